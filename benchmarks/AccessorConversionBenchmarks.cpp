@@ -0,0 +1,124 @@
+#include "Pch.hpp"
+
+#include "AccessorConversion.hpp"
+#include "Benchmark.hpp"
+
+namespace
+{
+    constexpr uint32_t GLTF_UNSIGNED_SHORT = 5123u;
+    constexpr uint32_t GLTF_FLOAT = 5126u;
+
+    constexpr uint32_t VERTEX_COUNT = 1'000'000u;
+    constexpr uint32_t INDEX_COUNT = 3'000'000u;
+    constexpr uint32_t ITERATION_COUNT = 10u;
+
+    template <typename T> sgfx::AccessorView getTightAccessorView(const std::vector<T>& data, const uint32_t componentType, const uint32_t componentCount, const bool normalized = false)
+    {
+        return sgfx::AccessorView{
+            .data = reinterpret_cast<const uint8_t*>(data.data()),
+            .byteStride = static_cast<uint32_t>(componentCount * sizeof(T)),
+            .count = static_cast<uint32_t>(data.size() / componentCount),
+            .componentType = componentType,
+            .componentCount = componentCount,
+            .normalized = normalized,
+        };
+    }
+}
+
+// Times the accessor conversion against the per element loops model loading used before it, on a million vertices with one tightly packed
+// accessor per attribute (as glTF exporters commonly write them), then on normalized 16 bit texture coordinates (as quantized glTF files store
+// them), and on three million 16 bit indices.
+SGFX_BENCHMARK(AccessorConversion)
+{
+    std::mt19937 randomEngine(3u);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    std::vector<float> positions(VERTEX_COUNT * 3u);
+    std::vector<float> textureCoords(VERTEX_COUNT * 2u);
+    std::vector<float> normals(VERTEX_COUNT * 3u);
+    std::vector<uint16_t> quantizedTextureCoords(VERTEX_COUNT * 2u);
+    std::vector<uint16_t> sourceIndices(INDEX_COUNT);
+
+    for (std::vector<float>* const attribute : {&positions, &textureCoords, &normals})
+    {
+        std::ranges::generate(*attribute, [&]() { return distribution(randomEngine); });
+    }
+
+    std::ranges::generate(quantizedTextureCoords, [&]() { return static_cast<uint16_t>(randomEngine()); });
+    std::ranges::generate(sourceIndices, [&]() { return static_cast<uint16_t>(randomEngine()); });
+
+    std::vector<sgfx::ModelVertex> vertices(VERTEX_COUNT);
+    std::byte* const vertexData = reinterpret_cast<std::byte*>(vertices.data());
+
+    std::vector<uint32_t> indices{};
+
+    // Each before / after pair must produce the same vertices or indices.
+    const auto compare = [&](const auto& function, const auto& referenceFunction, const auto& output)
+    {
+        const double referenceDuration = sgfx::benchmark::measure(ITERATION_COUNT, referenceFunction);
+        const auto referenceOutput = output;
+
+        const double duration = sgfx::benchmark::measure(ITERATION_COUNT, function);
+        const bool isMatching = std::memcmp(output.data(), referenceOutput.data(), output.size() * sizeof(output[0])) == 0 && output.size() == referenceOutput.size();
+
+        return std::format("per element loop {:.2f} ms, accessor conversion {:.2f} ms{}", referenceDuration, duration, isMatching ? "" : " (results differ)");
+    };
+
+    const std::string floatResult = compare(
+        [&]()
+        {
+            const std::array<sgfx::AttributeConversion, 3> attributes = {
+                sgfx::AttributeConversion{.accessor = getTightAccessorView(positions, GLTF_FLOAT, 3u), .destinationOffset = offsetof(sgfx::ModelVertex, position)},
+                sgfx::AttributeConversion{.accessor = getTightAccessorView(textureCoords, GLTF_FLOAT, 2u), .destinationOffset = offsetof(sgfx::ModelVertex, textureCoord)},
+                sgfx::AttributeConversion{.accessor = getTightAccessorView(normals, GLTF_FLOAT, 3u), .destinationOffset = offsetof(sgfx::ModelVertex, normal)},
+            };
+
+            sgfx::convertAttributesToFloats(attributes, vertexData, sizeof(sgfx::ModelVertex));
+        },
+        [&]()
+        {
+            for (const uint32_t i : std::views::iota(0u, VERTEX_COUNT))
+            {
+                vertices[i].position = {positions[3u * i], positions[3u * i + 1u], positions[3u * i + 2u]};
+                vertices[i].textureCoord = {textureCoords[2u * i], textureCoords[2u * i + 1u]};
+                vertices[i].normal = {normals[3u * i], normals[3u * i + 1u], normals[3u * i + 2u]};
+            }
+        },
+        vertices);
+
+    const std::string normalizedResult = compare(
+        [&]()
+        {
+            sgfx::convertAccessorToFloats(getTightAccessorView(quantizedTextureCoords, GLTF_UNSIGNED_SHORT, 2u, true),
+                                          vertexData + offsetof(sgfx::ModelVertex, textureCoord),
+                                          sizeof(sgfx::ModelVertex));
+        },
+        [&]()
+        {
+            for (const uint32_t i : std::views::iota(0u, VERTEX_COUNT))
+            {
+                vertices[i].textureCoord = {quantizedTextureCoords[2u * i] / 65535.0f, quantizedTextureCoords[2u * i + 1u] / 65535.0f};
+            }
+        },
+        vertices);
+
+    const std::string indexResult = compare(
+        [&]()
+        {
+            indices.resize(INDEX_COUNT);
+            sgfx::convertIndices(getTightAccessorView(sourceIndices, GLTF_UNSIGNED_SHORT, 1u), indices.data());
+        },
+        [&]()
+        {
+            indices.clear();
+            for (const uint16_t index : sourceIndices)
+            {
+                indices.push_back(static_cast<uint32_t>(index));
+            }
+        },
+        indices);
+
+    std::cout << std::format("Accessor conversion benchmark ({} vertices, float attributes) : {}.\n", VERTEX_COUNT, floatResult);
+    std::cout << std::format("Accessor conversion benchmark ({} vertices, normalized 16 bit texture coordinates) : {}.\n", VERTEX_COUNT, normalizedResult);
+    std::cout << std::format("Accessor conversion benchmark ({} indices, 16 bit) : {}.\n", INDEX_COUNT, indexResult);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "JobSystem.hpp"
+
+// Minimal benchmark registry : SGFX_BENCHMARK defines a benchmark function registered at static initialization. Every benchmark is handed the
+// job system shared by all of them, and prints its own results.
+#define SGFX_BENCHMARK(name)                                                                                                                         \
+    static void name(sgfx::JobSystem& jobSystem);                                                                                                    \
+    static const sgfx::benchmark::BenchmarkRegistration name##Registration{#name, &name};                                                            \
+    static void name([[maybe_unused]] sgfx::JobSystem& jobSystem)
+
+namespace sgfx::benchmark
+{
+    using BenchmarkFunction = void (*)(JobSystem& jobSystem);
+
+    struct BenchmarkCase
+    {
+        std::string_view name{};
+        BenchmarkFunction function{};
+    };
+
+    // Every registered benchmark, in registration order within a translation unit.
+    std::vector<BenchmarkCase>& getBenchmarkCases();
+
+    struct BenchmarkRegistration
+    {
+        BenchmarkRegistration(const std::string_view name, const BenchmarkFunction function)
+        {
+            getBenchmarkCases().push_back(BenchmarkCase{.name = name, .function = function});
+        }
+    };
+
+    // Average duration of a call to function over iterationCount calls, in milliseconds.
+    template <typename Function> double measure(const uint32_t iterationCount, const Function& function)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        for (uint32_t iteration = 0u; iteration < iterationCount; iteration++)
+        {
+            function();
+        }
+
+        const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+        return duration.count() / iterationCount;
+    }
+}
@@ -0,0 +1,34 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+
+namespace sgfx::benchmark
+{
+    std::vector<BenchmarkCase>& getBenchmarkCases()
+    {
+        static std::vector<BenchmarkCase> benchmarkCases{};
+        return benchmarkCases;
+    }
+}
+
+// Runs every benchmark, or those whose name contains the first argument. Assets are loaded relative to the working directory, which must be
+// the repository root.
+int main(int argc, char** argv)
+{
+    const std::string_view filter = argc > 1 ? std::string_view(argv[1]) : std::string_view{};
+
+    sgfx::JobSystem jobSystem{};
+
+    for (const sgfx::benchmark::BenchmarkCase& benchmarkCase : sgfx::benchmark::getBenchmarkCases())
+    {
+        if (benchmarkCase.name.find(filter) == std::string_view::npos)
+        {
+            continue;
+        }
+
+        std::cout << std::format("[{}]\n", benchmarkCase.name);
+        benchmarkCase.function(jobSystem);
+    }
+
+    return 0;
+}
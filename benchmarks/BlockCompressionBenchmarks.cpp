@@ -0,0 +1,54 @@
+#include "Pch.hpp"
+
+#include "BlockCompression.hpp"
+#include "Benchmark.hpp"
+
+// Compresses a 1024 x 1024 image (smooth gradients with some noise, as photographed textures have) to every format on one thread, and reports the
+// throughput and quality of each.
+SGFX_BENCHMARK(BlockCompression)
+{
+    constexpr uint32_t IMAGE_SIZE = 1024u;
+    constexpr uint32_t BLOCK_ROW_COUNT = IMAGE_SIZE / sgfx::BLOCK_WIDTH;
+
+    std::mt19937 randomEngine(23u);
+    std::uniform_int_distribution<int32_t> noiseDistribution(-12, 12);
+
+    std::vector<uint8_t> pixels(IMAGE_SIZE * IMAGE_SIZE * 4u);
+    for (uint32_t y = 0u; y < IMAGE_SIZE; y++)
+    {
+        for (uint32_t x = 0u; x < IMAGE_SIZE; x++)
+        {
+            const std::array<float, 4> gradient = {
+                127.5f + 127.5f * std::sin(x * 0.02f),
+                127.5f + 127.5f * std::cos(y * 0.015f),
+                255.0f * (x + y) / (2.0f * IMAGE_SIZE),
+                255.0f * y / IMAGE_SIZE,
+            };
+
+            for (const uint32_t channel : std::views::iota(0u, 4u))
+            {
+                pixels[(y * IMAGE_SIZE + x) * 4u + channel] = static_cast<uint8_t>(std::clamp(static_cast<int32_t>(gradient[channel]) + noiseDistribution(randomEngine), 0, 255));
+            }
+        }
+    }
+
+    std::vector<uint8_t> decodedPixels(pixels.size());
+
+    for (const sgfx::BlockFormat format : {sgfx::BlockFormat::BC1, sgfx::BlockFormat::BC3, sgfx::BlockFormat::BC4, sgfx::BlockFormat::BC5, sgfx::BlockFormat::BC7})
+    {
+        std::vector<std::byte> blocks(static_cast<size_t>(BLOCK_ROW_COUNT) * BLOCK_ROW_COUNT * sgfx::getBlockSize(format));
+
+        const double duration =
+            sgfx::benchmark::measure(1u, [&]() { sgfx::compressBlockRows(format, pixels, IMAGE_SIZE, IMAGE_SIZE, 0u, BLOCK_ROW_COUNT, blocks); });
+
+        sgfx::decompressImage(format, blocks, IMAGE_SIZE, IMAGE_SIZE, decodedPixels);
+
+        std::cout << std::format("Block compression benchmark ({}, {} x {}) : {:.1f} ms ({:.1f} MPixels/s), PSNR {:.2f} dB.\n",
+                                 sgfx::getBlockFormatName(format),
+                                 IMAGE_SIZE,
+                                 IMAGE_SIZE,
+                                 duration,
+                                 IMAGE_SIZE * IMAGE_SIZE / (duration * 1e3),
+                                 sgfx::computePsnr(format, pixels, decodedPixels));
+    }
+}
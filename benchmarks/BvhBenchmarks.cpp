@@ -0,0 +1,185 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "Bvh.hpp"
+#include "Frustum.hpp"
+
+// Times BVH builds, refits, frustum queries and ray casts over synthetic boxes and triangles.
+SGFX_BENCHMARK(Bvh)
+{
+    constexpr uint32_t BOX_COUNT = 100'000u;
+    constexpr uint32_t GRID_SIZE = 256u;
+    constexpr uint32_t QUERY_COUNT = 10'000u;
+    constexpr uint32_t ITERATION_COUNT = 20u;
+
+    std::mt19937 randomEngine(7u);
+    std::uniform_real_distribution<float> positionDistribution(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.1f, 4.0f);
+
+    // Boxes scattered in a cube, standing in for the meshes of a large scene.
+    std::vector<sgfx::AxisAlignedBoundingBox> boxes(BOX_COUNT);
+    for (sgfx::AxisAlignedBoundingBox& box : boxes)
+    {
+        const math::XMFLOAT3 center = {positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)};
+        const math::XMFLOAT3 extent = {sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine)};
+
+        box = sgfx::AxisAlignedBoundingBox{
+            .minimum = {center.x - extent.x, center.y - extent.y, center.z - extent.z},
+            .maximum = {center.x + extent.x, center.y + extent.y, center.z + extent.z},
+        };
+    }
+
+    sgfx::Bvh bvh{};
+    const double buildDuration = sgfx::benchmark::measure(ITERATION_COUNT, [&]() { bvh.build(boxes); });
+
+    for (sgfx::AxisAlignedBoundingBox& box : boxes)
+    {
+        box.minimum.y += 1.0f;
+        box.maximum.y += 1.0f;
+    }
+
+    const double refitDuration = sgfx::benchmark::measure(ITERATION_COUNT, [&]() { bvh.refit(boxes); });
+
+    // A camera and three shadow cascade like frustums, queried together and then one at a time through a linear scan.
+    const math::XMMATRIX viewMatrix =
+        math::XMMatrixLookAtLH(math::XMVectorSet(0.0f, 0.0f, -600.0f, 1.0f), math::XMVectorZero(), math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    std::array<sgfx::Frustum, 4> frustums{};
+    for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(frustums.size())))
+    {
+        frustums[i] = sgfx::createFrustum(viewMatrix * math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(20.0f + 15.0f * i), 16.0f / 9.0f, 1.0f, 1200.0f));
+    }
+
+    std::array<std::vector<uint32_t>, 4> queryResults{};
+    const double frustumQueryDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                                 [&]()
+                                                                 {
+                                                                     for (std::vector<uint32_t>& queryResult : queryResults)
+                                                                     {
+                                                                         queryResult.clear();
+                                                                     }
+
+                                                                     bvh.queryFrustums(frustums, queryResults);
+                                                                 });
+
+    sgfx::BoundingVolumes boundingVolumes{};
+    boundingVolumes.resize(BOX_COUNT);
+    for (const uint32_t i : std::views::iota(0u, BOX_COUNT))
+    {
+        boundingVolumes.set(i, boxes[i], {}, std::numeric_limits<float>::max());
+    }
+
+    std::vector<uint8_t> visibility(BOX_COUNT);
+    const double linearFrustumDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                                  [&]()
+                                                                  {
+                                                                      for (const sgfx::Frustum& frustum : frustums)
+                                                                      {
+                                                                          [[maybe_unused]] const uint32_t visibleCount = sgfx::cullBoundingVolumes(frustum, boundingVolumes, visibility);
+                                                                      }
+                                                                  });
+
+    std::vector<sgfx::Ray> rays(QUERY_COUNT);
+    for (sgfx::Ray& ray : rays)
+    {
+        ray.origin = {positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)};
+        ray.direction = {positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)};
+    }
+
+    uint32_t boxHitCount = 0u;
+    const double boxRaycastDuration = sgfx::benchmark::measure(1u,
+                                                               [&]()
+                                                               {
+                                                                   for (const sgfx::Ray& ray : rays)
+                                                                   {
+                                                                       const auto intersectBox = [&](const uint32_t boxIndex, const sgfx::Ray& boxRay, const float) { return sgfx::intersectRayAabb(boxRay, boxes[boxIndex]); };
+                                                                       boxHitCount += bvh.raycast(ray, intersectBox).isHit() ? 1u : 0u;
+                                                                   }
+                                                               });
+
+    // Bumpy height field, for nearest hit triangle queries.
+    std::vector<math::XMFLOAT3> positions{};
+    for (const uint32_t z : std::views::iota(0u, GRID_SIZE + 1u))
+    {
+        for (const uint32_t x : std::views::iota(0u, GRID_SIZE + 1u))
+        {
+            positions.emplace_back(static_cast<float>(x), 4.0f * std::sin(0.2f * x) * std::cos(0.3f * z), static_cast<float>(z));
+        }
+    }
+
+    std::vector<uint32_t> indices{};
+    std::vector<sgfx::AxisAlignedBoundingBox> triangleBounds{};
+    for (const uint32_t z : std::views::iota(0u, GRID_SIZE))
+    {
+        for (const uint32_t x : std::views::iota(0u, GRID_SIZE))
+        {
+            const uint32_t corner = z * (GRID_SIZE + 1u) + x;
+
+            for (const std::array<uint32_t, 3>& triangle : {std::array<uint32_t, 3>{corner, corner + GRID_SIZE + 1u, corner + 1u},
+                                                             std::array<uint32_t, 3>{corner + 1u, corner + GRID_SIZE + 1u, corner + GRID_SIZE + 2u}})
+            {
+                indices.insert(indices.end(), triangle.begin(), triangle.end());
+
+                const math::XMVECTOR p0 = math::XMLoadFloat3(&positions[triangle[0]]);
+                const math::XMVECTOR p1 = math::XMLoadFloat3(&positions[triangle[1]]);
+                const math::XMVECTOR p2 = math::XMLoadFloat3(&positions[triangle[2]]);
+
+                sgfx::AxisAlignedBoundingBox& bounds = triangleBounds.emplace_back();
+                math::XMStoreFloat3(&bounds.minimum, math::XMVectorMin(p0, math::XMVectorMin(p1, p2)));
+                math::XMStoreFloat3(&bounds.maximum, math::XMVectorMax(p0, math::XMVectorMax(p1, p2)));
+            }
+        }
+    }
+
+    sgfx::Bvh triangleBvh{};
+    const double triangleBuildDuration = sgfx::benchmark::measure(1u, [&]() { triangleBvh.build(triangleBounds); });
+
+    std::uniform_real_distribution<float> gridDistribution(0.0f, static_cast<float>(GRID_SIZE));
+
+    uint32_t triangleHitCount = 0u;
+    const double triangleRaycastDuration = sgfx::benchmark::measure(1u,
+                                                                    [&]()
+                                                                    {
+                                                                        for (uint32_t i = 0u; i < QUERY_COUNT; i++)
+                                                                        {
+                                                                            const sgfx::Ray ray{
+                                                                                .origin = {gridDistribution(randomEngine), 50.0f, gridDistribution(randomEngine)},
+                                                                                .direction = {gridDistribution(randomEngine) - GRID_SIZE * 0.5f, -50.0f, gridDistribution(randomEngine) - GRID_SIZE * 0.5f},
+                                                                            };
+
+                                                                            const auto intersectTriangle = [&](const uint32_t triangleIndex, const sgfx::Ray& triangleRay, const float maxDistance)
+                                                                            {
+                                                                                const sgfx::Ray boundedRay{.origin = triangleRay.origin, .direction = triangleRay.direction, .maxDistance = maxDistance};
+                                                                                return sgfx::intersectRayTriangle(boundedRay,
+                                                                                                                  positions[indices[3u * triangleIndex]],
+                                                                                                                  positions[indices[3u * triangleIndex + 1u]],
+                                                                                                                  positions[indices[3u * triangleIndex + 2u]]);
+                                                                            };
+
+                                                                            triangleHitCount += triangleBvh.raycast(ray, intersectTriangle).isHit() ? 1u : 0u;
+                                                                        }
+                                                                    });
+
+    std::cout << std::format("BVH benchmark ({} boxes, {} nodes) : build {:.2f} ms, refit {:.2f} ms, {} frustums {:.3f} ms ({} / {} / {} / {} boxes, "
+                             "linear scan {:.3f} ms), {} rays {:.2f} ms ({} hits).\n",
+                             BOX_COUNT,
+                             bvh.getNodeCount(),
+                             buildDuration,
+                             refitDuration,
+                             frustums.size(),
+                             frustumQueryDuration,
+                             queryResults[0].size(),
+                             queryResults[1].size(),
+                             queryResults[2].size(),
+                             queryResults[3].size(),
+                             linearFrustumDuration,
+                             QUERY_COUNT,
+                             boxRaycastDuration,
+                             boxHitCount);
+
+    std::cout << std::format("Triangle BVH benchmark ({} triangles) : build {:.2f} ms, {} nearest hit rays {:.2f} ms ({} hits).\n",
+                             triangleBounds.size(),
+                             triangleBuildDuration,
+                             QUERY_COUNT,
+                             triangleRaycastDuration,
+                             triangleHitCount);
+}
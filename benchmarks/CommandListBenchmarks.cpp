@@ -0,0 +1,155 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "CommandList.hpp"
+
+// Times recording synthetic draws into one command list against recording them into one list per thread and merging those, and the traversal
+// of the merged list.
+SGFX_BENCHMARK(CommandList)
+{
+    constexpr uint32_t ITEM_COUNT = 100'000u;
+    constexpr uint32_t MATERIAL_COUNT = 500u;
+    constexpr uint32_t ITERATION_COUNT = 20u;
+
+    // Stand ins for the transform buffers, textures and samplers the commands refer to. Items come sorted by material, as from the render
+    // queue, so the textures and samplers are only bound when the material changes.
+    std::vector<uint32_t> objects(ITEM_COUNT + MATERIAL_COUNT * 4u);
+    std::vector<uint32_t> materials(ITEM_COUNT);
+    for (const uint32_t i : std::views::iota(0u, ITEM_COUNT))
+    {
+        materials[i] = static_cast<uint32_t>(uint64_t{i} * MATERIAL_COUNT / ITEM_COUNT);
+    }
+
+    const auto recordItems = [&](sgfx::CommandList& commandList, const uint32_t firstItem, const uint32_t lastItem)
+    {
+        for (const uint32_t i : std::views::iota(firstItem, lastItem))
+        {
+            if (i == firstItem || materials[i] != materials[i - 1u])
+            {
+                const uint32_t* const materialObjects = &objects[ITEM_COUNT + materials[i] * 4u];
+
+                for (const uint32_t slot : std::views::iota(0u, 2u))
+                {
+                    commandList.record(sgfx::SetShaderResourceCommand{.resource = &materialObjects[slot], .stage = sgfx::ShaderStage::Pixel, .slot = slot});
+                    commandList.record(sgfx::SetSamplerCommand{.sampler = &materialObjects[2u + slot], .stage = sgfx::ShaderStage::Pixel, .slot = slot});
+                }
+            }
+
+            commandList.record(sgfx::SetConstantBufferCommand{.buffer = &objects[i], .stage = sgfx::ShaderStage::Vertex, .slot = 1u});
+            commandList.record(sgfx::DrawIndexedCommand{.indexCount = 3u * (i % 256u + 1u), .firstIndex = i * 3u});
+        }
+    };
+
+    // Order dependent, over the fields that differ between the items.
+    const auto getChecksum = [](const sgfx::CommandList& commandList)
+    {
+        uint64_t checksum = 0u;
+        commandList.forEach(
+            [&]<typename T>(const T& command)
+            {
+                uint64_t value = static_cast<uint64_t>(T::TYPE);
+                if constexpr (std::is_same_v<T, sgfx::DrawIndexedCommand>)
+                {
+                    value += uint64_t{command.firstIndex} << 8u;
+                }
+                else if constexpr (std::is_same_v<T, sgfx::SetConstantBufferCommand>)
+                {
+                    value += std::bit_cast<uintptr_t>(command.buffer) << 8u;
+                }
+                else if constexpr (std::is_same_v<T, sgfx::SetShaderResourceCommand>)
+                {
+                    value += std::bit_cast<uintptr_t>(command.resource) << 8u;
+                }
+
+                checksum = checksum * 0x100000001b3ull + value;
+            });
+
+        return checksum;
+    };
+
+    // The items are split into one range per thread. The single list records the same ranges one after the other, so the merged list must
+    // match it exactly.
+    const uint32_t commandListCount = jobSystem.getWorkerCount() + 1u;
+    const auto getFirstItem = [&](const uint32_t commandListIndex) { return static_cast<uint32_t>(uint64_t{ITEM_COUNT} * commandListIndex / commandListCount); };
+
+    // The lists are reused across iterations, as the engine does across frames.
+    sgfx::CommandList singleCommandList{};
+    double singleRecordingDuration = 0.0;
+
+    for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        singleCommandList.reset();
+        for (const uint32_t commandListIndex : std::views::iota(0u, commandListCount))
+        {
+            recordItems(singleCommandList, getFirstItem(commandListIndex), getFirstItem(commandListIndex + 1u));
+        }
+
+        singleRecordingDuration += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    std::vector<sgfx::CommandList> commandLists(commandListCount);
+    sgfx::CommandList mergedCommandList{};
+
+    double parallelRecordingDuration = 0.0;
+    double mergeDuration = 0.0;
+
+    for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+    {
+        const auto recordingStartTime = std::chrono::high_resolution_clock::now();
+
+        sgfx::JobCounter recordingCounter{};
+        jobSystem.parallelFor(
+            commandListCount,
+            1u,
+            [&](const uint32_t commandListIndex)
+            {
+                commandLists[commandListIndex].reset();
+                recordItems(commandLists[commandListIndex], getFirstItem(commandListIndex), getFirstItem(commandListIndex + 1u));
+            },
+            recordingCounter);
+
+        jobSystem.wait(recordingCounter);
+
+        const auto mergeStartTime = std::chrono::high_resolution_clock::now();
+
+        mergedCommandList.reset();
+        for (const sgfx::CommandList& commandList : commandLists)
+        {
+            mergedCommandList.append(commandList);
+        }
+
+        const auto endTime = std::chrono::high_resolution_clock::now();
+
+        parallelRecordingDuration += std::chrono::duration<double, std::milli>(mergeStartTime - recordingStartTime).count();
+        mergeDuration += std::chrono::duration<double, std::milli>(endTime - mergeStartTime).count();
+    }
+
+    // Traversal is what a backend replaying the list pays on top of its own API calls.
+    double traversalDuration = 0.0;
+    uint64_t checksum = 0u;
+
+    for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        checksum = getChecksum(mergedCommandList);
+
+        traversalDuration += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    const bool isMergeMatching = mergedCommandList.getCommandCount() == singleCommandList.getCommandCount() && checksum == getChecksum(singleCommandList);
+
+    std::cout << std::format("Command list benchmark ({} items, {} commands, {:.1f} MB) : recording {:.3f} ms, recording on {} threads {:.3f} ms + merge {:.3f} ms, traversal {:.3f} ms ({:.1f} M commands / s){}.\n",
+                             ITEM_COUNT,
+                             mergedCommandList.getCommandCount(),
+                             mergedCommandList.getSize() / (1024.0 * 1024.0),
+                             singleRecordingDuration / ITERATION_COUNT,
+                             commandListCount,
+                             parallelRecordingDuration / ITERATION_COUNT,
+                             mergeDuration / ITERATION_COUNT,
+                             traversalDuration / ITERATION_COUNT,
+                             mergedCommandList.getCommandCount() * ITERATION_COUNT / (traversalDuration * 1e3),
+                             isMergeMatching ? "" : " (merged list differs)");
+}
@@ -0,0 +1,58 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "MeshSimplifier.hpp"
+
+// Simplifies a displaced grid of about 130k triangles as LOD generation does, each LOD from the previous one with half its triangles, and
+// reports the time and error of every step.
+SGFX_BENCHMARK(MeshSimplifier)
+{
+    constexpr uint32_t GRID_SIZE = 256u;
+    constexpr uint32_t LOD_COUNT = 4u;
+
+    std::vector<sgfx::ModelVertex> vertices{};
+    for (uint32_t y = 0u; y <= GRID_SIZE; y++)
+    {
+        for (uint32_t x = 0u; x <= GRID_SIZE; x++)
+        {
+            const float u = static_cast<float>(x) / GRID_SIZE;
+            const float v = static_cast<float>(y) / GRID_SIZE;
+
+            vertices.push_back(sgfx::ModelVertex{.position = {u, v, 0.05f * std::sin(20.0f * u) * std::cos(14.0f * v)}, .textureCoord = {u, v}});
+        }
+    }
+
+    std::vector<uint32_t> indices{};
+    for (uint32_t y = 0u; y < GRID_SIZE; y++)
+    {
+        for (uint32_t x = 0u; x < GRID_SIZE; x++)
+        {
+            const uint32_t v00 = y * (GRID_SIZE + 1u) + x;
+            const uint32_t v01 = v00 + GRID_SIZE + 1u;
+
+            indices.insert(indices.end(), {v00, v01 + 1u, v00 + 1u, v00, v01, v01 + 1u});
+        }
+    }
+
+    for (uint32_t lod = 1u; lod <= LOD_COUNT; lod++)
+    {
+        const size_t sourceTriangleCount = indices.size() / 3u;
+
+        float error = 0.0f;
+        std::vector<uint32_t> lodIndices{};
+
+        const double duration = sgfx::benchmark::measure(1u,
+                                                         [&]() {
+                                                             lodIndices = sgfx::simplifyMesh(indices, vertices, sourceTriangleCount / 2u * 3u, std::numeric_limits<float>::max(), error);
+                                                         });
+
+        std::cout << std::format("Mesh simplifier benchmark (LOD {}, {} -> {} triangles) : {:.1f} ms, error {:.5f}.\n",
+                                 lod,
+                                 sourceTriangleCount,
+                                 lodIndices.size() / 3u,
+                                 duration,
+                                 error);
+
+        indices = std::move(lodIndices);
+    }
+}
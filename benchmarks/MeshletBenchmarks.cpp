@@ -0,0 +1,140 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "Camera.hpp"
+#include "Frustum.hpp"
+#include "GeometryPool.hpp"
+#include "Meshlet.hpp"
+#include "Model.hpp"
+#include "NullRenderBackend.hpp"
+#include "TextureCache.hpp"
+
+namespace
+{
+    // Written by the engine's camera path recording (Engine::CAMERA_PATH_FILE), in the same layout as Engine::CameraPathFrame.
+    constexpr std::string_view CAMERA_PATH_FILE = "camera_path.bin";
+
+    struct CameraPathFrame
+    {
+        math::XMFLOAT4 position{};
+        float pitch{};
+        float yaw{};
+    };
+
+    static_assert(sizeof(CameraPathFrame) == 24u);
+
+    std::vector<CameraPathFrame> loadCameraPath()
+    {
+        std::vector<CameraPathFrame> cameraPath{};
+
+        std::ifstream file(std::string(CAMERA_PATH_FILE), std::ios::binary | std::ios::ate);
+        if (file)
+        {
+            cameraPath.resize(static_cast<size_t>(file.tellg()) / sizeof(CameraPathFrame));
+
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(cameraPath.data()), static_cast<std::streamsize>(cameraPath.size() * sizeof(CameraPathFrame)));
+        }
+
+        return cameraPath;
+    }
+
+    // Without a recording : a full turn from the engine's starting camera, looking slightly down and then up.
+    std::vector<CameraPathFrame> generateCameraPath()
+    {
+        constexpr uint32_t FRAME_COUNT = 360u;
+
+        std::vector<CameraPathFrame> cameraPath(FRAME_COUNT);
+        for (const uint32_t i : std::views::iota(0u, FRAME_COUNT))
+        {
+            const float angle = math::XM_2PI * i / FRAME_COUNT;
+
+            cameraPath[i] = CameraPathFrame{
+                .position = sgfx::Camera{}.m_cameraPosition,
+                .pitch = 0.3f * std::sin(2.0f * angle),
+                .yaw = angle,
+            };
+        }
+
+        return cameraPath;
+    }
+}
+
+// Replays a camera path through the meshlet frustum and normal cone culling of Sponza, loaded and placed as the engine does, and reports the
+// triangles rejected per frame. Meshes are not culled first, so every meshlet is tested.
+SGFX_BENCHMARK(MeshletCullingCameraPath)
+{
+    sgfx::NullRenderBackend renderBackend{};
+
+    sgfx::GeometryPool geometryPool(renderBackend,
+                                    sgfx::GeometryPoolCreationDesc{
+                                        .vertexBufferSize = 64u * 1024u * 1024u,
+                                        .shortIndexCapacity = 8u * 1024u * 1024u,
+                                        .indexCapacity = 4u * 1024u * 1024u,
+                                    });
+
+    sgfx::TextureCache textureCache(renderBackend, jobSystem);
+    const sgfx::TextureHandle fallbackTexture = textureCache.getTexture("assets/textures/Default.png", sgfx::TextureUsage::Albedo);
+
+    // The engine's load options, so the cooked model is shared with it.
+    sgfx::Model sponza(renderBackend,
+                       geometryPool,
+                       textureCache,
+                       fallbackTexture,
+                       jobSystem,
+                       "assets/models/sponza-gltf-pbr/sponza.glb",
+                       sgfx::TransformComponent{.scale = {0.1f, 0.1f, 0.1f}},
+                       sgfx::ModelLoadOptions{.generateMeshlets = true, .generateLods = true, .buildCollisionBvhs = true});
+
+    sponza.updateTransformBuffer(math::XMMatrixIdentity(), renderBackend);
+
+    std::vector<CameraPathFrame> cameraPath = loadCameraPath();
+    const bool isRecorded = !cameraPath.empty();
+    if (!isRecorded)
+    {
+        cameraPath = generateCameraPath();
+    }
+
+    // The engine's projection, for a 16:9 window.
+    const math::XMMATRIX projectionMatrix = math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(45.0f), 16.0f / 9.0f, 0.1f, 230.0f);
+
+    sgfx::Camera camera{};
+
+    sgfx::MeshletCullingStats totalCullingStats{};
+    double totalDuration = 0.0;
+    double maximumDuration = 0.0;
+
+    for (const CameraPathFrame& frame : cameraPath)
+    {
+        camera.m_cameraPosition = frame.position;
+        camera.m_pitch = frame.pitch;
+        camera.m_yaw = frame.yaw;
+
+        const sgfx::Frustum frustum = sgfx::createFrustum(camera.getLookAtMatrix() * projectionMatrix);
+        const math::XMFLOAT3 cameraPosition = {frame.position.x, frame.position.y, frame.position.z};
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        const sgfx::MeshletCullingStats cullingStats = sponza.cullMeshlets(frustum, cameraPosition);
+        const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+
+        totalDuration += duration.count();
+        maximumDuration = std::max(maximumDuration, duration.count());
+
+        totalCullingStats += cullingStats;
+    }
+
+    const double frameCount = static_cast<double>(cameraPath.size());
+
+    std::cout << std::format("Meshlet culling camera path benchmark ({} frames, {}) : {:.0f} of {:.0f} triangles rejected per frame (frustum {:.0f}, "
+                             "backface {:.0f}), {:.0f} of {:.0f} meshlets culled, {:.3f} ms avg / {:.3f} ms max.\n",
+                             cameraPath.size(),
+                             isRecorded ? "recorded" : "generated turn",
+                             totalCullingStats.getRejectedTriangleCount() / frameCount,
+                             totalCullingStats.triangleCount / frameCount,
+                             totalCullingStats.frustumCulledTriangleCount / frameCount,
+                             totalCullingStats.backfaceCulledTriangleCount / frameCount,
+                             (totalCullingStats.frustumCulledMeshletCount + totalCullingStats.backfaceCulledMeshletCount) / frameCount,
+                             totalCullingStats.meshletCount / frameCount,
+                             totalDuration / frameCount,
+                             maximumDuration);
+}
@@ -0,0 +1,89 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "ModelCache.hpp"
+
+namespace
+{
+    constexpr std::string_view SPONZA_PATH = "assets/models/sponza-gltf-pbr/sponza.glb";
+
+    std::vector<std::byte> readFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return {};
+        }
+
+        std::vector<std::byte> data(static_cast<size_t>(file.tellg()));
+
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        return data;
+    }
+}
+
+// Times the key of Sponza's source files against hashing their contents (what the key used to be), and opening a cooked model of a million
+// vertices against reading the whole file.
+SGFX_BENCHMARK(ModelCache)
+{
+    constexpr uint32_t ITERATION_COUNT = 20u;
+    constexpr uint32_t VERTEX_COUNT = 1'000'000u;
+
+    // Written by every iteration, so the results are not optimized away.
+    volatile uint64_t sink = 0u;
+
+    const double keyDuration = sgfx::benchmark::measure(ITERATION_COUNT, [&]() { sink = sgfx::ModelCache::getSourceFilesKey(SPONZA_PATH); });
+
+    const double contentHashDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                                [&]()
+                                                                {
+                                                                    const std::filesystem::path sourcePath(SPONZA_PATH);
+
+                                                                    uint64_t hash = hashBytes(readFile(sourcePath));
+                                                                    for (const auto& entry : std::filesystem::directory_iterator(sourcePath.parent_path()))
+                                                                    {
+                                                                        if (entry.is_regular_file() && entry.path().extension() == ".bin")
+                                                                        {
+                                                                            hash = hashCombine(hash, hashBytes(readFile(entry.path())));
+                                                                        }
+                                                                    }
+
+                                                                    sink = hash;
+                                                                });
+
+    std::cout << std::format("Model cache key benchmark ({}) : sizes and write times {:.3f} ms, content hash {:.3f} ms.\n", SPONZA_PATH, keyDuration, contentHashDuration);
+
+    sgfx::ModelDataStorage storage{};
+    storage.vertices.resize(VERTEX_COUNT);
+
+    const std::string cachePath = (std::filesystem::temp_directory_path() / "sgfx_model_cache_benchmark.sgfxcache").string();
+    sgfx::ModelCache::write(cachePath, 0u, storage.getView());
+
+    // Both hash every vertex once, standing in for the upload reading them.
+    const double openDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                         [&]()
+                                                         {
+                                                             sgfx::ModelCache modelCache{};
+                                                             if (modelCache.open(cachePath, 0u))
+                                                             {
+                                                                 sink = hashBytes(std::as_bytes(modelCache.getData().vertices));
+                                                             }
+                                                         });
+
+    const double readDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                         [&]()
+                                                         {
+                                                             sink = hashBytes(readFile(cachePath));
+                                                         });
+
+    std::error_code errorCode{};
+    std::filesystem::remove(cachePath, errorCode);
+
+    std::cout << std::format("Model cache open benchmark ({} vertices, {:.1f} MB) : memory mapped {:.3f} ms, read into memory {:.3f} ms.\n",
+                             VERTEX_COUNT,
+                             VERTEX_COUNT * sizeof(sgfx::ModelVertex) / (1024.0 * 1024.0),
+                             openDuration,
+                             readDuration);
+}
@@ -0,0 +1,262 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "GeometryPool.hpp"
+#include "Model.hpp"
+#include "ModelCache.hpp"
+#include "NullRenderBackend.hpp"
+#include "TextureCache.hpp"
+
+#define TINYGLTF_NOEXCEPTION
+#define JSON_NOEXCEPTION
+#define TINYGLTF_NO_INCLUDE_STB_IMAGE
+#define TINYGLTF_NO_INCLUDE_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#define TINYGLTF_USE_CPP14
+#include <tiny_gltf.h>
+
+namespace
+{
+    constexpr std::string_view SPONZA_PATH = "assets/models/sponza-gltf-pbr/sponza.glb";
+    constexpr std::string_view SCIFI_HELMET_PATH = "assets/models/SciFiHelmet/glTF/SciFiHelmet.gltf";
+    constexpr uint32_t ITERATION_COUNT = 3u;
+
+    // The engine's load options, so the cooked files are shared with it.
+    constexpr sgfx::ModelLoadOptions MODEL_LOAD_OPTIONS = {
+        .generateMeshlets = true,
+        .generateLods = true,
+        .buildCollisionBvhs = true,
+    };
+
+    // Loads the model into a backend, geometry pool and texture cache of its own, so no texture is shared with a previous load. Returns the
+    // duration in milliseconds.
+    double loadModel(sgfx::JobSystem& jobSystem, const std::string_view modelPath, const sgfx::ModelLoadOptions& loadOptions)
+    {
+        sgfx::NullRenderBackend renderBackend{};
+
+        sgfx::GeometryPool geometryPool(renderBackend,
+                                        sgfx::GeometryPoolCreationDesc{
+                                            .vertexBufferSize = 64u * 1024u * 1024u,
+                                            .shortIndexCapacity = 8u * 1024u * 1024u,
+                                            .indexCapacity = 4u * 1024u * 1024u,
+                                        });
+
+        sgfx::TextureCache textureCache(renderBackend, jobSystem);
+        const sgfx::TextureHandle fallbackTexture = textureCache.getTexture("assets/textures/Default.png", sgfx::TextureUsage::Albedo);
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        const sgfx::Model model(renderBackend, geometryPool, textureCache, fallbackTexture, jobSystem, modelPath, {}, loadOptions);
+        geometryPool.flushUploads();
+
+        const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+        return duration.count();
+    }
+
+    struct MaterialTexture
+    {
+        std::string path{};
+        sgfx::TextureUsage usage{};
+    };
+
+    // Textures of every material, parsed with tinygltf. Images shared by materials are listed once per material.
+    std::vector<std::vector<MaterialTexture>> getMaterialTextures(const std::string_view modelPath)
+    {
+        tinygltf::TinyGLTF context{};
+        tinygltf::Model model{};
+        std::string warning{};
+        std::string error{};
+
+        const std::string path(modelPath);
+        const bool isLoaded = modelPath.ends_with(".glb") ? context.LoadBinaryFromFile(&model, &error, &warning, path) : context.LoadASCIIFromFile(&model, &error, &warning, path);
+        if (!isLoaded)
+        {
+            fatalError(error);
+        }
+
+        const std::string modelDirectory = std::filesystem::path(modelPath).parent_path().generic_string() + "/";
+
+        std::vector<std::vector<MaterialTexture>> materialTextures{};
+        for (const tinygltf::Material& material : model.materials)
+        {
+            std::vector<MaterialTexture>& textures = materialTextures.emplace_back();
+
+            const std::array<std::pair<int, sgfx::TextureUsage>, 5u> textureIndices = {{
+                {material.pbrMetallicRoughness.baseColorTexture.index, sgfx::TextureUsage::Albedo},
+                {material.pbrMetallicRoughness.metallicRoughnessTexture.index, sgfx::TextureUsage::MetalRoughness},
+                {material.normalTexture.index, sgfx::TextureUsage::Normal},
+                {material.occlusionTexture.index, sgfx::TextureUsage::Occlusion},
+                {material.emissiveTexture.index, sgfx::TextureUsage::Emissive},
+            }};
+
+            for (const auto& [textureIndex, usage] : textureIndices)
+            {
+                if (textureIndex >= 0)
+                {
+                    textures.push_back(MaterialTexture{
+                        .path = modelDirectory + model.images[model.textures[textureIndex].source].uri,
+                        .usage = usage,
+                    });
+                }
+            }
+        }
+
+        return materialTextures;
+    }
+
+    // The texture loading the job system replaced : every material starts a thread per texture, which decodes the image, generates its mips
+    // and creates it under a lock, and waits for them before the next material. Textures are neither cooked nor shared between materials.
+    // Returns the duration in milliseconds.
+    double loadTexturesThreadPerTexture(std::span<const std::vector<MaterialTexture>> materialTextures)
+    {
+        sgfx::NullRenderBackend renderBackend{};
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        std::mutex textureCreationMutex{};
+        std::vector<sgfx::BackendResource> textures{};
+
+        for (const std::vector<MaterialTexture>& material : materialTextures)
+        {
+            // Joined when leaving the scope, before the next material.
+            std::vector<std::jthread> threads{};
+
+            for (const MaterialTexture& texture : material)
+            {
+                threads.emplace_back(
+                    [&]()
+                    {
+                        const sgfx::UncompressedTexture uncompressedTexture = sgfx::decodeUncompressedTexture(texture.path, texture.usage);
+
+                        const sgfx::BackendTextureDesc textureDesc = {
+                            .width = uncompressedTexture.width,
+                            .height = uncompressedTexture.height,
+                            .format = sgfx::isSrgbTextureUsage(texture.usage) ? sgfx::TextureFormat::R8G8B8A8UnormSrgb : sgfx::TextureFormat::R8G8B8A8Unorm,
+                            .mipCount = uncompressedTexture.mipCount,
+                        };
+
+                        const std::lock_guard<std::mutex> lock(textureCreationMutex);
+                        textures.emplace_back(renderBackend, renderBackend.createTexture(textureDesc, uncompressedTexture.pixels));
+                    });
+            }
+        }
+
+        const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+        return duration.count();
+    }
+
+    // The same textures as models load them now : from their cooked files, through a texture cache of its own, with a job per material.
+    // Returns the duration in milliseconds.
+    double loadTexturesWithJobs(sgfx::JobSystem& jobSystem, std::span<const std::vector<MaterialTexture>> materialTextures)
+    {
+        sgfx::NullRenderBackend renderBackend{};
+        sgfx::TextureCache textureCache(renderBackend, jobSystem);
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::vector<sgfx::TextureHandle>> textures(materialTextures.size());
+
+        sgfx::JobCounter counter{};
+        jobSystem.parallelFor(static_cast<uint32_t>(materialTextures.size()),
+                              1u,
+                              [&](const uint32_t materialIndex)
+                              {
+                                  for (const MaterialTexture& texture : materialTextures[materialIndex])
+                                  {
+                                      textures[materialIndex].push_back(textureCache.getTexture(texture.path, texture.usage));
+                                  }
+                              },
+                              counter);
+        jobSystem.wait(counter);
+
+        const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+        return duration.count();
+    }
+
+    // Loads the model from glTF (the cooked model is deleted before every load), then from the cooked model, on a single worker and on every
+    // worker. Textures are cooked by a first load, which is not timed, so the timed loads measure model parsing or mapping, conversion and uploads.
+    void runModelLoadBenchmark(sgfx::JobSystem& jobSystem, const std::string_view modelName, const std::string_view modelPath)
+    {
+        const std::string cachePath = sgfx::ModelCache::getCachePath(modelPath);
+
+        loadModel(jobSystem, modelPath, MODEL_LOAD_OPTIONS);
+
+        sgfx::JobSystem singleWorkerJobSystem{1u};
+
+        for (sgfx::JobSystem* const loadJobSystem : {&singleWorkerJobSystem, &jobSystem})
+        {
+            for (const bool isCold : {true, false})
+            {
+                double totalDuration = 0.0;
+                double minimumDuration = std::numeric_limits<double>::max();
+
+                for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+                {
+                    // Cold loads cook the model again, so the last one leaves the cooked model for the warm loads.
+                    if (isCold)
+                    {
+                        std::filesystem::remove(cachePath);
+                    }
+
+                    const double duration = loadModel(*loadJobSystem, modelPath, MODEL_LOAD_OPTIONS);
+                    totalDuration += duration;
+                    minimumDuration = std::min(minimumDuration, duration);
+                }
+
+                std::cout << std::format("{} load benchmark ({}, {} threads) : {:.1f} ms avg / {:.1f} ms min.\n",
+                                         modelName,
+                                         isCold ? "cold, glTF" : "warm, cooked cache",
+                                         loadJobSystem->getWorkerCount() + 1u,
+                                         totalDuration / ITERATION_COUNT,
+                                         minimumDuration);
+            }
+        }
+    }
+}
+
+// Loads the textures of Sponza as models did before the job system (see loadTexturesThreadPerTexture), then as they do now. The textures are
+// cooked by a first load, which is not timed.
+SGFX_BENCHMARK(SponzaTextureLoadThreadPerTextureBaseline)
+{
+    const std::vector<std::vector<MaterialTexture>> materialTextures = getMaterialTextures(SPONZA_PATH);
+
+    size_t textureCount = 0u;
+    for (const std::vector<MaterialTexture>& material : materialTextures)
+    {
+        textureCount += material.size();
+    }
+
+    loadTexturesWithJobs(jobSystem, materialTextures);
+
+    for (const bool isBaseline : {true, false})
+    {
+        double totalDuration = 0.0;
+        double minimumDuration = std::numeric_limits<double>::max();
+
+        for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+        {
+            const double duration = isBaseline ? loadTexturesThreadPerTexture(materialTextures) : loadTexturesWithJobs(jobSystem, materialTextures);
+            totalDuration += duration;
+            minimumDuration = std::min(minimumDuration, duration);
+        }
+
+        std::cout << std::format("Sponza texture load benchmark ({}, {} textures of {} materials) : {:.1f} ms avg / {:.1f} ms min.\n",
+                                 isBaseline ? "baseline, thread per texture" : "job system, cooked textures",
+                                 textureCount,
+                                 materialTextures.size(),
+                                 totalDuration / ITERATION_COUNT,
+                                 minimumDuration);
+    }
+}
+
+// A large scene of many meshes and materials, from a single binary glTF.
+SGFX_BENCHMARK(SponzaLoad)
+{
+    runModelLoadBenchmark(jobSystem, "Sponza", SPONZA_PATH);
+}
+
+// A single dense mesh, from a text glTF with an external buffer.
+SGFX_BENCHMARK(SciFiHelmetLoad)
+{
+    runModelLoadBenchmark(jobSystem, "SciFiHelmet", SCIFI_HELMET_PATH);
+}
@@ -0,0 +1,106 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "Frustum.hpp"
+#include "OcclusionBuffer.hpp"
+
+// Times occluder rasterization and box tests over a synthetic scene of walls and boxes, reporting the boxes culled at several occlusion buffer
+// resolutions.
+SGFX_BENCHMARK(OcclusionCulling)
+{
+    constexpr uint32_t BOX_COUNT = 20'000u;
+    constexpr uint32_t ITERATION_COUNT = 20u;
+    constexpr std::array<std::pair<uint32_t, uint32_t>, 4> RESOLUTIONS = {{{160u, 90u}, {320u, 180u}, {640u, 360u}, {1280u, 720u}}};
+
+    // That of the engine's camera.
+    constexpr float VERTICAL_FIELD_OF_VIEW = 45.0f;
+
+    // Unit cube, scaled and moved into walls by the occluder model matrices.
+    const std::array<math::XMFLOAT3, 8> cubePositions = {{
+        {-0.5f, -0.5f, -0.5f},
+        {0.5f, -0.5f, -0.5f},
+        {0.5f, 0.5f, -0.5f},
+        {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f, 0.5f},
+        {0.5f, -0.5f, 0.5f},
+        {0.5f, 0.5f, 0.5f},
+        {-0.5f, 0.5f, 0.5f},
+    }};
+
+    const std::array<uint32_t, 36> cubeIndices = {0u, 2u, 1u, 0u, 3u, 2u, 4u, 5u, 6u, 4u, 6u, 7u, 0u, 1u, 5u, 0u, 5u, 4u,
+                                                  3u, 7u, 6u, 3u, 6u, 2u, 0u, 4u, 7u, 0u, 7u, 3u, 1u, 2u, 6u, 1u, 6u, 5u};
+
+    // Rows of walls with gaps between them, in front of a camera looking down +z, and boxes scattered behind and between them.
+    std::vector<sgfx::Occluder> occluders{};
+    for (const uint32_t row : std::views::iota(0u, 4u))
+    {
+        for (const uint32_t column : std::views::iota(0u, 8u))
+        {
+            const float x = -105.0f + 30.0f * column + 7.0f * row;
+
+            occluders.emplace_back(sgfx::Occluder{
+                .positions = cubePositions,
+                .indices = cubeIndices,
+                .modelMatrix = math::XMMatrixScaling(14.0f, 12.0f, 1.0f) * math::XMMatrixTranslation(x, 6.0f, 20.0f + 25.0f * row),
+            });
+        }
+    }
+
+    std::mt19937 randomEngine(11u);
+    std::uniform_real_distribution<float> xDistribution(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> yDistribution(0.5f, 8.0f);
+    std::uniform_real_distribution<float> zDistribution(5.0f, 150.0f);
+
+    std::vector<sgfx::AxisAlignedBoundingBox> boxes(BOX_COUNT);
+    for (sgfx::AxisAlignedBoundingBox& box : boxes)
+    {
+        const math::XMFLOAT3 center = {xDistribution(randomEngine), yDistribution(randomEngine), zDistribution(randomEngine)};
+
+        box = sgfx::AxisAlignedBoundingBox{
+            .minimum = {center.x - 0.5f, center.y - 0.5f, center.z - 0.5f},
+            .maximum = {center.x + 0.5f, center.y + 0.5f, center.z + 0.5f},
+        };
+    }
+
+    const math::XMMATRIX viewMatrix =
+        math::XMMatrixLookAtLH(math::XMVectorSet(0.0f, 4.0f, 0.0f, 1.0f), math::XMVectorSet(0.0f, 4.0f, 1.0f, 1.0f), math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+    for (const auto& [width, height] : RESOLUTIONS)
+    {
+        const math::XMMATRIX viewProjectionMatrix =
+            viewMatrix * math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(VERTICAL_FIELD_OF_VIEW), width / static_cast<float>(height), 0.1f, 230.0f);
+
+        // Boxes outside the frustum are left to frustum culling, so the cull rate is that of occlusion alone.
+        const sgfx::Frustum frustum = sgfx::createFrustum(viewProjectionMatrix);
+        std::vector<sgfx::AxisAlignedBoundingBox> boxesInFrustum{};
+        std::ranges::copy_if(boxes, std::back_inserter(boxesInFrustum), [&](const sgfx::AxisAlignedBoundingBox& box) { return sgfx::isAabbInFrustum(frustum, box); });
+
+        sgfx::OcclusionBuffer occlusionBuffer{};
+        occlusionBuffer.resize(width, height);
+
+        const double rasterizationDuration =
+            sgfx::benchmark::measure(ITERATION_COUNT, [&]() { occlusionBuffer.rasterize(occluders, viewProjectionMatrix, jobSystem); });
+
+        uint32_t occludedBoxCount = 0u;
+        const double testDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                             [&]()
+                                                             {
+                                                                 occludedBoxCount = 0u;
+                                                                 for (const sgfx::AxisAlignedBoundingBox& box : boxesInFrustum)
+                                                                 {
+                                                                     occludedBoxCount += occlusionBuffer.isAabbVisible(box) ? 0u : 1u;
+                                                                 }
+                                                             });
+
+        std::cout << std::format("Occlusion culling benchmark ({} x {}, {} occluders) : rasterization {:.3f} ms, tests {:.3f} ms, {} of {} boxes "
+                                 "in the frustum culled ({:.1f}%).\n",
+                                 width,
+                                 height,
+                                 occluders.size(),
+                                 rasterizationDuration,
+                                 testDuration,
+                                 occludedBoxCount,
+                                 boxesInFrustum.size(),
+                                 100.0 * occludedBoxCount / std::max<size_t>(boxesInFrustum.size(), 1u));
+    }
+}
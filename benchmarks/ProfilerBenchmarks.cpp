@@ -0,0 +1,138 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "Profiler.hpp"
+
+// Times recording and draining profiler zones on one thread and on every thread, against the same loops without zones, and reading the
+// profiler clock against steady_clock.
+SGFX_BENCHMARK(Profiler)
+{
+    constexpr uint32_t ZONE_COUNT = 1u << 20u;
+
+    // Half the ring buffer capacity, so no zone is dropped between two drains, even if a single thread records all of them.
+    constexpr uint32_t ZONES_PER_DRAIN = sgfx::Profiler::RING_BUFFER_CAPACITY / 2u;
+
+    sgfx::Profiler& profiler = sgfx::getProfiler();
+
+    // Starts from empty buffers.
+    profiler.endFrame();
+    const uint64_t droppedEventCount = profiler.getStats().droppedEventCount;
+
+    // Written by every iteration, so the loops without zones are not optimized away.
+    volatile uint64_t sink = 0u;
+
+    double drainDuration = 0.0;
+
+    // Per zone, in nanoseconds. Only the recording is timed, the drains in between are timed separately.
+    const auto measure = [&](const auto& function)
+    {
+        std::chrono::duration<double, std::nano> duration{};
+        std::chrono::duration<double, std::nano> totalDrainDuration{};
+
+        for (uint32_t batch = 0u; batch < ZONE_COUNT / ZONES_PER_DRAIN; batch++)
+        {
+            const auto startTime = std::chrono::high_resolution_clock::now();
+            function();
+
+            const auto drainStartTime = std::chrono::high_resolution_clock::now();
+            profiler.endFrame();
+
+            duration += drainStartTime - startTime;
+            totalDrainDuration += std::chrono::high_resolution_clock::now() - drainStartTime;
+        }
+
+        drainDuration = totalDrainDuration.count() / ZONE_COUNT;
+        return duration.count() / ZONE_COUNT;
+    };
+
+    const double loopDuration = measure(
+        [&]()
+        {
+            for (uint32_t i = 0u; i < ZONES_PER_DRAIN; i++)
+            {
+                sink = i;
+            }
+        });
+
+    const double zoneLoopDuration = measure(
+        [&]()
+        {
+            for (uint32_t i = 0u; i < ZONES_PER_DRAIN; i++)
+            {
+                const sgfx::ProfilerScope scope("Profiler benchmark zone");
+                sink = i;
+            }
+        });
+
+    const double zoneDrainDuration = drainDuration;
+
+    // One zone per index, spread over every thread.
+    const uint32_t threadCount = jobSystem.getWorkerCount() + 1u;
+    const uint32_t batchSize = std::max(ZONES_PER_DRAIN / (threadCount * 4u), 1u);
+
+    const double parallelLoopDuration = measure(
+        [&]()
+        {
+            sgfx::JobCounter counter{};
+            jobSystem.parallelFor(ZONES_PER_DRAIN, batchSize, [&](const uint32_t index) { sink = index; }, counter);
+            jobSystem.wait(counter);
+        });
+
+    const double parallelZoneLoopDuration = measure(
+        [&]()
+        {
+            sgfx::JobCounter counter{};
+            jobSystem.parallelFor(
+                ZONES_PER_DRAIN,
+                batchSize,
+                [&](const uint32_t index)
+                {
+                    const sgfx::ProfilerScope scope("Profiler benchmark parallel zone");
+                    sink = index;
+                },
+                counter);
+            jobSystem.wait(counter);
+        });
+
+    const auto measureClock = [&](const auto& readClock)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        for (uint32_t i = 0u; i < ZONE_COUNT; i++)
+        {
+            sink = static_cast<uint64_t>(readClock());
+        }
+
+        const std::chrono::duration<double, std::nano> duration = std::chrono::high_resolution_clock::now() - startTime;
+        return duration.count() / ZONE_COUNT;
+    };
+
+    const double timestampDuration = measureClock([]() { return sgfx::getProfilerTimestamp(); });
+    const double steadyClockDuration = measureClock([]() { return std::chrono::steady_clock::now().time_since_epoch().count(); });
+
+#ifdef SGFX_PROFILER
+    constexpr std::string_view ZONE_STATE = "compiled in";
+#else
+    constexpr std::string_view ZONE_STATE = "compiled out";
+#endif
+
+    std::cout << std::format("Profiler benchmark ({} zones, zone macros {}) : {:.1f} ns per zone ({:.1f} ns per iteration, {:.1f} ns without zone), "
+                             "{:.1f} ns per zone to drain.\n",
+                             ZONE_COUNT,
+                             ZONE_STATE,
+                             zoneLoopDuration - loopDuration,
+                             zoneLoopDuration,
+                             loopDuration,
+                             zoneDrainDuration);
+
+    std::cout << std::format("Profiler benchmark ({} threads) : {:.1f} ns per zone ({:.1f} Mzones/s), {} zones dropped.\n",
+                             threadCount,
+                             parallelZoneLoopDuration - parallelLoopDuration,
+                             1000.0 / parallelZoneLoopDuration,
+                             profiler.getStats().droppedEventCount - droppedEventCount);
+
+    std::cout << std::format("Profiler clock : {:.1f} ns per timestamp, {:.1f} ns per steady_clock::now, {:.1f} ticks / us.\n",
+                             timestampDuration,
+                             steadyClockDuration,
+                             profiler.getStats().ticksPerMicrosecond);
+}
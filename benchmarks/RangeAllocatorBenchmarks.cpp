@@ -0,0 +1,63 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "RangeAllocator.hpp"
+
+// Times allocations and frees of random sizes in a geometry pool sized address space, keeping about a thousand ranges alive (as a scene of
+// models streaming in and out would), and reports the fragmentation they leave.
+SGFX_BENCHMARK(RangeAllocator)
+{
+    constexpr uint64_t CAPACITY = 64u * 1024u * 1024u;
+    constexpr uint32_t LIVE_RANGE_COUNT = 1024u;
+    constexpr uint32_t OPERATION_COUNT = 200'000u;
+
+    std::mt19937 randomEngine(5u);
+    std::uniform_int_distribution<uint64_t> sizeDistribution(256u, 64u * 1024u);
+
+    sgfx::RangeAllocator allocator{CAPACITY};
+    std::vector<std::pair<uint64_t, uint64_t>> liveRanges{};
+
+    uint32_t failedAllocationCount = 0u;
+
+    const double duration = sgfx::benchmark::measure(1u,
+                                                     [&]()
+                                                     {
+                                                         for (uint32_t i = 0u; i < OPERATION_COUNT; i++)
+                                                         {
+                                                             // Frees a random live range once enough are alive, allocates otherwise.
+                                                             if (liveRanges.size() >= LIVE_RANGE_COUNT || (!liveRanges.empty() && randomEngine() % 2u == 0u))
+                                                             {
+                                                                 const size_t index = randomEngine() % liveRanges.size();
+                                                                 allocator.free(liveRanges[index].first, liveRanges[index].second);
+
+                                                                 liveRanges[index] = liveRanges.back();
+                                                                 liveRanges.pop_back();
+                                                                 continue;
+                                                             }
+
+                                                             // Vertex sized alignments, as the geometry pool requests.
+                                                             const uint64_t size = sizeDistribution(randomEngine);
+                                                             const std::optional<uint64_t> offset = allocator.allocate(size, i % 2u == 0u ? 32u : 16u);
+
+                                                             if (offset.has_value())
+                                                             {
+                                                                 liveRanges.emplace_back(*offset, size);
+                                                             }
+                                                             else
+                                                             {
+                                                                 failedAllocationCount++;
+                                                             }
+                                                         }
+                                                     });
+
+    const sgfx::RangeAllocatorStats stats = allocator.getStats();
+
+    std::cout << std::format("Range allocator benchmark ({} operations, {} live ranges) : {:.1f} ns per operation, {} free blocks, fragmentation {:.3f}, "
+                             "{} failed allocations.\n",
+                             OPERATION_COUNT,
+                             stats.allocationCount,
+                             duration * 1e6 / OPERATION_COUNT,
+                             stats.freeBlockCount,
+                             stats.getFragmentation(),
+                             failedAllocationCount);
+}
@@ -0,0 +1,84 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "RenderQueue.hpp"
+
+// Times render item collection and radix sorting of 100k synthetic items, against std::stable_sort.
+SGFX_BENCHMARK(RenderQueue)
+{
+    constexpr uint32_t ITEM_COUNT = 100'000u;
+    constexpr uint32_t MATERIAL_COUNT = 500u;
+    constexpr uint32_t ITERATION_COUNT = 20u;
+
+    // Those of the engine's geometry pass, the same for every item as there.
+    constexpr uint32_t GEOMETRY_PASS_KEY = 0u;
+    constexpr uint32_t GEOMETRY_PIPELINE_KEY = 0u;
+
+    // Stand ins for meshes : a material and a distance to the camera each, collected the way Model::gatherRenderItems does.
+    std::mt19937 randomEngine(13u);
+    std::uniform_int_distribution<uint32_t> materialDistribution(0u, MATERIAL_COUNT - 1u);
+    std::uniform_real_distribution<float> distanceDistribution(0.0f, 200.0f);
+
+    std::vector<uint32_t> materials(ITEM_COUNT);
+    std::vector<float> distances(ITEM_COUNT);
+    for (const uint32_t i : std::views::iota(0u, ITEM_COUNT))
+    {
+        materials[i] = materialDistribution(randomEngine);
+        distances[i] = distanceDistribution(randomEngine);
+    }
+
+    sgfx::RenderQueue renderQueue{};
+    renderQueue.reserve(ITEM_COUNT);
+
+    double collectionDuration = 0.0;
+    double sortDuration = 0.0;
+
+    for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+    {
+        const auto collectionStartTime = std::chrono::high_resolution_clock::now();
+
+        renderQueue.clear();
+        for (const uint32_t i : std::views::iota(0u, ITEM_COUNT))
+        {
+            renderQueue.add(sgfx::RenderQueue::createSortKey(GEOMETRY_PASS_KEY, GEOMETRY_PIPELINE_KEY, materials[i], distances[i] * distances[i]),
+                            sgfx::RenderItem{.meshIndex = i});
+        }
+
+        const auto sortStartTime = std::chrono::high_resolution_clock::now();
+
+        renderQueue.sort();
+
+        const auto endTime = std::chrono::high_resolution_clock::now();
+
+        collectionDuration += std::chrono::duration<double, std::milli>(sortStartTime - collectionStartTime).count();
+        sortDuration += std::chrono::duration<double, std::milli>(endTime - sortStartTime).count();
+    }
+
+    // The same keys through a comparison sort, stable as the radix sort is, so both orders must match.
+    std::vector<std::pair<uint64_t, uint32_t>> referenceItems(ITEM_COUNT);
+    double referenceSortDuration = 0.0;
+
+    for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+    {
+        for (const uint32_t i : std::views::iota(0u, ITEM_COUNT))
+        {
+            referenceItems[i] = {sgfx::RenderQueue::createSortKey(GEOMETRY_PASS_KEY, GEOMETRY_PIPELINE_KEY, materials[i], distances[i] * distances[i]), i};
+        }
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        std::ranges::stable_sort(referenceItems, {}, &std::pair<uint64_t, uint32_t>::first);
+
+        referenceSortDuration += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+
+    const bool isOrderMatching = std::ranges::equal(renderQueue.getItems(), referenceItems, {}, &sgfx::RenderItem::meshIndex, &std::pair<uint64_t, uint32_t>::second);
+
+    std::cout << std::format("Render queue benchmark ({} items, {} materials) : collection {:.3f} ms, radix sort {:.3f} ms, std::stable_sort {:.3f} ms{}.\n",
+                             ITEM_COUNT,
+                             MATERIAL_COUNT,
+                             collectionDuration / ITERATION_COUNT,
+                             sortDuration / ITERATION_COUNT,
+                             referenceSortDuration / ITERATION_COUNT,
+                             isOrderMatching ? "" : " (orders differ)");
+}
@@ -0,0 +1,87 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "ShaderCache.hpp"
+
+// Times the key of every shader of the repository (reading and scanning the files), and a cache hit against a miss, with a compiler that
+// returns the source as bytecode so the results do not depend on the platform's shader compiler.
+SGFX_BENCHMARK(ShaderCache)
+{
+    constexpr uint32_t ITERATION_COUNT = 20u;
+
+    std::vector<sgfx::ShaderCompileDesc> compileDescs{};
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator("shaders"))
+    {
+        if (entry.path().extension() == ".hlsl")
+        {
+            compileDescs.push_back(sgfx::ShaderCompileDesc{.path = entry.path(), .entryPoint = "PsMain", .target = "ps_5_0"});
+        }
+    }
+
+    if (compileDescs.empty())
+    {
+        std::cout << "Shader cache benchmark : no shader found, run from the repository root.\n";
+        return;
+    }
+
+    const sgfx::ShaderCompiler compiler = [](const sgfx::ShaderCompileDesc& compileDesc)
+    {
+        const std::string source = sgfx::readShaderFile(compileDesc.path).value_or("");
+        const std::span<const std::byte> bytes = std::as_bytes(std::span(source));
+
+        return std::vector<std::byte>(bytes.begin(), bytes.end());
+    };
+
+    const std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "sgfx_shader_cache_benchmark";
+
+    // Written by every iteration, so the results are not optimized away.
+    volatile uint64_t sink = 0u;
+
+    const double keyDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                        [&]()
+                                                        {
+                                                            for (const sgfx::ShaderCompileDesc& compileDesc : compileDescs)
+                                                            {
+                                                                sink = sgfx::computeShaderKey(compileDesc);
+                                                            }
+                                                        });
+
+    // Every iteration starts from an empty cache directory, so every request misses. Clearing the directory is timed on its own.
+    const auto clearCache = [&]()
+    {
+        std::error_code errorCode{};
+        std::filesystem::remove_all(cacheDirectory, errorCode);
+    };
+
+    const double clearDuration = sgfx::benchmark::measure(ITERATION_COUNT, clearCache);
+
+    const double missDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                         [&]()
+                                                         {
+                                                             clearCache();
+
+                                                             sgfx::ShaderCache shaderCache(cacheDirectory, compiler);
+                                                             for (const sgfx::ShaderCompileDesc& compileDesc : compileDescs)
+                                                             {
+                                                                 sink = shaderCache.getShader(compileDesc).size();
+                                                             }
+                                                         });
+
+    sgfx::ShaderCache shaderCache(cacheDirectory, compiler);
+    const double hitDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                        [&]()
+                                                        {
+                                                            for (const sgfx::ShaderCompileDesc& compileDesc : compileDescs)
+                                                            {
+                                                                sink = shaderCache.getShader(compileDesc).size();
+                                                            }
+                                                        });
+
+    clearCache();
+
+    std::cout << std::format("Shader cache benchmark ({} shaders) : keys {:.3f} ms, hits {:.3f} ms, misses {:.3f} ms with the mock compiler.\n",
+                             compileDescs.size(),
+                             keyDuration,
+                             hitDuration,
+                             missDuration - clearDuration);
+}
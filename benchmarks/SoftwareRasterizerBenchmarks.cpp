@@ -0,0 +1,81 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "Camera.hpp"
+#include "GeometryPool.hpp"
+#include "Model.hpp"
+#include "NullRenderBackend.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "TextureCache.hpp"
+
+// Renders Sponza from the engine's starting camera with the software rasterizer at several resolutions, reporting triangle and pixel
+// throughput, and writes the G-buffer of the largest one as PNG images. Golden images are checked by the tests, on a small textured scene.
+SGFX_BENCHMARK(SoftwareRasterizerSponza)
+{
+    constexpr uint32_t ITERATION_COUNT = 10u;
+    constexpr std::array<std::pair<uint32_t, uint32_t>, 3> RESOLUTIONS = {{{640u, 360u}, {1280u, 720u}, {1920u, 1080u}}};
+    constexpr std::string_view PNG_PATH_PREFIX = "software_rasterizer";
+
+    sgfx::NullRenderBackend renderBackend{};
+
+    sgfx::GeometryPool geometryPool(renderBackend,
+                                    sgfx::GeometryPoolCreationDesc{
+                                        .vertexBufferSize = 64u * 1024u * 1024u,
+                                        .shortIndexCapacity = 8u * 1024u * 1024u,
+                                        .indexCapacity = 4u * 1024u * 1024u,
+                                    });
+
+    sgfx::TextureCache textureCache(renderBackend, jobSystem);
+    const sgfx::TextureHandle fallbackTexture = textureCache.getTexture("assets/textures/Default.png", sgfx::TextureUsage::Albedo);
+
+    // Placed as the engine places it, with the engine's cook options so the cooked model is shared with it.
+    sgfx::Model sponza(renderBackend,
+                       geometryPool,
+                       textureCache,
+                       fallbackTexture,
+                       jobSystem,
+                       "assets/models/sponza-gltf-pbr/sponza.glb",
+                       sgfx::TransformComponent{.scale = {0.1f, 0.1f, 0.1f}},
+                       sgfx::ModelLoadOptions{.generateMeshlets = true, .generateLods = true, .keepRasterData = true});
+
+    const math::XMMATRIX viewMatrix = sgfx::Camera{}.getLookAtMatrix();
+    sponza.updateTransformBuffer(viewMatrix, renderBackend);
+
+    std::vector<sgfx::RasterMesh> meshes{};
+    sponza.gatherRasterMeshes(meshes);
+
+    sgfx::SoftwareRasterizer rasterizer{};
+
+    for (const auto& [width, height] : RESOLUTIONS)
+    {
+        // The engine's projection.
+        const math::XMMATRIX projectionMatrix = math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(45.0f), width / static_cast<float>(height), 0.1f, 230.0f);
+
+        rasterizer.resize(width, height);
+
+        // Grows the per mesh and per tile vectors to their final size.
+        rasterizer.render(meshes, viewMatrix, projectionMatrix, jobSystem);
+
+        sgfx::SoftwareRasterizationStats stats{};
+        const double frameDuration = sgfx::benchmark::measure(ITERATION_COUNT, [&]() { stats = rasterizer.render(meshes, viewMatrix, projectionMatrix, jobSystem); });
+
+        std::cout << std::format("Software rasterizer benchmark ({} x {}, {} meshes, {} threads) : {:.2f} ms, {:.1f} Mtris/s ({} triangles, {} rasterized), "
+                                 "{:.1f} Mpix/s ({} pixels shaded, {} written).\n",
+                                 width,
+                                 height,
+                                 stats.meshCount,
+                                 jobSystem.getWorkerCount() + 1u,
+                                 frameDuration,
+                                 stats.triangleCount / (frameDuration * 1000.0),
+                                 stats.triangleCount,
+                                 stats.rasterizedTriangleCount,
+                                 stats.shadedPixelCount / (frameDuration * 1000.0),
+                                 stats.shadedPixelCount,
+                                 stats.writtenPixelCount);
+    }
+
+    if (!rasterizer.writePngs(PNG_PATH_PREFIX))
+    {
+        std::cout << std::format("Software rasterizer benchmark : failed to write {}_*.png.\n", PNG_PATH_PREFIX);
+    }
+}
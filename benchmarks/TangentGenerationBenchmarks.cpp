@@ -0,0 +1,63 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "TangentGeneration.hpp"
+
+// Generates the tangents of a displaced grid of a million vertices, as model loading does for primitives without tangents.
+SGFX_BENCHMARK(TangentGeneration)
+{
+    constexpr uint32_t GRID_SIZE = 1000u;
+    constexpr uint32_t ITERATION_COUNT = 3u;
+
+    std::vector<sgfx::ModelVertex> sourceVertices{};
+    for (uint32_t y = 0u; y <= GRID_SIZE; y++)
+    {
+        for (uint32_t x = 0u; x <= GRID_SIZE; x++)
+        {
+            const float u = static_cast<float>(x) / GRID_SIZE;
+            const float v = static_cast<float>(y) / GRID_SIZE;
+
+            math::XMFLOAT3 normal{};
+            math::XMStoreFloat3(&normal, math::XMVector3Normalize(math::XMVectorSet(-std::cos(20.0f * u), 0.0f, 1.0f, 0.0f)));
+
+            sourceVertices.push_back(sgfx::ModelVertex{.position = {u, v, 0.05f * std::sin(20.0f * u)}, .textureCoord = {u, 1.0f - v}, .normal = normal});
+        }
+    }
+
+    std::vector<uint32_t> sourceIndices{};
+    for (uint32_t y = 0u; y < GRID_SIZE; y++)
+    {
+        for (uint32_t x = 0u; x < GRID_SIZE; x++)
+        {
+            const uint32_t v00 = y * (GRID_SIZE + 1u) + x;
+            const uint32_t v01 = v00 + GRID_SIZE + 1u;
+
+            sourceIndices.insert(sourceIndices.end(), {v00, v00 + 1u, v01 + 1u, v00, v01 + 1u, v01});
+        }
+    }
+
+    std::vector<sgfx::ModelVertex> vertices{};
+    std::vector<uint32_t> indices{};
+
+    // computeTangents may append vertices and rewrite indices, so every call starts from a copy. The copy is timed on its own.
+    const double copyDuration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                         [&]()
+                                                         {
+                                                             vertices = sourceVertices;
+                                                             indices = sourceIndices;
+                                                         });
+
+    const double duration = sgfx::benchmark::measure(ITERATION_COUNT,
+                                                     [&]()
+                                                     {
+                                                         vertices = sourceVertices;
+                                                         indices = sourceIndices;
+                                                         sgfx::computeTangents(vertices, indices);
+                                                     });
+
+    std::cout << std::format("Tangent generation benchmark ({} vertices, {} triangles) : {:.1f} ms ({:.1f} ns per vertex).\n",
+                             sourceVertices.size(),
+                             sourceIndices.size() / 3u,
+                             duration - copyDuration,
+                             (duration - copyDuration) * 1e6 / sourceVertices.size());
+}
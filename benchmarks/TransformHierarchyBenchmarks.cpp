@@ -0,0 +1,74 @@
+#include "Pch.hpp"
+
+#include "Benchmark.hpp"
+#include "TransformHierarchy.hpp"
+
+// Times full and partial world matrix updates of a synthetic transform hierarchy of tens of thousands of nodes.
+SGFX_BENCHMARK(TransformHierarchy)
+{
+    constexpr uint32_t NODE_COUNT = 50'000u;
+    constexpr uint32_t ITERATION_COUNT = 100u;
+
+    // Roughly 1% of the nodes are edited per partial update.
+    constexpr uint32_t PARTIAL_UPDATE_DIRTY_NODE_COUNT = NODE_COUNT / 100u;
+
+    // Random tree with the same shape every run : each node picks a parent among the last few nodes added, giving deep and wide subtrees.
+    std::mt19937 randomEngine(42u);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    const auto createLocalTransform = [&]()
+    {
+        sgfx::LocalTransform localTransform{.translation = {distribution(randomEngine), distribution(randomEngine), distribution(randomEngine)}};
+
+        math::XMStoreFloat4(&localTransform.rotation,
+                            math::XMQuaternionRotationRollPitchYaw(distribution(randomEngine), distribution(randomEngine), distribution(randomEngine)));
+
+        return localTransform;
+    };
+
+    sgfx::TransformHierarchy transformHierarchy{};
+    transformHierarchy.reserve(NODE_COUNT);
+
+    transformHierarchy.addNode(sgfx::INVALID_INDEX_U32, createLocalTransform());
+    for (uint32_t nodeIndex = 1u; nodeIndex < NODE_COUNT; nodeIndex++)
+    {
+        const uint32_t parentIndex = nodeIndex - 1u - std::min(nodeIndex - 1u, static_cast<uint32_t>(randomEngine() % 16u));
+        transformHierarchy.addNode(parentIndex, createLocalTransform());
+    }
+
+    transformHierarchy.updateWorldMatrices();
+
+    const auto measure = [&](const uint32_t dirtyNodeCount)
+    {
+        double totalDuration = 0.0;
+        uint64_t totalUpdatedNodeCount = 0u;
+
+        for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+        {
+            // Editing is not timed, only the propagation is.
+            for (uint32_t i = 0u; i < dirtyNodeCount; i++)
+            {
+                const uint32_t nodeIndex = dirtyNodeCount == NODE_COUNT ? i : static_cast<uint32_t>(randomEngine() % NODE_COUNT);
+                transformHierarchy.setLocalTransform(nodeIndex, transformHierarchy.getLocalTransform(nodeIndex));
+            }
+
+            const auto startTime = std::chrono::high_resolution_clock::now();
+
+            totalUpdatedNodeCount += transformHierarchy.updateWorldMatrices();
+
+            const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+            totalDuration += duration.count();
+        }
+
+        return std::format("{:.3f} ms avg, {:.0f} nodes updated", totalDuration / ITERATION_COUNT, static_cast<double>(totalUpdatedNodeCount) / ITERATION_COUNT);
+    };
+
+    const std::string fullUpdateResult = measure(NODE_COUNT);
+    const std::string partialUpdateResult = measure(PARTIAL_UPDATE_DIRTY_NODE_COUNT);
+
+    std::cout << std::format("Transform hierarchy benchmark ({} nodes) : full update {}, partial update ({} dirty nodes) {}.\n",
+                             NODE_COUNT,
+                             fullUpdateResult,
+                             PARTIAL_UPDATE_DIRTY_NODE_COUNT,
+                             partialUpdateResult);
+}
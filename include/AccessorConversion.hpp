@@ -0,0 +1,36 @@
+#pragma once
+
+namespace sgfx
+{
+    // Strided view over the elements of a glTF accessor. componentType uses the glTF component type values (5120 -> BYTE ... 5126 -> FLOAT).
+    struct AccessorView
+    {
+        const uint8_t* data{};
+        uint32_t byteStride{};
+        uint32_t count{};
+
+        uint32_t componentType{};
+        uint32_t componentCount{};
+        bool normalized{};
+    };
+
+    // Writes componentCount floats per element to destination + elementIndex * destinationStride. Bytes between the elements are left untouched, so
+    // the attributes of an interleaved vertex can be converted one after the other.
+    // Integer components are converted as per the glTF specification (i.e divided by the max value if normalized, cast otherwise).
+    void convertAccessorToFloats(const AccessorView& accessor, std::byte* const destination, const uint32_t destinationStride);
+
+    // Attribute of an interleaved destination vertex, destinationOffset bytes from the start of the vertex.
+    struct AttributeConversion
+    {
+        AccessorView accessor{};
+        uint32_t destinationOffset{};
+    };
+
+    // Converts every attribute as convertAccessorToFloats does, but a block of vertices at a time, so each vertex is written while it is in cache
+    // rather than streamed through memory once per attribute. Converts as many vertices as the first accessor has, an accessor with fewer elements
+    // leaves the remaining vertices untouched.
+    void convertAttributesToFloats(std::span<const AttributeConversion> attributes, std::byte* const destination, const uint32_t destinationStride);
+
+    // Widens unsigned byte / short / int indices to 32 bit.
+    void convertIndices(const AccessorView& accessor, uint32_t* const destination);
+}
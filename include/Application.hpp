@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Camera.hpp"
+#include "GeometryPool.hpp"
+#include "JobSystem.hpp"
 #include "Model.hpp"
-
-#include <imgui.h>
-#include <imgui_impl_dx11.h>
-#include <imgui_impl_sdl.h>
+#include "Profiler.hpp"
+#include "RenderBackend.hpp"
+#include "ShaderCache.hpp"
+#include "TextureCache.hpp"
 
 struct SDL_Window;
 
@@ -17,49 +19,72 @@ namespace sgfx
         Application(const std::string_view windowTitle);
         virtual ~Application();
 
+#ifdef _WIN32
+        // Opens a window and renders into it with the D3D11 backend until it is closed. The window, the user interface and the D3D11 backend
+        // only exist on Windows (see ApplicationWindow.cpp), every other platform only has the headless runs below.
         void run();
+#endif
+
+        // Loads the content on the null render backend, without a window or device, and runs benchmark() instead of the frame loop.
+        void runBenchmark();
+
+        // Loads the content on the null render backend, without a window or device, then runs frameCount frames of update() and
+        // renderHeadless(), and prints their CPU times.
+        void runHeadless(const uint32_t frameCount);
 
       protected:
         virtual void init();
         virtual void cleanup();
 
+        virtual void benchmark() {}
+
+        // The CPU side of a frame, which only submits to m_renderBackend.
+        virtual void renderHeadless() {}
+
         virtual void loadContent() = 0;
         virtual void update(const float deltaTime) = 0;
+
+#ifdef _WIN32
+        // A frame of the window, user interface included.
         virtual void render() = 0;
+#endif
 
         template <typename T> void updateConstantBuffer(ConstantBuffer<T>& buffer) const;
 
-        void bindPipeline(const GraphicsPipeline& pipeline);
-        void bindTexturePS(ID3D11ShaderResourceView* const srv, const uint32_t bindSlot);
+        // Every resource is created through m_renderBackend, released when the returned object is destroyed.
+        [[nodiscard]] BackendResource createGraphicsPipeline(const BackendPipelineDesc& pipelineDesc);
 
-        [[nodiscard]] wrl::ComPtr<ID3D11VertexShader> createVertexShader(const std::wstring_view shaderPath, wrl::ComPtr<ID3DBlob>& outShaderBlob);
-        [[nodiscard]] wrl::ComPtr<ID3D11PixelShader> createPixelShader(const std::wstring_view shaderPath);
+        // Creates the pipelines as parallel jobs, so shader cache misses compile concurrently.
+        [[nodiscard]] std::vector<BackendResource> createGraphicsPipelines(std::span<const BackendPipelineDesc> pipelineDescs);
 
-        [[nodiscard]] wrl::ComPtr<ID3D11InputLayout> createInputLayout(ID3DBlob* const vertexShaderBlob, std::span<const InputLayoutElementDesc> inputLayoutElementDescs);
+        template <typename T> [[nodiscard]] BackendResource createTexture(const std::span<const T> data, const uint32_t width, const uint32_t height, const TextureFormat format);
+        [[nodiscard]] BackendResource createSampler(const BackendSamplerDesc& samplerDesc);
 
-        [[nodiscard]] GraphicsPipeline createGraphicsPipeline(const GraphicsPipelineCreationDesc& pipelineCreationDesc);
+        [[nodiscard]] RenderTarget createRenderTarget(const uint32_t width, const uint32_t height, const TextureFormat format);
 
-        [[nodiscard]] wrl::ComPtr<ID3D11ShaderResourceView> createTexture(const std::wstring_view texturePath);
-        template <typename T> [[nodiscard]] wrl::ComPtr<ID3D11ShaderResourceView> createTexture(const std::span<const T> data, const uint32_t width, const uint32_t height, const DXGI_FORMAT format);
-        [[nodiscard]] wrl::ComPtr<ID3D11SamplerState> createSampler(const SamplerCreationDesc& samplerCreationDesc);
+        [[nodiscard]] Model createModel(const std::string_view modelPath, const sgfx::TransformComponent& transformData = {}, const ModelLoadOptions& loadOptions = {});
 
-        [[nodiscard]] RenderTarget createRenderTarget(const uint32_t width, const uint32_t height, const DXGI_FORMAT format);
+        // D32Float render target of the window's size.
+        [[nodiscard]] RenderTarget createDepthTexture();
 
-        [[nodiscard]] Model createModel(const std::string_view modelPath, const sgfx::TransformComponent& transformData = {});
-
-        [[nodiscard]] DepthTexture createDepthTexture();
-
-        template <typename T> [[nodiscard]] wrl::ComPtr<ID3D11Buffer> createBuffer(const BufferCreationDesc& bufferCreationDesc, std::span<const T> data = {});
+        template <typename T> [[nodiscard]] BackendResource createBuffer(const BufferType type, std::span<const T> data);
         template <typename T> [[nodiscard]] ConstantBuffer<T> createConstantBuffer();
 
-      private:
-        void createDeviceResources();
-        void createSwapchainResources();
+#ifdef _WIN32
+        // Creates the window, the user interface and the D3D11 backend, and destroys the window and the user interface.
+        void initWindow();
+        void cleanupWindow();
+
+        // Starts a frame of the user interface on the backend and the window, then ends it and draws it on top of the back buffer.
+        void beginUserInterfaceFrame();
+        void renderUserInterface();
+#endif
 
       protected:
-        template <typename T> using comptr = Microsoft::WRL::ComPtr<T>;
+        // Shared by all loading and per frame work. Declared first so it is destroyed after every resource that might still have jobs in flight.
+        JobSystem m_jobSystem{};
 
-        HWND m_windowHandle{};
+        // Not created when headless.
         SDL_Window* m_window{};
 
         uint32_t m_windowWidth{};
@@ -67,108 +92,61 @@ namespace sgfx
 
         std::string m_windowTitle{};
 
-        comptr<ID3D11Device> m_device{};
-        comptr<ID3D11Debug> m_debug{};
-        comptr<ID3D11InfoQueue> m_infoQueue{};
-        comptr<ID3D11DeviceContext> m_deviceContext{};
-        comptr<IDXGIFactory6> m_factory{};
-        comptr<IDXGISwapChain1> m_swapchain{};
-        comptr<ID3D11RenderTargetView> m_renderTargetView{};
+        bool m_isHeadless{false};
 
-        D3D11_VIEWPORT m_viewport{};
+        // Covers the whole window.
+        SetViewportCommand m_viewport{};
 
         Camera m_camera{};
 
+        // Compiled shaders, persisted across runs. Only used by the D3D11 backend, so not created when headless.
+        std::unique_ptr<ShaderCache> m_shaderCache{};
+
+        // The D3D11 backend, or the null backend when headless. Declared before everything holding backend resources, so it outlives them.
+        std::unique_ptr<RenderBackend> m_renderBackend{};
+
+        // Vertices and indices of every model, models refer to ranges within it.
+        std::unique_ptr<GeometryPool> m_geometryPool{};
+
+        // Textures of every model, shared between all materials using the same image.
+        std::unique_ptr<TextureCache> m_textureCache{};
+
         // Default / Fallback resources.
-        comptr<ID3D11ShaderResourceView> m_fallbackTexture{};
+        TextureHandle m_fallbackTexture{};
     };
 
     template <typename T> inline void Application::updateConstantBuffer(ConstantBuffer<T>& buffer) const
     {
-        m_deviceContext->UpdateSubresource(buffer.buffer.Get(), 0u, nullptr, &buffer.data, 0u, 0u);
+        m_renderBackend->updateBuffer(buffer.buffer.get(), std::as_bytes(std::span(&buffer.data, 1u)));
     }
 
     template <typename T>
-    inline wrl::ComPtr<ID3D11ShaderResourceView> Application::createTexture(const std::span<const T> data, const uint32_t width, const uint32_t height, const DXGI_FORMAT format)
+    inline BackendResource Application::createTexture(const std::span<const T> data, const uint32_t width, const uint32_t height, const TextureFormat format)
     {
-        comptr<ID3D11Texture2D> texture{};
-        comptr<ID3D11ShaderResourceView> srv{};
-
-        const D3D11_TEXTURE2D_DESC textureDesc = {
-            .Width = width,
-            .Height = height,
-            .MipLevels = 1u,
-            .ArraySize = 1u,
-            .Format = format,
-            .SampleDesc = {1u, 0u},
-            .Usage = D3D11_USAGE_IMMUTABLE,
-            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
-            .CPUAccessFlags = 0u,
-        };
-
-        // SysMemPitch is hardcoded to fit for SSAO noise texture, should probably be modified soon.
-        const D3D11_SUBRESOURCE_DATA subresourceData = {
-            .pSysMem = data.data(),
-            .SysMemPitch = width * sizeof(T),
-
+        const BackendTextureDesc textureDesc = {
+            .width = width,
+            .height = height,
+            .format = format,
         };
 
-        throwIfFailed(m_device->CreateTexture2D(&textureDesc, &subresourceData, &texture));
+        return BackendResource(*m_renderBackend, m_renderBackend->createTexture(textureDesc, std::as_bytes(data)));
+    }
 
-        const D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
-            .Format = format,
-            .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
-            .Texture2D =
-                {
-                    .MostDetailedMip = 0u,
-                    .MipLevels = 1u,
-                },
+    template <typename T> inline BackendResource Application::createBuffer(const BufferType type, std::span<const T> data)
+    {
+        const BackendBufferDesc bufferDesc = {
+            .type = type,
+            .size = static_cast<uint32_t>(data.size_bytes()),
         };
 
-        throwIfFailed(m_device->CreateShaderResourceView(texture.Get(), &srvDesc, &srv));
-
-        return srv;
+        return BackendResource(*m_renderBackend, m_renderBackend->createBuffer(bufferDesc, std::as_bytes(data)));
     }
 
-    template <typename T> inline wrl::ComPtr<ID3D11Buffer> Application::createBuffer(const BufferCreationDesc& bufferCreationDesc, std::span<const T> data)
-    {
-        comptr<ID3D11Buffer> buffer{};
-
-        if (data.size() != 0)
-        {
-            const D3D11_BUFFER_DESC bufferDesc = {
-                .ByteWidth = static_cast<uint32_t>(data.size_bytes()),
-                .Usage = bufferCreationDesc.usage,
-                .BindFlags = bufferCreationDesc.bindFlags,
-            };
-
-            const D3D11_SUBRESOURCE_DATA resourceData = {.pSysMem = data.data()};
-
-            throwIfFailed(m_device->CreateBuffer(&bufferDesc, &resourceData, &buffer));
-        }
-        else
-        {
-            // If the code reaches here, this buffer is a constant buffer.
-            const D3D11_BUFFER_DESC bufferDesc = {
-                .ByteWidth = static_cast<uint32_t>(sizeof(T)),
-                .Usage = bufferCreationDesc.usage,
-                .BindFlags = bufferCreationDesc.bindFlags,
-                .CPUAccessFlags = 0u,
-            };
-
-            throwIfFailed(m_device->CreateBuffer(&bufferDesc, nullptr, &buffer));
-        }
-
-        return buffer;
-    }
     template <typename T> inline ConstantBuffer<T> Application::createConstantBuffer()
     {
         ConstantBuffer<T> constantBuffer{};
-        constantBuffer.buffer = createBuffer<T>(BufferCreationDesc{
-            .usage = D3D11_USAGE_DEFAULT,
-            .bindFlags = D3D11_BIND_CONSTANT_BUFFER,
-        });
+        constantBuffer.buffer = createBuffer(BufferType::Constant, std::span<const T>(&constantBuffer.data, 1u));
 
         return constantBuffer;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+namespace sgfx
+{
+    // Block compressed formats written by the texture cooker. The encoders only depend on the standard library (and SSE2 when available), so they can
+    // be built and tested on any platform.
+    enum class BlockFormat : uint8_t
+    {
+        // RGB, 4 bits per pixel.
+        BC1,
+        // RGB (as BC1) and alpha (as BC4), 8 bits per pixel.
+        BC3,
+        // Single channel (red), 4 bits per pixel.
+        BC4,
+        // Two channels (red and green), 8 bits per pixel.
+        BC5,
+        // RGBA, 8 bits per pixel. Only mode 6 (single subset, 7 bit endpoints with a p-bit and 4 bit indices) is produced.
+        BC7,
+    };
+
+    [[nodiscard]] constexpr std::string_view getBlockFormatName(const BlockFormat format)
+    {
+        constexpr std::array<std::string_view, 5u> names = {"BC1", "BC3", "BC4", "BC5", "BC7"};
+        return names[static_cast<size_t>(format)];
+    }
+
+    static constexpr uint32_t BLOCK_WIDTH = 4u;
+    static constexpr uint32_t BLOCK_PIXEL_COUNT = BLOCK_WIDTH * BLOCK_WIDTH;
+
+    // 4x4 RGBA8 pixels, row major.
+    using BlockPixels = std::array<uint8_t, BLOCK_PIXEL_COUNT * 4u>;
+
+    [[nodiscard]] constexpr uint32_t getBlockSize(const BlockFormat format) { return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8u : 16u; }
+
+    // Number of channels the format stores, i.e the channels read by the encoder : RGB for BC1, RGBA for BC3 and BC7, R for BC4 and RG for BC5.
+    [[nodiscard]] constexpr uint32_t getBlockChannelCount(const BlockFormat format)
+    {
+        switch (format)
+        {
+            case BlockFormat::BC1:
+                return 3u;
+            case BlockFormat::BC4:
+                return 1u;
+            case BlockFormat::BC5:
+                return 2u;
+            default:
+                return 4u;
+        }
+    }
+
+    void compressBlock(const BlockFormat format, const BlockPixels& pixels, std::byte* const outBlock);
+
+    // Channels the format does not store are decoded as 0 (and alpha as 255).
+    void decompressBlock(const BlockFormat format, const std::byte* const block, BlockPixels& outPixels);
+
+    // Compresses rows [firstBlockRow, firstBlockRow + blockRowCount) of blocks of an RGBA8 image into outBlocks (the blocks of the whole image).
+    // Blocks overlapping the right or bottom edge repeat the last column / row.
+    void compressBlockRows(const BlockFormat format,
+                           std::span<const uint8_t> pixels,
+                           const uint32_t width,
+                           const uint32_t height,
+                           const uint32_t firstBlockRow,
+                           const uint32_t blockRowCount,
+                           std::span<std::byte> outBlocks);
+
+    void decompressImage(const BlockFormat format, std::span<const std::byte> blocks, const uint32_t width, const uint32_t height, std::span<uint8_t> outPixels);
+
+    // Peak signal to noise ratio (in dB) over the channels the format stores, infinity if both images are identical.
+    [[nodiscard]] double computePsnr(const BlockFormat format, std::span<const uint8_t> pixels, std::span<const uint8_t> decodedPixels);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+namespace sgfx
+{
+    struct Frustum;
+
+    // Four children per node, stored as structure of arrays so a single SIMD test covers all of them. Each child covers a contiguous range
+    // of the BVH's primitives : a child without a node is a leaf, otherwise the range is everything below it.
+    struct alignas(64) BvhNode
+    {
+        std::array<float, 4> minimumX{};
+        std::array<float, 4> minimumY{};
+        std::array<float, 4> minimumZ{};
+        std::array<float, 4> maximumX{};
+        std::array<float, 4> maximumY{};
+        std::array<float, 4> maximumZ{};
+
+        std::array<uint32_t, 4> childNodes{INVALID_INDEX_U32, INVALID_INDEX_U32, INVALID_INDEX_U32, INVALID_INDEX_U32};
+        std::array<uint32_t, 4> firstPrimitives{};
+        std::array<uint32_t, 4> primitiveCounts{};
+
+        // Children are packed in the first childCount lanes.
+        uint32_t childCount{};
+    };
+
+    struct BvhRayHit
+    {
+        uint32_t primitiveIndex{INVALID_INDEX_U32};
+        float distance{std::numeric_limits<float>::infinity()};
+
+        bool isHit() const { return primitiveIndex != INVALID_INDEX_U32; }
+    };
+
+    // Distance along the ray to the closest hit with the primitive if it is below maxDistance, infinity otherwise.
+    using BvhRayIntersector = std::function<float(const uint32_t primitiveIndex, const Ray& ray, const float maxDistance)>;
+
+    // Bounding volume hierarchy over the bounds of arbitrary primitives (meshes, triangles...), built with the binned surface area heuristic
+    // and flattened depth first, so every node comes before its children. Queries return the indices of the primitives as given to build.
+    class Bvh
+    {
+      public:
+        // Leaves hold at most maxLeafPrimitiveCount primitives, fewer when splitting is cheaper.
+        void build(std::span<const AxisAlignedBoundingBox> primitiveBounds, const uint32_t maxLeafPrimitiveCount = 4u);
+
+        // Recomputes the node bounds after primitives moved, keeping the tree structure. Much cheaper than build, but the tree degrades when
+        // primitives move far from where they were at build time.
+        void refit(std::span<const AxisAlignedBoundingBox> primitiveBounds);
+
+        // Appends the primitives that may be in each frustum to the matching output, in a single traversal (e.g for the camera and shadow
+        // cascades). Subtrees fully inside a frustum are appended without testing them, and primitives are tested through their leaf bounds,
+        // so results are conservative. At most 32 frustums.
+        void queryFrustums(std::span<const Frustum> frustums, std::span<std::vector<uint32_t>> outPrimitives) const;
+        void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& outPrimitives) const;
+
+        // Closest hit along the ray, visiting children front to back and skipping those beyond the closest hit found so far.
+        BvhRayHit raycast(const Ray& ray, const BvhRayIntersector& intersector) const;
+
+        AxisAlignedBoundingBox getBounds() const;
+
+        uint32_t getNodeCount() const { return static_cast<uint32_t>(m_nodes.size()); }
+        uint32_t getPrimitiveCount() const { return static_cast<uint32_t>(m_primitiveIndices.size()); }
+
+      private:
+        struct BuildNode
+        {
+            AxisAlignedBoundingBox bounds{};
+
+            uint32_t firstPrimitive{};
+            uint32_t primitiveCount{};
+
+            std::array<uint32_t, 2> children{INVALID_INDEX_U32, INVALID_INDEX_U32};
+        };
+
+        uint32_t buildBinaryNode(std::span<const AxisAlignedBoundingBox> primitiveBounds,
+                                 std::span<const math::XMFLOAT3> centroids,
+                                 const uint32_t firstPrimitive,
+                                 const uint32_t primitiveCount,
+                                 const uint32_t maxLeafPrimitiveCount,
+                                 std::vector<BuildNode>& buildNodes);
+
+        // Collapses the binary tree into four wide nodes, returns the index of the node.
+        uint32_t emitNode(std::span<const BuildNode> buildNodes, const uint32_t buildNodeIndex);
+
+      private:
+        std::vector<BvhNode> m_nodes{};
+
+        // Primitive indices, reordered so every node covers a contiguous range.
+        std::vector<uint32_t> m_primitiveIndices{};
+    };
+
+    // Distance along the ray to the triangle (either side), infinity if it is missed or beyond the ray (Moller - Trumbore).
+    [[nodiscard]] float intersectRayTriangle(const Ray& ray, const math::XMFLOAT3& p0, const math::XMFLOAT3& p1, const math::XMFLOAT3& p2);
+
+    // Distance along the ray to the box (0 if the origin is inside), infinity if it is missed.
+    [[nodiscard]] float intersectRayAabb(const Ray& ray, const AxisAlignedBoundingBox& bounds);
+}
@@ -23,6 +23,10 @@ namespace sgfx
 
         math::XMMATRIX getLookAtMatrix();
 
+        // World space ray from the near plane through the point (x, y) of the viewport (in pixels from its top left corner), ending at the far
+        // plane (maxDistance is 1).
+        Ray getScreenRay(const float x, const float y, const float viewportWidth, const float viewportHeight, const math::XMMATRIX projectionMatrix);
+
       public:
         // Note that the default values for the vectors must be set correctly (especially the W component).
         math::XMFLOAT4 m_cameraPosition{0.0f, 0.0f, -5.0f, 1.0f};
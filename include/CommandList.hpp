@@ -0,0 +1,259 @@
+#pragma once
+
+namespace sgfx
+{
+    // Backend object (pipeline, buffer, view, sampler or render target) a command refers to. Command lists only store them : the backend
+    // replaying a list knows what they point to.
+    using BackendHandle = const void*;
+
+    enum class ShaderStage : uint8_t
+    {
+        Vertex,
+        Pixel,
+    };
+
+    enum class CommandType : uint8_t
+    {
+        SetPipeline,
+        SetRenderTargets,
+        ClearRenderTarget,
+        ClearDepthStencil,
+        SetViewport,
+        SetVertexBuffer,
+        SetIndexBuffer,
+        SetConstantBuffer,
+        SetShaderResource,
+        SetSampler,
+        Draw,
+        DrawIndexed,
+        DrawIndexedInstanced,
+    };
+
+    static constexpr uint32_t MAX_RENDER_TARGET_COUNT = 4u;
+
+    struct SetPipelineCommand
+    {
+        static constexpr CommandType TYPE = CommandType::SetPipeline;
+
+        BackendHandle pipeline{};
+    };
+
+    struct SetRenderTargetsCommand
+    {
+        static constexpr CommandType TYPE = CommandType::SetRenderTargets;
+
+        std::array<BackendHandle, MAX_RENDER_TARGET_COUNT> renderTargets{};
+        BackendHandle depthStencil{};
+        uint32_t renderTargetCount{};
+    };
+
+    struct ClearRenderTargetCommand
+    {
+        static constexpr CommandType TYPE = CommandType::ClearRenderTarget;
+
+        BackendHandle renderTarget{};
+        std::array<float, 4u> color{};
+    };
+
+    struct ClearDepthStencilCommand
+    {
+        static constexpr CommandType TYPE = CommandType::ClearDepthStencil;
+
+        BackendHandle depthStencil{};
+        float depth{1.0f};
+    };
+
+    struct SetViewportCommand
+    {
+        static constexpr CommandType TYPE = CommandType::SetViewport;
+
+        float x{};
+        float y{};
+        float width{};
+        float height{};
+        float minimumDepth{};
+        float maximumDepth{1.0f};
+    };
+
+    struct SetVertexBufferCommand
+    {
+        static constexpr CommandType TYPE = CommandType::SetVertexBuffer;
+
+        BackendHandle buffer{};
+        uint32_t stride{};
+        uint32_t offset{};
+    };
+
+    struct SetIndexBufferCommand
+    {
+        static constexpr CommandType TYPE = CommandType::SetIndexBuffer;
+
+        BackendHandle buffer{};
+
+        // 2 or 4 bytes.
+        uint32_t indexSize{};
+    };
+
+    struct SetConstantBufferCommand
+    {
+        static constexpr CommandType TYPE = CommandType::SetConstantBuffer;
+
+        BackendHandle buffer{};
+        ShaderStage stage{};
+        uint32_t slot{};
+    };
+
+    struct SetShaderResourceCommand
+    {
+        static constexpr CommandType TYPE = CommandType::SetShaderResource;
+
+        BackendHandle resource{};
+        ShaderStage stage{};
+        uint32_t slot{};
+    };
+
+    struct SetSamplerCommand
+    {
+        static constexpr CommandType TYPE = CommandType::SetSampler;
+
+        BackendHandle sampler{};
+        ShaderStage stage{};
+        uint32_t slot{};
+    };
+
+    struct DrawCommand
+    {
+        static constexpr CommandType TYPE = CommandType::Draw;
+
+        uint32_t vertexCount{};
+        uint32_t firstVertex{};
+    };
+
+    struct DrawIndexedCommand
+    {
+        static constexpr CommandType TYPE = CommandType::DrawIndexed;
+
+        uint32_t indexCount{};
+        uint32_t firstIndex{};
+        int32_t baseVertex{};
+    };
+
+    struct DrawIndexedInstancedCommand
+    {
+        static constexpr CommandType TYPE = CommandType::DrawIndexedInstanced;
+
+        uint32_t indexCount{};
+        uint32_t instanceCount{};
+        uint32_t firstIndex{};
+        int32_t baseVertex{};
+        uint32_t firstInstance{};
+    };
+
+    // Commands recorded into a linear arena of fixed size blocks, independent of any graphics API. Recording never moves the commands already
+    // recorded, and reset keeps the blocks, so a list reused every frame stops allocating once it has grown to its usual size. A list is
+    // recorded by a single thread : record one list per thread, then append them in order (or replay them one after the other).
+    class CommandList
+    {
+      public:
+        static constexpr uint32_t BLOCK_SIZE = 64u * 1024u;
+
+        // Forgets the commands, keeping the blocks.
+        void reset();
+
+        template <typename T> void record(const T& command);
+
+        // Copies the commands of other after those of this list.
+        void append(const CommandList& other);
+
+        // Calls visitor with every command (as its own command type), in recording order.
+        template <typename Visitor> void forEach(Visitor&& visitor) const;
+
+        uint32_t getCommandCount() const { return m_commandCount; }
+        uint32_t getDrawCount() const { return m_drawCount; }
+
+        // Recorded bytes, headers and padding included.
+        uint64_t getSize() const;
+
+      private:
+        // Precedes each command. size is that of the header and command, rounded up so the next header stays aligned.
+        struct alignas(8) CommandHeader
+        {
+            CommandType type{};
+            uint32_t size{};
+        };
+
+        template <typename T> static constexpr uint32_t getRecordSize();
+
+        // Space for size bytes within the current block, starting a new block if they do not fit.
+        std::byte* allocate(const uint32_t size);
+        void startBlock();
+
+      private:
+        std::vector<std::unique_ptr<std::byte[]>> m_blocks{};
+
+        // Bytes recorded in each block. Only the first m_usedBlockCount blocks hold commands, the rest are kept for later.
+        std::vector<uint32_t> m_blockSizes{};
+        uint32_t m_usedBlockCount{};
+
+        uint32_t m_commandCount{};
+        uint32_t m_drawCount{};
+    };
+
+    template <typename T> inline constexpr uint32_t CommandList::getRecordSize()
+    {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= alignof(CommandHeader));
+
+        return static_cast<uint32_t>((sizeof(CommandHeader) + sizeof(T) + alignof(CommandHeader) - 1u) & ~(alignof(CommandHeader) - 1u));
+    }
+
+    template <typename T> inline void CommandList::record(const T& command)
+    {
+        constexpr uint32_t recordSize = getRecordSize<T>();
+
+        std::byte* const record = allocate(recordSize);
+        new (record) CommandHeader{.type = T::TYPE, .size = recordSize};
+        new (record + sizeof(CommandHeader)) T(command);
+
+        m_commandCount++;
+
+        if constexpr (T::TYPE == CommandType::Draw || T::TYPE == CommandType::DrawIndexed || T::TYPE == CommandType::DrawIndexedInstanced)
+        {
+            m_drawCount++;
+        }
+    }
+
+    template <typename Visitor> inline void CommandList::forEach(Visitor&& visitor) const
+    {
+        const auto visit = [&]<typename T>(const std::byte* const command) { visitor(*std::launder(reinterpret_cast<const T*>(command))); };
+
+        for (const uint32_t blockIndex : std::views::iota(0u, m_usedBlockCount))
+        {
+            const std::byte* const block = m_blocks[blockIndex].get();
+
+            for (uint32_t offset = 0u; offset < m_blockSizes[blockIndex];)
+            {
+                const CommandHeader& header = *std::launder(reinterpret_cast<const CommandHeader*>(block + offset));
+                const std::byte* const command = block + offset + sizeof(CommandHeader);
+
+                switch (header.type)
+                {
+                    case CommandType::SetPipeline: visit.template operator()<SetPipelineCommand>(command); break;
+                    case CommandType::SetRenderTargets: visit.template operator()<SetRenderTargetsCommand>(command); break;
+                    case CommandType::ClearRenderTarget: visit.template operator()<ClearRenderTargetCommand>(command); break;
+                    case CommandType::ClearDepthStencil: visit.template operator()<ClearDepthStencilCommand>(command); break;
+                    case CommandType::SetViewport: visit.template operator()<SetViewportCommand>(command); break;
+                    case CommandType::SetVertexBuffer: visit.template operator()<SetVertexBufferCommand>(command); break;
+                    case CommandType::SetIndexBuffer: visit.template operator()<SetIndexBufferCommand>(command); break;
+                    case CommandType::SetConstantBuffer: visit.template operator()<SetConstantBufferCommand>(command); break;
+                    case CommandType::SetShaderResource: visit.template operator()<SetShaderResourceCommand>(command); break;
+                    case CommandType::SetSampler: visit.template operator()<SetSamplerCommand>(command); break;
+                    case CommandType::Draw: visit.template operator()<DrawCommand>(command); break;
+                    case CommandType::DrawIndexed: visit.template operator()<DrawIndexedCommand>(command); break;
+                    case CommandType::DrawIndexedInstanced: visit.template operator()<DrawIndexedInstancedCommand>(command); break;
+                }
+
+                offset += header.size;
+            }
+        }
+    }
+}
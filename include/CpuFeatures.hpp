@@ -0,0 +1,27 @@
+#pragma once
+
+// Functions using instructions above the x64 baseline (SSE2) are tagged with these, and must only be called after checking getCpuFeatures().
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SGFX_TARGET_SSE41
+#define SGFX_TARGET_AVX2
+#define SGFX_TARGET_F16C
+#define SGFX_TARGET_SSE41_F16C
+#else
+#define SGFX_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SGFX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SGFX_TARGET_F16C __attribute__((target("f16c")))
+#define SGFX_TARGET_SSE41_F16C __attribute__((target("sse4.1,f16c")))
+#endif
+
+namespace sgfx
+{
+    struct CpuFeatures
+    {
+        bool sse41{};
+        bool avx2{};
+        bool f16c{};
+    };
+
+    // Queried once, on first use.
+    [[nodiscard]] const CpuFeatures& getCpuFeatures();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CommandList.hpp"
+
+namespace sgfx
+{
+    // Object behind the pipeline handles of the D3D11 backend.
+    struct GraphicsPipeline
+    {
+        wrl::ComPtr<ID3D11VertexShader> vertexShader{};
+        wrl::ComPtr<ID3D11PixelShader> pixelShader{};
+        wrl::ComPtr<ID3D11InputLayout> inputLayout{};
+
+        D3D11_PRIMITIVE_TOPOLOGY primitiveTopology{};
+
+        uint32_t vertexSize{};
+    };
+
+    // Executes the commands on the context, immediate or deferred. Pipeline handles point to a GraphicsPipeline, the other handles to the
+    // D3D11 object their command binds (buffers, views and samplers), render target and depth stencil views for clears.
+    void replayCommandList(ID3D11DeviceContext* const deviceContext, const CommandList& commandList);
+}
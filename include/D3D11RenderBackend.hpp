@@ -0,0 +1,115 @@
+#pragma once
+
+#include "D3D11CommandList.hpp"
+#include "RenderBackend.hpp"
+
+namespace sgfx
+{
+    class JobSystem;
+    class ShaderCache;
+    struct ShaderCompileDesc;
+
+    struct D3D11RenderBackendCreationDesc
+    {
+        HWND windowHandle{};
+        uint32_t width{};
+        uint32_t height{};
+    };
+
+    // Compiles HLSL with D3DCompileFromFile, the compiler of the shader caches the backend loads its shaders from.
+    [[nodiscard]] std::vector<std::byte> compileD3D11Shader(const ShaderCompileDesc& compileDesc);
+
+    // Backend owning the D3D11 device, the swapchain of the window and the Dear ImGui DX11 renderer (the ImGui context must outlive it).
+    // Buffer and sampler handles are D3D11 objects, render target handles their render target (or depth stencil) views, texture handles their
+    // shader resource views and pipeline handles GraphicsPipeline objects, as replayCommandList expects. The shader cache and job system must
+    // outlive the backend.
+    class D3D11RenderBackend final : public RenderBackend
+    {
+      public:
+        D3D11RenderBackend(const D3D11RenderBackendCreationDesc& creationDesc, ShaderCache& shaderCache, JobSystem& jobSystem);
+        ~D3D11RenderBackend() override;
+
+        D3D11RenderBackend(const D3D11RenderBackend&) = delete;
+        D3D11RenderBackend& operator=(const D3D11RenderBackend&) = delete;
+
+        [[nodiscard]] BackendHandle createBuffer(const BackendBufferDesc& bufferDesc, std::span<const std::byte> data = {}) override;
+        [[nodiscard]] BackendHandle createTexture(const BackendTextureDesc& textureDesc, std::span<const std::byte> data) override;
+        [[nodiscard]] BackendRenderTargetHandles createRenderTarget(const BackendRenderTargetDesc& renderTargetDesc) override;
+        [[nodiscard]] BackendHandle createSampler(const BackendSamplerDesc& samplerDesc) override;
+        [[nodiscard]] BackendHandle createGraphicsPipeline(const BackendPipelineDesc& pipelineDesc) override;
+
+        void releaseResource(const BackendHandle handle) override;
+
+        void updateBuffer(const BackendHandle buffer, std::span<const std::byte> data, const uint32_t offset = 0u) override;
+
+        // Replays the lists on the immediate context, or (if parallel submission is enabled) on one deferred context each, as parallel jobs,
+        // executing the resulting D3D11 command lists in order.
+        using RenderBackend::submit;
+        void submit(std::span<const CommandList> commandLists) override;
+
+        BackendHandle getBackBuffer() const override { return m_backBufferRtv.Get(); }
+
+        void beginUserInterfaceFrame() override;
+        void renderUserInterface() override;
+
+        void present() override;
+
+        RenderBackendStats getStats() const override;
+
+      private:
+        enum class ResourceType : uint8_t
+        {
+            Buffer,
+            Texture,
+            RenderTarget,
+
+            // Sampled view of a render target, counted with it.
+            RenderTargetTexture,
+            Sampler,
+            Pipeline,
+        };
+
+        struct Resource
+        {
+            ResourceType type{};
+
+            // Buffers, views and samplers.
+            wrl::ComPtr<ID3D11DeviceChild> object{};
+            std::unique_ptr<GraphicsPipeline> pipeline{};
+
+            // In bytes, of buffers, textures and render targets.
+            uint64_t size{};
+        };
+
+        void createDeviceResources();
+        void createSwapchainResources(const D3D11RenderBackendCreationDesc& creationDesc);
+
+        // Called with m_mutex locked.
+        BackendHandle addResource(const BackendHandle handle, Resource&& resource);
+
+      private:
+        ShaderCache& m_shaderCache;
+        JobSystem& m_jobSystem;
+
+        wrl::ComPtr<IDXGIFactory6> m_factory{};
+
+        wrl::ComPtr<ID3D11Device> m_device{};
+        wrl::ComPtr<ID3D11Debug> m_debug{};
+        wrl::ComPtr<ID3D11InfoQueue> m_infoQueue{};
+        wrl::ComPtr<ID3D11DeviceContext> m_deviceContext{};
+
+        // One per job system thread (the main thread included), so command lists can be replayed in parallel.
+        std::vector<wrl::ComPtr<ID3D11DeviceContext>> m_deferredContexts{};
+        std::vector<wrl::ComPtr<ID3D11CommandList>> m_deferredCommandLists{};
+
+        wrl::ComPtr<IDXGISwapChain1> m_swapchain{};
+        wrl::ComPtr<ID3D11RenderTargetView> m_backBufferRtv{};
+
+        // Guards the resources and the stats, as resources are created and released by any thread. Also serializes the buffer updates on the
+        // immediate context.
+        mutable std::mutex m_mutex{};
+        std::unordered_map<BackendHandle, Resource> m_resources{};
+
+        RenderBackendStats m_stats{};
+    };
+}
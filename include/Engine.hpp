@@ -1,44 +1,166 @@
 #pragma once
 
 #include "Application.hpp"
+#include "SceneBvh.hpp"
+#include "SoftwareDeferredPasses.hpp"
 
 class Engine final : public sgfx::Application
 {
   public:
-    Engine(const std::string_view windowTitle);
+    // Compact vertices (16 instead of 32 bytes) halve vertex fetch bandwidth, at a small precision loss.
+    Engine(const std::string_view windowTitle, const sgfx::VertexFormat vertexFormat = sgfx::VertexFormat::Float);
 
     void loadContent() override;
     void update(const float deltaTime) override;
+    void renderHeadless() override;
+
+#ifdef _WIN32
+    // Builds the user interface, then renders the frame and the user interface into the window (in EngineWindow.cpp).
     void render() override;
+#endif
+
+  private:
+    // Shared by the camera path recording and the benchmarks (in EngineBenchmarks.cpp).
+    static constexpr std::string_view CAMERA_PATH_FILE = "camera_path.bin";
+    static constexpr float VERTICAL_FIELD_OF_VIEW = 45.0f;
+
+    struct CameraPathFrame
+    {
+        math::XMFLOAT4 position{};
+        float pitch{};
+        float yaw{};
+    };
+
+    void benchmark() override;
+
+    math::XMMATRIX getProjectionMatrix() const;
+
+    // Moves the lights to view space, into the scene buffer, and updates the transforms of the point lights' models.
+    void updateLights(const math::XMMATRIX viewMatrix);
+
+    // Selects LODs for every model from the camera position.
+    sgfx::LodSelectionStats selectLods(const math::XMFLOAT3& cameraPosition);
+
+    // Requests texture mips for every model from the camera position, then swaps in the mips streamed since the last frame.
+    void streamTextures(const math::XMFLOAT3& cameraPosition);
+
+    // Culls the meshes of every model against the frustum (or clears the results if mesh culling is disabled), and times the pass.
+    sgfx::MeshCullingStats cullMeshes(const sgfx::Frustum& frustum);
+
+    // Rasterizes the occluders among the meshes kept by cullMeshes into the occlusion buffer, then culls the meshes hidden behind them
+    // (moving them from visible to occluded in the stats), and times the pass. Does nothing if occlusion culling is disabled.
+    void cullOccludedMeshes(const math::XMMATRIX viewProjectionMatrix, sgfx::MeshCullingStats& stats);
+
+    // Fills the render queue with the meshes every model draws this frame, then sorts it, and times the pass.
+    void collectRenderItems(const math::XMFLOAT3& cameraPosition);
+
+    // Records the render queue into command lists in parallel, each list taking a contiguous range of the items and setting up the pass
+    // itself (so the backend can translate it on its own), and times it.
+    void recordGeometryPass();
+
+    // Submits the geometry pass command lists to the render backend (which may translate them in parallel), and times it.
+    void submitGeometryPass();
+
+    // Records and submits every pass of a frame but the user interface, up to the fullscreen pass into the back buffer.
+    void renderFrame();
+
+    bool loadCameraPath();
+
+    // Replays the recorded camera path through LOD selection and meshlet culling only (nothing is rendered) and reports the triangles
+    // submitted per frame.
+    void runCameraPathBenchmark();
+
+    // Renders the G-buffer of Sponza from the starting camera with the software rasterizer (its throughput is benchmarked in the benchmarks
+    // project), and shades it with the overload below.
+    void runSoftwareDeferredPassesBenchmark();
+
+    // Times the software SSAO, blur and lighting passes over the G-buffer, and SSAO alone for several sample counts and radii (reporting
+    // how far the occlusion is from that of all the samples), and writes the images as PNG. Golden images are checked by the tests, on a
+    // synthetic G-buffer.
+    void runSoftwareDeferredPassesBenchmark(const sgfx::GBufferImages& gbuffer, const math::XMMATRIX viewMatrix, const math::XMMATRIX projectionMatrix);
+
+    // Picks the mesh under the point (x, y) of the window through the scene BVH.
+    void pickMesh(const float x, const float y);
 
   private:
-    sgfx::DepthTexture m_depthTexture{};
+    // Requested for every model, models that cannot use compact vertices fall back to float vertices.
+    sgfx::VertexFormat m_vertexFormat{sgfx::VertexFormat::Float};
+
+    sgfx::RenderTarget m_depthTexture{};
     sgfx::RenderTarget m_offscreenRT{};
-    comptr<ID3D11SamplerState> m_offscreenSampler{};
-    comptr<ID3D11SamplerState> m_wrapSampler{};
+    sgfx::BackendResource m_offscreenSampler{};
+    sgfx::BackendResource m_wrapSampler{};
 
-    sgfx::GraphicsPipeline m_pipeline{};
-    sgfx::GraphicsPipeline m_lightPipeline{};
-    sgfx::GraphicsPipeline m_fullscreenPassPipeline{};
+    sgfx::BackendResource m_pipeline{};
+    // Pipelines consuming model vertices, indexed by vertex format.
+    std::array<sgfx::BackendResource, 2> m_lightPipelines{};
+    sgfx::BackendResource m_fullscreenPassPipeline{};
 
     sgfx::ConstantBuffer<sgfx::SceneBuffer> m_sceneBuffer{};
 
     std::unordered_map<std::string, sgfx::Model> m_renderables{};
 
+    // Meshes of every renderable drawn by the geometry pass, in sorted order.
+    sgfx::RenderQueue m_renderQueue{};
+    sgfx::DrawSubmissionStats m_drawSubmissionStats{};
+    double m_renderQueueDuration{};
+
+    // The geometry pass, recorded in parallel.
+    std::vector<sgfx::CommandList> m_geometryCommandLists{};
+    double m_commandRecordingDuration{};
+    double m_commandSubmissionDuration{};
+
+    // Over the meshes of every renderable, named by m_sceneModelNames.
+    sgfx::SceneBvh m_sceneBvh{};
+    std::vector<std::string> m_sceneModelNames{};
+    std::string m_pickResult{};
+
     sgfx::Model m_lightModel{};
     sgfx::ConstantBuffer<sgfx::LightMatrix> m_lightMatricesBuffer{};
     std::array<math::XMFLOAT4, sgfx::LIGHT_COUNT - 1u> m_lightPositions{};
 
     std::array<sgfx::RenderTarget, 3> m_gpassRts{};
-    sgfx::GraphicsPipeline m_gpassPipeline{};
-    sgfx::DepthTexture m_gpassDepthTexture{};
+    std::array<sgfx::BackendResource, 2> m_gpassPipelines{};
+    sgfx::RenderTarget m_gpassDepthTexture{};
 
-    comptr<ID3D11ShaderResourceView> m_ssaoRandomRotationTexture{};
-    sgfx::GraphicsPipeline m_ssaoPipeline{};
-    sgfx::GraphicsPipeline m_boxBlurPipeline{};
+    sgfx::BackendResource m_ssaoRandomRotationTexture{};
+    sgfx::BackendResource m_ssaoPipeline{};
+    sgfx::BackendResource m_boxBlurPipeline{};
     sgfx::RenderTarget m_ssaoRt{};
     sgfx::RenderTarget m_ssaoBlurredRt{};
     sgfx::ConstantBuffer<sgfx::SSAOBuffer> m_ssaoBuffer{};
 
+    // The clears before the geometry pass, then the passes after it, recorded every frame.
+    sgfx::CommandList m_frameCommandList{};
+
+    // Texels of m_ssaoRandomRotationTexture, kept for the software SSAO.
+    std::array<math::XMFLOAT2, 64> m_ssaoNoise{};
+
     float m_sunAngle{123.0f};
+
+    bool m_isLodSelectionEnabled{true};
+    float m_lodErrorThreshold{1.0f};
+    sgfx::LodSelectionStats m_lodSelectionStats{};
+
+    bool m_isMeshCullingEnabled{true};
+    sgfx::MeshCullingStats m_meshCullingStats{};
+    double m_meshCullingDuration{};
+
+    bool m_isOcclusionCullingEnabled{true};
+    sgfx::OcclusionBuffer m_occlusionBuffer{};
+    sgfx::OccluderSelectionDesc m_occluderSelectionDesc{.minimumRadius = 1.0f, .maximumTriangleCount = 4096u};
+    std::vector<sgfx::Occluder> m_occluders{};
+    sgfx::OcclusionRasterizationStats m_occlusionRasterizationStats{};
+    double m_occlusionCullingDuration{};
+
+    bool m_isMeshletCullingEnabled{true};
+    sgfx::MeshletCullingStats m_meshletCullingStats{};
+
+    // Camera path used by the benchmark, recorded one frame at a time and saved to / loaded from CAMERA_PATH_FILE.
+    std::vector<CameraPathFrame> m_cameraPath{};
+    bool m_isRecordingCameraPath{false};
+    bool m_isCameraPathBenchmarkRequested{false};
+    std::string m_cameraPathBenchmarkResult{};
+
+    std::string m_profilerCaptureResult{};
 };
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CpuFeatures.hpp"
+
+namespace sgfx
+{
+    // Planes are normalized and point inwards : a point p is inside the frustum if dot(plane.xyz, p) + plane.w >= 0 for every plane.
+    struct Frustum
+    {
+        enum PlaneIndex : uint32_t
+        {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            PlaneCount,
+        };
+
+        std::array<math::XMFLOAT4, PlaneCount> planes{};
+    };
+
+    // Extracts the planes of a (row vector) view projection matrix with a [0, 1] depth range.
+    [[nodiscard]] Frustum createFrustum(const math::XMMATRIX viewProjectionMatrix);
+
+    // Moves the frustum into the space that transformMatrix maps from, e.g. passing the model matrix gives an object space frustum.
+    [[nodiscard]] Frustum transformFrustum(const Frustum& frustum, const math::XMMATRIX transformMatrix);
+
+    [[nodiscard]] bool isSphereInFrustum(const Frustum& frustum, const math::XMFLOAT3& center, const float radius);
+    [[nodiscard]] bool isAabbInFrustum(const Frustum& frustum, const AxisAlignedBoundingBox& bounds);
+
+    // Bounding box (as center and half extents) and bounding sphere of many objects, as structure of arrays so cullBoundingVolumes can test
+    // several objects per iteration.
+    struct BoundingVolumes
+    {
+        std::vector<float> boxCenterX{};
+        std::vector<float> boxCenterY{};
+        std::vector<float> boxCenterZ{};
+
+        std::vector<float> boxExtentX{};
+        std::vector<float> boxExtentY{};
+        std::vector<float> boxExtentZ{};
+
+        std::vector<float> sphereCenterX{};
+        std::vector<float> sphereCenterY{};
+        std::vector<float> sphereCenterZ{};
+        std::vector<float> sphereRadius{};
+
+        void resize(const uint32_t count);
+        void set(const uint32_t index, const AxisAlignedBoundingBox& box, const math::XMFLOAT3& sphereCenter, const float radius);
+
+        uint32_t getCount() const { return static_cast<uint32_t>(sphereRadius.size()); }
+    };
+
+    // Writes 1 to outIsVisible[i] if object i may be in the frustum, 0 otherwise, and returns the number of visible objects. An object is culled
+    // if either its box or its sphere is fully outside a plane, which rejects more than either volume alone. Tests 8 objects per iteration with
+    // AVX2, 4 otherwise. Passing cpuFeatures without AVX2 forces the SSE2 path, so tests can check both.
+    uint32_t cullBoundingVolumes(const Frustum& frustum, const BoundingVolumes& volumes, std::span<uint8_t> outIsVisible, const CpuFeatures& cpuFeatures = getCpuFeatures());
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "RangeAllocator.hpp"
+#include "RenderBackend.hpp"
+
+namespace sgfx
+{
+    struct GeometryPoolCreationDesc
+    {
+        // The vertex buffer is sized in bytes, as it holds vertices of every vertex format. Index capacities are in indices.
+        uint32_t vertexBufferSize{};
+        uint32_t shortIndexCapacity{};
+        uint32_t indexCapacity{};
+    };
+
+    // Range of elements (vertices of a given size, or indices) within one of the pool buffers.
+    struct GeometryRange
+    {
+        uint32_t first{};
+        uint32_t count{};
+    };
+
+    struct GeometryPoolStats
+    {
+        RangeAllocatorStats vertices{};
+        RangeAllocatorStats shortIndices{};
+        RangeAllocatorStats indices{};
+    };
+
+    // Packs the vertices and indices of every model into one vertex buffer and one index buffer per index format, so meshes are drawn with
+    // base vertex / first index offsets instead of binding their own buffers. Uploading and freeing is thread safe, uploads are staged and only
+    // written into the buffers by flushUploads. Indices are either 2 or 4 bytes, each size having its own buffer.
+    class GeometryPool
+    {
+      public:
+        GeometryPool(RenderBackend& renderBackend, const GeometryPoolCreationDesc& geometryPoolCreationDesc);
+
+        GeometryPool(const GeometryPool&) = delete;
+        GeometryPool& operator=(const GeometryPool&) = delete;
+
+        // Allocates the range and stages a copy of the data. Draws of the range can be recorded right away, but not submitted before the next
+        // flushUploads.
+        [[nodiscard]] GeometryRange uploadVertices(const std::span<const std::byte> vertexData, const uint32_t vertexSize);
+        [[nodiscard]] GeometryRange uploadIndices(const std::span<const std::byte> indexData, const uint32_t indexSize);
+
+        // Writes the staged uploads into the buffers through RenderBackend::updateBuffer. Must be called by the thread submitting to the
+        // backend, as the D3D11 backend updates buffers on its immediate context.
+        void flushUploads();
+
+        void freeVertices(const GeometryRange& range, const uint32_t vertexSize);
+        void freeIndices(const GeometryRange& range, const uint32_t indexSize);
+
+        // For recording the binds into a command list.
+        BackendHandle getVertexBuffer() const { return m_vertexBuffer.buffer.get(); }
+        BackendHandle getIndexBuffer(const uint32_t indexSize) const { return getIndexPoolBuffer(indexSize).buffer.get(); }
+
+        GeometryPoolStats getStats() const;
+
+      private:
+        struct PoolBuffer
+        {
+            BackendResource buffer{};
+            RangeAllocator allocator{};
+            uint32_t elementSize{};
+        };
+
+        PoolBuffer createPoolBuffer(const uint32_t elementSize, const uint32_t capacity, const BufferType bufferType) const;
+
+        PoolBuffer& getIndexPoolBuffer(const uint32_t indexSize);
+        const PoolBuffer& getIndexPoolBuffer(const uint32_t indexSize) const;
+
+        GeometryRange upload(PoolBuffer& poolBuffer, const std::span<const std::byte> data, const uint32_t alignment);
+
+      private:
+        struct StagedUpload
+        {
+            BackendHandle buffer{};
+            uint32_t offset{};
+            std::vector<std::byte> data{};
+        };
+
+        RenderBackend& m_renderBackend;
+
+        PoolBuffer m_vertexBuffer{};
+        PoolBuffer m_shortIndexBuffer{};
+        PoolBuffer m_indexBuffer{};
+
+        // In upload order, so a range freed and allocated again before the flush ends up with the data of its last upload.
+        std::vector<StagedUpload> m_stagedUploads{};
+
+        mutable std::mutex m_mutex{};
+    };
+
+    // Ranges owned by a single model. Returned to the pool on destruction, so share it (rather than copy it) between copies of a model.
+    struct GeometryAllocation
+    {
+        GeometryAllocation(GeometryPool& geometryPool) : geometryPool(geometryPool) {}
+        ~GeometryAllocation();
+
+        GeometryAllocation(const GeometryAllocation&) = delete;
+        GeometryAllocation& operator=(const GeometryAllocation&) = delete;
+
+        GeometryPool& geometryPool;
+
+        GeometryRange vertexRange{};
+        uint32_t vertexSize{};
+
+        // With their index size.
+        std::vector<std::pair<GeometryRange, uint32_t>> indexRanges{};
+    };
+}
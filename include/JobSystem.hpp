@@ -0,0 +1,124 @@
+#pragma once
+
+namespace sgfx
+{
+    enum class JobPriority : uint8_t
+    {
+        Normal,
+
+        // Background work (texture streaming, cooking helpers) : only run by workers with no normal job to run, and by threads waiting on a
+        // low priority counter, so frame critical waits never pick up a long running job.
+        Low,
+    };
+
+    // Tracks the number of in-flight jobs submitted against it. Jobs that depend on a counter are only queued once the counter reaches zero.
+    // Exceptions thrown by a job are captured in the counter and rethrown by JobSystem::wait.
+    class JobCounter
+    {
+      public:
+        explicit JobCounter(const JobPriority priority = JobPriority::Normal) : m_priority(priority) {}
+
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+      private:
+        friend class JobSystem;
+
+        struct Continuation
+        {
+            std::function<void()> function{};
+            JobCounter* counter{};
+        };
+
+        const JobPriority m_priority{};
+
+        std::atomic<uint32_t> m_pendingJobs{0u};
+
+        std::mutex m_mutex{};
+        std::vector<Continuation> m_continuations{};
+        std::exception_ptr m_exception{};
+    };
+
+    // Fixed size work stealing scheduler. Each worker owns a deque : it pushes / pops from the back and other threads steal from the front.
+    // Threads that wait on a counter execute pending jobs of the same or a higher priority instead of blocking.
+    class JobSystem
+    {
+      public:
+        using JobFunction = std::function<void()>;
+
+        // If workerCount is 0, one worker is created per hardware thread (minus the main thread, which helps out while waiting).
+        explicit JobSystem(const uint32_t workerCount = 0u);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void submit(JobFunction job, JobCounter& counter, JobCounter* const dependency = nullptr);
+
+        // Splits [0, count) into batches of batchSize indices, each of which is executed as a single job.
+        void parallelFor(const uint32_t count, const uint32_t batchSize, const std::function<void(const uint32_t)>& job, JobCounter& counter);
+
+        // Runs pending jobs until the counter reaches zero (low priority jobs only if the counter is low priority). Rethrows the first exception thrown by a job of the counter.
+        void wait(JobCounter& counter);
+
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+      private:
+        struct Job
+        {
+            JobFunction function{};
+            JobCounter* counter{};
+        };
+
+        struct WorkerQueue
+        {
+            std::mutex mutex{};
+            std::deque<Job> jobs{};
+        };
+
+        void pushJob(Job&& job);
+        bool tryRunJob(const bool canRunLowPriorityJobs);
+        void execute(Job& job);
+
+        void workerLoop(const std::stop_token stopToken, const uint32_t workerIndex);
+
+      private:
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues{};
+        std::vector<std::jthread> m_workers{};
+
+        // Shared by all workers, as low priority jobs are few and long.
+        WorkerQueue m_lowPriorityQueue{};
+
+        std::atomic<uint32_t> m_queuedJobCount{0u};
+        std::atomic<uint32_t> m_nextQueueIndex{0u};
+
+        std::mutex m_sleepMutex{};
+        std::condition_variable_any m_sleepCondition{};
+    };
+
+    // Waits on a counter when leaving the scope, so jobs referring to the caller's stack cannot outlive it if the caller throws before its own
+    // wait. Exceptions thrown by the jobs are dropped while unwinding, the caller's explicit wait still rethrows them.
+    class ScopedJobWait
+    {
+      public:
+        ScopedJobWait(JobSystem& jobSystem, JobCounter& counter) : m_jobSystem(jobSystem), m_counter(counter) {}
+
+        ~ScopedJobWait()
+        {
+            try
+            {
+                m_jobSystem.wait(m_counter);
+            }
+            catch (...)
+            {
+            }
+        }
+
+        ScopedJobWait(const ScopedJobWait&) = delete;
+        ScopedJobWait& operator=(const ScopedJobWait&) = delete;
+
+      private:
+        JobSystem& m_jobSystem;
+        JobCounter& m_counter;
+    };
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace sgfx
+{
+    // Quadric error metric simplification by edge collapse. Vertices are only ever collapsed onto one of their neighbours, so the result is a new index
+    // list over the same vertices (every LOD can share the vertex range of the full resolution mesh).
+    // Vertices on open borders only collapse along the border, and vertices on attribute seams (several vertices at one position) are never moved.
+    // Stops once the index count reaches targetIndexCount or when the next collapse would introduce an error larger than targetError.
+    // Errors are object space distances, outError receives the largest error introduced.
+    [[nodiscard]] std::vector<uint32_t> simplifyMesh(std::span<const uint32_t> indices,
+                                                     std::span<const ModelVertex> vertices,
+                                                     const size_t targetIndexCount,
+                                                     const float targetError,
+                                                     float& outError);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+namespace sgfx
+{
+    struct Frustum;
+
+    static constexpr uint32_t MESHLET_MAX_VERTEX_COUNT = 64u;
+    static constexpr uint32_t MESHLET_MAX_TRIANGLE_COUNT = 124u;
+
+    // Contiguous range of triangles within a primitive's indices (firstIndex is relative to the primitive), with its object space bounds.
+    // The normal cone bounds the (geometric) normals of the triangles : a meshlet with coneCutoff >= 1 can never be backface culled.
+    struct MeshletData
+    {
+        uint32_t firstIndex{};
+        uint32_t indexCount{};
+
+        math::XMFLOAT3 sphereCenter{};
+        float sphereRadius{};
+
+        AxisAlignedBoundingBox bounds{};
+
+        math::XMFLOAT3 coneAxis{};
+        float coneCutoff{1.0f};
+    };
+
+    // Splits the triangles into meshlets in index order, without reordering them. Run after the vertex cache optimization, so that
+    // consecutive triangles share vertices and meshlets stay spatially coherent.
+    [[nodiscard]] std::vector<MeshletData> buildMeshlets(std::span<const uint32_t> indices,
+                                                         std::span<const ModelVertex> vertices,
+                                                         const uint32_t maxVertexCount = MESHLET_MAX_VERTEX_COUNT,
+                                                         const uint32_t maxTriangleCount = MESHLET_MAX_TRIANGLE_COUNT);
+
+    struct MeshletCullingStats
+    {
+        uint32_t meshletCount{};
+        uint32_t frustumCulledMeshletCount{};
+        uint32_t backfaceCulledMeshletCount{};
+
+        uint64_t triangleCount{};
+        uint64_t frustumCulledTriangleCount{};
+        uint64_t backfaceCulledTriangleCount{};
+
+        uint64_t getRejectedTriangleCount() const { return frustumCulledTriangleCount + backfaceCulledTriangleCount; }
+
+        MeshletCullingStats& operator+=(const MeshletCullingStats& other);
+    };
+
+    // Appends the index (within meshlets) of every meshlet that passes the frustum and normal cone tests to visibleMeshlets.
+    // The frustum and camera position must be in the object space of the meshlets. The cone test assumes uniform scaling, so pass
+    // cullBackfaces = false for non uniformly scaled objects.
+    MeshletCullingStats cullMeshlets(std::span<const MeshletData> meshlets,
+                                     const Frustum& frustum,
+                                     const math::XMFLOAT3& cameraPosition,
+                                     const bool cullBackfaces,
+                                     std::vector<uint32_t>& visibleMeshlets);
+}
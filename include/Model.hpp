@@ -1,5 +1,17 @@
 #pragma once
 
+#include "Bvh.hpp"
+#include "CommandList.hpp"
+#include "Frustum.hpp"
+#include "GeometryPool.hpp"
+#include "MeshOptimizer.hpp"
+#include "Meshlet.hpp"
+#include "OcclusionBuffer.hpp"
+#include "RenderQueue.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "TextureCache.hpp"
+#include "TransformHierarchy.hpp"
+
 namespace tinygltf
 {
     class Model;
@@ -7,6 +19,17 @@ namespace tinygltf
 
 namespace sgfx
 {
+    class JobSystem;
+
+    struct ModelData;
+    struct ModelDataStorage;
+    struct NodeData;
+    struct PrimitiveData;
+    struct SamplerData;
+
+    // Number of levels of detail generated per mesh, including the full resolution one.
+    static constexpr uint32_t MAX_MESH_LOD_COUNT = 6u;
+
     struct TransformComponent
     {
         math::XMFLOAT3 rotation{0.0f, 0.0f, 0.0f};
@@ -14,71 +37,422 @@ namespace sgfx
         math::XMFLOAT3 translate{0.0f, 0.0f, 0.0f};
     };
 
+    // Options that affect the cooked data, and are therefore part of the model cache key.
+    struct ModelLoadOptions
+    {
+        // Reorders the triangles and vertices of every primitive for the vertex cache, overdraw and vertex fetch.
+        bool optimizeMeshes{true};
+
+        // Splits every primitive into meshlets (ranges of at most 64 vertices / 124 triangles) with bounds and a normal cone, for cullMeshlets.
+        bool generateMeshlets{false};
+
+        // Builds a chain of simplified index lists per primitive (each with about half the triangles of the previous one), for selectLods.
+        bool generateLods{false};
+
+        // Format of the vertices in the geometry pool. Compact vertices are encoded at upload time, so this does not affect the cooked data.
+        // A model whose texture coordinates do not fit half floats keeps float vertices, see getVertexFormat.
+        VertexFormat vertexFormat{VertexFormat::Float};
+
+        // Keeps a CPU copy of the full resolution triangles of every mesh, with a BVH over them, for raycastMesh. Built at load time, so this
+        // does not affect the cooked data either.
+        bool buildCollisionBvhs{false};
+
+        // Keeps a CPU copy of the full resolution vertices and triangles of every mesh, and decodes the albedo and normal textures of every
+        // material, for gatherRasterMeshes. Not cooked either.
+        bool keepRasterData{false};
+    };
+
     struct alignas(256) TransformBuffer
     {
         math::XMMATRIX modelMatrix{};
         math::XMMATRIX inverseModelMatrix{};
         math::XMMATRIX inverseModelViewMatrix{};
+
+        // Maps compact (quantized) positions to object space, identity for float vertices.
+        math::XMFLOAT4 positionDequantizationScale{1.0f, 1.0f, 1.0f, 0.0f};
+        math::XMFLOAT4 positionDequantizationOffset{0.0f, 0.0f, 0.0f, 0.0f};
     };
 
     struct PBRMaterial
     {
-        wrl::ComPtr<ID3D11ShaderResourceView> albedoTextureSrv{};
+        // Backend textures, owned by the texture cache.
+        BackendHandle albedoTexture{};
         uint32_t albedoTextureSamplerStateIndex{};
 
-        wrl::ComPtr<ID3D11ShaderResourceView> normalTexture{};
+        BackendHandle normalTexture{};
         uint32_t normalTextureSamplerStateIndex{};
 
-        wrl::ComPtr<ID3D11ShaderResourceView> metalRoughnessTexture{};
+        BackendHandle metalRoughnessTexture{};
         uint32_t metalRoughnessTextureSamplerStateIndex{};
 
-        wrl::ComPtr<ID3D11ShaderResourceView> aoTexture{};
+        BackendHandle aoTexture{};
         uint32_t aoTextureSamplerStateIndex{};
 
-        wrl::ComPtr<ID3D11ShaderResourceView> emissiveTexture{};
+        BackendHandle emissiveTexture{};
         uint32_t emissiveTextureSamplerStateIndex{};
     };
 
+    struct LodSelectionDesc
+    {
+        math::XMFLOAT3 cameraPosition{};
+
+        // Converts an error at unit distance to pixels : viewport height / (2 * tan(vertical field of view / 2)).
+        float projectionScale{};
+
+        // The coarsest LOD whose projected error is at most this many pixels is selected.
+        float errorThreshold{1.0f};
+
+        // A coarser LOD is only switched to once its projected error is below (1 - hysteresis) * errorThreshold, so meshes close to a switching
+        // distance do not alternate between two LODs every frame.
+        float hysteresis{0.25f};
+    };
+
+    struct TextureStreamingDesc
+    {
+        math::XMFLOAT3 cameraPosition{};
+
+        // Pixels covered by a world unit at unit distance : viewport height / (2 * tan(vertical field of view / 2)).
+        float projectionScale{};
+    };
+
+    struct RenderItemGatherDesc
+    {
+        // Sort key fields, see RenderQueue::createSortKey.
+        uint32_t pass{};
+        uint32_t pipeline{};
+
+        // Added to the material index of every mesh, so the materials of different models get different keys.
+        uint32_t firstMaterialKey{};
+
+        // The depth of an item is the squared distance from the camera to the world bounds of its mesh.
+        math::XMFLOAT3 cameraPosition{};
+    };
+
+    struct LodSelectionStats
+    {
+        uint64_t fullDetailTriangleCount{};
+        uint64_t selectedTriangleCount{};
+
+        std::array<uint32_t, MAX_MESH_LOD_COUNT> meshCountPerLod{};
+
+        LodSelectionStats& operator+=(const LodSelectionStats& other);
+    };
+
+    struct OccluderSelectionDesc
+    {
+        // Meshes with a smaller world space bounding sphere hide too little to be worth rasterizing.
+        float minimumRadius{};
+
+        // Meshes with more triangles cost more to rasterize than they are likely to save.
+        uint32_t maximumTriangleCount{};
+    };
+
+    struct MeshCullingStats
+    {
+        uint32_t meshCount{};
+        uint32_t visibleMeshCount{};
+
+        // Meshes in the frustum but hidden by occluders, not counted as visible.
+        uint32_t occludedMeshCount{};
+
+        uint32_t getCulledMeshCount() const { return meshCount - visibleMeshCount; }
+
+        MeshCullingStats& operator+=(const MeshCullingStats& other);
+    };
+
+    // Filled by the constructor, see Model::getLoadStats.
+    struct ModelLoadStats
+    {
+        double loadTimeMs{};
+
+        // Loaded from the cooked file rather than converted from glTF.
+        bool isCached{};
+
+        // Compact vertices were requested, but the texture coordinates do not fit them so the model kept float vertices.
+        bool isCompactVertexFormatRejected{};
+
+        uint32_t meshCount{};
+        uint32_t shortIndexMeshCount{};
+
+        // Bytes of index data, and what it would take if every mesh used 32 bit indices.
+        uint64_t indexBytes{};
+        uint64_t fullIndexBytes{};
+
+        // The fields below are only filled when the model is converted from glTF, the cooked file does not keep them.
+        uint32_t primitiveCount{};
+
+        // Primitives without tangents in the glTF file.
+        uint32_t generatedTangentPrimitiveCount{};
+
+        // Summed over every primitive, before and after ModelLoadOptions::optimizeMeshes.
+        VertexCacheStatistics vertexCacheBefore{};
+        VertexCacheStatistics vertexCacheAfter{};
+        VertexFetchStatistics vertexFetchBefore{};
+        VertexFetchStatistics vertexFetchAfter{};
+
+        // With ModelLoadOptions::generateMeshlets, meshlets whose normal cone can reject them are counted as having a cone.
+        uint64_t meshletCount{};
+        uint64_t meshletConeCount{};
+        uint64_t meshletTriangleCount{};
+
+        // With ModelLoadOptions::generateLods, triangles of the whole model at each LOD.
+        std::array<uint64_t, MAX_MESH_LOD_COUNT> lodTriangleCounts{};
+    };
+
+    // Range of indices relative to the first index of the mesh, error is in object space.
+    struct MeshLod
+    {
+        uint32_t firstIndex{};
+        uint32_t indexCount{};
+        float error{};
+    };
+
+    // LOD of lods to draw a mesh at, from the one drawn the previous frame (see LodSelectionDesc::hysteresis). errorScale converts their errors
+    // to pixels.
+    uint32_t selectLod(std::span<const MeshLod> lods, const uint32_t previousLod, const float errorScale, const LodSelectionDesc& lodSelectionDesc);
+
+    // Offsets into the geometry pool buffers, baseVertex is added to every index of the mesh.
     struct Mesh
     {
-        wrl::ComPtr<ID3D11Buffer> vertexBuffer{};
-        wrl::ComPtr<ID3D11Buffer> indexBuffer{};
+        uint32_t baseVertex{};
+        uint32_t firstIndex{};
         uint32_t indicesCount{};
+        // 2 or 4 bytes.
+        uint32_t indexSize{};
 
         uint32_t materialIndex{};
+
+        // Index of the mesh within the cooked data (meshes are reordered at load time), and so within the model's collision meshes.
+        uint32_t cookedIndex{};
+
+        // Index within the model's transforms (one per glTF node instancing meshes). Bounds, meshlets and LOD errors are in the space of that node.
+        uint32_t transformIndex{};
+
+        AxisAlignedBoundingBox bounds{};
+        math::XMFLOAT3 sphereCenter{};
+        float sphereRadius{};
+
+        // Texture coordinate units per object space unit.
+        float textureCoordDensity{};
+
+        // Range within the model's meshlets, whose index ranges are relative to firstIndex.
+        uint32_t firstMeshlet{};
+        uint32_t meshletCount{};
+
+        // Range within the model's LODs, the first one being the full resolution mesh.
+        uint32_t firstLod{};
+        uint32_t lodCount{};
+    };
+
+    // Cached texture of a material, and the material field its (streamed) backend texture is copied to.
+    struct MaterialTexture
+    {
+        TextureHandle texture{};
+
+        uint32_t materialIndex{};
+        BackendHandle PBRMaterial::*field{};
     };
 
     class Model
     {
       public:
         Model() = default;
-        Model(ID3D11Device* const device, ID3D11ShaderResourceView* const fallbackSrv, const std::string_view modelPath, const TransformComponent& transformData = {});
+        // The fallback texture is used by materials without an albedo texture.
+        Model(RenderBackend& renderBackend,
+              GeometryPool& geometryPool,
+              TextureCache& textureCache,
+              const TextureHandle& fallbackTexture,
+              JobSystem& jobSystem,
+              const std::string_view modelPath,
+              const TransformComponent& transformData = {},
+              const ModelLoadOptions& loadOptions = {});
 
         TransformComponent* getTransformComponent() { return &m_transformComponent; }
 
-        void updateTransformBuffer(const math::XMMATRIX viewMatrix, ID3D11DeviceContext* const deviceContext);
+        // May differ from the requested format, pipelines drawing the model must be picked by it.
+        VertexFormat getVertexFormat() const { return m_vertexFormat; }
+
+        // The model does not print anything while loading, the application reports these instead.
+        const ModelLoadStats& getLoadStats() const { return m_loadStats; }
+
+        // Propagates the transform component and glTF node transforms that changed through the model's hierarchy, then updates the transform
+        // buffer of every node instancing meshes.
+        void updateTransformBuffer(const math::XMMATRIX viewMatrix, RenderBackend& renderBackend);
+
+        // Selects a LOD per mesh from its projected error, using the model matrix of the last updateTransformBuffer call.
+        void selectLods(const LodSelectionDesc& lodSelectionDesc);
+        void resetLods();
+        LodSelectionStats getLodSelectionStats() const;
+
+        // Culls meshlets against a world space frustum and camera position, using the model matrix of the last updateTransformBuffer call.
+        // Until clearMeshletCulling is called, recordMesh only draws the visible meshlets. Meshes without meshlets, or drawn at a coarser LOD
+        // (meshlets are only built for the full resolution), are culled as a whole against their bounds.
+        MeshletCullingStats cullMeshlets(const Frustum& frustum, const math::XMFLOAT3& cameraPosition);
+        void clearMeshletCulling();
+
+        // Culls whole meshes against a world space frustum, using their world space bounds from the last updateTransformBuffer call.
+        // Until clearMeshCulling is called, recordMesh skips the culled meshes and cullMeshlets does not test their meshlets.
+        MeshCullingStats cullMeshes(const Frustum& frustum);
+        void clearMeshCulling();
+
+        // Appends the meshes selected as occluders among those cullMeshes kept, as their full resolution triangles (which requires
+        // ModelLoadOptions::buildCollisionBvhs). The occluders point to the model's data.
+        void gatherOccluders(const OccluderSelectionDesc& selectionDesc, std::vector<Occluder>& outOccluders) const;
+
+        // Appends the meshes cullMeshes kept as full resolution triangle lists for the software rasterizer, with the model matrix of the last
+        // updateTransformBuffer call (which requires ModelLoadOptions::keepRasterData). The meshes point to the model's data.
+        void gatherRasterMeshes(std::vector<RasterMesh>& outMeshes) const;
+
+        // Culls the meshes cullMeshes kept whose world space bounds are hidden in the occlusion buffer, with the same effect on recordMesh and
+        // cullMeshlets. Returns the number of meshes culled.
+        uint32_t cullOccludedMeshes(const OcclusionBuffer& occlusionBuffer);
+
+        // Requests the mips of every texture from the screen space texel density of the meshes using it (the closest mesh wins), using the
+        // model matrix of the last updateTransformBuffer call.
+        void requestTextureMips(TextureCache& textureCache, const TextureStreamingDesc& textureStreamingDesc) const;
+
+        // Copies the current backend texture of every texture to its material, after TextureCache::updateStreaming swapped in finer or
+        // coarser mips.
+        void updateMaterialTextures();
 
-        void render(ID3D11DeviceContext* const deviceContext) const;
+        // Adds a render item for every mesh recordMesh would draw, i.e not culled and with visible meshlets left.
+        void gatherRenderItems(const RenderItemGatherDesc& gatherDesc, RenderQueue& renderQueue) const;
 
-        void renderInstanced(ID3D11DeviceContext* const deviceContext, const uint32_t instanceCount) const;
+        // Records the draws of the mesh, only binding the state that differs from drawState, which is then updated. Only reads the model, so
+        // several threads may record meshes of the same model (each with its own command list and draw state).
+        void recordMesh(CommandList& commandList, const uint32_t meshIndex, DrawState& drawState) const;
+
+        // Records every mesh at full resolution, instanceCount times, ignoring culling.
+        void recordInstanced(CommandList& commandList, const uint32_t instanceCount) const;
+
+        uint32_t getMeshCount() const { return static_cast<uint32_t>(m_meshes.size()); }
+        uint32_t getMaterialCount() const { return static_cast<uint32_t>(m_materials.size()); }
+
+        // World space bounds of the mesh, as of the last updateTransformBuffer call.
+        AxisAlignedBoundingBox getMeshWorldBounds(const uint32_t meshIndex) const;
+
+        // Incremented whenever updateTransformBuffer changes the world bounds of any mesh.
+        uint64_t getWorldBoundsVersion() const { return m_worldBoundsVersion; }
+
+        // Distance along the world space ray to the closest triangle of the mesh (at full resolution), or to its world bounds if the model was
+        // loaded without collision BVHs. Infinity if the ray misses it.
+        float raycastMesh(const uint32_t meshIndex, const Ray& ray) const;
 
       private:
-        void loadSamplers(ID3D11Device* const device, tinygltf::Model* const model);
-        void loadMaterials(ID3D11Device* const device, tinygltf::Model* const model);
-        void loadNode(ID3D11Device* const device, uint32_t nodeIndex, tinygltf::Model* const model);
+        struct ModelTransform
+        {
+            uint32_t nodeIndex{};
+            ConstantBuffer<TransformBuffer> buffer{};
+
+            // Largest axis scale of the model matrix, and whether it scales every axis equally (which the normal cones of meshlets rely on).
+            float maximumScale{1.0f};
+            bool isUniformlyScaled{true};
+        };
+
+        // Object space triangles of a mesh, for ray casts.
+        struct MeshCollision
+        {
+            std::vector<math::XMFLOAT3> positions{};
+            std::vector<uint32_t> indices{};
+            Bvh bvh{};
+        };
+
+        // Vertices and triangles of a mesh, for the software rasterizer.
+        struct MeshRasterData
+        {
+            std::vector<ModelVertex> vertices{};
+            std::vector<uint32_t> indices{};
+        };
+
+        // Indices into the model's raster textures, INVALID_INDEX_U32 for those the material does not have.
+        struct RasterMaterial
+        {
+            uint32_t albedoTextureIndex{INVALID_INDEX_U32};
+            uint32_t normalTextureIndex{INVALID_INDEX_U32};
+        };
+
+        // Conversion from glTF to the cooked representation.
+        void convertModel(tinygltf::Model* const model, JobSystem& jobSystem, const ModelLoadOptions& loadOptions, ModelDataStorage& modelDataStorage, ModelLoadStats& loadStats) const;
+        void convertNode(uint32_t nodeIndex, const uint32_t parentNodeIndex, tinygltf::Model* const model, std::vector<PrimitiveData>& primitives, std::vector<NodeData>& nodes) const;
+        void generateTangents(JobSystem& jobSystem, std::span<PrimitiveData> primitives, ModelLoadStats& loadStats) const;
+        void optimizePrimitives(JobSystem& jobSystem, std::span<PrimitiveData> primitives, ModelLoadStats& loadStats) const;
+        void generateMeshlets(JobSystem& jobSystem, std::span<PrimitiveData> primitives, ModelLoadStats& loadStats) const;
+        void generateLods(JobSystem& jobSystem, std::span<PrimitiveData> primitives, ModelLoadStats& loadStats) const;
+
+        void loadSamplers(RenderBackend& renderBackend, std::span<const SamplerData> samplers);
+        void loadMaterials(TextureCache& textureCache, const TextureHandle& fallbackTexture, JobSystem& jobSystem, const ModelData& modelData);
+        void loadMeshes(const ModelData& modelData);
+        void loadMeshCollision(const ModelData& modelData, const uint32_t cookedMeshIndex);
+        void loadRasterData(JobSystem& jobSystem, const ModelData& modelData);
+
+        void loadTransforms(RenderBackend& renderBackend, std::span<const NodeData> nodes);
+
+        // Copies the world matrix of the transform's node (and derived values) to the transform, after the hierarchy updated it.
+        void applyWorldMatrix(ModelTransform& transform) const;
+
+        // Recomputes the world space bounds of the meshes whose transform the last hierarchy update changed.
+        void updateWorldBounds();
+
+        GeometryRange getLodIndexRange(const Mesh& mesh, const uint32_t lod) const;
+
+        // Index ranges recordMesh draws for the mesh : its visible meshlets if meshlet culling ran, otherwise its selected LOD (stored in
+        // lodIndexRange). Empty if the mesh is culled.
+        std::span<const GeometryRange> getDrawnIndexRanges(const uint32_t meshIndex, GeometryRange& lodIndexRange) const;
 
       private:
+        // Meshes are ordered by index size and then transform, so the index buffer is rebound at most once per model and the transform buffer
+        // at most once per node (and index size).
         std::vector<Mesh> m_meshes{};
+        std::vector<MeshletData> m_meshlets{};
+        std::vector<MeshLod> m_lods{};
         std::vector<PBRMaterial> m_materials{};
-        std::vector<wrl::ComPtr<ID3D11SamplerState>> m_samplers{};
+
+        // Keeps the cached textures used by the materials alive, they are shared with every other model using the same images.
+        std::vector<MaterialTexture> m_textures{};
+        std::vector<BackendResource> m_samplers{};
 
         std::string m_modelPath{};
         std::string m_modelDirectory{};
 
+        // Node 0 is the root of the model, following m_transformComponent. The glTF nodes follow in cooked order, offset by one.
         TransformComponent m_transformComponent{};
-        ConstantBuffer<TransformBuffer> m_transformBuffer{};
+        TransformComponent m_appliedTransformComponent{};
+        TransformHierarchy m_transformHierarchy{};
+
+        std::vector<ModelTransform> m_transforms{};
+
+        // Maps compact (quantized) positions to object space, shared by every transform.
+        math::XMFLOAT4 m_positionDequantizationScale{1.0f, 1.0f, 1.0f, 0.0f};
+        math::XMFLOAT4 m_positionDequantizationOffset{0.0f, 0.0f, 0.0f, 0.0f};
+
+        BackendResource m_fallbackSamplerState{};
+
+        ModelLoadStats m_loadStats{};
+
+        GeometryPool* m_geometryPool{};
+        VertexFormat m_vertexFormat{VertexFormat::Float};
+        std::shared_ptr<GeometryAllocation> m_geometryAllocation{};
+
+        // LOD drawn for each mesh, kept between frames for the hysteresis.
+        std::vector<uint32_t> m_selectedLods{};
+
+        // Result of the last cullMeshlets call : the index ranges of mesh i are [m_visibleIndexRangeOffsets[i], m_visibleIndexRangeOffsets[i + 1]).
+        // Consecutive visible meshlets are merged into a single range, and so a single draw.
+        std::vector<GeometryRange> m_visibleIndexRanges{};
+        std::vector<uint32_t> m_visibleIndexRangeOffsets{};
+        std::vector<uint32_t> m_visibleMeshlets{};
+
+        // World space bounds of each mesh, and the result of the last cullMeshes call (empty if every mesh is drawn).
+        BoundingVolumes m_worldBounds{};
+        uint64_t m_worldBoundsVersion{};
+        std::vector<uint8_t> m_meshVisibility{};
+
+        // Indexed by Mesh::cookedIndex, empty unless ModelLoadOptions::buildCollisionBvhs was set.
+        std::vector<MeshCollision> m_meshCollisions{};
 
-        wrl::ComPtr<ID3D11SamplerState> m_fallbackSamplerState{};
-        wrl::ComPtr<ID3D11ShaderResourceView> m_fallbackSrv{};
+        // Indexed by Mesh::cookedIndex and Mesh::materialIndex, empty unless ModelLoadOptions::keepRasterData was set.
+        std::vector<MeshRasterData> m_meshRasterData{};
+        std::vector<RasterMaterial> m_rasterMaterials{};
+        std::vector<RasterTexture> m_rasterTextures{};
     };
 }
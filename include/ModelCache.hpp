@@ -0,0 +1,183 @@
+#pragma once
+
+#include "Meshlet.hpp"
+#include "TransformHierarchy.hpp"
+
+namespace sgfx
+{
+    // Simplified index list over the vertices of the primitive, error is the object space distance to the full resolution surface.
+    struct PrimitiveLodData
+    {
+        std::vector<uint32_t> indices{};
+        float error{};
+    };
+
+    // Geometry of a single glTF primitive while it is being converted, before it is packed into the model wide streams.
+    struct PrimitiveData
+    {
+        std::vector<ModelVertex> vertices{};
+        std::vector<uint32_t> indices{};
+
+        // Only generated when requested by the load options, each meshlet refers to a range of indices.
+        std::vector<MeshletData> meshlets{};
+
+        // Only generated when requested by the load options, from the finest to the coarsest level (the full resolution indices are not included).
+        std::vector<PrimitiveLodData> lods{};
+
+        uint32_t materialIndex{};
+
+        // Node the primitive was instanced by, its vertices are in the space of that node.
+        uint32_t nodeIndex{};
+
+        // Tangents supplied by the glTF file, the others are generated at load time.
+        bool hasTangents{};
+    };
+
+    // Range of indices of a level of detail, relative to the first index of its mesh. The first LOD of every mesh is the full resolution one.
+    struct MeshLodData
+    {
+        uint32_t firstIndex{};
+        uint32_t indexCount{};
+        float error{};
+    };
+
+    // Range of a single glTF primitive within the model wide vertex and index streams. Indices are relative to firstVertex.
+    // Primitives with few enough vertices use 16 bit indices, so the index stream is stored as bytes and each mesh records its own index size.
+    struct MeshData
+    {
+        uint32_t firstVertex{};
+        uint32_t vertexCount{};
+
+        // indexCount is the full resolution index count, the indices of the coarser LODs follow (totalIndexCount includes them).
+        uint32_t indexByteOffset{};
+        uint32_t indexCount{};
+        uint32_t totalIndexCount{};
+        // 2 or 4 bytes.
+        uint32_t indexSize{};
+
+        uint32_t materialIndex{};
+        uint32_t nodeIndex{};
+
+        AxisAlignedBoundingBox bounds{};
+
+        // Centered on the bounds, with the smallest radius enclosing every vertex (tighter than the bounds' circumscribed sphere).
+        math::XMFLOAT3 sphereCenter{};
+        float sphereRadius{};
+
+        // Average texture coordinate units per object space unit (square root of the texture coordinate to object space area ratio), for texture streaming.
+        float textureCoordDensity{};
+
+        // Range within the model wide meshlet stream, empty if meshlets were not generated.
+        uint32_t firstMeshlet{};
+        uint32_t meshletCount{};
+
+        // Range within the model wide LOD stream, always containing at least the full resolution LOD.
+        uint32_t firstLod{};
+        uint32_t lodCount{};
+    };
+
+    // glTF node of the default scene. Nodes are ordered so every parent comes before its children, parentIndex is INVALID_INDEX_U32 for scene roots.
+    struct NodeData
+    {
+        uint32_t parentIndex{INVALID_INDEX_U32};
+        LocalTransform localTransform{};
+    };
+
+    struct MaterialTextureData
+    {
+        uint32_t imageIndex{INVALID_INDEX_U32};
+        uint32_t samplerIndex{INVALID_INDEX_U32};
+    };
+
+    struct MaterialData
+    {
+        MaterialTextureData albedo{};
+        MaterialTextureData metalRoughness{};
+        MaterialTextureData normal{};
+        MaterialTextureData occlusion{};
+        MaterialTextureData emissive{};
+    };
+
+    // Raw glTF sampler values.
+    struct SamplerData
+    {
+        int32_t minFilter{};
+        int32_t magFilter{};
+        int32_t wrapS{};
+        int32_t wrapT{};
+    };
+
+    // CPU side, GPU ready description of a model. Either points into ModelDataStorage (when converted from glTF) or into a memory mapped ModelCache.
+    struct ModelData
+    {
+        std::span<const ModelVertex> vertices{};
+        std::span<const std::byte> indexData{};
+        std::span<const MeshData> meshes{};
+        std::span<const MeshletData> meshlets{};
+        std::span<const MeshLodData> lods{};
+        std::span<const MaterialData> materials{};
+        std::span<const SamplerData> samplers{};
+        std::span<const NodeData> nodes{};
+
+        // Paths of images relative to the model directory.
+        std::vector<std::string_view> imagePaths{};
+    };
+
+    struct ModelDataStorage
+    {
+        std::vector<ModelVertex> vertices{};
+        std::vector<std::byte> indexData{};
+        std::vector<MeshData> meshes{};
+        std::vector<MeshletData> meshlets{};
+        std::vector<MeshLodData> lods{};
+        std::vector<MaterialData> materials{};
+        std::vector<SamplerData> samplers{};
+        std::vector<NodeData> nodes{};
+        std::vector<std::string> imagePaths{};
+
+        // Appends the primitive (and its LODs) to the streams, computing its bounds and texture coordinate density, and narrowing its indices to 16 bit if the vertex count allows.
+        void addPrimitive(const PrimitiveData& primitive);
+
+        [[nodiscard]] ModelData getView() const;
+    };
+
+    // Cooked, versioned binary file that stores already converted model data. Every section starts on a page boundary, so once the file is memory mapped
+    // the sections can be handed directly to buffer creation.
+    class ModelCache
+    {
+      public:
+        ModelCache() = default;
+        ~ModelCache();
+
+        ModelCache(const ModelCache&) = delete;
+        ModelCache& operator=(const ModelCache&) = delete;
+
+        // Key of the model file and of every .bin buffer that is present in the model directory, from their paths, sizes and last write times.
+        // Their contents are not read, so checking a cooked file stays cheap however large the buffers are.
+        [[nodiscard]] static uint64_t getSourceFilesKey(const std::string_view modelPath);
+
+        [[nodiscard]] static std::string getCachePath(const std::string_view modelPath);
+
+        static void write(const std::string_view cachePath, const uint64_t cacheKey, const ModelData& modelData);
+
+        // Maps the cooked file. Returns false if it does not exist, was written by a different version or does not match the cache key.
+        [[nodiscard]] bool open(const std::string_view cachePath, const uint64_t cacheKey);
+
+        const ModelData& getData() const { return m_data; }
+
+      private:
+        void close();
+
+      private:
+#ifdef _WIN32
+        HANDLE m_file{INVALID_HANDLE_VALUE};
+        HANDLE m_fileMapping{};
+#else
+        int m_file{-1};
+#endif
+        const std::byte* m_mappedData{};
+        uint64_t m_mappedSize{};
+
+        ModelData m_data{};
+    };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+
+namespace sgfx
+{
+    // Backend that draws nothing and needs no device nor window, so the CPU side of frames runs without a GPU. Resource creation and every
+    // command are validated (throwing on the first invalid one) and counted. Each command list is validated on its own, from nothing bound, as a
+    // deferred context would execute it. Handles the backend did not create (e.g the fake objects of benchmarks) are accepted, but only checked
+    // for null, while draws using its own buffers are checked against their size.
+    class NullRenderBackend final : public RenderBackend
+    {
+      public:
+        NullRenderBackend();
+
+        [[nodiscard]] BackendHandle createBuffer(const BackendBufferDesc& bufferDesc, std::span<const std::byte> data = {}) override;
+        [[nodiscard]] BackendHandle createTexture(const BackendTextureDesc& textureDesc, std::span<const std::byte> data) override;
+        [[nodiscard]] BackendRenderTargetHandles createRenderTarget(const BackendRenderTargetDesc& renderTargetDesc) override;
+        [[nodiscard]] BackendHandle createSampler(const BackendSamplerDesc& samplerDesc) override;
+        [[nodiscard]] BackendHandle createGraphicsPipeline(const BackendPipelineDesc& pipelineDesc) override;
+
+        void releaseResource(const BackendHandle handle) override;
+
+        void updateBuffer(const BackendHandle buffer, std::span<const std::byte> data, const uint32_t offset = 0u) override;
+
+        using RenderBackend::submit;
+        void submit(std::span<const CommandList> commandLists) override;
+
+        BackendHandle getBackBuffer() const override { return m_backBuffer; }
+
+        void beginUserInterfaceFrame() override {}
+        void renderUserInterface() override {}
+
+        void present() override {}
+
+        RenderBackendStats getStats() const override;
+
+      private:
+        enum class ResourceType : uint8_t
+        {
+            Buffer,
+            Texture,
+            RenderTarget,
+            DepthStencil,
+            Sampler,
+            Pipeline,
+        };
+
+        struct Resource
+        {
+            ResourceType type{};
+
+            BufferType bufferType{};
+
+            // In bytes, of buffers, textures and render targets.
+            uint64_t size{};
+
+            // Of pipelines.
+            uint32_t vertexSize{};
+
+            // Sampled view of a render target.
+            bool isRenderTargetTexture{};
+        };
+
+        // Called with m_mutex locked.
+        BackendHandle addResource(const Resource& resource);
+
+        // nullptr for handles the backend did not create. Called with m_mutex locked.
+        const Resource* findResource(const BackendHandle handle) const;
+
+        void validateCommandList(const CommandList& commandList);
+
+      private:
+        // Guards the resources and the stats, as resources are created and released by any thread.
+        mutable std::mutex m_mutex{};
+
+        // Handles are the addresses of the resources.
+        std::unordered_map<BackendHandle, std::unique_ptr<Resource>> m_resources{};
+
+        BackendHandle m_backBuffer{};
+
+        RenderBackendStats m_stats{};
+    };
+}
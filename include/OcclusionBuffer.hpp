@@ -0,0 +1,98 @@
+#pragma once
+
+namespace sgfx
+{
+    class JobSystem;
+
+    // Triangle list of an occluder, in object space. The spans must stay valid until OcclusionBuffer::rasterize returns.
+    struct Occluder
+    {
+        std::span<const math::XMFLOAT3> positions{};
+        std::span<const uint32_t> indices{};
+        math::XMMATRIX modelMatrix{};
+    };
+
+    struct OcclusionRasterizationStats
+    {
+        uint32_t occluderCount{};
+        uint32_t triangleCount{};
+
+        // Triangles left after rejecting those that are degenerate, off screen or crossing the near plane.
+        uint32_t rasterizedTriangleCount{};
+    };
+
+    // Low resolution depth buffer for CPU occlusion culling, with [0, 1] depth (1 being the far plane). A pixel covered by an occluder (at its
+    // center, as on the GPU) stores the farthest depth of the occluder within the pixel, and boxes are tested against every pixel they overlap.
+    // Coverage is sampled though, so a box seen only through gaps narrower than a pixel of the buffer may be culled : the resolution bounds
+    // that error. An 8 x 8 pixel block level on top of the pixels holds the farthest depth of each block, which rejects most boxes without
+    // reading their pixels.
+    class OcclusionBuffer
+    {
+      public:
+        // Tiles are rasterized in parallel, blocks are the hierarchical level.
+        static constexpr uint32_t TILE_SIZE = 32u;
+        static constexpr uint32_t BLOCK_SIZE = 8u;
+
+        void resize(const uint32_t width, const uint32_t height);
+
+        // Clears the buffer, then rasterizes every occluder with the (row vector) view projection matrix, which isAabbVisible also uses.
+        // Triangles are set up in parallel per occluder, binned to tiles and rasterized in parallel per tile, 8 pixels per iteration with AVX2
+        // and 4 otherwise. The result does not depend on the number of threads.
+        OcclusionRasterizationStats rasterize(std::span<const Occluder> occluders, const math::XMMATRIX viewProjectionMatrix, JobSystem& jobSystem);
+
+        // False if the world space box is hidden by the rasterized occluders (or entirely off screen). Boxes crossing the near plane are visible.
+        bool isAabbVisible(const AxisAlignedBoundingBox& bounds) const;
+
+        uint32_t getWidth() const { return m_width; }
+        uint32_t getHeight() const { return m_height; }
+
+        // Rows of getRowPitch() depths, of which the first getWidth() are on screen.
+        uint32_t getRowPitch() const { return m_rowPitch; }
+        std::span<const float> getDepths() const { return m_depths; }
+
+      private:
+        // Edge functions and depth plane of a screen space triangle, evaluated at pixel centers.
+        struct RasterTriangle
+        {
+            std::array<float, 3> edgeX{};
+            std::array<float, 3> edgeY{};
+            std::array<float, 3> edgeOffset{};
+
+            // Already offset towards the farthest corner of each pixel, and clamped to maximumDepth.
+            float depthX{};
+            float depthY{};
+            float depthOffset{};
+            float maximumDepth{};
+
+            // Inclusive pixel bounds, clamped to the buffer.
+            uint32_t minimumX{};
+            uint32_t minimumY{};
+            uint32_t maximumX{};
+            uint32_t maximumY{};
+        };
+
+        void setupTriangles(const Occluder& occluder, const math::XMMATRIX viewProjectionMatrix, std::vector<RasterTriangle>& outTriangles) const;
+        void rasterizeTile(const uint32_t tileIndex);
+
+      private:
+        uint32_t m_width{};
+        uint32_t m_height{};
+
+        // Both rounded up to whole tiles.
+        uint32_t m_rowPitch{};
+        uint32_t m_rowCount{};
+
+        uint32_t m_tileCountX{};
+        uint32_t m_tileCountY{};
+
+        std::vector<float> m_depths{};
+        std::vector<float> m_blockMaximumDepths{};
+
+        math::XMMATRIX m_viewProjectionMatrix{};
+
+        // Per occluder, then concatenated in occluder order so the binning (and so the rasterization order within a tile) is deterministic.
+        std::vector<std::vector<RasterTriangle>> m_occluderTriangles{};
+        std::vector<RasterTriangle> m_triangles{};
+        std::vector<std::vector<uint32_t>> m_tileTriangles{};
+    };
+}
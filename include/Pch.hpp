@@ -6,28 +6,60 @@ constexpr bool SGFX_DEBUG = true;
 constexpr bool SGFX_DEBUG = false;
 #endif
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <exception>
+#include <filesystem>
 #include <format>
+#include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <source_location>
 #include <span>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <ranges>
 #include <random>
 
+// The D3D11 backend and the windowed application are Windows only. Everything else (including the tests and benchmarks) also builds with
+// the portable DirectXMath headers elsewhere.
+#ifdef _WIN32
 #include <d3d11.h>
 #include <dxgi1_6.h>
 #include <wrl.h>
 
 #include <d3dcompiler.h>
+#else
+// Memory mapping of the model cache.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include <DirectXMath.h>
 
 // Global namespace aliases.
+#ifdef _WIN32
 namespace wrl = Microsoft::WRL;
+#endif
 namespace math = DirectX;
 
 #include "Types.hpp"
@@ -0,0 +1,196 @@
+#pragma once
+
+// Zones only exist if SGFX_PROFILER is defined (by premake, unless --no-profiler is passed), otherwise the macros expand to nothing.
+#ifdef SGFX_PROFILER
+#define SGFX_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SGFX_PROFILE_CONCAT(a, b) SGFX_PROFILE_CONCAT_IMPL(a, b)
+
+// Times the rest of the enclosing scope. name must be a string literal, as only its pointer is recorded.
+#define SGFX_PROFILE_ZONE(name) const sgfx::ProfilerScope SGFX_PROFILE_CONCAT(profilerScope, __LINE__)(name)
+
+// Drains the zones recorded by every thread since the last call, closing the profiler's frame. Called by the main thread only.
+#define SGFX_PROFILE_END_FRAME() sgfx::getProfiler().endFrame()
+#else
+#define SGFX_PROFILE_ZONE(name)
+#define SGFX_PROFILE_END_FRAME()
+#endif
+
+namespace sgfx
+{
+    // Profiler clock ticks : the time stamp counter on x64 (invariant on the CPUs the engine targets), steady_clock nanoseconds otherwise.
+    [[nodiscard]] uint64_t getProfilerTimestamp();
+
+    // A zone, written by the thread that recorded it when the zone ends. Children are recorded before their parent.
+    struct ProfilerEvent
+    {
+        const char* name{};
+
+        // Name of the zone enclosing this one on the same thread, nullptr at the root.
+        const char* parentName{};
+
+        uint64_t beginTimestamp{};
+        uint64_t endTimestamp{};
+    };
+
+    // Averages over the last Profiler::ROLLING_FRAME_COUNT frames, in milliseconds.
+    struct ProfilerZoneStats
+    {
+        std::string_view name{};
+
+        // Of the zone in the tree returned by Profiler::getZoneStats.
+        uint32_t depth{};
+
+        double averageDuration{};
+        double maximumDuration{};
+        double averageCallCount{};
+    };
+
+    struct ProfilerStats
+    {
+        uint32_t threadCount{};
+
+        // Zones lost because a thread's ring buffer was full (nothing drained it for too long).
+        uint64_t droppedEventCount{};
+
+        uint64_t capturedEventCount{};
+        bool isCapturing{};
+
+        // Ticks of getProfilerTimestamp per microsecond, measured against steady_clock.
+        double ticksPerMicrosecond{};
+    };
+
+    // Records the zones of every thread into per thread single producer / single consumer ring buffers, so recording a zone never takes a
+    // lock. The main thread drains them once per frame into rolling per zone averages and, while a capture is running, into a trace which
+    // is exported as Chrome trace event JSON (viewable with chrome://tracing or Perfetto).
+    class Profiler
+    {
+      public:
+        // Events per thread. A thread recording more zones than this between two drains loses the extra ones.
+        static constexpr uint32_t RING_BUFFER_CAPACITY = 16384u;
+
+        static constexpr uint32_t ROLLING_FRAME_COUNT = 120u;
+
+        // Bounds the memory of a capture left running.
+        static constexpr uint64_t MAX_CAPTURED_EVENT_COUNT = 4'000'000u;
+
+        Profiler();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        // Called by ProfilerScope.
+        void recordEvent(const ProfilerEvent& event);
+
+        void endFrame();
+
+        // Every zone drained until endCapture is kept, including those recorded before beginCapture but not drained yet.
+        void beginCapture();
+
+        // Drains the ring buffers, then writes the captured zones as a Chrome trace to path. Returns false if the file cannot be written,
+        // the capture being discarded either way.
+        bool endCapture(const std::filesystem::path& path);
+
+        // Every zone seen so far, depth first : a zone follows the zone enclosing it. Zones are identified by their name and the name of
+        // their parent, so the children of a zone appearing under several parents are listed under each of them.
+        [[nodiscard]] std::vector<ProfilerZoneStats> getZoneStats() const;
+
+        [[nodiscard]] ProfilerStats getStats() const;
+
+      private:
+        struct ThreadBuffer
+        {
+            std::array<ProfilerEvent, RING_BUFFER_CAPACITY> events{};
+
+            // Only written by the recording thread.
+            std::atomic<uint64_t> writeIndex{0u};
+
+            // Only written by the draining thread.
+            std::atomic<uint64_t> readIndex{0u};
+
+            std::atomic<uint64_t> droppedEventCount{0u};
+
+            uint32_t threadIndex{};
+        };
+
+        struct CapturedEvent
+        {
+            ProfilerEvent event{};
+            uint32_t threadIndex{};
+        };
+
+        struct ZoneHistory
+        {
+            std::string name{};
+            std::string parentName{};
+
+            std::array<double, ROLLING_FRAME_COUNT> durations{};
+            std::array<uint32_t, ROLLING_FRAME_COUNT> callCounts{};
+
+            // Of the frame being drained.
+            double duration{};
+            uint32_t callCount{};
+        };
+
+        struct ZoneKey
+        {
+            const char* name{};
+            const char* parentName{};
+
+            bool operator==(const ZoneKey&) const = default;
+        };
+
+        struct ZoneKeyHash
+        {
+            size_t operator()(const ZoneKey& key) const;
+        };
+
+        // Registers the calling thread's buffer on its first zone.
+        ThreadBuffer& getThreadBuffer();
+
+        void drainEvents();
+
+        uint32_t getZoneIndex(const ProfilerEvent& event);
+
+        double getTicksPerMicrosecond() const;
+
+      private:
+        const uint64_t m_startTimestamp{};
+        const std::chrono::steady_clock::time_point m_startTime{};
+
+        // Guards the registration of thread buffers, which are never freed as the threads recording zones outlive the frame loop.
+        mutable std::mutex m_threadBufferMutex{};
+        std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers{};
+
+        // The members below are only accessed by the main thread.
+        std::vector<ZoneHistory> m_zones{};
+
+        // String literals may be duplicated between translation units, so zones are looked up by pointer first, then by name.
+        std::unordered_map<ZoneKey, uint32_t, ZoneKeyHash> m_zoneIndicesByPointer{};
+        std::map<std::pair<std::string, std::string>, uint32_t> m_zoneIndicesByName{};
+
+        uint64_t m_frameIndex{};
+
+        bool m_isCapturing{};
+        std::vector<CapturedEvent> m_capturedEvents{};
+    };
+
+    // Queried once, on first use.
+    [[nodiscard]] Profiler& getProfiler();
+
+    // Records a zone from its construction to its destruction. Used through SGFX_PROFILE_ZONE, but always available (e.g to measure the cost
+    // of a zone when the macros are disabled).
+    class ProfilerScope
+    {
+      public:
+        explicit ProfilerScope(const char* const name);
+        ~ProfilerScope();
+
+        ProfilerScope(const ProfilerScope&) = delete;
+        ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+      private:
+        const char* m_name{};
+        const char* m_parentName{};
+        uint64_t m_beginTimestamp{};
+    };
+}
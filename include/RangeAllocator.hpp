@@ -0,0 +1,48 @@
+#pragma once
+
+namespace sgfx
+{
+    struct RangeAllocatorStats
+    {
+        uint64_t capacity{};
+        uint64_t usedSize{};
+        uint64_t freeSize{};
+        uint64_t largestFreeBlockSize{};
+
+        uint32_t allocationCount{};
+        uint32_t freeBlockCount{};
+
+        // 0 when all free space is a single block, approaching 1 as the free space gets split into many small blocks.
+        float getFragmentation() const { return freeSize == 0u ? 0.0f : 1.0f - static_cast<float>(largestFreeBlockSize) / static_cast<float>(freeSize); }
+    };
+
+    // Sub-allocates ranges of a fixed size address space (e.g a large GPU buffer) using a best fit free list. Adjacent free blocks are merged on free.
+    // Does not touch any memory itself, and is not thread safe.
+    class RangeAllocator
+    {
+      public:
+        RangeAllocator() = default;
+        explicit RangeAllocator(const uint64_t capacity);
+
+        // Returns std::nullopt if there is no free block large enough.
+        [[nodiscard]] std::optional<uint64_t> allocate(const uint64_t size, const uint64_t alignment = 1u);
+
+        // Throws if any part of the range is already free (a double free, or a range that was never allocated).
+        void free(const uint64_t offset, const uint64_t size);
+
+        RangeAllocatorStats getStats() const;
+
+      private:
+        void insertFreeBlock(const uint64_t offset, const uint64_t size);
+        void eraseFreeBlock(const std::map<uint64_t, uint64_t>::iterator blockIterator);
+
+      private:
+        uint64_t m_capacity{};
+        uint64_t m_usedSize{};
+        uint32_t m_allocationCount{};
+
+        // Free blocks, keyed by offset (for merging) and by size (for best fit lookups).
+        std::map<uint64_t, uint64_t> m_freeBlocksByOffset{};
+        std::multimap<uint64_t, uint64_t> m_freeBlocksBySize{};
+    };
+}
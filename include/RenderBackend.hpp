@@ -0,0 +1,250 @@
+#pragma once
+
+#include "CommandList.hpp"
+
+namespace sgfx
+{
+    // Slot counts every backend supports (those of D3D11).
+    static constexpr uint32_t MAX_CONSTANT_BUFFER_SLOT_COUNT = 14u;
+    static constexpr uint32_t MAX_SHADER_RESOURCE_SLOT_COUNT = 128u;
+    static constexpr uint32_t MAX_SAMPLER_SLOT_COUNT = 16u;
+
+    enum class BufferType : uint8_t
+    {
+        Vertex,
+        Index,
+        Constant,
+    };
+
+    struct BackendBufferDesc
+    {
+        BufferType type{};
+
+        // In bytes. Constant buffers are sized in multiples of 16 bytes.
+        uint32_t size{};
+    };
+
+    enum class TextureFormat : uint8_t
+    {
+        R8Unorm,
+        R8G8B8A8Unorm,
+        R8G8B8A8UnormSrgb,
+        R32G32Float,
+        R16G16B16A16Float,
+        R32G32B32A32Float,
+
+        // Depth buffers only (see createRenderTarget).
+        D32Float,
+
+        // Block compressed, in blocks of 4x4 texels.
+        BC1Unorm,
+        BC1UnormSrgb,
+        BC3Unorm,
+        BC3UnormSrgb,
+        BC4Unorm,
+        BC5Unorm,
+        BC7Unorm,
+        BC7UnormSrgb,
+    };
+
+    [[nodiscard]] bool isBlockCompressed(const TextureFormat format);
+
+    // Of a texel, or of a 4x4 block for block compressed formats.
+    [[nodiscard]] uint32_t getTexelSize(const TextureFormat format);
+
+    // Bytes of a mip, its rows (of texels or blocks) being tightly packed.
+    [[nodiscard]] uint64_t getMipSize(const TextureFormat format, const uint32_t width, const uint32_t height);
+
+    // Textures sampled by shaders, whose handle is the one shader resource commands bind. Their data holds every mip, finest first, each
+    // tightly packed (see getMipSize). The dimensions of block compressed textures are multiples of 4 (their smaller mips still take whole blocks).
+    struct BackendTextureDesc
+    {
+        uint32_t width{};
+        uint32_t height{};
+        TextureFormat format{};
+        uint32_t mipCount{1u};
+    };
+
+    // Texture rendered to, then sampled. D32Float ones are depth buffers, bound as depth stencil.
+    struct BackendRenderTargetDesc
+    {
+        uint32_t width{};
+        uint32_t height{};
+        TextureFormat format{};
+    };
+
+    // Two handles, released separately : the one render target (or depth stencil) commands bind, and the texture shader resource commands bind.
+    struct BackendRenderTargetHandles
+    {
+        BackendHandle renderTarget{};
+        BackendHandle texture{};
+    };
+
+    enum class SamplerFilter : uint8_t
+    {
+        Point,
+        Linear,
+        Anisotropic,
+    };
+
+    enum class SamplerAddressMode : uint8_t
+    {
+        Wrap,
+        Clamp,
+        Mirror,
+    };
+
+    // Textures are 2D, so the third coordinate wraps like the first.
+    struct BackendSamplerDesc
+    {
+        SamplerFilter filter{};
+        SamplerAddressMode addressModeU{};
+        SamplerAddressMode addressModeV{};
+    };
+
+    enum class VertexAttributeFormat : uint8_t
+    {
+        Float2,
+        Float3,
+        Float4,
+        Unorm8x4,
+        Snorm16x2,
+        Snorm16x4,
+        Unorm16x2,
+        Unorm16x4,
+        Half2,
+    };
+
+    [[nodiscard]] uint32_t getVertexAttributeSize(const VertexAttributeFormat format);
+
+    struct VertexAttribute
+    {
+        std::string semanticName{};
+        VertexAttributeFormat format{};
+    };
+
+    // Triangle list pipeline. The attributes are packed in order, so their sizes add up to vertexSize.
+    struct BackendPipelineDesc
+    {
+        std::filesystem::path vertexShaderPath{};
+        std::filesystem::path pixelShaderPath{};
+
+        // Defined (as 1) when compiling both shaders.
+        std::vector<std::string> shaderDefines{};
+
+        std::vector<VertexAttribute> vertexAttributes{};
+        uint32_t vertexSize{};
+    };
+
+    // Resource counts and sizes are those of the live resources.
+    struct RenderBackendStats
+    {
+        uint32_t bufferCount{};
+        uint32_t textureCount{};
+        uint32_t renderTargetCount{};
+        uint32_t samplerCount{};
+        uint32_t pipelineCount{};
+
+        uint64_t bufferBytes{};
+        uint64_t textureBytes{};
+        uint64_t renderTargetBytes{};
+
+        uint32_t submittedCommandListCount{};
+        uint64_t commandCount{};
+
+        uint64_t pipelineBindCount{};
+        uint64_t bufferBindCount{};
+        uint64_t textureBindCount{};
+        uint64_t samplerBindCount{};
+
+        uint64_t drawCount{};
+        uint64_t vertexCount{};
+        uint64_t indexCount{};
+
+        RenderBackendStats& operator+=(const RenderBackendStats& other);
+    };
+
+    // Creates the resources and executes the command lists of the engine on a graphics API, and presents frames to the window (if any).
+    // Handles stay valid until released. Resources and pipelines created elsewhere can still be bound by handle, as long as their handles follow
+    // the backend's conventions. Resources may be created and released by any thread, everything else is done by the rendering thread.
+    class RenderBackend
+    {
+      public:
+        virtual ~RenderBackend() = default;
+
+        // data is either empty (leaving the buffer uninitialized) or holds the whole buffer.
+        [[nodiscard]] virtual BackendHandle createBuffer(const BackendBufferDesc& bufferDesc, std::span<const std::byte> data = {}) = 0;
+        [[nodiscard]] virtual BackendHandle createTexture(const BackendTextureDesc& textureDesc, std::span<const std::byte> data) = 0;
+        [[nodiscard]] virtual BackendRenderTargetHandles createRenderTarget(const BackendRenderTargetDesc& renderTargetDesc) = 0;
+        [[nodiscard]] virtual BackendHandle createSampler(const BackendSamplerDesc& samplerDesc) = 0;
+        [[nodiscard]] virtual BackendHandle createGraphicsPipeline(const BackendPipelineDesc& pipelineDesc) = 0;
+
+        // Any handle created above. Lists already submitted are unaffected.
+        virtual void releaseResource(const BackendHandle handle) = 0;
+
+        // Writes data at offset bytes into the buffer. Constant buffers are always written whole. Only call it from the thread that submits, as the
+        // D3D11 backend writes through its immediate context.
+        virtual void updateBuffer(const BackendHandle buffer, std::span<const std::byte> data, const uint32_t offset = 0u) = 0;
+
+        // Executes the lists in order. Each list starts from nothing bound, so the backend may translate them in parallel (see
+        // setParallelSubmissionEnabled).
+        virtual void submit(std::span<const CommandList> commandLists) = 0;
+        void submit(const CommandList& commandList) { submit(std::span(&commandList, 1u)); }
+
+        // Render target of the window, presented by present. Backends without a window have one that is never shown.
+        [[nodiscard]] virtual BackendHandle getBackBuffer() const = 0;
+
+        // The user interface (Dear ImGui) is drawn on top of the back buffer, between beginUserInterfaceFrame (before ImGui::NewFrame) and
+        // renderUserInterface (after ImGui::Render).
+        virtual void beginUserInterfaceFrame() = 0;
+        virtual void renderUserInterface() = 0;
+
+        virtual void present() = 0;
+
+        virtual RenderBackendStats getStats() const = 0;
+
+        // Lets backends which can translate lists in parallel (e.g on D3D11 deferred contexts) do it for submissions of several lists.
+        void setParallelSubmissionEnabled(const bool isEnabled) { m_isParallelSubmissionEnabled = isEnabled; }
+        bool isParallelSubmissionEnabled() const { return m_isParallelSubmissionEnabled; }
+
+      protected:
+        bool m_isParallelSubmissionEnabled{};
+    };
+
+    // Releases the resource it owns on destruction. Move only.
+    class BackendResource
+    {
+      public:
+        BackendResource() = default;
+        BackendResource(RenderBackend& renderBackend, const BackendHandle handle) : m_renderBackend(&renderBackend), m_handle(handle) {}
+        ~BackendResource() { reset(); }
+
+        BackendResource(BackendResource&& other) noexcept;
+        BackendResource& operator=(BackendResource&& other) noexcept;
+
+        BackendResource(const BackendResource&) = delete;
+        BackendResource& operator=(const BackendResource&) = delete;
+
+        void reset();
+
+        BackendHandle get() const { return m_handle; }
+        explicit operator bool() const { return m_handle != nullptr; }
+
+      private:
+        RenderBackend* m_renderBackend{};
+        BackendHandle m_handle{};
+    };
+
+    // Render target (or depth buffer) created by RenderBackend::createRenderTarget.
+    struct RenderTarget
+    {
+        BackendResource renderTarget{};
+        BackendResource texture{};
+    };
+
+    template <typename T> struct ConstantBuffer
+    {
+        BackendResource buffer{};
+        T data{};
+    };
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CommandList.hpp"
+
+namespace sgfx
+{
+    class GeometryPool;
+    class Model;
+
+    // Draw of one mesh of a model.
+    struct RenderItem
+    {
+        const Model* model{};
+        uint32_t meshIndex{};
+    };
+
+    struct DrawSubmissionStats
+    {
+        uint32_t itemCount{};
+        uint32_t drawCount{};
+
+        // State changes actually made, the rest being skipped because the state was already bound.
+        uint32_t vertexBufferBindCount{};
+        uint32_t indexBufferBindCount{};
+        uint32_t transformBindCount{};
+        uint32_t textureBindCount{};
+        uint32_t samplerBindCount{};
+
+        DrawSubmissionStats& operator+=(const DrawSubmissionStats& other);
+    };
+
+    // What the draws recorded so far left bound (std::nullopt until the first draw binds it), so the next one only binds what differs. Use a
+    // new one for each command list, and whenever the state is changed by anything else.
+    struct DrawState
+    {
+        const GeometryPool* geometryPool{};
+        uint32_t vertexSize{};
+        // 0 until an index buffer is bound.
+        uint32_t indexSize{};
+        BackendHandle transformBuffer{};
+
+        // Pixel shader slots 0 (albedo) and 1 (normal).
+        std::array<std::optional<BackendHandle>, 2> textures{};
+        std::array<std::optional<BackendHandle>, 2> samplers{};
+
+        DrawSubmissionStats stats{};
+    };
+
+    // Render items with 64 bit sort keys. Keys are compared as integers, so items sort by pass, then pipeline, then material, then front to
+    // back depth, and radix sorting them groups the items sharing state into runs.
+    class RenderQueue
+    {
+      public:
+        static constexpr uint32_t PASS_BITS = 4u;
+        static constexpr uint32_t PIPELINE_BITS = 8u;
+        static constexpr uint32_t MATERIAL_BITS = 20u;
+
+        // Depth takes the low 32 bits : the bits of a non negative float sort like its value.
+        [[nodiscard]] static uint64_t createSortKey(const uint32_t pass, const uint32_t pipeline, const uint32_t material, const float depth);
+
+        void clear();
+        void reserve(const uint32_t itemCount);
+
+        void add(const uint64_t sortKey, const RenderItem& item);
+
+        // Stable least significant digit radix sort, 8 bits per pass. Passes over a digit that is the same for every key are skipped, so keys
+        // whose high bits barely vary (few passes and pipelines) take fewer passes.
+        void sort();
+
+        // In the order they were added, or in sorted order after sort.
+        std::span<const RenderItem> getItems() const { return m_items; }
+        std::span<const uint64_t> getSortKeys() const { return m_keys; }
+
+        uint32_t getItemCount() const { return static_cast<uint32_t>(m_keys.size()); }
+
+      private:
+        std::vector<uint64_t> m_keys{};
+        std::vector<RenderItem> m_items{};
+
+        // Ping pong buffers of the radix sort, which moves the keys along with the index of their item. Items are only moved once, at the end.
+        std::vector<uint64_t> m_scratchKeys{};
+        std::vector<uint32_t> m_itemIndices{};
+        std::vector<uint32_t> m_scratchItemIndices{};
+        std::vector<RenderItem> m_scratchItems{};
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Bvh.hpp"
+
+namespace sgfx
+{
+    class Model;
+
+    struct SceneMeshReference
+    {
+        uint32_t modelIndex{};
+        uint32_t meshIndex{};
+    };
+
+    struct ScenePickResult
+    {
+        SceneMeshReference mesh{INVALID_INDEX_U32, INVALID_INDEX_U32};
+
+        // Along the picking ray, and the world space point that was hit.
+        float distance{std::numeric_limits<float>::infinity()};
+        math::XMFLOAT3 position{};
+
+        bool isHit() const { return mesh.modelIndex != INVALID_INDEX_U32; }
+    };
+
+    // BVH over the world space bounds of every mesh of a set of models.
+    class SceneBvh
+    {
+      public:
+        // The models must outlive the BVH (or the next build), and their transform buffers must have been updated at least once.
+        void build(std::span<Model* const> models);
+
+        // Refits the BVH if the world bounds of any model changed since the last build or update, returns whether it did.
+        bool update();
+
+        // Meshes that may be in each frustum (see Bvh::queryFrustums).
+        void queryFrustums(std::span<const Frustum> frustums, std::span<std::vector<SceneMeshReference>> outMeshes) const;
+
+        // Closest mesh hit by the world space ray : candidate meshes are visited front to back by their bounds, then tested with Model::raycastMesh.
+        ScenePickResult pick(const Ray& ray) const;
+
+        const Bvh& getBvh() const { return m_bvh; }
+        uint32_t getMeshCount() const { return static_cast<uint32_t>(m_meshes.size()); }
+
+      private:
+        void gatherMeshBounds();
+
+      private:
+        std::vector<Model*> m_models{};
+        std::vector<uint64_t> m_modelWorldBoundsVersions{};
+
+        // Primitives of the BVH.
+        std::vector<SceneMeshReference> m_meshes{};
+        std::vector<AxisAlignedBoundingBox> m_meshBounds{};
+
+        Bvh m_bvh{};
+    };
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+namespace sgfx
+{
+    struct ShaderCompileDesc
+    {
+        std::filesystem::path path{};
+        std::string entryPoint{};
+        std::string target{};
+
+        // Defined (as 1) while compiling.
+        std::vector<std::string> defines{};
+    };
+
+    // Returns std::nullopt if the file cannot be read.
+    using ShaderFileReader = std::function<std::optional<std::string>(const std::filesystem::path& path)>;
+
+    // Returns the compiled bytecode. Throws if the shader does not compile.
+    using ShaderCompiler = std::function<std::vector<std::byte>(const ShaderCompileDesc& compileDesc)>;
+
+    [[nodiscard]] std::optional<std::string> readShaderFile(const std::filesystem::path& path);
+
+    // Paths named by the #include directives of the source, in order. Comments are skipped, but conditional compilation is not evaluated, so
+    // every include is treated as a dependency.
+    [[nodiscard]] std::vector<std::string> scanShaderIncludes(const std::string_view source);
+
+    // Hash of the source, of every file it (transitively) includes, of the defines (in any order), of the entry point and of the target.
+    // Includes are resolved relative to the including file, as D3D_COMPILE_STANDARD_FILE_INCLUDE does. Missing files are hashed as missing, so
+    // creating them later changes the key.
+    [[nodiscard]] uint64_t computeShaderKey(const ShaderCompileDesc& compileDesc, const ShaderFileReader& fileReader = readShaderFile);
+
+    struct ShaderCacheStats
+    {
+        uint32_t requestCount{};
+        uint32_t hitCount{};
+
+        // Compilations that were required because of a cache miss, and the time spent in them (summed over every thread).
+        uint32_t compileCount{};
+        float compileTimeMs{};
+    };
+
+    // On disk cache of compiled shaders, one file per key (see computeShaderKey) in the cache directory.
+    // Thread safe : the compiler runs without holding any lock, so misses of different shaders compile in parallel.
+    class ShaderCache
+    {
+      public:
+        // The file reader is used for dependency scanning only, so scanning and keying can be tested with an in memory file system and a mock compiler.
+        ShaderCache(const std::filesystem::path& cacheDirectory, ShaderCompiler compiler, ShaderFileReader fileReader = readShaderFile);
+
+        // Throws if the shader is not cached and does not compile.
+        [[nodiscard]] std::vector<std::byte> getShader(const ShaderCompileDesc& compileDesc);
+
+        ShaderCacheStats getStats() const;
+
+      private:
+        std::filesystem::path getCachePath(const uint64_t key) const;
+
+        std::optional<std::vector<std::byte>> readCachedShader(const uint64_t key) const;
+        void writeCachedShader(const uint64_t key, std::span<const std::byte> bytecode) const;
+
+      private:
+        std::filesystem::path m_cacheDirectory{};
+
+        ShaderCompiler m_compiler{};
+        ShaderFileReader m_fileReader{};
+
+        ShaderCacheStats m_stats{};
+        mutable std::mutex m_mutex{};
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "SoftwareRasterizer.hpp"
+
+namespace sgfx
+{
+    class JobSystem;
+
+    // Geometry pass targets read by the passes that follow it, as SoftwareRasterizer writes them : RGBA8 albedo (red in the lowest byte),
+    // view space position and view space normal. Rows are rowPitch pixels apart, rowPitch being a multiple of 8, and the pixels past width
+    // are read but never used.
+    struct GBufferImages
+    {
+        uint32_t width{};
+        uint32_t height{};
+        uint32_t rowPitch{};
+
+        std::span<const uint32_t> albedos{};
+        std::span<const math::XMFLOAT4> positions{};
+        std::span<const math::XMFLOAT4> normals{};
+    };
+
+    // CPU implementation of the passes following the geometry pass : SSAO.hlsl, BoxBlur.hlsl and PhongShader.hlsl, reading their inputs as
+    // the GPU passes sample them (with point sampling at pixel centers). The occlusion images are 8 bit, as the R8_UNORM targets of the GPU
+    // passes, and the lit image is HDR. Each pass processes its tiles in parallel, with SIMD over pixels : SSAO evaluates 8 pixels per
+    // iteration with AVX2 (gathering the sample depths) and 4 otherwise, the blur 8 pixels and the lighting 4 pixels per iteration.
+    class SoftwareDeferredPasses
+    {
+      public:
+        static constexpr uint32_t TILE_SIZE = 64u;
+
+        // Of SSAOBuffer::sampleVectors.
+        static constexpr uint32_t MAX_SSAO_SAMPLE_COUNT = 64u;
+
+        // Of the 8 x 8 texels of the SSAO noise texture (tiled over the screen).
+        static constexpr uint32_t SSAO_NOISE_SIZE = 8u;
+
+        void resize(const uint32_t width, const uint32_t height);
+
+        // SSAO.hlsl with the first sampleCount sample vectors (all of them on the GPU). noise holds the 8 x 8 random rotations, row by row.
+        void computeAmbientOcclusion(const GBufferImages& gbuffer,
+                                     const SSAOBuffer& ssaoBuffer,
+                                     std::span<const math::XMFLOAT2> noise,
+                                     const uint32_t sampleCount,
+                                     JobSystem& jobSystem);
+
+        // BoxBlur.hlsl : 3 x 3 average of the occlusion.
+        void blurAmbientOcclusion(JobSystem& jobSystem);
+
+        // PhongShader.hlsl, lit by the scene buffer's lights with the blurred occlusion as ambient factor.
+        void computeLighting(const GBufferImages& gbuffer, const SceneBuffer& sceneBuffer, JobSystem& jobSystem);
+
+        // Writes the occlusion, blurred occlusion and lit images (tone mapped as FullscreenPass.hlsl does) as PNG images : pathPrefix followed by
+        // "_occlusion.png", "_blurred_occlusion.png" and "_lit.png". Returns false if any of them cannot be written.
+        bool writePngs(const std::string_view pathPrefix) const;
+
+        // Compares the images writePngs writes with those at goldenPathPrefix, in the same order.
+        std::array<GoldenImageComparison, 3> compareWithGoldenImages(const std::string_view goldenPathPrefix, const uint32_t tolerance) const;
+
+        uint32_t getWidth() const { return m_width; }
+        uint32_t getHeight() const { return m_height; }
+
+        // Rows of getRowPitch() pixels, of which the first getWidth() are on screen.
+        uint32_t getRowPitch() const { return m_rowPitch; }
+        std::span<const uint8_t> getOcclusions() const { return m_occlusions; }
+        std::span<const uint8_t> getBlurredOcclusions() const { return m_blurredOcclusions; }
+        std::span<const math::XMFLOAT4> getLitColors() const { return m_litColors; }
+
+      private:
+        struct PngImage
+        {
+            std::string_view suffix{};
+            uint32_t channelCount{};
+            std::vector<uint8_t> pixels{};
+        };
+
+        // Tightly packed 8 bit images, in the order of writePngs.
+        std::array<PngImage, 3> getPngImages() const;
+
+        // Inclusive bounds of a tile, clamped to the images. x bounds are multiples of 8 (the last one plus 7), as every pass processes whole
+        // groups of 8 pixels.
+        void getTileBounds(const uint32_t tileIndex, uint32_t& minimumX, uint32_t& minimumY, uint32_t& maximumX, uint32_t& maximumY) const;
+
+        void validateGBuffer(const GBufferImages& gbuffer) const;
+
+      private:
+        uint32_t m_width{};
+        uint32_t m_height{};
+
+        // Rounded up to a multiple of 8.
+        uint32_t m_rowPitch{};
+
+        uint32_t m_tileCountX{};
+        uint32_t m_tileCountY{};
+
+        // z of the G-buffer positions, read by the SSAO samples.
+        std::vector<float> m_viewDepths{};
+
+        std::vector<uint8_t> m_occlusions{};
+        std::vector<uint8_t> m_blurredOcclusions{};
+        std::vector<math::XMFLOAT4> m_litColors{};
+    };
+}
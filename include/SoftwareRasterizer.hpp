@@ -0,0 +1,219 @@
+#pragma once
+
+namespace sgfx
+{
+    class JobSystem;
+
+    // Difference between an image and its golden image, in 8 bit units.
+    struct GoldenImageComparison
+    {
+        // False if the golden image is missing or of another size, the other members being 0.
+        bool isCompared{};
+
+        uint32_t maximumDifference{};
+
+        // Pixels of which a channel differs by more than the tolerance.
+        uint64_t differingPixelCount{};
+    };
+
+    // Compares an image of tightly packed rows of channelCount 8 bit channels with the PNG image at goldenPath.
+    [[nodiscard]] GoldenImageComparison compareWithGoldenImage(const std::string_view goldenPath,
+                                                               std::span<const uint8_t> pixels,
+                                                               const uint32_t width,
+                                                               const uint32_t height,
+                                                               const uint32_t channelCount,
+                                                               const uint32_t tolerance);
+
+    // RGBA8 mip chain sampled by the software rasterizer, mip i being max(width >> i, 1) x max(height >> i, 1) texels.
+    class RasterTexture
+    {
+      public:
+        RasterTexture() = default;
+
+        // texels holds every mip, consecutive from the top one. sRGB texels are converted to linear before filtering, as the GPU does.
+        RasterTexture(const uint32_t width, const uint32_t height, std::vector<uint8_t> texels, const bool isSrgb);
+
+        // Trilinear filtered sample with wrapping addressing. lod is log2 of the texels covered by a pixel, relative to the top mip.
+        math::XMFLOAT4 sample(const float u, const float v, const float lod) const;
+
+        uint32_t getWidth() const { return m_width; }
+        uint32_t getHeight() const { return m_height; }
+        uint32_t getMipCount() const { return static_cast<uint32_t>(m_mipOffsets.size()); }
+
+      private:
+        // Bilinear filtered sample of a mip, in linear space.
+        math::XMFLOAT4 sampleMip(const float u, const float v, const uint32_t mip) const;
+
+      private:
+        uint32_t m_width{};
+        uint32_t m_height{};
+        bool m_isSrgb{};
+
+        // Offset of each mip in m_texels, in texels.
+        std::vector<size_t> m_mipOffsets{};
+        std::vector<uint8_t> m_texels{};
+    };
+
+    // Decodes every mip of a cooked (block compressed) texture. Returns std::nullopt if the file is missing or was not written by the cooker.
+    [[nodiscard]] std::optional<RasterTexture> loadCookedRasterTexture(const std::string_view cookedPath, const bool isSrgb);
+
+    // Generates the mips of an RGBA8 image with a box filter (in linear space for sRGB images).
+    [[nodiscard]] RasterTexture createRasterTexture(const uint32_t width, const uint32_t height, std::span<const uint8_t> pixels, const bool isSrgb);
+
+    // Full resolution triangle list of a mesh, in object space, with the textures of its material. The spans and textures must stay valid until
+    // SoftwareRasterizer::render returns.
+    struct RasterMesh
+    {
+        std::span<const ModelVertex> vertices{};
+        std::span<const uint32_t> indices{};
+        math::XMMATRIX modelMatrix{};
+
+        // Without an albedo texture the mesh is opaque white, without a normal texture its vertex normals are kept.
+        const RasterTexture* albedoTexture{};
+        const RasterTexture* normalTexture{};
+    };
+
+    struct SoftwareRasterizationStats
+    {
+        uint32_t meshCount{};
+        uint64_t triangleCount{};
+
+        // Triangles left after culling back faces and rejecting those that are degenerate or off screen. Triangles crossing the near plane are
+        // clipped, and count once per piece.
+        uint64_t rasterizedTriangleCount{};
+
+        // Pixels covered by a triangle and passing the depth test, and those of them not discarded by the alpha test.
+        uint64_t shadedPixelCount{};
+        uint64_t writtenPixelCount{};
+
+        SoftwareRasterizationStats& operator+=(const SoftwareRasterizationStats& other);
+    };
+
+    // CPU implementation of the geometry pass (GPass.hlsl), writing the same targets : albedo (RGBA8), view space position and view space
+    // normal (float4), with a [0, 1] depth buffer. Follows the D3D11 rules the GPU pass relies on : back faces (counter clockwise on screen)
+    // are culled, pixels are covered at their center with the top left fill rule, and depth is tested with less. Targets are cleared as the
+    // GPU pass clears them, to (0, 0, 0, 1).
+    class SoftwareRasterizer
+    {
+      public:
+        // Tiles are rasterized in parallel.
+        static constexpr uint32_t TILE_SIZE = 64u;
+
+        void resize(const uint32_t width, const uint32_t height);
+
+        // Clears the targets, then draws every mesh with the (row vector) view and projection matrices. Vertices are transformed and
+        // triangles set up (clipped against the near plane) in parallel per mesh, then binned to tiles in mesh order and rasterized in parallel
+        // per tile, with the edge functions and depth test evaluated 8 pixels per iteration with AVX2 and 4 otherwise. Covered pixels are then
+        // shaded one at a time, with perspective correct attributes and texture coordinate derivatives for mip selection. The result does
+        // not depend on the number of threads.
+        SoftwareRasterizationStats render(std::span<const RasterMesh> meshes, const math::XMMATRIX viewMatrix, const math::XMMATRIX projectionMatrix, JobSystem& jobSystem);
+
+        // Writes the albedo, the view space normal (remapped to [0, 1]) and the linear depth (view space z over the farthest one) as PNG
+        // images : pathPrefix followed by "_albedo.png", "_normal.png" and "_depth.png". Returns false if any of them cannot be written.
+        bool writePngs(const std::string_view pathPrefix) const;
+
+        // Compares the images writePngs writes with those at goldenPathPrefix, in the same order.
+        std::array<GoldenImageComparison, 3> compareWithGoldenImages(const std::string_view goldenPathPrefix, const uint32_t tolerance) const;
+
+        uint32_t getWidth() const { return m_width; }
+        uint32_t getHeight() const { return m_height; }
+
+        // Rows of getRowPitch() pixels, of which the first getWidth() are on screen.
+        uint32_t getRowPitch() const { return m_rowPitch; }
+        std::span<const uint32_t> getAlbedos() const { return m_albedos; }
+        std::span<const math::XMFLOAT4> getPositions() const { return m_positions; }
+        std::span<const math::XMFLOAT4> getNormals() const { return m_normals; }
+        std::span<const float> getDepths() const { return m_depths; }
+
+      private:
+        struct PngImage
+        {
+            std::string_view suffix{};
+            uint32_t channelCount{};
+            std::vector<uint8_t> pixels{};
+        };
+
+        // Tightly packed 8 bit images, in the order of writePngs.
+        std::array<PngImage, 3> getPngImages() const;
+
+        // Output of the vertex stage (VsMain) : clip space position, then the attributes interpolated across triangles.
+        struct RasterVertex
+        {
+            math::XMFLOAT4 clipPosition{};
+
+            math::XMFLOAT2 textureCoord{};
+            math::XMFLOAT3 viewPosition{};
+            math::XMFLOAT3 viewNormal{};
+
+            // Rows of the tangent basis, the third being viewNormal.
+            math::XMFLOAT3 viewTangent{};
+            math::XMFLOAT3 viewBitangent{};
+        };
+
+        // Edge functions and depth plane of a screen space triangle, evaluated at pixel centers.
+        struct RasterTriangle
+        {
+            // Edge i goes from vertex i to vertex i + 1, and is positive inside the triangle.
+            std::array<float, 3> edgeX{};
+            std::array<float, 3> edgeY{};
+            std::array<float, 3> edgeOffset{};
+
+            // Bit i is set if edge i is a top or left edge, which owns the pixels centered on it.
+            uint32_t topLeftEdgeMask{};
+
+            float depthX{};
+            float depthY{};
+            float depthOffset{};
+
+            float inverseArea{};
+
+            // Of the clip space w of each vertex, for perspective correct interpolation.
+            std::array<float, 3> inverseW{};
+
+            // Inclusive pixel bounds, clamped to the targets.
+            uint32_t minimumX{};
+            uint32_t minimumY{};
+            uint32_t maximumX{};
+            uint32_t maximumY{};
+
+            uint32_t meshIndex{};
+
+            // Into the vertices of the mesh, clipped vertices included.
+            std::array<uint32_t, 3> vertexIndices{};
+        };
+
+        void transformVertices(const RasterMesh& mesh, const math::XMMATRIX viewMatrix, const math::XMMATRIX projectionMatrix, std::vector<RasterVertex>& outVertices) const;
+        void setupTriangles(const RasterMesh& mesh, const uint32_t meshIndex, std::vector<RasterVertex>& vertices, std::vector<RasterTriangle>& outTriangles) const;
+        void rasterizeTile(const uint32_t tileIndex);
+
+        // Runs PsMain for the pixel, then writes its depth and targets. Returns false if the alpha test discards it, leaving them untouched.
+        bool shadePixel(const RasterTriangle& triangle, const uint32_t x, const uint32_t y, const float depth);
+
+      private:
+        uint32_t m_width{};
+        uint32_t m_height{};
+
+        // Both rounded up to whole tiles.
+        uint32_t m_rowPitch{};
+        uint32_t m_rowCount{};
+
+        uint32_t m_tileCountX{};
+        uint32_t m_tileCountY{};
+
+        // RGBA8 albedo, packed as on the GPU (red in the lowest byte).
+        std::vector<uint32_t> m_albedos{};
+        std::vector<math::XMFLOAT4> m_positions{};
+        std::vector<math::XMFLOAT4> m_normals{};
+        std::vector<float> m_depths{};
+
+        // Of the meshes being rendered.
+        std::span<const RasterMesh> m_meshes{};
+
+        // Per mesh, the triangles being binned in mesh order so the rasterization order within a tile is deterministic.
+        std::vector<std::vector<RasterVertex>> m_meshVertices{};
+        std::vector<std::vector<RasterTriangle>> m_meshTriangles{};
+        std::vector<std::vector<const RasterTriangle*>> m_tileTriangles{};
+
+        std::vector<SoftwareRasterizationStats> m_tileStats{};
+    };
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace sgfx
+{
+    // Generates per vertex tangents following MikkTSpace : per triangle tangents (along increasing u) are projected onto the tangent plane of each
+    // corner's normal, weighted by the corner angle, and averaged over vertices with identical position, normal and texture coordinates.
+    // Vertices shared by triangles of opposite texture space orientation (mirrored UVs) are split, as their tangents must not be averaged.
+    // Follows the glTF convention : bitangent = cross(normal, tangent.xyz) * tangent.w, pointing towards decreasing v.
+    void computeTangents(std::vector<ModelVertex>& vertices, std::span<uint32_t> indices);
+}
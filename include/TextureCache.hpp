@@ -0,0 +1,151 @@
+#pragma once
+
+#include "JobSystem.hpp"
+#include "RenderBackend.hpp"
+#include "TextureCooker.hpp"
+#include "TextureStreaming.hpp"
+
+namespace sgfx
+{
+    struct Texture
+    {
+        // Replaced by TextureCache::updateStreaming when mips are streamed in or evicted.
+        BackendResource resource{};
+
+        // Size of the resident mips.
+        uint64_t sizeInBytes{};
+
+        // Dimensions of the finest mip, which may not be resident.
+        uint32_t width{};
+        uint32_t height{};
+
+        // Id within the cache's texture streamer, INVALID_INDEX_U32 for textures that are always fully resident.
+        uint32_t streamingId{INVALID_INDEX_U32};
+    };
+
+    // Textures are freed once the last handle to them is released.
+    using TextureHandle = std::shared_ptr<const Texture>;
+
+    struct TextureCacheStats
+    {
+        uint64_t requestCount{};
+
+        // Requests served by a resident texture, and by waiting on a load already in flight.
+        uint64_t hitCount{};
+        uint64_t inFlightHitCount{};
+
+        // Bytes of texture memory that every hit would have uploaded again.
+        uint64_t bytesSaved{};
+
+        // Textures cooked during this run, and textures loaded uncompressed as they could not be cooked.
+        uint32_t cookedTextureCount{};
+        uint32_t uncompressedTextureCount{};
+
+        // Of the textures cooked during this run : their compressed size, the summed time spent cooking them (over every thread), and the
+        // quality of the worst one.
+        uint64_t cookedBytes{};
+        double cookTimeMs{};
+        double lowestCookedPsnr{std::numeric_limits<double>::infinity()};
+
+        uint32_t residentTextureCount{};
+        uint64_t residentBytes{};
+
+        TextureStreamingStats streaming{};
+
+        float getHitRate() const { return requestCount == 0u ? 0.0f : static_cast<float>(hitCount + inFlightHitCount) / static_cast<float>(requestCount); }
+    };
+
+    // Process wide cache of uploaded images, keyed by normalized path and usage.
+    // Images are loaded from their cooked (block compressed, fully mipmapped) DDS file, which is cooked first if missing or older than the image.
+    // Only the mip tail of a cooked texture is loaded at first, finer mips are streamed in the background as they are requested.
+    // Thread safe : concurrent requests for an image that is being loaded wait for that single load instead of loading it again.
+    class TextureCache
+    {
+      public:
+        // The backend must outlive the cache and every texture it returned.
+        TextureCache(RenderBackend& renderBackend, JobSystem& jobSystem, const TextureStreamerCreationDesc& streamerCreationDesc = {});
+        ~TextureCache();
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+
+        // Throws if the image cannot be loaded. Waiters on a failed load rethrow the same error, and the next request retries.
+        [[nodiscard]] TextureHandle getTexture(const std::string_view path, const TextureUsage usage);
+
+        // Requests the mips needed for the given level of detail (see computeTextureLod) until the next updateStreaming call.
+        void requestTextureLod(const Texture& texture, const float lod);
+
+        // Swaps in the textures whose streaming requests completed, then issues new requests as background jobs.
+        // Replaces Texture::resource, so it must not run concurrently with code reading it (in practice, with model loading).
+        void updateStreaming();
+
+        TextureCacheStats getStats() const;
+
+      private:
+        struct Key
+        {
+            std::string path{};
+            TextureUsage usage{};
+
+            bool operator==(const Key& other) const = default;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const;
+        };
+
+        struct Entry
+        {
+            std::weak_ptr<const Texture> texture{};
+
+            // Valid while the texture is being loaded.
+            std::shared_future<TextureHandle> pendingLoad{};
+        };
+
+        struct StreamedTexture
+        {
+            std::weak_ptr<Texture> texture{};
+
+            std::string cookedPath{};
+            std::shared_ptr<const CookedTextureLayout> layout{};
+        };
+
+        // Result of a streaming request, resource is null if it failed.
+        struct StreamingLoad
+        {
+            uint32_t textureId{};
+            uint32_t firstMip{};
+
+            BackendResource resource{};
+            uint64_t sizeInBytes{};
+        };
+
+        TextureHandle loadTexture(const std::string& path, const TextureUsage usage);
+
+        // Loads the mip tail of a cooked texture and registers it for streaming.
+        TextureHandle loadStreamedTexture(const std::string& cookedPath, std::shared_ptr<const CookedTextureLayout> layout);
+
+        // Creates a texture from mips [firstMip, mipCount), read with readCookedTextureMips.
+        BackendResource createStreamedTexture(const CookedTextureLayout& layout, const uint32_t firstMip, std::span<const std::byte> mipData) const;
+
+        // Decodes and mipmaps the image at load time, for images that cannot be cooked.
+        TextureHandle loadUncompressedTexture(const std::string& path, const TextureUsage usage) const;
+
+      private:
+        RenderBackend* m_renderBackend{};
+        JobSystem* m_jobSystem{};
+
+        std::unordered_map<Key, Entry, KeyHash> m_entries{};
+        TextureCacheStats m_stats{};
+
+        // Indexed by streaming id.
+        TextureStreamer m_streamer{};
+        std::vector<StreamedTexture> m_streamedTextures{};
+
+        std::vector<StreamingLoad> m_completedStreamingLoads{};
+        JobCounter m_streamingCounter{JobPriority::Low};
+
+        mutable std::mutex m_mutex{};
+    };
+}
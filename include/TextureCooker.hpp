@@ -0,0 +1,100 @@
+#pragma once
+
+#include "BlockCompression.hpp"
+
+namespace sgfx
+{
+    class JobSystem;
+
+    // How materials sample a texture, which decides its block format and color space.
+    enum class TextureUsage : uint8_t
+    {
+        Albedo,
+        Normal,
+        Occlusion,
+        MetalRoughness,
+        Emissive,
+    };
+
+    [[nodiscard]] constexpr bool isSrgbTextureUsage(const TextureUsage usage) { return usage == TextureUsage::Albedo || usage == TextureUsage::Emissive; }
+
+    // Albedo : BC7, which also beats BC3 on both color and alpha for alpha tested textures.
+    // Normal maps : BC5 (the shader reconstructs z). Occlusion : BC4 (red channel).
+    // Metal / roughness and emissive : BC1, metal / roughness has to keep its glTF layout (roughness in green, metalness in blue).
+    [[nodiscard]] BlockFormat getCookedTextureFormat(const TextureUsage usage);
+
+    struct CookedTextureInfo
+    {
+        BlockFormat format{};
+        uint32_t width{};
+        uint32_t height{};
+        uint32_t mipCount{};
+
+        // Size of the full, compressed mip chain.
+        uint64_t sizeInBytes{};
+
+        // Quality of the top mip after compression, over the channels the format stores.
+        double psnr{};
+
+        float cookTimeMs{};
+    };
+
+    struct CookedMipLayout
+    {
+        // Offset from the start of the file.
+        uint64_t offset{};
+        uint64_t size{};
+
+        uint32_t width{};
+        uint32_t height{};
+
+        // Bytes per row of blocks.
+        uint32_t rowPitch{};
+    };
+
+    // Layout of a cooked DDS file, so a subset of its mips can be loaded.
+    struct CookedTextureLayout
+    {
+        BlockFormat format{};
+
+        // Of the albedo and emissive textures, see isSrgbTextureUsage.
+        bool isSrgb{};
+
+        uint32_t width{};
+        uint32_t height{};
+
+        std::vector<CookedMipLayout> mips{};
+    };
+
+    // Cooked textures are written next to their source image, one per usage.
+    [[nodiscard]] std::string getCookedTexturePath(const std::string_view sourcePath, const TextureUsage usage);
+
+    // True if the cooked file was written by the current cooker version, from the current contents of the source image.
+    [[nodiscard]] bool isCookedTextureUpToDate(const std::string_view sourcePath, const std::string_view cookedPath);
+
+    // Returns std::nullopt if the file is missing or was not written by the cooker.
+    [[nodiscard]] std::optional<CookedTextureLayout> readCookedTextureLayout(const std::string_view cookedPath);
+
+    // Reads mips [firstMip, mipCount), which are contiguous in the file. Throws if the file cannot be read.
+    [[nodiscard]] std::vector<std::byte> readCookedTextureMips(const std::string_view cookedPath, const CookedTextureLayout& layout, const uint32_t firstMip);
+
+    // Full mip chain of an image that could not be cooked, as 8 bit RGBA pixels (sRGB encoded for sRGB usages). The mips are tightly packed,
+    // finest first.
+    struct UncompressedTexture
+    {
+        uint32_t width{};
+        uint32_t height{};
+        uint32_t mipCount{};
+
+        std::vector<std::byte> pixels{};
+    };
+
+    // Decodes the source image and filters its mips as cookTexture does, without compressing them. Throws if the image cannot be decoded.
+    [[nodiscard]] UncompressedTexture decodeUncompressedTexture(const std::string_view sourcePath, const TextureUsage usage);
+
+    // Decodes the source image, generates its full mip chain (filtered in linear space for sRGB usages, renormalized for normal maps), block
+    // compresses every mip in parallel and writes the result as a DDS file.
+    // Returns std::nullopt if the image cannot be block compressed (dimensions that are not a multiple of 4) or the file cannot be written.
+    // Throws if the image cannot be decoded.
+    [[nodiscard]] std::optional<CookedTextureInfo> cookTexture(JobSystem& jobSystem, const std::string_view sourcePath, const TextureUsage usage, const std::string_view cookedPath);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+namespace sgfx
+{
+    struct TextureStreamerCreationDesc
+    {
+        // Mips whose largest dimension is at most this are loaded with the texture, and are never evicted.
+        uint32_t mipTailDimension{64u};
+
+        // Hard cap on the memory of every streamed texture. A request creates a new texture from the mips that remain resident, so the current
+        // and the new texture both count against it until the request completes. Mip tails always count against it, but can not be evicted.
+        uint64_t residentBudgetBytes{256ull * 1024ull * 1024ull};
+
+        // Bytes of new mips requested by a single update, and number of requests in flight at once.
+        uint64_t uploadBudgetBytesPerUpdate{8ull * 1024ull * 1024ull};
+        uint32_t maxPendingRequestCount{8u};
+    };
+
+    struct StreamedTextureDesc
+    {
+        // Size of every mip, from the finest to the coarsest.
+        std::span<const uint64_t> mipSizes{};
+
+        uint32_t width{};
+        uint32_t height{};
+
+        // Coarsest mip the resident range may start at (e.g block compressed textures need a first mip made of whole blocks).
+        uint32_t maxFirstMip{INVALID_INDEX_U32};
+    };
+
+    // Makes mips [firstMip, mipCount) of the texture resident : a firstMip finer than the resident one loads mips, a coarser one evicts them.
+    struct TextureStreamingRequest
+    {
+        uint32_t textureId{};
+        uint32_t firstMip{};
+    };
+
+    struct TextureStreamingStats
+    {
+        uint32_t textureCount{};
+        uint32_t pendingRequestCount{};
+
+        // Textures whose resident mip is coarser than the one wanted.
+        uint32_t waitingTextureCount{};
+
+        uint64_t residentBytes{};
+        uint64_t budgetBytes{};
+
+        // Textures being created by the requests in flight, counted against the budget alongside residentBytes.
+        uint64_t inFlightBytes{};
+
+        // Requests issued by the last update.
+        uint32_t lastUpdateLoadCount{};
+        uint32_t lastUpdateEvictionCount{};
+
+        // Totals since creation.
+        uint64_t loadedBytes{};
+        uint64_t evictedBytes{};
+        uint64_t evictionCount{};
+    };
+
+    // Level of detail sampled where a pixel covers textureCoordsPerPixel texture coordinate units (for a surface with a given texture coordinate
+    // density per world unit, seen from a distance d by a camera covering projectionScale pixels per world unit at unit distance : density * d /
+    // projectionScale) : log2 of the number of top mip texels per pixel.
+    [[nodiscard]] float computeTextureLod(const uint32_t textureSize, const float textureCoordsPerPixel);
+
+    // Decides which mips of every streamed texture are resident, within a hard memory budget. Independent of the graphics API : update returns
+    // requests, which the caller performs (asynchronously) and reports back with completeRequest. Not thread safe.
+    // When a load does not fit the budget, mips are evicted in this order :
+    //  - Mips finer than wanted, from the least recently requested textures first.
+    //  - The finest mip of textures that would still be closer to their wanted mip than the loading texture is, closest and largest first.
+    //    This spreads the loss of detail over every texture rather than starving the ones requested last.
+    class TextureStreamer
+    {
+      public:
+        explicit TextureStreamer(const TextureStreamerCreationDesc& creationDesc = {});
+
+        // Only the mip tail is resident until a request for finer mips completes.
+        [[nodiscard]] uint32_t addTexture(const StreamedTextureDesc& textureDesc);
+        void removeTexture(const uint32_t textureId);
+
+        uint32_t getMipTailFirstMip(const uint32_t textureId) const { return m_textures[textureId].mipTailFirstMip; }
+        uint32_t getResidentMip(const uint32_t textureId) const { return m_textures[textureId].residentMip; }
+        uint32_t getWantedMip(const uint32_t textureId) const { return m_textures[textureId].wantedMip; }
+        uint64_t getResidentSize(const uint32_t textureId) const { return getSize(m_textures[textureId], m_textures[textureId].residentMip); }
+
+        // Keeps the finest mip requested since the last update. Textures without any request are wanted at their mip tail.
+        void requestMip(const uint32_t textureId, const uint32_t mip);
+
+        // Textures furthest from their wanted mip are served first, each request loading as many mips as the remaining upload budget allows
+        // (at least one). Mips are only evicted when a load would exceed the resident budget, the load is then issued by a later update once
+        // the evictions completed.
+        [[nodiscard]] std::vector<TextureStreamingRequest> update();
+
+        // Must be called once for every request returned by update, with the first mip that is now resident (the previous one if the request failed).
+        void completeRequest(const uint32_t textureId, const uint32_t residentMip);
+
+        TextureStreamingStats getStats() const;
+
+      private:
+        struct StreamedTexture
+        {
+            std::vector<uint64_t> mipSizes{};
+
+            uint32_t mipTailFirstMip{};
+            uint32_t residentMip{};
+            uint32_t wantedMip{};
+            uint32_t requestedMip{INVALID_INDEX_U32};
+
+            // Target of the request in flight, if any.
+            uint32_t pendingMip{INVALID_INDEX_U32};
+
+            // Index of the last update that followed a requestMip call.
+            uint64_t lastRequestedUpdate{};
+
+            bool isActive{};
+        };
+
+        // Size of mips [firstMip, mipCount).
+        static uint64_t getSize(const StreamedTexture& texture, const uint32_t firstMip);
+
+        // Issues eviction requests to free at least byteCount bytes of mips for a load of loadingTextureId. The textures they create are added to
+        // residentBytes, returns the bytes of the textures they release once complete. Evictions that only make room for the load (rather than
+        // dropping unwanted mips) are not issued if they can not free enough.
+        uint64_t evict(const uint64_t byteCount, const uint32_t loadingTextureId, uint64_t& residentBytes, std::vector<TextureStreamingRequest>& requests);
+
+      private:
+        TextureStreamerCreationDesc m_creationDesc{};
+
+        std::vector<StreamedTexture> m_textures{};
+        std::vector<uint32_t> m_freeTextureIds{};
+
+        uint64_t m_updateIndex{};
+
+        uint32_t m_lastUpdateLoadCount{};
+        uint32_t m_lastUpdateEvictionCount{};
+
+        uint64_t m_loadedBytes{};
+        uint64_t m_evictedBytes{};
+        uint64_t m_evictionCount{};
+    };
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+namespace sgfx
+{
+    struct LocalTransform
+    {
+        math::XMFLOAT3 translation{0.0f, 0.0f, 0.0f};
+
+        // Quaternion.
+        math::XMFLOAT4 rotation{0.0f, 0.0f, 0.0f, 1.0f};
+
+        math::XMFLOAT3 scale{1.0f, 1.0f, 1.0f};
+    };
+
+    // Flattened node hierarchy, stored as structure of arrays. Nodes are sorted so every parent comes before its children, which lets a single
+    // linear pass compute the world matrices : a node is recomputed if it is dirty or if its parent was recomputed earlier in the same pass.
+    class TransformHierarchy
+    {
+      public:
+        void reserve(const uint32_t nodeCount);
+
+        // parentIndex is either INVALID_INDEX_U32 (for a root) or a node that was already added. New nodes are dirty.
+        uint32_t addNode(const uint32_t parentIndex, const LocalTransform& localTransform);
+
+        void setLocalTransform(const uint32_t nodeIndex, const LocalTransform& localTransform);
+        LocalTransform getLocalTransform(const uint32_t nodeIndex) const;
+
+        // Recomputes the world matrices of dirty nodes and of all their descendants, returns the number of nodes recomputed.
+        uint32_t updateWorldMatrices();
+
+        // True if the world matrix of the node was recomputed by the last updateWorldMatrices call.
+        bool isWorldMatrixUpdated(const uint32_t nodeIndex) const { return m_isUpdated[nodeIndex] != 0u; }
+
+        const math::XMMATRIX& getWorldMatrix(const uint32_t nodeIndex) const { return m_worldMatrices[nodeIndex]; }
+
+        uint32_t getParentIndex(const uint32_t nodeIndex) const { return m_parentIndices[nodeIndex]; }
+        uint32_t getNodeCount() const { return static_cast<uint32_t>(m_parentIndices.size()); }
+
+      private:
+        std::vector<uint32_t> m_parentIndices{};
+
+        std::vector<math::XMFLOAT3> m_translations{};
+        std::vector<math::XMFLOAT4> m_rotations{};
+        std::vector<math::XMFLOAT3> m_scales{};
+
+        std::vector<math::XMMATRIX> m_worldMatrices{};
+
+        // One byte per node : set by setLocalTransform and cleared by updateWorldMatrices, and set for every node the last update recomputed.
+        std::vector<uint8_t> m_isDirty{};
+        std::vector<uint8_t> m_isUpdated{};
+
+        // Nodes before the first dirty one can not change, so the update pass starts there. getNodeCount() if no node is dirty.
+        uint32_t m_firstDirtyNode{};
+    };
+}
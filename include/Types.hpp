@@ -22,83 +22,59 @@ namespace sgfx
         math::XMFLOAT3 position{};
         math::XMFLOAT2 textureCoord{};
         math::XMFLOAT3 normal{};
-    };
-
-    static constexpr uint32_t LIGHT_COUNT = 5u;
-
-    struct alignas(256) SceneBuffer
-    {
-        math::XMMATRIX viewMatrix{};
-        math::XMMATRIX viewProjectionMatrix{};
 
-        math::XMFLOAT4 lightColorIntensity[LIGHT_COUNT]{};
-        math::XMFLOAT4 viewSpaceLightPosition[LIGHT_COUNT]{};
-    };
-
-    struct alignas(256) LightMatrix
-    {
-        math::XMMATRIX lightModelMatrix[sgfx::LIGHT_COUNT - 1u];
+        // w is the handedness of the tangent basis : bitangent = cross(normal, tangent.xyz) * w.
+        math::XMFLOAT4 tangent{};
     };
 
-    struct InputLayoutElementDesc
+    // 16 byte alternative to ModelVertex. Position is quantized to the model bounds, texture coordinates are half floats and the normal is
+    // octahedral encoded. Position w holds the tangent, as an angle around the normal plus the handedness (see encodeTangent).
+    struct CompactModelVertex
     {
-        std::string semanticName{};
-        DXGI_FORMAT format{};
-        D3D11_INPUT_CLASSIFICATION inputClassification{};
+        uint16_t position[4]{};
+        uint16_t textureCoord[2]{};
+        int16_t normal[2]{};
     };
 
-    struct SamplerCreationDesc
+    enum class VertexFormat : uint8_t
     {
-        D3D11_FILTER filter{};
-        D3D11_TEXTURE_ADDRESS_MODE addressMode{};
+        Float,
+        Compact,
     };
 
-    struct BufferCreationDesc
+    inline constexpr uint32_t getVertexSize(const VertexFormat vertexFormat)
     {
-        D3D11_USAGE usage;
-        uint32_t bindFlags{};
-    };
+        return vertexFormat == VertexFormat::Compact ? static_cast<uint32_t>(sizeof(CompactModelVertex)) : static_cast<uint32_t>(sizeof(ModelVertex));
+    }
 
-    template <typename T> struct ConstantBuffer
+    struct AxisAlignedBoundingBox
     {
-        wrl::ComPtr<ID3D11Buffer> buffer{};
-        T data{};
+        math::XMFLOAT3 minimum{};
+        math::XMFLOAT3 maximum{};
     };
 
-    struct GraphicsPipelineCreationDesc
+    // Points origin + t * direction for t in [0, maxDistance]. The direction does not have to be normalized, distances are in units of its length.
+    struct Ray
     {
-        std::wstring vertexShaderPath{};
-        std::wstring pixelShaderPath{};
-
-        std::vector<InputLayoutElementDesc> inputLayoutElements{};
-
-        D3D11_PRIMITIVE_TOPOLOGY primitiveTopology{};
-        uint32_t vertexSize{};
+        math::XMFLOAT3 origin{};
+        math::XMFLOAT3 direction{};
+        float maxDistance{std::numeric_limits<float>::infinity()};
     };
 
-    struct GraphicsPipeline
-    {
-        wrl::ComPtr<ID3D11VertexShader> vertexShader{};
-        wrl::ComPtr<ID3D11PixelShader> pixelShader{};
-        wrl::ComPtr<ID3D11InputLayout> inputLayout{};
-
-        D3D11_PRIMITIVE_TOPOLOGY primitiveTopology{};
-
-        uint32_t vertexSize{};
-    };
+    static constexpr uint32_t LIGHT_COUNT = 5u;
 
-    struct RenderTarget
+    struct alignas(256) SceneBuffer
     {
-        wrl::ComPtr<ID3D11Texture2D> texture{};
+        math::XMMATRIX viewMatrix{};
+        math::XMMATRIX viewProjectionMatrix{};
 
-        wrl::ComPtr<ID3D11RenderTargetView> rtv{};
-        wrl::ComPtr<ID3D11ShaderResourceView> srv{};
+        math::XMFLOAT4 lightColorIntensity[LIGHT_COUNT]{};
+        math::XMFLOAT4 viewSpaceLightPosition[LIGHT_COUNT]{};
     };
 
-    struct DepthTexture
+    struct alignas(256) LightMatrix
     {
-        wrl::ComPtr<ID3D11DepthStencilView> dsv{};
-        wrl::ComPtr<ID3D11ShaderResourceView> srv{};
+        math::XMMATRIX lightModelMatrix[sgfx::LIGHT_COUNT - 1u];
     };
 
     struct alignas(256) SSAOBuffer
@@ -11,6 +11,7 @@ inline void fatalError(const std::string_view message, const std::source_locatio
     throw std::runtime_error(errorMessage.data());
 }
 
+#ifdef _WIN32
 inline void throwIfFailed(const HRESULT hr, const std::source_location sourceLocation = std::source_location::current())
 {
     if (FAILED(hr))
@@ -48,5 +49,31 @@ inline std::string wStringToString(const std::wstring_view inputWString)
 
     return result;
 }
+#endif
 
 template <typename T> static inline constexpr typename std::underlying_type<T>::type enumClassValue(const T& value) { return static_cast<std::underlying_type<T>::type>(value); }
+
+// Non cryptographic 64 bit hash, used to key cached data by its contents.
+inline uint64_t hashBytes(const std::span<const std::byte> data, const uint64_t seed = 0xcbf29ce484222325ull)
+{
+    uint64_t hash = seed ^ (data.size() * 0x9e3779b97f4a7c15ull);
+
+    // Process eight bytes at a time, then the remaining bytes one at a time.
+    size_t i = 0u;
+    for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t))
+    {
+        uint64_t word{};
+        std::memcpy(&word, data.data() + i, sizeof(uint64_t));
+
+        hash = std::rotl(hash ^ (word * 0x9e3779b97f4a7c15ull), 31) * 0xbf58476d1ce4e5b9ull;
+    }
+
+    for (; i < data.size(); ++i)
+    {
+        hash = (hash ^ static_cast<uint64_t>(data[i])) * 0x100000001b3ull;
+    }
+
+    return hash ^ (hash >> 29u);
+}
+
+inline uint64_t hashCombine(const uint64_t hash, const uint64_t value) { return hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6u) + (hash >> 2u)); }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+
+namespace sgfx
+{
+    // Maps quantized positions (unorm16, in [0, 1]) back to object space : position = quantized * scale + offset.
+    struct PositionDequantization
+    {
+        math::XMFLOAT4 scale{1.0f, 1.0f, 1.0f, 0.0f};
+        math::XMFLOAT4 offset{0.0f, 0.0f, 0.0f, 0.0f};
+    };
+
+    [[nodiscard]] PositionDequantization getPositionDequantization(const AxisAlignedBoundingBox& bounds);
+
+    // Half floats step by 1/256 of a texture repeat up to this magnitude, and twice as coarsely with every power of two beyond it.
+    inline constexpr float MAX_COMPACT_TEXTURE_COORD = 8.0f;
+
+    // Whether every texture coordinate is within +/- MAX_COMPACT_TEXTURE_COORD. Models with larger (tiling) coordinates keep float vertices.
+    [[nodiscard]] bool canEncodeCompactTextureCoords(std::span<const ModelVertex> vertices);
+
+    // Encodes vertices into the compact format, using F16C / SSE4.1 when available. Positions are quantized to the given bounds.
+    void encodeCompactVertices(std::span<const ModelVertex> vertices, const AxisAlignedBoundingBox& bounds, std::span<CompactModelVertex> outVertices);
+
+    // Scalar reference encoders and decoders, the SIMD path produces identical results.
+    [[nodiscard]] uint16_t quantizeUnorm16(const float value, const float minimum, const float inverseExtent);
+    [[nodiscard]] uint16_t floatToHalf(const float value);
+    [[nodiscard]] float halfToFloat(const uint16_t value);
+    [[nodiscard]] std::array<int16_t, 2> encodeOctahedralNormal(const math::XMFLOAT3& normal);
+    [[nodiscard]] math::XMFLOAT3 decodeOctahedralNormal(const std::array<int16_t, 2>& encodedNormal);
+
+    // The tangent is stored as its angle (15 bits) within an orthonormal basis derived from the normal, and the handedness in the top bit.
+    // Pass the decoded normal, so the basis matches the one the vertex shader derives.
+    [[nodiscard]] uint16_t encodeTangent(const math::XMFLOAT3& normal, const math::XMFLOAT4& tangent);
+    [[nodiscard]] math::XMFLOAT4 decodeTangent(const math::XMFLOAT3& normal, const uint16_t encodedTangent);
+
+    // Vertex attributes matching ModelVertex / CompactModelVertex. Shaders consuming the compact layout need COMPACT_VERTEX defined.
+    [[nodiscard]] std::vector<VertexAttribute> getModelVertexAttributes(const VertexFormat vertexFormat);
+}
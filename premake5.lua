@@ -1,65 +1,188 @@
+newoption
+{
+    trigger = "no-profiler",
+    description = "Compile the CPU profiler zones to nothing"
+}
+
 workspace "SimpleGfx"
-    configurations 
-    { 
-        "Debug", 
-        "Release" 
+    configurations
+    {
+        "Debug",
+        "Release"
     }
     architecture "x86_64"
+    startproject "SimpleGfx"
 
-project "SimpleGfx"
-    kind "ConsoleApp"
-    
     language "C++"
     cppdialect "C++20"
-    
+
     targetdir "bin/%{cfg.buildcfg}"
-    
+
     staticruntime "Off"
 
-    nuget 
-    { 
-        "directxtex_desktop_2019:2022.10.18.1"
+    -- Assets, shaders and golden images are loaded relative to the repository root.
+    debugdir "."
+
+    includedirs
+    {
+        "include/"
     }
 
+    filter "not options:no-profiler"
+        defines
+        {
+            "SGFX_PROFILER"
+        }
+
+    filter "configurations:Debug"
+        defines
+        {
+            "_DEBUG"
+        }
+        symbols "On"
+        optimize "Debug"
+
+    filter "configurations:Release"
+        defines
+        {
+            "_NDEBUG"
+        }
+        optimize "Speed"
+
+    filter "system:not windows"
+        links
+        {
+            "pthread"
+        }
+
+    filter {}
+
+-- Everything but the entry points, shared by the application, the tests and the benchmarks.
+project "SimpleGfxCore"
+    kind "StaticLib"
+
     pchheader "Pch.hpp"
     pchsource "src/Pch.cpp"
 
-    files 
-    { 
+    files
+    {
         "src/**.cpp",
         "include/**.hpp",
         "shaders/**.hlsl",
         "shaders/**.hlsli",
     }
 
-    includedirs
+    removefiles
     {
-        "include/"
+        "src/Main.cpp",
+        "src/Engine*.cpp",
+        "include/Engine.hpp"
+    }
+
+    filter "files:**.hlsl"
+        buildaction ("None")
+
+    -- Direct3D only exists on Windows, and so does the window (SDL2) with its user interface (ImGui). Model loading (tinygltf) is part of
+    -- the core everywhere, headless runs use the null render backend.
+    filter "system:not windows"
+        removefiles
+        {
+            "src/ApplicationWindow.cpp",
+            "src/D3D11*.cpp"
+        }
+
+project "SimpleGfx"
+    kind "ConsoleApp"
+
+    pchheader "Pch.hpp"
+    pchsource "src/Pch.cpp"
+
+    files
+    {
+        "src/Main.cpp",
+        "src/Engine*.cpp",
+        "src/Pch.cpp",
+        "include/Engine.hpp"
     }
 
     links
     {
-        "d3d11.lib",
-        "dxgi.lib",
-        "d3dcompiler.lib",
-        "winmm.lib",
-        "dxguid.lib"
+        "SimpleGfxCore"
     }
 
-    filter "files:**.hlsl"
-        buildaction ("None")
+    filter "system:windows"
+        links
+        {
+            "d3d11.lib",
+            "dxgi.lib",
+            "d3dcompiler.lib",
+            "winmm.lib",
+            "dxguid.lib"
+        }
 
-    filter "configurations:Debug"
-        defines 
-        { 
-            "_DEBUG" 
+    -- The windowed frame and its user interface.
+    filter "system:not windows"
+        removefiles
+        {
+            "src/EngineWindow.cpp"
         }
-        symbols "On"
-        optimize "Debug"
 
-    filter "configurations:Release"
-        defines 
-        { 
-            "_NDEBUG"
+-- Unit tests of the platform independent code. Returns a non zero exit code if any check fails.
+project "SimpleGfxTests"
+    kind "ConsoleApp"
+
+    files
+    {
+        "tests/**.cpp",
+        "tests/**.hpp"
+    }
+
+    includedirs
+    {
+        "tests/"
+    }
+
+    links
+    {
+        "SimpleGfxCore"
+    }
+
+    filter "system:windows"
+        links
+        {
+            "d3d11.lib",
+            "dxgi.lib",
+            "d3dcompiler.lib",
+            "winmm.lib",
+            "dxguid.lib"
+        }
+
+-- Benchmarks of the engine's systems, run from the repository root. Runs every benchmark, or those whose name contains the first argument.
+project "SimpleGfxBenchmarks"
+    kind "ConsoleApp"
+
+    files
+    {
+        "benchmarks/**.cpp",
+        "benchmarks/**.hpp"
+    }
+
+    includedirs
+    {
+        "benchmarks/"
+    }
+
+    links
+    {
+        "SimpleGfxCore"
+    }
+
+    filter "system:windows"
+        links
+        {
+            "d3d11.lib",
+            "dxgi.lib",
+            "d3dcompiler.lib",
+            "winmm.lib",
+            "dxguid.lib"
         }
-        optimize "Speed"
\ No newline at end of file
@@ -1,9 +1,21 @@
+// Compact vertices : position is unorm16 quantized to the model bounds, normal is octahedral encoded and position.w holds the tangent
+// (angle around the normal and handedness).
+#ifdef COMPACT_VERTEX
+struct VSInput
+{
+    float4 position : POSITION;
+    float2 textureCoord : TEXTURECOORD;
+    float2 normal : NORMAL;
+};
+#else
 struct VSInput
 {
     float3 position : POSITION;
     float2 textureCoord : TEXTURECOORD;
     float3 normal : NORMAL;
+    float4 tangent : TANGENT;
 };
+#endif
 
 struct VSOutput
 {
@@ -28,33 +40,89 @@ cbuffer transformBuffer : register(b1)
     row_major matrix modelMatrix;
     row_major matrix inverseModelMatrix;
     row_major matrix inverseModelViewMatrix;
+
+    float4 positionDequantizationScale;
+    float4 positionDequantizationOffset;
 };
 
+float3 getPosition(VSInput input)
+{
+#ifdef COMPACT_VERTEX
+    return input.position.xyz * positionDequantizationScale.xyz + positionDequantizationOffset.xyz;
+#else
+    return input.position;
+#endif
+}
+
+float3 getNormal(VSInput input)
+{
+#ifdef COMPACT_VERTEX
+    float3 normal = float3(input.normal, 1.0f - abs(input.normal.x) - abs(input.normal.y));
+    const float t = saturate(-normal.z);
+    normal.xy += (normal.xy >= 0.0f) ? -t : t;
+    return normalize(normal);
+#else
+    return input.normal;
+#endif
+}
+
+// Duff et al. 2017, "Building an Orthonormal Basis, Revisited". Must match getTangentBasis in VertexQuantization.cpp.
+void getTangentBasis(float3 normal, out float3 b1, out float3 b2)
+{
+    const float s = normal.z >= 0.0f ? 1.0f : -1.0f;
+    const float a = -1.0f / (s + normal.z);
+    const float b = normal.x * normal.y * a;
+
+    b1 = float3(1.0f + s * normal.x * normal.x * a, s * b, -s * normal.x);
+    b2 = float3(b, s + normal.y * normal.y * a, -normal.y);
+}
+
+float4 getTangent(VSInput input, float3 normal)
+{
+#ifdef COMPACT_VERTEX
+    static const float TWO_PI = 6.28318530718f;
+
+    const uint encodedTangent = (uint)round(input.position.w * 65535.0f);
+    const float angle = (float)(encodedTangent & 0x7fff) * (TWO_PI / 32768.0f);
+
+    float3 b1;
+    float3 b2;
+    getTangentBasis(normal, b1, b2);
+
+    float sine;
+    float cosine;
+    sincos(angle, sine, cosine);
+
+    return float4(b1 * cosine + b2 * sine, (encodedTangent & 0x8000) ? 1.0f : -1.0f);
+#else
+    return input.tangent;
+#endif
+}
+
 VSOutput VsMain(VSInput input)
 {
+    const float3 position = getPosition(input);
+    const float3 inputNormal = getNormal(input);
+    const float4 inputTangent = getTangent(input, inputNormal);
+
     VSOutput output;
-    output.position = mul(mul(float4(input.position, 1.0f), modelMatrix), viewProjectionMatrix);
+    output.position = mul(mul(float4(position, 1.0f), modelMatrix), viewProjectionMatrix);
     output.textureCoord = input.textureCoord;
 
     const float3x3 transposedInverseModelViewMatrix = (float3x3)transpose(inverseModelViewMatrix);
-    output.viewSpaceNormal = normalize(mul(input.normal, transposedInverseModelViewMatrix));
-
-    output.viewSpacePixelPosition = mul(float4(input.position, 1.0f), mul(modelMatrix, viewMatrix)).xyz;
-
-    // Calculation of tbn matrix.
-    const float3 normal = normalize(input.normal);
+    output.viewSpaceNormal = normalize(mul(inputNormal, transposedInverseModelViewMatrix));
 
-    // Generate tangent from normal.
-    static const float MIN_FLOAT_VALUE = 0.00001f;
+    output.viewSpacePixelPosition = mul(float4(position, 1.0f), mul(modelMatrix, viewMatrix)).xyz;
 
-    float3 tangent = cross(normal, float3(0.0f, 1.0f, 0.0f));
-    tangent = normalize(lerp(cross(normal, float3(1.0f, 0.0f, 0.0f)), tangent, step(MIN_FLOAT_VALUE, dot(tangent, tangent))));
+    // Calculation of tbn matrix. Tangents are directions on the surface, so they are transformed by the model view matrix itself
+    // (normals use its inverse transpose).
+    const float3x3 modelViewMatrix = (float3x3)mul(modelMatrix, viewMatrix);
 
-    const float3 biTangent = normalize(cross(normal, tangent));
+    const float3 biTangent = cross(inputNormal, inputTangent.xyz) * inputTangent.w;
 
-    const float3 t = normalize(mul(tangent, transposedInverseModelViewMatrix));
-    const float3 b = normalize(mul(biTangent, transposedInverseModelViewMatrix));
-    const float3 n = normalize(mul(normal, transposedInverseModelViewMatrix));
+    const float3 t = normalize(mul(inputTangent.xyz, modelViewMatrix));
+    const float3 b = normalize(mul(biTangent, modelViewMatrix));
+    const float3 n = output.viewSpaceNormal;
 
     output.tbnMatrix = float3x3(t, b, n);
 
@@ -90,7 +158,9 @@ PSOutput PsMain(VSOutput input)
     float3 normal = normalize(input.viewSpaceNormal);
     if (normalTextureWidth != 0)
     {
-        normal = 2.0f * normalTexture.Sample(normalTextureSampler, input.textureCoord).xyz - float3(1.0f, 1.0f, 1.0f);
+        // Normal maps are cooked to BC5, which only stores x and y.
+        const float2 normalXY = 2.0f * normalTexture.Sample(normalTextureSampler, input.textureCoord).xy - float2(1.0f, 1.0f);
+        normal = float3(normalXY, sqrt(saturate(1.0f - dot(normalXY, normalXY))));
         normal = normalize(mul(normal, input.tbnMatrix));
     }
 
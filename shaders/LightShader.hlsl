@@ -1,9 +1,19 @@
+// Compact vertices : position is unorm16 quantized to the model bounds, normal is octahedral encoded (and unused here).
+#ifdef COMPACT_VERTEX
+struct VSInput
+{
+    float4 position : POSITION;
+    float2 textureCoord : TEXTURECOORD;
+    float2 normal : NORMAL;
+};
+#else
 struct VSInput
 {
     float3 position : POSITION;
     float2 textureCoord : TEXTURECOORD;
     float3 normal : NORMAL;
 };
+#endif
 
 struct VSOutput
 {
@@ -25,14 +35,26 @@ cbuffer transformBuffer : register(b1)
     row_major matrix modelMatrix;
     row_major matrix inverseModelMatrix;
     row_major matrix inverseModelViewMatrix;
+
+    float4 positionDequantizationScale;
+    float4 positionDequantizationOffset;
 };
 
+float3 getPosition(VSInput input)
+{
+#ifdef COMPACT_VERTEX
+    return input.position.xyz * positionDequantizationScale.xyz + positionDequantizationOffset.xyz;
+#else
+    return input.position;
+#endif
+}
+
 cbuffer instanceModelMatrixBuffer : register(b2) { row_major matrix modelMatrices[4]; };
 
 VSOutput VsMain(VSInput input, uint instanceID : SV_InstanceID)
 {
     VSOutput output;
-    output.position = mul(mul(float4(input.position, 1.0f), modelMatrices[instanceID]), viewProjectionMatrix);
+    output.position = mul(mul(float4(getPosition(input), 1.0f), modelMatrices[instanceID]), viewProjectionMatrix);
     output.colorIntensity = lightColorIntensity[instanceID];
 
     return output;
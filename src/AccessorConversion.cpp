@@ -0,0 +1,381 @@
+#include "Pch.hpp"
+
+#include "AccessorConversion.hpp"
+
+#include "CpuFeatures.hpp"
+
+#include <immintrin.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        constexpr uint32_t COMPONENT_TYPE_BYTE = 5120u;
+        constexpr uint32_t COMPONENT_TYPE_UNSIGNED_BYTE = 5121u;
+        constexpr uint32_t COMPONENT_TYPE_SHORT = 5122u;
+        constexpr uint32_t COMPONENT_TYPE_UNSIGNED_SHORT = 5123u;
+        constexpr uint32_t COMPONENT_TYPE_UNSIGNED_INT = 5125u;
+        constexpr uint32_t COMPONENT_TYPE_FLOAT = 5126u;
+
+        // Vertices per block of convertAttributesToFloats : 12 KB of 48 byte vertices, well within the L1 cache.
+        constexpr uint32_t ATTRIBUTE_CONVERSION_BLOCK_SIZE = 256u;
+
+        // Number of leading elements for which a 16 byte load starting at the element does not read past the end of the accessor.
+        uint32_t getSafeWideLoadCount(const AccessorView& accessor, const uint32_t elementSize)
+        {
+            if (accessor.count == 0u)
+            {
+                return 0u;
+            }
+
+            const uint64_t accessorSize = static_cast<uint64_t>(accessor.count - 1u) * accessor.byteStride + elementSize;
+            if (accessorSize < 16u)
+            {
+                return 0u;
+            }
+
+            return std::min(accessor.count, static_cast<uint32_t>((accessorSize - 16u) / std::max(accessor.byteStride, 1u)) + 1u);
+        }
+
+        // Stores the first ComponentCount lanes only, as the following bytes may belong to another (already written) attribute.
+        template <uint32_t ComponentCount> inline void storePartial(float* const destination, const __m128 value)
+        {
+            if constexpr (ComponentCount == 4u)
+            {
+                _mm_storeu_ps(destination, value);
+            }
+            else if constexpr (ComponentCount == 3u)
+            {
+                _mm_storel_pi(reinterpret_cast<__m64*>(destination), value);
+                _mm_store_ss(destination + 2u, _mm_movehl_ps(value, value));
+            }
+            else if constexpr (ComponentCount == 2u)
+            {
+                _mm_storel_pi(reinterpret_cast<__m64*>(destination), value);
+            }
+            else
+            {
+                _mm_store_ss(destination, value);
+            }
+        }
+
+        template <uint32_t ComponentCount> void convertFloats(const AccessorView& accessor, std::byte* const destination, const uint32_t destinationStride)
+        {
+            constexpr uint32_t elementSize = ComponentCount * sizeof(float);
+
+            // Tight layouts on both sides : single copy.
+            if (accessor.byteStride == elementSize && destinationStride == elementSize)
+            {
+                std::memcpy(destination, accessor.data, static_cast<size_t>(accessor.count) * elementSize);
+                return;
+            }
+
+            const uint32_t safeWideLoadCount = getSafeWideLoadCount(accessor, elementSize);
+
+            for (uint32_t i = 0u; i < safeWideLoadCount; ++i)
+            {
+                const __m128 value = _mm_loadu_ps(reinterpret_cast<const float*>(accessor.data + static_cast<size_t>(i) * accessor.byteStride));
+                storePartial<ComponentCount>(reinterpret_cast<float*>(destination + static_cast<size_t>(i) * destinationStride), value);
+            }
+
+            for (uint32_t i = safeWideLoadCount; i < accessor.count; ++i)
+            {
+                std::memcpy(destination + static_cast<size_t>(i) * destinationStride, accessor.data + static_cast<size_t>(i) * accessor.byteStride, elementSize);
+            }
+        }
+
+        template <typename T, bool Normalized> inline float convertComponent(const T value)
+        {
+            if constexpr (!Normalized)
+            {
+                return static_cast<float>(value);
+            }
+            else if constexpr (std::is_signed_v<T>)
+            {
+                return std::max(static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max()), -1.0f);
+            }
+            else
+            {
+                return static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max());
+            }
+        }
+
+        template <typename T, uint32_t ComponentCount, bool Normalized>
+        void convertIntegersScalar(const AccessorView& accessor, std::byte* const destination, const uint32_t destinationStride, const uint32_t firstElement)
+        {
+            for (uint32_t i = firstElement; i < accessor.count; ++i)
+            {
+                std::array<T, ComponentCount> components{};
+                std::memcpy(components.data(), accessor.data + static_cast<size_t>(i) * accessor.byteStride, sizeof(components));
+
+                std::array<float, ComponentCount> result{};
+                for (const uint32_t c : std::views::iota(0u, ComponentCount))
+                {
+                    result[c] = convertComponent<T, Normalized>(components[c]);
+                }
+
+                std::memcpy(destination + static_cast<size_t>(i) * destinationStride, result.data(), sizeof(result));
+            }
+        }
+
+        // 8 and 16 bit components : widen all components of an element at once to 32 bit integers, then convert to float.
+        // Division (rather than multiplication by the reciprocal) keeps the result bit identical to the scalar path.
+        template <typename T, uint32_t ComponentCount, bool Normalized>
+        SGFX_TARGET_SSE41 void convertIntegersSse41(const AccessorView& accessor, std::byte* const destination, const uint32_t destinationStride)
+        {
+            const __m128 maxValue = _mm_set1_ps(static_cast<float>(std::numeric_limits<T>::max()));
+            const __m128 minusOne = _mm_set1_ps(-1.0f);
+
+            for (uint32_t i = 0u; i < accessor.count; ++i)
+            {
+                uint64_t packedComponents{};
+                std::memcpy(&packedComponents, accessor.data + static_cast<size_t>(i) * accessor.byteStride, sizeof(T) * ComponentCount);
+
+                const __m128i packed = _mm_cvtsi64_si128(static_cast<int64_t>(packedComponents));
+
+                __m128i widened{};
+                if constexpr (std::is_same_v<T, uint8_t>)
+                {
+                    widened = _mm_cvtepu8_epi32(packed);
+                }
+                else if constexpr (std::is_same_v<T, int8_t>)
+                {
+                    widened = _mm_cvtepi8_epi32(packed);
+                }
+                else if constexpr (std::is_same_v<T, uint16_t>)
+                {
+                    widened = _mm_cvtepu16_epi32(packed);
+                }
+                else
+                {
+                    widened = _mm_cvtepi16_epi32(packed);
+                }
+
+                __m128 value = _mm_cvtepi32_ps(widened);
+                if constexpr (Normalized)
+                {
+                    value = _mm_div_ps(value, maxValue);
+                    if constexpr (std::is_signed_v<T>)
+                    {
+                        value = _mm_max_ps(value, minusOne);
+                    }
+                }
+
+                storePartial<ComponentCount>(reinterpret_cast<float*>(destination + static_cast<size_t>(i) * destinationStride), value);
+            }
+        }
+
+        template <typename T, uint32_t ComponentCount, bool Normalized>
+        void convertIntegers(const AccessorView& accessor, std::byte* const destination, const uint32_t destinationStride)
+        {
+            if constexpr (sizeof(T) <= sizeof(uint16_t))
+            {
+                if (getCpuFeatures().sse41)
+                {
+                    convertIntegersSse41<T, ComponentCount, Normalized>(accessor, destination, destinationStride);
+                    return;
+                }
+            }
+
+            convertIntegersScalar<T, ComponentCount, Normalized>(accessor, destination, destinationStride, 0u);
+        }
+
+        template <typename T, bool Normalized> void dispatchComponentCount(const AccessorView& accessor, std::byte* const destination, const uint32_t destinationStride)
+        {
+            switch (accessor.componentCount)
+            {
+                case 1u: convertIntegers<T, 1u, Normalized>(accessor, destination, destinationStride); break;
+                case 2u: convertIntegers<T, 2u, Normalized>(accessor, destination, destinationStride); break;
+                case 3u: convertIntegers<T, 3u, Normalized>(accessor, destination, destinationStride); break;
+                case 4u: convertIntegers<T, 4u, Normalized>(accessor, destination, destinationStride); break;
+                default: fatalError("Unsupported accessor component count.");
+            }
+        }
+
+        template <typename T> void dispatchNormalized(const AccessorView& accessor, std::byte* const destination, const uint32_t destinationStride)
+        {
+            if (accessor.normalized)
+            {
+                dispatchComponentCount<T, true>(accessor, destination, destinationStride);
+            }
+            else
+            {
+                dispatchComponentCount<T, false>(accessor, destination, destinationStride);
+            }
+        }
+
+        template <typename T> void widenIndicesScalar(const AccessorView& accessor, uint32_t* const destination, const uint32_t firstElement)
+        {
+            for (uint32_t i = firstElement; i < accessor.count; ++i)
+            {
+                T index{};
+                std::memcpy(&index, accessor.data + static_cast<size_t>(i) * accessor.byteStride, sizeof(T));
+
+                destination[i] = static_cast<uint32_t>(index);
+            }
+        }
+
+        SGFX_TARGET_AVX2 uint32_t widenTightShortIndicesAvx2(const uint16_t* const source, uint32_t* const destination, const uint32_t count)
+        {
+            uint32_t i = 0u;
+            for (; i + 16u <= count; i += 16u)
+            {
+                const __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_cvtepu16_epi32(_mm256_castsi256_si128(indices)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i + 8u), _mm256_cvtepu16_epi32(_mm256_extracti128_si256(indices, 1)));
+            }
+
+            return i;
+        }
+
+        uint32_t widenTightShortIndicesSse2(const uint16_t* const source, uint32_t* const destination, const uint32_t count)
+        {
+            const __m128i zero = _mm_setzero_si128();
+
+            uint32_t i = 0u;
+            for (; i + 8u <= count; i += 8u)
+            {
+                const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_unpacklo_epi16(indices, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i + 4u), _mm_unpackhi_epi16(indices, zero));
+            }
+
+            return i;
+        }
+
+        uint32_t widenTightByteIndicesSse2(const uint8_t* const source, uint32_t* const destination, const uint32_t count)
+        {
+            const __m128i zero = _mm_setzero_si128();
+
+            uint32_t i = 0u;
+            for (; i + 16u <= count; i += 16u)
+            {
+                const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+                const __m128i low = _mm_unpacklo_epi8(indices, zero);
+                const __m128i high = _mm_unpackhi_epi8(indices, zero);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_unpacklo_epi16(low, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i + 4u), _mm_unpackhi_epi16(low, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i + 8u), _mm_unpacklo_epi16(high, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i + 12u), _mm_unpackhi_epi16(high, zero));
+            }
+
+            return i;
+        }
+    }
+
+    void convertAccessorToFloats(const AccessorView& accessor, std::byte* const destination, const uint32_t destinationStride)
+    {
+        switch (accessor.componentType)
+        {
+            case COMPONENT_TYPE_FLOAT:
+                {
+                    switch (accessor.componentCount)
+                    {
+                        case 1u: convertFloats<1u>(accessor, destination, destinationStride); break;
+                        case 2u: convertFloats<2u>(accessor, destination, destinationStride); break;
+                        case 3u: convertFloats<3u>(accessor, destination, destinationStride); break;
+                        case 4u: convertFloats<4u>(accessor, destination, destinationStride); break;
+                        default: fatalError("Unsupported accessor component count.");
+                    }
+                }
+                break;
+
+            case COMPONENT_TYPE_BYTE: dispatchNormalized<int8_t>(accessor, destination, destinationStride); break;
+            case COMPONENT_TYPE_UNSIGNED_BYTE: dispatchNormalized<uint8_t>(accessor, destination, destinationStride); break;
+            case COMPONENT_TYPE_SHORT: dispatchNormalized<int16_t>(accessor, destination, destinationStride); break;
+            case COMPONENT_TYPE_UNSIGNED_SHORT: dispatchNormalized<uint16_t>(accessor, destination, destinationStride); break;
+            case COMPONENT_TYPE_UNSIGNED_INT: dispatchNormalized<uint32_t>(accessor, destination, destinationStride); break;
+
+            default:
+                {
+                    fatalError("Unsupported accessor component type.");
+                }
+                break;
+        }
+    }
+
+    void convertAttributesToFloats(std::span<const AttributeConversion> attributes, std::byte* const destination, const uint32_t destinationStride)
+    {
+        if (attributes.empty())
+        {
+            return;
+        }
+
+        const uint32_t count = attributes.front().accessor.count;
+
+        for (uint32_t firstElement = 0u; firstElement < count; firstElement += ATTRIBUTE_CONVERSION_BLOCK_SIZE)
+        {
+            const uint32_t blockCount = std::min(count - firstElement, ATTRIBUTE_CONVERSION_BLOCK_SIZE);
+
+            for (const AttributeConversion& attribute : attributes)
+            {
+                if (firstElement >= attribute.accessor.count)
+                {
+                    continue;
+                }
+
+                AccessorView blockAccessor = attribute.accessor;
+                blockAccessor.data += static_cast<size_t>(firstElement) * blockAccessor.byteStride;
+                blockAccessor.count = std::min(blockCount, attribute.accessor.count - firstElement);
+
+                convertAccessorToFloats(blockAccessor, destination + static_cast<size_t>(firstElement) * destinationStride + attribute.destinationOffset, destinationStride);
+            }
+        }
+    }
+
+    void convertIndices(const AccessorView& accessor, uint32_t* const destination)
+    {
+        switch (accessor.componentType)
+        {
+            case COMPONENT_TYPE_UNSIGNED_INT:
+                {
+                    if (accessor.byteStride == sizeof(uint32_t))
+                    {
+                        std::memcpy(destination, accessor.data, static_cast<size_t>(accessor.count) * sizeof(uint32_t));
+                    }
+                    else
+                    {
+                        widenIndicesScalar<uint32_t>(accessor, destination, 0u);
+                    }
+                }
+                break;
+
+            case COMPONENT_TYPE_UNSIGNED_SHORT:
+                {
+                    uint32_t convertedCount = 0u;
+                    if (accessor.byteStride == sizeof(uint16_t))
+                    {
+                        const uint16_t* const source = reinterpret_cast<const uint16_t*>(accessor.data);
+
+                        convertedCount = getCpuFeatures().avx2 ? widenTightShortIndicesAvx2(source, destination, accessor.count)
+                                                               : widenTightShortIndicesSse2(source, destination, accessor.count);
+                    }
+
+                    widenIndicesScalar<uint16_t>(accessor, destination, convertedCount);
+                }
+                break;
+
+            case COMPONENT_TYPE_UNSIGNED_BYTE:
+                {
+                    uint32_t convertedCount = 0u;
+                    if (accessor.byteStride == sizeof(uint8_t))
+                    {
+                        convertedCount = widenTightByteIndicesSse2(accessor.data, destination, accessor.count);
+                    }
+
+                    widenIndicesScalar<uint8_t>(accessor, destination, convertedCount);
+                }
+                break;
+
+            default:
+                {
+                    fatalError("Unsupported index component type.");
+                }
+                break;
+        }
+    }
+}
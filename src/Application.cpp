@@ -2,65 +2,33 @@
 
 #include "Application.hpp"
 
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_syswm.h>
-
-#include <DirectXTex.h>
+#include "NullRenderBackend.hpp"
 
 namespace sgfx
 {
+    namespace
+    {
+        // Resolution of the (never shown) back buffer when headless, so runs do not depend on the monitor.
+        constexpr uint32_t HEADLESS_WIDTH = 1920u;
+        constexpr uint32_t HEADLESS_HEIGHT = 1080u;
+    }
+
     Application::Application(const std::string_view windowTitle) : m_windowTitle(windowTitle) {}
 
     Application::~Application() { cleanup(); }
 
-    void Application::run()
+    void Application::runBenchmark()
     {
         try
         {
+            m_isHeadless = true;
+
             init();
 
             loadContent();
+            m_geometryPool->flushUploads();
 
-            std::chrono::high_resolution_clock clock{};
-            std::chrono::high_resolution_clock::time_point previousFrameTime{};
-
-            bool quit = false;
-            while (!quit)
-            {
-                SDL_Event event{};
-                while (SDL_PollEvent(&event))
-                {
-                    ImGui_ImplSDL2_ProcessEvent(&event);
-
-                    if (event.type == SDL_QUIT)
-                    {
-                        quit = true;
-                    }
-
-                    const uint8_t* keyboardState = SDL_GetKeyboardState(nullptr);
-                    if (keyboardState[SDL_SCANCODE_ESCAPE])
-                    {
-                        quit = true;
-                    }
-
-                    m_camera.handleInput(Keys::W, keyboardState[SDL_SCANCODE_W]);
-                    m_camera.handleInput(Keys::A, keyboardState[SDL_SCANCODE_A]);
-                    m_camera.handleInput(Keys::S, keyboardState[SDL_SCANCODE_S]);
-                    m_camera.handleInput(Keys::D, keyboardState[SDL_SCANCODE_D]);
-
-                    m_camera.handleInput(Keys::AUp, keyboardState[SDL_SCANCODE_UP]);
-                    m_camera.handleInput(Keys::ALeft, keyboardState[SDL_SCANCODE_LEFT]);
-                    m_camera.handleInput(Keys::ADown, keyboardState[SDL_SCANCODE_DOWN]);
-                    m_camera.handleInput(Keys::ARight, keyboardState[SDL_SCANCODE_RIGHT]);
-                }
-
-                const auto currentFrameTime = clock.now();
-                const float deltaTime = static_cast<float>((currentFrameTime - previousFrameTime).count() * 1e-9);
-                previousFrameTime = currentFrameTime;
-
-                update(deltaTime);
-                render();
-            }
+            benchmark();
         }
         catch (const std::exception& exception)
         {
@@ -69,393 +37,174 @@ namespace sgfx
         }
     }
 
-    void Application::init()
+    void Application::runHeadless(const uint32_t frameCount)
     {
-        // Set DPI awareness on Windows
-        SDL_SetHint(SDL_HINT_WINDOWS_DPI_AWARENESS, "permonitorv2");
-        SDL_SetHint(SDL_HINT_WINDOWS_DPI_SCALING, "1");
-
-        // Initialize SDL2 and create window.
-        if (SDL_Init(SDL_INIT_EVERYTHING) < 0)
-        {
-            fatalError("Failed to initialize SDL2.");
-        }
-
-        // Get monitor dimensions.
-        SDL_DisplayMode displayMode{};
-        if (SDL_GetCurrentDisplayMode(0, &displayMode) < 0)
-        {
-            fatalError("Failed to get display mode.");
-        }
-
-        const uint32_t monitorWidth = displayMode.w;
-        const uint32_t monitorHeight = displayMode.h;
-
-        // Window must cover 100% of the screen.
-        m_windowWidth = static_cast<uint32_t>(monitorWidth * 1.00f);
-        m_windowHeight = static_cast<uint32_t>(monitorHeight * 1.00f);
-
-        // Not made const as SDL_DestroyWindow requires us to pass a non - const SDL_Window.
-        SDL_Window* m_window = SDL_CreateWindow("SimpleGfx", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, m_windowWidth, m_windowHeight, SDL_WINDOW_ALLOW_HIGHDPI);
-
-        if (!m_window)
+        try
         {
-            fatalError("Failed to create SDL2 window.");
-        }
-
-        SDL_SysWMinfo wmInfo{};
-        SDL_VERSION(&wmInfo.version);
-
-        SDL_GetWindowWMInfo(m_window, &wmInfo);
-        m_windowHandle = wmInfo.info.win.window;
-
-        // Initialize graphics back end.
-        createDeviceResources();
-        createSwapchainResources();
-
-        // Init Imgui.
-        IMGUI_CHECKVERSION();
-        ImGui::CreateContext();
-
-        ImGui::StyleColorsDark();
-        ImGui_ImplSDL2_InitForD3D(m_window);
-        ImGui_ImplDX11_Init(m_device.Get(), m_deviceContext.Get());
+            m_isHeadless = true;
 
-        // Create the fallback texture that will be used if some texture does not exist but the shader requires something to be bound at that slot.
-        m_fallbackTexture = createTexture(L"assets/textures/Default.png");
-    }
+            init();
 
-    void Application::cleanup()
-    {
+            loadContent();
 
-        ImGui_ImplDX11_Shutdown();
-        ImGui_ImplSDL2_Shutdown();
-        ImGui::DestroyContext();
+            // Fixed time steps, so every run does the same work.
+            constexpr float deltaTime = 1.0f / 60.0f;
 
-        SDL_DestroyWindow(m_window);
-        SDL_Quit();
-    }
+            std::vector<double> frameDurations{};
+            frameDurations.reserve(frameCount);
 
-    void Application::createDeviceResources()
-    {
-        // Create the DXGI factory (with debug flags set in debug build).
-        uint32_t factoryCreationFlags = 0u;
-        if constexpr (SGFX_DEBUG)
-        {
-            factoryCreationFlags = DXGI_CREATE_FACTORY_DEBUG;
-        }
+            for (uint32_t frame = 0u; frame < frameCount; frame++)
+            {
+                // Drains the previous frame's zones, outside of the measured frame.
+                SGFX_PROFILE_END_FRAME();
 
-        throwIfFailed(::CreateDXGIFactory2(factoryCreationFlags, IID_PPV_ARGS(&m_factory)));
+                const auto startTime = std::chrono::high_resolution_clock::now();
 
-        // Get the adapter with best performance.
-        comptr<IDXGIAdapter1> adapter{};
-        throwIfFailed(m_factory->EnumAdapterByGpuPreference(0u, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&adapter)));
+                // Geometry of the models loaded since the previous frame.
+                m_geometryPool->flushUploads();
 
-        uint32_t deviceCreationFlags = 0u;
+                update(deltaTime);
+                renderHeadless();
 
-        if constexpr (SGFX_DEBUG)
-        {
-            deviceCreationFlags |= D3D11_CREATE_DEVICE_DEBUG;
+                frameDurations.emplace_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count());
+            }
 
-            // Display chosen adapter.
-            DXGI_ADAPTER_DESC1 adapterDesc{};
-            throwIfFailed(adapter->GetDesc1(&adapterDesc));
+            if (frameDurations.empty())
+            {
+                return;
+            }
 
-            std::cout << "Chosen Adapter : ";
-            std::wcout << adapterDesc.Description << L'\n';
+            const double averageDuration = std::accumulate(frameDurations.begin(), frameDurations.end(), 0.0) / frameDurations.size();
+
+            std::ranges::sort(frameDurations);
+            const auto getPercentile = [&](const double percentile) { return frameDurations[static_cast<size_t>(percentile * (frameDurations.size() - 1u))]; };
+
+            const RenderBackendStats stats = m_renderBackend->getStats();
+
+            std::cout << std::format("Headless frames ({}) : average {:.3f} ms, median {:.3f} ms, 99th percentile {:.3f} ms, max {:.3f} ms.\n",
+                                     frameCount,
+                                     averageDuration,
+                                     getPercentile(0.5),
+                                     getPercentile(0.99),
+                                     frameDurations.back());
+            // Every pipeline draws triangle lists, so the triangles drawn (after LOD selection and culling) follow from the vertices and indices.
+            std::cout << std::format("    per frame : {} command lists, {} commands, {} draws, {} triangles ({} indices), {} buffer / {} texture / {} sampler binds.\n",
+                                     stats.submittedCommandListCount / frameCount,
+                                     stats.commandCount / frameCount,
+                                     stats.drawCount / frameCount,
+                                     (stats.vertexCount + stats.indexCount) / 3u / frameCount,
+                                     stats.indexCount / frameCount,
+                                     stats.bufferBindCount / frameCount,
+                                     stats.textureBindCount / frameCount,
+                                     stats.samplerBindCount / frameCount);
         }
-
-        // Create the D3D11 device and device context.
-        throwIfFailed(
-            ::D3D11CreateDevice(adapter.Get(), D3D_DRIVER_TYPE_UNKNOWN, nullptr, deviceCreationFlags, nullptr, 0u, D3D11_SDK_VERSION, &m_device, nullptr, &m_deviceContext));
-
-        if constexpr (SGFX_DEBUG)
+        catch (const std::exception& exception)
         {
-            // Enable debug layer.
-            throwIfFailed(m_device.As(&m_debug));
-
-            // Setup info queue.
-            throwIfFailed(m_device.As(&m_infoQueue));
-            throwIfFailed(m_infoQueue->SetBreakOnSeverity(D3D11_MESSAGE_SEVERITY_CORRUPTION, true));
-            throwIfFailed(m_infoQueue->SetBreakOnSeverity(D3D11_MESSAGE_SEVERITY_ERROR, true));
-            throwIfFailed(m_infoQueue->SetBreakOnSeverity(D3D11_MESSAGE_SEVERITY_WARNING, true));
+            std::cerr << exception.what() << "\n";
+            return;
         }
     }
 
-    void Application::createSwapchainResources()
-    {
-        // Create the swapchain.
-        const DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {
-            .Width = m_windowWidth,
-            .Height = m_windowHeight,
-            .Format = DXGI_FORMAT_R10G10B10A2_UNORM,
-            .SampleDesc = {1u, 0u},
-            .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
-            .BufferCount = 2u,
-            .Scaling = DXGI_SCALING_STRETCH,
-            .SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD,
-            .Flags = 0u,
-        };
-
-       
-        throwIfFailed(m_factory->CreateSwapChainForHwnd(m_device.Get(), m_windowHandle, &swapChainDesc, nullptr, nullptr, &m_swapchain));
-
-        // Setup the swapchain backbuffer render target view.
-        comptr<ID3D11Texture2D> backBuffer{};
-        throwIfFailed(m_swapchain->GetBuffer(0u, IID_PPV_ARGS(&backBuffer)));
-
-        throwIfFailed(m_device->CreateRenderTargetView(backBuffer.Get(), nullptr, &m_renderTargetView));
-
-        m_viewport = {
-            .TopLeftX = 0.0f,
-            .TopLeftY = 0.0f,
-            .Width = static_cast<float>(m_windowWidth),
-            .Height = static_cast<float>(m_windowHeight),
-            .MinDepth = 0.0f,
-            .MaxDepth = 1.0f,
-        };
-    }
-
-    Microsoft::WRL::ComPtr<ID3D11VertexShader> Application::createVertexShader(const std::wstring_view shaderPath, comptr<ID3DBlob>& outShaderBlob)
+    void Application::init()
     {
-        comptr<ID3D11VertexShader> vertexShader{};
-
-        comptr<ID3DBlob> errorBlob{};
-
-        if (FAILED(::D3DCompileFromFile(shaderPath.data(), nullptr, nullptr, "VsMain", "vs_5_0", 0u, 0u, &outShaderBlob, &errorBlob)))
+        if (m_isHeadless)
         {
-            std::wcout << "Error in compiling shader : " << shaderPath << ". Error : " << static_cast<const char*>(errorBlob->GetBufferPointer());
-            throw std::runtime_error("Shader compilation error.");
-        }
-
-        throwIfFailed(m_device->CreateVertexShader(outShaderBlob->GetBufferPointer(), outShaderBlob->GetBufferSize(), nullptr, &vertexShader));
-
-        return vertexShader;
-    }
-
-    void Application::bindPipeline(const GraphicsPipeline& pipeline)
-    {
-        m_deviceContext->IASetPrimitiveTopology(pipeline.primitiveTopology);
-        m_deviceContext->IASetInputLayout(pipeline.inputLayout.Get());
-
-        m_deviceContext->VSSetShader(pipeline.vertexShader.Get(), nullptr, 0u);
-        m_deviceContext->PSSetShader(pipeline.pixelShader.Get(), nullptr, 0u);
-    }
+            // Nothing is displayed, so there is no window, device or user interface.
+            m_windowWidth = HEADLESS_WIDTH;
+            m_windowHeight = HEADLESS_HEIGHT;
 
-    void Application::bindTexturePS(ID3D11ShaderResourceView* const srv, const uint32_t bindSlot)
-    {
-        if (!srv)
-        {
-            m_deviceContext->PSSetShaderResources(bindSlot, 1u, m_fallbackTexture.GetAddressOf());
+            m_renderBackend = std::make_unique<NullRenderBackend>();
         }
+#ifdef _WIN32
         else
         {
-            m_deviceContext->PSSetShaderResources(bindSlot, 1u, &srv);
+            initWindow();
         }
-    }
+#endif
 
-    Microsoft::WRL::ComPtr<ID3D11PixelShader> Application::createPixelShader(const std::wstring_view shaderPath)
-    {
-        comptr<ID3D11PixelShader> pixelShader{};
-
-        comptr<ID3DBlob> shaderBlob{};
-        comptr<ID3DBlob> errorBlob{};
+        m_viewport = SetViewportCommand{
+            .width = static_cast<float>(m_windowWidth),
+            .height = static_cast<float>(m_windowHeight),
+        };
 
-        if (FAILED(::D3DCompileFromFile(shaderPath.data(), nullptr, nullptr, "PsMain", "ps_5_0", 0u, 0u, &shaderBlob, &errorBlob)))
-        {
-            std::wcout << "Error in compiling shader : " << shaderPath << ". Error : " << static_cast<const char*>(errorBlob->GetBufferPointer());
-            throw std::runtime_error("Shader compilation error.");
-        }
+        // Create the geometry pool all models are uploaded into.
+        m_geometryPool = std::make_unique<GeometryPool>(*m_renderBackend,
+                                                        GeometryPoolCreationDesc{
+                                                            .vertexBufferSize = 64u * 1024u * 1024u,
+                                                            .shortIndexCapacity = 8u * 1024u * 1024u,
+                                                            .indexCapacity = 4u * 1024u * 1024u,
+                                                        });
 
-        throwIfFailed(m_device->CreatePixelShader(shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize(), nullptr, &pixelShader));
+        m_textureCache = std::make_unique<TextureCache>(*m_renderBackend, m_jobSystem);
 
-        return pixelShader;
+        // Create the fallback texture that will be used if some texture does not exist but the shader requires something to be bound at that slot.
+        m_fallbackTexture = m_textureCache->getTexture("assets/textures/Default.png", TextureUsage::Albedo);
     }
 
-    Microsoft::WRL::ComPtr<ID3D11InputLayout> Application::createInputLayout(ID3DBlob* vertexShaderBlob, std::span<const InputLayoutElementDesc> inputLayoutElementDescs)
+    void Application::cleanup()
     {
-        if (inputLayoutElementDescs.size() == 0)
-        {
-            return nullptr;
-        }
-
-        comptr<ID3D11InputLayout> inputLayout{};
-
-        std::vector<D3D11_INPUT_ELEMENT_DESC> inputElementDescs{};
-        inputElementDescs.reserve(inputLayoutElementDescs.size());
+        // Everything holding backend resources goes first, the backend (and its user interface renderer) then.
+        m_fallbackTexture.reset();
+        m_textureCache.reset();
+        m_geometryPool.reset();
+        m_renderBackend.reset();
+        m_shaderCache.reset();
 
-        for (const auto& inputLayoutElementDesc : inputLayoutElementDescs)
+#ifdef _WIN32
+        if (m_window)
         {
-            inputElementDescs.emplace_back(D3D11_INPUT_ELEMENT_DESC{
-                .SemanticName = inputLayoutElementDesc.semanticName.c_str(),
-                .SemanticIndex = 0u,
-                .Format = inputLayoutElementDesc.format,
-                .InputSlot = 0u,
-                .AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT,
-                .InputSlotClass = inputLayoutElementDesc.inputClassification,
-                .InstanceDataStepRate = 0u,
-            });
+            cleanupWindow();
         }
-
-        throwIfFailed(m_device->CreateInputLayout(inputElementDescs.data(),
-                                                  static_cast<uint32_t>(inputElementDescs.size()),
-                                                  vertexShaderBlob->GetBufferPointer(),
-                                                  vertexShaderBlob->GetBufferSize(),
-                                                  &inputLayout));
-
-        return inputLayout;
+#endif
     }
 
-    GraphicsPipeline Application::createGraphicsPipeline(const GraphicsPipelineCreationDesc& pipelineCreationDesc)
+    BackendResource Application::createGraphicsPipeline(const BackendPipelineDesc& pipelineDesc)
     {
-        comptr<ID3DBlob> vertexShaderBlob{};
-
-        comptr<ID3D11VertexShader> vertexShader = createVertexShader(pipelineCreationDesc.vertexShaderPath, vertexShaderBlob);
-
-        return GraphicsPipeline{
-            .vertexShader = vertexShader,
-            .pixelShader = createPixelShader(pipelineCreationDesc.pixelShaderPath),
-            .inputLayout = createInputLayout(vertexShaderBlob.Get(), pipelineCreationDesc.inputLayoutElements),
-            .primitiveTopology = pipelineCreationDesc.primitiveTopology,
-            .vertexSize = pipelineCreationDesc.vertexSize,
-        };
+        return BackendResource(*m_renderBackend, m_renderBackend->createGraphicsPipeline(pipelineDesc));
     }
 
-    wrl::ComPtr<ID3D11ShaderResourceView> Application::createTexture(const std::wstring_view texturePath)
+    std::vector<BackendResource> Application::createGraphicsPipelines(std::span<const BackendPipelineDesc> pipelineDescs)
     {
-        // Main reference : https://github.com/GraphicsProgramming/learnd3d11/blob/main/src/Cpp/1-getting-started/1-3-1-Texturing/TexturingApplication.cpp.
-
-        comptr<ID3D11ShaderResourceView> srv{};
+        // Each job writes to its own pipeline, backends create resources from any thread.
+        std::vector<BackendResource> pipelines(pipelineDescs.size());
 
-        DirectX::TexMetadata metaData{};
-        DirectX::ScratchImage scratchImage{};
+        JobCounter pipelineCounter{};
+        const ScopedJobWait pipelineWait(m_jobSystem, pipelineCounter);
 
-        if (FAILED(DirectX::LoadFromWICFile(texturePath.data(), DirectX::WIC_FLAGS_NONE, &metaData, scratchImage)))
+        for (const size_t index : std::views::iota(0u, pipelineDescs.size()))
         {
-            std::wcout << L"Failed to load texture from path : " << texturePath << L'\n';
-            throw std::runtime_error("Texture Loading Error");
+            m_jobSystem.submit([&, index]() { pipelines[index] = createGraphicsPipeline(pipelineDescs[index]); }, pipelineCounter);
         }
 
-        DirectX::ScratchImage mipChain{};
-        throwIfFailed(DirectX::GenerateMipMaps(scratchImage.GetImages(), scratchImage.GetImageCount(), metaData, DirectX::TEX_FILTER_DEFAULT, 0u, mipChain));
-
-        comptr<ID3D11Resource> texture{};
-        throwIfFailed(DirectX::CreateTexture(m_device.Get(), mipChain.GetImages(), mipChain.GetImageCount(), mipChain.GetMetadata(), &texture));
+        m_jobSystem.wait(pipelineCounter);
 
-        throwIfFailed(DirectX::CreateShaderResourceView(m_device.Get(), mipChain.GetImages(), mipChain.GetImageCount(), mipChain.GetMetadata(), &srv));
-
-        return srv;
+        return pipelines;
     }
 
-    wrl::ComPtr<ID3D11SamplerState> Application::createSampler(const SamplerCreationDesc& samplerCreationDesc)
+    BackendResource Application::createSampler(const BackendSamplerDesc& samplerDesc)
     {
-        comptr<ID3D11SamplerState> sampler{};
-
-        const D3D11_SAMPLER_DESC samplerDesc = {
-            .Filter = samplerCreationDesc.filter,
-            .AddressU = samplerCreationDesc.addressMode,
-            .AddressV = samplerCreationDesc.addressMode,
-            .AddressW = samplerCreationDesc.addressMode,
-            .MaxAnisotropy = D3D11_MAX_MAXANISOTROPY,
-            .ComparisonFunc = D3D11_COMPARISON_NEVER,
-        };
-
-        throwIfFailed(m_device->CreateSamplerState(&samplerDesc, &sampler));
-
-        return sampler;
+        return BackendResource(*m_renderBackend, m_renderBackend->createSampler(samplerDesc));
     }
 
-    RenderTarget Application::createRenderTarget(const uint32_t width, const uint32_t height, const DXGI_FORMAT format)
+    RenderTarget Application::createRenderTarget(const uint32_t width, const uint32_t height, const TextureFormat format)
     {
-        RenderTarget renderTarget{};
-
-        const D3D11_TEXTURE2D_DESC textureDesc = {
-            .Width = width,
-            .Height = height,
-            .MipLevels = 1u,
-            .ArraySize = 1u,
-            .Format = format,
-            .SampleDesc = {1u, 0u},
-            .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE,
-            .CPUAccessFlags = 0u,
-        };
-
-        throwIfFailed(m_device->CreateTexture2D(&textureDesc, nullptr, &renderTarget.texture));
+        const BackendRenderTargetHandles handles = m_renderBackend->createRenderTarget(BackendRenderTargetDesc{
+            .width = width,
+            .height = height,
+            .format = format,
+        });
 
-        const D3D11_RENDER_TARGET_VIEW_DESC rtvDesc = {
-            .Format = format,
-            .ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D,
-            .Texture2D =
-                {
-                    .MipSlice = 0u,
-                },
+        return RenderTarget{
+            .renderTarget = BackendResource(*m_renderBackend, handles.renderTarget),
+            .texture = BackendResource(*m_renderBackend, handles.texture),
         };
-
-        throwIfFailed(m_device->CreateRenderTargetView(renderTarget.texture.Get(), &rtvDesc, &renderTarget.rtv));
-
-        const D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
-            .Format = format,
-            .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
-            .Texture2D =
-                {
-                    .MostDetailedMip = 0u,
-                    .MipLevels = 1u,
-                },
-        };
-
-        throwIfFailed(m_device->CreateShaderResourceView(renderTarget.texture.Get(), &srvDesc, &renderTarget.srv));
-
-        return renderTarget;
     }
 
-    Model Application::createModel(const std::string_view modelPath, const sgfx::TransformComponent& transformData)
+    Model Application::createModel(const std::string_view modelPath, const sgfx::TransformComponent& transformData, const ModelLoadOptions& loadOptions)
     {
-        Model model(m_device.Get(), m_fallbackTexture.Get(), modelPath, transformData);
+        Model model(*m_renderBackend, *m_geometryPool, *m_textureCache, m_fallbackTexture, m_jobSystem, modelPath, transformData, loadOptions);
         return model;
     }
 
-    DepthTexture Application::createDepthTexture()
-    {
-        DepthTexture depthTexture{};
-
-        comptr<ID3D11Texture2D> depthBuffer{};
-
-        const D3D11_TEXTURE2D_DESC depthStencilBufferDesc = {
-            .Width = m_windowWidth,
-            .Height = m_windowHeight,
-            .MipLevels = 1u,
-            .ArraySize = 1u,
-            .Format = DXGI_FORMAT_R32_TYPELESS,
-            .SampleDesc = {1u, 0u},
-            .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE,
-        };
-
-        const D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {
-            .Format = DXGI_FORMAT_D32_FLOAT,
-            .ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D,
-            .Texture2D =
-                {
-                    .MipSlice = 0u,
-                },
-        };
-
-        throwIfFailed(m_device->CreateTexture2D(&depthStencilBufferDesc, nullptr, &depthBuffer));
-        throwIfFailed(m_device->CreateDepthStencilView(depthBuffer.Get(), &dsvDesc, &depthTexture.dsv));
-
-        const D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
-            .Format = DXGI_FORMAT_R32_FLOAT,
-            .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
-            .Texture2D =
-                {
-                    .MostDetailedMip = 0u,
-                    .MipLevels = 1u,
-                },
-        };
-
-        throwIfFailed(m_device->CreateShaderResourceView(depthBuffer.Get(), &srvDesc, &depthTexture.srv));
-
-        return depthTexture;
-    }
+    RenderTarget Application::createDepthTexture() { return createRenderTarget(m_windowWidth, m_windowHeight, TextureFormat::D32Float); }
 }
@@ -0,0 +1,180 @@
+#include "Pch.hpp"
+
+#include "Application.hpp"
+
+#include "D3D11RenderBackend.hpp"
+
+#include <imgui.h>
+#include <imgui_impl_sdl.h>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_syswm.h>
+
+// The windowed path of Application, Windows only : the window and its input (SDL2), the user interface (Dear ImGui) and the D3D11 backend.
+
+namespace sgfx
+{
+    namespace
+    {
+        constexpr std::string_view LOADING_TRACE_PATH = "loading_trace.json";
+    }
+
+    void Application::run()
+    {
+        try
+        {
+#ifdef SGFX_PROFILER
+            // Loading happens before the first frame, so it is only shown by this trace.
+            getProfiler().beginCapture();
+#endif
+
+            init();
+
+            {
+                SGFX_PROFILE_ZONE("Load content");
+                loadContent();
+            }
+
+#ifdef SGFX_PROFILER
+            if (getProfiler().endCapture(LOADING_TRACE_PATH))
+            {
+                std::cout << "Loading trace written to " << LOADING_TRACE_PATH << ".\n";
+            }
+#endif
+
+            std::chrono::high_resolution_clock clock{};
+            std::chrono::high_resolution_clock::time_point previousFrameTime{};
+
+            bool quit = false;
+            while (!quit)
+            {
+                SGFX_PROFILE_END_FRAME();
+                SGFX_PROFILE_ZONE("Frame");
+
+                SDL_Event event{};
+                while (SDL_PollEvent(&event))
+                {
+                    ImGui_ImplSDL2_ProcessEvent(&event);
+
+                    if (event.type == SDL_QUIT)
+                    {
+                        quit = true;
+                    }
+
+                    const uint8_t* keyboardState = SDL_GetKeyboardState(nullptr);
+                    if (keyboardState[SDL_SCANCODE_ESCAPE])
+                    {
+                        quit = true;
+                    }
+
+                    m_camera.handleInput(Keys::W, keyboardState[SDL_SCANCODE_W]);
+                    m_camera.handleInput(Keys::A, keyboardState[SDL_SCANCODE_A]);
+                    m_camera.handleInput(Keys::S, keyboardState[SDL_SCANCODE_S]);
+                    m_camera.handleInput(Keys::D, keyboardState[SDL_SCANCODE_D]);
+
+                    m_camera.handleInput(Keys::AUp, keyboardState[SDL_SCANCODE_UP]);
+                    m_camera.handleInput(Keys::ALeft, keyboardState[SDL_SCANCODE_LEFT]);
+                    m_camera.handleInput(Keys::ADown, keyboardState[SDL_SCANCODE_DOWN]);
+                    m_camera.handleInput(Keys::ARight, keyboardState[SDL_SCANCODE_RIGHT]);
+                }
+
+                const auto currentFrameTime = clock.now();
+                const float deltaTime = static_cast<float>((currentFrameTime - previousFrameTime).count() * 1e-9);
+                previousFrameTime = currentFrameTime;
+
+                // Geometry of the models loaded since the previous frame.
+                m_geometryPool->flushUploads();
+
+                update(deltaTime);
+                render();
+            }
+        }
+        catch (const std::exception& exception)
+        {
+            std::cerr << exception.what() << "\n";
+            return;
+        }
+    }
+
+    void Application::initWindow()
+    {
+        // Set DPI awareness on Windows
+        SDL_SetHint(SDL_HINT_WINDOWS_DPI_AWARENESS, "permonitorv2");
+        SDL_SetHint(SDL_HINT_WINDOWS_DPI_SCALING, "1");
+
+        // Initialize SDL2 and create window.
+        if (SDL_Init(SDL_INIT_EVERYTHING) < 0)
+        {
+            fatalError("Failed to initialize SDL2.");
+        }
+
+        // Get monitor dimensions.
+        SDL_DisplayMode displayMode{};
+        if (SDL_GetCurrentDisplayMode(0, &displayMode) < 0)
+        {
+            fatalError("Failed to get display mode.");
+        }
+
+        const uint32_t monitorWidth = displayMode.w;
+        const uint32_t monitorHeight = displayMode.h;
+
+        // Window must cover 100% of the screen.
+        m_windowWidth = static_cast<uint32_t>(monitorWidth * 1.00f);
+        m_windowHeight = static_cast<uint32_t>(monitorHeight * 1.00f);
+
+        m_window = SDL_CreateWindow("SimpleGfx", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, m_windowWidth, m_windowHeight, SDL_WINDOW_ALLOW_HIGHDPI);
+
+        if (!m_window)
+        {
+            fatalError("Failed to create SDL2 window.");
+        }
+
+        // Init Imgui, before the backend initializes its renderer.
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+
+        ImGui::StyleColorsDark();
+        ImGui_ImplSDL2_InitForD3D(m_window);
+
+        SDL_SysWMinfo wmInfo{};
+        SDL_VERSION(&wmInfo.version);
+
+        SDL_GetWindowWMInfo(m_window, &wmInfo);
+
+        // Initialize graphics back end.
+        m_shaderCache = std::make_unique<ShaderCache>("shaders/cache", compileD3D11Shader);
+
+        m_renderBackend = std::make_unique<D3D11RenderBackend>(
+            D3D11RenderBackendCreationDesc{
+                .windowHandle = wmInfo.info.win.window,
+                .width = m_windowWidth,
+                .height = m_windowHeight,
+            },
+            *m_shaderCache,
+            m_jobSystem);
+    }
+
+    void Application::cleanupWindow()
+    {
+        ImGui_ImplSDL2_Shutdown();
+        ImGui::DestroyContext();
+
+        SDL_DestroyWindow(m_window);
+        m_window = nullptr;
+
+        SDL_Quit();
+    }
+
+    void Application::beginUserInterfaceFrame()
+    {
+        m_renderBackend->beginUserInterfaceFrame();
+        ImGui_ImplSDL2_NewFrame();
+        ImGui::NewFrame();
+    }
+
+    void Application::renderUserInterface()
+    {
+        ImGui::Render();
+        m_renderBackend->renderUserInterface();
+    }
+}
@@ -0,0 +1,893 @@
+#include "Pch.hpp"
+
+#include "BlockCompression.hpp"
+
+#include <immintrin.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        static constexpr uint32_t REFINEMENT_ITERATION_COUNT = 2u;
+        static constexpr uint32_t POWER_ITERATION_COUNT = 8u;
+
+        // BC7 4 bit index interpolation weights (out of 64).
+        static constexpr std::array<uint32_t, 16u> BC7_WEIGHTS = {0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u};
+        static constexpr uint32_t BC7_MODE_6 = 1u << 6u;
+
+        // Block pixels as floats in [0, 255], one array of 16 values per channel so 4 pixels are processed per SSE operation.
+        struct BlockChannels
+        {
+            alignas(16) std::array<std::array<float, BLOCK_PIXEL_COUNT>, 4u> values{};
+        };
+
+        using Color = std::array<float, 4u>;
+        using BlockIndices = std::array<uint8_t, BLOCK_PIXEL_COUNT>;
+
+        struct Palette
+        {
+            std::array<Color, 16u> colors{};
+            uint32_t size{};
+        };
+
+        // Little endian bit stream over a 64 or 128 bit block.
+        struct BlockBits
+        {
+            std::array<uint64_t, 2u> words{};
+            uint32_t offset{};
+
+            void write(const uint32_t value, const uint32_t bitCount)
+            {
+                for (const uint32_t bit : std::views::iota(0u, bitCount))
+                {
+                    words[offset / 64u] |= static_cast<uint64_t>((value >> bit) & 1u) << (offset % 64u);
+                    offset++;
+                }
+            }
+
+            uint32_t read(const uint32_t bitCount)
+            {
+                uint32_t value = 0u;
+                for (const uint32_t bit : std::views::iota(0u, bitCount))
+                {
+                    value |= static_cast<uint32_t>((words[offset / 64u] >> (offset % 64u)) & 1u) << bit;
+                    offset++;
+                }
+
+                return value;
+            }
+        };
+
+        BlockChannels loadChannels(const BlockPixels& pixels)
+        {
+            BlockChannels block{};
+            for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+            {
+                for (const uint32_t channel : std::views::iota(0u, 4u))
+                {
+                    block.values[channel][pixel] = static_cast<float>(pixels[pixel * 4u + channel]);
+                }
+            }
+
+            return block;
+        }
+
+        uint8_t quantizeUnorm8(const float value) { return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 255.0f))); }
+
+        // Picks the nearest palette entry of every pixel over channels [firstChannel, firstChannel + channelCount), returns the total squared error.
+        float selectIndices(const BlockChannels& block, const uint32_t firstChannel, const uint32_t channelCount, const Palette& palette, BlockIndices& indices)
+        {
+            float error = 0.0f;
+
+            for (const uint32_t group : std::views::iota(0u, BLOCK_PIXEL_COUNT / 4u))
+            {
+                __m128 bestDistance = _mm_set1_ps(std::numeric_limits<float>::max());
+                __m128i bestIndex = _mm_setzero_si128();
+
+                for (const uint32_t entry : std::views::iota(0u, palette.size))
+                {
+                    __m128 distance = _mm_setzero_ps();
+                    for (const uint32_t channel : std::views::iota(firstChannel, firstChannel + channelCount))
+                    {
+                        const __m128 difference = _mm_sub_ps(_mm_load_ps(&block.values[channel][group * 4u]), _mm_set1_ps(palette.colors[entry][channel]));
+                        distance = _mm_add_ps(distance, _mm_mul_ps(difference, difference));
+                    }
+
+                    // SSE2 select : entries only replace the current best when strictly closer, so ties keep the lowest index.
+                    const __m128i isCloser = _mm_castps_si128(_mm_cmplt_ps(distance, bestDistance));
+                    bestIndex = _mm_or_si128(_mm_and_si128(isCloser, _mm_set1_epi32(static_cast<int32_t>(entry))), _mm_andnot_si128(isCloser, bestIndex));
+                    bestDistance = _mm_min_ps(distance, bestDistance);
+                }
+
+                alignas(16) std::array<int32_t, 4u> groupIndices{};
+                alignas(16) std::array<float, 4u> groupDistances{};
+                _mm_store_si128(reinterpret_cast<__m128i*>(groupIndices.data()), bestIndex);
+                _mm_store_ps(groupDistances.data(), bestDistance);
+
+                for (const uint32_t i : std::views::iota(0u, 4u))
+                {
+                    indices[group * 4u + i] = static_cast<uint8_t>(groupIndices[i]);
+                    error += groupDistances[i];
+                }
+            }
+
+            return error;
+        }
+
+        // Segment along the principal axis of the block's colors that covers all of them.
+        void computeAxisEndpoints(const BlockChannels& block, const uint32_t firstChannel, const uint32_t channelCount, Color& start, Color& end)
+        {
+            const uint32_t lastChannel = firstChannel + channelCount;
+
+            Color mean{};
+            for (const uint32_t channel : std::views::iota(firstChannel, lastChannel))
+            {
+                mean[channel] = std::accumulate(block.values[channel].begin(), block.values[channel].end(), 0.0f) / static_cast<float>(BLOCK_PIXEL_COUNT);
+            }
+
+            std::array<Color, 4u> covariance{};
+            for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+            {
+                for (const uint32_t row : std::views::iota(firstChannel, lastChannel))
+                {
+                    for (const uint32_t column : std::views::iota(firstChannel, lastChannel))
+                    {
+                        covariance[row][column] += (block.values[row][pixel] - mean[row]) * (block.values[column][pixel] - mean[column]);
+                    }
+                }
+            }
+
+            // Power iteration, starting from the covariance column of the channel with the largest variance (which is never orthogonal to the principal axis).
+            uint32_t widestChannel = firstChannel;
+            for (const uint32_t channel : std::views::iota(firstChannel, lastChannel))
+            {
+                widestChannel = covariance[channel][channel] > covariance[widestChannel][widestChannel] ? channel : widestChannel;
+            }
+
+            Color axis{};
+            for (const uint32_t channel : std::views::iota(firstChannel, lastChannel))
+            {
+                axis[channel] = covariance[channel][widestChannel];
+            }
+
+            for (const uint32_t iteration : std::views::iota(0u, POWER_ITERATION_COUNT))
+            {
+                static_cast<void>(iteration);
+
+                Color nextAxis{};
+                float lengthSquared = 0.0f;
+                for (const uint32_t row : std::views::iota(firstChannel, lastChannel))
+                {
+                    for (const uint32_t column : std::views::iota(firstChannel, lastChannel))
+                    {
+                        nextAxis[row] += covariance[row][column] * axis[column];
+                    }
+
+                    lengthSquared += nextAxis[row] * nextAxis[row];
+                }
+
+                if (lengthSquared < std::numeric_limits<float>::min())
+                {
+                    break;
+                }
+
+                const float inverseLength = 1.0f / std::sqrt(lengthSquared);
+                for (const uint32_t channel : std::views::iota(firstChannel, lastChannel))
+                {
+                    axis[channel] = nextAxis[channel] * inverseLength;
+                }
+            }
+
+            float minimumProjection = std::numeric_limits<float>::max();
+            float maximumProjection = std::numeric_limits<float>::lowest();
+            for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+            {
+                float projection = 0.0f;
+                for (const uint32_t channel : std::views::iota(firstChannel, lastChannel))
+                {
+                    projection += (block.values[channel][pixel] - mean[channel]) * axis[channel];
+                }
+
+                minimumProjection = std::min(minimumProjection, projection);
+                maximumProjection = std::max(maximumProjection, projection);
+            }
+
+            // Flat blocks have a zero axis, both endpoints are then the mean.
+            for (const uint32_t channel : std::views::iota(firstChannel, lastChannel))
+            {
+                start[channel] = mean[channel] + axis[channel] * minimumProjection;
+                end[channel] = mean[channel] + axis[channel] * maximumProjection;
+            }
+        }
+
+        // Least squares endpoints for the selected indices, where every pixel is reconstructed as lerp(start, end, weights[index]).
+        // Returns false when all pixels use the same weight (the system is singular).
+        bool refineEndpoints(const BlockChannels& block,
+                             const uint32_t firstChannel,
+                             const uint32_t channelCount,
+                             const BlockIndices& indices,
+                             std::span<const float> weights,
+                             Color& start,
+                             Color& end)
+        {
+            float startStart = 0.0f;
+            float startEnd = 0.0f;
+            float endEnd = 0.0f;
+            Color startColor{};
+            Color endColor{};
+
+            for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+            {
+                const float endWeight = weights[indices[pixel]];
+                const float startWeight = 1.0f - endWeight;
+
+                startStart += startWeight * startWeight;
+                startEnd += startWeight * endWeight;
+                endEnd += endWeight * endWeight;
+
+                for (const uint32_t channel : std::views::iota(firstChannel, firstChannel + channelCount))
+                {
+                    startColor[channel] += startWeight * block.values[channel][pixel];
+                    endColor[channel] += endWeight * block.values[channel][pixel];
+                }
+            }
+
+            const float determinant = startStart * endEnd - startEnd * startEnd;
+            if (std::abs(determinant) < 1e-6f)
+            {
+                return false;
+            }
+
+            const float inverseDeterminant = 1.0f / determinant;
+            for (const uint32_t channel : std::views::iota(firstChannel, firstChannel + channelCount))
+            {
+                start[channel] = (endEnd * startColor[channel] - startEnd * endColor[channel]) * inverseDeterminant;
+                end[channel] = (startStart * endColor[channel] - startEnd * startColor[channel]) * inverseDeterminant;
+            }
+
+            return true;
+        }
+
+        // BC1 color block.
+
+        static constexpr std::array<float, 4u> BC1_WEIGHTS = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+        uint16_t quantizeRgb565(const Color& color)
+        {
+            const auto quantize = [](const float value, const float maximum) { return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 255.0f) * maximum / 255.0f)); };
+
+            return static_cast<uint16_t>((quantize(color[0], 31.0f) << 11u) | (quantize(color[1], 63.0f) << 5u) | quantize(color[2], 31.0f));
+        }
+
+        std::array<uint32_t, 3u> expandRgb565(const uint16_t color)
+        {
+            const uint32_t red = (color >> 11u) & 0x1fu;
+            const uint32_t green = (color >> 5u) & 0x3fu;
+            const uint32_t blue = color & 0x1fu;
+
+            return {(red << 3u) | (red >> 2u), (green << 2u) | (green >> 4u), (blue << 3u) | (blue >> 2u)};
+        }
+
+        Palette getColorPalette(const uint16_t color0, const uint16_t color1)
+        {
+            const std::array<uint32_t, 3u> endpoint0 = expandRgb565(color0);
+            const std::array<uint32_t, 3u> endpoint1 = expandRgb565(color1);
+
+            Palette palette{.size = 4u};
+            for (const uint32_t channel : std::views::iota(0u, 3u))
+            {
+                palette.colors[0][channel] = static_cast<float>(endpoint0[channel]);
+                palette.colors[1][channel] = static_cast<float>(endpoint1[channel]);
+
+                if (color0 > color1)
+                {
+                    palette.colors[2][channel] = static_cast<float>((2u * endpoint0[channel] + endpoint1[channel]) / 3u);
+                    palette.colors[3][channel] = static_cast<float>((endpoint0[channel] + 2u * endpoint1[channel]) / 3u);
+                }
+                else
+                {
+                    palette.colors[2][channel] = static_cast<float>((endpoint0[channel] + endpoint1[channel]) / 2u);
+                    palette.colors[3][channel] = 0.0f;
+                }
+            }
+
+            return palette;
+        }
+
+        void writeColorBlock(const uint16_t color0, const uint16_t color1, const BlockIndices& indices, std::byte* const outBlock)
+        {
+            BlockBits bits{};
+            bits.write(color0, 16u);
+            bits.write(color1, 16u);
+            for (const uint8_t index : indices)
+            {
+                bits.write(index, 2u);
+            }
+
+            std::memcpy(outBlock, bits.words.data(), 8u);
+        }
+
+        // Quantized endpoint pairs whose 2/3 interpolant is closest to each 8 bit value, for blocks of a single color (which a line fit can only
+        // round to the nearest 565 color).
+        struct SingleColorEndpoints
+        {
+            uint8_t endpoint0{};
+            uint8_t endpoint1{};
+        };
+
+        std::array<SingleColorEndpoints, 256u> computeSingleColorTable(const uint32_t bitCount)
+        {
+            const uint32_t maximum = (1u << bitCount) - 1u;
+            const auto expand = [&](const uint32_t value) { return (value << (8u - bitCount)) | (value >> (2u * bitCount - 8u)); };
+
+            std::array<SingleColorEndpoints, 256u> table{};
+            for (const uint32_t value : std::views::iota(0u, 256u))
+            {
+                uint32_t bestError = std::numeric_limits<uint32_t>::max();
+                for (const uint32_t endpoint0 : std::views::iota(0u, maximum + 1u))
+                {
+                    for (const uint32_t endpoint1 : std::views::iota(0u, maximum + 1u))
+                    {
+                        const uint32_t interpolant = (2u * expand(endpoint0) + expand(endpoint1)) / 3u;
+                        const uint32_t error = interpolant > value ? interpolant - value : value - interpolant;
+                        if (error < bestError)
+                        {
+                            table[value] = SingleColorEndpoints{static_cast<uint8_t>(endpoint0), static_cast<uint8_t>(endpoint1)};
+                            bestError = error;
+                        }
+                    }
+                }
+            }
+
+            return table;
+        }
+
+        bool isSingleColorBlock(const BlockChannels& block)
+        {
+            for (const uint32_t channel : std::views::iota(0u, 3u))
+            {
+                const auto [minimum, maximum] = std::ranges::minmax_element(block.values[channel]);
+                if (*minimum != *maximum)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void encodeSingleColorBlock(const BlockChannels& block, std::byte* const outBlock)
+        {
+            static const std::array<SingleColorEndpoints, 256u> table5 = computeSingleColorTable(5u);
+            static const std::array<SingleColorEndpoints, 256u> table6 = computeSingleColorTable(6u);
+
+            const SingleColorEndpoints& red = table5[static_cast<uint32_t>(block.values[0][0])];
+            const SingleColorEndpoints& green = table6[static_cast<uint32_t>(block.values[1][0])];
+            const SingleColorEndpoints& blue = table5[static_cast<uint32_t>(block.values[2][0])];
+
+            const uint16_t color0 = static_cast<uint16_t>((red.endpoint0 << 11u) | (green.endpoint0 << 5u) | blue.endpoint0);
+            const uint16_t color1 = static_cast<uint16_t>((red.endpoint1 << 11u) | (green.endpoint1 << 5u) | blue.endpoint1);
+
+            // Index 2 is the 2/3 interpolant in 4 color mode, which requires color0 > color1 (index 3 once swapped).
+            BlockIndices indices{};
+            if (color0 == color1)
+            {
+                writeColorBlock(color0, color1, indices, outBlock);
+            }
+            else
+            {
+                indices.fill(color0 > color1 ? 2u : 3u);
+                writeColorBlock(std::max(color0, color1), std::min(color0, color1), indices, outBlock);
+            }
+        }
+
+        // Always uses the 4 color mode, which is the only one BC3 supports.
+        void encodeColorBlock(const BlockChannels& block, std::byte* const outBlock)
+        {
+            if (isSingleColorBlock(block))
+            {
+                encodeSingleColorBlock(block, outBlock);
+                return;
+            }
+
+            Color start{};
+            Color end{};
+            computeAxisEndpoints(block, 0u, 3u, start, end);
+
+            // Palette entries are computed as if color0 > color1, the order is fixed up when writing the block.
+            const auto evaluate = [&](const uint16_t color0, const uint16_t color1, BlockIndices& indices) {
+                return selectIndices(block, 0u, 3u, getColorPalette(std::max(color0, color1), std::min(color0, color1)), indices);
+            };
+
+            uint16_t bestColor0 = quantizeRgb565(end);
+            uint16_t bestColor1 = quantizeRgb565(start);
+            if (bestColor0 < bestColor1)
+            {
+                std::swap(bestColor0, bestColor1);
+            }
+
+            BlockIndices bestIndices{};
+            float bestError = evaluate(bestColor0, bestColor1, bestIndices);
+
+            for (const uint32_t iteration : std::views::iota(0u, REFINEMENT_ITERATION_COUNT))
+            {
+                static_cast<void>(iteration);
+
+                // Weights are relative to color0 (index 0) and color1 (index 1).
+                if (bestError == 0.0f || !refineEndpoints(block, 0u, 3u, bestIndices, BC1_WEIGHTS, start, end))
+                {
+                    break;
+                }
+
+                uint16_t color0 = quantizeRgb565(start);
+                uint16_t color1 = quantizeRgb565(end);
+                if (color0 < color1)
+                {
+                    std::swap(color0, color1);
+                }
+
+                BlockIndices indices{};
+                const float error = evaluate(color0, color1, indices);
+                if (error >= bestError)
+                {
+                    break;
+                }
+
+                bestColor0 = color0;
+                bestColor1 = color1;
+                bestIndices = indices;
+                bestError = error;
+            }
+
+            // Equal endpoints select the 3 color mode, where index 0 still decodes to color0.
+            if (bestColor0 == bestColor1)
+            {
+                bestIndices.fill(0u);
+            }
+
+            writeColorBlock(bestColor0, bestColor1, bestIndices, outBlock);
+        }
+
+        void decodeColorBlock(const std::byte* const block, BlockPixels& outPixels)
+        {
+            BlockBits bits{};
+            std::memcpy(bits.words.data(), block, 8u);
+
+            const uint16_t color0 = static_cast<uint16_t>(bits.read(16u));
+            const uint16_t color1 = static_cast<uint16_t>(bits.read(16u));
+            const Palette palette = getColorPalette(color0, color1);
+
+            for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+            {
+                const Color& color = palette.colors[bits.read(2u)];
+                for (const uint32_t channel : std::views::iota(0u, 3u))
+                {
+                    outPixels[pixel * 4u + channel] = static_cast<uint8_t>(color[channel]);
+                }
+            }
+        }
+
+        // BC4 single channel block.
+
+        static constexpr std::array<float, 8u> BC4_WEIGHTS = {0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f};
+
+        Palette getChannelPalette(const uint32_t channel, const uint32_t value0, const uint32_t value1)
+        {
+            Palette palette{.size = 8u};
+            palette.colors[0][channel] = static_cast<float>(value0);
+            palette.colors[1][channel] = static_cast<float>(value1);
+
+            if (value0 > value1)
+            {
+                for (const uint32_t index : std::views::iota(2u, 8u))
+                {
+                    palette.colors[index][channel] = static_cast<float>(((8u - index) * value0 + (index - 1u) * value1) / 7u);
+                }
+            }
+            else
+            {
+                for (const uint32_t index : std::views::iota(2u, 6u))
+                {
+                    palette.colors[index][channel] = static_cast<float>(((6u - index) * value0 + (index - 1u) * value1) / 5u);
+                }
+
+                palette.colors[6][channel] = 0.0f;
+                palette.colors[7][channel] = 255.0f;
+            }
+
+            return palette;
+        }
+
+        // Always uses the 8 value mode (value0 > value1).
+        void encodeChannelBlock(const BlockChannels& block, const uint32_t channel, std::byte* const outBlock)
+        {
+            const auto [minimum, maximum] = std::ranges::minmax_element(block.values[channel]);
+
+            uint8_t bestValue0 = quantizeUnorm8(*maximum);
+            uint8_t bestValue1 = quantizeUnorm8(*minimum);
+
+            BlockIndices bestIndices{};
+            if (bestValue0 != bestValue1)
+            {
+                float bestError = selectIndices(block, channel, 1u, getChannelPalette(channel, bestValue0, bestValue1), bestIndices);
+
+                for (const uint32_t iteration : std::views::iota(0u, REFINEMENT_ITERATION_COUNT))
+                {
+                    static_cast<void>(iteration);
+
+                    Color start{};
+                    Color end{};
+                    if (bestError == 0.0f || !refineEndpoints(block, channel, 1u, bestIndices, BC4_WEIGHTS, start, end))
+                    {
+                        break;
+                    }
+
+                    const uint8_t value0 = quantizeUnorm8(start[channel]);
+                    const uint8_t value1 = quantizeUnorm8(end[channel]);
+                    if (value0 <= value1)
+                    {
+                        break;
+                    }
+
+                    BlockIndices indices{};
+                    const float error = selectIndices(block, channel, 1u, getChannelPalette(channel, value0, value1), indices);
+                    if (error >= bestError)
+                    {
+                        break;
+                    }
+
+                    bestValue0 = value0;
+                    bestValue1 = value1;
+                    bestIndices = indices;
+                    bestError = error;
+                }
+            }
+
+            BlockBits bits{};
+            bits.write(bestValue0, 8u);
+            bits.write(bestValue1, 8u);
+            for (const uint8_t index : bestIndices)
+            {
+                bits.write(index, 3u);
+            }
+
+            std::memcpy(outBlock, bits.words.data(), 8u);
+        }
+
+        void decodeChannelBlock(const std::byte* const block, const uint32_t channel, BlockPixels& outPixels)
+        {
+            BlockBits bits{};
+            std::memcpy(bits.words.data(), block, 8u);
+
+            const uint32_t value0 = bits.read(8u);
+            const uint32_t value1 = bits.read(8u);
+            const Palette palette = getChannelPalette(channel, value0, value1);
+
+            for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+            {
+                outPixels[pixel * 4u + channel] = static_cast<uint8_t>(palette.colors[bits.read(3u)][channel]);
+            }
+        }
+
+        // BC7 mode 6 block.
+
+        using Bc7Endpoint = std::array<uint32_t, 4u>;
+
+        // 7 bits per channel plus a p-bit shared by the channels of the endpoint.
+        Bc7Endpoint quantizeBc7Endpoint(const Color& color, const uint32_t pBit)
+        {
+            Bc7Endpoint endpoint{};
+            for (const uint32_t channel : std::views::iota(0u, 4u))
+            {
+                const float value = (std::clamp(color[channel], 0.0f, 255.0f) - static_cast<float>(pBit)) * 0.5f;
+                endpoint[channel] = (static_cast<uint32_t>(std::clamp(std::lround(value), 0l, 127l)) << 1u) | pBit;
+            }
+
+            return endpoint;
+        }
+
+        Palette getBc7Palette(const Bc7Endpoint& endpoint0, const Bc7Endpoint& endpoint1)
+        {
+            Palette palette{.size = 16u};
+            for (const uint32_t index : std::views::iota(0u, 16u))
+            {
+                for (const uint32_t channel : std::views::iota(0u, 4u))
+                {
+                    const uint32_t weight = BC7_WEIGHTS[index];
+                    palette.colors[index][channel] = static_cast<float>(((64u - weight) * endpoint0[channel] + weight * endpoint1[channel] + 32u) >> 6u);
+                }
+            }
+
+            return palette;
+        }
+
+        void encodeBc7Block(const BlockChannels& block, std::byte* const outBlock)
+        {
+            static constexpr std::array<float, 16u> weights = [] {
+                std::array<float, 16u> result{};
+                for (const uint32_t index : std::views::iota(0u, 16u))
+                {
+                    result[index] = static_cast<float>(BC7_WEIGHTS[index]) / 64.0f;
+                }
+
+                return result;
+            }();
+
+            Bc7Endpoint bestEndpoint0{};
+            Bc7Endpoint bestEndpoint1{};
+            BlockIndices bestIndices{};
+            float bestError = std::numeric_limits<float>::max();
+
+            // Tries every p-bit combination for the given unquantized endpoints, returns true if the block improved.
+            const auto tryEndpoints = [&](const Color& start, const Color& end) {
+                bool hasImproved = false;
+                for (const uint32_t pBits : std::views::iota(0u, 4u))
+                {
+                    const Bc7Endpoint endpoint0 = quantizeBc7Endpoint(start, pBits & 1u);
+                    const Bc7Endpoint endpoint1 = quantizeBc7Endpoint(end, pBits >> 1u);
+
+                    BlockIndices indices{};
+                    const float error = selectIndices(block, 0u, 4u, getBc7Palette(endpoint0, endpoint1), indices);
+                    if (error < bestError)
+                    {
+                        bestEndpoint0 = endpoint0;
+                        bestEndpoint1 = endpoint1;
+                        bestIndices = indices;
+                        bestError = error;
+                        hasImproved = true;
+                    }
+                }
+
+                return hasImproved;
+            };
+
+            Color start{};
+            Color end{};
+            computeAxisEndpoints(block, 0u, 4u, start, end);
+            tryEndpoints(start, end);
+
+            for (const uint32_t iteration : std::views::iota(0u, REFINEMENT_ITERATION_COUNT))
+            {
+                static_cast<void>(iteration);
+
+                if (bestError == 0.0f || !refineEndpoints(block, 0u, 4u, bestIndices, weights, start, end) || !tryEndpoints(start, end))
+                {
+                    break;
+                }
+            }
+
+            // The most significant bit of the first (anchor) index is implicitly 0.
+            if (bestIndices[0] >= 8u)
+            {
+                std::swap(bestEndpoint0, bestEndpoint1);
+                for (uint8_t& index : bestIndices)
+                {
+                    index = static_cast<uint8_t>(15u - index);
+                }
+            }
+
+            BlockBits bits{};
+            bits.write(BC7_MODE_6, 7u);
+            for (const uint32_t channel : std::views::iota(0u, 4u))
+            {
+                bits.write(bestEndpoint0[channel] >> 1u, 7u);
+                bits.write(bestEndpoint1[channel] >> 1u, 7u);
+            }
+
+            bits.write(bestEndpoint0[0] & 1u, 1u);
+            bits.write(bestEndpoint1[0] & 1u, 1u);
+
+            for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+            {
+                bits.write(bestIndices[pixel], pixel == 0u ? 3u : 4u);
+            }
+
+            std::memcpy(outBlock, bits.words.data(), 16u);
+        }
+
+        // Only decodes mode 6, the single mode the encoder produces. Blocks of other modes decode as opaque magenta.
+        void decodeBc7Block(const std::byte* const block, BlockPixels& outPixels)
+        {
+            BlockBits bits{};
+            std::memcpy(bits.words.data(), block, 16u);
+
+            if (bits.read(7u) != BC7_MODE_6)
+            {
+                for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+                {
+                    std::ranges::copy(std::array<uint8_t, 4u>{255u, 0u, 255u, 255u}, outPixels.begin() + pixel * 4u);
+                }
+
+                return;
+            }
+
+            Bc7Endpoint endpoint0{};
+            Bc7Endpoint endpoint1{};
+            for (const uint32_t channel : std::views::iota(0u, 4u))
+            {
+                endpoint0[channel] = bits.read(7u) << 1u;
+                endpoint1[channel] = bits.read(7u) << 1u;
+            }
+
+            const uint32_t pBit0 = bits.read(1u);
+            const uint32_t pBit1 = bits.read(1u);
+            for (const uint32_t channel : std::views::iota(0u, 4u))
+            {
+                endpoint0[channel] |= pBit0;
+                endpoint1[channel] |= pBit1;
+            }
+
+            const Palette palette = getBc7Palette(endpoint0, endpoint1);
+            for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+            {
+                const Color& color = palette.colors[bits.read(pixel == 0u ? 3u : 4u)];
+                for (const uint32_t channel : std::views::iota(0u, 4u))
+                {
+                    outPixels[pixel * 4u + channel] = static_cast<uint8_t>(color[channel]);
+                }
+            }
+        }
+    }
+
+    void compressBlock(const BlockFormat format, const BlockPixels& pixels, std::byte* const outBlock)
+    {
+        const BlockChannels block = loadChannels(pixels);
+
+        switch (format)
+        {
+            case BlockFormat::BC1:
+            {
+                encodeColorBlock(block, outBlock);
+            }
+            break;
+
+            case BlockFormat::BC3:
+            {
+                encodeChannelBlock(block, 3u, outBlock);
+                encodeColorBlock(block, outBlock + 8u);
+            }
+            break;
+
+            case BlockFormat::BC4:
+            {
+                encodeChannelBlock(block, 0u, outBlock);
+            }
+            break;
+
+            case BlockFormat::BC5:
+            {
+                encodeChannelBlock(block, 0u, outBlock);
+                encodeChannelBlock(block, 1u, outBlock + 8u);
+            }
+            break;
+
+            case BlockFormat::BC7:
+            {
+                encodeBc7Block(block, outBlock);
+            }
+            break;
+        }
+    }
+
+    void decompressBlock(const BlockFormat format, const std::byte* const block, BlockPixels& outPixels)
+    {
+        for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+        {
+            std::ranges::copy(std::array<uint8_t, 4u>{0u, 0u, 0u, 255u}, outPixels.begin() + pixel * 4u);
+        }
+
+        switch (format)
+        {
+            case BlockFormat::BC1:
+            {
+                decodeColorBlock(block, outPixels);
+            }
+            break;
+
+            case BlockFormat::BC3:
+            {
+                decodeChannelBlock(block, 3u, outPixels);
+                decodeColorBlock(block + 8u, outPixels);
+            }
+            break;
+
+            case BlockFormat::BC4:
+            {
+                decodeChannelBlock(block, 0u, outPixels);
+            }
+            break;
+
+            case BlockFormat::BC5:
+            {
+                decodeChannelBlock(block, 0u, outPixels);
+                decodeChannelBlock(block + 8u, 1u, outPixels);
+            }
+            break;
+
+            case BlockFormat::BC7:
+            {
+                decodeBc7Block(block, outPixels);
+            }
+            break;
+        }
+    }
+
+    void compressBlockRows(const BlockFormat format,
+                           std::span<const uint8_t> pixels,
+                           const uint32_t width,
+                           const uint32_t height,
+                           const uint32_t firstBlockRow,
+                           const uint32_t blockRowCount,
+                           std::span<std::byte> outBlocks)
+    {
+        const uint32_t blockColumnCount = (width + BLOCK_WIDTH - 1u) / BLOCK_WIDTH;
+        const uint32_t blockSize = getBlockSize(format);
+
+        for (const uint32_t blockRow : std::views::iota(firstBlockRow, firstBlockRow + blockRowCount))
+        {
+            for (const uint32_t blockColumn : std::views::iota(0u, blockColumnCount))
+            {
+                BlockPixels blockPixels{};
+                for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+                {
+                    const uint32_t x = std::min(blockColumn * BLOCK_WIDTH + pixel % BLOCK_WIDTH, width - 1u);
+                    const uint32_t y = std::min(blockRow * BLOCK_WIDTH + pixel / BLOCK_WIDTH, height - 1u);
+
+                    std::memcpy(&blockPixels[pixel * 4u], &pixels[(static_cast<size_t>(y) * width + x) * 4u], 4u);
+                }
+
+                compressBlock(format, blockPixels, &outBlocks[(static_cast<size_t>(blockRow) * blockColumnCount + blockColumn) * blockSize]);
+            }
+        }
+    }
+
+    void decompressImage(const BlockFormat format, std::span<const std::byte> blocks, const uint32_t width, const uint32_t height, std::span<uint8_t> outPixels)
+    {
+        const uint32_t blockColumnCount = (width + BLOCK_WIDTH - 1u) / BLOCK_WIDTH;
+        const uint32_t blockRowCount = (height + BLOCK_WIDTH - 1u) / BLOCK_WIDTH;
+        const uint32_t blockSize = getBlockSize(format);
+
+        for (const uint32_t blockRow : std::views::iota(0u, blockRowCount))
+        {
+            for (const uint32_t blockColumn : std::views::iota(0u, blockColumnCount))
+            {
+                BlockPixels blockPixels{};
+                decompressBlock(format, &blocks[(static_cast<size_t>(blockRow) * blockColumnCount + blockColumn) * blockSize], blockPixels);
+
+                for (const uint32_t pixel : std::views::iota(0u, BLOCK_PIXEL_COUNT))
+                {
+                    const uint32_t x = blockColumn * BLOCK_WIDTH + pixel % BLOCK_WIDTH;
+                    const uint32_t y = blockRow * BLOCK_WIDTH + pixel / BLOCK_WIDTH;
+
+                    if (x < width && y < height)
+                    {
+                        std::memcpy(&outPixels[(static_cast<size_t>(y) * width + x) * 4u], &blockPixels[pixel * 4u], 4u);
+                    }
+                }
+            }
+        }
+    }
+
+    double computePsnr(const BlockFormat format, std::span<const uint8_t> pixels, std::span<const uint8_t> decodedPixels)
+    {
+        const uint32_t channelCount = getBlockChannelCount(format);
+
+        uint64_t squaredError = 0u;
+        for (size_t pixel = 0u; pixel < pixels.size() / 4u; pixel++)
+        {
+            for (const uint32_t channel : std::views::iota(0u, channelCount))
+            {
+                const int32_t difference = static_cast<int32_t>(pixels[pixel * 4u + channel]) - static_cast<int32_t>(decodedPixels[pixel * 4u + channel]);
+                squaredError += static_cast<uint64_t>(difference * difference);
+            }
+        }
+
+        if (squaredError == 0u)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        const double meanSquaredError = static_cast<double>(squaredError) / static_cast<double>(pixels.size() / 4u * channelCount);
+        return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+    }
+}
@@ -0,0 +1,597 @@
+#include "Pch.hpp"
+
+#include "Bvh.hpp"
+
+#include "Frustum.hpp"
+
+#include <immintrin.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        constexpr uint32_t SAH_BIN_COUNT = 16u;
+
+        // Cost of visiting a node relative to intersecting a primitive.
+        constexpr float SAH_TRAVERSAL_COST = 1.0f;
+
+        constexpr uint32_t MAX_FRUSTUM_COUNT = 32u;
+
+        AxisAlignedBoundingBox createEmptyBounds()
+        {
+            return AxisAlignedBoundingBox{
+                .minimum = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()},
+                .maximum = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()},
+            };
+        }
+
+        void growBounds(AxisAlignedBoundingBox& bounds, const AxisAlignedBoundingBox& other)
+        {
+            bounds.minimum = {std::min(bounds.minimum.x, other.minimum.x), std::min(bounds.minimum.y, other.minimum.y), std::min(bounds.minimum.z, other.minimum.z)};
+            bounds.maximum = {std::max(bounds.maximum.x, other.maximum.x), std::max(bounds.maximum.y, other.maximum.y), std::max(bounds.maximum.z, other.maximum.z)};
+        }
+
+        void growBounds(AxisAlignedBoundingBox& bounds, const math::XMFLOAT3& point) { growBounds(bounds, AxisAlignedBoundingBox{.minimum = point, .maximum = point}); }
+
+        // Half the surface area, which is all the heuristic needs.
+        float getHalfArea(const AxisAlignedBoundingBox& bounds)
+        {
+            const float x = std::max(bounds.maximum.x - bounds.minimum.x, 0.0f);
+            const float y = std::max(bounds.maximum.y - bounds.minimum.y, 0.0f);
+            const float z = std::max(bounds.maximum.z - bounds.minimum.z, 0.0f);
+
+            return x * y + y * z + z * x;
+        }
+
+        float getAxis(const math::XMFLOAT3& vector, const uint32_t axis) { return axis == 0u ? vector.x : (axis == 1u ? vector.y : vector.z); }
+
+        void setChildBounds(BvhNode& node, const uint32_t child, const AxisAlignedBoundingBox& bounds)
+        {
+            node.minimumX[child] = bounds.minimum.x;
+            node.minimumY[child] = bounds.minimum.y;
+            node.minimumZ[child] = bounds.minimum.z;
+            node.maximumX[child] = bounds.maximum.x;
+            node.maximumY[child] = bounds.maximum.y;
+            node.maximumZ[child] = bounds.maximum.z;
+        }
+
+        AxisAlignedBoundingBox getNodeBounds(const BvhNode& node)
+        {
+            AxisAlignedBoundingBox bounds = createEmptyBounds();
+
+            for (const uint32_t child : std::views::iota(0u, node.childCount))
+            {
+                growBounds(bounds,
+                           AxisAlignedBoundingBox{
+                               .minimum = {node.minimumX[child], node.minimumY[child], node.minimumZ[child]},
+                               .maximum = {node.maximumX[child], node.maximumY[child], node.maximumZ[child]},
+                           });
+            }
+
+            return bounds;
+        }
+
+        // Bit i is set if child i is fully outside the frustum (outsideMask), or crosses one of its planes (crossingMask).
+        void testNodeAgainstFrustum(const BvhNode& node, const Frustum& frustum, uint32_t& outsideMask, uint32_t& crossingMask)
+        {
+            const __m128 minimum[3] = {_mm_load_ps(node.minimumX.data()), _mm_load_ps(node.minimumY.data()), _mm_load_ps(node.minimumZ.data())};
+            const __m128 maximum[3] = {_mm_load_ps(node.maximumX.data()), _mm_load_ps(node.maximumY.data()), _mm_load_ps(node.maximumZ.data())};
+
+            __m128 isOutside = _mm_setzero_ps();
+            __m128 isCrossing = _mm_setzero_ps();
+
+            for (const math::XMFLOAT4& plane : frustum.planes)
+            {
+                // The corner furthest along the plane normal decides whether a box is outside, the nearest one whether it is fully inside.
+                const std::array<float, 3> normal = {plane.x, plane.y, plane.z};
+
+                __m128 furthestDistance = _mm_set1_ps(plane.w);
+                __m128 nearestDistance = _mm_set1_ps(plane.w);
+
+                for (const uint32_t axis : std::views::iota(0u, 3u))
+                {
+                    const __m128 component = _mm_set1_ps(normal[axis]);
+                    const bool isPositive = normal[axis] >= 0.0f;
+
+                    furthestDistance = _mm_add_ps(furthestDistance, _mm_mul_ps(component, isPositive ? maximum[axis] : minimum[axis]));
+                    nearestDistance = _mm_add_ps(nearestDistance, _mm_mul_ps(component, isPositive ? minimum[axis] : maximum[axis]));
+                }
+
+                isOutside = _mm_or_ps(isOutside, _mm_cmplt_ps(furthestDistance, _mm_setzero_ps()));
+                isCrossing = _mm_or_ps(isCrossing, _mm_cmplt_ps(nearestDistance, _mm_setzero_ps()));
+            }
+
+            const uint32_t childMask = (1u << node.childCount) - 1u;
+
+            outsideMask = static_cast<uint32_t>(_mm_movemask_ps(isOutside)) & childMask;
+            crossingMask = static_cast<uint32_t>(_mm_movemask_ps(isCrossing)) & childMask & ~outsideMask;
+        }
+    }
+
+    void Bvh::build(std::span<const AxisAlignedBoundingBox> primitiveBounds, const uint32_t maxLeafPrimitiveCount)
+    {
+        m_nodes.clear();
+        m_primitiveIndices.resize(primitiveBounds.size());
+        std::iota(m_primitiveIndices.begin(), m_primitiveIndices.end(), 0u);
+
+        if (primitiveBounds.empty())
+        {
+            return;
+        }
+
+        std::vector<math::XMFLOAT3> centroids{};
+        centroids.reserve(primitiveBounds.size());
+
+        for (const AxisAlignedBoundingBox& bounds : primitiveBounds)
+        {
+            centroids.emplace_back(0.5f * (bounds.minimum.x + bounds.maximum.x), 0.5f * (bounds.minimum.y + bounds.maximum.y), 0.5f * (bounds.minimum.z + bounds.maximum.z));
+        }
+
+        std::vector<BuildNode> buildNodes{};
+        buildNodes.reserve(2u * primitiveBounds.size());
+
+        const uint32_t rootIndex =
+            buildBinaryNode(primitiveBounds, centroids, 0u, static_cast<uint32_t>(primitiveBounds.size()), std::max(maxLeafPrimitiveCount, 1u), buildNodes);
+
+        m_nodes.reserve(buildNodes.size() / 2u + 1u);
+
+        // A root leaf still gets a node, so every query starts from node 0.
+        if (buildNodes[rootIndex].children[0] == INVALID_INDEX_U32)
+        {
+            BvhNode& node = m_nodes.emplace_back();
+            setChildBounds(node, 0u, buildNodes[rootIndex].bounds);
+            node.firstPrimitives[0] = 0u;
+            node.primitiveCounts[0] = buildNodes[rootIndex].primitiveCount;
+            node.childCount = 1u;
+
+            return;
+        }
+
+        emitNode(buildNodes, rootIndex);
+    }
+
+    uint32_t Bvh::buildBinaryNode(std::span<const AxisAlignedBoundingBox> primitiveBounds,
+                                  std::span<const math::XMFLOAT3> centroids,
+                                  const uint32_t firstPrimitive,
+                                  const uint32_t primitiveCount,
+                                  const uint32_t maxLeafPrimitiveCount,
+                                  std::vector<BuildNode>& buildNodes)
+    {
+        const std::span<uint32_t> primitiveIndices = std::span<uint32_t>(m_primitiveIndices).subspan(firstPrimitive, primitiveCount);
+
+        AxisAlignedBoundingBox bounds = createEmptyBounds();
+        AxisAlignedBoundingBox centroidBounds = createEmptyBounds();
+
+        for (const uint32_t primitiveIndex : primitiveIndices)
+        {
+            growBounds(bounds, primitiveBounds[primitiveIndex]);
+            growBounds(centroidBounds, centroids[primitiveIndex]);
+        }
+
+        const uint32_t nodeIndex = static_cast<uint32_t>(buildNodes.size());
+        buildNodes.emplace_back(BuildNode{
+            .bounds = bounds,
+            .firstPrimitive = firstPrimitive,
+            .primitiveCount = primitiveCount,
+        });
+
+        if (primitiveCount == 1u)
+        {
+            return nodeIndex;
+        }
+
+        // Binned SAH : primitives are binned by centroid along each axis, and every boundary between bins is a candidate split.
+        struct Bin
+        {
+            AxisAlignedBoundingBox bounds{createEmptyBounds()};
+            uint32_t primitiveCount{};
+        };
+
+        float bestCost = std::numeric_limits<float>::infinity();
+        uint32_t bestAxis = INVALID_INDEX_U32;
+        uint32_t bestSplit = 0u;
+
+        const auto getBinIndex = [&](const uint32_t primitiveIndex, const uint32_t axis)
+        {
+            const float minimum = getAxis(centroidBounds.minimum, axis);
+            const float extent = getAxis(centroidBounds.maximum, axis) - minimum;
+
+            return std::min(static_cast<uint32_t>((getAxis(centroids[primitiveIndex], axis) - minimum) / extent * SAH_BIN_COUNT), SAH_BIN_COUNT - 1u);
+        };
+
+        for (const uint32_t axis : std::views::iota(0u, 3u))
+        {
+            if (getAxis(centroidBounds.maximum, axis) <= getAxis(centroidBounds.minimum, axis))
+            {
+                continue;
+            }
+
+            std::array<Bin, SAH_BIN_COUNT> bins{};
+
+            for (const uint32_t primitiveIndex : primitiveIndices)
+            {
+                Bin& bin = bins[getBinIndex(primitiveIndex, axis)];
+                growBounds(bin.bounds, primitiveBounds[primitiveIndex]);
+                bin.primitiveCount++;
+            }
+
+            // Cost of the primitives left of each split, swept from the left, then combined with the right side swept from the right.
+            std::array<float, SAH_BIN_COUNT> leftCosts{};
+
+            AxisAlignedBoundingBox leftBounds = createEmptyBounds();
+            uint32_t leftCount = 0u;
+
+            for (const uint32_t split : std::views::iota(1u, SAH_BIN_COUNT))
+            {
+                growBounds(leftBounds, bins[split - 1u].bounds);
+                leftCount += bins[split - 1u].primitiveCount;
+                leftCosts[split] = leftCount > 0u ? getHalfArea(leftBounds) * leftCount : 0.0f;
+            }
+
+            AxisAlignedBoundingBox rightBounds = createEmptyBounds();
+            uint32_t rightCount = 0u;
+
+            for (uint32_t split = SAH_BIN_COUNT - 1u; split > 0u; split--)
+            {
+                growBounds(rightBounds, bins[split].bounds);
+                rightCount += bins[split].primitiveCount;
+
+                if (rightCount == 0u || rightCount == primitiveCount)
+                {
+                    continue;
+                }
+
+                const float cost = leftCosts[split] + getHalfArea(rightBounds) * rightCount;
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        const float leafCost = getHalfArea(bounds) * primitiveCount;
+        const float splitCost = SAH_TRAVERSAL_COST * getHalfArea(bounds) + bestCost;
+
+        if (primitiveCount <= maxLeafPrimitiveCount && leafCost <= splitCost)
+        {
+            return nodeIndex;
+        }
+
+        uint32_t leftCount = primitiveCount / 2u;
+
+        if (bestAxis != INVALID_INDEX_U32)
+        {
+            const auto middle = std::partition(primitiveIndices.begin(), primitiveIndices.end(), [&](const uint32_t primitiveIndex) { return getBinIndex(primitiveIndex, bestAxis) < bestSplit; });
+            leftCount = static_cast<uint32_t>(middle - primitiveIndices.begin());
+        }
+
+        // Without a valid split (every centroid is the same), oversized leaves are split in half.
+        const uint32_t leftChild = buildBinaryNode(primitiveBounds, centroids, firstPrimitive, leftCount, maxLeafPrimitiveCount, buildNodes);
+        const uint32_t rightChild = buildBinaryNode(primitiveBounds, centroids, firstPrimitive + leftCount, primitiveCount - leftCount, maxLeafPrimitiveCount, buildNodes);
+
+        buildNodes[nodeIndex].children = {leftChild, rightChild};
+
+        return nodeIndex;
+    }
+
+    uint32_t Bvh::emitNode(std::span<const BuildNode> buildNodes, const uint32_t buildNodeIndex)
+    {
+        // Opens the largest inner children until there are four, so the wide node keeps the binary tree's best splits.
+        std::array<uint32_t, 4> children{buildNodes[buildNodeIndex].children[0], buildNodes[buildNodeIndex].children[1]};
+        uint32_t childCount = 2u;
+
+        while (childCount < 4u)
+        {
+            uint32_t largestChild = INVALID_INDEX_U32;
+            float largestArea = -1.0f;
+
+            for (const uint32_t child : std::views::iota(0u, childCount))
+            {
+                const BuildNode& buildNode = buildNodes[children[child]];
+                if (buildNode.children[0] != INVALID_INDEX_U32 && getHalfArea(buildNode.bounds) > largestArea)
+                {
+                    largestChild = child;
+                    largestArea = getHalfArea(buildNode.bounds);
+                }
+            }
+
+            if (largestChild == INVALID_INDEX_U32)
+            {
+                break;
+            }
+
+            const std::array<uint32_t, 2> grandChildren = buildNodes[children[largestChild]].children;
+            children[largestChild] = grandChildren[0];
+            children[childCount++] = grandChildren[1];
+        }
+
+        // Children are emitted after their parent, which is what refit relies on.
+        const uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+
+        BvhNode node{.childCount = childCount};
+
+        for (const uint32_t child : std::views::iota(0u, childCount))
+        {
+            const BuildNode& buildNode = buildNodes[children[child]];
+
+            setChildBounds(node, child, buildNode.bounds);
+            node.firstPrimitives[child] = buildNode.firstPrimitive;
+            node.primitiveCounts[child] = buildNode.primitiveCount;
+
+            if (buildNode.children[0] != INVALID_INDEX_U32)
+            {
+                node.childNodes[child] = emitNode(buildNodes, children[child]);
+            }
+        }
+
+        m_nodes[nodeIndex] = node;
+
+        return nodeIndex;
+    }
+
+    void Bvh::refit(std::span<const AxisAlignedBoundingBox> primitiveBounds)
+    {
+        for (BvhNode& node : std::views::reverse(m_nodes))
+        {
+            for (const uint32_t child : std::views::iota(0u, node.childCount))
+            {
+                AxisAlignedBoundingBox bounds = createEmptyBounds();
+
+                if (node.childNodes[child] != INVALID_INDEX_U32)
+                {
+                    bounds = getNodeBounds(m_nodes[node.childNodes[child]]);
+                }
+                else
+                {
+                    for (const uint32_t primitiveIndex : std::span<const uint32_t>(m_primitiveIndices).subspan(node.firstPrimitives[child], node.primitiveCounts[child]))
+                    {
+                        growBounds(bounds, primitiveBounds[primitiveIndex]);
+                    }
+                }
+
+                setChildBounds(node, child, bounds);
+            }
+        }
+    }
+
+    void Bvh::queryFrustums(std::span<const Frustum> frustums, std::span<std::vector<uint32_t>> outPrimitives) const
+    {
+        if (frustums.size() > MAX_FRUSTUM_COUNT)
+        {
+            fatalError(std::format("Bvh::queryFrustums supports at most {} frustums, {} were given.", MAX_FRUSTUM_COUNT, frustums.size()));
+        }
+
+        if (m_nodes.empty() || frustums.empty())
+        {
+            return;
+        }
+
+        const auto appendPrimitives = [&](const uint32_t frustumIndex, const uint32_t firstPrimitive, const uint32_t primitiveCount)
+        {
+            const std::span<const uint32_t> primitiveIndices = std::span<const uint32_t>(m_primitiveIndices).subspan(firstPrimitive, primitiveCount);
+            outPrimitives[frustumIndex].insert(outPrimitives[frustumIndex].end(), primitiveIndices.begin(), primitiveIndices.end());
+        };
+
+        // Each entry carries the frustums its node still crosses, the others either rejected or fully contain an ancestor.
+        struct StackEntry
+        {
+            uint32_t nodeIndex{};
+            uint32_t frustumMask{};
+        };
+
+        std::vector<StackEntry> stack{};
+        stack.emplace_back(StackEntry{.nodeIndex = 0u, .frustumMask = static_cast<uint32_t>((uint64_t{1u} << frustums.size()) - 1u)});
+
+        while (!stack.empty())
+        {
+            const StackEntry entry = stack.back();
+            stack.pop_back();
+
+            const BvhNode& node = m_nodes[entry.nodeIndex];
+
+            std::array<uint32_t, 4> childFrustumMasks{};
+
+            for (uint32_t frustumMask = entry.frustumMask; frustumMask != 0u; frustumMask &= frustumMask - 1u)
+            {
+                const uint32_t frustumIndex = static_cast<uint32_t>(std::countr_zero(frustumMask));
+
+                uint32_t outsideMask = 0u;
+                uint32_t crossingMask = 0u;
+                testNodeAgainstFrustum(node, frustums[frustumIndex], outsideMask, crossingMask);
+
+                for (const uint32_t child : std::views::iota(0u, node.childCount))
+                {
+                    const uint32_t childBit = 1u << child;
+
+                    if ((outsideMask & childBit) != 0u)
+                    {
+                        continue;
+                    }
+
+                    if ((crossingMask & childBit) != 0u && node.childNodes[child] != INVALID_INDEX_U32)
+                    {
+                        childFrustumMasks[child] |= 1u << frustumIndex;
+                    }
+                    else
+                    {
+                        appendPrimitives(frustumIndex, node.firstPrimitives[child], node.primitiveCounts[child]);
+                    }
+                }
+            }
+
+            for (const uint32_t child : std::views::iota(0u, node.childCount))
+            {
+                if (childFrustumMasks[child] != 0u)
+                {
+                    stack.emplace_back(StackEntry{.nodeIndex = node.childNodes[child], .frustumMask = childFrustumMasks[child]});
+                }
+            }
+        }
+    }
+
+    void Bvh::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& outPrimitives) const
+    {
+        queryFrustums(std::span<const Frustum>(&frustum, 1u), std::span<std::vector<uint32_t>>(&outPrimitives, 1u));
+    }
+
+    BvhRayHit Bvh::raycast(const Ray& ray, const BvhRayIntersector& intersector) const
+    {
+        BvhRayHit hit{.distance = ray.maxDistance};
+
+        if (m_nodes.empty())
+        {
+            return BvhRayHit{};
+        }
+
+        const __m128 origin[3] = {_mm_set1_ps(ray.origin.x), _mm_set1_ps(ray.origin.y), _mm_set1_ps(ray.origin.z)};
+        const __m128 inverseDirection[3] = {_mm_set1_ps(1.0f / ray.direction.x), _mm_set1_ps(1.0f / ray.direction.y), _mm_set1_ps(1.0f / ray.direction.z)};
+
+        // Leaves are pushed as well, so they are visited in distance order along with the nodes.
+        struct StackEntry
+        {
+            uint32_t nodeIndex{};
+            uint32_t firstPrimitive{};
+            uint32_t primitiveCount{};
+            float distance{};
+        };
+
+        std::vector<StackEntry> stack{};
+        stack.emplace_back(StackEntry{.nodeIndex = 0u, .distance = 0.0f});
+
+        while (!stack.empty())
+        {
+            const StackEntry entry = stack.back();
+            stack.pop_back();
+
+            if (entry.distance > hit.distance)
+            {
+                continue;
+            }
+
+            if (entry.nodeIndex == INVALID_INDEX_U32)
+            {
+                for (const uint32_t primitiveIndex : std::span<const uint32_t>(m_primitiveIndices).subspan(entry.firstPrimitive, entry.primitiveCount))
+                {
+                    const float distance = intersector(primitiveIndex, ray, hit.distance);
+                    if (distance < hit.distance)
+                    {
+                        hit = BvhRayHit{.primitiveIndex = primitiveIndex, .distance = distance};
+                    }
+                }
+
+                continue;
+            }
+
+            const BvhNode& node = m_nodes[entry.nodeIndex];
+
+            // Slab test of the four children at once.
+            const __m128 minimum[3] = {_mm_load_ps(node.minimumX.data()), _mm_load_ps(node.minimumY.data()), _mm_load_ps(node.minimumZ.data())};
+            const __m128 maximum[3] = {_mm_load_ps(node.maximumX.data()), _mm_load_ps(node.maximumY.data()), _mm_load_ps(node.maximumZ.data())};
+
+            __m128 nearDistance = _mm_setzero_ps();
+            __m128 farDistance = _mm_set1_ps(hit.distance);
+
+            for (const uint32_t axis : std::views::iota(0u, 3u))
+            {
+                const __m128 distance0 = _mm_mul_ps(_mm_sub_ps(minimum[axis], origin[axis]), inverseDirection[axis]);
+                const __m128 distance1 = _mm_mul_ps(_mm_sub_ps(maximum[axis], origin[axis]), inverseDirection[axis]);
+
+                nearDistance = _mm_max_ps(nearDistance, _mm_min_ps(distance0, distance1));
+                farDistance = _mm_min_ps(farDistance, _mm_max_ps(distance0, distance1));
+            }
+
+            const uint32_t hitMask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(nearDistance, farDistance))) & ((1u << node.childCount) - 1u);
+
+            alignas(16) std::array<float, 4> nearDistances{};
+            _mm_store_ps(nearDistances.data(), nearDistance);
+
+            // Furthest children are pushed first, so the nearest one is visited next.
+            std::array<uint32_t, 4> hitChildren{};
+            uint32_t hitChildCount = 0u;
+
+            for (uint32_t mask = hitMask; mask != 0u; mask &= mask - 1u)
+            {
+                hitChildren[hitChildCount++] = static_cast<uint32_t>(std::countr_zero(mask));
+            }
+
+            std::sort(hitChildren.begin(), hitChildren.begin() + hitChildCount, [&](const uint32_t a, const uint32_t b) { return nearDistances[a] > nearDistances[b]; });
+
+            for (const uint32_t child : std::span<const uint32_t>(hitChildren).first(hitChildCount))
+            {
+                stack.emplace_back(StackEntry{
+                    .nodeIndex = node.childNodes[child],
+                    .firstPrimitive = node.firstPrimitives[child],
+                    .primitiveCount = node.primitiveCounts[child],
+                    .distance = nearDistances[child],
+                });
+            }
+        }
+
+        return hit.isHit() ? hit : BvhRayHit{};
+    }
+
+    AxisAlignedBoundingBox Bvh::getBounds() const { return m_nodes.empty() ? AxisAlignedBoundingBox{} : getNodeBounds(m_nodes.front()); }
+
+    float intersectRayTriangle(const Ray& ray, const math::XMFLOAT3& p0, const math::XMFLOAT3& p1, const math::XMFLOAT3& p2)
+    {
+        constexpr float EPSILON = 1e-9f;
+        constexpr float MISS = std::numeric_limits<float>::infinity();
+
+        const math::XMVECTOR origin = math::XMLoadFloat3(&ray.origin);
+        const math::XMVECTOR direction = math::XMLoadFloat3(&ray.direction);
+
+        const math::XMVECTOR vertex0 = math::XMLoadFloat3(&p0);
+        const math::XMVECTOR edge1 = math::XMVectorSubtract(math::XMLoadFloat3(&p1), vertex0);
+        const math::XMVECTOR edge2 = math::XMVectorSubtract(math::XMLoadFloat3(&p2), vertex0);
+
+        const math::XMVECTOR p = math::XMVector3Cross(direction, edge2);
+        const float determinant = math::XMVectorGetX(math::XMVector3Dot(edge1, p));
+
+        if (std::abs(determinant) < EPSILON)
+        {
+            return MISS;
+        }
+
+        const float inverseDeterminant = 1.0f / determinant;
+        const math::XMVECTOR t = math::XMVectorSubtract(origin, vertex0);
+
+        const float u = math::XMVectorGetX(math::XMVector3Dot(t, p)) * inverseDeterminant;
+        if (u < 0.0f || u > 1.0f)
+        {
+            return MISS;
+        }
+
+        const math::XMVECTOR q = math::XMVector3Cross(t, edge1);
+
+        const float v = math::XMVectorGetX(math::XMVector3Dot(direction, q)) * inverseDeterminant;
+        if (v < 0.0f || u + v > 1.0f)
+        {
+            return MISS;
+        }
+
+        const float distance = math::XMVectorGetX(math::XMVector3Dot(edge2, q)) * inverseDeterminant;
+
+        return distance >= 0.0f && distance <= ray.maxDistance ? distance : MISS;
+    }
+
+    float intersectRayAabb(const Ray& ray, const AxisAlignedBoundingBox& bounds)
+    {
+        float nearDistance = 0.0f;
+        float farDistance = ray.maxDistance;
+
+        for (const uint32_t axis : std::views::iota(0u, 3u))
+        {
+            const float inverseDirection = 1.0f / getAxis(ray.direction, axis);
+            const float distance0 = (getAxis(bounds.minimum, axis) - getAxis(ray.origin, axis)) * inverseDirection;
+            const float distance1 = (getAxis(bounds.maximum, axis) - getAxis(ray.origin, axis)) * inverseDirection;
+
+            nearDistance = std::max(nearDistance, std::min(distance0, distance1));
+            farDistance = std::min(farDistance, std::max(distance0, distance1));
+        }
+
+        return nearDistance <= farDistance ? nearDistance : std::numeric_limits<float>::infinity();
+    }
+}
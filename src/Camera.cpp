@@ -81,6 +81,25 @@ namespace sgfx
 
         return DirectX::XMMatrixLookAtLH(cameraPosition, cameraTarget, cameraUp);
     }
+
+    Ray sgfx::Camera::getScreenRay(const float x, const float y, const float viewportWidth, const float viewportHeight, const math::XMMATRIX projectionMatrix)
+    {
+        const math::XMMATRIX viewMatrix = getLookAtMatrix();
+
+        const auto unproject = [&](const float depth)
+        {
+            return math::XMVector3Unproject(math::XMVectorSet(x, y, depth, 0.0f), 0.0f, 0.0f, viewportWidth, viewportHeight, 0.0f, 1.0f, projectionMatrix, viewMatrix, math::XMMatrixIdentity());
+        };
+
+        const math::XMVECTOR nearPoint = unproject(0.0f);
+        const math::XMVECTOR farPoint = unproject(1.0f);
+
+        Ray ray{.maxDistance = 1.0f};
+        math::XMStoreFloat3(&ray.origin, nearPoint);
+        math::XMStoreFloat3(&ray.direction, math::XMVectorSubtract(farPoint, nearPoint));
+
+        return ray;
+    }
 }
 
 
@@ -0,0 +1,83 @@
+#include "Pch.hpp"
+
+#include "CommandList.hpp"
+
+namespace sgfx
+{
+    void CommandList::reset()
+    {
+        std::fill_n(m_blockSizes.begin(), m_usedBlockCount, 0u);
+        m_usedBlockCount = 0u;
+
+        m_commandCount = 0u;
+        m_drawCount = 0u;
+    }
+
+    void CommandList::append(const CommandList& other)
+    {
+        for (const uint32_t blockIndex : std::views::iota(0u, other.m_usedBlockCount))
+        {
+            const std::byte* source = other.m_blocks[blockIndex].get();
+            uint32_t remainingSize = other.m_blockSizes[blockIndex];
+
+            while (remainingSize != 0u)
+            {
+                const uint32_t freeSize = m_usedBlockCount == 0u ? 0u : BLOCK_SIZE - m_blockSizes[m_usedBlockCount - 1u];
+
+                // The longest run of whole commands fitting in the current block is copied at once.
+                uint32_t runSize = 0u;
+                while (runSize < remainingSize)
+                {
+                    const uint32_t commandSize = reinterpret_cast<const CommandHeader*>(source + runSize)->size;
+                    if (runSize + commandSize > freeSize)
+                    {
+                        break;
+                    }
+
+                    runSize += commandSize;
+                }
+
+                if (runSize == 0u)
+                {
+                    startBlock();
+                    continue;
+                }
+
+                std::memcpy(allocate(runSize), source, runSize);
+
+                source += runSize;
+                remainingSize -= runSize;
+            }
+        }
+
+        m_commandCount += other.m_commandCount;
+        m_drawCount += other.m_drawCount;
+    }
+
+    uint64_t CommandList::getSize() const { return std::accumulate(m_blockSizes.begin(), m_blockSizes.begin() + m_usedBlockCount, uint64_t{0u}); }
+
+    std::byte* CommandList::allocate(const uint32_t size)
+    {
+        if (m_usedBlockCount == 0u || m_blockSizes[m_usedBlockCount - 1u] + size > BLOCK_SIZE)
+        {
+            startBlock();
+        }
+
+        uint32_t& blockSize = m_blockSizes[m_usedBlockCount - 1u];
+        std::byte* const allocation = m_blocks[m_usedBlockCount - 1u].get() + blockSize;
+        blockSize += size;
+
+        return allocation;
+    }
+
+    void CommandList::startBlock()
+    {
+        if (m_usedBlockCount == m_blocks.size())
+        {
+            m_blocks.emplace_back(std::make_unique_for_overwrite<std::byte[]>(BLOCK_SIZE));
+            m_blockSizes.emplace_back(0u);
+        }
+
+        m_usedBlockCount++;
+    }
+}
@@ -0,0 +1,78 @@
+#include "Pch.hpp"
+
+#include "CpuFeatures.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace sgfx
+{
+    namespace
+    {
+        std::array<uint32_t, 4> cpuid(const uint32_t leaf, const uint32_t subLeaf)
+        {
+            std::array<uint32_t, 4> registers{};
+
+#if defined(_MSC_VER)
+            std::array<int, 4> cpuInfo{};
+            __cpuidex(cpuInfo.data(), static_cast<int>(leaf), static_cast<int>(subLeaf));
+            std::memcpy(registers.data(), cpuInfo.data(), sizeof(registers));
+#else
+            __cpuid_count(leaf, subLeaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+
+            return registers;
+        }
+
+        // Checks that the OS saves / restores the YMM registers on context switches.
+        bool isAvxStateEnabled()
+        {
+#if defined(_MSC_VER)
+            return (_xgetbv(0u) & 0x6u) == 0x6u;
+#else
+            uint32_t eax{};
+            uint32_t edx{};
+            __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0u));
+            return (eax & 0x6u) == 0x6u;
+#endif
+        }
+
+        CpuFeatures queryCpuFeatures()
+        {
+            CpuFeatures features{};
+
+            const uint32_t maxLeaf = cpuid(0u, 0u)[0];
+            if (maxLeaf < 1u)
+            {
+                return features;
+            }
+
+            const std::array<uint32_t, 4> leaf1 = cpuid(1u, 0u);
+
+            const bool osxsave = (leaf1[2] & (1u << 27u)) != 0u;
+            const bool avx = (leaf1[2] & (1u << 28u)) != 0u && osxsave && isAvxStateEnabled();
+
+            features.sse41 = (leaf1[2] & (1u << 19u)) != 0u;
+            features.f16c = avx && (leaf1[2] & (1u << 29u)) != 0u;
+
+            if (maxLeaf >= 7u)
+            {
+                const std::array<uint32_t, 4> leaf7 = cpuid(7u, 0u);
+                const bool fma = (leaf1[2] & (1u << 12u)) != 0u;
+
+                features.avx2 = avx && fma && (leaf7[1] & (1u << 5u)) != 0u;
+            }
+
+            return features;
+        }
+    }
+
+    const CpuFeatures& getCpuFeatures()
+    {
+        static const CpuFeatures features = queryCpuFeatures();
+        return features;
+    }
+}
@@ -0,0 +1,126 @@
+#include "Pch.hpp"
+
+#include "D3D11CommandList.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        template <typename T> T* fromHandle(const BackendHandle handle) { return static_cast<T*>(const_cast<void*>(handle)); }
+
+        struct CommandReplayer
+        {
+            void operator()(const SetPipelineCommand& command) const
+            {
+                const GraphicsPipeline& pipeline = *static_cast<const GraphicsPipeline*>(command.pipeline);
+
+                deviceContext->IASetPrimitiveTopology(pipeline.primitiveTopology);
+                deviceContext->IASetInputLayout(pipeline.inputLayout.Get());
+
+                deviceContext->VSSetShader(pipeline.vertexShader.Get(), nullptr, 0u);
+                deviceContext->PSSetShader(pipeline.pixelShader.Get(), nullptr, 0u);
+            }
+
+            void operator()(const SetRenderTargetsCommand& command) const
+            {
+                std::array<ID3D11RenderTargetView*, MAX_RENDER_TARGET_COUNT> rtvs{};
+                for (const uint32_t i : std::views::iota(0u, command.renderTargetCount))
+                {
+                    rtvs[i] = fromHandle<ID3D11RenderTargetView>(command.renderTargets[i]);
+                }
+
+                deviceContext->OMSetRenderTargets(command.renderTargetCount, rtvs.data(), fromHandle<ID3D11DepthStencilView>(command.depthStencil));
+            }
+
+            void operator()(const ClearRenderTargetCommand& command) const
+            {
+                deviceContext->ClearRenderTargetView(fromHandle<ID3D11RenderTargetView>(command.renderTarget), command.color.data());
+            }
+
+            void operator()(const ClearDepthStencilCommand& command) const
+            {
+                deviceContext->ClearDepthStencilView(fromHandle<ID3D11DepthStencilView>(command.depthStencil), D3D11_CLEAR_DEPTH, command.depth, 0u);
+            }
+
+            void operator()(const SetViewportCommand& command) const
+            {
+                const D3D11_VIEWPORT viewport = {
+                    .TopLeftX = command.x,
+                    .TopLeftY = command.y,
+                    .Width = command.width,
+                    .Height = command.height,
+                    .MinDepth = command.minimumDepth,
+                    .MaxDepth = command.maximumDepth,
+                };
+
+                deviceContext->RSSetViewports(1u, &viewport);
+            }
+
+            void operator()(const SetVertexBufferCommand& command) const
+            {
+                ID3D11Buffer* const buffer = fromHandle<ID3D11Buffer>(command.buffer);
+                deviceContext->IASetVertexBuffers(0u, 1u, &buffer, &command.stride, &command.offset);
+            }
+
+            void operator()(const SetIndexBufferCommand& command) const
+            {
+                deviceContext->IASetIndexBuffer(fromHandle<ID3D11Buffer>(command.buffer), command.indexSize == 2u ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0u);
+            }
+
+            void operator()(const SetConstantBufferCommand& command) const
+            {
+                ID3D11Buffer* const buffer = fromHandle<ID3D11Buffer>(command.buffer);
+
+                if (command.stage == ShaderStage::Vertex)
+                {
+                    deviceContext->VSSetConstantBuffers(command.slot, 1u, &buffer);
+                }
+                else
+                {
+                    deviceContext->PSSetConstantBuffers(command.slot, 1u, &buffer);
+                }
+            }
+
+            void operator()(const SetShaderResourceCommand& command) const
+            {
+                ID3D11ShaderResourceView* const srv = fromHandle<ID3D11ShaderResourceView>(command.resource);
+
+                if (command.stage == ShaderStage::Vertex)
+                {
+                    deviceContext->VSSetShaderResources(command.slot, 1u, &srv);
+                }
+                else
+                {
+                    deviceContext->PSSetShaderResources(command.slot, 1u, &srv);
+                }
+            }
+
+            void operator()(const SetSamplerCommand& command) const
+            {
+                ID3D11SamplerState* const sampler = fromHandle<ID3D11SamplerState>(command.sampler);
+
+                if (command.stage == ShaderStage::Vertex)
+                {
+                    deviceContext->VSSetSamplers(command.slot, 1u, &sampler);
+                }
+                else
+                {
+                    deviceContext->PSSetSamplers(command.slot, 1u, &sampler);
+                }
+            }
+
+            void operator()(const DrawCommand& command) const { deviceContext->Draw(command.vertexCount, command.firstVertex); }
+
+            void operator()(const DrawIndexedCommand& command) const { deviceContext->DrawIndexed(command.indexCount, command.firstIndex, command.baseVertex); }
+
+            void operator()(const DrawIndexedInstancedCommand& command) const
+            {
+                deviceContext->DrawIndexedInstanced(command.indexCount, command.instanceCount, command.firstIndex, command.baseVertex, command.firstInstance);
+            }
+
+            ID3D11DeviceContext* deviceContext{};
+        };
+    }
+
+    void replayCommandList(ID3D11DeviceContext* const deviceContext, const CommandList& commandList) { commandList.forEach(CommandReplayer{.deviceContext = deviceContext}); }
+}
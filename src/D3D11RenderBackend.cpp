@@ -0,0 +1,587 @@
+#include "Pch.hpp"
+
+#include "D3D11RenderBackend.hpp"
+
+#include "JobSystem.hpp"
+#include "ShaderCache.hpp"
+
+#include <imgui.h>
+#include <imgui_impl_dx11.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        DXGI_FORMAT getDxgiFormat(const TextureFormat format)
+        {
+            switch (format)
+            {
+                case TextureFormat::R8Unorm: return DXGI_FORMAT_R8_UNORM;
+                case TextureFormat::R8G8B8A8Unorm: return DXGI_FORMAT_R8G8B8A8_UNORM;
+                case TextureFormat::R8G8B8A8UnormSrgb: return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+                case TextureFormat::R32G32Float: return DXGI_FORMAT_R32G32_FLOAT;
+                case TextureFormat::R16G16B16A16Float: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+                case TextureFormat::R32G32B32A32Float: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+                case TextureFormat::D32Float: return DXGI_FORMAT_D32_FLOAT;
+                case TextureFormat::BC1Unorm: return DXGI_FORMAT_BC1_UNORM;
+                case TextureFormat::BC1UnormSrgb: return DXGI_FORMAT_BC1_UNORM_SRGB;
+                case TextureFormat::BC3Unorm: return DXGI_FORMAT_BC3_UNORM;
+                case TextureFormat::BC3UnormSrgb: return DXGI_FORMAT_BC3_UNORM_SRGB;
+                case TextureFormat::BC4Unorm: return DXGI_FORMAT_BC4_UNORM;
+                case TextureFormat::BC5Unorm: return DXGI_FORMAT_BC5_UNORM;
+                case TextureFormat::BC7Unorm: return DXGI_FORMAT_BC7_UNORM;
+                case TextureFormat::BC7UnormSrgb: return DXGI_FORMAT_BC7_UNORM_SRGB;
+            }
+
+            return DXGI_FORMAT_UNKNOWN;
+        }
+
+        DXGI_FORMAT getDxgiFormat(const VertexAttributeFormat format)
+        {
+            switch (format)
+            {
+                case VertexAttributeFormat::Float2: return DXGI_FORMAT_R32G32_FLOAT;
+                case VertexAttributeFormat::Float3: return DXGI_FORMAT_R32G32B32_FLOAT;
+                case VertexAttributeFormat::Float4: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+                case VertexAttributeFormat::Unorm8x4: return DXGI_FORMAT_R8G8B8A8_UNORM;
+                case VertexAttributeFormat::Snorm16x2: return DXGI_FORMAT_R16G16_SNORM;
+                case VertexAttributeFormat::Snorm16x4: return DXGI_FORMAT_R16G16B16A16_SNORM;
+                case VertexAttributeFormat::Unorm16x2: return DXGI_FORMAT_R16G16_UNORM;
+                case VertexAttributeFormat::Unorm16x4: return DXGI_FORMAT_R16G16B16A16_UNORM;
+                case VertexAttributeFormat::Half2: return DXGI_FORMAT_R16G16_FLOAT;
+            }
+
+            return DXGI_FORMAT_UNKNOWN;
+        }
+
+        uint32_t getBindFlags(const BufferType type)
+        {
+            switch (type)
+            {
+                case BufferType::Vertex: return D3D11_BIND_VERTEX_BUFFER;
+                case BufferType::Index: return D3D11_BIND_INDEX_BUFFER;
+                case BufferType::Constant: return D3D11_BIND_CONSTANT_BUFFER;
+            }
+
+            return 0u;
+        }
+
+        D3D11_FILTER getFilter(const SamplerFilter filter)
+        {
+            switch (filter)
+            {
+                case SamplerFilter::Point: return D3D11_FILTER_MIN_MAG_MIP_POINT;
+                case SamplerFilter::Linear: return D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+                case SamplerFilter::Anisotropic: return D3D11_FILTER_ANISOTROPIC;
+            }
+
+            return D3D11_FILTER_MIN_MAG_MIP_POINT;
+        }
+
+        D3D11_TEXTURE_ADDRESS_MODE getAddressMode(const SamplerAddressMode addressMode)
+        {
+            switch (addressMode)
+            {
+                case SamplerAddressMode::Wrap: return D3D11_TEXTURE_ADDRESS_WRAP;
+                case SamplerAddressMode::Clamp: return D3D11_TEXTURE_ADDRESS_CLAMP;
+                case SamplerAddressMode::Mirror: return D3D11_TEXTURE_ADDRESS_MIRROR;
+            }
+
+            return D3D11_TEXTURE_ADDRESS_WRAP;
+        }
+
+        // Null terminated macro list for D3DCompileFromFile, the defines must outlive it.
+        std::vector<D3D_SHADER_MACRO> getShaderMacros(std::span<const std::string> shaderDefines)
+        {
+            std::vector<D3D_SHADER_MACRO> shaderMacros{};
+            shaderMacros.reserve(shaderDefines.size() + 1u);
+
+            for (const std::string& shaderDefine : shaderDefines)
+            {
+                shaderMacros.emplace_back(D3D_SHADER_MACRO{.Name = shaderDefine.c_str(), .Definition = "1"});
+            }
+
+            shaderMacros.emplace_back(D3D_SHADER_MACRO{.Name = nullptr, .Definition = nullptr});
+
+            return shaderMacros;
+        }
+    }
+
+    std::vector<std::byte> compileD3D11Shader(const ShaderCompileDesc& compileDesc)
+    {
+        wrl::ComPtr<ID3DBlob> shaderBlob{};
+        wrl::ComPtr<ID3DBlob> errorBlob{};
+
+        const std::vector<D3D_SHADER_MACRO> shaderMacros = getShaderMacros(compileDesc.defines);
+
+        if (FAILED(::D3DCompileFromFile(compileDesc.path.c_str(),
+                                        shaderMacros.data(),
+                                        D3D_COMPILE_STANDARD_FILE_INCLUDE,
+                                        compileDesc.entryPoint.c_str(),
+                                        compileDesc.target.c_str(),
+                                        0u,
+                                        0u,
+                                        &shaderBlob,
+                                        &errorBlob)))
+        {
+            // There is no error message if the file could not be opened.
+            std::cout << "Error in compiling shader : " << compileDesc.path.string() << ". Error : "
+                      << (errorBlob ? static_cast<const char*>(errorBlob->GetBufferPointer()) : "file not found") << '\n';
+            throw std::runtime_error("Shader compilation error.");
+        }
+
+        const std::byte* const bytecode = static_cast<const std::byte*>(shaderBlob->GetBufferPointer());
+        return std::vector<std::byte>(bytecode, bytecode + shaderBlob->GetBufferSize());
+    }
+
+    D3D11RenderBackend::D3D11RenderBackend(const D3D11RenderBackendCreationDesc& creationDesc, ShaderCache& shaderCache, JobSystem& jobSystem)
+        : m_shaderCache(shaderCache), m_jobSystem(jobSystem)
+    {
+        createDeviceResources();
+        createSwapchainResources(creationDesc);
+
+        ImGui_ImplDX11_Init(m_device.Get(), m_deviceContext.Get());
+    }
+
+    D3D11RenderBackend::~D3D11RenderBackend() { ImGui_ImplDX11_Shutdown(); }
+
+    BackendHandle D3D11RenderBackend::createBuffer(const BackendBufferDesc& bufferDesc, std::span<const std::byte> data)
+    {
+        const D3D11_BUFFER_DESC d3dBufferDesc = {
+            .ByteWidth = bufferDesc.size,
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = getBindFlags(bufferDesc.type),
+        };
+
+        const D3D11_SUBRESOURCE_DATA resourceData = {.pSysMem = data.data()};
+
+        wrl::ComPtr<ID3D11Buffer> buffer{};
+        throwIfFailed(m_device->CreateBuffer(&d3dBufferDesc, data.empty() ? nullptr : &resourceData, &buffer));
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.bufferCount++;
+        m_stats.bufferBytes += bufferDesc.size;
+
+        return addResource(buffer.Get(), Resource{.type = ResourceType::Buffer, .object = buffer, .size = bufferDesc.size});
+    }
+
+    BackendHandle D3D11RenderBackend::createTexture(const BackendTextureDesc& textureDesc, std::span<const std::byte> data)
+    {
+        const D3D11_TEXTURE2D_DESC d3dTextureDesc = {
+            .Width = textureDesc.width,
+            .Height = textureDesc.height,
+            .MipLevels = textureDesc.mipCount,
+            .ArraySize = 1u,
+            .Format = getDxgiFormat(textureDesc.format),
+            .SampleDesc = {1u, 0u},
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+        };
+
+        // The mips are tightly packed one after the other, rows of blocks being the rows of block compressed formats.
+        std::vector<D3D11_SUBRESOURCE_DATA> subresourceData(textureDesc.mipCount);
+
+        uint64_t offset = 0u;
+        for (const uint32_t mip : std::views::iota(0u, textureDesc.mipCount))
+        {
+            const uint32_t width = std::max(textureDesc.width >> mip, 1u);
+            const uint32_t height = std::max(textureDesc.height >> mip, 1u);
+            const uint32_t rowLength = isBlockCompressed(textureDesc.format) ? (width + 3u) / 4u : width;
+
+            subresourceData[mip] = D3D11_SUBRESOURCE_DATA{
+                .pSysMem = data.data() + offset,
+                .SysMemPitch = rowLength * getTexelSize(textureDesc.format),
+            };
+
+            offset += getMipSize(textureDesc.format, width, height);
+        }
+
+        if (offset != data.size())
+        {
+            fatalError("Texture data size differs from the size of its mips.");
+        }
+
+        wrl::ComPtr<ID3D11Texture2D> texture{};
+        throwIfFailed(m_device->CreateTexture2D(&d3dTextureDesc, subresourceData.data(), &texture));
+
+        wrl::ComPtr<ID3D11ShaderResourceView> srv{};
+        throwIfFailed(m_device->CreateShaderResourceView(texture.Get(), nullptr, &srv));
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.textureCount++;
+        m_stats.textureBytes += data.size();
+
+        return addResource(srv.Get(), Resource{.type = ResourceType::Texture, .object = srv, .size = data.size()});
+    }
+
+    BackendRenderTargetHandles D3D11RenderBackend::createRenderTarget(const BackendRenderTargetDesc& renderTargetDesc)
+    {
+        const bool isDepthStencil = renderTargetDesc.format == TextureFormat::D32Float;
+
+        // Depth buffers are typeless, so they can be both bound as depth stencil and sampled as floats.
+        const D3D11_TEXTURE2D_DESC textureDesc = {
+            .Width = renderTargetDesc.width,
+            .Height = renderTargetDesc.height,
+            .MipLevels = 1u,
+            .ArraySize = 1u,
+            .Format = isDepthStencil ? DXGI_FORMAT_R32_TYPELESS : getDxgiFormat(renderTargetDesc.format),
+            .SampleDesc = {1u, 0u},
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = (isDepthStencil ? D3D11_BIND_DEPTH_STENCIL : D3D11_BIND_RENDER_TARGET) | D3D11_BIND_SHADER_RESOURCE,
+        };
+
+        wrl::ComPtr<ID3D11Texture2D> texture{};
+        throwIfFailed(m_device->CreateTexture2D(&textureDesc, nullptr, &texture));
+
+        wrl::ComPtr<ID3D11DeviceChild> targetView{};
+        if (isDepthStencil)
+        {
+            const D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {
+                .Format = DXGI_FORMAT_D32_FLOAT,
+                .ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D,
+            };
+
+            wrl::ComPtr<ID3D11DepthStencilView> dsv{};
+            throwIfFailed(m_device->CreateDepthStencilView(texture.Get(), &dsvDesc, &dsv));
+            targetView = dsv;
+        }
+        else
+        {
+            wrl::ComPtr<ID3D11RenderTargetView> rtv{};
+            throwIfFailed(m_device->CreateRenderTargetView(texture.Get(), nullptr, &rtv));
+            targetView = rtv;
+        }
+
+        const D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
+            .Format = isDepthStencil ? DXGI_FORMAT_R32_FLOAT : textureDesc.Format,
+            .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
+            .Texture2D =
+                {
+                    .MostDetailedMip = 0u,
+                    .MipLevels = 1u,
+                },
+        };
+
+        wrl::ComPtr<ID3D11ShaderResourceView> srv{};
+        throwIfFailed(m_device->CreateShaderResourceView(texture.Get(), &srvDesc, &srv));
+
+        const uint64_t renderTargetSize = getMipSize(renderTargetDesc.format, renderTargetDesc.width, renderTargetDesc.height);
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.renderTargetCount++;
+        m_stats.renderTargetBytes += renderTargetSize;
+
+        // The views are distinct objects, so the handles are too : each view keeps the texture alive until both are released.
+        const BackendHandle targetHandle = targetView.Get();
+
+        return BackendRenderTargetHandles{
+            .renderTarget = addResource(targetHandle, Resource{.type = ResourceType::RenderTarget, .object = std::move(targetView), .size = renderTargetSize}),
+            .texture = addResource(srv.Get(), Resource{.type = ResourceType::RenderTargetTexture, .object = srv}),
+        };
+    }
+
+    BackendHandle D3D11RenderBackend::createSampler(const BackendSamplerDesc& samplerDesc)
+    {
+        const D3D11_SAMPLER_DESC d3dSamplerDesc = {
+            .Filter = getFilter(samplerDesc.filter),
+            .AddressU = getAddressMode(samplerDesc.addressModeU),
+            .AddressV = getAddressMode(samplerDesc.addressModeV),
+            .AddressW = getAddressMode(samplerDesc.addressModeU),
+            .MaxAnisotropy = D3D11_MAX_MAXANISOTROPY,
+            .ComparisonFunc = D3D11_COMPARISON_NEVER,
+            .MinLOD = 0.0f,
+            .MaxLOD = D3D11_FLOAT32_MAX,
+        };
+
+        wrl::ComPtr<ID3D11SamplerState> sampler{};
+        throwIfFailed(m_device->CreateSamplerState(&d3dSamplerDesc, &sampler));
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.samplerCount++;
+
+        return addResource(sampler.Get(), Resource{.type = ResourceType::Sampler, .object = sampler});
+    }
+
+    BackendHandle D3D11RenderBackend::createGraphicsPipeline(const BackendPipelineDesc& pipelineDesc)
+    {
+        const std::vector<std::byte> vertexShaderBytecode = m_shaderCache.getShader(ShaderCompileDesc{
+            .path = pipelineDesc.vertexShaderPath,
+            .entryPoint = "VsMain",
+            .target = "vs_5_0",
+            .defines = pipelineDesc.shaderDefines,
+        });
+
+        const std::vector<std::byte> pixelShaderBytecode = m_shaderCache.getShader(ShaderCompileDesc{
+            .path = pipelineDesc.pixelShaderPath,
+            .entryPoint = "PsMain",
+            .target = "ps_5_0",
+            .defines = pipelineDesc.shaderDefines,
+        });
+
+        std::unique_ptr<GraphicsPipeline> pipeline = std::make_unique<GraphicsPipeline>(GraphicsPipeline{
+            .primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+            .vertexSize = pipelineDesc.vertexSize,
+        });
+
+        throwIfFailed(m_device->CreateVertexShader(vertexShaderBytecode.data(), vertexShaderBytecode.size(), nullptr, &pipeline->vertexShader));
+        throwIfFailed(m_device->CreatePixelShader(pixelShaderBytecode.data(), pixelShaderBytecode.size(), nullptr, &pipeline->pixelShader));
+
+        if (!pipelineDesc.vertexAttributes.empty())
+        {
+            std::vector<D3D11_INPUT_ELEMENT_DESC> inputElementDescs{};
+            inputElementDescs.reserve(pipelineDesc.vertexAttributes.size());
+
+            for (const VertexAttribute& attribute : pipelineDesc.vertexAttributes)
+            {
+                inputElementDescs.emplace_back(D3D11_INPUT_ELEMENT_DESC{
+                    .SemanticName = attribute.semanticName.c_str(),
+                    .SemanticIndex = 0u,
+                    .Format = getDxgiFormat(attribute.format),
+                    .InputSlot = 0u,
+                    .AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT,
+                    .InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA,
+                    .InstanceDataStepRate = 0u,
+                });
+            }
+
+            throwIfFailed(m_device->CreateInputLayout(inputElementDescs.data(),
+                                                      static_cast<uint32_t>(inputElementDescs.size()),
+                                                      vertexShaderBytecode.data(),
+                                                      vertexShaderBytecode.size(),
+                                                      &pipeline->inputLayout));
+        }
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.pipelineCount++;
+
+        const BackendHandle handle = pipeline.get();
+        return addResource(handle, Resource{.type = ResourceType::Pipeline, .pipeline = std::move(pipeline)});
+    }
+
+    void D3D11RenderBackend::releaseResource(const BackendHandle handle)
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        const auto resource = m_resources.find(handle);
+        if (resource == m_resources.end())
+        {
+            fatalError("Release of a resource the D3D11 backend did not create, or released twice.");
+        }
+
+        switch (resource->second.type)
+        {
+            case ResourceType::Buffer:
+                m_stats.bufferCount--;
+                m_stats.bufferBytes -= resource->second.size;
+                break;
+            case ResourceType::Texture:
+                m_stats.textureCount--;
+                m_stats.textureBytes -= resource->second.size;
+                break;
+            case ResourceType::RenderTarget:
+                m_stats.renderTargetCount--;
+                m_stats.renderTargetBytes -= resource->second.size;
+                break;
+            case ResourceType::RenderTargetTexture: break;
+            case ResourceType::Sampler: m_stats.samplerCount--; break;
+            case ResourceType::Pipeline: m_stats.pipelineCount--; break;
+        }
+
+        m_resources.erase(resource);
+    }
+
+    void D3D11RenderBackend::updateBuffer(const BackendHandle buffer, std::span<const std::byte> data, const uint32_t offset)
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        const auto resource = m_resources.find(buffer);
+        if (resource == m_resources.end() || resource->second.type != ResourceType::Buffer || offset + data.size() > resource->second.size)
+        {
+            fatalError("Buffer update out of a buffer of the D3D11 backend.");
+        }
+
+        ID3D11Buffer* const d3dBuffer = static_cast<ID3D11Buffer*>(const_cast<void*>(buffer));
+
+        // Constant buffers can only be updated whole.
+        D3D11_BUFFER_DESC bufferDesc{};
+        d3dBuffer->GetDesc(&bufferDesc);
+
+        if (bufferDesc.BindFlags & D3D11_BIND_CONSTANT_BUFFER)
+        {
+            m_deviceContext->UpdateSubresource(d3dBuffer, 0u, nullptr, data.data(), 0u, 0u);
+        }
+        else
+        {
+            const D3D11_BOX box = {
+                .left = offset,
+                .top = 0u,
+                .front = 0u,
+                .right = offset + static_cast<uint32_t>(data.size()),
+                .bottom = 1u,
+                .back = 1u,
+            };
+
+            m_deviceContext->UpdateSubresource(d3dBuffer, 0u, &box, data.data(), 0u, 0u);
+        }
+    }
+
+    void D3D11RenderBackend::submit(std::span<const CommandList> commandLists)
+    {
+        uint64_t commandCount = 0u;
+        uint64_t drawCount = 0u;
+
+        for (const CommandList& commandList : commandLists)
+        {
+            commandCount += commandList.getCommandCount();
+            drawCount += commandList.getDrawCount();
+        }
+
+        if (m_isParallelSubmissionEnabled && commandLists.size() > 1u && commandLists.size() <= m_deferredContexts.size())
+        {
+            const uint32_t commandListCount = static_cast<uint32_t>(commandLists.size());
+            m_deferredCommandLists.resize(commandListCount);
+
+            JobCounter replayCounter{};
+            m_jobSystem.parallelFor(
+                commandListCount,
+                1u,
+                [&](const uint32_t commandListIndex)
+                {
+                    ID3D11DeviceContext* const deferredContext = m_deferredContexts[commandListIndex].Get();
+
+                    replayCommandList(deferredContext, commandLists[commandListIndex]);
+                    throwIfFailed(deferredContext->FinishCommandList(FALSE, &m_deferredCommandLists[commandListIndex]));
+                },
+                replayCounter);
+
+            m_jobSystem.wait(replayCounter);
+
+            // Executing a command list clears the immediate context's state (it is not restored, as every list binds its own).
+            for (wrl::ComPtr<ID3D11CommandList>& deferredCommandList : m_deferredCommandLists)
+            {
+                m_deviceContext->ExecuteCommandList(deferredCommandList.Get(), FALSE);
+                deferredCommandList.Reset();
+            }
+        }
+        else
+        {
+            for (const CommandList& commandList : commandLists)
+            {
+                replayCommandList(m_deviceContext.Get(), commandList);
+            }
+        }
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.submittedCommandListCount += static_cast<uint32_t>(commandLists.size());
+        m_stats.commandCount += commandCount;
+        m_stats.drawCount += drawCount;
+    }
+
+    void D3D11RenderBackend::beginUserInterfaceFrame() { ImGui_ImplDX11_NewFrame(); }
+
+    void D3D11RenderBackend::renderUserInterface()
+    {
+        // The renderer draws into whatever is bound.
+        m_deviceContext->OMSetRenderTargets(1u, m_backBufferRtv.GetAddressOf(), nullptr);
+
+        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    }
+
+    void D3D11RenderBackend::present() { throwIfFailed(m_swapchain->Present(1u, 0u)); }
+
+    RenderBackendStats D3D11RenderBackend::getStats() const
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        return m_stats;
+    }
+
+    void D3D11RenderBackend::createDeviceResources()
+    {
+        // Create the DXGI factory (with debug flags set in debug build).
+        uint32_t factoryCreationFlags = 0u;
+        if constexpr (SGFX_DEBUG)
+        {
+            factoryCreationFlags = DXGI_CREATE_FACTORY_DEBUG;
+        }
+
+        throwIfFailed(::CreateDXGIFactory2(factoryCreationFlags, IID_PPV_ARGS(&m_factory)));
+
+        // Get the adapter with best performance.
+        wrl::ComPtr<IDXGIAdapter1> adapter{};
+        throwIfFailed(m_factory->EnumAdapterByGpuPreference(0u, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&adapter)));
+
+        uint32_t deviceCreationFlags = 0u;
+
+        if constexpr (SGFX_DEBUG)
+        {
+            deviceCreationFlags |= D3D11_CREATE_DEVICE_DEBUG;
+
+            // Display chosen adapter.
+            DXGI_ADAPTER_DESC1 adapterDesc{};
+            throwIfFailed(adapter->GetDesc1(&adapterDesc));
+
+            std::cout << "Chosen Adapter : ";
+            std::wcout << adapterDesc.Description << L'\n';
+        }
+
+        // Create the D3D11 device and device context.
+        throwIfFailed(
+            ::D3D11CreateDevice(adapter.Get(), D3D_DRIVER_TYPE_UNKNOWN, nullptr, deviceCreationFlags, nullptr, 0u, D3D11_SDK_VERSION, &m_device, nullptr, &m_deviceContext));
+
+        if constexpr (SGFX_DEBUG)
+        {
+            // Enable debug layer.
+            throwIfFailed(m_device.As(&m_debug));
+
+            // Setup info queue.
+            throwIfFailed(m_device.As(&m_infoQueue));
+            throwIfFailed(m_infoQueue->SetBreakOnSeverity(D3D11_MESSAGE_SEVERITY_CORRUPTION, true));
+            throwIfFailed(m_infoQueue->SetBreakOnSeverity(D3D11_MESSAGE_SEVERITY_ERROR, true));
+            throwIfFailed(m_infoQueue->SetBreakOnSeverity(D3D11_MESSAGE_SEVERITY_WARNING, true));
+        }
+
+        m_deferredContexts.resize(m_jobSystem.getWorkerCount() + 1u);
+        for (wrl::ComPtr<ID3D11DeviceContext>& deferredContext : m_deferredContexts)
+        {
+            throwIfFailed(m_device->CreateDeferredContext(0u, &deferredContext));
+        }
+    }
+
+    void D3D11RenderBackend::createSwapchainResources(const D3D11RenderBackendCreationDesc& creationDesc)
+    {
+        // Create the swapchain.
+        const DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {
+            .Width = creationDesc.width,
+            .Height = creationDesc.height,
+            .Format = DXGI_FORMAT_R10G10B10A2_UNORM,
+            .SampleDesc = {1u, 0u},
+            .BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT,
+            .BufferCount = 2u,
+            .Scaling = DXGI_SCALING_STRETCH,
+            .SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD,
+            .Flags = 0u,
+        };
+
+        throwIfFailed(m_factory->CreateSwapChainForHwnd(m_device.Get(), creationDesc.windowHandle, &swapChainDesc, nullptr, nullptr, &m_swapchain));
+
+        // Setup the swapchain backbuffer render target view.
+        wrl::ComPtr<ID3D11Texture2D> backBuffer{};
+        throwIfFailed(m_swapchain->GetBuffer(0u, IID_PPV_ARGS(&backBuffer)));
+
+        throwIfFailed(m_device->CreateRenderTargetView(backBuffer.Get(), nullptr, &m_backBufferRtv));
+    }
+
+    BackendHandle D3D11RenderBackend::addResource(const BackendHandle handle, Resource&& resource)
+    {
+        m_resources.emplace(handle, std::move(resource));
+
+        return handle;
+    }
+}
@@ -2,77 +2,181 @@
 
 #include "Engine.hpp"
 
-using namespace math;
+#include "Frustum.hpp"
+#include "VertexQuantization.hpp"
 
-Engine::Engine(const std::string_view windowTitle) : sgfx::Application(windowTitle) {}
+using namespace math;
 
-void Engine::loadContent()
+namespace
 {
-    m_offscreenRT = createRenderTarget(m_windowWidth, m_windowHeight, DXGI_FORMAT_R16G16B16A16_FLOAT);
+    // Height follows the window's aspect ratio.
+    constexpr uint32_t OCCLUSION_BUFFER_WIDTH = 320u;
 
-    m_offscreenSampler = createSampler(sgfx::SamplerCreationDesc{
-        .filter = D3D11_FILTER_MIN_MAG_MIP_POINT,
-        .addressMode = D3D11_TEXTURE_ADDRESS_CLAMP,
-    });
+    // Sort key fields of the geometry pass, the only one drawing the renderables. The pipeline key of an item is offset by the vertex format of
+    // its model, so items sharing a pipeline are drawn together.
+    constexpr uint32_t GEOMETRY_PASS_KEY = 0u;
+    constexpr uint32_t GEOMETRY_PIPELINE_KEY = 0u;
 
-    m_wrapSampler = createSampler(sgfx::SamplerCreationDesc{
-        .filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
-        .addressMode = D3D11_TEXTURE_ADDRESS_WRAP,
-    });
+    // Fewer items are not worth recording on another thread.
+    constexpr uint32_t MIN_ITEMS_PER_COMMAND_LIST = 64u;
+
+    void printModelLoadStats(const std::string_view name, const sgfx::ModelLoadStats& stats)
+    {
+        std::cout << std::format("Loaded model {} in {:.2f} ms ({}).\n", name, stats.loadTimeMs, stats.isCached ? "warm, cooked cache" : "cold, glTF");
+        std::cout << std::format("    Index memory : {:.1f} KiB ({} / {} meshes use 16 bit indices, {:.1f} KiB saved).\n",
+                                 stats.indexBytes / 1024.0,
+                                 stats.shortIndexMeshCount,
+                                 stats.meshCount,
+                                 (stats.fullIndexBytes - stats.indexBytes) / 1024.0);
+
+        if (stats.isCompactVertexFormatRejected)
+        {
+            std::cout << std::format("    Texture coordinates beyond +/-{}, keeping float vertices.\n", sgfx::MAX_COMPACT_TEXTURE_COORD);
+        }
+
+        if (stats.generatedTangentPrimitiveCount > 0u)
+        {
+            std::cout << std::format("    Generated tangents for {} of {} primitives.\n", stats.generatedTangentPrimitiveCount, stats.primitiveCount);
+        }
+
+        if (stats.vertexCacheBefore.triangleCount > 0u)
+        {
+            std::cout << std::format("    Optimized meshes : ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, vertex overfetch {:.3f} -> {:.3f}.\n",
+                                     stats.vertexCacheBefore.getAcmr(),
+                                     stats.vertexCacheAfter.getAcmr(),
+                                     stats.vertexCacheBefore.getAtvr(),
+                                     stats.vertexCacheAfter.getAtvr(),
+                                     stats.vertexFetchBefore.getOverfetch(),
+                                     stats.vertexFetchAfter.getOverfetch());
+        }
 
-    m_ssaoRt = createRenderTarget(m_windowWidth, m_windowHeight, DXGI_FORMAT_R8_UNORM);
-    m_ssaoBlurredRt = createRenderTarget(m_windowWidth, m_windowHeight, DXGI_FORMAT_R8_UNORM);
+        if (stats.meshletCount > 0u)
+        {
+            std::cout << std::format("    Generated {} meshlets ({:.1f} triangles per meshlet, {} with a usable normal cone).\n",
+                                     stats.meshletCount,
+                                     static_cast<double>(stats.meshletTriangleCount) / stats.meshletCount,
+                                     stats.meshletConeCount);
+        }
 
-    m_renderables["cube"] = createModel("assets/models/Cube/glTF/Cube.gltf");
+        if (stats.lodTriangleCounts[0] > 0u)
+        {
+            std::string lodTriangleCountsText{};
+            for (const uint64_t lodTriangleCount : stats.lodTriangleCounts)
+            {
+                lodTriangleCountsText += std::format("{}{}", lodTriangleCountsText.empty() ? "" : " -> ", lodTriangleCount);
+            }
 
-    m_renderables["cube2"] = createModel("assets/models/Cube/glTF/Cube.gltf", sgfx::TransformComponent{.translate = {5.0f, 0.0f, -2.0f}});
+            std::cout << std::format("    Generated LODs : {} triangles.\n", lodTriangleCountsText);
+        }
+    }
+}
 
-    m_renderables["sponza"] = createModel("assets/models/sponza-gltf-pbr/sponza.glb", sgfx::TransformComponent{.scale = {0.1f, 0.1f, 0.1f}});
+Engine::Engine(const std::string_view windowTitle, const sgfx::VertexFormat vertexFormat) : sgfx::Application(windowTitle), m_vertexFormat(vertexFormat) {}
 
-    m_renderables["scifi-helmet"] = createModel("assets/models/SciFiHelmet/glTF/SciFiHelmet.gltf");
+void Engine::loadContent()
+{
+    m_offscreenRT = createRenderTarget(m_windowWidth, m_windowHeight, sgfx::TextureFormat::R16G16B16A16Float);
 
-    m_fullscreenPassPipeline = createGraphicsPipeline(sgfx::GraphicsPipelineCreationDesc{
-        .vertexShaderPath = L"shaders/FullscreenPass.hlsl",
-        .pixelShaderPath = L"shaders/FullscreenPass.hlsl",
-        .primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+    m_offscreenSampler = createSampler(sgfx::BackendSamplerDesc{
+        .filter = sgfx::SamplerFilter::Point,
+        .addressModeU = sgfx::SamplerAddressMode::Clamp,
+        .addressModeV = sgfx::SamplerAddressMode::Clamp,
     });
 
-    m_pipeline = createGraphicsPipeline(sgfx::GraphicsPipelineCreationDesc{
-        .vertexShaderPath = L"shaders/PhongShader.hlsl",
-        .pixelShaderPath = L"shaders/PhongShader.hlsl",
-        .primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+    m_wrapSampler = createSampler(sgfx::BackendSamplerDesc{
+        .filter = sgfx::SamplerFilter::Linear,
+        .addressModeU = sgfx::SamplerAddressMode::Wrap,
+        .addressModeV = sgfx::SamplerAddressMode::Wrap,
     });
 
-    m_ssaoPipeline = createGraphicsPipeline(sgfx::GraphicsPipelineCreationDesc{
-        .vertexShaderPath = L"shaders/SSAO.hlsl",
-        .pixelShaderPath = L"shaders/SSAO.hlsl",
-        .primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+    m_ssaoRt = createRenderTarget(m_windowWidth, m_windowHeight, sgfx::TextureFormat::R8Unorm);
+    m_ssaoBlurredRt = createRenderTarget(m_windowWidth, m_windowHeight, sgfx::TextureFormat::R8Unorm);
 
-    });
+    // Models are loaded in parallel. The map entries are created up front, as the map itself cannot be modified concurrently.
+    sgfx::JobCounter modelLoadCounter{};
+    const sgfx::ScopedJobWait modelLoadWait(m_jobSystem, modelLoadCounter);
 
-    m_boxBlurPipeline = createGraphicsPipeline(sgfx::GraphicsPipelineCreationDesc{
-        .vertexShaderPath = L"shaders/BoxBlur.hlsl",
-        .pixelShaderPath = L"shaders/BoxBlur.hlsl",
-        .primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+    const auto loadModel = [&](sgfx::Model& model, const std::string_view modelPath, const sgfx::TransformComponent& transformData = {})
+    {
+        m_jobSystem.submit([&model, modelPath, transformData, this]() { model = createModel(modelPath, transformData, sgfx::ModelLoadOptions{.generateMeshlets = true, .generateLods = true, .vertexFormat = m_vertexFormat, .buildCollisionBvhs = true}); },
+                           modelLoadCounter);
+    };
+
+    loadModel(m_renderables["cube"], "assets/models/Cube/glTF/Cube.gltf");
+
+    loadModel(m_renderables["cube2"], "assets/models/Cube/glTF/Cube.gltf", sgfx::TransformComponent{.translate = {5.0f, 0.0f, -2.0f}});
+
+    loadModel(m_renderables["sponza"], "assets/models/sponza-gltf-pbr/sponza.glb", sgfx::TransformComponent{.scale = {0.1f, 0.1f, 0.1f}});
+
+    loadModel(m_renderables["scifi-helmet"], "assets/models/SciFiHelmet/glTF/SciFiHelmet.gltf");
+
+    loadModel(m_lightModel, "assets/models/Cube/glTF/Cube.gltf");
+
+    // Every shader is compiled (or loaded from the shader cache) in parallel, alongside the model loads.
+    std::vector<sgfx::BackendPipelineDesc> pipelineDescs = {
+        sgfx::BackendPipelineDesc{
+            .vertexShaderPath = L"shaders/FullscreenPass.hlsl",
+            .pixelShaderPath = L"shaders/FullscreenPass.hlsl",
+        },
+        sgfx::BackendPipelineDesc{
+            .vertexShaderPath = L"shaders/PhongShader.hlsl",
+            .pixelShaderPath = L"shaders/PhongShader.hlsl",
+        },
+        sgfx::BackendPipelineDesc{
+            .vertexShaderPath = L"shaders/SSAO.hlsl",
+            .pixelShaderPath = L"shaders/SSAO.hlsl",
+        },
+        sgfx::BackendPipelineDesc{
+            .vertexShaderPath = L"shaders/BoxBlur.hlsl",
+            .pixelShaderPath = L"shaders/BoxBlur.hlsl",
+        },
+    };
+
+    // Pipelines that consume model vertices must match the vertex format of the model they draw. Float ones are always needed, as models fall
+    // back to float vertices when compact ones would lose too much precision.
+    std::vector<sgfx::VertexFormat> modelVertexFormats = {sgfx::VertexFormat::Float};
+    if (m_vertexFormat == sgfx::VertexFormat::Compact)
+    {
+        modelVertexFormats.push_back(sgfx::VertexFormat::Compact);
+    }
 
-    });
+    for (const sgfx::VertexFormat vertexFormat : modelVertexFormats)
+    {
+        const std::vector<std::string> shaderDefines = vertexFormat == sgfx::VertexFormat::Compact ? std::vector<std::string>{"COMPACT_VERTEX"} : std::vector<std::string>{};
+
+        pipelineDescs.push_back(sgfx::BackendPipelineDesc{
+            .vertexShaderPath = L"shaders/LightShader.hlsl",
+            .pixelShaderPath = L"shaders/LightShader.hlsl",
+            .shaderDefines = shaderDefines,
+            .vertexAttributes = sgfx::getModelVertexAttributes(vertexFormat),
+            .vertexSize = sgfx::getVertexSize(vertexFormat),
+        });
+
+        pipelineDescs.push_back(sgfx::BackendPipelineDesc{
+            .vertexShaderPath = L"shaders/GPass.hlsl",
+            .pixelShaderPath = L"shaders/GPass.hlsl",
+            .shaderDefines = shaderDefines,
+            .vertexAttributes = sgfx::getModelVertexAttributes(vertexFormat),
+            .vertexSize = sgfx::getVertexSize(vertexFormat),
+        });
+    }
 
-    m_lightPipeline = createGraphicsPipeline(sgfx::GraphicsPipelineCreationDesc{
-        .vertexShaderPath = L"shaders/LightShader.hlsl",
-        .pixelShaderPath = L"shaders/LightShader.hlsl",
-        .inputLayoutElements =
-            {
-                sgfx::InputLayoutElementDesc{.semanticName = "Position", .format = DXGI_FORMAT_R32G32B32_FLOAT, .inputClassification = D3D11_INPUT_PER_VERTEX_DATA},
-                sgfx::InputLayoutElementDesc{.semanticName = "TextureCoord", .format = DXGI_FORMAT_R32G32_FLOAT, .inputClassification = D3D11_INPUT_PER_VERTEX_DATA},
-                sgfx::InputLayoutElementDesc{.semanticName = "Normal", .format = DXGI_FORMAT_R32G32B32_FLOAT, .inputClassification = D3D11_INPUT_PER_VERTEX_DATA},
-            },
-        .primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
-        .vertexSize = sizeof(sgfx::ModelVertex),
-    });
+    std::vector<sgfx::BackendResource> pipelines = createGraphicsPipelines(pipelineDescs);
 
-    m_sceneBuffer = createConstantBuffer<sgfx::SceneBuffer>();
+    m_fullscreenPassPipeline = std::move(pipelines[0]);
+    m_pipeline = std::move(pipelines[1]);
+    m_ssaoPipeline = std::move(pipelines[2]);
+    m_boxBlurPipeline = std::move(pipelines[3]);
 
-    m_lightModel = createModel("assets/models/Cube/glTF/Cube.gltf");
+    for (const size_t formatIndex : std::views::iota(size_t{0u}, modelVertexFormats.size()))
+    {
+        const size_t vertexFormat = static_cast<size_t>(modelVertexFormats[formatIndex]);
+
+        m_lightPipelines[vertexFormat] = std::move(pipelines[4u + 2u * formatIndex]);
+        m_gpassPipelines[vertexFormat] = std::move(pipelines[5u + 2u * formatIndex]);
+    }
+
+    m_sceneBuffer = createConstantBuffer<sgfx::SceneBuffer>();
 
     math::XMFLOAT4 position = math::XMFLOAT4(2.2f, 2.2f, -0.5f, 1.0f);
 
@@ -94,22 +198,9 @@ void Engine::loadContent()
 
     m_gpassDepthTexture = createDepthTexture();
 
-    m_gpassRts[0] = createRenderTarget(m_windowWidth, m_windowHeight, DXGI_FORMAT_R8G8B8A8_UNORM);
-    m_gpassRts[1] = createRenderTarget(m_windowWidth, m_windowHeight, DXGI_FORMAT_R32G32B32A32_FLOAT);
-    m_gpassRts[2] = createRenderTarget(m_windowWidth, m_windowHeight, DXGI_FORMAT_R32G32B32A32_FLOAT);
-
-    m_gpassPipeline = createGraphicsPipeline(sgfx::GraphicsPipelineCreationDesc{
-        .vertexShaderPath = L"shaders/GPass.hlsl",
-        .pixelShaderPath = L"shaders/GPass.hlsl",
-        .inputLayoutElements =
-            {
-                sgfx::InputLayoutElementDesc{.semanticName = "Position", .format = DXGI_FORMAT_R32G32B32_FLOAT, .inputClassification = D3D11_INPUT_PER_VERTEX_DATA},
-                sgfx::InputLayoutElementDesc{.semanticName = "TextureCoord", .format = DXGI_FORMAT_R32G32_FLOAT, .inputClassification = D3D11_INPUT_PER_VERTEX_DATA},
-                sgfx::InputLayoutElementDesc{.semanticName = "Normal", .format = DXGI_FORMAT_R32G32B32_FLOAT, .inputClassification = D3D11_INPUT_PER_VERTEX_DATA},
-            },
-        .primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
-        .vertexSize = sizeof(sgfx::ModelVertex),
-    });
+    m_gpassRts[0] = createRenderTarget(m_windowWidth, m_windowHeight, sgfx::TextureFormat::R8G8B8A8Unorm);
+    m_gpassRts[1] = createRenderTarget(m_windowWidth, m_windowHeight, sgfx::TextureFormat::R32G32B32A32Float);
+    m_gpassRts[2] = createRenderTarget(m_windowWidth, m_windowHeight, sgfx::TextureFormat::R32G32B32A32Float);
 
     m_gpassDepthTexture = createDepthTexture();
 
@@ -148,27 +239,69 @@ void Engine::loadContent()
     // Generate the noise kernel.
     // Contents are used to randomly rotate the kernel vectors.
     // Z component not taken into account as it will always be 0 (i.e we want rotation around the z axis).
-    std::array<math::XMFLOAT2, 64> noiseTextureData{};
     for (const uint32_t i : std::views::iota(0u, 64u))
     {
-        noiseTextureData[i] = math::XMFLOAT2{randomUnitFloatDistribution(generator) * 2.0f - 1.0f, randomUnitFloatDistribution(generator) * 2.0f - 1.0f};
+        m_ssaoNoise[i] = math::XMFLOAT2{randomUnitFloatDistribution(generator) * 2.0f - 1.0f, randomUnitFloatDistribution(generator) * 2.0f - 1.0f};
     }
 
-    m_ssaoRandomRotationTexture = createTexture<math::XMFLOAT2>(noiseTextureData, 8u, 8u, DXGI_FORMAT_R32G32_FLOAT);
-}
+    m_ssaoRandomRotationTexture = createTexture<math::XMFLOAT2>(m_ssaoNoise, 8u, 8u, sgfx::TextureFormat::R32G32Float);
 
-void Engine::update(const float deltaTime)
-{
-    m_camera.update(deltaTime);
+    m_jobSystem.wait(modelLoadCounter);
 
-    const math::XMMATRIX viewMatrix = m_camera.getLookAtMatrix();
-    const math::XMMATRIX projectionMatrix = math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(45.0f), m_windowWidth / static_cast<float>(m_windowHeight), 0.1f, 230.0f);
+    // Map nodes are never moved, so the scene BVH can point to the renderables directly.
+    std::vector<sgfx::Model*> sceneModels{};
+    for (auto& [name, renderable] : m_renderables)
+    {
+        m_sceneModelNames.emplace_back(name);
+        sceneModels.emplace_back(&renderable);
+    }
 
-    m_sceneBuffer.data.viewMatrix = viewMatrix;
-    m_sceneBuffer.data.viewProjectionMatrix = viewMatrix * projectionMatrix;
+    // Reported once every load is done, as models load in parallel.
+    for (const std::string& name : m_sceneModelNames)
+    {
+        printModelLoadStats(name, m_renderables.at(name).getLoadStats());
+    }
 
-    m_ssaoBuffer.data.projectionMatrix = projectionMatrix;
+    printModelLoadStats("light", m_lightModel.getLoadStats());
+
+    m_sceneBvh.build(sceneModels);
+    std::cout << std::format("Scene BVH : {} meshes, {} nodes.\n", m_sceneBvh.getMeshCount(), m_sceneBvh.getBvh().getNodeCount());
+
+    m_occlusionBuffer.resize(OCCLUSION_BUFFER_WIDTH, std::max(OCCLUSION_BUFFER_WIDTH * m_windowHeight / m_windowWidth, 1u));
+
+    const sgfx::TextureCacheStats textureCacheStats = m_textureCache->getStats();
+    std::cout << std::format("Texture cache : {} textures ({:.1f} MB, {} streamed) for {} requests, hit rate {:.2f}, {:.1f} MB not loaded again, {} cooked, {} uncompressed.\n",
+                             textureCacheStats.residentTextureCount,
+                             textureCacheStats.residentBytes / (1024.0 * 1024.0),
+                             textureCacheStats.streaming.textureCount,
+                             textureCacheStats.requestCount,
+                             textureCacheStats.getHitRate(),
+                             textureCacheStats.bytesSaved / (1024.0 * 1024.0),
+                             textureCacheStats.cookedTextureCount,
+                             textureCacheStats.uncompressedTextureCount);
+
+    if (textureCacheStats.cookedTextureCount > 0u)
+    {
+        std::cout << std::format("    Cooked textures : {:.1f} MB, lowest PSNR {:.2f} dB, {:.1f} ms of cooking.\n",
+                                 textureCacheStats.cookedBytes / (1024.0 * 1024.0),
+                                 textureCacheStats.lowestCookedPsnr,
+                                 textureCacheStats.cookTimeMs);
+    }
 
+    // Only the D3D11 backend compiles shaders.
+    if (m_shaderCache)
+    {
+        const sgfx::ShaderCacheStats shaderCacheStats = m_shaderCache->getStats();
+        std::cout << std::format("Shader cache : {} shaders, {} loaded from the cache, {} compiled ({:.1f} ms).\n",
+                                 shaderCacheStats.requestCount,
+                                 shaderCacheStats.hitCount,
+                                 shaderCacheStats.compileCount,
+                                 shaderCacheStats.compileTimeMs);
+    }
+}
+
+void Engine::updateLights(const math::XMMATRIX viewMatrix)
+{
     // Update scene buffer for non directional lights.
     for (const uint32_t i : std::views::iota(1u, sgfx::LIGHT_COUNT))
     {
@@ -188,6 +321,39 @@ void Engine::update(const float deltaTime)
 
         math::XMStoreFloat4(&m_sceneBuffer.data.viewSpaceLightPosition[0], viewSpaceLightPosition);
     }
+}
+
+void Engine::update(const float deltaTime)
+{
+    SGFX_PROFILE_ZONE("Update");
+
+    m_camera.update(deltaTime);
+
+    if (m_isRecordingCameraPath)
+    {
+        m_cameraPath.emplace_back(CameraPathFrame{
+            .position = m_camera.m_cameraPosition,
+            .pitch = m_camera.m_pitch,
+            .yaw = m_camera.m_yaw,
+        });
+    }
+
+    // Run before this frame's LOD selection and culling, as the benchmark overwrites the results of every model.
+    if (m_isCameraPathBenchmarkRequested)
+    {
+        runCameraPathBenchmark();
+        m_isCameraPathBenchmarkRequested = false;
+    }
+
+    const math::XMMATRIX viewMatrix = m_camera.getLookAtMatrix();
+    const math::XMMATRIX projectionMatrix = getProjectionMatrix();
+
+    m_sceneBuffer.data.viewMatrix = viewMatrix;
+    m_sceneBuffer.data.viewProjectionMatrix = viewMatrix * projectionMatrix;
+
+    m_ssaoBuffer.data.projectionMatrix = projectionMatrix;
+
+    updateLights(viewMatrix);
 
     updateConstantBuffer(m_sceneBuffer);
     updateConstantBuffer(m_lightMatricesBuffer);
@@ -195,174 +361,413 @@ void Engine::update(const float deltaTime)
 
     for (auto& [name, renderable] : m_renderables)
     {
-        renderable.updateTransformBuffer(viewMatrix, m_deviceContext.Get());
+        renderable.updateTransformBuffer(viewMatrix, *m_renderBackend);
     }
 
+    // Only refits when a renderable moved.
+    m_sceneBvh.update();
+
+    // LOD selection and meshlet culling use the model matrices set above. Culling depends on the selected LODs, so it runs last.
+    const math::XMFLOAT3 cameraPosition = {m_camera.m_cameraPosition.x, m_camera.m_cameraPosition.y, m_camera.m_cameraPosition.z};
+
+    m_lodSelectionStats = selectLods(cameraPosition);
+
+    streamTextures(cameraPosition);
+
+    m_meshletCullingStats = {};
+
+    const sgfx::Frustum frustum = sgfx::createFrustum(viewMatrix * projectionMatrix);
+
+    // Meshlet culling skips the meshes rejected here.
+    m_meshCullingStats = cullMeshes(frustum);
+    cullOccludedMeshes(viewMatrix * projectionMatrix, m_meshCullingStats);
+
+    {
+        SGFX_PROFILE_ZONE("Meshlet culling");
+
+        for (auto& [name, renderable] : m_renderables)
+        {
+            if (m_isMeshletCullingEnabled)
+            {
+                m_meshletCullingStats += renderable.cullMeshlets(frustum, cameraPosition);
+            }
+            else
+            {
+                renderable.clearMeshletCulling();
+            }
+        }
+    }
+
+    collectRenderItems(cameraPosition);
 }
 
-void Engine::render()
+void Engine::collectRenderItems(const math::XMFLOAT3& cameraPosition)
 {
-    // Start the Dear ImGui frame
-    ImGui_ImplDX11_NewFrame();
-    ImGui_ImplSDL2_NewFrame();
-    ImGui::NewFrame();
+    SGFX_PROFILE_ZONE("Render item collection");
 
-    ImGui::Begin("Scene menu");
-    ImGui::SliderFloat("camera mvmt speed", &m_camera.m_movementSpeed, 0.1f, 50.0f);
-    ImGui::SliderFloat("camera rotation speed", &m_camera.m_rotationSpeed, 0.1f, 3.0f);
+    const auto startTime = std::chrono::high_resolution_clock::now();
 
-    ImGui::SliderFloat("ssao radius", &m_ssaoBuffer.data.radius, 0.0f, 10.0f);
-    ImGui::SliderFloat("ssao bias", &m_ssaoBuffer.data.bias, 0.0f, 10.0f);
-    ImGui::SliderFloat("ssao power", &m_ssaoBuffer.data.power, 0.0f, 10.0f);
+    m_renderQueue.clear();
 
-    for (auto& [name, renderable] : m_renderables)
+    uint32_t firstMaterialKey = 0u;
+    for (const auto& [name, renderable] : m_renderables)
     {
-        if (ImGui::TreeNode(name.c_str()))
+        const sgfx::RenderItemGatherDesc gatherDesc = {
+            .pass = GEOMETRY_PASS_KEY,
+            .pipeline = GEOMETRY_PIPELINE_KEY + static_cast<uint32_t>(renderable.getVertexFormat()),
+            .firstMaterialKey = firstMaterialKey,
+            .cameraPosition = cameraPosition,
+        };
+
+        renderable.gatherRenderItems(gatherDesc, m_renderQueue);
+        firstMaterialKey += renderable.getMaterialCount();
+    }
+
+    m_renderQueue.sort();
+
+    const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+    m_renderQueueDuration = duration.count();
+}
+
+void Engine::recordGeometryPass()
+{
+    SGFX_PROFILE_ZONE("Geometry pass recording");
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    const std::span<const sgfx::RenderItem> items = m_renderQueue.getItems();
+    const uint32_t itemCount = static_cast<uint32_t>(items.size());
+
+    // At most one list per thread, which is also the number of lists the D3D11 backend translates in parallel.
+    const uint32_t commandListCount = std::clamp((itemCount + MIN_ITEMS_PER_COMMAND_LIST - 1u) / MIN_ITEMS_PER_COMMAND_LIST, 1u, m_jobSystem.getWorkerCount() + 1u);
+
+    m_geometryCommandLists.resize(commandListCount);
+
+    const sgfx::SetRenderTargetsCommand renderTargetsCommand = {
+        .renderTargets = {m_gpassRts[0].renderTarget.get(), m_gpassRts[1].renderTarget.get(), m_gpassRts[2].renderTarget.get()},
+        .depthStencil = m_gpassDepthTexture.renderTarget.get(),
+        .renderTargetCount = 3u,
+    };
+
+    std::vector<sgfx::DrawSubmissionStats> commandListStats(commandListCount);
+
+    sgfx::JobCounter recordingCounter{};
+    m_jobSystem.parallelFor(
+        commandListCount,
+        1u,
+        [&](const uint32_t commandListIndex)
         {
-            ImGui::SliderFloat3("position", &renderable.getTransformComponent()->translate.x, -25.0f, 25.0f);
-            ImGui::SliderFloat("scale", &renderable.getTransformComponent()->scale.x, 0.1f, 10.0f);
-            ImGui::SliderFloat3("rotation", &renderable.getTransformComponent()->rotation.x, math::XMConvertToRadians(-90.0f), math::XMConvertToRadians(90.0f));
+            sgfx::CommandList& commandList = m_geometryCommandLists[commandListIndex];
+            commandList.reset();
 
-            renderable.getTransformComponent()->scale.y = renderable.getTransformComponent()->scale.x;
-            renderable.getTransformComponent()->scale.z = renderable.getTransformComponent()->scale.x;
+            // Every list starts from nothing bound, so every list sets up the pass.
+            commandList.record(renderTargetsCommand);
+            commandList.record(m_viewport);
+            commandList.record(sgfx::SetConstantBufferCommand{.buffer = m_sceneBuffer.buffer.get(), .stage = sgfx::ShaderStage::Vertex, .slot = 0u});
+            commandList.record(sgfx::SetConstantBufferCommand{.buffer = m_sceneBuffer.buffer.get(), .stage = sgfx::ShaderStage::Pixel, .slot = 0u});
 
-            ImGui::TreePop();
-        }
+            const uint32_t firstItem = static_cast<uint32_t>(uint64_t{itemCount} * commandListIndex / commandListCount);
+            const uint32_t lastItem = static_cast<uint32_t>(uint64_t{itemCount} * (commandListIndex + 1u) / commandListCount);
+
+            sgfx::DrawState drawState{};
+            std::optional<sgfx::VertexFormat> boundVertexFormat{};
+            for (const sgfx::RenderItem& item : items.subspan(firstItem, lastItem - firstItem))
+            {
+                // Items are sorted by pipeline, so this switches at most once per list.
+                if (item.model->getVertexFormat() != boundVertexFormat)
+                {
+                    boundVertexFormat = item.model->getVertexFormat();
+                    commandList.record(sgfx::SetPipelineCommand{.pipeline = m_gpassPipelines[static_cast<size_t>(*boundVertexFormat)].get()});
+                }
+
+                item.model->recordMesh(commandList, item.meshIndex, drawState);
+            }
+
+            commandListStats[commandListIndex] = drawState.stats;
+        },
+        recordingCounter);
+
+    m_jobSystem.wait(recordingCounter);
+
+    m_drawSubmissionStats = {};
+    for (const sgfx::DrawSubmissionStats& stats : commandListStats)
+    {
+        m_drawSubmissionStats += stats;
     }
 
-    if (ImGui::TreeNode("light properties"))
+    const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+    m_commandRecordingDuration = duration.count();
+}
+
+void Engine::submitGeometryPass()
+{
+    SGFX_PROFILE_ZONE("Geometry pass submission");
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    m_renderBackend->submit(m_geometryCommandLists);
+
+    const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+    m_commandSubmissionDuration = duration.count();
+}
+
+sgfx::MeshCullingStats Engine::cullMeshes(const sgfx::Frustum& frustum)
+{
+    SGFX_PROFILE_ZONE("Mesh culling");
+
+    sgfx::MeshCullingStats stats{};
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    for (auto& [name, renderable] : m_renderables)
     {
-        if (ImGui::TreeNode("Directional light"))
+        if (m_isMeshCullingEnabled)
         {
-            ImGui::SliderFloat("sun Angle", &m_sunAngle, -180.0f, 180.0f);
-            ImGui::SliderFloat3("dir light color", &m_sceneBuffer.data.lightColorIntensity[0].x, 0.0f, 1.0f);
-            ImGui::SliderFloat("dir light intensity", &m_sceneBuffer.data.lightColorIntensity[0].w, 0.0f, 30.0f);
-
-            ImGui::TreePop();
+            stats += renderable.cullMeshes(frustum);
         }
-
-        for (const uint32_t i : std::views::iota(1u, sgfx::LIGHT_COUNT))
+        else
         {
-            if (ImGui::TreeNode((std::string("Point Light") + std::to_string(i)).c_str()))
-            {
-                ImGui::ColorPicker3("light color", &m_sceneBuffer.data.lightColorIntensity[i].x);
-                ImGui::SliderFloat("Intensity", &m_sceneBuffer.data.lightColorIntensity[i].w, 0.1f, 30.0f);
+            renderable.clearMeshCulling();
+        }
+    }
 
-                ImGui::SliderFloat3("position", &m_lightPositions[i - 1].x, -25.0f, 25.0f);
+    const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+    m_meshCullingDuration = duration.count();
 
-                ImGui::TreePop();
-            }
-        }
+    return stats;
+}
 
-        ImGui::TreePop();
+void Engine::cullOccludedMeshes(const math::XMMATRIX viewProjectionMatrix, sgfx::MeshCullingStats& stats)
+{
+    SGFX_PROFILE_ZONE("Occlusion culling");
+
+    if (!m_isOcclusionCullingEnabled)
+    {
+        m_occlusionRasterizationStats = {};
+        m_occlusionCullingDuration = 0.0;
+        return;
     }
 
-    ImGui::End();
+    const auto startTime = std::chrono::high_resolution_clock::now();
 
-    ImGui::Begin("SSAO RT");
-    ImGui::Image(m_ssaoRt.srv.Get(), {300, 300});
-    ImGui::End();
+    m_occluders.clear();
+    for (const auto& [name, renderable] : m_renderables)
+    {
+        renderable.gatherOccluders(m_occluderSelectionDesc, m_occluders);
+    }
 
-    ImGui::Begin("SSAO Blurred RT");
-    ImGui::Image(m_ssaoBlurredRt.srv.Get(), {300, 300});
-    ImGui::End();
+    m_occlusionRasterizationStats = m_occlusionBuffer.rasterize(m_occluders, viewProjectionMatrix, m_jobSystem);
 
-    auto& ctx = m_deviceContext;
+    for (auto& [name, renderable] : m_renderables)
+    {
+        const uint32_t occludedMeshCount = renderable.cullOccludedMeshes(m_occlusionBuffer);
 
-    constexpr std::array<float, 4> clearColor{0.0f, 0.0f, 0.0f, 1.0f};
+        stats.visibleMeshCount -= occludedMeshCount;
+        stats.occludedMeshCount += occludedMeshCount;
+    }
 
-    ctx->ClearDepthStencilView(m_depthTexture.dsv.Get(), D3D11_CLEAR_DEPTH, 1.0f, 1u);
-    ctx->ClearDepthStencilView(m_gpassDepthTexture.dsv.Get(), D3D11_CLEAR_DEPTH, 1.0f, 1u);
+    const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+    m_occlusionCullingDuration = duration.count();
+}
 
-    ctx->ClearRenderTargetView(m_renderTargetView.Get(), clearColor.data());
-    ctx->ClearRenderTargetView(m_renderTargetView.Get(), clearColor.data());
-    ctx->ClearRenderTargetView(m_ssaoRt.rtv.Get(), clearColor.data());
+math::XMMATRIX Engine::getProjectionMatrix() const
+{
+    return math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(VERTICAL_FIELD_OF_VIEW), m_windowWidth / static_cast<float>(m_windowHeight), 0.1f, 230.0f);
+}
+
+sgfx::LodSelectionStats Engine::selectLods(const math::XMFLOAT3& cameraPosition)
+{
+    SGFX_PROFILE_ZONE("LOD selection");
 
-    std::array<ID3D11ShaderResourceView*, 4> nullSrvs{nullptr, nullptr, nullptr, nullptr};
+    sgfx::LodSelectionStats stats{};
 
-    for (auto& renderTarget : m_gpassRts)
+    const sgfx::LodSelectionDesc lodSelectionDesc = {
+        .cameraPosition = cameraPosition,
+        .projectionScale = m_windowHeight / (2.0f * std::tan(math::XMConvertToRadians(VERTICAL_FIELD_OF_VIEW) * 0.5f)),
+        .errorThreshold = m_lodErrorThreshold,
+    };
+
+    for (auto& [name, renderable] : m_renderables)
     {
-        ctx->ClearRenderTargetView(renderTarget.rtv.Get(), clearColor.data());
+        if (m_isLodSelectionEnabled)
+        {
+            renderable.selectLods(lodSelectionDesc);
+        }
+        else
+        {
+            renderable.resetLods();
+        }
+
+        stats += renderable.getLodSelectionStats();
     }
 
-    // Render the Geometry pass.
-    const std::array<ID3D11RenderTargetView*, 3u> gpassRtvs{m_gpassRts[0].rtv.Get(), m_gpassRts[1].rtv.Get(), m_gpassRts[2].rtv.Get()};
-    ctx->OMSetRenderTargets(3u, gpassRtvs.data(), m_gpassDepthTexture.dsv.Get());
-    ctx->RSSetViewports(1u, &m_viewport);
+    return stats;
+}
+
+void Engine::streamTextures(const math::XMFLOAT3& cameraPosition)
+{
+    SGFX_PROFILE_ZONE("Texture streaming");
+
+    const sgfx::TextureStreamingDesc textureStreamingDesc = {
+        .cameraPosition = cameraPosition,
+        .projectionScale = m_windowHeight / (2.0f * std::tan(math::XMConvertToRadians(VERTICAL_FIELD_OF_VIEW) * 0.5f)),
+    };
+
+    for (const auto& [name, renderable] : m_renderables)
+    {
+        renderable.requestTextureMips(*m_textureCache, textureStreamingDesc);
+    }
 
-    bindPipeline(m_gpassPipeline);
-    ctx->VSSetConstantBuffers(0u, 1u, m_sceneBuffer.buffer.GetAddressOf());
-    ctx->PSSetConstantBuffers(0u, 1u, m_sceneBuffer.buffer.GetAddressOf());
+    m_textureCache->updateStreaming();
 
     for (auto& [name, renderable] : m_renderables)
     {
-        renderable.render(ctx.Get());
+        renderable.updateMaterialTextures();
     }
 
-    // SSAO pass.
-    ctx->OMSetRenderTargets(1u, m_ssaoRt.rtv.GetAddressOf(), nullptr);
-    bindPipeline(m_ssaoPipeline);
+    m_lightModel.updateMaterialTextures();
+}
 
-    ctx->VSSetConstantBuffers(0u, 1u, m_sceneBuffer.buffer.GetAddressOf());
-    ctx->PSSetConstantBuffers(0u, 1u, m_sceneBuffer.buffer.GetAddressOf());
-    ctx->PSSetConstantBuffers(1u, 1u, m_ssaoBuffer.buffer.GetAddressOf());
-    ctx->PSSetSamplers(0u, 1u, m_offscreenSampler.GetAddressOf());
-    ctx->PSSetSamplers(1u, 1u, m_wrapSampler.GetAddressOf());
+void Engine::pickMesh(const float x, const float y)
+{
+    const sgfx::Ray ray = m_camera.getScreenRay(x, y, static_cast<float>(m_windowWidth), static_cast<float>(m_windowHeight), getProjectionMatrix());
+    const sgfx::ScenePickResult result = m_sceneBvh.pick(ray);
 
-    const std::array<ID3D11ShaderResourceView* const, 3u> ssaoShaderTextures{m_ssaoRandomRotationTexture.Get(), m_gpassRts[1].srv.Get(), m_gpassRts[2].srv.Get()};
+    if (!result.isHit())
+    {
+        m_pickResult = "Nothing picked.";
+        return;
+    }
 
-    ctx->PSSetShaderResources(0u, 3u, ssaoShaderTextures.data());
+    m_pickResult = std::format("{} mesh {} at ({:.2f}, {:.2f}, {:.2f}).",
+                               m_sceneModelNames[result.mesh.modelIndex],
+                               result.mesh.meshIndex,
+                               result.position.x,
+                               result.position.y,
+                               result.position.z);
+}
 
-    ctx->Draw(3u, 0u);
+void Engine::renderHeadless() { renderFrame(); }
 
-    // Apply box blur filter on SSAO texture.
+void Engine::renderFrame()
+{
+    constexpr std::array<float, 4> clearColor{0.0f, 0.0f, 0.0f, 1.0f};
 
-    ctx->OMSetRenderTargets(1u, m_ssaoBlurredRt.rtv.GetAddressOf(), nullptr);
-    bindPipeline(m_boxBlurPipeline);
+    {
+        SGFX_PROFILE_ZONE("Clear");
 
-    ctx->PSSetShaderResources(0u, 1u, nullSrvs.data());
+        m_frameCommandList.reset();
 
-    ctx->PSSetShaderResources(0u, 1u, m_ssaoRt.srv.GetAddressOf());
-    ctx->Draw(3u, 0u);
+        m_frameCommandList.record(sgfx::ClearDepthStencilCommand{.depthStencil = m_depthTexture.renderTarget.get()});
+        m_frameCommandList.record(sgfx::ClearDepthStencilCommand{.depthStencil = m_gpassDepthTexture.renderTarget.get()});
 
-    // Shading pass.
-    ctx->OMSetRenderTargets(1u, m_offscreenRT.rtv.GetAddressOf(), nullptr);
+        m_frameCommandList.record(sgfx::ClearRenderTargetCommand{.renderTarget = m_renderBackend->getBackBuffer(), .color = clearColor});
+        m_frameCommandList.record(sgfx::ClearRenderTargetCommand{.renderTarget = m_ssaoRt.renderTarget.get(), .color = clearColor});
+
+        for (const sgfx::RenderTarget& renderTarget : m_gpassRts)
+        {
+            m_frameCommandList.record(sgfx::ClearRenderTargetCommand{.renderTarget = renderTarget.renderTarget.get(), .color = clearColor});
+        }
+
+        m_renderBackend->submit(m_frameCommandList);
+    }
+
+    // Render the Geometry pass. Sorted by material and then front to back, so textures and samplers are bound once per run of items and early
+    // depth testing rejects most hidden pixels.
+    {
+        SGFX_PROFILE_ZONE("Geometry pass");
 
-    bindPipeline(m_pipeline);
+        recordGeometryPass();
+        submitGeometryPass();
+    }
+
+    m_frameCommandList.reset();
+
+    const auto recordPixelShaderTextures = [&](const std::span<const sgfx::BackendHandle> textures)
+    {
+        for (const uint32_t slot : std::views::iota(0u, static_cast<uint32_t>(textures.size())))
+        {
+            m_frameCommandList.record(sgfx::SetShaderResourceCommand{.resource = textures[slot], .stage = sgfx::ShaderStage::Pixel, .slot = slot});
+        }
+    };
+
+    // SSAO pass. The list starts from nothing bound, so the viewport is set again.
+    {
+        SGFX_PROFILE_ZONE("SSAO pass");
 
-    const std::array<ID3D11ShaderResourceView*, 4u> lightingPassSrvs{m_gpassRts[0].srv.Get(), m_gpassRts[1].srv.Get(), m_gpassRts[2].srv.Get(), m_ssaoBlurredRt.srv.Get()};
+        m_frameCommandList.record(sgfx::SetRenderTargetsCommand{.renderTargets = {m_ssaoRt.renderTarget.get()}, .renderTargetCount = 1u});
+        m_frameCommandList.record(m_viewport);
+        m_frameCommandList.record(sgfx::SetPipelineCommand{.pipeline = m_ssaoPipeline.get()});
 
-    ctx->VSSetConstantBuffers(0u, 1u, m_sceneBuffer.buffer.GetAddressOf());
-    ctx->PSSetConstantBuffers(0u, 1u, m_sceneBuffer.buffer.GetAddressOf());
+        m_frameCommandList.record(sgfx::SetConstantBufferCommand{.buffer = m_sceneBuffer.buffer.get(), .stage = sgfx::ShaderStage::Vertex, .slot = 0u});
+        m_frameCommandList.record(sgfx::SetConstantBufferCommand{.buffer = m_sceneBuffer.buffer.get(), .stage = sgfx::ShaderStage::Pixel, .slot = 0u});
+        m_frameCommandList.record(sgfx::SetConstantBufferCommand{.buffer = m_ssaoBuffer.buffer.get(), .stage = sgfx::ShaderStage::Pixel, .slot = 1u});
+        m_frameCommandList.record(sgfx::SetSamplerCommand{.sampler = m_offscreenSampler.get(), .stage = sgfx::ShaderStage::Pixel, .slot = 0u});
+        m_frameCommandList.record(sgfx::SetSamplerCommand{.sampler = m_wrapSampler.get(), .stage = sgfx::ShaderStage::Pixel, .slot = 1u});
 
-    ctx->PSSetShaderResources(0u, 4u, lightingPassSrvs.data());
-    ctx->Draw(3u, 0u);
+        recordPixelShaderTextures(std::array{m_ssaoRandomRotationTexture.get(), m_gpassRts[1].texture.get(), m_gpassRts[2].texture.get()});
 
-    ctx->OMSetRenderTargets(1u, m_offscreenRT.rtv.GetAddressOf(), m_gpassDepthTexture.dsv.Get());
-    ctx->RSSetViewports(1u, &m_viewport);
+        m_frameCommandList.record(sgfx::DrawCommand{.vertexCount = 3u});
+    }
 
-    bindPipeline(m_lightPipeline);
+    // Apply box blur filter on SSAO texture. Its render target is unbound first, so it can be sampled.
+    {
+        SGFX_PROFILE_ZONE("Box blur pass");
 
-    ctx->VSSetConstantBuffers(0u, 1u, m_sceneBuffer.buffer.GetAddressOf());
+        m_frameCommandList.record(sgfx::SetRenderTargetsCommand{.renderTargets = {m_ssaoBlurredRt.renderTarget.get()}, .renderTargetCount = 1u});
+        m_frameCommandList.record(sgfx::SetPipelineCommand{.pipeline = m_boxBlurPipeline.get()});
 
-    ctx->VSSetConstantBuffers(2u, 1u, m_lightMatricesBuffer.buffer.GetAddressOf());
-    m_lightModel.renderInstanced(ctx.Get(), sgfx::LIGHT_COUNT - 1u);
+        recordPixelShaderTextures(std::array{m_ssaoRt.texture.get()});
 
-    // Render to swapchain backbuffer RTV.
+        m_frameCommandList.record(sgfx::DrawCommand{.vertexCount = 3u});
+    }
 
-    ctx->RSSetViewports(1u, &m_viewport);
-    ctx->OMSetRenderTargets(1u, m_renderTargetView.GetAddressOf(), nullptr);
+    // Shading pass.
+    {
+        SGFX_PROFILE_ZONE("Shading pass");
 
-    bindPipeline(m_fullscreenPassPipeline);
-    bindTexturePS(m_offscreenRT.srv.Get(), 0u);
-    ctx->PSSetSamplers(0u, 1u, m_offscreenSampler.GetAddressOf());
+        m_frameCommandList.record(sgfx::SetRenderTargetsCommand{.renderTargets = {m_offscreenRT.renderTarget.get()}, .renderTargetCount = 1u});
+        m_frameCommandList.record(sgfx::SetPipelineCommand{.pipeline = m_pipeline.get()});
 
-    ctx->Draw(3u, 0u);
+        m_frameCommandList.record(sgfx::SetConstantBufferCommand{.buffer = m_sceneBuffer.buffer.get(), .stage = sgfx::ShaderStage::Vertex, .slot = 0u});
+        m_frameCommandList.record(sgfx::SetConstantBufferCommand{.buffer = m_sceneBuffer.buffer.get(), .stage = sgfx::ShaderStage::Pixel, .slot = 0u});
 
-    ctx->PSSetShaderResources(0u, 4u, nullSrvs.data());
+        recordPixelShaderTextures(std::array{m_gpassRts[0].texture.get(), m_gpassRts[1].texture.get(), m_gpassRts[2].texture.get(), m_ssaoBlurredRt.texture.get()});
 
-    ImGui::Render();
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        m_frameCommandList.record(sgfx::DrawCommand{.vertexCount = 3u});
+    }
+
+    {
+        SGFX_PROFILE_ZONE("Light models pass");
+
+        m_frameCommandList.record(sgfx::SetRenderTargetsCommand{
+            .renderTargets = {m_offscreenRT.renderTarget.get()},
+            .depthStencil = m_gpassDepthTexture.renderTarget.get(),
+            .renderTargetCount = 1u,
+        });
+        m_frameCommandList.record(sgfx::SetPipelineCommand{.pipeline = m_lightPipelines[static_cast<size_t>(m_lightModel.getVertexFormat())].get()});
+
+        m_frameCommandList.record(sgfx::SetConstantBufferCommand{.buffer = m_sceneBuffer.buffer.get(), .stage = sgfx::ShaderStage::Vertex, .slot = 0u});
+        m_frameCommandList.record(sgfx::SetConstantBufferCommand{.buffer = m_lightMatricesBuffer.buffer.get(), .stage = sgfx::ShaderStage::Vertex, .slot = 2u});
+
+        m_lightModel.recordInstanced(m_frameCommandList, sgfx::LIGHT_COUNT - 1u);
+    }
+
+    // Render to swapchain backbuffer.
+    {
+        SGFX_PROFILE_ZONE("Fullscreen pass");
+
+        m_frameCommandList.record(sgfx::SetRenderTargetsCommand{.renderTargets = {m_renderBackend->getBackBuffer()}, .renderTargetCount = 1u});
+        m_frameCommandList.record(sgfx::SetPipelineCommand{.pipeline = m_fullscreenPassPipeline.get()});
+
+        recordPixelShaderTextures(std::array{m_offscreenRT.texture.get()});
+        m_frameCommandList.record(sgfx::SetSamplerCommand{.sampler = m_offscreenSampler.get(), .stage = sgfx::ShaderStage::Pixel, .slot = 0u});
+
+        m_frameCommandList.record(sgfx::DrawCommand{.vertexCount = 3u});
+
+        // The render targets sampled above are rendered to again next frame.
+        recordPixelShaderTextures(std::array<sgfx::BackendHandle, 4u>{});
+    }
 
-    throwIfFailed(m_swapchain->Present(1u, 0u));
+    m_renderBackend->submit(m_frameCommandList);
 }
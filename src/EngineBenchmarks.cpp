@@ -0,0 +1,249 @@
+#include "Pch.hpp"
+
+#include "Engine.hpp"
+
+#include "Frustum.hpp"
+
+// Benchmarks that need the engine's scene. Those of standalone systems are in the benchmarks project.
+
+using namespace math;
+
+bool Engine::loadCameraPath()
+{
+    std::ifstream file(std::string(CAMERA_PATH_FILE), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+
+    m_cameraPath.resize(static_cast<size_t>(file.tellg()) / sizeof(CameraPathFrame));
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_cameraPath.data()), static_cast<std::streamsize>(m_cameraPath.size() * sizeof(CameraPathFrame)));
+
+    return true;
+}
+
+void Engine::runCameraPathBenchmark()
+{
+    if (m_cameraPath.empty())
+    {
+        m_cameraPathBenchmarkResult = "No camera path recorded.";
+        return;
+    }
+
+    const math::XMMATRIX projectionMatrix = getProjectionMatrix();
+
+    // A copy of the camera is moved along the path, so the look at matrix is computed exactly as during recording.
+    sgfx::Camera camera = m_camera;
+
+    sgfx::LodSelectionStats totalLodStats{};
+    sgfx::MeshCullingStats totalMeshCullingStats{};
+    sgfx::MeshletCullingStats totalCullingStats{};
+    uint64_t totalSubmittedTriangleCount = 0u;
+
+    double totalDuration = 0.0;
+    double maximumDuration = 0.0;
+
+    for (const CameraPathFrame& frame : m_cameraPath)
+    {
+        camera.m_cameraPosition = frame.position;
+        camera.m_pitch = frame.pitch;
+        camera.m_yaw = frame.yaw;
+
+        const math::XMMATRIX viewProjectionMatrix = camera.getLookAtMatrix() * projectionMatrix;
+        const sgfx::Frustum frustum = sgfx::createFrustum(viewProjectionMatrix);
+        const math::XMFLOAT3 cameraPosition = {frame.position.x, frame.position.y, frame.position.z};
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        const sgfx::LodSelectionStats lodStats = selectLods(cameraPosition);
+
+        sgfx::MeshCullingStats meshCullingStats = cullMeshes(frustum);
+        cullOccludedMeshes(viewProjectionMatrix, meshCullingStats);
+
+        totalMeshCullingStats += meshCullingStats;
+
+        sgfx::MeshletCullingStats cullingStats{};
+        if (m_isMeshletCullingEnabled)
+        {
+            for (auto& [name, renderable] : m_renderables)
+            {
+                cullingStats += renderable.cullMeshlets(frustum, cameraPosition);
+            }
+        }
+
+        const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+        totalDuration += duration.count();
+        maximumDuration = std::max(maximumDuration, duration.count());
+
+        // Culling counts the triangles of the selected LODs, so what it does not reject is what would be submitted.
+        totalSubmittedTriangleCount += m_isMeshletCullingEnabled ? cullingStats.triangleCount - cullingStats.getRejectedTriangleCount() : lodStats.selectedTriangleCount;
+
+        totalLodStats += lodStats;
+        totalCullingStats += cullingStats;
+    }
+
+    const double frameCount = static_cast<double>(m_cameraPath.size());
+
+    m_cameraPathBenchmarkResult = std::format("{} frames : {:.0f} triangles submitted per frame of {:.0f} at full detail ({:.0f} after LOD selection, "
+                                              "{:.0f} rejected by culling : frustum {:.0f}, backface {:.0f}), {:.1f} of {:.1f} meshes visible ({:.1f} occluded), "
+                                              "{:.3f} ms avg / {:.3f} ms max.",
+                                              m_cameraPath.size(),
+                                              totalSubmittedTriangleCount / frameCount,
+                                              totalLodStats.fullDetailTriangleCount / frameCount,
+                                              totalLodStats.selectedTriangleCount / frameCount,
+                                              totalCullingStats.getRejectedTriangleCount() / frameCount,
+                                              totalCullingStats.frustumCulledTriangleCount / frameCount,
+                                              totalCullingStats.backfaceCulledTriangleCount / frameCount,
+                                              totalMeshCullingStats.visibleMeshCount / frameCount,
+                                              totalMeshCullingStats.meshCount / frameCount,
+                                              totalMeshCullingStats.occludedMeshCount / frameCount,
+                                              totalDuration / frameCount,
+                                              maximumDuration);
+
+    std::cout << "Camera path benchmark : " << m_cameraPathBenchmarkResult << '\n';
+}
+
+void Engine::runSoftwareDeferredPassesBenchmark()
+{
+    constexpr uint32_t WIDTH = 1920u;
+    constexpr uint32_t HEIGHT = 1080u;
+
+    // Loaded again, as the scene's models do not keep their CPU data. The cook options match the scene's so the cooked file is shared.
+    sgfx::Model sponza = createModel("assets/models/sponza-gltf-pbr/sponza.glb",
+                                     sgfx::TransformComponent{.scale = {0.1f, 0.1f, 0.1f}},
+                                     sgfx::ModelLoadOptions{.generateMeshlets = true, .generateLods = true, .vertexFormat = m_vertexFormat, .keepRasterData = true});
+
+    const math::XMMATRIX viewMatrix = m_camera.getLookAtMatrix();
+    sponza.updateTransformBuffer(viewMatrix, *m_renderBackend);
+
+    std::vector<sgfx::RasterMesh> meshes{};
+    sponza.gatherRasterMeshes(meshes);
+
+    const math::XMMATRIX projectionMatrix =
+        math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(VERTICAL_FIELD_OF_VIEW), WIDTH / static_cast<float>(HEIGHT), 0.1f, 230.0f);
+
+    // Not timed : the rasterizer's throughput is measured by the benchmarks project.
+    sgfx::SoftwareRasterizer rasterizer{};
+    rasterizer.resize(WIDTH, HEIGHT);
+    rasterizer.render(meshes, viewMatrix, projectionMatrix, m_jobSystem);
+
+    runSoftwareDeferredPassesBenchmark(
+        sgfx::GBufferImages{
+            .width = rasterizer.getWidth(),
+            .height = rasterizer.getHeight(),
+            .rowPitch = rasterizer.getRowPitch(),
+            .albedos = rasterizer.getAlbedos(),
+            .positions = rasterizer.getPositions(),
+            .normals = rasterizer.getNormals(),
+        },
+        viewMatrix,
+        projectionMatrix);
+}
+
+void Engine::runSoftwareDeferredPassesBenchmark(const sgfx::GBufferImages& gbuffer, const math::XMMATRIX viewMatrix, const math::XMMATRIX projectionMatrix)
+{
+    constexpr uint32_t ITERATION_COUNT = 10u;
+    constexpr std::array<uint32_t, 4> SSAO_SAMPLE_COUNTS = {8u, 16u, 32u, 64u};
+    constexpr std::array<float, 3> SSAO_RADII = {0.25f, 0.65f, 1.5f};
+
+    constexpr std::string_view PNG_PATH_PREFIX = "software_deferred";
+
+    updateLights(viewMatrix);
+    const sgfx::SceneBuffer& sceneBuffer = m_sceneBuffer.data;
+
+    sgfx::SSAOBuffer ssaoBuffer = m_ssaoBuffer.data;
+    ssaoBuffer.projectionMatrix = projectionMatrix;
+
+    sgfx::SoftwareDeferredPasses passes{};
+    passes.resize(gbuffer.width, gbuffer.height);
+
+    const auto measure = [&](const auto& function)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; iteration++)
+        {
+            function();
+        }
+
+        const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - startTime;
+        return duration.count() / ITERATION_COUNT;
+    };
+
+    // Mean absolute difference of the occlusion with the one computed from every sample.
+    const auto getOcclusionError = [&](std::span<const uint8_t> referenceOcclusions)
+    {
+        uint64_t difference = 0u;
+        for (const uint32_t y : std::views::iota(0u, gbuffer.height))
+        {
+            for (const uint32_t x : std::views::iota(0u, gbuffer.width))
+            {
+                const size_t index = static_cast<size_t>(y) * passes.getRowPitch() + x;
+                difference += static_cast<uint64_t>(std::abs(static_cast<int32_t>(passes.getOcclusions()[index]) - referenceOcclusions[index]));
+            }
+        }
+
+        return difference / (255.0 * gbuffer.width * gbuffer.height);
+    };
+
+    for (const float radius : SSAO_RADII)
+    {
+        ssaoBuffer.radius = radius;
+
+        passes.computeAmbientOcclusion(gbuffer, ssaoBuffer, m_ssaoNoise, sgfx::SoftwareDeferredPasses::MAX_SSAO_SAMPLE_COUNT, m_jobSystem);
+        const std::vector<uint8_t> referenceOcclusions(passes.getOcclusions().begin(), passes.getOcclusions().end());
+
+        for (const uint32_t sampleCount : SSAO_SAMPLE_COUNTS)
+        {
+            const double duration = measure([&]() { passes.computeAmbientOcclusion(gbuffer, ssaoBuffer, m_ssaoNoise, sampleCount, m_jobSystem); });
+
+            std::cout << std::format("Software SSAO benchmark ({} x {}, radius {:.2f}, {} samples) : {:.2f} ms, mean occlusion error {:.4f}.\n",
+                                     gbuffer.width,
+                                     gbuffer.height,
+                                     radius,
+                                     sampleCount,
+                                     duration,
+                                     getOcclusionError(referenceOcclusions));
+        }
+    }
+
+    // The engine's settings, as the GPU passes run them.
+    ssaoBuffer.radius = m_ssaoBuffer.data.radius;
+
+    const double ssaoDuration =
+        measure([&]() { passes.computeAmbientOcclusion(gbuffer, ssaoBuffer, m_ssaoNoise, sgfx::SoftwareDeferredPasses::MAX_SSAO_SAMPLE_COUNT, m_jobSystem); });
+    const double blurDuration = measure([&]() { passes.blurAmbientOcclusion(m_jobSystem); });
+    const double lightingDuration = measure([&]() { passes.computeLighting(gbuffer, sceneBuffer, m_jobSystem); });
+
+    std::cout << std::format("Software deferred passes benchmark ({} x {}, {} threads) : SSAO {:.2f} ms, blur {:.2f} ms, lighting {:.2f} ms, {:.1f} Mpix/s overall.\n",
+                             gbuffer.width,
+                             gbuffer.height,
+                             m_jobSystem.getWorkerCount() + 1u,
+                             ssaoDuration,
+                             blurDuration,
+                             lightingDuration,
+                             gbuffer.width * gbuffer.height / ((ssaoDuration + blurDuration + lightingDuration) * 1000.0));
+
+    if (!passes.writePngs(PNG_PATH_PREFIX))
+    {
+        std::cout << std::format("Software deferred passes benchmark : failed to write {}_*.png.\n", PNG_PATH_PREFIX);
+    }
+}
+
+void Engine::benchmark()
+{
+    runSoftwareDeferredPassesBenchmark();
+
+    if (!loadCameraPath())
+    {
+        std::cout << "Camera path benchmark : " << CAMERA_PATH_FILE << " not found.\n";
+        return;
+    }
+
+    // Sets up the model matrices used by LOD selection and culling.
+    update(0.0f);
+
+    runCameraPathBenchmark();
+}
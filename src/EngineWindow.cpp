@@ -0,0 +1,314 @@
+#include "Pch.hpp"
+
+#include "Engine.hpp"
+
+#include <imgui.h>
+
+// The windowed frame of the engine and its user interface, Windows only as the window is (see ApplicationWindow.cpp).
+
+namespace
+{
+    constexpr std::string_view PROFILER_TRACE_FILE = "profiler_trace.json";
+}
+
+void Engine::render()
+{
+    // Start the Dear ImGui frame
+    beginUserInterfaceFrame();
+
+    ImGui::Begin("Scene menu");
+    ImGui::SliderFloat("camera mvmt speed", &m_camera.m_movementSpeed, 0.1f, 50.0f);
+    ImGui::SliderFloat("camera rotation speed", &m_camera.m_rotationSpeed, 0.1f, 3.0f);
+
+    ImGui::SliderFloat("ssao radius", &m_ssaoBuffer.data.radius, 0.0f, 10.0f);
+    ImGui::SliderFloat("ssao bias", &m_ssaoBuffer.data.bias, 0.0f, 10.0f);
+    ImGui::SliderFloat("ssao power", &m_ssaoBuffer.data.power, 0.0f, 10.0f);
+
+    for (auto& [name, renderable] : m_renderables)
+    {
+        if (ImGui::TreeNode(name.c_str()))
+        {
+            ImGui::SliderFloat3("position", &renderable.getTransformComponent()->translate.x, -25.0f, 25.0f);
+            ImGui::SliderFloat("scale", &renderable.getTransformComponent()->scale.x, 0.1f, 10.0f);
+            ImGui::SliderFloat3("rotation", &renderable.getTransformComponent()->rotation.x, math::XMConvertToRadians(-90.0f), math::XMConvertToRadians(90.0f));
+
+            renderable.getTransformComponent()->scale.y = renderable.getTransformComponent()->scale.x;
+            renderable.getTransformComponent()->scale.z = renderable.getTransformComponent()->scale.x;
+
+            ImGui::TreePop();
+        }
+    }
+
+    if (ImGui::TreeNode("light properties"))
+    {
+        if (ImGui::TreeNode("Directional light"))
+        {
+            ImGui::SliderFloat("sun Angle", &m_sunAngle, -180.0f, 180.0f);
+            ImGui::SliderFloat3("dir light color", &m_sceneBuffer.data.lightColorIntensity[0].x, 0.0f, 1.0f);
+            ImGui::SliderFloat("dir light intensity", &m_sceneBuffer.data.lightColorIntensity[0].w, 0.0f, 30.0f);
+
+            ImGui::TreePop();
+        }
+
+        for (const uint32_t i : std::views::iota(1u, sgfx::LIGHT_COUNT))
+        {
+            if (ImGui::TreeNode((std::string("Point Light") + std::to_string(i)).c_str()))
+            {
+                ImGui::ColorPicker3("light color", &m_sceneBuffer.data.lightColorIntensity[i].x);
+                ImGui::SliderFloat("Intensity", &m_sceneBuffer.data.lightColorIntensity[i].w, 0.1f, 30.0f);
+
+                ImGui::SliderFloat3("position", &m_lightPositions[i - 1].x, -25.0f, 25.0f);
+
+                ImGui::TreePop();
+            }
+        }
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("geometry pool"))
+    {
+        const sgfx::GeometryPoolStats geometryPoolStats = m_geometryPool->getStats();
+
+        const auto showPoolStats = [](const char* const name, const sgfx::RangeAllocatorStats& stats)
+        {
+            ImGui::Text("%s : %llu / %llu used, %u ranges", name, stats.usedSize, stats.capacity, stats.allocationCount);
+            ImGui::Text("    %u free blocks, largest %llu, fragmentation %.3f", stats.freeBlockCount, stats.largestFreeBlockSize, stats.getFragmentation());
+        };
+
+        showPoolStats("vertices", geometryPoolStats.vertices);
+        showPoolStats("16 bit indices", geometryPoolStats.shortIndices);
+        showPoolStats("32 bit indices", geometryPoolStats.indices);
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("texture cache"))
+    {
+        const sgfx::TextureCacheStats stats = m_textureCache->getStats();
+
+        ImGui::Text("%u textures resident, %.1f MB", stats.residentTextureCount, stats.residentBytes / (1024.0 * 1024.0));
+        ImGui::Text("%llu requests : %llu hits, %llu waited on a load in flight (hit rate %.2f)", stats.requestCount, stats.hitCount, stats.inFlightHitCount, stats.getHitRate());
+        ImGui::Text("%.1f MB not loaded again", stats.bytesSaved / (1024.0 * 1024.0));
+        ImGui::Text("%u cooked this run, %u loaded uncompressed", stats.cookedTextureCount, stats.uncompressedTextureCount);
+
+        if (stats.cookedTextureCount > 0u)
+        {
+            ImGui::Text("cooked : %.1f MB, lowest PSNR %.2f dB, %.1f ms of cooking", stats.cookedBytes / (1024.0 * 1024.0), stats.lowestCookedPsnr, stats.cookTimeMs);
+        }
+
+        const sgfx::TextureStreamingStats& streamingStats = stats.streaming;
+        ImGui::Text("streaming : %u textures, %.1f MB resident + %.1f MB in flight of %.1f MB",
+                    streamingStats.textureCount,
+                    streamingStats.residentBytes / (1024.0 * 1024.0),
+                    streamingStats.inFlightBytes / (1024.0 * 1024.0),
+                    streamingStats.budgetBytes / (1024.0 * 1024.0));
+        ImGui::Text("    %u waiting for finer mips, %u requests in flight", streamingStats.waitingTextureCount, streamingStats.pendingRequestCount);
+        ImGui::Text("    last update : %u loads, %u evictions", streamingStats.lastUpdateLoadCount, streamingStats.lastUpdateEvictionCount);
+        ImGui::Text("    %.1f MB loaded, %.1f MB evicted (%llu evictions)",
+                    streamingStats.loadedBytes / (1024.0 * 1024.0),
+                    streamingStats.evictedBytes / (1024.0 * 1024.0),
+                    streamingStats.evictionCount);
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("level of detail"))
+    {
+        ImGui::Checkbox("enabled", &m_isLodSelectionEnabled);
+        ImGui::SliderFloat("error threshold (pixels)", &m_lodErrorThreshold, 0.25f, 16.0f);
+
+        const sgfx::LodSelectionStats& stats = m_lodSelectionStats;
+        ImGui::Text("triangles : %llu selected of %llu", stats.selectedTriangleCount, stats.fullDetailTriangleCount);
+
+        for (const uint32_t lod : std::views::iota(0u, sgfx::MAX_MESH_LOD_COUNT))
+        {
+            ImGui::Text("    LOD %u : %u meshes", lod, stats.meshCountPerLod[lod]);
+        }
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("picking"))
+    {
+        ImGui::Text("right click to pick a mesh");
+        ImGui::TextWrapped("%s", m_pickResult.c_str());
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::IsMouseClicked(ImGuiMouseButton_Right) && !ImGui::GetIO().WantCaptureMouse)
+    {
+        const ImVec2 mousePosition = ImGui::GetMousePos();
+        pickMesh(mousePosition.x, mousePosition.y);
+    }
+
+    if (ImGui::TreeNode("mesh culling"))
+    {
+        ImGui::Checkbox("enabled", &m_isMeshCullingEnabled);
+
+        const sgfx::MeshCullingStats& stats = m_meshCullingStats;
+        ImGui::Text("meshes : %u visible, %u culled of %u", stats.visibleMeshCount, stats.getCulledMeshCount(), stats.meshCount);
+        ImGui::Text("culling time : %.3f ms", m_meshCullingDuration);
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("occlusion culling"))
+    {
+        ImGui::Checkbox("enabled", &m_isOcclusionCullingEnabled);
+        ImGui::SliderFloat("minimum occluder radius", &m_occluderSelectionDesc.minimumRadius, 0.0f, 10.0f);
+
+        const sgfx::OcclusionRasterizationStats& stats = m_occlusionRasterizationStats;
+        ImGui::Text("occluders : %u (%u of %u triangles rasterized)", stats.occluderCount, stats.rasterizedTriangleCount, stats.triangleCount);
+        ImGui::Text("meshes occluded : %u", m_meshCullingStats.occludedMeshCount);
+        ImGui::Text("buffer : %u x %u, culling time : %.3f ms", m_occlusionBuffer.getWidth(), m_occlusionBuffer.getHeight(), m_occlusionCullingDuration);
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("draw submission"))
+    {
+        const sgfx::DrawSubmissionStats& stats = m_drawSubmissionStats;
+        ImGui::Text("items : %u, draws : %u", stats.itemCount, stats.drawCount);
+        ImGui::Text("binds : %u textures, %u samplers, %u transforms, %u index buffers", stats.textureBindCount, stats.samplerBindCount, stats.transformBindCount, stats.indexBufferBindCount);
+        ImGui::Text("collection and sort : %.3f ms", m_renderQueueDuration);
+
+        bool isParallelSubmissionEnabled = m_renderBackend->isParallelSubmissionEnabled();
+        if (ImGui::Checkbox("parallel submission", &isParallelSubmissionEnabled))
+        {
+            m_renderBackend->setParallelSubmissionEnabled(isParallelSubmissionEnabled);
+        }
+
+        uint32_t commandCount = 0u;
+        uint64_t commandListSize = 0u;
+        for (const sgfx::CommandList& commandList : m_geometryCommandLists)
+        {
+            commandCount += commandList.getCommandCount();
+            commandListSize += commandList.getSize();
+        }
+
+        ImGui::Text("command lists : %zu, %u commands, %.1f KB", m_geometryCommandLists.size(), commandCount, commandListSize / 1024.0);
+        ImGui::Text("recording : %.3f ms, submission : %.3f ms", m_commandRecordingDuration, m_commandSubmissionDuration);
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("meshlet culling"))
+    {
+        ImGui::Checkbox("enabled", &m_isMeshletCullingEnabled);
+
+        const sgfx::MeshletCullingStats& stats = m_meshletCullingStats;
+        ImGui::Text("meshlets : %u culled by frustum, %u by normal cone, %u total", stats.frustumCulledMeshletCount, stats.backfaceCulledMeshletCount, stats.meshletCount);
+        ImGui::Text("triangles : %llu rejected (frustum %llu, backface %llu) of %llu", stats.getRejectedTriangleCount(), stats.frustumCulledTriangleCount, stats.backfaceCulledTriangleCount, stats.triangleCount);
+
+        if (ImGui::Button(m_isRecordingCameraPath ? "stop recording" : "record camera path"))
+        {
+            if (!m_isRecordingCameraPath)
+            {
+                m_cameraPath.clear();
+            }
+
+            m_isRecordingCameraPath = !m_isRecordingCameraPath;
+        }
+
+        ImGui::SameLine();
+        if (ImGui::Button("save path"))
+        {
+            std::ofstream file(std::string(CAMERA_PATH_FILE), std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(m_cameraPath.data()), static_cast<std::streamsize>(m_cameraPath.size() * sizeof(CameraPathFrame)));
+        }
+
+        ImGui::SameLine();
+        if (ImGui::Button("load path"))
+        {
+            loadCameraPath();
+        }
+
+        ImGui::Text("camera path : %zu frames", m_cameraPath.size());
+
+        if (ImGui::Button("run benchmark"))
+        {
+            m_isRecordingCameraPath = false;
+            m_isCameraPathBenchmarkRequested = true;
+        }
+
+        ImGui::TextWrapped("%s", m_cameraPathBenchmarkResult.c_str());
+
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("profiler"))
+    {
+#ifdef SGFX_PROFILER
+        sgfx::Profiler& profiler = sgfx::getProfiler();
+        const sgfx::ProfilerStats stats = profiler.getStats();
+
+        ImGui::Text("%u threads, %llu zones dropped, %.1f ticks / us", stats.threadCount, stats.droppedEventCount, stats.ticksPerMicrosecond);
+
+        if (ImGui::Button(stats.isCapturing ? "stop capture" : "capture trace"))
+        {
+            if (!stats.isCapturing)
+            {
+                profiler.beginCapture();
+                m_profilerCaptureResult.clear();
+            }
+            else
+            {
+                m_profilerCaptureResult = profiler.endCapture(PROFILER_TRACE_FILE) ? std::format("trace written to {}", PROFILER_TRACE_FILE)
+                                                                                     : std::format("failed to write {}", PROFILER_TRACE_FILE);
+            }
+        }
+
+        ImGui::SameLine();
+        if (stats.isCapturing)
+        {
+            ImGui::Text("%llu zones captured", stats.capturedEventCount);
+        }
+        else
+        {
+            ImGui::Text("%s", m_profilerCaptureResult.c_str());
+        }
+
+        ImGui::Text("last %u frames : average ms (maximum ms), calls per frame", sgfx::Profiler::ROLLING_FRAME_COUNT);
+
+        for (const sgfx::ProfilerZoneStats& zone : profiler.getZoneStats())
+        {
+            ImGui::Text("%*s%.*s : %.3f (%.3f), %.1f",
+                        static_cast<int>(zone.depth * 2u),
+                        "",
+                        static_cast<int>(zone.name.size()),
+                        zone.name.data(),
+                        zone.averageDuration,
+                        zone.maximumDuration,
+                        zone.averageCallCount);
+        }
+#else
+        ImGui::Text("zones compiled out (premake --no-profiler)");
+#endif
+
+        ImGui::TreePop();
+    }
+
+    ImGui::End();
+
+    // Texture handles of the D3D11 backend are shader resource views, which is what the ImGui DX11 renderer takes as texture ids.
+    ImGui::Begin("SSAO RT");
+    ImGui::Image(const_cast<void*>(m_ssaoRt.texture.get()), {300, 300});
+    ImGui::End();
+
+    ImGui::Begin("SSAO Blurred RT");
+    ImGui::Image(const_cast<void*>(m_ssaoBlurredRt.texture.get()), {300, 300});
+    ImGui::End();
+
+    renderFrame();
+
+    {
+        SGFX_PROFILE_ZONE("ImGui pass");
+
+        renderUserInterface();
+    }
+
+    SGFX_PROFILE_ZONE("Present");
+    m_renderBackend->present();
+}
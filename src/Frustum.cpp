@@ -0,0 +1,258 @@
+#include "Pch.hpp"
+
+#include "Frustum.hpp"
+
+#include "CpuFeatures.hpp"
+
+#include <immintrin.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        math::XMVECTOR normalizePlane(const math::XMVECTOR plane) { return math::XMVectorDivide(plane, math::XMVector3Length(plane)); }
+
+        bool isBoundingVolumeVisible(const Frustum& frustum, const BoundingVolumes& volumes, const uint32_t i)
+        {
+            for (const math::XMFLOAT4& plane : frustum.planes)
+            {
+                const float boxDistance = plane.x * volumes.boxCenterX[i] + plane.y * volumes.boxCenterY[i] + plane.z * volumes.boxCenterZ[i] + plane.w;
+                const float boxRadius =
+                    std::abs(plane.x) * volumes.boxExtentX[i] + std::abs(plane.y) * volumes.boxExtentY[i] + std::abs(plane.z) * volumes.boxExtentZ[i];
+
+                const float sphereDistance =
+                    plane.x * volumes.sphereCenterX[i] + plane.y * volumes.sphereCenterY[i] + plane.z * volumes.sphereCenterZ[i] + plane.w;
+
+                if (boxDistance + boxRadius < 0.0f || sphereDistance + volumes.sphereRadius[i] < 0.0f)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // SSE2 is part of the x64 baseline, so this path needs no feature check. Returns the number of objects tested.
+        uint32_t cullBoundingVolumesSse2(const Frustum& frustum, const BoundingVolumes& volumes, uint8_t* const outIsVisible, uint32_t& visibleCount)
+        {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            const uint32_t count = volumes.getCount();
+
+            uint32_t i = 0u;
+            for (; i + 4u <= count; i += 4u)
+            {
+                const __m128 boxCenterX = _mm_loadu_ps(&volumes.boxCenterX[i]);
+                const __m128 boxCenterY = _mm_loadu_ps(&volumes.boxCenterY[i]);
+                const __m128 boxCenterZ = _mm_loadu_ps(&volumes.boxCenterZ[i]);
+                const __m128 boxExtentX = _mm_loadu_ps(&volumes.boxExtentX[i]);
+                const __m128 boxExtentY = _mm_loadu_ps(&volumes.boxExtentY[i]);
+                const __m128 boxExtentZ = _mm_loadu_ps(&volumes.boxExtentZ[i]);
+                const __m128 sphereCenterX = _mm_loadu_ps(&volumes.sphereCenterX[i]);
+                const __m128 sphereCenterY = _mm_loadu_ps(&volumes.sphereCenterY[i]);
+                const __m128 sphereCenterZ = _mm_loadu_ps(&volumes.sphereCenterZ[i]);
+                const __m128 sphereRadius = _mm_loadu_ps(&volumes.sphereRadius[i]);
+
+                __m128 isOutside = _mm_setzero_ps();
+
+                for (const math::XMFLOAT4& plane : frustum.planes)
+                {
+                    const __m128 planeX = _mm_set1_ps(plane.x);
+                    const __m128 planeY = _mm_set1_ps(plane.y);
+                    const __m128 planeZ = _mm_set1_ps(plane.z);
+                    const __m128 planeW = _mm_set1_ps(plane.w);
+
+                    const __m128 boxDistance =
+                        _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX, boxCenterX), _mm_mul_ps(planeY, boxCenterY)), _mm_add_ps(_mm_mul_ps(planeZ, boxCenterZ), planeW));
+                    const __m128 boxRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(planeX, absMask), boxExtentX), _mm_mul_ps(_mm_and_ps(planeY, absMask), boxExtentY)),
+                                                        _mm_mul_ps(_mm_and_ps(planeZ, absMask), boxExtentZ));
+
+                    const __m128 sphereDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX, sphereCenterX), _mm_mul_ps(planeY, sphereCenterY)),
+                                                             _mm_add_ps(_mm_mul_ps(planeZ, sphereCenterZ), planeW));
+
+                    isOutside = _mm_or_ps(isOutside, _mm_cmplt_ps(_mm_add_ps(boxDistance, boxRadius), _mm_setzero_ps()));
+                    isOutside = _mm_or_ps(isOutside, _mm_cmplt_ps(_mm_add_ps(sphereDistance, sphereRadius), _mm_setzero_ps()));
+                }
+
+                const uint32_t outsideMask = static_cast<uint32_t>(_mm_movemask_ps(isOutside));
+                for (const uint32_t lane : std::views::iota(0u, 4u))
+                {
+                    outIsVisible[i + lane] = static_cast<uint8_t>(((outsideMask >> lane) & 1u) ^ 1u);
+                }
+
+                visibleCount += 4u - static_cast<uint32_t>(std::popcount(outsideMask));
+            }
+
+            return i;
+        }
+
+        SGFX_TARGET_AVX2 uint32_t cullBoundingVolumesAvx2(const Frustum& frustum, const BoundingVolumes& volumes, uint8_t* const outIsVisible, uint32_t& visibleCount)
+        {
+            const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+            const uint32_t count = volumes.getCount();
+
+            uint32_t i = 0u;
+            for (; i + 8u <= count; i += 8u)
+            {
+                const __m256 boxCenterX = _mm256_loadu_ps(&volumes.boxCenterX[i]);
+                const __m256 boxCenterY = _mm256_loadu_ps(&volumes.boxCenterY[i]);
+                const __m256 boxCenterZ = _mm256_loadu_ps(&volumes.boxCenterZ[i]);
+                const __m256 boxExtentX = _mm256_loadu_ps(&volumes.boxExtentX[i]);
+                const __m256 boxExtentY = _mm256_loadu_ps(&volumes.boxExtentY[i]);
+                const __m256 boxExtentZ = _mm256_loadu_ps(&volumes.boxExtentZ[i]);
+                const __m256 sphereCenterX = _mm256_loadu_ps(&volumes.sphereCenterX[i]);
+                const __m256 sphereCenterY = _mm256_loadu_ps(&volumes.sphereCenterY[i]);
+                const __m256 sphereCenterZ = _mm256_loadu_ps(&volumes.sphereCenterZ[i]);
+                const __m256 sphereRadius = _mm256_loadu_ps(&volumes.sphereRadius[i]);
+
+                __m256 isOutside = _mm256_setzero_ps();
+
+                for (const math::XMFLOAT4& plane : frustum.planes)
+                {
+                    const __m256 planeX = _mm256_set1_ps(plane.x);
+                    const __m256 planeY = _mm256_set1_ps(plane.y);
+                    const __m256 planeZ = _mm256_set1_ps(plane.z);
+                    const __m256 planeW = _mm256_set1_ps(plane.w);
+
+                    const __m256 boxDistance = _mm256_fmadd_ps(planeX, boxCenterX, _mm256_fmadd_ps(planeY, boxCenterY, _mm256_fmadd_ps(planeZ, boxCenterZ, planeW)));
+                    const __m256 boxRadius = _mm256_fmadd_ps(_mm256_and_ps(planeX, absMask),
+                                                             boxExtentX,
+                                                             _mm256_fmadd_ps(_mm256_and_ps(planeY, absMask), boxExtentY, _mm256_mul_ps(_mm256_and_ps(planeZ, absMask), boxExtentZ)));
+
+                    const __m256 sphereDistance =
+                        _mm256_fmadd_ps(planeX, sphereCenterX, _mm256_fmadd_ps(planeY, sphereCenterY, _mm256_fmadd_ps(planeZ, sphereCenterZ, planeW)));
+
+                    isOutside = _mm256_or_ps(isOutside, _mm256_cmp_ps(_mm256_add_ps(boxDistance, boxRadius), _mm256_setzero_ps(), _CMP_LT_OQ));
+                    isOutside = _mm256_or_ps(isOutside, _mm256_cmp_ps(_mm256_add_ps(sphereDistance, sphereRadius), _mm256_setzero_ps(), _CMP_LT_OQ));
+                }
+
+                const uint32_t outsideMask = static_cast<uint32_t>(_mm256_movemask_ps(isOutside));
+                for (const uint32_t lane : std::views::iota(0u, 8u))
+                {
+                    outIsVisible[i + lane] = static_cast<uint8_t>(((outsideMask >> lane) & 1u) ^ 1u);
+                }
+
+                visibleCount += 8u - static_cast<uint32_t>(std::popcount(outsideMask));
+            }
+
+            return i;
+        }
+    }
+
+    Frustum createFrustum(const math::XMMATRIX viewProjectionMatrix)
+    {
+        // Gribb / Hartmann : with clip = p * M, the planes are combinations of the columns of M (i.e the rows of its transpose).
+        const math::XMMATRIX transposedMatrix = math::XMMatrixTranspose(viewProjectionMatrix);
+
+        const math::XMVECTOR x = transposedMatrix.r[0];
+        const math::XMVECTOR y = transposedMatrix.r[1];
+        const math::XMVECTOR z = transposedMatrix.r[2];
+        const math::XMVECTOR w = transposedMatrix.r[3];
+
+        Frustum frustum{};
+
+        math::XMStoreFloat4(&frustum.planes[Frustum::Left], normalizePlane(math::XMVectorAdd(w, x)));
+        math::XMStoreFloat4(&frustum.planes[Frustum::Right], normalizePlane(math::XMVectorSubtract(w, x)));
+        math::XMStoreFloat4(&frustum.planes[Frustum::Bottom], normalizePlane(math::XMVectorAdd(w, y)));
+        math::XMStoreFloat4(&frustum.planes[Frustum::Top], normalizePlane(math::XMVectorSubtract(w, y)));
+        math::XMStoreFloat4(&frustum.planes[Frustum::Near], normalizePlane(z));
+        math::XMStoreFloat4(&frustum.planes[Frustum::Far], normalizePlane(math::XMVectorSubtract(w, z)));
+
+        return frustum;
+    }
+
+    Frustum transformFrustum(const Frustum& frustum, const math::XMMATRIX transformMatrix)
+    {
+        // dot(plane, p * M) = dot(plane * transpose(M), p), so the planes are transformed by the transpose of the matrix (not its inverse transpose).
+        const math::XMMATRIX transposedMatrix = math::XMMatrixTranspose(transformMatrix);
+
+        Frustum transformedFrustum{};
+
+        for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(Frustum::PlaneCount)))
+        {
+            const math::XMVECTOR plane = math::XMVector4Transform(math::XMLoadFloat4(&frustum.planes[i]), transposedMatrix);
+            math::XMStoreFloat4(&transformedFrustum.planes[i], normalizePlane(plane));
+        }
+
+        return transformedFrustum;
+    }
+
+    bool isSphereInFrustum(const Frustum& frustum, const math::XMFLOAT3& center, const float radius)
+    {
+        for (const math::XMFLOAT4& plane : frustum.planes)
+        {
+            if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool isAabbInFrustum(const Frustum& frustum, const AxisAlignedBoundingBox& bounds)
+    {
+        // Only the corner furthest along the plane normal has to be tested.
+        for (const math::XMFLOAT4& plane : frustum.planes)
+        {
+            const float x = plane.x >= 0.0f ? bounds.maximum.x : bounds.minimum.x;
+            const float y = plane.y >= 0.0f ? bounds.maximum.y : bounds.minimum.y;
+            const float z = plane.z >= 0.0f ? bounds.maximum.z : bounds.minimum.z;
+
+            if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void BoundingVolumes::resize(const uint32_t count)
+    {
+        for (std::vector<float>* const values : {&boxCenterX,
+                                                 &boxCenterY,
+                                                 &boxCenterZ,
+                                                 &boxExtentX,
+                                                 &boxExtentY,
+                                                 &boxExtentZ,
+                                                 &sphereCenterX,
+                                                 &sphereCenterY,
+                                                 &sphereCenterZ,
+                                                 &sphereRadius})
+        {
+            values->resize(count);
+        }
+    }
+
+    void BoundingVolumes::set(const uint32_t index, const AxisAlignedBoundingBox& box, const math::XMFLOAT3& sphereCenter, const float radius)
+    {
+        boxCenterX[index] = 0.5f * (box.minimum.x + box.maximum.x);
+        boxCenterY[index] = 0.5f * (box.minimum.y + box.maximum.y);
+        boxCenterZ[index] = 0.5f * (box.minimum.z + box.maximum.z);
+
+        boxExtentX[index] = 0.5f * (box.maximum.x - box.minimum.x);
+        boxExtentY[index] = 0.5f * (box.maximum.y - box.minimum.y);
+        boxExtentZ[index] = 0.5f * (box.maximum.z - box.minimum.z);
+
+        sphereCenterX[index] = sphereCenter.x;
+        sphereCenterY[index] = sphereCenter.y;
+        sphereCenterZ[index] = sphereCenter.z;
+        sphereRadius[index] = radius;
+    }
+
+    uint32_t cullBoundingVolumes(const Frustum& frustum, const BoundingVolumes& volumes, std::span<uint8_t> outIsVisible, const CpuFeatures& cpuFeatures)
+    {
+        uint32_t visibleCount = 0u;
+
+        uint32_t i = cpuFeatures.avx2 ? cullBoundingVolumesAvx2(frustum, volumes, outIsVisible.data(), visibleCount)
+                                      : cullBoundingVolumesSse2(frustum, volumes, outIsVisible.data(), visibleCount);
+
+        for (; i < volumes.getCount(); i++)
+        {
+            outIsVisible[i] = isBoundingVolumeVisible(frustum, volumes, i) ? 1u : 0u;
+            visibleCount += outIsVisible[i];
+        }
+
+        return visibleCount;
+    }
+}
@@ -0,0 +1,128 @@
+#include "Pch.hpp"
+
+#include "GeometryPool.hpp"
+
+namespace sgfx
+{
+    GeometryPool::GeometryPool(RenderBackend& renderBackend, const GeometryPoolCreationDesc& geometryPoolCreationDesc) : m_renderBackend(renderBackend)
+    {
+        m_vertexBuffer = createPoolBuffer(1u, geometryPoolCreationDesc.vertexBufferSize, BufferType::Vertex);
+        m_shortIndexBuffer = createPoolBuffer(sizeof(uint16_t), geometryPoolCreationDesc.shortIndexCapacity, BufferType::Index);
+        m_indexBuffer = createPoolBuffer(sizeof(uint32_t), geometryPoolCreationDesc.indexCapacity, BufferType::Index);
+    }
+
+    GeometryRange GeometryPool::uploadVertices(const std::span<const std::byte> vertexData, const uint32_t vertexSize)
+    {
+        // Aligning the byte offset to the vertex size lets the range be addressed in vertices, with the buffer bound at offset 0.
+        const GeometryRange byteRange = upload(m_vertexBuffer, vertexData, vertexSize);
+
+        return GeometryRange{
+            .first = byteRange.first / vertexSize,
+            .count = byteRange.count / vertexSize,
+        };
+    }
+
+    GeometryRange GeometryPool::uploadIndices(const std::span<const std::byte> indexData, const uint32_t indexSize)
+    {
+        return upload(getIndexPoolBuffer(indexSize), indexData, 1u);
+    }
+
+    void GeometryPool::flushUploads()
+    {
+        std::vector<StagedUpload> stagedUploads{};
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            stagedUploads.swap(m_stagedUploads);
+        }
+
+        for (const StagedUpload& stagedUpload : stagedUploads)
+        {
+            m_renderBackend.updateBuffer(stagedUpload.buffer, stagedUpload.data, stagedUpload.offset);
+        }
+    }
+
+    void GeometryPool::freeVertices(const GeometryRange& range, const uint32_t vertexSize)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_vertexBuffer.allocator.free(static_cast<uint64_t>(range.first) * vertexSize, static_cast<uint64_t>(range.count) * vertexSize);
+    }
+
+    void GeometryPool::freeIndices(const GeometryRange& range, const uint32_t indexSize)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        getIndexPoolBuffer(indexSize).allocator.free(range.first, range.count);
+    }
+
+    GeometryPoolStats GeometryPool::getStats() const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        return GeometryPoolStats{
+            .vertices = m_vertexBuffer.allocator.getStats(),
+            .shortIndices = m_shortIndexBuffer.allocator.getStats(),
+            .indices = m_indexBuffer.allocator.getStats(),
+        };
+    }
+
+    GeometryPool::PoolBuffer GeometryPool::createPoolBuffer(const uint32_t elementSize, const uint32_t capacity, const BufferType bufferType) const
+    {
+        return PoolBuffer{
+            .buffer = BackendResource(m_renderBackend, m_renderBackend.createBuffer(BackendBufferDesc{.type = bufferType, .size = elementSize * capacity})),
+            .allocator = RangeAllocator(capacity),
+            .elementSize = elementSize,
+        };
+    }
+
+    GeometryPool::PoolBuffer& GeometryPool::getIndexPoolBuffer(const uint32_t indexSize) { return indexSize == sizeof(uint16_t) ? m_shortIndexBuffer : m_indexBuffer; }
+
+    const GeometryPool::PoolBuffer& GeometryPool::getIndexPoolBuffer(const uint32_t indexSize) const
+    {
+        return indexSize == sizeof(uint16_t) ? m_shortIndexBuffer : m_indexBuffer;
+    }
+
+    GeometryRange GeometryPool::upload(PoolBuffer& poolBuffer, const std::span<const std::byte> data, const uint32_t alignment)
+    {
+        const uint32_t count = static_cast<uint32_t>(data.size() / poolBuffer.elementSize);
+        if (count == 0u)
+        {
+            return GeometryRange{};
+        }
+
+        // Copied outside of the lock, as the data may be large.
+        const std::span<const std::byte> uploadedData = data.first(uint64_t{count} * poolBuffer.elementSize);
+        std::vector<std::byte> stagedData(uploadedData.begin(), uploadedData.end());
+
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        const std::optional<uint64_t> first = poolBuffer.allocator.allocate(count, alignment);
+        if (!first.has_value())
+        {
+            const RangeAllocatorStats stats = poolBuffer.allocator.getStats();
+            fatalError(std::format("Geometry pool is out of memory : requested {} elements, {} free (largest free block : {}).", count, stats.freeSize, stats.largestFreeBlockSize));
+        }
+
+        const GeometryRange range{
+            .first = static_cast<uint32_t>(*first),
+            .count = count,
+        };
+
+        m_stagedUploads.emplace_back(StagedUpload{
+            .buffer = poolBuffer.buffer.get(),
+            .offset = range.first * poolBuffer.elementSize,
+            .data = std::move(stagedData),
+        });
+
+        return range;
+    }
+
+    GeometryAllocation::~GeometryAllocation()
+    {
+        geometryPool.freeVertices(vertexRange, vertexSize);
+
+        for (const auto& [indexRange, indexSize] : indexRanges)
+        {
+            geometryPool.freeIndices(indexRange, indexSize);
+        }
+    }
+}
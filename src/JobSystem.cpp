@@ -0,0 +1,251 @@
+#include "Pch.hpp"
+
+#include "JobSystem.hpp"
+
+namespace sgfx
+{
+    // Used to identify if the calling thread is a worker of a particular job system, and if so, which queue it owns.
+    static thread_local JobSystem* tlsJobSystem{nullptr};
+    static thread_local uint32_t tlsWorkerIndex{INVALID_INDEX_U32};
+
+    JobSystem::JobSystem(const uint32_t workerCount)
+    {
+        const uint32_t threadCount = workerCount == 0u ? std::max(std::thread::hardware_concurrency(), 2u) - 1u : workerCount;
+
+        // All queues must exist before any worker is started, as workers steal from each other.
+        m_queues.resize(threadCount);
+        std::ranges::generate(m_queues, []() { return std::make_unique<WorkerQueue>(); });
+
+        m_workers.reserve(threadCount);
+        for (const uint32_t i : std::views::iota(0u, threadCount))
+        {
+            m_workers.emplace_back([this, i](const std::stop_token stopToken) { workerLoop(stopToken, i); });
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        for (auto& worker : m_workers)
+        {
+            worker.request_stop();
+        }
+
+        // Join the workers explicitly, as they use the sleep condition variable which would otherwise be destroyed before them.
+        m_workers.clear();
+    }
+
+    void JobSystem::submit(JobFunction job, JobCounter& counter, JobCounter* const dependency)
+    {
+        counter.m_pendingJobs.fetch_add(1u, std::memory_order_relaxed);
+
+        if (dependency)
+        {
+            const std::scoped_lock<std::mutex> lock(dependency->m_mutex);
+            if (dependency->m_pendingJobs.load(std::memory_order_acquire) != 0u)
+            {
+                // The job will be queued by whichever thread completes the last job of the dependency.
+                dependency->m_continuations.emplace_back(JobCounter::Continuation{
+                    .function = std::move(job),
+                    .counter = &counter,
+                });
+
+                return;
+            }
+        }
+
+        pushJob(Job{
+            .function = std::move(job),
+            .counter = &counter,
+        });
+    }
+
+    void JobSystem::parallelFor(const uint32_t count, const uint32_t batchSize, const std::function<void(const uint32_t)>& job, JobCounter& counter)
+    {
+        const uint32_t clampedBatchSize = std::max(batchSize, 1u);
+
+        // The batches may outlive the caller's function object, so they share a single copy of it.
+        const auto sharedJob = std::make_shared<const std::function<void(const uint32_t)>>(job);
+
+        for (uint32_t batchStart = 0u; batchStart < count; batchStart += clampedBatchSize)
+        {
+            const uint32_t batchEnd = std::min(batchStart + clampedBatchSize, count);
+
+            submit(
+                [sharedJob, batchStart, batchEnd]()
+                {
+                    for (const uint32_t i : std::views::iota(batchStart, batchEnd))
+                    {
+                        (*sharedJob)(i);
+                    }
+                },
+                counter);
+        }
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        while (counter.m_pendingJobs.load(std::memory_order_acquire) != 0u)
+        {
+            if (!tryRunJob(counter.m_priority == JobPriority::Low))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // Acquiring the lock guarantees that the thread which completed the last job has released the counter, so it can safely be destroyed by the caller.
+        std::exception_ptr exception{};
+        {
+            const std::scoped_lock<std::mutex> lock(counter.m_mutex);
+            exception = std::exchange(counter.m_exception, nullptr);
+        }
+
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void JobSystem::pushJob(Job&& job)
+    {
+        if (job.counter->m_priority == JobPriority::Low)
+        {
+            const std::scoped_lock<std::mutex> lock(m_lowPriorityQueue.mutex);
+            m_lowPriorityQueue.jobs.emplace_back(std::move(job));
+        }
+        else
+        {
+            const uint32_t queueIndex = tlsJobSystem == this ? tlsWorkerIndex : m_nextQueueIndex.fetch_add(1u, std::memory_order_relaxed) % m_queues.size();
+
+            const std::scoped_lock<std::mutex> lock(m_queues[queueIndex]->mutex);
+            m_queues[queueIndex]->jobs.emplace_back(std::move(job));
+        }
+
+        m_queuedJobCount.fetch_add(1u, std::memory_order_release);
+
+        // Lock and release the sleep mutex so a worker that is about to sleep cannot miss the notification.
+        {
+            const std::scoped_lock<std::mutex> lock(m_sleepMutex);
+        }
+
+        m_sleepCondition.notify_one();
+    }
+
+    bool JobSystem::tryRunJob(const bool canRunLowPriorityJobs)
+    {
+        const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+        const bool isWorker = tlsJobSystem == this;
+
+        Job job{};
+        bool foundJob = false;
+
+        // Workers first pop from the back of their own queue (most recently pushed, so likely to be hot in cache).
+        if (isWorker)
+        {
+            WorkerQueue& queue = *m_queues[tlsWorkerIndex];
+
+            const std::scoped_lock<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                foundJob = true;
+            }
+        }
+
+        // Steal from the front of the other queues.
+        const uint32_t stealStartIndex = isWorker ? tlsWorkerIndex + 1u : m_nextQueueIndex.load(std::memory_order_relaxed);
+        for (uint32_t i = 0u; i < queueCount && !foundJob; ++i)
+        {
+            const uint32_t queueIndex = (stealStartIndex + i) % queueCount;
+            if (isWorker && queueIndex == tlsWorkerIndex)
+            {
+                continue;
+            }
+
+            WorkerQueue& queue = *m_queues[queueIndex];
+
+            const std::scoped_lock<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                foundJob = true;
+            }
+        }
+
+        // Low priority jobs are run in submission order, once no normal job is left.
+        if (!foundJob && canRunLowPriorityJobs)
+        {
+            const std::scoped_lock<std::mutex> lock(m_lowPriorityQueue.mutex);
+            if (!m_lowPriorityQueue.jobs.empty())
+            {
+                job = std::move(m_lowPriorityQueue.jobs.front());
+                m_lowPriorityQueue.jobs.pop_front();
+                foundJob = true;
+            }
+        }
+
+        if (!foundJob)
+        {
+            return false;
+        }
+
+        m_queuedJobCount.fetch_sub(1u, std::memory_order_acq_rel);
+        execute(job);
+
+        return true;
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        JobCounter& counter = *job.counter;
+
+        try
+        {
+            job.function();
+        }
+        catch (...)
+        {
+            const std::scoped_lock<std::mutex> lock(counter.m_mutex);
+            if (!counter.m_exception)
+            {
+                counter.m_exception = std::current_exception();
+            }
+        }
+
+        std::vector<JobCounter::Continuation> continuations{};
+        {
+            const std::scoped_lock<std::mutex> lock(counter.m_mutex);
+            if (counter.m_pendingJobs.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+            {
+                continuations = std::move(counter.m_continuations);
+                counter.m_continuations.clear();
+            }
+        }
+
+        for (auto& continuation : continuations)
+        {
+            pushJob(Job{
+                .function = std::move(continuation.function),
+                .counter = continuation.counter,
+            });
+        }
+    }
+
+    void JobSystem::workerLoop(const std::stop_token stopToken, const uint32_t workerIndex)
+    {
+        tlsJobSystem = this;
+        tlsWorkerIndex = workerIndex;
+
+        while (!stopToken.stop_requested())
+        {
+            if (tryRunJob(true))
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepCondition.wait(lock, stopToken, [&]() { return m_queuedJobCount.load(std::memory_order_acquire) != 0u; });
+        }
+    }
+}
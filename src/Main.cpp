@@ -4,8 +4,33 @@
 
 int main(int arc, char** argv)
 {
-    Engine engine{"Simple GFX"};
-    engine.run();
+    std::vector<std::string_view> arguments(argv + 1, argv + arc);
+
+    // --compact-vertices uploads models with 16 byte quantized vertices, which may be combined with any of the modes below.
+    const bool compactVertices = std::erase(arguments, std::string_view("--compact-vertices")) > 0u;
+
+    Engine engine{"Simple GFX", compactVertices ? sgfx::VertexFormat::Compact : sgfx::VertexFormat::Float};
+
+    // --benchmark replays camera_path.bin without rendering and prints the triangles submitted per frame.
+    // --headless [frame count] runs the frame logic against the null render backend and prints the CPU frame times.
+    if (!arguments.empty() && arguments[0] == "--benchmark")
+    {
+        engine.runBenchmark();
+    }
+    else if (!arguments.empty() && arguments[0] == "--headless")
+    {
+        engine.runHeadless(arguments.size() > 1u ? static_cast<uint32_t>(std::stoul(std::string(arguments[1]))) : 1000u);
+    }
+    else
+    {
+#ifdef _WIN32
+        engine.run();
+#else
+        // The window and the D3D11 backend are Windows only.
+        std::cout << "Usage : SimpleGfx [--compact-vertices] --headless [frame count] | --benchmark\n";
+        return 1;
+#endif
+    }
 
     return 0;
-}
\ No newline at end of file
+}
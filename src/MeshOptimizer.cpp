@@ -0,0 +1,419 @@
+#include "Pch.hpp"
+
+#include "MeshOptimizer.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        // Size of the LRU cache simulated while optimizing, and the scoring constants from Forsyth's article.
+        constexpr uint32_t VERTEX_CACHE_SIZE = 32u;
+        constexpr float CACHE_DECAY_POWER = 1.5f;
+        constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+        constexpr float VALENCE_BOOST_SCALE = 2.0f;
+        constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+        // FIFO cache size used to find cluster boundaries while optimizing overdraw.
+        constexpr uint32_t OVERDRAW_CACHE_SIZE = 16u;
+
+        constexpr uint32_t FETCH_CACHE_LINE_SIZE = 64u;
+        constexpr uint32_t FETCH_CACHE_SIZE = 128u * 1024u;
+
+        float getVertexScore(const int32_t cachePosition, const uint32_t liveTriangleCount)
+        {
+            if (liveTriangleCount == 0u)
+            {
+                return -1.0f;
+            }
+
+            float score = 0.0f;
+
+            if (cachePosition >= 0)
+            {
+                // The vertices of the last triangle get a fixed score, so the next triangle does not depend on their order.
+                if (cachePosition < 3)
+                {
+                    score = LAST_TRIANGLE_SCORE;
+                }
+                else
+                {
+                    const float scaler = 1.0f / static_cast<float>(VERTEX_CACHE_SIZE - 3u);
+                    score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+                }
+            }
+
+            // Vertices with few triangles left are preferred, so they get finished rather than left as lone triangles.
+            score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(liveTriangleCount), -VALENCE_BOOST_POWER);
+
+            return score;
+        }
+
+        // Number of vertex transforms per triangle, simulating a FIFO cache.
+        std::vector<uint32_t> getTriangleCacheMisses(std::span<const uint32_t> indices, const uint32_t vertexCount, const uint32_t cacheSize)
+        {
+            std::vector<uint32_t> cacheTimestamps(vertexCount, 0u);
+            uint32_t timestamp = cacheSize + 1u;
+
+            std::vector<uint32_t> triangleCacheMisses(indices.size() / 3u, 0u);
+
+            for (const size_t i : std::views::iota(0u, indices.size()))
+            {
+                const uint32_t vertexIndex = indices[i];
+
+                if (timestamp - cacheTimestamps[vertexIndex] > cacheSize)
+                {
+                    cacheTimestamps[vertexIndex] = timestamp++;
+                    triangleCacheMisses[i / 3u]++;
+                }
+            }
+
+            return triangleCacheMisses;
+        }
+    }
+
+    void optimizeVertexCache(std::span<uint32_t> indices, const uint32_t vertexCount)
+    {
+        const size_t triangleCount = indices.size() / 3u;
+        if (triangleCount == 0u)
+        {
+            return;
+        }
+
+        // Triangles adjacent to each vertex, only the first liveTriangleCounts[v] entries of a vertex are not emitted yet.
+        std::vector<uint32_t> liveTriangleCounts(vertexCount, 0u);
+        for (const uint32_t index : indices)
+        {
+            liveTriangleCounts[index]++;
+        }
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1u, 0u);
+        for (const uint32_t i : std::views::iota(0u, vertexCount))
+        {
+            adjacencyOffsets[i + 1u] = adjacencyOffsets[i] + liveTriangleCounts[i];
+        }
+
+        std::vector<uint32_t> adjacentTriangles(indices.size());
+        {
+            std::vector<uint32_t> adjacencyCursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1u);
+            for (const size_t i : std::views::iota(0u, indices.size()))
+            {
+                adjacentTriangles[adjacencyCursors[indices[i]]++] = static_cast<uint32_t>(i / 3u);
+            }
+        }
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (const uint32_t i : std::views::iota(0u, vertexCount))
+        {
+            vertexScores[i] = getVertexScore(-1, liveTriangleCounts[i]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        for (const size_t i : std::views::iota(0u, triangleCount))
+        {
+            triangleScores[i] = vertexScores[indices[i * 3u]] + vertexScores[indices[i * 3u + 1u]] + vertexScores[indices[i * 3u + 2u]];
+        }
+
+        std::vector<bool> isTriangleEmitted(triangleCount, false);
+
+        std::vector<uint32_t> optimizedIndices{};
+        optimizedIndices.reserve(indices.size());
+
+        std::array<uint32_t, VERTEX_CACHE_SIZE + 3u> cache{};
+        std::array<uint32_t, VERTEX_CACHE_SIZE + 3u> newCache{};
+        uint32_t cacheCount = 0u;
+
+        size_t inputCursor = 0u;
+        uint32_t currentTriangle = 0u;
+
+        while (currentTriangle != INVALID_INDEX_U32)
+        {
+            const std::array<uint32_t, 3u> triangle = {
+                indices[currentTriangle * 3u],
+                indices[currentTriangle * 3u + 1u],
+                indices[currentTriangle * 3u + 2u],
+            };
+
+            optimizedIndices.insert(optimizedIndices.end(), triangle.begin(), triangle.end());
+            isTriangleEmitted[currentTriangle] = true;
+
+            // Remove the triangle from the adjacency of its vertices.
+            for (const uint32_t vertexIndex : triangle)
+            {
+                const auto begin = adjacentTriangles.begin() + adjacencyOffsets[vertexIndex];
+                const auto end = begin + liveTriangleCounts[vertexIndex];
+
+                std::iter_swap(std::find(begin, end, currentTriangle), end - 1);
+                liveTriangleCounts[vertexIndex]--;
+            }
+
+            // The vertices of the triangle move to the front of the cache, vertices pushed past the end are evicted.
+            uint32_t newCacheCount = 0u;
+            for (const uint32_t vertexIndex : triangle)
+            {
+                if (std::find(newCache.begin(), newCache.begin() + newCacheCount, vertexIndex) == newCache.begin() + newCacheCount)
+                {
+                    newCache[newCacheCount++] = vertexIndex;
+                }
+            }
+
+            for (const uint32_t vertexIndex : std::span(cache).first(cacheCount))
+            {
+                if (vertexIndex != triangle[0] && vertexIndex != triangle[1] && vertexIndex != triangle[2])
+                {
+                    newCache[newCacheCount++] = vertexIndex;
+                }
+            }
+
+            // Rescore every vertex whose cache position changed, and propagate the change to its remaining triangles.
+            for (const uint32_t i : std::views::iota(0u, newCacheCount))
+            {
+                const uint32_t vertexIndex = newCache[i];
+                cachePositions[vertexIndex] = i < VERTEX_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+
+                const float score = getVertexScore(cachePositions[vertexIndex], liveTriangleCounts[vertexIndex]);
+                const float scoreDelta = score - vertexScores[vertexIndex];
+                vertexScores[vertexIndex] = score;
+
+                for (const uint32_t triangleIndex : std::span(adjacentTriangles).subspan(adjacencyOffsets[vertexIndex], liveTriangleCounts[vertexIndex]))
+                {
+                    triangleScores[triangleIndex] += scoreDelta;
+                }
+            }
+
+            cacheCount = std::min(newCacheCount, VERTEX_CACHE_SIZE);
+            std::swap(cache, newCache);
+
+            // The next triangle is the best scoring one that uses a cached vertex.
+            currentTriangle = INVALID_INDEX_U32;
+            float bestScore = -1.0f;
+
+            for (const uint32_t vertexIndex : std::span(cache).first(cacheCount))
+            {
+                for (const uint32_t triangleIndex : std::span(adjacentTriangles).subspan(adjacencyOffsets[vertexIndex], liveTriangleCounts[vertexIndex]))
+                {
+                    if (triangleScores[triangleIndex] > bestScore)
+                    {
+                        bestScore = triangleScores[triangleIndex];
+                        currentTriangle = triangleIndex;
+                    }
+                }
+            }
+
+            // Dead end, continue with the next triangle in input order.
+            if (currentTriangle == INVALID_INDEX_U32)
+            {
+                while (inputCursor < triangleCount && isTriangleEmitted[inputCursor])
+                {
+                    inputCursor++;
+                }
+
+                if (inputCursor < triangleCount)
+                {
+                    currentTriangle = static_cast<uint32_t>(inputCursor);
+                }
+            }
+        }
+
+        std::ranges::copy(optimizedIndices, indices.begin());
+    }
+
+    void optimizeOverdraw(std::span<uint32_t> indices, std::span<const ModelVertex> vertices, const float threshold)
+    {
+        const size_t triangleCount = indices.size() / 3u;
+        if (triangleCount == 0u)
+        {
+            return;
+        }
+
+        const std::vector<uint32_t> triangleCacheMisses = getTriangleCacheMisses(indices, static_cast<uint32_t>(vertices.size()), OVERDRAW_CACHE_SIZE);
+
+        // Hard boundaries are where the cache has been completely flushed, so reordering clusters there does not cost extra transforms.
+        std::vector<size_t> hardBoundaries{};
+        for (const size_t i : std::views::iota(0u, triangleCount))
+        {
+            if (triangleCacheMisses[i] == 3u)
+            {
+                hardBoundaries.emplace_back(i);
+            }
+        }
+
+        hardBoundaries.emplace_back(triangleCount);
+
+        // Soft boundaries further split a hard cluster once the ACMR since the last split is within the threshold of the cluster's ACMR.
+        // The cache is flushed at every split, as the clusters may be drawn in any order afterwards.
+        std::vector<uint32_t> cacheTimestamps(vertices.size(), 0u);
+        uint32_t timestamp = OVERDRAW_CACHE_SIZE + 1u;
+
+        const auto getCacheMisses = [&](const size_t triangleIndex)
+        {
+            uint32_t cacheMisses = 0u;
+            for (const uint32_t vertexIndex : indices.subspan(triangleIndex * 3u, 3u))
+            {
+                if (timestamp - cacheTimestamps[vertexIndex] > OVERDRAW_CACHE_SIZE)
+                {
+                    cacheTimestamps[vertexIndex] = timestamp++;
+                    cacheMisses++;
+                }
+            }
+
+            return cacheMisses;
+        };
+
+        std::vector<size_t> clusterStarts{};
+        for (const size_t i : std::views::iota(0u, hardBoundaries.size() - 1u))
+        {
+            const size_t start = hardBoundaries[i];
+            const size_t end = hardBoundaries[i + 1u];
+
+            uint32_t clusterMisses = 0u;
+            for (const size_t j : std::views::iota(start, end))
+            {
+                clusterMisses += triangleCacheMisses[j];
+            }
+
+            const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+            clusterStarts.emplace_back(start);
+            timestamp += OVERDRAW_CACHE_SIZE + 1u;
+
+            uint32_t runningMisses = 0u;
+            uint32_t runningTriangles = 0u;
+
+            for (const size_t j : std::views::iota(start, end))
+            {
+                runningMisses += getCacheMisses(j);
+                runningTriangles++;
+
+                if (static_cast<float>(runningMisses) / static_cast<float>(runningTriangles) <= clusterThreshold && j + 1u < end)
+                {
+                    clusterStarts.emplace_back(j + 1u);
+                    timestamp += OVERDRAW_CACHE_SIZE + 1u;
+
+                    runningMisses = 0u;
+                    runningTriangles = 0u;
+                }
+            }
+        }
+
+        clusterStarts.emplace_back(triangleCount);
+
+        const size_t clusterCount = clusterStarts.size() - 1u;
+
+        math::XMVECTOR meshCentroid = math::XMVectorZero();
+        for (const ModelVertex& vertex : vertices)
+        {
+            meshCentroid = math::XMVectorAdd(meshCentroid, math::XMLoadFloat3(&vertex.position));
+        }
+
+        meshCentroid = math::XMVectorScale(meshCentroid, 1.0f / static_cast<float>(std::max<size_t>(vertices.size(), 1u)));
+
+        // Clusters that face away from the center of the mesh are likely to occlude others, so they are drawn first.
+        std::vector<float> clusterSortKeys(clusterCount);
+        for (const size_t i : std::views::iota(0u, clusterCount))
+        {
+            math::XMVECTOR clusterCentroid = math::XMVectorZero();
+            math::XMVECTOR clusterNormal = math::XMVectorZero();
+            float clusterArea = 0.0f;
+
+            for (const size_t j : std::views::iota(clusterStarts[i], clusterStarts[i + 1u]))
+            {
+                const math::XMVECTOR p0 = math::XMLoadFloat3(&vertices[indices[j * 3u]].position);
+                const math::XMVECTOR p1 = math::XMLoadFloat3(&vertices[indices[j * 3u + 1u]].position);
+                const math::XMVECTOR p2 = math::XMLoadFloat3(&vertices[indices[j * 3u + 2u]].position);
+
+                const math::XMVECTOR normal = math::XMVector3Cross(math::XMVectorSubtract(p1, p0), math::XMVectorSubtract(p2, p0));
+                const float area = math::XMVectorGetX(math::XMVector3Length(normal));
+
+                clusterCentroid = math::XMVectorAdd(clusterCentroid, math::XMVectorScale(math::XMVectorAdd(math::XMVectorAdd(p0, p1), p2), area / 3.0f));
+                clusterNormal = math::XMVectorAdd(clusterNormal, normal);
+                clusterArea += area;
+            }
+
+            clusterCentroid = clusterArea > 0.0f ? math::XMVectorScale(clusterCentroid, 1.0f / clusterArea) : meshCentroid;
+            clusterNormal = math::XMVector3Normalize(clusterNormal);
+
+            clusterSortKeys[i] = math::XMVectorGetX(math::XMVector3Dot(math::XMVectorSubtract(clusterCentroid, meshCentroid), clusterNormal));
+        }
+
+        std::vector<uint32_t> clusterOrder(clusterCount);
+        std::iota(clusterOrder.begin(), clusterOrder.end(), 0u);
+        std::ranges::stable_sort(clusterOrder, [&](const uint32_t a, const uint32_t b) { return clusterSortKeys[a] > clusterSortKeys[b]; });
+
+        std::vector<uint32_t> optimizedIndices{};
+        optimizedIndices.reserve(indices.size());
+
+        for (const uint32_t clusterIndex : clusterOrder)
+        {
+            const auto clusterIndices = indices.subspan(clusterStarts[clusterIndex] * 3u, (clusterStarts[clusterIndex + 1u] - clusterStarts[clusterIndex]) * 3u);
+            optimizedIndices.insert(optimizedIndices.end(), clusterIndices.begin(), clusterIndices.end());
+        }
+
+        std::ranges::copy(optimizedIndices, indices.begin());
+    }
+
+    void optimizeVertexFetch(std::vector<ModelVertex>& vertices, std::span<uint32_t> indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX_U32);
+        std::vector<ModelVertex> optimizedVertices{};
+        optimizedVertices.reserve(vertices.size());
+
+        for (uint32_t& index : indices)
+        {
+            if (remap[index] == INVALID_INDEX_U32)
+            {
+                remap[index] = static_cast<uint32_t>(optimizedVertices.size());
+                optimizedVertices.emplace_back(vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        vertices = std::move(optimizedVertices);
+    }
+
+    VertexCacheStatistics analyzeVertexCache(std::span<const uint32_t> indices, const uint32_t vertexCount, const uint32_t cacheSize)
+    {
+        VertexCacheStatistics statistics{
+            .triangleCount = indices.size() / 3u,
+            .vertexCount = vertexCount,
+        };
+
+        for (const uint32_t triangleCacheMisses : getTriangleCacheMisses(indices, vertexCount, cacheSize))
+        {
+            statistics.vertexTransformCount += triangleCacheMisses;
+        }
+
+        return statistics;
+    }
+
+    VertexFetchStatistics analyzeVertexFetch(std::span<const uint32_t> indices, const uint32_t vertexCount, const uint32_t vertexSize)
+    {
+        VertexFetchStatistics statistics{
+            .vertexBufferSize = static_cast<uint64_t>(vertexCount) * vertexSize,
+        };
+
+        // Approximates an LRU cache : a line hits if it was fetched within the last FETCH_CACHE_SIZE bytes of misses.
+        constexpr uint32_t cacheLineCount = FETCH_CACHE_SIZE / FETCH_CACHE_LINE_SIZE;
+
+        std::vector<uint32_t> lineTimestamps((statistics.vertexBufferSize + FETCH_CACHE_LINE_SIZE - 1u) / FETCH_CACHE_LINE_SIZE, 0u);
+        uint32_t timestamp = cacheLineCount + 1u;
+
+        for (const uint32_t index : indices)
+        {
+            const uint64_t startLine = static_cast<uint64_t>(index) * vertexSize / FETCH_CACHE_LINE_SIZE;
+            const uint64_t endLine = (static_cast<uint64_t>(index + 1u) * vertexSize - 1u) / FETCH_CACHE_LINE_SIZE;
+
+            for (const uint64_t line : std::views::iota(startLine, endLine + 1u))
+            {
+                if (timestamp - lineTimestamps[line] > cacheLineCount)
+                {
+                    lineTimestamps[line] = timestamp++;
+                    statistics.bytesFetched += FETCH_CACHE_LINE_SIZE;
+                }
+            }
+        }
+
+        return statistics;
+    }
+}
@@ -0,0 +1,478 @@
+#include "Pch.hpp"
+
+#include "MeshSimplifier.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        // Border edges get an extra plane perpendicular to their triangle, weighted so borders are preserved over interior detail.
+        constexpr double BORDER_EDGE_WEIGHT = 10.0;
+
+        // Cosine of the largest rotation a collapse may apply to a remaining triangle.
+        constexpr float MAXIMUM_ROTATION_COSINE = 0.25f;
+
+        enum class VertexKind : uint8_t
+        {
+            // Interior vertex, may collapse onto any neighbour.
+            Manifold,
+            // On a single open border, may only collapse along it.
+            Border,
+            // Seam, non manifold or complex border vertex, never moved (but other vertices may collapse onto it).
+            Locked,
+        };
+
+        // Sum of squared distances to a set of weighted planes, stored as the upper half of the symmetric 4x4 matrix.
+        struct Quadric
+        {
+            double a2{};
+            double ab{};
+            double ac{};
+            double ad{};
+            double b2{};
+            double bc{};
+            double bd{};
+            double c2{};
+            double cd{};
+            double d2{};
+
+            double weight{};
+
+            void addPlane(const double a, const double b, const double c, const double d, const double planeWeight)
+            {
+                a2 += a * a * planeWeight;
+                ab += a * b * planeWeight;
+                ac += a * c * planeWeight;
+                ad += a * d * planeWeight;
+                b2 += b * b * planeWeight;
+                bc += b * c * planeWeight;
+                bd += b * d * planeWeight;
+                c2 += c * c * planeWeight;
+                cd += c * d * planeWeight;
+                d2 += d * d * planeWeight;
+
+                weight += planeWeight;
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                a2 += other.a2;
+                ab += other.ab;
+                ac += other.ac;
+                ad += other.ad;
+                b2 += other.b2;
+                bc += other.bc;
+                bd += other.bd;
+                c2 += other.c2;
+                cd += other.cd;
+                d2 += other.d2;
+
+                weight += other.weight;
+
+                return *this;
+            }
+
+            // Weighted mean of the squared distances from the point to the planes.
+            double getError(const math::XMFLOAT3& point) const
+            {
+                const double x = point.x;
+                const double y = point.y;
+                const double z = point.z;
+
+                const double error = a2 * x * x + b2 * y * y + c2 * z * z + 2.0 * (ab * x * y + ac * x * z + bc * y * z) + 2.0 * (ad * x + bd * y + cd * z) + d2;
+
+                return weight > 0.0 ? std::abs(error) / weight : 0.0;
+            }
+        };
+
+        struct Collapse
+        {
+            uint32_t source{};
+            uint32_t target{};
+            double cost{};
+        };
+
+        struct PositionKey
+        {
+            std::array<uint32_t, 3u> bits{};
+
+            bool operator==(const PositionKey&) const = default;
+        };
+
+        struct PositionKeyHash
+        {
+            size_t operator()(const PositionKey& key) const
+            {
+                return static_cast<size_t>(hashCombine(hashCombine(key.bits[0], key.bits[1]), key.bits[2]));
+            }
+        };
+
+        uint64_t getEdgeKey(const uint32_t from, const uint32_t to) { return (static_cast<uint64_t>(from) << 32u) | to; }
+
+        math::XMFLOAT3 subtract(const math::XMFLOAT3& a, const math::XMFLOAT3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+
+        math::XMFLOAT3 cross(const math::XMFLOAT3& a, const math::XMFLOAT3& b) { return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+
+        float dot(const math::XMFLOAT3& a, const math::XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+        // Maps every vertex to the first vertex sharing its position, so topology can be analyzed across attribute seams.
+        std::vector<uint32_t> getPositionRemap(std::span<const ModelVertex> vertices)
+        {
+            std::unordered_map<PositionKey, uint32_t, PositionKeyHash> firstVertices{};
+            firstVertices.reserve(vertices.size());
+
+            std::vector<uint32_t> positionRemap(vertices.size());
+
+            for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(vertices.size())))
+            {
+                const PositionKey key{
+                    .bits = {std::bit_cast<uint32_t>(vertices[i].position.x), std::bit_cast<uint32_t>(vertices[i].position.y), std::bit_cast<uint32_t>(vertices[i].position.z)},
+                };
+
+                positionRemap[i] = firstVertices.try_emplace(key, i).first->second;
+            }
+
+            return positionRemap;
+        }
+
+        // Half edge use counts in position space, an edge is open (on a border) if it is used in a single direction only once.
+        std::unordered_map<uint64_t, uint32_t> getHalfEdges(std::span<const uint32_t> indices, std::span<const uint32_t> positionRemap)
+        {
+            std::unordered_map<uint64_t, uint32_t> halfEdges{};
+            halfEdges.reserve(indices.size());
+
+            for (size_t i = 0u; i < indices.size(); i += 3u)
+            {
+                for (const uint32_t corner : std::views::iota(0u, 3u))
+                {
+                    const uint32_t from = positionRemap[indices[i + corner]];
+                    const uint32_t to = positionRemap[indices[i + (corner + 1u) % 3u]];
+
+                    halfEdges[getEdgeKey(from, to)]++;
+                }
+            }
+
+            return halfEdges;
+        }
+
+        bool isOpenEdge(const std::unordered_map<uint64_t, uint32_t>& halfEdges, const uint32_t from, const uint32_t to)
+        {
+            const auto forward = halfEdges.find(getEdgeKey(from, to));
+            const auto backward = halfEdges.find(getEdgeKey(to, from));
+
+            const uint32_t forwardCount = forward != halfEdges.end() ? forward->second : 0u;
+            const uint32_t backwardCount = backward != halfEdges.end() ? backward->second : 0u;
+
+            return forwardCount + backwardCount == 1u;
+        }
+
+        std::vector<VertexKind> classifyVertices(const std::unordered_map<uint64_t, uint32_t>& halfEdges, std::span<const uint32_t> positionRemap)
+        {
+            std::vector<uint32_t> wedgeCounts(positionRemap.size(), 0u);
+            for (const uint32_t position : positionRemap)
+            {
+                wedgeCounts[position]++;
+            }
+
+            std::vector<uint32_t> openEdgeCounts(positionRemap.size(), 0u);
+            std::vector<bool> isNonManifold(positionRemap.size(), false);
+
+            for (const auto& [edgeKey, count] : halfEdges)
+            {
+                const uint32_t from = static_cast<uint32_t>(edgeKey >> 32u);
+                const uint32_t to = static_cast<uint32_t>(edgeKey & 0xffffffffu);
+
+                const auto backward = halfEdges.find(getEdgeKey(to, from));
+                const uint32_t backwardCount = backward != halfEdges.end() ? backward->second : 0u;
+
+                if (count > 1u || backwardCount > 1u)
+                {
+                    isNonManifold[from] = true;
+                    isNonManifold[to] = true;
+                }
+                else if (backwardCount == 0u)
+                {
+                    openEdgeCounts[from]++;
+                    openEdgeCounts[to]++;
+                }
+            }
+
+            std::vector<VertexKind> vertexKinds(positionRemap.size(), VertexKind::Locked);
+
+            for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(positionRemap.size())))
+            {
+                const uint32_t position = positionRemap[i];
+
+                if (wedgeCounts[position] > 1u || isNonManifold[position])
+                {
+                    continue;
+                }
+
+                if (openEdgeCounts[position] == 0u)
+                {
+                    vertexKinds[i] = VertexKind::Manifold;
+                }
+                else if (openEdgeCounts[position] == 2u)
+                {
+                    vertexKinds[i] = VertexKind::Border;
+                }
+            }
+
+            return vertexKinds;
+        }
+
+        std::vector<Quadric> computeQuadrics(std::span<const uint32_t> indices,
+                                             std::span<const ModelVertex> vertices,
+                                             std::span<const uint32_t> positionRemap,
+                                             const std::unordered_map<uint64_t, uint32_t>& halfEdges)
+        {
+            std::vector<Quadric> quadrics(vertices.size());
+
+            for (size_t i = 0u; i < indices.size(); i += 3u)
+            {
+                const std::array<uint32_t, 3u> triangle = {indices[i], indices[i + 1u], indices[i + 2u]};
+
+                const math::XMFLOAT3& a = vertices[triangle[0]].position;
+                const math::XMFLOAT3& b = vertices[triangle[1]].position;
+                const math::XMFLOAT3& c = vertices[triangle[2]].position;
+
+                const math::XMFLOAT3 normal = cross(subtract(b, a), subtract(c, a));
+                const float normalLength = std::sqrt(dot(normal, normal));
+                if (normalLength <= 0.0f)
+                {
+                    continue;
+                }
+
+                const math::XMFLOAT3 unitNormal = {normal.x / normalLength, normal.y / normalLength, normal.z / normalLength};
+                const float area = normalLength * 0.5f;
+
+                Quadric triangleQuadric{};
+                triangleQuadric.addPlane(unitNormal.x, unitNormal.y, unitNormal.z, -dot(unitNormal, a), area);
+
+                for (const uint32_t corner : std::views::iota(0u, 3u))
+                {
+                    quadrics[positionRemap[triangle[corner]]] += triangleQuadric;
+
+                    const uint32_t from = positionRemap[triangle[corner]];
+                    const uint32_t to = positionRemap[triangle[(corner + 1u) % 3u]];
+
+                    if (!isOpenEdge(halfEdges, from, to))
+                    {
+                        continue;
+                    }
+
+                    // Plane containing the border edge, perpendicular to the triangle.
+                    const math::XMFLOAT3& edgeStart = vertices[from].position;
+                    const math::XMFLOAT3 edge = subtract(vertices[to].position, edgeStart);
+
+                    const math::XMFLOAT3 edgeNormal = cross(edge, unitNormal);
+                    const float edgeNormalLength = std::sqrt(dot(edgeNormal, edgeNormal));
+                    if (edgeNormalLength <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    const math::XMFLOAT3 unitEdgeNormal = {edgeNormal.x / edgeNormalLength, edgeNormal.y / edgeNormalLength, edgeNormal.z / edgeNormalLength};
+
+                    Quadric edgeQuadric{};
+                    edgeQuadric.addPlane(unitEdgeNormal.x, unitEdgeNormal.y, unitEdgeNormal.z, -dot(unitEdgeNormal, edgeStart), dot(edge, edge) * BORDER_EDGE_WEIGHT);
+
+                    quadrics[from] += edgeQuadric;
+                    quadrics[to] += edgeQuadric;
+                }
+            }
+
+            return quadrics;
+        }
+    }
+
+    std::vector<uint32_t> simplifyMesh(std::span<const uint32_t> indices,
+                                       std::span<const ModelVertex> vertices,
+                                       const size_t targetIndexCount,
+                                       const float targetError,
+                                       float& outError)
+    {
+        outError = 0.0f;
+
+        std::vector<uint32_t> result(indices.begin(), indices.end());
+
+        const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        const size_t targetTriangleCount = targetIndexCount / 3u;
+        const double maximumCost = static_cast<double>(targetError) * static_cast<double>(targetError);
+
+        const std::vector<uint32_t> positionRemap = getPositionRemap(vertices);
+
+        // Quadrics are indexed by position, and accumulate the quadrics of the vertices collapsed onto them.
+        std::vector<Quadric> quadrics = computeQuadrics(result, vertices, positionRemap, getHalfEdges(result, positionRemap));
+
+        double largestCost = 0.0;
+
+        std::vector<Collapse> collapses{};
+        std::vector<uint32_t> vertexRemap(vertexCount);
+        std::vector<bool> isVertexLocked(vertexCount);
+        std::vector<uint32_t> vertexTriangleOffsets(vertexCount + 1u);
+        std::vector<uint32_t> vertexTriangles{};
+
+        // Each pass applies the cheapest collapses that do not touch a vertex already modified in that pass, then compacts the index list.
+        while (result.size() / 3u > targetTriangleCount)
+        {
+            const std::unordered_map<uint64_t, uint32_t> halfEdges = getHalfEdges(result, positionRemap);
+            const std::vector<VertexKind> vertexKinds = classifyVertices(halfEdges, positionRemap);
+
+            // Triangles adjacent to each vertex, used to reject collapses that would flip a triangle.
+            std::ranges::fill(vertexTriangleOffsets, 0u);
+            for (const uint32_t index : result)
+            {
+                vertexTriangleOffsets[index + 1u]++;
+            }
+
+            std::partial_sum(vertexTriangleOffsets.begin(), vertexTriangleOffsets.end(), vertexTriangleOffsets.begin());
+
+            vertexTriangles.resize(result.size());
+            std::vector<uint32_t> vertexTriangleCounts(vertexCount, 0u);
+            for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(result.size())))
+            {
+                const uint32_t index = result[i];
+                vertexTriangles[vertexTriangleOffsets[index] + vertexTriangleCounts[index]++] = i / 3u;
+            }
+
+            collapses.clear();
+
+            for (size_t i = 0u; i < result.size(); i += 3u)
+            {
+                for (const uint32_t corner : std::views::iota(0u, 3u))
+                {
+                    const uint32_t first = result[i + corner];
+                    const uint32_t second = result[i + (corner + 1u) % 3u];
+
+                    for (const auto& [source, target] : {std::pair{first, second}, std::pair{second, first}})
+                    {
+                        const VertexKind sourceKind = vertexKinds[source];
+
+                        if (sourceKind == VertexKind::Locked || positionRemap[source] == positionRemap[target] ||
+                            (sourceKind == VertexKind::Border && !isOpenEdge(halfEdges, positionRemap[source], positionRemap[target])))
+                        {
+                            continue;
+                        }
+
+                        Quadric quadric = quadrics[positionRemap[source]];
+                        quadric += quadrics[positionRemap[target]];
+
+                        collapses.emplace_back(Collapse{
+                            .source = source,
+                            .target = target,
+                            .cost = quadric.getError(vertices[target].position),
+                        });
+                    }
+                }
+            }
+
+            std::ranges::sort(collapses, [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+            std::iota(vertexRemap.begin(), vertexRemap.end(), 0u);
+            std::fill(isVertexLocked.begin(), isVertexLocked.end(), false);
+
+            size_t triangleCount = result.size() / 3u;
+            uint32_t collapseCount = 0u;
+
+            for (const Collapse& collapse : collapses)
+            {
+                if (triangleCount <= targetTriangleCount || collapse.cost > maximumCost)
+                {
+                    break;
+                }
+
+                const uint32_t sourcePosition = positionRemap[collapse.source];
+                const uint32_t targetPosition = positionRemap[collapse.target];
+
+                if (isVertexLocked[sourcePosition] || isVertexLocked[targetPosition])
+                {
+                    continue;
+                }
+
+                // Reject the collapse if any remaining triangle around the source would flip, and count the triangles that become degenerate.
+                // Rotations close to 90 degrees are rejected as well, as over several passes they add up to a flip.
+                bool hasFlip = false;
+                uint32_t removedTriangleCount = 0u;
+
+                for (const uint32_t triangleIndex : std::views::iota(vertexTriangleOffsets[collapse.source], vertexTriangleOffsets[collapse.source + 1u]))
+                {
+                    const uint32_t triangle = vertexTriangles[triangleIndex];
+
+                    std::array<uint32_t, 3u> corners = {
+                        vertexRemap[result[triangle * 3u + 0u]],
+                        vertexRemap[result[triangle * 3u + 1u]],
+                        vertexRemap[result[triangle * 3u + 2u]],
+                    };
+
+                    if (std::ranges::any_of(corners, [&](const uint32_t corner) { return positionRemap[corner] == targetPosition; }))
+                    {
+                        removedTriangleCount++;
+                        continue;
+                    }
+
+                    const math::XMFLOAT3 normalBefore =
+                        cross(subtract(vertices[corners[1]].position, vertices[corners[0]].position), subtract(vertices[corners[2]].position, vertices[corners[0]].position));
+
+                    for (uint32_t& corner : corners)
+                    {
+                        corner = corner == collapse.source ? collapse.target : corner;
+                    }
+
+                    const math::XMFLOAT3 normalAfter =
+                        cross(subtract(vertices[corners[1]].position, vertices[corners[0]].position), subtract(vertices[corners[2]].position, vertices[corners[0]].position));
+
+                    if (dot(normalBefore, normalAfter) <= MAXIMUM_ROTATION_COSINE * std::sqrt(dot(normalBefore, normalBefore) * dot(normalAfter, normalAfter)))
+                    {
+                        hasFlip = true;
+                        break;
+                    }
+                }
+
+                if (hasFlip)
+                {
+                    continue;
+                }
+
+                vertexRemap[collapse.source] = collapse.target;
+                quadrics[targetPosition] += quadrics[sourcePosition];
+
+                isVertexLocked[sourcePosition] = true;
+                isVertexLocked[targetPosition] = true;
+
+                largestCost = std::max(largestCost, collapse.cost);
+                triangleCount -= std::min<size_t>(removedTriangleCount, triangleCount);
+                collapseCount++;
+            }
+
+            if (collapseCount == 0u)
+            {
+                break;
+            }
+
+            // Apply the collapses and drop the triangles that became degenerate (two corners at the same position).
+            size_t writeIndex = 0u;
+            for (size_t i = 0u; i < result.size(); i += 3u)
+            {
+                const uint32_t a = vertexRemap[result[i + 0u]];
+                const uint32_t b = vertexRemap[result[i + 1u]];
+                const uint32_t c = vertexRemap[result[i + 2u]];
+
+                if (positionRemap[a] == positionRemap[b] || positionRemap[b] == positionRemap[c] || positionRemap[a] == positionRemap[c])
+                {
+                    continue;
+                }
+
+                result[writeIndex++] = a;
+                result[writeIndex++] = b;
+                result[writeIndex++] = c;
+            }
+
+            result.resize(writeIndex);
+        }
+
+        outError = static_cast<float>(std::sqrt(largestCost));
+
+        return result;
+    }
+}
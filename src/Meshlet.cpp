@@ -0,0 +1,232 @@
+#include "Pch.hpp"
+
+#include "Meshlet.hpp"
+
+#include "Frustum.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        // Meshlets whose normals spread further than this (cosine of the cone half angle) are unlikely to ever be fully backfacing.
+        constexpr float MINIMUM_CONE_DOT = 0.1f;
+
+        MeshletData createMeshlet(std::span<const uint32_t> indices,
+                                  std::span<const ModelVertex> vertices,
+                                  std::span<const uint32_t> meshletVertices,
+                                  const uint32_t firstTriangle,
+                                  const uint32_t triangleCount)
+        {
+            MeshletData meshlet{
+                .firstIndex = firstTriangle * 3u,
+                .indexCount = triangleCount * 3u,
+            };
+
+            math::XMVECTOR boundsMinimum = math::XMVectorReplicate(std::numeric_limits<float>::max());
+            math::XMVECTOR boundsMaximum = math::XMVectorReplicate(std::numeric_limits<float>::lowest());
+
+            for (const uint32_t vertexIndex : meshletVertices)
+            {
+                const math::XMVECTOR position = math::XMLoadFloat3(&vertices[vertexIndex].position);
+                boundsMinimum = math::XMVectorMin(boundsMinimum, position);
+                boundsMaximum = math::XMVectorMax(boundsMaximum, position);
+            }
+
+            math::XMStoreFloat3(&meshlet.bounds.minimum, boundsMinimum);
+            math::XMStoreFloat3(&meshlet.bounds.maximum, boundsMaximum);
+
+            // The sphere is centered on the bounds, with the radius reaching the furthest vertex.
+            const math::XMVECTOR sphereCenter = math::XMVectorScale(math::XMVectorAdd(boundsMinimum, boundsMaximum), 0.5f);
+
+            float sphereRadius = 0.0f;
+            for (const uint32_t vertexIndex : meshletVertices)
+            {
+                const math::XMVECTOR position = math::XMLoadFloat3(&vertices[vertexIndex].position);
+                sphereRadius = std::max(sphereRadius, math::XMVectorGetX(math::XMVector3Length(math::XMVectorSubtract(position, sphereCenter))));
+            }
+
+            math::XMStoreFloat3(&meshlet.sphereCenter, sphereCenter);
+            meshlet.sphereRadius = sphereRadius;
+
+            // The cone axis is the average of the triangle normals, and the cone is as wide as the normal furthest from it.
+            // For glTF (counter clockwise) winding, cross(b - a, c - a) points out of the front face. Viewed in the left handed view space the
+            // same triangles are clockwise, which is the rasterizer's front face, so this normal points towards the viewer when not culled.
+            std::vector<math::XMVECTOR> triangleNormals{};
+            triangleNormals.reserve(triangleCount);
+
+            math::XMVECTOR normalSum = math::XMVectorZero();
+
+            for (const uint32_t triangle : std::views::iota(firstTriangle, firstTriangle + triangleCount))
+            {
+                const math::XMVECTOR a = math::XMLoadFloat3(&vertices[indices[triangle * 3u + 0u]].position);
+                const math::XMVECTOR b = math::XMLoadFloat3(&vertices[indices[triangle * 3u + 1u]].position);
+                const math::XMVECTOR c = math::XMLoadFloat3(&vertices[indices[triangle * 3u + 2u]].position);
+
+                const math::XMVECTOR normal = math::XMVector3Cross(math::XMVectorSubtract(b, a), math::XMVectorSubtract(c, a));
+                const float normalLength = math::XMVectorGetX(math::XMVector3Length(normal));
+
+                // Degenerate triangles are never rasterized, so they do not constrain the cone.
+                if (normalLength > 0.0f)
+                {
+                    triangleNormals.emplace_back(math::XMVectorScale(normal, 1.0f / normalLength));
+                    normalSum = math::XMVectorAdd(normalSum, triangleNormals.back());
+                }
+            }
+
+            const float normalSumLength = math::XMVectorGetX(math::XMVector3Length(normalSum));
+            if (triangleNormals.empty() || normalSumLength <= 0.0f)
+            {
+                return meshlet;
+            }
+
+            const math::XMVECTOR coneAxis = math::XMVectorScale(normalSum, 1.0f / normalSumLength);
+
+            float minimumDot = 1.0f;
+            for (const math::XMVECTOR& normal : triangleNormals)
+            {
+                minimumDot = std::min(minimumDot, math::XMVectorGetX(math::XMVector3Dot(normal, coneAxis)));
+            }
+
+            if (minimumDot <= MINIMUM_CONE_DOT)
+            {
+                return meshlet;
+            }
+
+            // Every triangle faces away from the camera when the view direction is within 90 - coneAngle of the axis,
+            // i.e when dot(view direction, axis) >= cos(90 - coneAngle) = sin(coneAngle).
+            math::XMStoreFloat3(&meshlet.coneAxis, coneAxis);
+            meshlet.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+
+            return meshlet;
+        }
+    }
+
+    std::vector<MeshletData> buildMeshlets(std::span<const uint32_t> indices,
+                                           std::span<const ModelVertex> vertices,
+                                           const uint32_t maxVertexCount,
+                                           const uint32_t maxTriangleCount)
+    {
+        std::vector<MeshletData> meshlets{};
+
+        // Index of the last meshlet that referenced each vertex, so membership of the current meshlet is a single compare.
+        std::vector<uint32_t> vertexMeshlet(vertices.size(), INVALID_INDEX_U32);
+
+        std::vector<uint32_t> meshletVertices{};
+        meshletVertices.reserve(maxVertexCount);
+
+        uint32_t firstTriangle = 0u;
+        uint32_t triangleCount = 0u;
+
+        const uint32_t totalTriangleCount = static_cast<uint32_t>(indices.size() / 3u);
+
+        for (const uint32_t triangle : std::views::iota(0u, totalTriangleCount))
+        {
+            const std::array<uint32_t, 3u> triangleIndices = {indices[triangle * 3u + 0u], indices[triangle * 3u + 1u], indices[triangle * 3u + 2u]};
+
+            const auto countNewVertices = [&](const uint32_t meshletIndex)
+            {
+                uint32_t newVertexCount = 0u;
+                for (const uint32_t i : std::views::iota(0u, 3u))
+                {
+                    const bool isDuplicate = (i > 0u && triangleIndices[i] == triangleIndices[0]) || (i > 1u && triangleIndices[i] == triangleIndices[1]);
+                    newVertexCount += (vertexMeshlet[triangleIndices[i]] != meshletIndex && !isDuplicate) ? 1u : 0u;
+                }
+
+                return newVertexCount;
+            };
+
+            uint32_t meshletIndex = static_cast<uint32_t>(meshlets.size());
+
+            if (triangleCount == maxTriangleCount || meshletVertices.size() + countNewVertices(meshletIndex) > maxVertexCount)
+            {
+                meshlets.emplace_back(createMeshlet(indices, vertices, meshletVertices, firstTriangle, triangleCount));
+
+                meshletVertices.clear();
+                firstTriangle = triangle;
+                triangleCount = 0u;
+
+                meshletIndex++;
+            }
+
+            for (const uint32_t vertexIndex : triangleIndices)
+            {
+                if (vertexMeshlet[vertexIndex] != meshletIndex)
+                {
+                    vertexMeshlet[vertexIndex] = meshletIndex;
+                    meshletVertices.emplace_back(vertexIndex);
+                }
+            }
+
+            triangleCount++;
+        }
+
+        if (triangleCount > 0u)
+        {
+            meshlets.emplace_back(createMeshlet(indices, vertices, meshletVertices, firstTriangle, triangleCount));
+        }
+
+        return meshlets;
+    }
+
+    MeshletCullingStats& MeshletCullingStats::operator+=(const MeshletCullingStats& other)
+    {
+        meshletCount += other.meshletCount;
+        frustumCulledMeshletCount += other.frustumCulledMeshletCount;
+        backfaceCulledMeshletCount += other.backfaceCulledMeshletCount;
+
+        triangleCount += other.triangleCount;
+        frustumCulledTriangleCount += other.frustumCulledTriangleCount;
+        backfaceCulledTriangleCount += other.backfaceCulledTriangleCount;
+
+        return *this;
+    }
+
+    MeshletCullingStats cullMeshlets(std::span<const MeshletData> meshlets,
+                                     const Frustum& frustum,
+                                     const math::XMFLOAT3& cameraPosition,
+                                     const bool cullBackfaces,
+                                     std::vector<uint32_t>& visibleMeshlets)
+    {
+        MeshletCullingStats stats{.meshletCount = static_cast<uint32_t>(meshlets.size())};
+
+        for (const uint32_t meshletIndex : std::views::iota(0u, static_cast<uint32_t>(meshlets.size())))
+        {
+            const MeshletData& meshlet = meshlets[meshletIndex];
+            const uint32_t triangleCount = meshlet.indexCount / 3u;
+
+            stats.triangleCount += triangleCount;
+
+            // The sphere test is cheaper, the box test is tighter for elongated meshlets.
+            if (!isSphereInFrustum(frustum, meshlet.sphereCenter, meshlet.sphereRadius) || !isAabbInFrustum(frustum, meshlet.bounds))
+            {
+                stats.frustumCulledMeshletCount++;
+                stats.frustumCulledTriangleCount += triangleCount;
+                continue;
+            }
+
+            // Conservative for the whole bounding sphere : dot(center - camera, axis) >= cutoff * |center - camera| + radius.
+            if (cullBackfaces && meshlet.coneCutoff < 1.0f)
+            {
+                const math::XMFLOAT3 viewVector = {
+                    meshlet.sphereCenter.x - cameraPosition.x,
+                    meshlet.sphereCenter.y - cameraPosition.y,
+                    meshlet.sphereCenter.z - cameraPosition.z,
+                };
+
+                const float viewDistance = std::sqrt(viewVector.x * viewVector.x + viewVector.y * viewVector.y + viewVector.z * viewVector.z);
+                const float axisDot = viewVector.x * meshlet.coneAxis.x + viewVector.y * meshlet.coneAxis.y + viewVector.z * meshlet.coneAxis.z;
+
+                if (axisDot >= meshlet.coneCutoff * viewDistance + meshlet.sphereRadius)
+                {
+                    stats.backfaceCulledMeshletCount++;
+                    stats.backfaceCulledTriangleCount += triangleCount;
+                    continue;
+                }
+            }
+
+            visibleMeshlets.emplace_back(meshletIndex);
+        }
+
+        return stats;
+    }
+}
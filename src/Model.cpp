@@ -2,10 +2,17 @@
 
 #include "Model.hpp"
 
-#define STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "AccessorConversion.hpp"
+#include "Frustum.hpp"
+#include "GeometryPool.hpp"
+#include "JobSystem.hpp"
+#include "MeshSimplifier.hpp"
+#include "ModelCache.hpp"
+#include "Profiler.hpp"
+#include "TangentGeneration.hpp"
+#include "VertexQuantization.hpp"
+
 #include <stb_image.h>
-#include <stb_image_write.h>
 
 #define TINYGLTF_NOEXCEPTION
 #define JSON_NOEXCEPTION
@@ -16,606 +23,1629 @@
 #define TINYGLTF_IMPLEMENTATION
 #include <tiny_gltf.h>
 
-#include <DirectXTex.h>
-
 namespace sgfx
 {
-    Model::Model(ID3D11Device* const device, ID3D11ShaderResourceView* const fallbackSrv, const std::string_view modelPath, const TransformComponent& transformData)
-        : m_modelPath(modelPath), m_fallbackSrv(fallbackSrv), m_transformComponent(transformData)
-    {
-        // Create the transform buffer.
-        const D3D11_BUFFER_DESC bufferDesc = {
-            .ByteWidth = static_cast<uint32_t>(sizeof(TransformBuffer)),
-            .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
-        };
+    namespace
+    {
+        // Same rotation as XMMatrixRotationRollPitchYawFromVector, as a quaternion.
+        LocalTransform toLocalTransform(const TransformComponent& transformComponent)
+        {
+            LocalTransform localTransform{
+                .translation = transformComponent.translate,
+                .scale = transformComponent.scale,
+            };
+
+            math::XMStoreFloat4(&localTransform.rotation, math::XMQuaternionRotationRollPitchYawFromVector(math::XMLoadFloat3(&transformComponent.rotation)));
+
+            return localTransform;
+        }
+
+        // Only the full resolution indices, which come first.
+        std::vector<uint32_t> readMeshIndices(const ModelData& modelData, const MeshData& meshData)
+        {
+            std::vector<uint32_t> indices(meshData.indexCount);
+
+            if (meshData.indexSize == sizeof(uint16_t))
+            {
+                const std::span<const std::byte> indexData = modelData.indexData.subspan(meshData.indexByteOffset, static_cast<size_t>(meshData.indexCount) * sizeof(uint16_t));
 
-        const D3D11_SUBRESOURCE_DATA subresourceData = {.pSysMem = &transformData};
+                for (const uint32_t i : std::views::iota(0u, meshData.indexCount))
+                {
+                    uint16_t index{};
+                    std::memcpy(&index, indexData.data() + i * sizeof(uint16_t), sizeof(uint16_t));
+                    indices[i] = index;
+                }
+            }
+            else
+            {
+                std::memcpy(indices.data(), modelData.indexData.data() + meshData.indexByteOffset, static_cast<size_t>(meshData.indexCount) * sizeof(uint32_t));
+            }
 
-        throwIfFailed(device->CreateBuffer(&bufferDesc, &subresourceData, &m_transformBuffer.buffer));
+            return indices;
+        }
+    }
 
-        std::string modelDirectoryPathStr{};
+    Model::Model(RenderBackend& renderBackend,
+                 GeometryPool& geometryPool,
+                 TextureCache& textureCache,
+                 const TextureHandle& fallbackTexture,
+                 JobSystem& jobSystem,
+                 const std::string_view modelPath,
+                 const TransformComponent& transformData,
+                 const ModelLoadOptions& loadOptions)
+        : m_modelPath(modelPath), m_transformComponent(transformData), m_geometryPool(&geometryPool), m_vertexFormat(loadOptions.vertexFormat)
+    {
+        SGFX_PROFILE_ZONE("Model loading");
 
         if (m_modelPath.find_last_of("/\\") != std::string::npos)
         {
             m_modelDirectory = m_modelPath.substr(0, modelPath.find_last_of("/\\")) + "/";
         }
 
-        std::string warning{};
-        std::string error{};
+        const auto loadStartTime = std::chrono::high_resolution_clock::now();
 
-        tinygltf::TinyGLTF context{};
+        // Use the cooked file if it is up to date, otherwise parse the glTF file and (re)cook it.
+        const uint64_t cookOptions = (loadOptions.optimizeMeshes ? 1u : 0u) | (loadOptions.generateMeshlets ? 2u : 0u) | (loadOptions.generateLods ? 4u : 0u);
+        const uint64_t cacheKey = hashCombine(ModelCache::getSourceFilesKey(m_modelPath), cookOptions);
+        const std::string cachePath = ModelCache::getCachePath(m_modelPath);
 
-        tinygltf::Model model{};
+        ModelCache modelCache{};
+        ModelDataStorage modelDataStorage{};
 
-        if (m_modelPath.find(".glb") != std::string::npos)
+        const bool isCached = modelCache.open(cachePath, cacheKey);
+        if (!isCached)
         {
-            if (!context.LoadBinaryFromFile(&model, &error, &warning, m_modelPath))
+            std::string warning{};
+            std::string error{};
+
+            tinygltf::TinyGLTF context{};
+
+            tinygltf::Model model{};
+
+            if (m_modelPath.find(".glb") != std::string::npos)
             {
-                if (!error.empty())
+                if (!context.LoadBinaryFromFile(&model, &error, &warning, m_modelPath))
                 {
-                    fatalError(error);
-                }
+                    if (!error.empty())
+                    {
+                        fatalError(error);
+                    }
 
-                if (!warning.empty())
-                {
-                    fatalError(warning);
+                    if (!warning.empty())
+                    {
+                        fatalError(warning);
+                    }
                 }
             }
-        }
-        else
-        {
-            if (!context.LoadASCIIFromFile(&model, &error, &warning, m_modelPath))
+            else
             {
-                if (!error.empty())
+                if (!context.LoadASCIIFromFile(&model, &error, &warning, m_modelPath))
                 {
-                    fatalError(error);
-                }
+                    if (!error.empty())
+                    {
+                        fatalError(error);
+                    }
 
-                if (!warning.empty())
-                {
-                    fatalError(warning);
+                    if (!warning.empty())
+                    {
+                        fatalError(warning);
+                    }
                 }
             }
+
+            convertModel(&model, jobSystem, loadOptions, modelDataStorage, m_loadStats);
+
+            ModelCache::write(cachePath, cacheKey, modelDataStorage.getView());
         }
 
-        std::thread samplerThread(
+        const ModelData modelData = isCached ? modelCache.getData() : modelDataStorage.getView();
+
+        JobCounter loadCounter{};
+        const ScopedJobWait loadWait(jobSystem, loadCounter);
+
+        jobSystem.submit(
             [&]()
             {
                 // Load samplers.
-                loadSamplers(device, &model);
-            });
+                loadSamplers(renderBackend, modelData.samplers);
+            },
+            loadCounter);
 
-        std::thread materialThread(
+        jobSystem.submit(
             [&]()
             {
                 // Load textures and materials.
-                loadMaterials(device, &model);
-            });
-
-        tinygltf::Scene& scene = model.scenes[model.defaultScene];
+                loadMaterials(textureCache, fallbackTexture, jobSystem, modelData);
+            },
+            loadCounter);
 
-        std::thread meshThread(
+        jobSystem.submit(
             [&]()
             {
-                // Build meshes.
-                for (const int& nodeIndex : scene.nodes)
-                {
-                    loadNode(device, nodeIndex, &model);
-                }
-            });
+                // Upload meshes into the geometry pool.
+                loadMeshes(modelData);
+            },
+            loadCounter);
 
-        samplerThread.join();
-        materialThread.join();
-        meshThread.join();
-    }
+        if (loadOptions.buildCollisionBvhs)
+        {
+            m_meshCollisions.resize(modelData.meshes.size());
+            jobSystem.parallelFor(static_cast<uint32_t>(modelData.meshes.size()), 1u, [&](const uint32_t meshIndex) { loadMeshCollision(modelData, meshIndex); }, loadCounter);
+        }
 
-    void Model::updateTransformBuffer(const math::XMMATRIX viewMatrix, ID3D11DeviceContext* const deviceContext)
-    {
-        const DirectX::XMVECTOR scalingVector = DirectX::XMLoadFloat3(&m_transformComponent.scale);
-        const DirectX::XMVECTOR rotationVector = DirectX::XMLoadFloat3(&m_transformComponent.rotation);
-        const DirectX::XMVECTOR translationVector = DirectX::XMLoadFloat3(&m_transformComponent.translate);
+        jobSystem.wait(loadCounter);
 
-        const DirectX::XMMATRIX modelMatrix = DirectX::XMMatrixScalingFromVector(scalingVector) * DirectX::XMMatrixRotationRollPitchYawFromVector(rotationVector) *
-                                              DirectX::XMMatrixTranslationFromVector(translationVector);
-        m_transformBuffer.data = {
-            .modelMatrix = modelMatrix,
-            .inverseModelMatrix = DirectX::XMMatrixInverse(nullptr, modelMatrix),
-            .inverseModelViewMatrix = DirectX::XMMatrixInverse(nullptr, modelMatrix * viewMatrix),
-        };
+        // After the materials, so every texture has been cooked.
+        if (loadOptions.keepRasterData)
+        {
+            loadRasterData(jobSystem, modelData);
+        }
 
-        deviceContext->UpdateSubresource(m_transformBuffer.buffer.Get(), 0u, nullptr, &m_transformBuffer.data, 0u, 0u);
+        // Create the transform buffers. This is done after loading, as the position dequantization is only known once the meshes are uploaded.
+        loadTransforms(renderBackend, modelData.nodes);
+
+        const std::chrono::duration<double, std::milli> loadDuration = std::chrono::high_resolution_clock::now() - loadStartTime;
+
+        m_loadStats.loadTimeMs = loadDuration.count();
+        m_loadStats.isCached = isCached;
+        m_loadStats.meshCount = static_cast<uint32_t>(modelData.meshes.size());
+
+        // How much index memory the 16 bit index buffers save compared to promoting every mesh to 32 bit indices.
+        for (const MeshData& meshData : modelData.meshes)
+        {
+            const bool isShortIndexed = meshData.indexSize == sizeof(uint16_t);
+
+            m_loadStats.indexBytes += static_cast<uint64_t>(meshData.totalIndexCount) * (isShortIndexed ? sizeof(uint16_t) : sizeof(uint32_t));
+            m_loadStats.fullIndexBytes += static_cast<uint64_t>(meshData.totalIndexCount) * sizeof(uint32_t);
+            m_loadStats.shortIndexMeshCount += isShortIndexed ? 1u : 0u;
+        }
     }
 
-    void Model::render(ID3D11DeviceContext* const deviceContext) const
+    void Model::updateTransformBuffer(const math::XMMATRIX viewMatrix, RenderBackend& renderBackend)
     {
-        deviceContext->VSSetConstantBuffers(1u, 1u, m_transformBuffer.buffer.GetAddressOf());
-        uint32_t meshIndex = 0u;
-
-        for (const auto& mesh : m_meshes)
+        // The transform component has no padding, and is only pushed to the hierarchy when edited so the nodes below it are not recomputed every frame.
+        if (std::memcmp(&m_appliedTransformComponent, &m_transformComponent, sizeof(TransformComponent)) != 0)
         {
-            constexpr uint32_t stride = sizeof(ModelVertex);
-            constexpr uint32_t offset = 0u;
+            m_transformHierarchy.setLocalTransform(0u, toLocalTransform(m_transformComponent));
+            m_appliedTransformComponent = m_transformComponent;
+        }
 
-            deviceContext->IASetVertexBuffers(0u, 1u, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
-            deviceContext->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0u);
+        m_transformHierarchy.updateWorldMatrices();
 
-            const auto albedoTexturesampler = m_materials[mesh.materialIndex].albedoTextureSamplerStateIndex == INVALID_INDEX_U32
-                                                  ? m_fallbackSamplerState.GetAddressOf()
-                                                  : m_samplers[m_materials[mesh.materialIndex].albedoTextureSamplerStateIndex].GetAddressOf();
+        for (ModelTransform& transform : m_transforms)
+        {
+            if (m_transformHierarchy.isWorldMatrixUpdated(transform.nodeIndex))
+            {
+                applyWorldMatrix(transform);
+            }
 
-            const auto albedoSrv = m_materials[mesh.materialIndex].albedoTextureSrv.GetAddressOf();
+            // The position dequantization set at load time is left as is.
+            transform.buffer.data.inverseModelViewMatrix = math::XMMatrixInverse(nullptr, transform.buffer.data.modelMatrix * viewMatrix);
 
-            const auto normalTextureSampler = m_materials[mesh.materialIndex].normalTextureSamplerStateIndex == INVALID_INDEX_U32
-                                                  ? m_fallbackSamplerState.GetAddressOf()
-                                                  : m_samplers[m_materials[mesh.materialIndex].normalTextureSamplerStateIndex].GetAddressOf();
+            renderBackend.updateBuffer(transform.buffer.buffer.get(), std::as_bytes(std::span(&transform.buffer.data, 1u)));
+        }
 
-            const auto normalSrv = m_materials[mesh.materialIndex].normalTexture.GetAddressOf();
+        updateWorldBounds();
+    }
 
-            // Albedo texture and sampler.
-            deviceContext->PSSetSamplers(0u, 1u, albedoTexturesampler);
-            deviceContext->PSSetShaderResources(0u, 1u, albedoSrv);
+    void Model::gatherRenderItems(const RenderItemGatherDesc& gatherDesc, RenderQueue& renderQueue) const
+    {
+        for (const uint32_t meshIndex : std::views::iota(0u, static_cast<uint32_t>(m_meshes.size())))
+        {
+            GeometryRange lodIndexRange{};
+            if (getDrawnIndexRanges(meshIndex, lodIndexRange).empty())
+            {
+                continue;
+            }
 
-            // Normal texture and sampler.
-            deviceContext->PSSetSamplers(1u, 1u, normalTextureSampler);
-            deviceContext->PSSetShaderResources(1u, 1u, normalSrv);
+            // Zero from within the bounds.
+            const float distanceX = std::max(std::abs(gatherDesc.cameraPosition.x - m_worldBounds.boxCenterX[meshIndex]) - m_worldBounds.boxExtentX[meshIndex], 0.0f);
+            const float distanceY = std::max(std::abs(gatherDesc.cameraPosition.y - m_worldBounds.boxCenterY[meshIndex]) - m_worldBounds.boxExtentY[meshIndex], 0.0f);
+            const float distanceZ = std::max(std::abs(gatherDesc.cameraPosition.z - m_worldBounds.boxCenterZ[meshIndex]) - m_worldBounds.boxExtentZ[meshIndex], 0.0f);
 
-            deviceContext->DrawIndexed(mesh.indicesCount, 0u, 0u);
+            const uint64_t sortKey = RenderQueue::createSortKey(gatherDesc.pass,
+                                                                gatherDesc.pipeline,
+                                                                gatherDesc.firstMaterialKey + m_meshes[meshIndex].materialIndex,
+                                                                distanceX * distanceX + distanceY * distanceY + distanceZ * distanceZ);
 
-            meshIndex++;
+            renderQueue.add(sortKey, RenderItem{.model = this, .meshIndex = meshIndex});
         }
     }
 
-    void Model::renderInstanced(ID3D11DeviceContext* const deviceContext, const uint32_t instanceCount) const
+    void Model::recordMesh(CommandList& commandList, const uint32_t meshIndex, DrawState& drawState) const
     {
-        deviceContext->VSSetConstantBuffers(1u, 1u, m_transformBuffer.buffer.GetAddressOf());
-        uint32_t meshIndex = 0u;
+        const Mesh& mesh = m_meshes[meshIndex];
 
-        for (const auto& mesh : m_meshes)
-        {
-            constexpr uint32_t stride = sizeof(ModelVertex);
-            constexpr uint32_t offset = 0u;
+        GeometryRange lodIndexRange{};
+        const std::span<const GeometryRange> indexRanges = getDrawnIndexRanges(meshIndex, lodIndexRange);
 
-            deviceContext->IASetVertexBuffers(0u, 1u, mesh.vertexBuffer.GetAddressOf(), &stride, &offset);
-            deviceContext->IASetIndexBuffer(mesh.indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0u);
+        if (indexRanges.empty())
+        {
+            return;
+        }
 
-            const auto albedoTexturesampler = m_materials[mesh.materialIndex].albedoTextureSamplerStateIndex == INVALID_INDEX_U32
-                                                  ? m_fallbackSamplerState.GetAddressOf()
-                                                  : m_samplers[m_materials[mesh.materialIndex].albedoTextureSamplerStateIndex].GetAddressOf();
+        DrawSubmissionStats& stats = drawState.stats;
 
-            const auto albedoSrv = m_materials[mesh.materialIndex].albedoTextureSrv.GetAddressOf();
+        // All meshes of a pool share its buffers, so only the index buffer may need rebinding (when the index size changes).
+        const uint32_t vertexSize = getVertexSize(m_vertexFormat);
+        if (drawState.geometryPool != m_geometryPool || drawState.vertexSize != vertexSize)
+        {
+            commandList.record(SetVertexBufferCommand{.buffer = m_geometryPool->getVertexBuffer(), .stride = vertexSize});
 
-            const auto normalTextureSampler = m_materials[mesh.materialIndex].normalTextureSamplerStateIndex == INVALID_INDEX_U32
-                                                  ? m_fallbackSamplerState.GetAddressOf()
-                                                  : m_samplers[m_materials[mesh.materialIndex].normalTextureSamplerStateIndex].GetAddressOf();
+            // The bound index buffer belongs to the previous pool.
+            drawState.indexSize = drawState.geometryPool != m_geometryPool ? 0u : drawState.indexSize;
+            drawState.geometryPool = m_geometryPool;
+            drawState.vertexSize = vertexSize;
 
-            const auto normalSrv = m_materials[mesh.materialIndex].normalTexture.GetAddressOf();
+            stats.vertexBufferBindCount++;
+        }
 
-            // Albedo texture and sampler.
-            deviceContext->PSSetSamplers(0u, 1u, albedoTexturesampler);
-            deviceContext->PSSetShaderResources(0u, 1u, albedoSrv);
+        if (mesh.indexSize != drawState.indexSize)
+        {
+            commandList.record(SetIndexBufferCommand{.buffer = m_geometryPool->getIndexBuffer(mesh.indexSize), .indexSize = mesh.indexSize});
+            drawState.indexSize = mesh.indexSize;
 
-            // Normal texture and sampler.
-            deviceContext->PSSetSamplers(1u, 1u, normalTextureSampler);
-            deviceContext->PSSetShaderResources(1u, 1u, normalSrv);
+            stats.indexBufferBindCount++;
+        }
 
-            deviceContext->DrawIndexedInstanced(mesh.indicesCount, instanceCount, 0u, 0u, 0u);
+        const BackendHandle transformBuffer = m_transforms[mesh.transformIndex].buffer.buffer.get();
+        if (transformBuffer != drawState.transformBuffer)
+        {
+            commandList.record(SetConstantBufferCommand{.buffer = transformBuffer, .stage = ShaderStage::Vertex, .slot = 1u});
+            drawState.transformBuffer = transformBuffer;
 
-            meshIndex++;
+            stats.transformBindCount++;
         }
-    }
-
-    void Model::loadSamplers(ID3D11Device* const device, tinygltf::Model* const model)
-    {
-        // Create fallback sampler.
-        const D3D11_SAMPLER_DESC samplerDesc = {
-            .Filter = D3D11_FILTER_ANISOTROPIC,
-            .AddressU = D3D11_TEXTURE_ADDRESS_CLAMP,
-            .AddressV = D3D11_TEXTURE_ADDRESS_CLAMP,
-            .AddressW = D3D11_TEXTURE_ADDRESS_CLAMP,
-            .MaxAnisotropy = D3D11_MAX_MAXANISOTROPY,
-            .ComparisonFunc = D3D11_COMPARISON_NEVER,
-        };
 
-        throwIfFailed(device->CreateSamplerState(&samplerDesc, &m_fallbackSamplerState));
+        const PBRMaterial& material = m_materials[mesh.materialIndex];
 
-        m_samplers.resize(model->samplers.size());
+        const auto getSampler = [&](const uint32_t samplerStateIndex)
+        { return samplerStateIndex == INVALID_INDEX_U32 ? m_fallbackSamplerState.get() : m_samplers[samplerStateIndex].get(); };
 
-        size_t index{0};
+        // Albedo texture and sampler in slot 0, normal texture and sampler in slot 1.
+        const std::array<BackendHandle, 2> textures = {material.albedoTexture, material.normalTexture};
+        const std::array<BackendHandle, 2> samplers = {getSampler(material.albedoTextureSamplerStateIndex), getSampler(material.normalTextureSamplerStateIndex)};
 
-        for (tinygltf::Sampler& sampler : model->samplers)
+        for (const uint32_t slot : std::views::iota(0u, 2u))
         {
-            D3D11_SAMPLER_DESC samplerDesc{};
-
-            switch (sampler.minFilter)
+            if (drawState.textures[slot] != textures[slot])
             {
-                case TINYGLTF_TEXTURE_FILTER_NEAREST:
-                    {
-                        if (sampler.magFilter == TINYGLTF_TEXTURE_FILTER_NEAREST)
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
-                        }
-                        else
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-                        }
-                    }
-                    break;
+                commandList.record(SetShaderResourceCommand{.resource = textures[slot], .stage = ShaderStage::Pixel, .slot = slot});
+                drawState.textures[slot] = textures[slot];
 
-                case TINYGLTF_TEXTURE_FILTER_LINEAR:
-                    {
-                        if (sampler.magFilter == TINYGLTF_TEXTURE_FILTER_NEAREST)
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_LINEAR_MAG_MIP_POINT;
-                        }
-                        else
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT;
-                        }
-                    }
-                    break;
+                stats.textureBindCount++;
+            }
 
-                case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST:
-                    {
-                        if (sampler.magFilter == TINYGLTF_TEXTURE_FILTER_NEAREST)
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
-                        }
-                        else
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_POINT_MAG_LINEAR_MIP_POINT;
-                        }
-                    }
-                    break;
+            if (drawState.samplers[slot] != samplers[slot])
+            {
+                commandList.record(SetSamplerCommand{.sampler = samplers[slot], .stage = ShaderStage::Pixel, .slot = slot});
+                drawState.samplers[slot] = samplers[slot];
 
-                case TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_NEAREST:
-                    {
-                        if (sampler.magFilter == TINYGLTF_TEXTURE_FILTER_NEAREST)
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_LINEAR_MAG_MIP_POINT;
-                        }
-                        else
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT;
-                        }
-                    }
-                    break;
+                stats.samplerBindCount++;
+            }
+        }
 
-                case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR:
-                    {
-                        if (sampler.magFilter == TINYGLTF_TEXTURE_FILTER_NEAREST)
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_MAG_POINT_MIP_LINEAR;
-                        }
-                        else
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_POINT_MAG_MIP_LINEAR;
-                        }
-                    }
-                    break;
+        for (const GeometryRange& indexRange : indexRanges)
+        {
+            commandList.record(DrawIndexedCommand{.indexCount = indexRange.count, .firstIndex = indexRange.first, .baseVertex = static_cast<int32_t>(mesh.baseVertex)});
+        }
 
-                case TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_LINEAR:
-                    {
-                        if (sampler.magFilter == TINYGLTF_TEXTURE_FILTER_NEAREST)
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_LINEAR_MAG_POINT_MIP_LINEAR;
-                        }
-                        else
-                        {
-                            samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-                        }
-                    }
-                    break;
+        stats.itemCount++;
+        stats.drawCount += static_cast<uint32_t>(indexRanges.size());
+    }
 
-                default:
-                    {
-                        samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
-                    }
-                    break;
-            }
+    std::span<const GeometryRange> Model::getDrawnIndexRanges(const uint32_t meshIndex, GeometryRange& lodIndexRange) const
+    {
+        if (!m_meshVisibility.empty() && m_meshVisibility[meshIndex] == 0u)
+        {
+            return {};
+        }
 
-            auto toTextureAddressMode = [](int wrap)
-            {
-                switch (wrap)
-                {
-                    case TINYGLTF_TEXTURE_WRAP_REPEAT:
-                        {
-                            return D3D11_TEXTURE_ADDRESS_WRAP;
-                        }
-                        break;
+        // Without meshlet culling results, every mesh is drawn as a single range (of its selected LOD).
+        if (!m_visibleIndexRangeOffsets.empty())
+        {
+            const uint32_t firstRange = m_visibleIndexRangeOffsets[meshIndex];
+            return std::span<const GeometryRange>(m_visibleIndexRanges).subspan(firstRange, m_visibleIndexRangeOffsets[meshIndex + 1u] - firstRange);
+        }
 
-                    case TINYGLTF_TEXTURE_WRAP_CLAMP_TO_EDGE:
-                        {
-                            return D3D11_TEXTURE_ADDRESS_CLAMP;
-                        }
-                        break;
+        lodIndexRange = getLodIndexRange(m_meshes[meshIndex], m_selectedLods[meshIndex]);
+        return std::span<const GeometryRange>(&lodIndexRange, 1u);
+    }
 
-                    case TINYGLTF_TEXTURE_WRAP_MIRRORED_REPEAT:
-                        {
-                            return D3D11_TEXTURE_ADDRESS_MIRROR;
-                        }
-                        break;
+    MeshletCullingStats Model::cullMeshlets(const Frustum& frustum, const math::XMFLOAT3& cameraPosition)
+    {
+        // Meshlet bounds are in object space, so the frustum and camera are moved to the object space of each transform instead of transforming
+        // every meshlet.
+        std::vector<Frustum> objectSpaceFrustums{};
+        std::vector<math::XMFLOAT3> objectSpaceCameraPositions{};
 
-                    default:
-                        {
-                            return D3D11_TEXTURE_ADDRESS_WRAP;
-                        }
-                        break;
-                }
-            };
+        objectSpaceFrustums.reserve(m_transforms.size());
+        objectSpaceCameraPositions.reserve(m_transforms.size());
 
-            samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
-            samplerDesc.AddressU = toTextureAddressMode(sampler.wrapS);
-            samplerDesc.AddressV = toTextureAddressMode(sampler.wrapT);
-            samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-            samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-            samplerDesc.MinLOD = 0.0f;
-            samplerDesc.MipLODBias = 0.0f;
-            samplerDesc.MaxAnisotropy = 16;
-            samplerDesc.ComparisonFunc = D3D11_COMPARISON_LESS_EQUAL;
+        for (const ModelTransform& transform : m_transforms)
+        {
+            objectSpaceFrustums.emplace_back(transformFrustum(frustum, transform.buffer.data.modelMatrix));
 
-            wrl::ComPtr<ID3D11SamplerState> samplerState{};
-            throwIfFailed(device->CreateSamplerState(&samplerDesc, &samplerState));
-            m_samplers[index++] = std::move(samplerState);
+            math::XMStoreFloat3(&objectSpaceCameraPositions.emplace_back(),
+                                math::XMVector3TransformCoord(math::XMLoadFloat3(&cameraPosition), transform.buffer.data.inverseModelMatrix));
         }
-    }
 
-    void Model::loadMaterials(ID3D11Device* const device, tinygltf::Model* const model)
-    {
-        std::mutex textureCreationMutex{};
+        m_visibleIndexRanges.clear();
+        m_visibleIndexRangeOffsets.clear();
 
-        auto createTexture = [&](tinygltf::Image& image, bool isSrgb)
+        MeshletCullingStats stats{};
+
+        for (const uint32_t meshIndex : std::views::iota(0u, static_cast<uint32_t>(m_meshes.size())))
         {
-            const std::wstring texturePath = stringToWString(m_modelDirectory + image.uri);
+            const Mesh& mesh = m_meshes[meshIndex];
+            const uint32_t selectedLod = m_selectedLods[meshIndex];
 
-            wrl::ComPtr<ID3D11ShaderResourceView> srv{};
+            const Frustum& objectSpaceFrustum = objectSpaceFrustums[mesh.transformIndex];
 
-            DirectX::TexMetadata metaData{};
-            DirectX::ScratchImage scratchImage{};
+            m_visibleIndexRangeOffsets.emplace_back(static_cast<uint32_t>(m_visibleIndexRanges.size()));
 
-            const DirectX::WIC_FLAGS wicFlag = isSrgb == true ? DirectX::WIC_FLAGS_DEFAULT_SRGB : DirectX::WIC_FLAGS_IGNORE_SRGB;
+            // Meshes rejected by cullMeshes are not tested again, but their meshlets still count as frustum culled.
+            const bool isMeshCulled = !m_meshVisibility.empty() && m_meshVisibility[meshIndex] == 0u;
 
-            if (FAILED(DirectX::LoadFromWICFile(texturePath.data(), wicFlag, &metaData, scratchImage)))
+            if (isMeshCulled || mesh.meshletCount == 0u || selectedLod != 0u)
             {
-                std::wcout << L"Failed to load texture from path : " << texturePath << L'\n';
-                throw std::runtime_error("Texture Loading Error");
-            }
+                const GeometryRange lodIndexRange = getLodIndexRange(mesh, selectedLod);
+                stats.triangleCount += lodIndexRange.count / 3u;
+
+                if (isMeshCulled && selectedLod == 0u)
+                {
+                    stats.meshletCount += mesh.meshletCount;
+                    stats.frustumCulledMeshletCount += mesh.meshletCount;
+                }
 
-            DirectX::ScratchImage mipChain{};
-            throwIfFailed(DirectX::GenerateMipMaps(scratchImage.GetImages(), scratchImage.GetImageCount(), metaData, DirectX::TEX_FILTER_DEFAULT, 0u, mipChain));
+                if (isMeshCulled || !isAabbInFrustum(objectSpaceFrustum, mesh.bounds))
+                {
+                    stats.frustumCulledTriangleCount += lodIndexRange.count / 3u;
+                    continue;
+                }
 
-            const std::lock_guard<std::mutex> lock(textureCreationMutex);
+                m_visibleIndexRanges.emplace_back(lodIndexRange);
 
-            wrl::ComPtr<ID3D11Resource> texture{};
-            throwIfFailed(DirectX::CreateTexture(device, mipChain.GetImages(), mipChain.GetImageCount(), mipChain.GetMetadata(), &texture));
+                continue;
+            }
 
-            throwIfFailed(DirectX::CreateShaderResourceView(device, mipChain.GetImages(), mipChain.GetImageCount(), mipChain.GetMetadata(), &srv));
+            const std::span<const MeshletData> meshlets = std::span<const MeshletData>(m_meshlets).subspan(mesh.firstMeshlet, mesh.meshletCount);
 
-            return srv;
-        };
+            m_visibleMeshlets.clear();
+            // Non uniform scaling does not preserve the angles the normal cones rely on.
+            stats += sgfx::cullMeshlets(meshlets, objectSpaceFrustum, objectSpaceCameraPositions[mesh.transformIndex], m_transforms[mesh.transformIndex].isUniformlyScaled, m_visibleMeshlets);
 
-        size_t index{0};
-        m_materials.resize(model->materials.size());
+            const uint32_t meshFirstRange = m_visibleIndexRangeOffsets.back();
 
-        for (const tinygltf::Material& material : model->materials)
-        {
-            PBRMaterial pbrMaterial{};
+            for (const uint32_t meshletIndex : m_visibleMeshlets)
+            {
+                const uint32_t firstIndex = mesh.firstIndex + meshlets[meshletIndex].firstIndex;
 
-            std::jthread albedoThread(
-                [&]()
+                if (m_visibleIndexRanges.size() > meshFirstRange && m_visibleIndexRanges.back().first + m_visibleIndexRanges.back().count == firstIndex)
                 {
-                    if (material.pbrMetallicRoughness.baseColorTexture.index >= 0)
-                    {
+                    m_visibleIndexRanges.back().count += meshlets[meshletIndex].indexCount;
+                }
+                else
+                {
+                    m_visibleIndexRanges.emplace_back(GeometryRange{
+                        .first = firstIndex,
+                        .count = meshlets[meshletIndex].indexCount,
+                    });
+                }
+            }
+        }
 
-                        tinygltf::Texture& albedoTexture = model->textures[material.pbrMetallicRoughness.baseColorTexture.index];
-                        tinygltf::Image& albedoImage = model->images[albedoTexture.source];
+        m_visibleIndexRangeOffsets.emplace_back(static_cast<uint32_t>(m_visibleIndexRanges.size()));
 
-                        pbrMaterial.albedoTextureSrv = createTexture(albedoImage, true);
-                        pbrMaterial.albedoTextureSamplerStateIndex = albedoTexture.sampler;
-                    }
-                    else
-                    {
-                        pbrMaterial.albedoTextureSrv = m_fallbackSrv;
-                        pbrMaterial.albedoTextureSamplerStateIndex = INVALID_INDEX_U32;
-                    }
-                });
+        return stats;
+    }
 
-            std::jthread metalRoughnessThread(
-                [&]()
-                {
-                    if (material.pbrMetallicRoughness.metallicRoughnessTexture.index >= 0)
-                    {
+    void Model::clearMeshletCulling()
+    {
+        m_visibleIndexRanges.clear();
+        m_visibleIndexRangeOffsets.clear();
+    }
 
-                        tinygltf::Texture& metalRoughnessTexture = model->textures[material.pbrMetallicRoughness.metallicRoughnessTexture.index];
-                        tinygltf::Image& metalRoughnessImage = model->images[metalRoughnessTexture.source];
+    MeshCullingStats Model::cullMeshes(const Frustum& frustum)
+    {
+        m_meshVisibility.resize(m_meshes.size());
 
-                        pbrMaterial.metalRoughnessTexture = createTexture(metalRoughnessImage, false);
-                        pbrMaterial.metalRoughnessTextureSamplerStateIndex = metalRoughnessTexture.sampler;
-                    }
-                });
+        return MeshCullingStats{
+            .meshCount = static_cast<uint32_t>(m_meshes.size()),
+            .visibleMeshCount = cullBoundingVolumes(frustum, m_worldBounds, m_meshVisibility),
+        };
+    }
 
-            std::jthread normalThread(
-                [&]()
-                {
-                    if (material.normalTexture.index >= 0)
-                    {
-                        tinygltf::Texture& normalTexture = model->textures[material.normalTexture.index];
-                        tinygltf::Image& normalImage = model->images[normalTexture.source];
+    void Model::clearMeshCulling() { m_meshVisibility.clear(); }
 
-                        pbrMaterial.normalTexture = createTexture(normalImage, false);
-                        pbrMaterial.normalTextureSamplerStateIndex = normalTexture.sampler;
-                    }
-                    else
-                    {
-                        pbrMaterial.normalTextureSamplerStateIndex = INVALID_INDEX_U32;
-                    }
-                });
+    void Model::gatherOccluders(const OccluderSelectionDesc& selectionDesc, std::vector<Occluder>& outOccluders) const
+    {
+        if (m_meshCollisions.empty())
+        {
+            return;
+        }
 
-            std::jthread occlusionThread(
-                [&]()
-                {
-                    if (material.occlusionTexture.index >= 0)
-                    {
-                        tinygltf::Texture& aoTexture = model->textures[material.occlusionTexture.index];
-                        tinygltf::Image& aoImage = model->images[aoTexture.source];
+        for (const uint32_t meshIndex : std::views::iota(0u, static_cast<uint32_t>(m_meshes.size())))
+        {
+            const Mesh& mesh = m_meshes[meshIndex];
+            const MeshCollision& collision = m_meshCollisions[mesh.cookedIndex];
 
-                        pbrMaterial.aoTexture = createTexture(aoImage, false);
-                        pbrMaterial.aoTextureSamplerStateIndex = aoTexture.sampler;
-                    }
-                });
+            const bool isMeshCulled = !m_meshVisibility.empty() && m_meshVisibility[meshIndex] == 0u;
 
-            std::jthread emissiveThread(
-                [&]()
-                {
-                    if (material.emissiveTexture.index >= 0)
-                    {
-                        tinygltf::Texture& emissiveTexture = model->textures[material.emissiveTexture.index];
-                        tinygltf::Image& emissiveImage = model->images[emissiveTexture.source];
+            if (isMeshCulled || m_worldBounds.sphereRadius[meshIndex] < selectionDesc.minimumRadius ||
+                collision.indices.size() / 3u > selectionDesc.maximumTriangleCount)
+            {
+                continue;
+            }
 
-                        pbrMaterial.emissiveTexture = createTexture(emissiveImage, true);
-                        pbrMaterial.emissiveTextureSamplerStateIndex = emissiveTexture.sampler;
-                    }
-                });
+            outOccluders.emplace_back(Occluder{
+                .positions = collision.positions,
+                .indices = collision.indices,
+                .modelMatrix = m_transforms[mesh.transformIndex].buffer.data.modelMatrix,
+            });
+        }
+    }
+
+    void Model::gatherRasterMeshes(std::vector<RasterMesh>& outMeshes) const
+    {
+        if (m_meshRasterData.empty())
+        {
+            return;
+        }
+
+        const auto getTexture = [&](const uint32_t textureIndex) { return textureIndex == INVALID_INDEX_U32 ? nullptr : &m_rasterTextures[textureIndex]; };
+
+        for (const uint32_t meshIndex : std::views::iota(0u, static_cast<uint32_t>(m_meshes.size())))
+        {
+            if (!m_meshVisibility.empty() && m_meshVisibility[meshIndex] == 0u)
+            {
+                continue;
+            }
 
-            albedoThread.join();
-            metalRoughnessThread.join();
-            normalThread.join();
-            occlusionThread.join();
-            emissiveThread.join();
+            const Mesh& mesh = m_meshes[meshIndex];
+            const MeshRasterData& rasterData = m_meshRasterData[mesh.cookedIndex];
+            const RasterMaterial& material = m_rasterMaterials[mesh.materialIndex];
 
-            m_materials[index++] = std::move(pbrMaterial);
+            outMeshes.emplace_back(RasterMesh{
+                .vertices = rasterData.vertices,
+                .indices = rasterData.indices,
+                .modelMatrix = m_transforms[mesh.transformIndex].buffer.data.modelMatrix,
+                .albedoTexture = getTexture(material.albedoTextureIndex),
+                .normalTexture = getTexture(material.normalTextureIndex),
+            });
         }
     }
-    void Model::loadNode(ID3D11Device* const device, uint32_t nodeIndex, tinygltf::Model* const model)
+
+    uint32_t Model::cullOccludedMeshes(const OcclusionBuffer& occlusionBuffer)
     {
-        const tinygltf::Node& node = model->nodes[nodeIndex];
-        if (node.mesh < 0)
+        m_meshVisibility.resize(m_meshes.size(), 1u);
+
+        uint32_t occludedMeshCount = 0u;
+
+        for (const uint32_t meshIndex : std::views::iota(0u, static_cast<uint32_t>(m_meshes.size())))
         {
-            // Load children immediatly, as it may have some.
-            for (const int& childrenNodeIndex : node.children)
+            if (m_meshVisibility[meshIndex] != 0u && !occlusionBuffer.isAabbVisible(getMeshWorldBounds(meshIndex)))
             {
-                loadNode(device, childrenNodeIndex, model);
+                m_meshVisibility[meshIndex] = 0u;
+                occludedMeshCount++;
             }
-
-            return;
         }
 
-        tinygltf::Mesh& nodeMesh = model->meshes[node.mesh];
-        for (size_t i = 0; i < nodeMesh.primitives.size(); ++i)
+        return occludedMeshCount;
+    }
+
+    void Model::selectLods(const LodSelectionDesc& lodSelectionDesc)
+    {
+        const math::XMVECTOR cameraPosition = math::XMLoadFloat3(&lodSelectionDesc.cameraPosition);
+
+        for (const uint32_t meshIndex : std::views::iota(0u, static_cast<uint32_t>(m_meshes.size())))
         {
-            Mesh mesh{};
+            const Mesh& mesh = m_meshes[meshIndex];
+            const ModelTransform& transform = m_transforms[mesh.transformIndex];
 
-            std::vector<ModelVertex> vertices{};
+            // Object space errors and radii are scaled by the largest axis scale, so the projected error is never underestimated.
+            const float maximumScale = transform.maximumScale;
 
-            std::vector<uint32_t> indices{};
+            const math::XMVECTOR boundsMinimum = math::XMLoadFloat3(&mesh.bounds.minimum);
+            const math::XMVECTOR boundsMaximum = math::XMLoadFloat3(&mesh.bounds.maximum);
 
-            // Reference used : https://github.com/mateeeeeee/Adria-DX12/blob/fc98468095bf5688a186ca84d94990ccd2f459b0/Adria/Rendering/EntityLoader.cpp.
+            const math::XMVECTOR center = math::XMVector3TransformCoord(math::XMVectorScale(math::XMVectorAdd(boundsMinimum, boundsMaximum), 0.5f), transform.buffer.data.modelMatrix);
+            const float radius = 0.5f * maximumScale * math::XMVectorGetX(math::XMVector3Length(math::XMVectorSubtract(boundsMaximum, boundsMinimum)));
 
-            // Get Accesor, buffer view and buffer for each attribute (position, textureCoord, normal).
-            tinygltf::Primitive primitive = nodeMesh.primitives[i];
-            const tinygltf::Accessor& indexAccesor = model->accessors[primitive.indices];
+            // Distance to the bounding sphere rather than to its center. Inside the sphere the distance is clamped, which selects the full resolution.
+            const float distance = std::max(math::XMVectorGetX(math::XMVector3Length(math::XMVectorSubtract(center, cameraPosition))) - radius,
+                                            std::numeric_limits<float>::epsilon());
 
-            // Position data.
-            const tinygltf::Accessor& positionAccesor = model->accessors[primitive.attributes["POSITION"]];
-            const tinygltf::BufferView& positionBufferView = model->bufferViews[positionAccesor.bufferView];
-            const tinygltf::Buffer& positionBuffer = model->buffers[positionBufferView.buffer];
-
-            const int positionByteStride = positionAccesor.ByteStride(positionBufferView);
-            uint8_t const* const positions = &positionBuffer.data[positionBufferView.byteOffset + positionAccesor.byteOffset];
-
-            // TextureCoord data.
-            const tinygltf::Accessor& textureCoordAccesor = model->accessors[primitive.attributes["TEXCOORD_0"]];
-            const tinygltf::BufferView& textureCoordBufferView = model->bufferViews[textureCoordAccesor.bufferView];
-            const tinygltf::Buffer& textureCoordBuffer = model->buffers[textureCoordBufferView.buffer];
-            const int textureCoordBufferStride = textureCoordAccesor.ByteStride(textureCoordBufferView);
-            uint8_t const* const texcoords = &textureCoordBuffer.data[textureCoordBufferView.byteOffset + textureCoordAccesor.byteOffset];
-
-            // Normal data.
-            const tinygltf::Accessor& normalAccesor = model->accessors[primitive.attributes["NORMAL"]];
-            const tinygltf::BufferView& normalBufferView = model->bufferViews[normalAccesor.bufferView];
-            const tinygltf::Buffer& normalBuffer = model->buffers[normalBufferView.buffer];
-            const int normalByteStride = normalAccesor.ByteStride(normalBufferView);
-            uint8_t const* const normals = &normalBuffer.data[normalBufferView.byteOffset + normalAccesor.byteOffset];
-
-            // Tangent data.
-            const tinygltf::Accessor& tangentAccesor = model->accessors[primitive.attributes["TANGENT"]];
-            const tinygltf::BufferView& tangentBufferView = model->bufferViews[tangentAccesor.bufferView];
-            const tinygltf::Buffer& tangentBuffer = model->buffers[tangentBufferView.buffer];
-            const int tangentByteStride = tangentAccesor.ByteStride(tangentBufferView);
-            uint8_t const* const tangents = &tangentBuffer.data[tangentBufferView.byteOffset + tangentAccesor.byteOffset];
-
-            // Fill in the vertices array.
-            for (size_t i : std::views::iota(0u, positionAccesor.count))
-            {
-                ModelVertex modelVertex{};
-
-                modelVertex.position = {(reinterpret_cast<float const*>(positions + (i * positionByteStride)))[0],
-                                        (reinterpret_cast<float const*>(positions + (i * positionByteStride)))[1],
-                                        (reinterpret_cast<float const*>(positions + (i * positionByteStride)))[2]};
-
-                modelVertex.textureCoord = {
-                    (reinterpret_cast<float const*>(texcoords + (i * textureCoordBufferStride)))[0],
-                    (reinterpret_cast<float const*>(texcoords + (i * textureCoordBufferStride)))[1],
-                };
+            m_selectedLods[meshIndex] = selectLod(std::span(m_lods).subspan(mesh.firstLod, mesh.lodCount),
+                                                  m_selectedLods[meshIndex],
+                                                  maximumScale * lodSelectionDesc.projectionScale / distance,
+                                                  lodSelectionDesc);
+        }
+    }
 
-                modelVertex.normal = {
-                    (reinterpret_cast<float const*>(normals + (i * normalByteStride)))[0],
-                    (reinterpret_cast<float const*>(normals + (i * normalByteStride)))[1],
-                    (reinterpret_cast<float const*>(normals + (i * normalByteStride)))[2],
-                };
+    void Model::requestTextureMips(TextureCache& textureCache, const TextureStreamingDesc& textureStreamingDesc) const
+    {
+        const math::XMVECTOR cameraPosition = math::XMLoadFloat3(&textureStreamingDesc.cameraPosition);
 
-                vertices.emplace_back(modelVertex);
+        // Texture coordinate units per pixel of the mesh seen with the most detail, per material. Materials of meshes without texture
+        // coordinates keep FLT_MAX, so their textures are not requested and stay at their mip tail.
+        std::vector<float> textureCoordsPerPixel(m_materials.size(), std::numeric_limits<float>::max());
+
+        for (const Mesh& mesh : m_meshes)
+        {
+            if (mesh.textureCoordDensity <= 0.0f)
+            {
+                continue;
             }
 
-            // Get the index buffer data.
-            tinygltf::BufferView& indexBufferView = model->bufferViews[indexAccesor.bufferView];
-            tinygltf::Buffer& indexBuffer = model->buffers[indexBufferView.buffer];
-            int indexByteStride = indexAccesor.ByteStride(indexBufferView);
-            uint8_t const* const indexes = indexBuffer.data.data() + indexBufferView.byteOffset + indexAccesor.byteOffset;
+            const ModelTransform& transform = m_transforms[mesh.transformIndex];
 
-            // Fill indices array.
-            for (size_t i : std::views::iota(0u, indexAccesor.count))
+            // World space texture coordinate density is divided by the largest axis scale, so the wanted mip is never too coarse.
+            const float maximumScale = transform.maximumScale;
+
+            const math::XMVECTOR boundsMinimum = math::XMLoadFloat3(&mesh.bounds.minimum);
+            const math::XMVECTOR boundsMaximum = math::XMLoadFloat3(&mesh.bounds.maximum);
+
+            const math::XMVECTOR center = math::XMVector3TransformCoord(math::XMVectorScale(math::XMVectorAdd(boundsMinimum, boundsMaximum), 0.5f), transform.buffer.data.modelMatrix);
+            const float radius = 0.5f * maximumScale * math::XMVectorGetX(math::XMVector3Length(math::XMVectorSubtract(boundsMaximum, boundsMinimum)));
+
+            // Same distance as LOD selection : to the bounding sphere, clamped inside it (which requests the finest mip).
+            const float distance = std::max(math::XMVectorGetX(math::XMVector3Length(math::XMVectorSubtract(center, cameraPosition))) - radius,
+                                            std::numeric_limits<float>::epsilon());
+
+            float& materialTextureCoordsPerPixel = textureCoordsPerPixel[mesh.materialIndex];
+            materialTextureCoordsPerPixel = std::min(materialTextureCoordsPerPixel, mesh.textureCoordDensity / maximumScale * distance / textureStreamingDesc.projectionScale);
+        }
+
+        for (const MaterialTexture& materialTexture : m_textures)
+        {
+            if (textureCoordsPerPixel[materialTexture.materialIndex] == std::numeric_limits<float>::max())
             {
-                if (indexAccesor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
-                {
-                    indices.push_back(static_cast<uint32_t>((reinterpret_cast<uint16_t const*>(indexes + (i * indexByteStride)))[0]));
-                }
-                else if (indexAccesor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
-                {
-                    indices.push_back(static_cast<uint32_t>((reinterpret_cast<uint32_t const*>(indexes + (i * indexByteStride)))[0]));
-                }
+                continue;
             }
 
-            const D3D11_BUFFER_DESC vertexBufferDesc = {
-                .ByteWidth = static_cast<uint32_t>(vertices.size() * sizeof(ModelVertex)),
-                .Usage = D3D11_USAGE_IMMUTABLE,
-                .BindFlags = D3D11_BIND_VERTEX_BUFFER,
-            };
+            const Texture& texture = *materialTexture.texture;
+            const float lod = computeTextureLod(std::max(texture.width, texture.height), textureCoordsPerPixel[materialTexture.materialIndex]);
 
-            const D3D11_SUBRESOURCE_DATA vertexBufferResourceData = {.pSysMem = vertices.data()};
+            textureCache.requestTextureLod(texture, lod);
+        }
+    }
 
-            throwIfFailed(device->CreateBuffer(&vertexBufferDesc, &vertexBufferResourceData, &mesh.vertexBuffer));
+    void Model::updateMaterialTextures()
+    {
+        for (const MaterialTexture& materialTexture : m_textures)
+        {
+            m_materials[materialTexture.materialIndex].*materialTexture.field = materialTexture.texture->resource.get();
+        }
+    }
 
-            const D3D11_BUFFER_DESC indexBufferDesc = {
-                .ByteWidth = static_cast<uint32_t>(indices.size() * sizeof(uint32_t)),
-                .Usage = D3D11_USAGE_IMMUTABLE,
-                .BindFlags = D3D11_BIND_INDEX_BUFFER,
-            };
+    uint32_t selectLod(std::span<const MeshLod> lods, const uint32_t previousLod, const float errorScale, const LodSelectionDesc& lodSelectionDesc)
+    {
+        const uint32_t lodCount = static_cast<uint32_t>(lods.size());
+        const auto getProjectedError = [&](const uint32_t lod) { return lods[lod].error * errorScale; };
 
-            const D3D11_SUBRESOURCE_DATA indexBufferResourceData = {.pSysMem = indices.data()};
+        // Refine as soon as the current LOD is too coarse, but only coarsen once the next LOD is below the threshold by the hysteresis margin.
+        uint32_t selectedLod = std::min(previousLod, lodCount - 1u);
 
-            throwIfFailed(device->CreateBuffer(&indexBufferDesc, &indexBufferResourceData, &mesh.indexBuffer));
+        while (selectedLod > 0u && getProjectedError(selectedLod) > lodSelectionDesc.errorThreshold)
+        {
+            selectedLod--;
+        }
+
+        while (selectedLod + 1u < lodCount && getProjectedError(selectedLod + 1u) <= lodSelectionDesc.errorThreshold * (1.0f - lodSelectionDesc.hysteresis))
+        {
+            selectedLod++;
+        }
+
+        return selectedLod;
+    }
 
-            mesh.indicesCount = static_cast<uint32_t>(indices.size());
+    void Model::resetLods() { std::ranges::fill(m_selectedLods, 0u); }
 
-            mesh.materialIndex = primitive.material;
+    LodSelectionStats Model::getLodSelectionStats() const
+    {
+        LodSelectionStats stats{};
+
+        for (const uint32_t meshIndex : std::views::iota(0u, static_cast<uint32_t>(m_meshes.size())))
+        {
+            const Mesh& mesh = m_meshes[meshIndex];
+            const uint32_t selectedLod = m_selectedLods[meshIndex];
+
+            stats.fullDetailTriangleCount += mesh.indicesCount / 3u;
+            stats.selectedTriangleCount += getLodIndexRange(mesh, selectedLod).count / 3u;
+            stats.meshCountPerLod[selectedLod]++;
+        }
+
+        return stats;
+    }
+
+    MeshCullingStats& MeshCullingStats::operator+=(const MeshCullingStats& other)
+    {
+        meshCount += other.meshCount;
+        visibleMeshCount += other.visibleMeshCount;
+        occludedMeshCount += other.occludedMeshCount;
+
+        return *this;
+    }
+
+    LodSelectionStats& LodSelectionStats::operator+=(const LodSelectionStats& other)
+    {
+        fullDetailTriangleCount += other.fullDetailTriangleCount;
+        selectedTriangleCount += other.selectedTriangleCount;
+
+        for (const uint32_t lod : std::views::iota(0u, MAX_MESH_LOD_COUNT))
+        {
+            meshCountPerLod[lod] += other.meshCountPerLod[lod];
+        }
+
+        return *this;
+    }
+
+    void Model::loadTransforms(RenderBackend& renderBackend, std::span<const NodeData> nodes)
+    {
+        m_transformHierarchy.reserve(static_cast<uint32_t>(nodes.size()) + 1u);
+
+        m_transformHierarchy.addNode(INVALID_INDEX_U32, toLocalTransform(m_transformComponent));
+        m_appliedTransformComponent = m_transformComponent;
+
+        // Cooked nodes are already ordered parents first, scene roots become children of the model root.
+        for (const NodeData& node : nodes)
+        {
+            m_transformHierarchy.addNode(node.parentIndex == INVALID_INDEX_U32 ? 0u : node.parentIndex + 1u, node.localTransform);
+        }
+
+        m_transformHierarchy.updateWorldMatrices();
+
+        for (ModelTransform& transform : m_transforms)
+        {
+            transform.buffer.data.positionDequantizationScale = m_positionDequantizationScale;
+            transform.buffer.data.positionDequantizationOffset = m_positionDequantizationOffset;
+
+            applyWorldMatrix(transform);
+
+            const BackendBufferDesc bufferDesc = {
+                .type = BufferType::Constant,
+                .size = static_cast<uint32_t>(sizeof(TransformBuffer)),
+            };
+
+            transform.buffer.buffer = BackendResource(renderBackend, renderBackend.createBuffer(bufferDesc, std::as_bytes(std::span(&transform.buffer.data, 1u))));
+        }
+
+        m_worldBounds.resize(static_cast<uint32_t>(m_meshes.size()));
+        updateWorldBounds();
+    }
+
+    void Model::applyWorldMatrix(ModelTransform& transform) const
+    {
+        const math::XMMATRIX& modelMatrix = m_transformHierarchy.getWorldMatrix(transform.nodeIndex);
+
+        transform.buffer.data.modelMatrix = modelMatrix;
+        transform.buffer.data.inverseModelMatrix = math::XMMatrixInverse(nullptr, modelMatrix);
+
+        // The rows of the upper 3x3 part are the transformed axes : uniform scaling keeps them orthogonal and of equal length.
+        const std::array<float, 3u> axisScales = {
+            math::XMVectorGetX(math::XMVector3Length(modelMatrix.r[0])),
+            math::XMVectorGetX(math::XMVector3Length(modelMatrix.r[1])),
+            math::XMVectorGetX(math::XMVector3Length(modelMatrix.r[2])),
+        };
+
+        transform.maximumScale = std::ranges::max(axisScales);
+
+        const float tolerance = 1e-4f * transform.maximumScale;
+        const float squaredTolerance = tolerance * transform.maximumScale;
+
+        transform.isUniformlyScaled = std::abs(axisScales[0] - axisScales[1]) <= tolerance && std::abs(axisScales[1] - axisScales[2]) <= tolerance &&
+                                      std::abs(math::XMVectorGetX(math::XMVector3Dot(modelMatrix.r[0], modelMatrix.r[1]))) <= squaredTolerance &&
+                                      std::abs(math::XMVectorGetX(math::XMVector3Dot(modelMatrix.r[1], modelMatrix.r[2]))) <= squaredTolerance &&
+                                      std::abs(math::XMVectorGetX(math::XMVector3Dot(modelMatrix.r[0], modelMatrix.r[2]))) <= squaredTolerance;
+    }
+
+    void Model::updateWorldBounds()
+    {
+        bool isAnyMeshUpdated = false;
+
+        for (const uint32_t meshIndex : std::views::iota(0u, static_cast<uint32_t>(m_meshes.size())))
+        {
+            const Mesh& mesh = m_meshes[meshIndex];
+            const ModelTransform& transform = m_transforms[mesh.transformIndex];
+
+            if (!m_transformHierarchy.isWorldMatrixUpdated(transform.nodeIndex))
+            {
+                continue;
+            }
+
+            const math::XMMATRIX& modelMatrix = transform.buffer.data.modelMatrix;
+
+            const math::XMVECTOR boundsMinimum = math::XMLoadFloat3(&mesh.bounds.minimum);
+            const math::XMVECTOR boundsMaximum = math::XMLoadFloat3(&mesh.bounds.maximum);
+
+            const math::XMVECTOR center = math::XMVector3TransformCoord(math::XMVectorScale(math::XMVectorAdd(boundsMinimum, boundsMaximum), 0.5f), modelMatrix);
+            const math::XMVECTOR extent = math::XMVectorScale(math::XMVectorSubtract(boundsMaximum, boundsMinimum), 0.5f);
+
+            // Arvo : the world space half extents of the transformed box are its object space ones transformed by the absolute matrix.
+            const math::XMVECTOR worldExtent =
+                math::XMVectorAdd(math::XMVectorAdd(math::XMVectorMultiply(math::XMVectorSplatX(extent), math::XMVectorAbs(modelMatrix.r[0])),
+                                                    math::XMVectorMultiply(math::XMVectorSplatY(extent), math::XMVectorAbs(modelMatrix.r[1]))),
+                                  math::XMVectorMultiply(math::XMVectorSplatZ(extent), math::XMVectorAbs(modelMatrix.r[2])));
+
+            AxisAlignedBoundingBox worldBox{};
+            math::XMStoreFloat3(&worldBox.minimum, math::XMVectorSubtract(center, worldExtent));
+            math::XMStoreFloat3(&worldBox.maximum, math::XMVectorAdd(center, worldExtent));
+
+            math::XMFLOAT3 worldSphereCenter{};
+            math::XMStoreFloat3(&worldSphereCenter, math::XMVector3TransformCoord(math::XMLoadFloat3(&mesh.sphereCenter), modelMatrix));
+
+            m_worldBounds.set(meshIndex, worldBox, worldSphereCenter, mesh.sphereRadius * transform.maximumScale);
+
+            isAnyMeshUpdated = true;
+        }
+
+        if (isAnyMeshUpdated)
+        {
+            m_worldBoundsVersion++;
+        }
+    }
+
+    AxisAlignedBoundingBox Model::getMeshWorldBounds(const uint32_t meshIndex) const
+    {
+        const math::XMFLOAT3 center = {m_worldBounds.boxCenterX[meshIndex], m_worldBounds.boxCenterY[meshIndex], m_worldBounds.boxCenterZ[meshIndex]};
+        const math::XMFLOAT3 extent = {m_worldBounds.boxExtentX[meshIndex], m_worldBounds.boxExtentY[meshIndex], m_worldBounds.boxExtentZ[meshIndex]};
+
+        return AxisAlignedBoundingBox{
+            .minimum = {center.x - extent.x, center.y - extent.y, center.z - extent.z},
+            .maximum = {center.x + extent.x, center.y + extent.y, center.z + extent.z},
+        };
+    }
+
+    float Model::raycastMesh(const uint32_t meshIndex, const Ray& ray) const
+    {
+        const Mesh& mesh = m_meshes[meshIndex];
+
+        if (m_meshCollisions.empty())
+        {
+            return intersectRayAabb(ray, getMeshWorldBounds(meshIndex));
+        }
+
+        const MeshCollision& collision = m_meshCollisions[mesh.cookedIndex];
+        const math::XMMATRIX& inverseModelMatrix = m_transforms[mesh.transformIndex].buffer.data.inverseModelMatrix;
+
+        // The direction is not normalized after the transform, so distances along the object space ray are the world space ones.
+        Ray objectSpaceRay{.maxDistance = ray.maxDistance};
+        math::XMStoreFloat3(&objectSpaceRay.origin, math::XMVector3TransformCoord(math::XMLoadFloat3(&ray.origin), inverseModelMatrix));
+        math::XMStoreFloat3(&objectSpaceRay.direction, math::XMVector3TransformNormal(math::XMLoadFloat3(&ray.direction), inverseModelMatrix));
+
+        const auto intersectTriangle = [&](const uint32_t triangleIndex, const Ray& triangleRay, const float maxDistance)
+        {
+            const Ray boundedRay{.origin = triangleRay.origin, .direction = triangleRay.direction, .maxDistance = maxDistance};
+
+            return intersectRayTriangle(boundedRay,
+                                        collision.positions[collision.indices[3u * triangleIndex]],
+                                        collision.positions[collision.indices[3u * triangleIndex + 1u]],
+                                        collision.positions[collision.indices[3u * triangleIndex + 2u]]);
+        };
+
+        return collision.bvh.raycast(objectSpaceRay, intersectTriangle).distance;
+    }
+
+    GeometryRange Model::getLodIndexRange(const Mesh& mesh, const uint32_t lod) const
+    {
+        const MeshLod& meshLod = m_lods[mesh.firstLod + lod];
+
+        return GeometryRange{
+            .first = mesh.firstIndex + meshLod.firstIndex,
+            .count = meshLod.indexCount,
+        };
+    }
+
+    void Model::recordInstanced(CommandList& commandList, const uint32_t instanceCount) const
+    {
+        if (m_meshes.empty())
+        {
+            return;
+        }
+
+        // All meshes live in the shared pool buffers, so only the index buffer may need rebinding (when the index size changes).
+        commandList.record(SetVertexBufferCommand{.buffer = m_geometryPool->getVertexBuffer(), .stride = getVertexSize(m_vertexFormat)});
+        uint32_t boundIndexSize = 0u;
+        uint32_t boundTransformIndex = INVALID_INDEX_U32;
+
+        const auto getSampler = [&](const uint32_t samplerStateIndex)
+        { return samplerStateIndex == INVALID_INDEX_U32 ? m_fallbackSamplerState.get() : m_samplers[samplerStateIndex].get(); };
+
+        for (const Mesh& mesh : m_meshes)
+        {
+            if (mesh.indexSize != boundIndexSize)
+            {
+                commandList.record(SetIndexBufferCommand{.buffer = m_geometryPool->getIndexBuffer(mesh.indexSize), .indexSize = mesh.indexSize});
+                boundIndexSize = mesh.indexSize;
+            }
+
+            if (mesh.transformIndex != boundTransformIndex)
+            {
+                commandList.record(SetConstantBufferCommand{.buffer = m_transforms[mesh.transformIndex].buffer.buffer.get(), .stage = ShaderStage::Vertex, .slot = 1u});
+                boundTransformIndex = mesh.transformIndex;
+            }
+
+            const PBRMaterial& material = m_materials[mesh.materialIndex];
+
+            // Albedo texture and sampler.
+            commandList.record(SetSamplerCommand{.sampler = getSampler(material.albedoTextureSamplerStateIndex), .stage = ShaderStage::Pixel, .slot = 0u});
+            commandList.record(SetShaderResourceCommand{.resource = material.albedoTexture, .stage = ShaderStage::Pixel, .slot = 0u});
+
+            // Normal texture and sampler.
+            commandList.record(SetSamplerCommand{.sampler = getSampler(material.normalTextureSamplerStateIndex), .stage = ShaderStage::Pixel, .slot = 1u});
+            commandList.record(SetShaderResourceCommand{.resource = material.normalTexture, .stage = ShaderStage::Pixel, .slot = 1u});
+
+            commandList.record(DrawIndexedInstancedCommand{
+                .indexCount = mesh.indicesCount,
+                .instanceCount = instanceCount,
+                .firstIndex = mesh.firstIndex,
+                .baseVertex = static_cast<int32_t>(mesh.baseVertex),
+            });
+        }
+    }
+
+    void Model::loadSamplers(RenderBackend& renderBackend, std::span<const SamplerData> samplers)
+    {
+        // Create fallback sampler.
+        const BackendSamplerDesc fallbackSamplerDesc = {
+            .filter = SamplerFilter::Anisotropic,
+            .addressModeU = SamplerAddressMode::Clamp,
+            .addressModeV = SamplerAddressMode::Clamp,
+        };
+
+        m_fallbackSamplerState = BackendResource(renderBackend, renderBackend.createSampler(fallbackSamplerDesc));
+
+        m_samplers.reserve(samplers.size());
+
+        const auto toAddressMode = [](const int wrap)
+        {
+            switch (wrap)
+            {
+                case TINYGLTF_TEXTURE_WRAP_CLAMP_TO_EDGE:
+                    {
+                        return SamplerAddressMode::Clamp;
+                    }
+                    break;
+
+                case TINYGLTF_TEXTURE_WRAP_MIRRORED_REPEAT:
+                    {
+                        return SamplerAddressMode::Mirror;
+                    }
+                    break;
+
+                default:
+                    {
+                        return SamplerAddressMode::Wrap;
+                    }
+                    break;
+            }
+        };
+
+        // Every sampler filters anisotropically, whatever the glTF filters are.
+        for (const SamplerData& sampler : samplers)
+        {
+            const BackendSamplerDesc samplerDesc = {
+                .filter = SamplerFilter::Anisotropic,
+                .addressModeU = toAddressMode(sampler.wrapS),
+                .addressModeV = toAddressMode(sampler.wrapT),
+            };
+
+            m_samplers.emplace_back(renderBackend, renderBackend.createSampler(samplerDesc));
+        }
+    }
+
+    void Model::loadMaterials(TextureCache& textureCache, const TextureHandle& fallbackTexture, JobSystem& jobSystem, const ModelData& modelData)
+    {
+        m_materials.resize(modelData.materials.size());
+
+        // Every texture of every material is requested as a separate job, so materials are no longer processed one at a time. Images shared
+        // between materials (or models) are only decoded once, by the first request, the others get the cached texture.
+        // Each job writes to a distinct field of the (already allocated) material and a distinct handle, so no synchronization is required.
+        JobCounter textureCounter{};
+
+        constexpr uint32_t MAX_MATERIAL_TEXTURE_COUNT = 5u;
+        m_textures.resize(modelData.materials.size() * MAX_MATERIAL_TEXTURE_COUNT);
+
+        uint32_t textureIndex = 0u;
+
+        const auto loadTexture = [&](const MaterialTextureData& textureData,
+                                     const TextureUsage usage,
+                                     const uint32_t materialIndex,
+                                     BackendHandle PBRMaterial::*field,
+                                     uint32_t& outSamplerIndex)
+        {
+            MaterialTexture& outTexture = m_textures[textureIndex++];
+            outTexture.materialIndex = materialIndex;
+            outTexture.field = field;
+
+            jobSystem.submit(
+                [&, usage]()
+                {
+                    SGFX_PROFILE_ZONE("Material texture decode");
+
+                    outTexture.texture = textureCache.getTexture(m_modelDirectory + std::string(modelData.imagePaths[textureData.imageIndex]), usage);
+                    outSamplerIndex = textureData.samplerIndex;
+                },
+                textureCounter);
+        };
+
+        for (const uint32_t materialIndex : std::views::iota(0u, static_cast<uint32_t>(modelData.materials.size())))
+        {
+            const MaterialData& material = modelData.materials[materialIndex];
+            PBRMaterial& pbrMaterial = m_materials[materialIndex];
+
+            if (material.albedo.imageIndex != INVALID_INDEX_U32)
+            {
+                loadTexture(material.albedo, TextureUsage::Albedo, materialIndex, &PBRMaterial::albedoTexture, pbrMaterial.albedoTextureSamplerStateIndex);
+            }
+            else
+            {
+                // Tracked like the other textures, so the material follows the fallback texture's streaming too.
+                m_textures[textureIndex++] = MaterialTexture{
+                    .texture = fallbackTexture,
+                    .materialIndex = materialIndex,
+                    .field = &PBRMaterial::albedoTexture,
+                };
+
+                pbrMaterial.albedoTextureSamplerStateIndex = INVALID_INDEX_U32;
+            }
+
+            if (material.metalRoughness.imageIndex != INVALID_INDEX_U32)
+            {
+                loadTexture(material.metalRoughness, TextureUsage::MetalRoughness, materialIndex, &PBRMaterial::metalRoughnessTexture, pbrMaterial.metalRoughnessTextureSamplerStateIndex);
+            }
+
+            if (material.normal.imageIndex != INVALID_INDEX_U32)
+            {
+                loadTexture(material.normal, TextureUsage::Normal, materialIndex, &PBRMaterial::normalTexture, pbrMaterial.normalTextureSamplerStateIndex);
+            }
+            else
+            {
+                pbrMaterial.normalTextureSamplerStateIndex = INVALID_INDEX_U32;
+            }
+
+            if (material.occlusion.imageIndex != INVALID_INDEX_U32)
+            {
+                loadTexture(material.occlusion, TextureUsage::Occlusion, materialIndex, &PBRMaterial::aoTexture, pbrMaterial.aoTextureSamplerStateIndex);
+            }
+
+            if (material.emissive.imageIndex != INVALID_INDEX_U32)
+            {
+                loadTexture(material.emissive, TextureUsage::Emissive, materialIndex, &PBRMaterial::emissiveTexture, pbrMaterial.emissiveTextureSamplerStateIndex);
+            }
+        }
+
+        jobSystem.wait(textureCounter);
+
+        m_textures.resize(textureIndex);
+
+        updateMaterialTextures();
+    }
+
+    void Model::loadMeshes(const ModelData& modelData)
+    {
+        m_geometryAllocation = std::make_shared<GeometryAllocation>(*m_geometryPool);
+
+        // Tiling texture coordinates would visibly snap as half floats.
+        if (m_vertexFormat == VertexFormat::Compact && !canEncodeCompactTextureCoords(modelData.vertices))
+        {
+            m_loadStats.isCompactVertexFormatRejected = true;
+            m_vertexFormat = VertexFormat::Float;
+        }
+
+        // The vertex and index data is passed as is (it may point directly into the memory mapped cooked file), unless vertices are encoded to the compact format.
+        // All vertices of the model are uploaded as a single range, indices are uploaded per mesh as their format may differ.
+        m_geometryAllocation->vertexSize = getVertexSize(m_vertexFormat);
+
+        if (m_vertexFormat == VertexFormat::Compact)
+        {
+            // Positions are quantized to the bounds of the whole model, so a single dequantization transform applies to every mesh.
+            AxisAlignedBoundingBox modelBounds{
+                .minimum = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()},
+                .maximum = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()},
+            };
+
+            for (const MeshData& meshData : modelData.meshes)
+            {
+                math::XMStoreFloat3(&modelBounds.minimum, math::XMVectorMin(math::XMLoadFloat3(&modelBounds.minimum), math::XMLoadFloat3(&meshData.bounds.minimum)));
+                math::XMStoreFloat3(&modelBounds.maximum, math::XMVectorMax(math::XMLoadFloat3(&modelBounds.maximum), math::XMLoadFloat3(&meshData.bounds.maximum)));
+            }
+
+            std::vector<CompactModelVertex> compactVertices(modelData.vertices.size());
+            encodeCompactVertices(modelData.vertices, modelBounds, compactVertices);
+
+            const PositionDequantization positionDequantization = getPositionDequantization(modelBounds);
+            m_positionDequantizationScale = positionDequantization.scale;
+            m_positionDequantizationOffset = positionDequantization.offset;
+
+            m_geometryAllocation->vertexRange = m_geometryPool->uploadVertices(std::as_bytes(std::span(compactVertices)), m_geometryAllocation->vertexSize);
+        }
+        else
+        {
+            m_geometryAllocation->vertexRange = m_geometryPool->uploadVertices(std::as_bytes(modelData.vertices), m_geometryAllocation->vertexSize);
+        }
+
+        m_meshes.reserve(modelData.meshes.size());
+        m_meshlets.assign(modelData.meshlets.begin(), modelData.meshlets.end());
+
+        m_lods.reserve(modelData.lods.size());
+        for (const MeshLodData& lodData : modelData.lods)
+        {
+            m_lods.emplace_back(MeshLod{
+                .firstIndex = lodData.firstIndex,
+                .indexCount = lodData.indexCount,
+                .error = lodData.error,
+            });
+        }
+
+        m_geometryAllocation->indexRanges.reserve(modelData.meshes.size());
+
+        // One transform per node instancing meshes, in order of first use.
+        std::vector<uint32_t> nodeTransformIndices(modelData.nodes.size(), INVALID_INDEX_U32);
+
+        for (const uint32_t cookedIndex : std::views::iota(0u, static_cast<uint32_t>(modelData.meshes.size())))
+        {
+            const MeshData& meshData = modelData.meshes[cookedIndex];
+
+            uint32_t& transformIndex = nodeTransformIndices[meshData.nodeIndex];
+            if (transformIndex == INVALID_INDEX_U32)
+            {
+                transformIndex = static_cast<uint32_t>(m_transforms.size());
+                m_transforms.emplace_back(ModelTransform{.nodeIndex = meshData.nodeIndex + 1u});
+            }
+
+            // The indices of every LOD are uploaded as one range, so LODs are addressed relative to the mesh's first index.
+            const std::span<const std::byte> indices = modelData.indexData.subspan(meshData.indexByteOffset, static_cast<size_t>(meshData.totalIndexCount) * meshData.indexSize);
+
+            const GeometryRange indexRange = m_geometryPool->uploadIndices(indices, meshData.indexSize);
+            m_geometryAllocation->indexRanges.emplace_back(indexRange, meshData.indexSize);
+
+            m_meshes.emplace_back(Mesh{
+                .baseVertex = m_geometryAllocation->vertexRange.first + meshData.firstVertex,
+                .firstIndex = indexRange.first,
+                .indicesCount = meshData.indexCount,
+                .indexSize = meshData.indexSize,
+                .materialIndex = meshData.materialIndex,
+                .cookedIndex = cookedIndex,
+                .transformIndex = transformIndex,
+                .bounds = meshData.bounds,
+                .sphereCenter = meshData.sphereCenter,
+                .sphereRadius = meshData.sphereRadius,
+                .textureCoordDensity = meshData.textureCoordDensity,
+                .firstMeshlet = meshData.firstMeshlet,
+                .meshletCount = meshData.meshletCount,
+                .firstLod = meshData.firstLod,
+                .lodCount = meshData.lodCount,
+            });
+        }
+
+        std::ranges::stable_sort(m_meshes, {}, [](const Mesh& mesh) { return std::pair(mesh.indexSize != sizeof(uint16_t), mesh.transformIndex); });
+
+        m_selectedLods.assign(m_meshes.size(), 0u);
+    }
+
+    void Model::loadMeshCollision(const ModelData& modelData, const uint32_t cookedMeshIndex)
+    {
+        const MeshData& meshData = modelData.meshes[cookedMeshIndex];
+        MeshCollision& collision = m_meshCollisions[cookedMeshIndex];
+
+        collision.positions.reserve(meshData.vertexCount);
+        for (const ModelVertex& vertex : modelData.vertices.subspan(meshData.firstVertex, meshData.vertexCount))
+        {
+            collision.positions.emplace_back(vertex.position);
+        }
+
+        collision.indices = readMeshIndices(modelData, meshData);
+
+        std::vector<AxisAlignedBoundingBox> triangleBounds(meshData.indexCount / 3u);
+
+        for (const uint32_t triangleIndex : std::views::iota(0u, static_cast<uint32_t>(triangleBounds.size())))
+        {
+            const math::XMVECTOR p0 = math::XMLoadFloat3(&collision.positions[collision.indices[3u * triangleIndex]]);
+            const math::XMVECTOR p1 = math::XMLoadFloat3(&collision.positions[collision.indices[3u * triangleIndex + 1u]]);
+            const math::XMVECTOR p2 = math::XMLoadFloat3(&collision.positions[collision.indices[3u * triangleIndex + 2u]]);
+
+            math::XMStoreFloat3(&triangleBounds[triangleIndex].minimum, math::XMVectorMin(p0, math::XMVectorMin(p1, p2)));
+            math::XMStoreFloat3(&triangleBounds[triangleIndex].maximum, math::XMVectorMax(p0, math::XMVectorMax(p1, p2)));
+        }
+
+        collision.bvh.build(triangleBounds);
+    }
+
+    void Model::loadRasterData(JobSystem& jobSystem, const ModelData& modelData)
+    {
+        JobCounter loadCounter{};
+        const ScopedJobWait loadWait(jobSystem, loadCounter);
+
+        m_meshRasterData.resize(modelData.meshes.size());
+        jobSystem.parallelFor(
+            static_cast<uint32_t>(modelData.meshes.size()),
+            1u,
+            [&](const uint32_t meshIndex)
+            {
+                const MeshData& meshData = modelData.meshes[meshIndex];
+                const std::span<const ModelVertex> vertices = modelData.vertices.subspan(meshData.firstVertex, meshData.vertexCount);
+
+                m_meshRasterData[meshIndex] = MeshRasterData{
+                    .vertices = std::vector<ModelVertex>(vertices.begin(), vertices.end()),
+                    .indices = readMeshIndices(modelData, meshData),
+                };
+            },
+            loadCounter);
+
+        // Only the textures GPass.hlsl samples. Each image is decoded once per usage, however many materials use it.
+        std::map<std::pair<uint32_t, TextureUsage>, uint32_t> textureIndices{};
+
+        const auto addTexture = [&](const MaterialTextureData& textureData, const TextureUsage usage)
+        {
+            if (textureData.imageIndex == INVALID_INDEX_U32)
+            {
+                return INVALID_INDEX_U32;
+            }
+
+            return textureIndices.try_emplace(std::pair(textureData.imageIndex, usage), static_cast<uint32_t>(textureIndices.size())).first->second;
+        };
+
+        m_rasterMaterials.resize(modelData.materials.size());
+        for (const uint32_t materialIndex : std::views::iota(0u, static_cast<uint32_t>(modelData.materials.size())))
+        {
+            m_rasterMaterials[materialIndex] = RasterMaterial{
+                .albedoTextureIndex = addTexture(modelData.materials[materialIndex].albedo, TextureUsage::Albedo),
+                .normalTextureIndex = addTexture(modelData.materials[materialIndex].normal, TextureUsage::Normal),
+            };
+        }
+
+        std::vector<std::pair<uint32_t, TextureUsage>> textures(textureIndices.size());
+        for (const auto& [texture, textureIndex] : textureIndices)
+        {
+            textures[textureIndex] = texture;
+        }
+
+        m_rasterTextures.resize(textures.size());
+        jobSystem.parallelFor(
+            static_cast<uint32_t>(textures.size()),
+            1u,
+            [&](const uint32_t textureIndex)
+            {
+                const auto [imageIndex, usage] = textures[textureIndex];
+
+                const std::string path = m_modelDirectory + std::string(modelData.imagePaths[imageIndex]);
+                const bool isSrgb = isSrgbTextureUsage(usage);
+
+                // The texture cache cooked every image it could block compress, the others are decoded from the source image.
+                if (std::optional<RasterTexture> texture = loadCookedRasterTexture(getCookedTexturePath(path, usage), isSrgb))
+                {
+                    m_rasterTextures[textureIndex] = std::move(*texture);
+                    return;
+                }
+
+                int width{};
+                int height{};
+                stbi_uc* const pixels = stbi_load(path.c_str(), &width, &height, nullptr, STBI_rgb_alpha);
+                if (!pixels)
+                {
+                    fatalError(std::format("Failed to decode texture : {}.", path));
+                }
+
+                m_rasterTextures[textureIndex] = createRasterTexture(static_cast<uint32_t>(width),
+                                                                     static_cast<uint32_t>(height),
+                                                                     std::span(pixels, static_cast<size_t>(width) * height * 4u),
+                                                                     isSrgb);
+                stbi_image_free(pixels);
+            },
+            loadCounter);
+
+        jobSystem.wait(loadCounter);
+    }
+
+    void Model::convertModel(tinygltf::Model* const model, JobSystem& jobSystem, const ModelLoadOptions& loadOptions, ModelDataStorage& modelDataStorage, ModelLoadStats& loadStats) const
+    {
+        for (const tinygltf::Sampler& sampler : model->samplers)
+        {
+            modelDataStorage.samplers.emplace_back(SamplerData{
+                .minFilter = sampler.minFilter,
+                .magFilter = sampler.magFilter,
+                .wrapS = sampler.wrapS,
+                .wrapT = sampler.wrapT,
+            });
+        }
+
+        for (const tinygltf::Image& image : model->images)
+        {
+            modelDataStorage.imagePaths.emplace_back(image.uri);
+        }
+
+        const auto toMaterialTextureData = [&](const int textureIndex)
+        {
+            if (textureIndex < 0)
+            {
+                return MaterialTextureData{};
+            }
+
+            const tinygltf::Texture& texture = model->textures[textureIndex];
+
+            return MaterialTextureData{
+                .imageIndex = static_cast<uint32_t>(texture.source),
+                .samplerIndex = static_cast<uint32_t>(texture.sampler),
+            };
+        };
+
+        for (const tinygltf::Material& material : model->materials)
+        {
+            modelDataStorage.materials.emplace_back(MaterialData{
+                .albedo = toMaterialTextureData(material.pbrMetallicRoughness.baseColorTexture.index),
+                .metalRoughness = toMaterialTextureData(material.pbrMetallicRoughness.metallicRoughnessTexture.index),
+                .normal = toMaterialTextureData(material.normalTexture.index),
+                .occlusion = toMaterialTextureData(material.occlusionTexture.index),
+                .emissive = toMaterialTextureData(material.emissiveTexture.index),
+            });
+        }
+
+        std::vector<PrimitiveData> primitives{};
+
+        const tinygltf::Scene& scene = model->scenes[model->defaultScene];
+        for (const int& nodeIndex : scene.nodes)
+        {
+            convertNode(nodeIndex, INVALID_INDEX_U32, model, primitives, modelDataStorage.nodes);
+        }
+
+        // Generating tangents may split vertices, so it runs before any pass that depends on the vertex count.
+        generateTangents(jobSystem, primitives, loadStats);
+
+        if (loadOptions.optimizeMeshes)
+        {
+            optimizePrimitives(jobSystem, primitives, loadStats);
+        }
+
+        if (loadOptions.generateLods)
+        {
+            generateLods(jobSystem, primitives, loadStats);
+        }
+
+        if (loadOptions.generateMeshlets)
+        {
+            generateMeshlets(jobSystem, primitives, loadStats);
+        }
+
+        // Reserve space for every primitive up front, so packing them does not repeatedly reallocate the streams.
+        size_t vertexCount = 0u;
+        size_t indexCount = 0u;
+        for (const PrimitiveData& primitive : primitives)
+        {
+            vertexCount += primitive.vertices.size();
+            indexCount += primitive.indices.size();
+
+            for (const PrimitiveLodData& lod : primitive.lods)
+            {
+                indexCount += lod.indices.size();
+            }
+        }
+
+        modelDataStorage.vertices.reserve(vertexCount);
+        modelDataStorage.indexData.reserve(indexCount * sizeof(uint32_t));
+
+        for (const PrimitiveData& primitive : primitives)
+        {
+            modelDataStorage.addPrimitive(primitive);
+        }
+    }
+
+    void Model::generateTangents(JobSystem& jobSystem, std::span<PrimitiveData> primitives, ModelLoadStats& loadStats) const
+    {
+        JobCounter tangentCounter{};
+        jobSystem.parallelFor(
+            static_cast<uint32_t>(primitives.size()),
+            1u,
+            [&](const uint32_t index)
+            {
+                PrimitiveData& primitive = primitives[index];
+                if (!primitive.hasTangents)
+                {
+                    computeTangents(primitive.vertices, primitive.indices);
+                }
+            },
+            tangentCounter);
+
+        jobSystem.wait(tangentCounter);
+
+        loadStats.primitiveCount = static_cast<uint32_t>(primitives.size());
+        loadStats.generatedTangentPrimitiveCount = static_cast<uint32_t>(std::ranges::count_if(primitives, [](const PrimitiveData& primitive) { return !primitive.hasTangents; }));
+    }
+
+    void Model::optimizePrimitives(JobSystem& jobSystem, std::span<PrimitiveData> primitives, ModelLoadStats& loadStats) const
+    {
+        struct PrimitiveStatistics
+        {
+            VertexCacheStatistics vertexCache{};
+            VertexFetchStatistics vertexFetch{};
+        };
+
+        std::vector<PrimitiveStatistics> statisticsBefore(primitives.size());
+        std::vector<PrimitiveStatistics> statisticsAfter(primitives.size());
+
+        const auto analyze = [](const PrimitiveData& primitive)
+        {
+            const uint32_t vertexCount = static_cast<uint32_t>(primitive.vertices.size());
+
+            return PrimitiveStatistics{
+                .vertexCache = analyzeVertexCache(primitive.indices, vertexCount),
+                .vertexFetch = analyzeVertexFetch(primitive.indices, vertexCount, sizeof(ModelVertex)),
+            };
+        };
+
+        // Primitives are independent of each other, so each is optimized as a separate job.
+        JobCounter optimizeCounter{};
+        jobSystem.parallelFor(
+            static_cast<uint32_t>(primitives.size()),
+            1u,
+            [&](const uint32_t index)
+            {
+                PrimitiveData& primitive = primitives[index];
+
+                statisticsBefore[index] = analyze(primitive);
+
+                optimizeVertexCache(primitive.indices, static_cast<uint32_t>(primitive.vertices.size()));
+                optimizeOverdraw(primitive.indices, primitive.vertices);
+                optimizeVertexFetch(primitive.vertices, primitive.indices);
+
+                statisticsAfter[index] = analyze(primitive);
+            },
+            optimizeCounter);
+
+        jobSystem.wait(optimizeCounter);
+
+        const auto accumulate = [](std::span<const PrimitiveStatistics> statistics)
+        {
+            PrimitiveStatistics total{};
+            for (const PrimitiveStatistics& primitiveStatistics : statistics)
+            {
+                total.vertexCache.vertexTransformCount += primitiveStatistics.vertexCache.vertexTransformCount;
+                total.vertexCache.triangleCount += primitiveStatistics.vertexCache.triangleCount;
+                total.vertexCache.vertexCount += primitiveStatistics.vertexCache.vertexCount;
+
+                total.vertexFetch.bytesFetched += primitiveStatistics.vertexFetch.bytesFetched;
+                total.vertexFetch.vertexBufferSize += primitiveStatistics.vertexFetch.vertexBufferSize;
+            }
+
+            return total;
+        };
+
+        const PrimitiveStatistics before = accumulate(statisticsBefore);
+        const PrimitiveStatistics after = accumulate(statisticsAfter);
+
+        loadStats.vertexCacheBefore = before.vertexCache;
+        loadStats.vertexCacheAfter = after.vertexCache;
+        loadStats.vertexFetchBefore = before.vertexFetch;
+        loadStats.vertexFetchAfter = after.vertexFetch;
+    }
+
+    void Model::generateMeshlets(JobSystem& jobSystem, std::span<PrimitiveData> primitives, ModelLoadStats& loadStats) const
+    {
+        // Meshlets are built in index order, so this runs after the optimization passes have settled the triangle order.
+        JobCounter meshletCounter{};
+        jobSystem.parallelFor(
+            static_cast<uint32_t>(primitives.size()),
+            1u,
+            [&](const uint32_t index)
+            {
+                PrimitiveData& primitive = primitives[index];
+                primitive.meshlets = buildMeshlets(primitive.indices, primitive.vertices);
+            },
+            meshletCounter);
+
+        jobSystem.wait(meshletCounter);
+
+        for (const PrimitiveData& primitive : primitives)
+        {
+            loadStats.meshletCount += primitive.meshlets.size();
+            loadStats.meshletConeCount += std::ranges::count_if(primitive.meshlets, [](const MeshletData& meshlet) { return meshlet.coneCutoff < 1.0f; });
+            loadStats.meshletTriangleCount += primitive.indices.size() / 3u;
+        }
+    }
+
+    void Model::generateLods(JobSystem& jobSystem, std::span<PrimitiveData> primitives, ModelLoadStats& loadStats) const
+    {
+        // Each LOD halves the triangle count of the previous one, and is simplified from it rather than from the full resolution mesh.
+        // The error of a LOD is therefore bounded by the sum of the errors of every simplification that led to it.
+        constexpr float LOD_TRIANGLE_RATIO = 0.5f;
+        constexpr float MINIMUM_LOD_REDUCTION = 0.85f;
+        constexpr size_t MINIMUM_LOD_TRIANGLE_COUNT = 16u;
+
+        JobCounter lodCounter{};
+        jobSystem.parallelFor(
+            static_cast<uint32_t>(primitives.size()),
+            1u,
+            [&](const uint32_t index)
+            {
+                PrimitiveData& primitive = primitives[index];
+
+                std::span<const uint32_t> previousIndices = primitive.indices;
+                float error = 0.0f;
+
+                // Reserved so the span over the previous LOD's indices is never invalidated.
+                primitive.lods.clear();
+                primitive.lods.reserve(MAX_MESH_LOD_COUNT - 1u);
+
+                while (primitive.lods.size() + 1u < MAX_MESH_LOD_COUNT)
+                {
+                    const size_t targetTriangleCount = static_cast<size_t>(static_cast<float>(previousIndices.size() / 3u) * LOD_TRIANGLE_RATIO);
+                    if (targetTriangleCount < MINIMUM_LOD_TRIANGLE_COUNT)
+                    {
+                        break;
+                    }
+
+                    float lodError = 0.0f;
+                    std::vector<uint32_t> lodIndices =
+                        simplifyMesh(previousIndices, primitive.vertices, targetTriangleCount * 3u, std::numeric_limits<float>::max(), lodError);
+
+                    // Stop once locked vertices (borders, seams) prevent any meaningful reduction.
+                    if (static_cast<float>(lodIndices.size()) > static_cast<float>(previousIndices.size()) * MINIMUM_LOD_REDUCTION)
+                    {
+                        break;
+                    }
+
+                    optimizeVertexCache(lodIndices, static_cast<uint32_t>(primitive.vertices.size()));
+
+                    error += lodError;
+                    primitive.lods.emplace_back(PrimitiveLodData{
+                        .indices = std::move(lodIndices),
+                        .error = error,
+                    });
+
+                    previousIndices = primitive.lods.back().indices;
+                }
+            },
+            lodCounter);
+
+        jobSystem.wait(lodCounter);
+
+        for (const PrimitiveData& primitive : primitives)
+        {
+            // Primitives with a shorter chain contribute their coarsest LOD to the remaining levels.
+            for (const uint32_t lod : std::views::iota(0u, MAX_MESH_LOD_COUNT))
+            {
+                const std::vector<uint32_t>& indices = lod == 0u || primitive.lods.empty() ? primitive.indices : primitive.lods[std::min<size_t>(lod, primitive.lods.size()) - 1u].indices;
+                loadStats.lodTriangleCounts[lod] += indices.size() / 3u;
+            }
+        }
+    }
+
+    void Model::convertNode(uint32_t nodeIndex,
+                            const uint32_t parentNodeIndex,
+                            tinygltf::Model* const model,
+                            std::vector<PrimitiveData>& primitives,
+                            std::vector<NodeData>& nodes) const
+    {
+        const tinygltf::Node& node = model->nodes[nodeIndex];
+
+        // Nodes are cooked in depth first order, so parents always come before their children.
+        NodeData& nodeData = nodes.emplace_back(NodeData{.parentIndex = parentNodeIndex});
+        LocalTransform& localTransform = nodeData.localTransform;
+
+        if (node.matrix.size() == 16u)
+        {
+            // glTF matrices are column major for column vectors, which is the same memory layout as a row major matrix for row vectors.
+            math::XMFLOAT4X4 matrix{};
+            std::ranges::transform(node.matrix, &matrix.m[0][0], [](const double value) { return static_cast<float>(value); });
+
+            math::XMVECTOR scale{};
+            math::XMVECTOR rotation{};
+            math::XMVECTOR translation{};
+
+            if (math::XMMatrixDecompose(&scale, &rotation, &translation, math::XMLoadFloat4x4(&matrix)))
+            {
+                math::XMStoreFloat3(&localTransform.scale, scale);
+                math::XMStoreFloat4(&localTransform.rotation, rotation);
+                math::XMStoreFloat3(&localTransform.translation, translation);
+            }
+        }
+        else
+        {
+            if (node.translation.size() == 3u)
+            {
+                localTransform.translation = {static_cast<float>(node.translation[0]), static_cast<float>(node.translation[1]), static_cast<float>(node.translation[2])};
+            }
+
+            if (node.rotation.size() == 4u)
+            {
+                localTransform.rotation = {static_cast<float>(node.rotation[0]),
+                                           static_cast<float>(node.rotation[1]),
+                                           static_cast<float>(node.rotation[2]),
+                                           static_cast<float>(node.rotation[3])};
+            }
+
+            if (node.scale.size() == 3u)
+            {
+                localTransform.scale = {static_cast<float>(node.scale[0]), static_cast<float>(node.scale[1]), static_cast<float>(node.scale[2])};
+            }
+        }
+
+        const uint32_t cookedNodeIndex = static_cast<uint32_t>(nodes.size() - 1u);
+
+        if (node.mesh < 0)
+        {
+            // Load children immediatly, as it may have some.
+            for (const int& childrenNodeIndex : node.children)
+            {
+                convertNode(childrenNodeIndex, cookedNodeIndex, model, primitives, nodes);
+            }
+
+            return;
+        }
+
+        const auto getAccessorView = [&](const tinygltf::Accessor& accessor)
+        {
+            const tinygltf::BufferView& bufferView = model->bufferViews[accessor.bufferView];
+            const tinygltf::Buffer& buffer = model->buffers[bufferView.buffer];
+
+            return AccessorView{
+                .data = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset,
+                .byteStride = static_cast<uint32_t>(accessor.ByteStride(bufferView)),
+                .count = static_cast<uint32_t>(accessor.count),
+                .componentType = static_cast<uint32_t>(accessor.componentType),
+                .componentCount = static_cast<uint32_t>(tinygltf::GetNumComponentsInType(accessor.type)),
+                .normalized = accessor.normalized,
+            };
+        };
+
+        tinygltf::Mesh& nodeMesh = model->meshes[node.mesh];
+        for (size_t i = 0; i < nodeMesh.primitives.size(); ++i)
+        {
+            PrimitiveData& primitiveData = primitives.emplace_back();
+
+            // Reference used : https://github.com/mateeeeeee/Adria-DX12/blob/fc98468095bf5688a186ca84d94990ccd2f459b0/Adria/Rendering/EntityLoader.cpp.
+
+            // Get Accesor for each attribute (position, textureCoord, normal, tangent). Only the position is required, missing attributes are left zeroed.
+            const tinygltf::Primitive& primitive = nodeMesh.primitives[i];
+            const tinygltf::Accessor& indexAccesor = model->accessors[primitive.indices];
+
+            const auto findAccessor = [&](const std::string& attributeName) -> const tinygltf::Accessor*
+            {
+                const auto attribute = primitive.attributes.find(attributeName);
+                return attribute != primitive.attributes.end() ? &model->accessors[attribute->second] : nullptr;
+            };
+
+            const tinygltf::Accessor* const positionAccesor = findAccessor("POSITION");
+            const tinygltf::Accessor* const textureCoordAccesor = findAccessor("TEXCOORD_0");
+            const tinygltf::Accessor* const normalAccesor = findAccessor("NORMAL");
+            const tinygltf::Accessor* const tangentAccesor = findAccessor("TANGENT");
+
+            if (!positionAccesor)
+            {
+                fatalError(std::format("Primitive of mesh {} has no POSITION attribute.", node.mesh));
+            }
+
+            // Fill in the vertices array, all attributes of a block of vertices at a time.
+            primitiveData.vertices.resize(positionAccesor->count);
+
+            std::vector<AttributeConversion> attributeConversions{};
+            for (const auto& [accessor, attributeOffset] : {std::pair{positionAccesor, offsetof(ModelVertex, position)},
+                                                            std::pair{textureCoordAccesor, offsetof(ModelVertex, textureCoord)},
+                                                            std::pair{normalAccesor, offsetof(ModelVertex, normal)},
+                                                            std::pair{tangentAccesor, offsetof(ModelVertex, tangent)}})
+            {
+                if (accessor)
+                {
+                    attributeConversions.emplace_back(AttributeConversion{.accessor = getAccessorView(*accessor), .destinationOffset = static_cast<uint32_t>(attributeOffset)});
+                }
+            }
+
+            convertAttributesToFloats(attributeConversions, reinterpret_cast<std::byte*>(primitiveData.vertices.data()), sizeof(ModelVertex));
+
+            primitiveData.hasTangents = tangentAccesor != nullptr;
+
+            // Fill indices array.
+            primitiveData.indices.resize(indexAccesor.count);
+            convertIndices(getAccessorView(indexAccesor), primitiveData.indices.data());
 
-            m_meshes.emplace_back(mesh);
+            primitiveData.materialIndex = primitive.material;
+            primitiveData.nodeIndex = cookedNodeIndex;
         }
 
         for (const int& childrenNodeIndex : node.children)
         {
-            loadNode(device, childrenNodeIndex, model);
+            convertNode(childrenNodeIndex, cookedNodeIndex, model, primitives, nodes);
         }
     }
 }
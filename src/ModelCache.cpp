@@ -0,0 +1,445 @@
+#include "Pch.hpp"
+
+#include "ModelCache.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        constexpr uint32_t MODEL_CACHE_MAGIC = 0x4d584653u; // 'SFXM'.
+        constexpr uint32_t MODEL_CACHE_VERSION = 9u;
+
+        constexpr uint64_t MODEL_CACHE_SECTION_ALIGNMENT = 4096u;
+
+        enum class ModelCacheSectionType : uint32_t
+        {
+            Vertices,
+            IndexData,
+            Meshes,
+            Materials,
+            Samplers,
+            ImagePaths,
+            Meshlets,
+            Lods,
+            Nodes,
+            Count,
+        };
+
+        struct ModelCacheSection
+        {
+            uint64_t offset{};
+            uint64_t size{};
+        };
+
+        struct ModelCacheHeader
+        {
+            uint32_t magic{MODEL_CACHE_MAGIC};
+            uint32_t version{MODEL_CACHE_VERSION};
+            uint64_t cacheKey{};
+
+            std::array<ModelCacheSection, enumClassValue(ModelCacheSectionType::Count)> sections{};
+        };
+
+        template <typename T> std::span<const T> getSection(const std::byte* const mappedData, const ModelCacheSection& section)
+        {
+            return std::span<const T>(reinterpret_cast<const T*>(mappedData + section.offset), static_cast<size_t>(section.size / sizeof(T)));
+        }
+    }
+
+    void ModelDataStorage::addPrimitive(const PrimitiveData& primitive)
+    {
+        MeshData meshData{
+            .firstVertex = static_cast<uint32_t>(vertices.size()),
+            .vertexCount = static_cast<uint32_t>(primitive.vertices.size()),
+            .indexCount = static_cast<uint32_t>(primitive.indices.size()),
+            .materialIndex = primitive.materialIndex,
+            .nodeIndex = primitive.nodeIndex,
+            .firstMeshlet = static_cast<uint32_t>(meshlets.size()),
+            .meshletCount = static_cast<uint32_t>(primitive.meshlets.size()),
+            .firstLod = static_cast<uint32_t>(lods.size()),
+            .lodCount = static_cast<uint32_t>(primitive.lods.size() + 1u),
+        };
+
+        vertices.insert(vertices.end(), primitive.vertices.begin(), primitive.vertices.end());
+        meshlets.insert(meshlets.end(), primitive.meshlets.begin(), primitive.meshlets.end());
+
+        math::XMVECTOR boundsMinimum = math::XMVectorReplicate(std::numeric_limits<float>::max());
+        math::XMVECTOR boundsMaximum = math::XMVectorReplicate(std::numeric_limits<float>::lowest());
+
+        for (const ModelVertex& vertex : primitive.vertices)
+        {
+            const math::XMVECTOR position = math::XMLoadFloat3(&vertex.position);
+            boundsMinimum = math::XMVectorMin(boundsMinimum, position);
+            boundsMaximum = math::XMVectorMax(boundsMaximum, position);
+        }
+
+        math::XMStoreFloat3(&meshData.bounds.minimum, boundsMinimum);
+        math::XMStoreFloat3(&meshData.bounds.maximum, boundsMaximum);
+
+        const math::XMVECTOR sphereCenter = math::XMVectorScale(math::XMVectorAdd(boundsMinimum, boundsMaximum), 0.5f);
+        math::XMVECTOR squaredSphereRadius = math::XMVectorZero();
+
+        for (const ModelVertex& vertex : primitive.vertices)
+        {
+            squaredSphereRadius = math::XMVectorMax(squaredSphereRadius, math::XMVector3LengthSq(math::XMVectorSubtract(math::XMLoadFloat3(&vertex.position), sphereCenter)));
+        }
+
+        math::XMStoreFloat3(&meshData.sphereCenter, sphereCenter);
+        meshData.sphereRadius = std::sqrt(math::XMVectorGetX(squaredSphereRadius));
+
+        // Accumulated over the whole primitive, so degenerate or seam triangles do not skew the density.
+        float surfaceArea = 0.0f;
+        float textureCoordArea = 0.0f;
+
+        for (size_t i = 0u; i + 2u < primitive.indices.size(); i += 3u)
+        {
+            const ModelVertex& v0 = primitive.vertices[primitive.indices[i]];
+            const ModelVertex& v1 = primitive.vertices[primitive.indices[i + 1u]];
+            const ModelVertex& v2 = primitive.vertices[primitive.indices[i + 2u]];
+
+            const math::XMVECTOR p0 = math::XMLoadFloat3(&v0.position);
+            const math::XMVECTOR edge1 = math::XMVectorSubtract(math::XMLoadFloat3(&v1.position), p0);
+            const math::XMVECTOR edge2 = math::XMVectorSubtract(math::XMLoadFloat3(&v2.position), p0);
+            surfaceArea += 0.5f * math::XMVectorGetX(math::XMVector3Length(math::XMVector3Cross(edge1, edge2)));
+
+            const float du1 = v1.textureCoord.x - v0.textureCoord.x;
+            const float dv1 = v1.textureCoord.y - v0.textureCoord.y;
+            const float du2 = v2.textureCoord.x - v0.textureCoord.x;
+            const float dv2 = v2.textureCoord.y - v0.textureCoord.y;
+            textureCoordArea += 0.5f * std::abs(du1 * dv2 - du2 * dv1);
+        }
+
+        meshData.textureCoordDensity = surfaceArea > 0.0f ? std::sqrt(textureCoordArea / surfaceArea) : 0.0f;
+
+        // 0xffff is excluded so the strip cut value can never appear as a regular index.
+        const bool useShortIndices = primitive.vertices.size() < std::numeric_limits<uint16_t>::max();
+
+        meshData.indexSize = useShortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+        // Every mesh starts at a 4 byte boundary, so both index sizes are naturally aligned.
+        indexData.resize((indexData.size() + 3u) & ~size_t{3u});
+        meshData.indexByteOffset = static_cast<uint32_t>(indexData.size());
+
+        // The full resolution indices come first, followed by the indices of every coarser LOD.
+        const auto appendIndices = [&](std::span<const uint32_t> lodIndices, const float error)
+        {
+            lods.emplace_back(MeshLodData{
+                .firstIndex = meshData.totalIndexCount,
+                .indexCount = static_cast<uint32_t>(lodIndices.size()),
+                .error = error,
+            });
+
+            meshData.totalIndexCount += static_cast<uint32_t>(lodIndices.size());
+
+            if (useShortIndices)
+            {
+                std::vector<uint16_t> shortIndices(lodIndices.size());
+                std::ranges::transform(lodIndices, shortIndices.begin(), [](const uint32_t index) { return static_cast<uint16_t>(index); });
+
+                const std::span<const std::byte> shortIndexBytes = std::as_bytes(std::span(shortIndices));
+                indexData.insert(indexData.end(), shortIndexBytes.begin(), shortIndexBytes.end());
+            }
+            else
+            {
+                const std::span<const std::byte> indexBytes = std::as_bytes(lodIndices);
+                indexData.insert(indexData.end(), indexBytes.begin(), indexBytes.end());
+            }
+        };
+
+        appendIndices(primitive.indices, 0.0f);
+
+        for (const PrimitiveLodData& lod : primitive.lods)
+        {
+            appendIndices(lod.indices, lod.error);
+        }
+
+        meshes.emplace_back(meshData);
+    }
+
+    ModelData ModelDataStorage::getView() const
+    {
+        ModelData modelData = {
+            .vertices = vertices,
+            .indexData = indexData,
+            .meshes = meshes,
+            .meshlets = meshlets,
+            .lods = lods,
+            .materials = materials,
+            .samplers = samplers,
+            .nodes = nodes,
+        };
+
+        modelData.imagePaths.reserve(imagePaths.size());
+        for (const auto& imagePath : imagePaths)
+        {
+            modelData.imagePaths.emplace_back(imagePath);
+        }
+
+        return modelData;
+    }
+
+    ModelCache::~ModelCache() { close(); }
+
+    uint64_t ModelCache::getSourceFilesKey(const std::string_view modelPath)
+    {
+        const auto hashFile = [](const uint64_t hash, const std::filesystem::path& path)
+        {
+            std::error_code errorCode{};
+            const uint64_t fileSize = std::filesystem::file_size(path, errorCode);
+            const auto lastWriteTime = std::filesystem::last_write_time(path, errorCode);
+
+            const std::string pathString = path.generic_string();
+
+            uint64_t fileHash = hashCombine(hash, hashBytes(std::as_bytes(std::span(pathString))));
+            fileHash = hashCombine(fileHash, fileSize);
+            return hashCombine(fileHash, static_cast<uint64_t>(lastWriteTime.time_since_epoch().count()));
+        };
+
+        const std::filesystem::path sourcePath(modelPath);
+
+        uint64_t hash = hashFile(0u, sourcePath);
+
+        // The glTF buffers may change without the .gltf file changing, so they are part of the key as well.
+        // Iteration order of a directory is unspecified, hence the sort.
+        std::vector<std::filesystem::path> bufferPaths{};
+        if (sourcePath.has_parent_path())
+        {
+            for (const auto& entry : std::filesystem::directory_iterator(sourcePath.parent_path()))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".bin")
+                {
+                    bufferPaths.emplace_back(entry.path());
+                }
+            }
+        }
+
+        std::ranges::sort(bufferPaths);
+
+        for (const auto& bufferPath : bufferPaths)
+        {
+            hash = hashFile(hash, bufferPath);
+        }
+
+        return hash;
+    }
+
+    std::string ModelCache::getCachePath(const std::string_view modelPath) { return std::string(modelPath) + ".sgfxcache"; }
+
+    void ModelCache::write(const std::string_view cachePath, const uint64_t cacheKey, const ModelData& modelData)
+    {
+        std::string imagePaths{};
+        for (const auto& imagePath : modelData.imagePaths)
+        {
+            imagePaths.append(imagePath);
+            imagePaths.push_back('\0');
+        }
+
+        const std::array<std::span<const std::byte>, enumClassValue(ModelCacheSectionType::Count)> sectionData = {
+            std::as_bytes(modelData.vertices),
+            modelData.indexData,
+            std::as_bytes(modelData.meshes),
+            std::as_bytes(modelData.materials),
+            std::as_bytes(modelData.samplers),
+            std::as_bytes(std::span(imagePaths)),
+            std::as_bytes(modelData.meshlets),
+            std::as_bytes(modelData.lods),
+            std::as_bytes(modelData.nodes),
+        };
+
+        ModelCacheHeader header{.cacheKey = cacheKey};
+
+        uint64_t offset = MODEL_CACHE_SECTION_ALIGNMENT;
+        for (const size_t i : std::views::iota(0u, sectionData.size()))
+        {
+            header.sections[i] = ModelCacheSection{
+                .offset = offset,
+                .size = sectionData[i].size(),
+            };
+
+            offset = (offset + sectionData[i].size() + MODEL_CACHE_SECTION_ALIGNMENT - 1u) & ~(MODEL_CACHE_SECTION_ALIGNMENT - 1u);
+        }
+
+        // Multiple models may cook the same file concurrently, so each writes to a unique temporary file that is then renamed.
+        const std::filesystem::path finalPath(cachePath);
+        const std::filesystem::path temporaryPath = finalPath.string() + std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cout << "Failed to create model cache file : " << temporaryPath.string() << '\n';
+                return;
+            }
+
+            const std::array<char, MODEL_CACHE_SECTION_ALIGNMENT> padding{};
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(ModelCacheHeader));
+            file.write(padding.data(), MODEL_CACHE_SECTION_ALIGNMENT - sizeof(ModelCacheHeader));
+
+            for (const size_t i : std::views::iota(0u, sectionData.size()))
+            {
+                file.write(reinterpret_cast<const char*>(sectionData[i].data()), static_cast<std::streamsize>(sectionData[i].size()));
+
+                const uint64_t sectionEnd = header.sections[i].offset + header.sections[i].size;
+                const uint64_t nextSectionOffset = i + 1u < sectionData.size() ? header.sections[i + 1u].offset : sectionEnd;
+                file.write(padding.data(), static_cast<std::streamsize>(nextSectionOffset - sectionEnd));
+            }
+        }
+
+        // On Windows, renaming fails if another model has the file mapped at the moment, in which case the existing (identical) file is kept.
+        std::error_code errorCode{};
+        std::filesystem::rename(temporaryPath, finalPath, errorCode);
+        if (errorCode)
+        {
+            std::filesystem::remove(temporaryPath, errorCode);
+        }
+    }
+
+    bool ModelCache::open(const std::string_view cachePath, const uint64_t cacheKey)
+    {
+        close();
+
+#ifdef _WIN32
+        const std::wstring widePath = stringToWString(cachePath);
+
+        m_file = ::CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!::GetFileSizeEx(m_file, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) < sizeof(ModelCacheHeader))
+        {
+            close();
+            return false;
+        }
+
+        m_fileMapping = ::CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_fileMapping)
+        {
+            close();
+            return false;
+        }
+
+        m_mappedData = static_cast<const std::byte*>(::MapViewOfFile(m_fileMapping, FILE_MAP_READ, 0u, 0u, 0u));
+        if (!m_mappedData)
+        {
+            close();
+            return false;
+        }
+
+        m_mappedSize = static_cast<uint64_t>(fileSize.QuadPart);
+#else
+        m_file = ::open(std::string(cachePath).c_str(), O_RDONLY);
+        if (m_file < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStatus{};
+        if (::fstat(m_file, &fileStatus) != 0 || static_cast<uint64_t>(fileStatus.st_size) < sizeof(ModelCacheHeader))
+        {
+            close();
+            return false;
+        }
+
+        void* const mappedData = ::mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+        if (mappedData == MAP_FAILED)
+        {
+            close();
+            return false;
+        }
+
+        // The sections are read front to back once, when they are uploaded.
+        ::madvise(mappedData, static_cast<size_t>(fileStatus.st_size), MADV_SEQUENTIAL);
+
+        m_mappedData = static_cast<const std::byte*>(mappedData);
+        m_mappedSize = static_cast<uint64_t>(fileStatus.st_size);
+#endif
+
+        ModelCacheHeader header{};
+        std::memcpy(&header, m_mappedData, sizeof(ModelCacheHeader));
+
+        if (header.magic != MODEL_CACHE_MAGIC || header.version != MODEL_CACHE_VERSION || header.cacheKey != cacheKey)
+        {
+            close();
+            return false;
+        }
+
+        for (const auto& section : header.sections)
+        {
+            if (section.offset + section.size > m_mappedSize)
+            {
+                close();
+                return false;
+            }
+        }
+
+        const auto& sections = header.sections;
+
+        m_data = ModelData{
+            .vertices = getSection<ModelVertex>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::Vertices)]),
+            .indexData = getSection<std::byte>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::IndexData)]),
+            .meshes = getSection<MeshData>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::Meshes)]),
+            .meshlets = getSection<MeshletData>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::Meshlets)]),
+            .lods = getSection<MeshLodData>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::Lods)]),
+            .materials = getSection<MaterialData>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::Materials)]),
+            .samplers = getSection<SamplerData>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::Samplers)]),
+            .nodes = getSection<NodeData>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::Nodes)]),
+        };
+
+        // Image paths are stored as consecutive null terminated strings.
+        const std::span<const char> imagePaths = getSection<char>(m_mappedData, sections[enumClassValue(ModelCacheSectionType::ImagePaths)]);
+
+        size_t pathStart = 0u;
+        for (const size_t i : std::views::iota(0u, imagePaths.size()))
+        {
+            if (imagePaths[i] == '\0')
+            {
+                m_data.imagePaths.emplace_back(imagePaths.data() + pathStart, i - pathStart);
+                pathStart = i + 1u;
+            }
+        }
+
+        return true;
+    }
+
+    void ModelCache::close()
+    {
+#ifdef _WIN32
+        if (m_mappedData)
+        {
+            ::UnmapViewOfFile(m_mappedData);
+            m_mappedData = nullptr;
+        }
+
+        if (m_fileMapping)
+        {
+            ::CloseHandle(m_fileMapping);
+            m_fileMapping = nullptr;
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            ::CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (m_mappedData)
+        {
+            ::munmap(const_cast<std::byte*>(m_mappedData), static_cast<size_t>(m_mappedSize));
+            m_mappedData = nullptr;
+        }
+
+        if (m_file >= 0)
+        {
+            ::close(m_file);
+            m_file = -1;
+        }
+#endif
+
+        m_mappedSize = 0u;
+        m_data = {};
+    }
+}
@@ -0,0 +1,370 @@
+#include "Pch.hpp"
+
+#include "NullRenderBackend.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        void validate(const bool condition, const std::string_view message, const uint64_t commandIndex)
+        {
+            if (!condition)
+            {
+                fatalError(std::format("Null render backend : {} (command {}).", message, commandIndex));
+            }
+        }
+
+        void validate(const bool condition, const std::string_view message)
+        {
+            if (!condition)
+            {
+                fatalError(std::format("Null render backend : {}.", message));
+            }
+        }
+    }
+
+    NullRenderBackend::NullRenderBackend()
+    {
+        // Never shown, so its size does not matter.
+        m_backBuffer = addResource(Resource{.type = ResourceType::RenderTarget});
+    }
+
+    BackendHandle NullRenderBackend::createBuffer(const BackendBufferDesc& bufferDesc, std::span<const std::byte> data)
+    {
+        validate(bufferDesc.size != 0u, "empty buffer");
+        validate(data.empty() || data.size() == bufferDesc.size, "buffer data size differs from the buffer size");
+        validate(bufferDesc.type != BufferType::Constant || bufferDesc.size % 16u == 0u, "constant buffer size is not a multiple of 16 bytes");
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.bufferCount++;
+        m_stats.bufferBytes += bufferDesc.size;
+
+        return addResource(Resource{.type = ResourceType::Buffer, .bufferType = bufferDesc.type, .size = bufferDesc.size});
+    }
+
+    BackendHandle NullRenderBackend::createTexture(const BackendTextureDesc& textureDesc, std::span<const std::byte> data)
+    {
+        validate(textureDesc.width != 0u && textureDesc.height != 0u && textureDesc.mipCount != 0u, "empty texture");
+        validate(textureDesc.format != TextureFormat::D32Float, "depth texture created as a sampled texture");
+        validate(textureDesc.mipCount <= std::bit_width(std::max(textureDesc.width, textureDesc.height)), "more mips than the texture has");
+
+        validate(!isBlockCompressed(textureDesc.format) || (textureDesc.width % 4u == 0u && textureDesc.height % 4u == 0u), "block compressed texture is not made of whole blocks");
+
+        uint64_t textureSize = 0u;
+        for (const uint32_t mip : std::views::iota(0u, textureDesc.mipCount))
+        {
+            textureSize += getMipSize(textureDesc.format, std::max(textureDesc.width >> mip, 1u), std::max(textureDesc.height >> mip, 1u));
+        }
+
+        validate(data.size() == textureSize, "texture data size differs from the size of its mips");
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.textureCount++;
+        m_stats.textureBytes += textureSize;
+
+        return addResource(Resource{.type = ResourceType::Texture, .size = textureSize});
+    }
+
+    BackendRenderTargetHandles NullRenderBackend::createRenderTarget(const BackendRenderTargetDesc& renderTargetDesc)
+    {
+        validate(renderTargetDesc.width != 0u && renderTargetDesc.height != 0u, "empty render target");
+        validate(!isBlockCompressed(renderTargetDesc.format), "block compressed render target");
+
+        const uint64_t renderTargetSize = getMipSize(renderTargetDesc.format, renderTargetDesc.width, renderTargetDesc.height);
+        const ResourceType type = renderTargetDesc.format == TextureFormat::D32Float ? ResourceType::DepthStencil : ResourceType::RenderTarget;
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.renderTargetCount++;
+        m_stats.renderTargetBytes += renderTargetSize;
+
+        return BackendRenderTargetHandles{
+            .renderTarget = addResource(Resource{.type = type, .size = renderTargetSize}),
+            .texture = addResource(Resource{.type = ResourceType::Texture, .isRenderTargetTexture = true}),
+        };
+    }
+
+    BackendHandle NullRenderBackend::createSampler(const BackendSamplerDesc&)
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.samplerCount++;
+
+        return addResource(Resource{.type = ResourceType::Sampler});
+    }
+
+    BackendHandle NullRenderBackend::createGraphicsPipeline(const BackendPipelineDesc& pipelineDesc)
+    {
+        validate(!pipelineDesc.vertexShaderPath.empty() && !pipelineDesc.pixelShaderPath.empty(), "pipeline without shaders");
+
+        uint32_t attributesSize = 0u;
+        for (const VertexAttribute& attribute : pipelineDesc.vertexAttributes)
+        {
+            validate(!attribute.semanticName.empty(), "vertex attribute without semantic name");
+            attributesSize += getVertexAttributeSize(attribute.format);
+        }
+
+        validate(attributesSize == pipelineDesc.vertexSize, "vertex attribute sizes do not add up to the vertex size");
+
+        const std::scoped_lock lock(m_mutex);
+
+        m_stats.pipelineCount++;
+
+        return addResource(Resource{.type = ResourceType::Pipeline, .vertexSize = pipelineDesc.vertexSize});
+    }
+
+    void NullRenderBackend::releaseResource(const BackendHandle handle)
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        const auto resource = m_resources.find(handle);
+        validate(resource != m_resources.end() && handle != m_backBuffer, "release of a resource the backend did not create, or released twice");
+
+        switch (resource->second->type)
+        {
+            case ResourceType::Buffer:
+                m_stats.bufferCount--;
+                m_stats.bufferBytes -= resource->second->size;
+                break;
+            case ResourceType::Texture:
+                // Render target textures are counted with their render target.
+                if (!resource->second->isRenderTargetTexture)
+                {
+                    m_stats.textureCount--;
+                    m_stats.textureBytes -= resource->second->size;
+                }
+                break;
+            case ResourceType::RenderTarget:
+            case ResourceType::DepthStencil:
+                m_stats.renderTargetCount--;
+                m_stats.renderTargetBytes -= resource->second->size;
+                break;
+            case ResourceType::Sampler: m_stats.samplerCount--; break;
+            case ResourceType::Pipeline: m_stats.pipelineCount--; break;
+        }
+
+        m_resources.erase(resource);
+    }
+
+    void NullRenderBackend::updateBuffer(const BackendHandle buffer, std::span<const std::byte> data, const uint32_t offset)
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        const Resource* const resource = findResource(buffer);
+        validate(resource && resource->type == ResourceType::Buffer, "update of something else than a buffer of the backend");
+        validate(!data.empty() && offset + data.size() <= resource->size, "update out of the buffer");
+        validate(resource->bufferType != BufferType::Constant || (offset == 0u && data.size() == resource->size), "partial constant buffer update");
+    }
+
+    void NullRenderBackend::submit(std::span<const CommandList> commandLists)
+    {
+        // Held for the whole submission, so resources released by other threads meanwhile cannot be mistaken for foreign handles.
+        const std::scoped_lock lock(m_mutex);
+
+        for (const CommandList& commandList : commandLists)
+        {
+            validateCommandList(commandList);
+        }
+    }
+
+    RenderBackendStats NullRenderBackend::getStats() const
+    {
+        const std::scoped_lock lock(m_mutex);
+
+        return m_stats;
+    }
+
+    void NullRenderBackend::validateCommandList(const CommandList& commandList)
+    {
+        // What the list bound so far. Handles the backend did not create are bound with a null resource.
+        bool isPipelineBound = false;
+        const Resource* pipeline{};
+
+        bool isRenderTargetBound = false;
+        bool isViewportBound = false;
+
+        bool isVertexBufferBound = false;
+        uint32_t vertexStride = 0u;
+
+        bool isIndexBufferBound = false;
+        const Resource* indexBuffer{};
+        uint32_t indexSize = 0u;
+
+        uint64_t commandIndex = 0u;
+
+        const auto validateResource = [&](const BackendHandle handle, const ResourceType type, const std::string_view name)
+        {
+            // The message is only formatted on failure, this being on the path of every command.
+            if (!handle)
+            {
+                fatalError(std::format("Null render backend : null {} (command {}).", name, commandIndex));
+            }
+
+            const Resource* const resource = findResource(handle);
+            if (resource && resource->type != type)
+            {
+                fatalError(std::format("Null render backend : {} handle of another kind of resource (command {}).", name, commandIndex));
+            }
+
+            return resource;
+        };
+
+        const auto validateDraw = [&]()
+        {
+            validate(isPipelineBound, "draw without a pipeline", commandIndex);
+            validate(isRenderTargetBound, "draw without render targets", commandIndex);
+            validate(isViewportBound, "draw without a viewport", commandIndex);
+        };
+
+        const auto validateIndexedDraw = [&](const uint32_t indexCount, const uint32_t firstIndex)
+        {
+            validateDraw();
+
+            validate(isVertexBufferBound && isIndexBufferBound, "indexed draw without vertex and index buffers", commandIndex);
+            validate(!pipeline || pipeline->vertexSize == vertexStride, "vertex buffer stride differs from the pipeline's vertex size", commandIndex);
+            validate(!indexBuffer || uint64_t{firstIndex} + indexCount <= indexBuffer->size / indexSize, "indices out of the index buffer", commandIndex);
+        };
+
+        commandList.forEach(
+            [&]<typename T>(const T& command)
+            {
+                if constexpr (std::is_same_v<T, SetPipelineCommand>)
+                {
+                    pipeline = validateResource(command.pipeline, ResourceType::Pipeline, "pipeline");
+                    isPipelineBound = true;
+
+                    m_stats.pipelineBindCount++;
+                }
+                else if constexpr (std::is_same_v<T, SetRenderTargetsCommand>)
+                {
+                    validate(command.renderTargetCount <= MAX_RENDER_TARGET_COUNT, "too many render targets", commandIndex);
+                    validate(command.renderTargetCount != 0u || command.depthStencil, "no render target nor depth stencil", commandIndex);
+
+                    for (const uint32_t i : std::views::iota(0u, command.renderTargetCount))
+                    {
+                        validateResource(command.renderTargets[i], ResourceType::RenderTarget, "render target");
+                    }
+
+                    if (command.depthStencil)
+                    {
+                        validateResource(command.depthStencil, ResourceType::DepthStencil, "depth stencil");
+                    }
+
+                    isRenderTargetBound = true;
+                }
+                else if constexpr (std::is_same_v<T, ClearRenderTargetCommand>)
+                {
+                    validateResource(command.renderTarget, ResourceType::RenderTarget, "render target");
+                }
+                else if constexpr (std::is_same_v<T, ClearDepthStencilCommand>)
+                {
+                    validateResource(command.depthStencil, ResourceType::DepthStencil, "depth stencil");
+                    validate(command.depth >= 0.0f && command.depth <= 1.0f, "depth clear value out of [0, 1]", commandIndex);
+                }
+                else if constexpr (std::is_same_v<T, SetViewportCommand>)
+                {
+                    validate(command.width > 0.0f && command.height > 0.0f, "empty viewport", commandIndex);
+                    validate(command.minimumDepth >= 0.0f && command.minimumDepth <= command.maximumDepth && command.maximumDepth <= 1.0f, "invalid viewport depth range", commandIndex);
+
+                    isViewportBound = true;
+                }
+                else if constexpr (std::is_same_v<T, SetVertexBufferCommand>)
+                {
+                    const Resource* const buffer = validateResource(command.buffer, ResourceType::Buffer, "vertex buffer");
+                    validate(!buffer || buffer->bufferType == BufferType::Vertex, "vertex buffer is not one", commandIndex);
+                    validate(command.stride != 0u, "zero vertex stride", commandIndex);
+
+                    isVertexBufferBound = true;
+                    vertexStride = command.stride;
+
+                    m_stats.bufferBindCount++;
+                }
+                else if constexpr (std::is_same_v<T, SetIndexBufferCommand>)
+                {
+                    indexBuffer = validateResource(command.buffer, ResourceType::Buffer, "index buffer");
+                    validate(!indexBuffer || indexBuffer->bufferType == BufferType::Index, "index buffer is not one", commandIndex);
+                    validate(command.indexSize == 2u || command.indexSize == 4u, "index size is neither 2 nor 4 bytes", commandIndex);
+
+                    isIndexBufferBound = true;
+                    indexSize = command.indexSize;
+
+                    m_stats.bufferBindCount++;
+                }
+                else if constexpr (std::is_same_v<T, SetConstantBufferCommand>)
+                {
+                    const Resource* const buffer = validateResource(command.buffer, ResourceType::Buffer, "constant buffer");
+                    validate(!buffer || buffer->bufferType == BufferType::Constant, "constant buffer is not one", commandIndex);
+                    validate(command.slot < MAX_CONSTANT_BUFFER_SLOT_COUNT, "constant buffer slot out of range", commandIndex);
+
+                    m_stats.bufferBindCount++;
+                }
+                else if constexpr (std::is_same_v<T, SetShaderResourceCommand>)
+                {
+                    // Null unbinds the slot.
+                    if (command.resource)
+                    {
+                        validateResource(command.resource, ResourceType::Texture, "shader resource");
+                    }
+
+                    validate(command.slot < MAX_SHADER_RESOURCE_SLOT_COUNT, "shader resource slot out of range", commandIndex);
+
+                    m_stats.textureBindCount++;
+                }
+                else if constexpr (std::is_same_v<T, SetSamplerCommand>)
+                {
+                    validateResource(command.sampler, ResourceType::Sampler, "sampler");
+                    validate(command.slot < MAX_SAMPLER_SLOT_COUNT, "sampler slot out of range", commandIndex);
+
+                    m_stats.samplerBindCount++;
+                }
+                else if constexpr (std::is_same_v<T, DrawCommand>)
+                {
+                    validateDraw();
+                    validate(command.vertexCount != 0u, "draw of no vertices", commandIndex);
+
+                    m_stats.drawCount++;
+                    m_stats.vertexCount += command.vertexCount;
+                }
+                else if constexpr (std::is_same_v<T, DrawIndexedCommand>)
+                {
+                    validateIndexedDraw(command.indexCount, command.firstIndex);
+                    validate(command.indexCount != 0u, "draw of no indices", commandIndex);
+
+                    m_stats.drawCount++;
+                    m_stats.indexCount += command.indexCount;
+                }
+                else if constexpr (std::is_same_v<T, DrawIndexedInstancedCommand>)
+                {
+                    validateIndexedDraw(command.indexCount, command.firstIndex);
+                    validate(command.indexCount != 0u && command.instanceCount != 0u, "draw of no indices or instances", commandIndex);
+
+                    m_stats.drawCount++;
+                    m_stats.indexCount += uint64_t{command.indexCount} * command.instanceCount;
+                }
+
+                commandIndex++;
+            });
+
+        m_stats.submittedCommandListCount++;
+        m_stats.commandCount += commandIndex;
+    }
+
+    BackendHandle NullRenderBackend::addResource(const Resource& resource)
+    {
+        std::unique_ptr<Resource> ownedResource = std::make_unique<Resource>(resource);
+        const BackendHandle handle = ownedResource.get();
+
+        m_resources.emplace(handle, std::move(ownedResource));
+
+        return handle;
+    }
+
+    const NullRenderBackend::Resource* NullRenderBackend::findResource(const BackendHandle handle) const
+    {
+        const auto resource = m_resources.find(handle);
+
+        return resource == m_resources.end() ? nullptr : resource->second.get();
+    }
+}
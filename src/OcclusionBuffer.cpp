@@ -0,0 +1,493 @@
+#include "Pch.hpp"
+
+#include "OcclusionBuffer.hpp"
+
+#include "CpuFeatures.hpp"
+#include "JobSystem.hpp"
+
+#include <immintrin.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        struct ScreenVertex
+        {
+            float x{};
+            float y{};
+            float z{};
+
+            // Clip space z below 0 (D3D's near plane).
+            bool isInFrontOfNearPlane{};
+        };
+
+        // Pixels [minimumX, maximumX] x [minimumY, maximumY] of the triangle, 4 per iteration. minimumX is rounded down to a multiple of 4, the
+        // extra pixels being outside the triangle's bounds and so outside the triangle.
+        void rasterizeTriangleSse2(const float* const edgeX,
+                                   const float* const edgeY,
+                                   const float* const edgeOffset,
+                                   const std::array<float, 4>& depthPlane,
+                                   float* const depths,
+                                   const uint32_t rowPitch,
+                                   const uint32_t minimumX,
+                                   const uint32_t minimumY,
+                                   const uint32_t maximumX,
+                                   const uint32_t maximumY)
+        {
+            const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 maximumDepth = _mm_set1_ps(depthPlane[3]);
+
+            for (uint32_t y = minimumY; y <= maximumY; y++)
+            {
+                const float centerY = static_cast<float>(y) + 0.5f;
+
+                __m128 rowEdges[3]{};
+                for (const uint32_t edge : std::views::iota(0u, 3u))
+                {
+                    rowEdges[edge] = _mm_set1_ps(edgeY[edge] * centerY + edgeOffset[edge]);
+                }
+
+                const __m128 rowDepth = _mm_set1_ps(depthPlane[1] * centerY + depthPlane[2]);
+
+                float* const row = depths + static_cast<size_t>(y) * rowPitch;
+
+                for (uint32_t x = minimumX & ~3u; x <= maximumX; x += 4u)
+                {
+                    const __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+                    __m128 isInside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeX[0]), centerX), rowEdges[0]), _mm_setzero_ps());
+                    isInside = _mm_and_ps(isInside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeX[1]), centerX), rowEdges[1]), _mm_setzero_ps()));
+                    isInside = _mm_and_ps(isInside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeX[2]), centerX), rowEdges[2]), _mm_setzero_ps()));
+
+                    if (_mm_movemask_ps(isInside) == 0)
+                    {
+                        continue;
+                    }
+
+                    const __m128 depth = _mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(depthPlane[0]), centerX), rowDepth), maximumDepth);
+
+                    const __m128 previousDepth = _mm_loadu_ps(row + x);
+                    const __m128 coveredDepth = _mm_or_ps(_mm_and_ps(isInside, depth), _mm_andnot_ps(isInside, previousDepth));
+
+                    _mm_storeu_ps(row + x, _mm_min_ps(previousDepth, coveredDepth));
+                }
+            }
+        }
+
+        SGFX_TARGET_AVX2 void rasterizeTriangleAvx2(const float* const edgeX,
+                                                    const float* const edgeY,
+                                                    const float* const edgeOffset,
+                                                    const std::array<float, 4>& depthPlane,
+                                                    float* const depths,
+                                                    const uint32_t rowPitch,
+                                                    const uint32_t minimumX,
+                                                    const uint32_t minimumY,
+                                                    const uint32_t maximumX,
+                                                    const uint32_t maximumY)
+        {
+            const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+            const __m256 maximumDepth = _mm256_set1_ps(depthPlane[3]);
+
+            for (uint32_t y = minimumY; y <= maximumY; y++)
+            {
+                const float centerY = static_cast<float>(y) + 0.5f;
+
+                __m256 rowEdges[3]{};
+                for (const uint32_t edge : std::views::iota(0u, 3u))
+                {
+                    rowEdges[edge] = _mm256_set1_ps(edgeY[edge] * centerY + edgeOffset[edge]);
+                }
+
+                const __m256 rowDepth = _mm256_set1_ps(depthPlane[1] * centerY + depthPlane[2]);
+
+                float* const row = depths + static_cast<size_t>(y) * rowPitch;
+
+                for (uint32_t x = minimumX & ~7u; x <= maximumX; x += 8u)
+                {
+                    const __m256 centerX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+
+                    __m256 isInside = _mm256_cmp_ps(_mm256_fmadd_ps(_mm256_set1_ps(edgeX[0]), centerX, rowEdges[0]), _mm256_setzero_ps(), _CMP_GE_OQ);
+                    isInside = _mm256_and_ps(isInside, _mm256_cmp_ps(_mm256_fmadd_ps(_mm256_set1_ps(edgeX[1]), centerX, rowEdges[1]), _mm256_setzero_ps(), _CMP_GE_OQ));
+                    isInside = _mm256_and_ps(isInside, _mm256_cmp_ps(_mm256_fmadd_ps(_mm256_set1_ps(edgeX[2]), centerX, rowEdges[2]), _mm256_setzero_ps(), _CMP_GE_OQ));
+
+                    if (_mm256_movemask_ps(isInside) == 0)
+                    {
+                        continue;
+                    }
+
+                    const __m256 depth = _mm256_min_ps(_mm256_fmadd_ps(_mm256_set1_ps(depthPlane[0]), centerX, rowDepth), maximumDepth);
+
+                    const __m256 previousDepth = _mm256_loadu_ps(row + x);
+                    _mm256_storeu_ps(row + x, _mm256_min_ps(previousDepth, _mm256_blendv_ps(previousDepth, depth, isInside)));
+                }
+            }
+        }
+
+        // True if any pixel of [minimumX, maximumX] x [minimumY, maximumY] is not in front of depth. Reads whole blocks rows, masking the columns
+        // outside the rectangle, and skips the blocks whose farthest depth is in front of depth.
+        bool isRectangleVisibleSse2(std::span<const float> depths,
+                                    std::span<const float> blockMaximumDepths,
+                                    const uint32_t rowPitch,
+                                    const uint32_t minimumX,
+                                    const uint32_t minimumY,
+                                    const uint32_t maximumX,
+                                    const uint32_t maximumY,
+                                    const float depth)
+        {
+            constexpr uint32_t BLOCK_SIZE = OcclusionBuffer::BLOCK_SIZE;
+
+            const uint32_t blockCountX = rowPitch / BLOCK_SIZE;
+            const __m128 boxDepth = _mm_set1_ps(depth);
+
+            for (uint32_t blockY = minimumY / BLOCK_SIZE; blockY <= maximumY / BLOCK_SIZE; blockY++)
+            {
+                for (uint32_t blockX = minimumX / BLOCK_SIZE; blockX <= maximumX / BLOCK_SIZE; blockX++)
+                {
+                    if (depth > blockMaximumDepths[blockY * blockCountX + blockX])
+                    {
+                        continue;
+                    }
+
+                    const uint32_t firstColumn = blockX * BLOCK_SIZE;
+                    const __m128i columns = _mm_setr_epi32(0, 1, 2, 3);
+                    const __m128i rectangleStart = _mm_set1_epi32(static_cast<int32_t>(minimumX) - static_cast<int32_t>(firstColumn) - 1);
+                    const __m128i rectangleEnd = _mm_set1_epi32(static_cast<int32_t>(maximumX) - static_cast<int32_t>(firstColumn) + 1);
+
+                    const __m128 isLowColumnInRectangle = _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(columns, rectangleStart), _mm_cmplt_epi32(columns, rectangleEnd)));
+
+                    const __m128i highColumns = _mm_add_epi32(columns, _mm_set1_epi32(4));
+                    const __m128 isHighColumnInRectangle =
+                        _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(highColumns, rectangleStart), _mm_cmplt_epi32(highColumns, rectangleEnd)));
+
+                    const uint32_t firstRow = std::max(minimumY, blockY * BLOCK_SIZE);
+                    const uint32_t lastRow = std::min(maximumY, blockY * BLOCK_SIZE + BLOCK_SIZE - 1u);
+
+                    for (uint32_t y = firstRow; y <= lastRow; y++)
+                    {
+                        const float* const row = depths.data() + static_cast<size_t>(y) * rowPitch + firstColumn;
+
+                        const __m128 isLowVisible = _mm_and_ps(isLowColumnInRectangle, _mm_cmple_ps(boxDepth, _mm_loadu_ps(row)));
+                        const __m128 isHighVisible = _mm_and_ps(isHighColumnInRectangle, _mm_cmple_ps(boxDepth, _mm_loadu_ps(row + 4u)));
+
+                        if (_mm_movemask_ps(_mm_or_ps(isLowVisible, isHighVisible)) != 0)
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        SGFX_TARGET_AVX2 bool isRectangleVisibleAvx2(std::span<const float> depths,
+                                                     std::span<const float> blockMaximumDepths,
+                                                     const uint32_t rowPitch,
+                                                     const uint32_t minimumX,
+                                                     const uint32_t minimumY,
+                                                     const uint32_t maximumX,
+                                                     const uint32_t maximumY,
+                                                     const float depth)
+        {
+            constexpr uint32_t BLOCK_SIZE = OcclusionBuffer::BLOCK_SIZE;
+
+            const uint32_t blockCountX = rowPitch / BLOCK_SIZE;
+            const __m256 boxDepth = _mm256_set1_ps(depth);
+
+            for (uint32_t blockY = minimumY / BLOCK_SIZE; blockY <= maximumY / BLOCK_SIZE; blockY++)
+            {
+                for (uint32_t blockX = minimumX / BLOCK_SIZE; blockX <= maximumX / BLOCK_SIZE; blockX++)
+                {
+                    if (depth > blockMaximumDepths[blockY * blockCountX + blockX])
+                    {
+                        continue;
+                    }
+
+                    const uint32_t firstColumn = blockX * BLOCK_SIZE;
+                    const __m256i columns = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+                    const __m256i rectangleStart = _mm256_set1_epi32(static_cast<int32_t>(minimumX) - static_cast<int32_t>(firstColumn) - 1);
+                    const __m256i rectangleEnd = _mm256_set1_epi32(static_cast<int32_t>(maximumX) - static_cast<int32_t>(firstColumn) + 1);
+
+                    const __m256 isColumnInRectangle =
+                        _mm256_castsi256_ps(_mm256_and_si256(_mm256_cmpgt_epi32(columns, rectangleStart), _mm256_cmpgt_epi32(rectangleEnd, columns)));
+
+                    const uint32_t firstRow = std::max(minimumY, blockY * BLOCK_SIZE);
+                    const uint32_t lastRow = std::min(maximumY, blockY * BLOCK_SIZE + BLOCK_SIZE - 1u);
+
+                    for (uint32_t y = firstRow; y <= lastRow; y++)
+                    {
+                        const float* const row = depths.data() + static_cast<size_t>(y) * rowPitch + firstColumn;
+                        const __m256 isVisible = _mm256_and_ps(isColumnInRectangle, _mm256_cmp_ps(boxDepth, _mm256_loadu_ps(row), _CMP_LE_OQ));
+
+                        if (_mm256_movemask_ps(isVisible) != 0)
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+
+            return false;
+        }
+    }
+
+    void OcclusionBuffer::resize(const uint32_t width, const uint32_t height)
+    {
+        m_width = width;
+        m_height = height;
+
+        m_tileCountX = (width + TILE_SIZE - 1u) / TILE_SIZE;
+        m_tileCountY = (height + TILE_SIZE - 1u) / TILE_SIZE;
+
+        m_rowPitch = m_tileCountX * TILE_SIZE;
+        m_rowCount = m_tileCountY * TILE_SIZE;
+
+        m_depths.assign(static_cast<size_t>(m_rowPitch) * m_rowCount, 1.0f);
+        m_blockMaximumDepths.assign(static_cast<size_t>(m_rowPitch / BLOCK_SIZE) * (m_rowCount / BLOCK_SIZE), 1.0f);
+
+        m_tileTriangles.resize(static_cast<size_t>(m_tileCountX) * m_tileCountY);
+    }
+
+    OcclusionRasterizationStats OcclusionBuffer::rasterize(std::span<const Occluder> occluders, const math::XMMATRIX viewProjectionMatrix, JobSystem& jobSystem)
+    {
+        m_viewProjectionMatrix = viewProjectionMatrix;
+
+        const uint32_t occluderCount = static_cast<uint32_t>(occluders.size());
+        if (m_occluderTriangles.size() < occluderCount)
+        {
+            m_occluderTriangles.resize(occluderCount);
+        }
+
+        JobCounter setupCounter{};
+        jobSystem.parallelFor(occluderCount, 1u, [&](const uint32_t i) { setupTriangles(occluders[i], viewProjectionMatrix, m_occluderTriangles[i]); }, setupCounter);
+        jobSystem.wait(setupCounter);
+
+        OcclusionRasterizationStats stats{.occluderCount = occluderCount};
+
+        m_triangles.clear();
+        for (const uint32_t i : std::views::iota(0u, occluderCount))
+        {
+            stats.triangleCount += static_cast<uint32_t>(occluders[i].indices.size() / 3u);
+            m_triangles.insert(m_triangles.end(), m_occluderTriangles[i].begin(), m_occluderTriangles[i].end());
+        }
+
+        stats.rasterizedTriangleCount = static_cast<uint32_t>(m_triangles.size());
+
+        for (std::vector<uint32_t>& tileTriangles : m_tileTriangles)
+        {
+            tileTriangles.clear();
+        }
+
+        for (const uint32_t triangleIndex : std::views::iota(0u, stats.rasterizedTriangleCount))
+        {
+            const RasterTriangle& triangle = m_triangles[triangleIndex];
+
+            for (uint32_t tileY = triangle.minimumY / TILE_SIZE; tileY <= triangle.maximumY / TILE_SIZE; tileY++)
+            {
+                for (uint32_t tileX = triangle.minimumX / TILE_SIZE; tileX <= triangle.maximumX / TILE_SIZE; tileX++)
+                {
+                    m_tileTriangles[tileY * m_tileCountX + tileX].emplace_back(triangleIndex);
+                }
+            }
+        }
+
+        // Every tile is cleared by its own job, including those without triangles.
+        JobCounter tileCounter{};
+        jobSystem.parallelFor(m_tileCountX * m_tileCountY, 1u, [&](const uint32_t tileIndex) { rasterizeTile(tileIndex); }, tileCounter);
+        jobSystem.wait(tileCounter);
+
+        return stats;
+    }
+
+    bool OcclusionBuffer::isAabbVisible(const AxisAlignedBoundingBox& bounds) const
+    {
+        float minimumX = std::numeric_limits<float>::max();
+        float minimumY = std::numeric_limits<float>::max();
+        float maximumX = std::numeric_limits<float>::lowest();
+        float maximumY = std::numeric_limits<float>::lowest();
+        float minimumDepth = std::numeric_limits<float>::max();
+
+        for (const uint32_t corner : std::views::iota(0u, 8u))
+        {
+            const math::XMVECTOR position = math::XMVectorSet((corner & 1u) ? bounds.maximum.x : bounds.minimum.x,
+                                                              (corner & 2u) ? bounds.maximum.y : bounds.minimum.y,
+                                                              (corner & 4u) ? bounds.maximum.z : bounds.minimum.z,
+                                                              1.0f);
+
+            math::XMFLOAT4 clipPosition{};
+            math::XMStoreFloat4(&clipPosition, math::XMVector4Transform(position, m_viewProjectionMatrix));
+
+            // The projected bounds of a box crossing the near plane are unbounded.
+            if (clipPosition.z < 0.0f)
+            {
+                return true;
+            }
+
+            const float x = (clipPosition.x / clipPosition.w * 0.5f + 0.5f) * m_width;
+            const float y = (0.5f - clipPosition.y / clipPosition.w * 0.5f) * m_height;
+
+            minimumX = std::min(minimumX, x);
+            minimumY = std::min(minimumY, y);
+            maximumX = std::max(maximumX, x);
+            maximumY = std::max(maximumY, y);
+            minimumDepth = std::min(minimumDepth, clipPosition.z / clipPosition.w);
+        }
+
+        // Every pixel the box overlaps, not only those whose center it covers.
+        if (maximumX < 0.0f || maximumY < 0.0f || minimumX >= static_cast<float>(m_width) || minimumY >= static_cast<float>(m_height))
+        {
+            return false;
+        }
+
+        const uint32_t firstX = static_cast<uint32_t>(std::max(minimumX, 0.0f));
+        const uint32_t firstY = static_cast<uint32_t>(std::max(minimumY, 0.0f));
+        const uint32_t lastX = static_cast<uint32_t>(std::min(maximumX, static_cast<float>(m_width - 1u)));
+        const uint32_t lastY = static_cast<uint32_t>(std::min(maximumY, static_cast<float>(m_height - 1u)));
+
+        if (getCpuFeatures().avx2)
+        {
+            return isRectangleVisibleAvx2(m_depths, m_blockMaximumDepths, m_rowPitch, firstX, firstY, lastX, lastY, minimumDepth);
+        }
+
+        return isRectangleVisibleSse2(m_depths, m_blockMaximumDepths, m_rowPitch, firstX, firstY, lastX, lastY, minimumDepth);
+    }
+
+    void OcclusionBuffer::setupTriangles(const Occluder& occluder, const math::XMMATRIX viewProjectionMatrix, std::vector<RasterTriangle>& outTriangles) const
+    {
+        outTriangles.clear();
+
+        const math::XMMATRIX modelViewProjectionMatrix = math::XMMatrixMultiply(occluder.modelMatrix, viewProjectionMatrix);
+
+        std::vector<ScreenVertex> vertices(occluder.positions.size());
+        for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(vertices.size())))
+        {
+            math::XMFLOAT4 clipPosition{};
+            math::XMStoreFloat4(&clipPosition, math::XMVector3Transform(math::XMLoadFloat3(&occluder.positions[i]), modelViewProjectionMatrix));
+
+            vertices[i] = ScreenVertex{
+                .x = (clipPosition.x / clipPosition.w * 0.5f + 0.5f) * m_width,
+                .y = (0.5f - clipPosition.y / clipPosition.w * 0.5f) * m_height,
+                .z = clipPosition.z / clipPosition.w,
+                .isInFrontOfNearPlane = clipPosition.z < 0.0f,
+            };
+        }
+
+        for (uint32_t i = 0u; i + 2u < occluder.indices.size(); i += 3u)
+        {
+            ScreenVertex v0 = vertices[occluder.indices[i]];
+            ScreenVertex v1 = vertices[occluder.indices[i + 1u]];
+            ScreenVertex v2 = vertices[occluder.indices[i + 2u]];
+
+            // Skipping an occluder triangle only makes culling less effective, so triangles crossing the near plane are not clipped.
+            if (v0.isInFrontOfNearPlane || v1.isInFrontOfNearPlane || v2.isInFrontOfNearPlane)
+            {
+                continue;
+            }
+
+            // Both faces are rasterized, so the winding is made counter clockwise (in y down screen space) to keep the edge functions positive inside.
+            float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+            if (area < 0.0f)
+            {
+                std::swap(v1, v2);
+                area = -area;
+            }
+
+            if (area <= std::numeric_limits<float>::epsilon())
+            {
+                continue;
+            }
+
+            // Pixels whose center is within the triangle's bounds.
+            const float minimumX = std::ceil(std::min({v0.x, v1.x, v2.x}) - 0.5f);
+            const float minimumY = std::ceil(std::min({v0.y, v1.y, v2.y}) - 0.5f);
+            const float maximumX = std::floor(std::max({v0.x, v1.x, v2.x}) - 0.5f);
+            const float maximumY = std::floor(std::max({v0.y, v1.y, v2.y}) - 0.5f);
+
+            if (maximumX < 0.0f || maximumY < 0.0f || minimumX >= static_cast<float>(m_width) || minimumY >= static_cast<float>(m_height) || minimumX > maximumX ||
+                minimumY > maximumY)
+            {
+                continue;
+            }
+
+            RasterTriangle triangle{
+                .minimumX = static_cast<uint32_t>(std::max(minimumX, 0.0f)),
+                .minimumY = static_cast<uint32_t>(std::max(minimumY, 0.0f)),
+                .maximumX = static_cast<uint32_t>(std::min(maximumX, static_cast<float>(m_width - 1u))),
+                .maximumY = static_cast<uint32_t>(std::min(maximumY, static_cast<float>(m_height - 1u))),
+            };
+
+            // Edge i goes from vertex i to vertex i + 1, its function is the cross product of the edge with the vector to the pixel.
+            const std::array<const ScreenVertex*, 3> corners = {&v0, &v1, &v2};
+            for (const uint32_t edge : std::views::iota(0u, 3u))
+            {
+                const ScreenVertex& start = *corners[edge];
+                const ScreenVertex& end = *corners[(edge + 1u) % 3u];
+
+                triangle.edgeX[edge] = start.y - end.y;
+                triangle.edgeY[edge] = end.x - start.x;
+                triangle.edgeOffset[edge] = -(triangle.edgeX[edge] * start.x + triangle.edgeY[edge] * start.y);
+            }
+
+            triangle.depthX = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+            triangle.depthY = ((v1.x - v0.x) * (v2.z - v0.z) - (v2.x - v0.x) * (v1.z - v0.z)) / area;
+
+            // Moves the plane to the farthest corner of every pixel, so the stored depth is never in front of the occluder within the pixel.
+            triangle.depthOffset = v0.z - triangle.depthX * v0.x - triangle.depthY * v0.y + 0.5f * (std::abs(triangle.depthX) + std::abs(triangle.depthY));
+            triangle.maximumDepth = std::max({v0.z, v1.z, v2.z});
+
+            outTriangles.emplace_back(triangle);
+        }
+    }
+
+    void OcclusionBuffer::rasterizeTile(const uint32_t tileIndex)
+    {
+        const uint32_t tileX = (tileIndex % m_tileCountX) * TILE_SIZE;
+        const uint32_t tileY = (tileIndex / m_tileCountX) * TILE_SIZE;
+
+        for (const uint32_t y : std::views::iota(tileY, tileY + TILE_SIZE))
+        {
+            std::fill_n(m_depths.begin() + static_cast<size_t>(y) * m_rowPitch + tileX, TILE_SIZE, 1.0f);
+        }
+
+        const bool isAvx2Supported = getCpuFeatures().avx2;
+
+        for (const uint32_t triangleIndex : m_tileTriangles[tileIndex])
+        {
+            const RasterTriangle& triangle = m_triangles[triangleIndex];
+
+            const uint32_t minimumX = std::max(triangle.minimumX, tileX);
+            const uint32_t minimumY = std::max(triangle.minimumY, tileY);
+            const uint32_t maximumX = std::min(triangle.maximumX, tileX + TILE_SIZE - 1u);
+            const uint32_t maximumY = std::min(triangle.maximumY, tileY + TILE_SIZE - 1u);
+
+            const std::array<float, 4> depthPlane = {triangle.depthX, triangle.depthY, triangle.depthOffset, triangle.maximumDepth};
+
+            if (isAvx2Supported)
+            {
+                rasterizeTriangleAvx2(triangle.edgeX.data(), triangle.edgeY.data(), triangle.edgeOffset.data(), depthPlane, m_depths.data(), m_rowPitch, minimumX, minimumY, maximumX, maximumY);
+            }
+            else
+            {
+                rasterizeTriangleSse2(triangle.edgeX.data(), triangle.edgeY.data(), triangle.edgeOffset.data(), depthPlane, m_depths.data(), m_rowPitch, minimumX, minimumY, maximumX, maximumY);
+            }
+        }
+
+        const uint32_t blockCountX = m_rowPitch / BLOCK_SIZE;
+
+        for (uint32_t blockY = tileY; blockY < tileY + TILE_SIZE; blockY += BLOCK_SIZE)
+        {
+            for (uint32_t blockX = tileX; blockX < tileX + TILE_SIZE; blockX += BLOCK_SIZE)
+            {
+                float maximumDepth = 0.0f;
+
+                for (const uint32_t y : std::views::iota(blockY, blockY + BLOCK_SIZE))
+                {
+                    const float* const row = m_depths.data() + static_cast<size_t>(y) * m_rowPitch + blockX;
+                    maximumDepth = std::max(maximumDepth, *std::max_element(row, row + BLOCK_SIZE));
+                }
+
+                m_blockMaximumDepths[(blockY / BLOCK_SIZE) * blockCountX + blockX / BLOCK_SIZE] = maximumDepth;
+            }
+        }
+    }
+}
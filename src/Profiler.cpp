@@ -0,0 +1,367 @@
+#include "Pch.hpp"
+
+#include "Profiler.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace sgfx
+{
+    namespace
+    {
+        thread_local const char* tlsCurrentZoneName{nullptr};
+
+        // Appends text as a JSON string, quotes included.
+        void appendJsonString(std::string& json, const std::string_view text)
+        {
+            json += '"';
+
+            for (const char c : text)
+            {
+                switch (c)
+                {
+                    case '"':
+                        json += "\\\"";
+                        break;
+
+                    case '\\':
+                        json += "\\\\";
+                        break;
+
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20u)
+                        {
+                            json += std::format("\\u{:04x}", static_cast<uint32_t>(c));
+                        }
+                        else
+                        {
+                            json += c;
+                        }
+                        break;
+                }
+            }
+
+            json += '"';
+        }
+    }
+
+    uint64_t getProfilerTimestamp()
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    size_t Profiler::ZoneKeyHash::operator()(const ZoneKey& key) const
+    {
+        return static_cast<size_t>(hashCombine(std::hash<const char*>{}(key.name), std::hash<const char*>{}(key.parentName)));
+    }
+
+    Profiler::Profiler() : m_startTimestamp(getProfilerTimestamp()), m_startTime(std::chrono::steady_clock::now()) {}
+
+    Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+    {
+        static thread_local ThreadBuffer* tlsThreadBuffer{nullptr};
+
+        if (tlsThreadBuffer == nullptr)
+        {
+            const std::lock_guard<std::mutex> lock(m_threadBufferMutex);
+
+            m_threadBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+            m_threadBuffers.back()->threadIndex = static_cast<uint32_t>(m_threadBuffers.size() - 1u);
+
+            tlsThreadBuffer = m_threadBuffers.back().get();
+        }
+
+        return *tlsThreadBuffer;
+    }
+
+    void Profiler::recordEvent(const ProfilerEvent& event)
+    {
+        ThreadBuffer& buffer = getThreadBuffer();
+
+        const uint64_t writeIndex = buffer.writeIndex.load(std::memory_order_relaxed);
+
+        // The acquire pairs with the release of drainEvents, so the slot is not overwritten while being read.
+        if (writeIndex - buffer.readIndex.load(std::memory_order_acquire) == RING_BUFFER_CAPACITY)
+        {
+            buffer.droppedEventCount.fetch_add(1u, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer.events[writeIndex % RING_BUFFER_CAPACITY] = event;
+        buffer.writeIndex.store(writeIndex + 1u, std::memory_order_release);
+    }
+
+    uint32_t Profiler::getZoneIndex(const ProfilerEvent& event)
+    {
+        const ZoneKey key = {.name = event.name, .parentName = event.parentName};
+
+        if (const auto it = m_zoneIndicesByPointer.find(key); it != m_zoneIndicesByPointer.end())
+        {
+            return it->second;
+        }
+
+        std::pair<std::string, std::string> names = {event.name, event.parentName != nullptr ? event.parentName : ""};
+
+        auto it = m_zoneIndicesByName.find(names);
+        if (it == m_zoneIndicesByName.end())
+        {
+            m_zones.emplace_back(ZoneHistory{.name = names.first, .parentName = names.second});
+            it = m_zoneIndicesByName.emplace(std::move(names), static_cast<uint32_t>(m_zones.size() - 1u)).first;
+        }
+
+        m_zoneIndicesByPointer.emplace(key, it->second);
+
+        return it->second;
+    }
+
+    void Profiler::drainEvents()
+    {
+        std::vector<ThreadBuffer*> threadBuffers{};
+
+        {
+            const std::lock_guard<std::mutex> lock(m_threadBufferMutex);
+
+            threadBuffers.reserve(m_threadBuffers.size());
+            for (const std::unique_ptr<ThreadBuffer>& threadBuffer : m_threadBuffers)
+            {
+                threadBuffers.emplace_back(threadBuffer.get());
+            }
+        }
+
+        for (ThreadBuffer* const threadBuffer : threadBuffers)
+        {
+            const uint64_t readIndex = threadBuffer->readIndex.load(std::memory_order_relaxed);
+            const uint64_t writeIndex = threadBuffer->writeIndex.load(std::memory_order_acquire);
+
+            for (uint64_t index = readIndex; index < writeIndex; index++)
+            {
+                const ProfilerEvent& event = threadBuffer->events[index % RING_BUFFER_CAPACITY];
+
+                ZoneHistory& zone = m_zones[getZoneIndex(event)];
+                zone.duration += static_cast<double>(event.endTimestamp - event.beginTimestamp);
+                zone.callCount++;
+
+                if (m_isCapturing && m_capturedEvents.size() < MAX_CAPTURED_EVENT_COUNT)
+                {
+                    m_capturedEvents.emplace_back(CapturedEvent{.event = event, .threadIndex = threadBuffer->threadIndex});
+                }
+            }
+
+            threadBuffer->readIndex.store(writeIndex, std::memory_order_release);
+        }
+    }
+
+    void Profiler::endFrame()
+    {
+        drainEvents();
+
+        const double ticksPerMillisecond = getTicksPerMicrosecond() * 1000.0;
+        const uint64_t frameSlot = m_frameIndex % ROLLING_FRAME_COUNT;
+
+        for (ZoneHistory& zone : m_zones)
+        {
+            zone.durations[frameSlot] = zone.duration / ticksPerMillisecond;
+            zone.callCounts[frameSlot] = zone.callCount;
+
+            zone.duration = 0.0;
+            zone.callCount = 0u;
+        }
+
+        m_frameIndex++;
+    }
+
+    void Profiler::beginCapture()
+    {
+        m_capturedEvents.clear();
+        m_isCapturing = true;
+    }
+
+    bool Profiler::endCapture(const std::filesystem::path& path)
+    {
+        drainEvents();
+
+        m_isCapturing = false;
+        const std::vector<CapturedEvent> capturedEvents = std::move(m_capturedEvents);
+        m_capturedEvents = {};
+
+        const double ticksPerMicrosecond = getTicksPerMicrosecond();
+        const uint32_t threadCount = getStats().threadCount;
+
+        // Complete ("X") events, nested by the viewer from their times. Timestamps are in microseconds since the profiler started.
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        json.reserve(json.size() + capturedEvents.size() * 96u);
+
+        for (const uint32_t threadIndex : std::views::iota(0u, threadCount))
+        {
+            json += std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"thread {}\"}}}},\n", threadIndex, threadIndex);
+        }
+
+        for (const CapturedEvent& capturedEvent : capturedEvents)
+        {
+            const ProfilerEvent& event = capturedEvent.event;
+
+            // Zones that began before the profiler was created have negative timestamps.
+            const double beginTime = static_cast<double>(static_cast<int64_t>(event.beginTimestamp - m_startTimestamp)) / ticksPerMicrosecond;
+            const double duration = static_cast<double>(event.endTimestamp - event.beginTimestamp) / ticksPerMicrosecond;
+
+            json += "{\"name\":";
+            appendJsonString(json, event.name);
+            json += std::format(",\"cat\":\"sgfx\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}},\n", capturedEvent.threadIndex, beginTime, duration);
+        }
+
+        // The metadata events make the list non empty, so the last separator can be replaced by the closing brackets.
+        json.resize(json.size() - 2u);
+        json += "\n]}\n";
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(json.data(), static_cast<std::streamsize>(json.size()));
+
+        return file.good();
+    }
+
+    std::vector<ProfilerZoneStats> Profiler::getZoneStats() const
+    {
+        // Bounds the tree of zones nesting themselves through other zones (e.g a job run by a thread waiting in a zone of the same name).
+        constexpr uint32_t MAX_ZONE_DEPTH = 16u;
+
+        std::unordered_map<std::string_view, std::vector<uint32_t>> childIndicesByParentName{};
+        for (const uint32_t zoneIndex : std::views::iota(0u, static_cast<uint32_t>(m_zones.size())))
+        {
+            childIndicesByParentName[m_zones[zoneIndex].parentName].emplace_back(zoneIndex);
+        }
+
+        const uint32_t frameCount = static_cast<uint32_t>(std::clamp<uint64_t>(m_frameIndex, 1u, ROLLING_FRAME_COUNT));
+
+        std::vector<ProfilerZoneStats> zoneStats{};
+        std::vector<bool> isVisited(m_zones.size(), false);
+
+        const auto appendZone = [&](const uint32_t zoneIndex, const uint32_t depth)
+        {
+            const ZoneHistory& zone = m_zones[zoneIndex];
+            isVisited[zoneIndex] = true;
+
+            ProfilerZoneStats stats = {.name = zone.name, .depth = depth};
+            for (const uint32_t frame : std::views::iota(0u, frameCount))
+            {
+                stats.averageDuration += zone.durations[frame];
+                stats.maximumDuration = std::max(stats.maximumDuration, zone.durations[frame]);
+                stats.averageCallCount += zone.callCounts[frame];
+            }
+
+            stats.averageDuration /= frameCount;
+            stats.averageCallCount /= frameCount;
+
+            zoneStats.emplace_back(stats);
+        };
+
+        // Depth first from the roots, then from the zones whose parent has not been drained yet.
+        std::vector<std::pair<uint32_t, uint32_t>> stack{};
+
+        const auto appendTree = [&](const uint32_t rootIndex)
+        {
+            stack.emplace_back(rootIndex, 0u);
+
+            while (!stack.empty())
+            {
+                const auto [zoneIndex, depth] = stack.back();
+                stack.pop_back();
+
+                appendZone(zoneIndex, depth);
+
+                const auto it = childIndicesByParentName.find(m_zones[zoneIndex].name);
+                if (it == childIndicesByParentName.end() || depth + 1u == MAX_ZONE_DEPTH)
+                {
+                    continue;
+                }
+
+                // Reversed, so children are listed in the order they were first seen.
+                for (const uint32_t childIndex : it->second | std::views::reverse)
+                {
+                    stack.emplace_back(childIndex, depth + 1u);
+                }
+            }
+        };
+
+        if (const auto it = childIndicesByParentName.find(""); it != childIndicesByParentName.end())
+        {
+            for (const uint32_t rootIndex : it->second)
+            {
+                appendTree(rootIndex);
+            }
+        }
+
+        for (const uint32_t zoneIndex : std::views::iota(0u, static_cast<uint32_t>(m_zones.size())))
+        {
+            if (!isVisited[zoneIndex])
+            {
+                appendTree(zoneIndex);
+            }
+        }
+
+        return zoneStats;
+    }
+
+    ProfilerStats Profiler::getStats() const
+    {
+        ProfilerStats stats = {
+            .capturedEventCount = m_capturedEvents.size(),
+            .isCapturing = m_isCapturing,
+            .ticksPerMicrosecond = getTicksPerMicrosecond(),
+        };
+
+        const std::lock_guard<std::mutex> lock(m_threadBufferMutex);
+
+        stats.threadCount = static_cast<uint32_t>(m_threadBuffers.size());
+        for (const std::unique_ptr<ThreadBuffer>& threadBuffer : m_threadBuffers)
+        {
+            stats.droppedEventCount += threadBuffer->droppedEventCount.load(std::memory_order_relaxed);
+        }
+
+        return stats;
+    }
+
+    double Profiler::getTicksPerMicrosecond() const
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        // Measured over the whole lifetime of the profiler, so it gets more precise as time passes.
+        const uint64_t elapsedTicks = getProfilerTimestamp() - m_startTimestamp;
+        const std::chrono::duration<double, std::micro> elapsedTime = std::chrono::steady_clock::now() - m_startTime;
+
+        return elapsedTime.count() > 0.0 ? elapsedTicks / elapsedTime.count() : 1000.0;
+#else
+        return 1000.0;
+#endif
+    }
+
+    Profiler& getProfiler()
+    {
+        static Profiler profiler{};
+        return profiler;
+    }
+
+    ProfilerScope::ProfilerScope(const char* const name) : m_name(name), m_parentName(tlsCurrentZoneName)
+    {
+        tlsCurrentZoneName = name;
+        m_beginTimestamp = getProfilerTimestamp();
+    }
+
+    ProfilerScope::~ProfilerScope()
+    {
+        const uint64_t endTimestamp = getProfilerTimestamp();
+        tlsCurrentZoneName = m_parentName;
+
+        getProfiler().recordEvent(ProfilerEvent{
+            .name = m_name,
+            .parentName = m_parentName,
+            .beginTimestamp = m_beginTimestamp,
+            .endTimestamp = endTimestamp,
+        });
+    }
+}
@@ -0,0 +1,133 @@
+#include "Pch.hpp"
+
+#include "RangeAllocator.hpp"
+
+namespace sgfx
+{
+    RangeAllocator::RangeAllocator(const uint64_t capacity) : m_capacity(capacity)
+    {
+        if (capacity != 0u)
+        {
+            insertFreeBlock(0u, capacity);
+        }
+    }
+
+    std::optional<uint64_t> RangeAllocator::allocate(const uint64_t size, const uint64_t alignment)
+    {
+        if (size == 0u)
+        {
+            return std::nullopt;
+        }
+
+        // Smallest blocks first : the first block that can fit the aligned allocation is the best fit.
+        for (auto sizeIterator = m_freeBlocksBySize.lower_bound(size); sizeIterator != m_freeBlocksBySize.end(); ++sizeIterator)
+        {
+            const uint64_t blockOffset = sizeIterator->second;
+            const uint64_t blockSize = sizeIterator->first;
+
+            const uint64_t alignedOffset = (blockOffset + alignment - 1u) / alignment * alignment;
+            const uint64_t padding = alignedOffset - blockOffset;
+
+            if (padding + size > blockSize)
+            {
+                continue;
+            }
+
+            eraseFreeBlock(m_freeBlocksByOffset.find(blockOffset));
+
+            // The alignment padding and the remainder of the block stay free.
+            if (padding != 0u)
+            {
+                insertFreeBlock(blockOffset, padding);
+            }
+
+            if (padding + size < blockSize)
+            {
+                insertFreeBlock(alignedOffset + size, blockSize - padding - size);
+            }
+
+            m_usedSize += size;
+            m_allocationCount++;
+
+            return alignedOffset;
+        }
+
+        return std::nullopt;
+    }
+
+    void RangeAllocator::free(const uint64_t offset, const uint64_t size)
+    {
+        if (size == 0u)
+        {
+            return;
+        }
+
+        // Free blocks around the range. A range overlapping either of them (or past the end) was never allocated, or is freed twice.
+        const auto nextBlock = m_freeBlocksByOffset.lower_bound(offset);
+        const auto previousBlock = nextBlock != m_freeBlocksByOffset.begin() ? std::prev(nextBlock) : m_freeBlocksByOffset.end();
+
+        const bool overlapsNextBlock = nextBlock != m_freeBlocksByOffset.end() && nextBlock->first < offset + size;
+        const bool overlapsPreviousBlock = previousBlock != m_freeBlocksByOffset.end() && previousBlock->first + previousBlock->second > offset;
+
+        if (offset + size > m_capacity || overlapsNextBlock || overlapsPreviousBlock)
+        {
+            fatalError(std::format("Range allocator : freeing [{}, {}), which is not allocated.", offset, offset + size));
+        }
+
+        uint64_t mergedOffset = offset;
+        uint64_t mergedSize = size;
+
+        // Merge with the following block.
+        if (nextBlock != m_freeBlocksByOffset.end() && nextBlock->first == offset + size)
+        {
+            mergedSize += nextBlock->second;
+            eraseFreeBlock(nextBlock);
+        }
+
+        // Merge with the preceding block.
+        if (previousBlock != m_freeBlocksByOffset.end() && previousBlock->first + previousBlock->second == offset)
+        {
+            mergedOffset = previousBlock->first;
+            mergedSize += previousBlock->second;
+            eraseFreeBlock(previousBlock);
+        }
+
+        insertFreeBlock(mergedOffset, mergedSize);
+
+        m_usedSize -= size;
+        m_allocationCount--;
+    }
+
+    RangeAllocatorStats RangeAllocator::getStats() const
+    {
+        return RangeAllocatorStats{
+            .capacity = m_capacity,
+            .usedSize = m_usedSize,
+            .freeSize = m_capacity - m_usedSize,
+            .largestFreeBlockSize = m_freeBlocksBySize.empty() ? 0u : m_freeBlocksBySize.rbegin()->first,
+            .allocationCount = m_allocationCount,
+            .freeBlockCount = static_cast<uint32_t>(m_freeBlocksByOffset.size()),
+        };
+    }
+
+    void RangeAllocator::insertFreeBlock(const uint64_t offset, const uint64_t size)
+    {
+        m_freeBlocksByOffset.emplace(offset, size);
+        m_freeBlocksBySize.emplace(size, offset);
+    }
+
+    void RangeAllocator::eraseFreeBlock(const std::map<uint64_t, uint64_t>::iterator blockIterator)
+    {
+        const auto [first, last] = m_freeBlocksBySize.equal_range(blockIterator->second);
+        for (auto sizeIterator = first; sizeIterator != last; ++sizeIterator)
+        {
+            if (sizeIterator->second == blockIterator->first)
+            {
+                m_freeBlocksBySize.erase(sizeIterator);
+                break;
+            }
+        }
+
+        m_freeBlocksByOffset.erase(blockIterator);
+    }
+}
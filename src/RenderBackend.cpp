@@ -0,0 +1,126 @@
+#include "Pch.hpp"
+
+#include "RenderBackend.hpp"
+
+namespace sgfx
+{
+    bool isBlockCompressed(const TextureFormat format)
+    {
+        switch (format)
+        {
+            case TextureFormat::BC1Unorm:
+            case TextureFormat::BC1UnormSrgb:
+            case TextureFormat::BC3Unorm:
+            case TextureFormat::BC3UnormSrgb:
+            case TextureFormat::BC4Unorm:
+            case TextureFormat::BC5Unorm:
+            case TextureFormat::BC7Unorm:
+            case TextureFormat::BC7UnormSrgb: return true;
+            default: return false;
+        }
+    }
+
+    uint32_t getTexelSize(const TextureFormat format)
+    {
+        switch (format)
+        {
+            case TextureFormat::R8Unorm: return 1u;
+            case TextureFormat::R8G8B8A8Unorm: return 4u;
+            case TextureFormat::R8G8B8A8UnormSrgb: return 4u;
+            case TextureFormat::R32G32Float: return 8u;
+            case TextureFormat::R16G16B16A16Float: return 8u;
+            case TextureFormat::R32G32B32A32Float: return 16u;
+            case TextureFormat::D32Float: return 4u;
+            case TextureFormat::BC1Unorm: return 8u;
+            case TextureFormat::BC1UnormSrgb: return 8u;
+            case TextureFormat::BC3Unorm: return 16u;
+            case TextureFormat::BC3UnormSrgb: return 16u;
+            case TextureFormat::BC4Unorm: return 8u;
+            case TextureFormat::BC5Unorm: return 16u;
+            case TextureFormat::BC7Unorm: return 16u;
+            case TextureFormat::BC7UnormSrgb: return 16u;
+        }
+
+        return 0u;
+    }
+
+    uint64_t getMipSize(const TextureFormat format, const uint32_t width, const uint32_t height)
+    {
+        if (isBlockCompressed(format))
+        {
+            return uint64_t{(width + 3u) / 4u} * ((height + 3u) / 4u) * getTexelSize(format);
+        }
+
+        return uint64_t{width} * height * getTexelSize(format);
+    }
+
+    uint32_t getVertexAttributeSize(const VertexAttributeFormat format)
+    {
+        switch (format)
+        {
+            case VertexAttributeFormat::Float2: return 8u;
+            case VertexAttributeFormat::Float3: return 12u;
+            case VertexAttributeFormat::Float4: return 16u;
+            case VertexAttributeFormat::Unorm8x4: return 4u;
+            case VertexAttributeFormat::Snorm16x2: return 4u;
+            case VertexAttributeFormat::Snorm16x4: return 8u;
+            case VertexAttributeFormat::Unorm16x2: return 4u;
+            case VertexAttributeFormat::Unorm16x4: return 8u;
+            case VertexAttributeFormat::Half2: return 4u;
+        }
+
+        return 0u;
+    }
+
+    RenderBackendStats& RenderBackendStats::operator+=(const RenderBackendStats& other)
+    {
+        bufferCount += other.bufferCount;
+        textureCount += other.textureCount;
+        renderTargetCount += other.renderTargetCount;
+        samplerCount += other.samplerCount;
+        pipelineCount += other.pipelineCount;
+        bufferBytes += other.bufferBytes;
+        textureBytes += other.textureBytes;
+        renderTargetBytes += other.renderTargetBytes;
+        submittedCommandListCount += other.submittedCommandListCount;
+        commandCount += other.commandCount;
+        pipelineBindCount += other.pipelineBindCount;
+        bufferBindCount += other.bufferBindCount;
+        textureBindCount += other.textureBindCount;
+        samplerBindCount += other.samplerBindCount;
+        drawCount += other.drawCount;
+        vertexCount += other.vertexCount;
+        indexCount += other.indexCount;
+
+        return *this;
+    }
+
+    BackendResource::BackendResource(BackendResource&& other) noexcept
+        : m_renderBackend(std::exchange(other.m_renderBackend, nullptr)), m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    BackendResource& BackendResource::operator=(BackendResource&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+
+            m_renderBackend = std::exchange(other.m_renderBackend, nullptr);
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    void BackendResource::reset()
+    {
+        if (m_handle)
+        {
+            m_renderBackend->releaseResource(m_handle);
+        }
+
+        m_renderBackend = nullptr;
+        m_handle = nullptr;
+    }
+}
@@ -0,0 +1,118 @@
+#include "Pch.hpp"
+
+#include "RenderQueue.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        constexpr uint32_t RADIX_BITS = 8u;
+        constexpr uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+        constexpr uint32_t RADIX_PASS_COUNT = 64u / RADIX_BITS;
+
+        uint32_t getDigit(const uint64_t key, const uint32_t radixPass) { return static_cast<uint32_t>(key >> (radixPass * RADIX_BITS)) & (RADIX_SIZE - 1u); }
+    }
+
+    DrawSubmissionStats& DrawSubmissionStats::operator+=(const DrawSubmissionStats& other)
+    {
+        itemCount += other.itemCount;
+        drawCount += other.drawCount;
+        vertexBufferBindCount += other.vertexBufferBindCount;
+        indexBufferBindCount += other.indexBufferBindCount;
+        transformBindCount += other.transformBindCount;
+        textureBindCount += other.textureBindCount;
+        samplerBindCount += other.samplerBindCount;
+
+        return *this;
+    }
+
+    uint64_t RenderQueue::createSortKey(const uint32_t pass, const uint32_t pipeline, const uint32_t material, const float depth)
+    {
+        constexpr uint32_t MATERIAL_SHIFT = 32u;
+        constexpr uint32_t PIPELINE_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+        constexpr uint32_t PASS_SHIFT = PIPELINE_SHIFT + PIPELINE_BITS;
+
+        static_assert(PASS_SHIFT + PASS_BITS == 64u);
+
+        // Negative depths (e.g a large mesh around the camera) would sort after every positive one, and are as close as it gets anyway.
+        const uint32_t depthBits = std::bit_cast<uint32_t>(std::max(depth, 0.0f));
+
+        return (static_cast<uint64_t>(pass & ((1u << PASS_BITS) - 1u)) << PASS_SHIFT) | (static_cast<uint64_t>(pipeline & ((1u << PIPELINE_BITS) - 1u)) << PIPELINE_SHIFT) |
+               (static_cast<uint64_t>(material & ((1u << MATERIAL_BITS) - 1u)) << MATERIAL_SHIFT) | depthBits;
+    }
+
+    void RenderQueue::clear()
+    {
+        m_keys.clear();
+        m_items.clear();
+    }
+
+    void RenderQueue::reserve(const uint32_t itemCount)
+    {
+        m_keys.reserve(itemCount);
+        m_items.reserve(itemCount);
+    }
+
+    void RenderQueue::add(const uint64_t sortKey, const RenderItem& item)
+    {
+        m_keys.emplace_back(sortKey);
+        m_items.emplace_back(item);
+    }
+
+    void RenderQueue::sort()
+    {
+        const uint32_t itemCount = getItemCount();
+
+        m_scratchKeys.resize(itemCount);
+        m_itemIndices.resize(itemCount);
+        m_scratchItemIndices.resize(itemCount);
+
+        std::iota(m_itemIndices.begin(), m_itemIndices.end(), 0u);
+
+        // The histograms of every digit are counted in a single read of the keys.
+        std::array<std::array<uint32_t, RADIX_SIZE>, RADIX_PASS_COUNT> histograms{};
+        for (const uint64_t key : m_keys)
+        {
+            for (const uint32_t radixPass : std::views::iota(0u, RADIX_PASS_COUNT))
+            {
+                histograms[radixPass][getDigit(key, radixPass)]++;
+            }
+        }
+
+        for (const uint32_t radixPass : std::views::iota(0u, RADIX_PASS_COUNT))
+        {
+            std::array<uint32_t, RADIX_SIZE>& histogram = histograms[radixPass];
+
+            if (itemCount == 0u || histogram[getDigit(m_keys[0], radixPass)] == itemCount)
+            {
+                continue;
+            }
+
+            // Exclusive prefix sum, giving the first output position of each digit.
+            uint32_t offset = 0u;
+            for (uint32_t& count : histogram)
+            {
+                offset += std::exchange(count, offset);
+            }
+
+            for (const uint32_t i : std::views::iota(0u, itemCount))
+            {
+                const uint32_t position = histogram[getDigit(m_keys[i], radixPass)]++;
+
+                m_scratchKeys[position] = m_keys[i];
+                m_scratchItemIndices[position] = m_itemIndices[i];
+            }
+
+            m_keys.swap(m_scratchKeys);
+            m_itemIndices.swap(m_scratchItemIndices);
+        }
+
+        m_scratchItems.resize(itemCount);
+        for (const uint32_t i : std::views::iota(0u, itemCount))
+        {
+            m_scratchItems[i] = m_items[m_itemIndices[i]];
+        }
+
+        m_items.swap(m_scratchItems);
+    }
+}
@@ -0,0 +1,105 @@
+#include "Pch.hpp"
+
+#include "SceneBvh.hpp"
+
+#include "Model.hpp"
+
+namespace sgfx
+{
+    void SceneBvh::build(std::span<Model* const> models)
+    {
+        m_models.assign(models.begin(), models.end());
+        m_modelWorldBoundsVersions.resize(m_models.size());
+
+        m_meshes.clear();
+
+        for (const uint32_t modelIndex : std::views::iota(0u, static_cast<uint32_t>(m_models.size())))
+        {
+            for (const uint32_t meshIndex : std::views::iota(0u, m_models[modelIndex]->getMeshCount()))
+            {
+                m_meshes.emplace_back(SceneMeshReference{.modelIndex = modelIndex, .meshIndex = meshIndex});
+            }
+        }
+
+        gatherMeshBounds();
+
+        m_bvh.build(m_meshBounds);
+    }
+
+    bool SceneBvh::update()
+    {
+        bool isAnyModelMoved = false;
+
+        for (const uint32_t modelIndex : std::views::iota(0u, static_cast<uint32_t>(m_models.size())))
+        {
+            isAnyModelMoved |= m_models[modelIndex]->getWorldBoundsVersion() != m_modelWorldBoundsVersions[modelIndex];
+        }
+
+        if (!isAnyModelMoved)
+        {
+            return false;
+        }
+
+        gatherMeshBounds();
+
+        m_bvh.refit(m_meshBounds);
+
+        return true;
+    }
+
+    void SceneBvh::queryFrustums(std::span<const Frustum> frustums, std::span<std::vector<SceneMeshReference>> outMeshes) const
+    {
+        std::vector<std::vector<uint32_t>> primitives(frustums.size());
+        m_bvh.queryFrustums(frustums, primitives);
+
+        for (const size_t frustumIndex : std::views::iota(size_t{0u}, frustums.size()))
+        {
+            for (const uint32_t primitiveIndex : primitives[frustumIndex])
+            {
+                outMeshes[frustumIndex].emplace_back(m_meshes[primitiveIndex]);
+            }
+        }
+    }
+
+    ScenePickResult SceneBvh::pick(const Ray& ray) const
+    {
+        const BvhRayHit hit = m_bvh.raycast(ray,
+                                            [&](const uint32_t primitiveIndex, const Ray& meshRay, const float maxDistance)
+                                            {
+                                                const SceneMeshReference& mesh = m_meshes[primitiveIndex];
+                                                const Ray boundedRay{.origin = meshRay.origin, .direction = meshRay.direction, .maxDistance = maxDistance};
+
+                                                return m_models[mesh.modelIndex]->raycastMesh(mesh.meshIndex, boundedRay);
+                                            });
+
+        if (!hit.isHit())
+        {
+            return ScenePickResult{};
+        }
+
+        ScenePickResult result{
+            .mesh = m_meshes[hit.primitiveIndex],
+            .distance = hit.distance,
+        };
+
+        math::XMStoreFloat3(&result.position, math::XMVectorMultiplyAdd(math::XMLoadFloat3(&ray.direction), math::XMVectorReplicate(hit.distance), math::XMLoadFloat3(&ray.origin)));
+
+        return result;
+    }
+
+    void SceneBvh::gatherMeshBounds()
+    {
+        m_meshBounds.clear();
+        m_meshBounds.reserve(m_meshes.size());
+
+        for (const SceneMeshReference& mesh : m_meshes)
+        {
+            m_meshBounds.emplace_back(m_models[mesh.modelIndex]->getMeshWorldBounds(mesh.meshIndex));
+        }
+
+        for (const uint32_t modelIndex : std::views::iota(0u, static_cast<uint32_t>(m_models.size())))
+        {
+            m_modelWorldBoundsVersions[modelIndex] = m_models[modelIndex]->getWorldBoundsVersion();
+        }
+    }
+}
@@ -0,0 +1,317 @@
+#include "Pch.hpp"
+
+#include "ShaderCache.hpp"
+
+#include "Profiler.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        constexpr uint32_t SHADER_CACHE_MAGIC = 0x53584653u; // 'SFXS'.
+
+        // Part of every key, so bumping it invalidates every cached shader (e.g when the compile flags change).
+        constexpr uint32_t SHADER_CACHE_VERSION = 1u;
+
+        struct ShaderCacheHeader
+        {
+            uint32_t magic{SHADER_CACHE_MAGIC};
+            uint32_t version{SHADER_CACHE_VERSION};
+            uint64_t key{};
+            uint64_t bytecodeSize{};
+        };
+
+        uint64_t hashString(const std::string_view string) { return hashBytes(std::as_bytes(std::span(string))); }
+
+        // Replaces comments by spaces (keeping line breaks) and leaves string literals untouched, so "//" within an include path is preserved.
+        std::string removeComments(const std::string_view source)
+        {
+            std::string result{};
+            result.reserve(source.size());
+
+            bool isInString = false;
+            bool isInLineComment = false;
+            bool isInBlockComment = false;
+
+            for (size_t i = 0u; i < source.size(); i++)
+            {
+                const char c = source[i];
+                const char next = i + 1u < source.size() ? source[i + 1u] : '\0';
+
+                if (isInLineComment)
+                {
+                    if (c == '\n')
+                    {
+                        isInLineComment = false;
+                        result.push_back(c);
+                    }
+                }
+                else if (isInBlockComment)
+                {
+                    if (c == '*' && next == '/')
+                    {
+                        isInBlockComment = false;
+                        result.push_back(' ');
+                        i++;
+                    }
+                    else if (c == '\n')
+                    {
+                        result.push_back(c);
+                    }
+                }
+                else if (isInString)
+                {
+                    isInString = c != '"' && c != '\n';
+                    result.push_back(c);
+                }
+                else if (c == '/' && next == '/')
+                {
+                    isInLineComment = true;
+                    i++;
+                }
+                else if (c == '/' && next == '*')
+                {
+                    isInBlockComment = true;
+                    i++;
+                }
+                else
+                {
+                    isInString = c == '"';
+                    result.push_back(c);
+                }
+            }
+
+            return result;
+        }
+
+        void hashShaderFile(const std::filesystem::path& path, const ShaderFileReader& fileReader, std::vector<std::filesystem::path>& visitedPaths, uint64_t& key)
+        {
+            // Include guards are not evaluated, so each file is hashed once (which also stops include cycles).
+            if (std::ranges::find(visitedPaths, path) != visitedPaths.end())
+            {
+                return;
+            }
+
+            visitedPaths.emplace_back(path);
+
+            key = hashCombine(key, hashString(path.generic_string()));
+
+            const std::optional<std::string> source = fileReader(path);
+            if (!source.has_value())
+            {
+                key = hashCombine(key, hashString("<missing>"));
+                return;
+            }
+
+            key = hashCombine(key, hashString(*source));
+
+            for (const std::string& includePath : scanShaderIncludes(*source))
+            {
+                hashShaderFile((path.parent_path() / includePath).lexically_normal(), fileReader, visitedPaths, key);
+            }
+        }
+    }
+
+    std::optional<std::string> readShaderFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        std::string source(static_cast<size_t>(file.tellg()), '\0');
+
+        file.seekg(0);
+        file.read(source.data(), static_cast<std::streamsize>(source.size()));
+
+        return source;
+    }
+
+    std::vector<std::string> scanShaderIncludes(const std::string_view source)
+    {
+        std::vector<std::string> includePaths{};
+
+        const std::string code = removeComments(source);
+
+        const auto isSpace = [](const char c) { return c == ' ' || c == '\t' || c == '\r'; };
+
+        for (const auto lineRange : std::views::split(code, '\n'))
+        {
+            std::string_view line(lineRange.begin(), lineRange.end());
+
+            const auto skipSpaces = [&]()
+            {
+                while (!line.empty() && isSpace(line.front()))
+                {
+                    line.remove_prefix(1u);
+                }
+            };
+
+            skipSpaces();
+            if (!line.starts_with('#'))
+            {
+                continue;
+            }
+
+            line.remove_prefix(1u);
+            skipSpaces();
+
+            constexpr std::string_view INCLUDE_DIRECTIVE = "include";
+            if (!line.starts_with(INCLUDE_DIRECTIVE))
+            {
+                continue;
+            }
+
+            line.remove_prefix(INCLUDE_DIRECTIVE.size());
+            skipSpaces();
+
+            if (line.empty() || (line.front() != '"' && line.front() != '<'))
+            {
+                continue;
+            }
+
+            const char closingDelimiter = line.front() == '"' ? '"' : '>';
+            line.remove_prefix(1u);
+
+            const size_t pathEnd = line.find(closingDelimiter);
+            if (pathEnd != std::string_view::npos)
+            {
+                includePaths.emplace_back(line.substr(0u, pathEnd));
+            }
+        }
+
+        return includePaths;
+    }
+
+    uint64_t computeShaderKey(const ShaderCompileDesc& compileDesc, const ShaderFileReader& fileReader)
+    {
+        uint64_t key = hashCombine(SHADER_CACHE_VERSION, hashString(compileDesc.entryPoint));
+        key = hashCombine(key, hashString(compileDesc.target));
+
+        // Every define has the same value, so their order does not affect the bytecode.
+        std::vector<std::string> defines = compileDesc.defines;
+        std::ranges::sort(defines);
+
+        for (const std::string& define : defines)
+        {
+            key = hashCombine(key, hashString(define));
+        }
+
+        std::vector<std::filesystem::path> visitedPaths{};
+        hashShaderFile(compileDesc.path.lexically_normal(), fileReader, visitedPaths, key);
+
+        return key;
+    }
+
+    ShaderCache::ShaderCache(const std::filesystem::path& cacheDirectory, ShaderCompiler compiler, ShaderFileReader fileReader)
+        : m_cacheDirectory(cacheDirectory), m_compiler(std::move(compiler)), m_fileReader(std::move(fileReader))
+    {
+        std::error_code errorCode{};
+        std::filesystem::create_directories(m_cacheDirectory, errorCode);
+    }
+
+    std::vector<std::byte> ShaderCache::getShader(const ShaderCompileDesc& compileDesc)
+    {
+        SGFX_PROFILE_ZONE("Shader cache lookup");
+
+        const uint64_t key = computeShaderKey(compileDesc, m_fileReader);
+
+        if (std::optional<std::vector<std::byte>> bytecode = readCachedShader(key))
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.requestCount++;
+            m_stats.hitCount++;
+
+            return std::move(*bytecode);
+        }
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::byte> bytecode{};
+        {
+            SGFX_PROFILE_ZONE("Shader compilation");
+            bytecode = m_compiler(compileDesc);
+        }
+
+        const std::chrono::duration<float, std::milli> compileTime = std::chrono::high_resolution_clock::now() - startTime;
+
+        writeCachedShader(key, bytecode);
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.requestCount++;
+            m_stats.compileCount++;
+            m_stats.compileTimeMs += compileTime.count();
+        }
+
+        return bytecode;
+    }
+
+    ShaderCacheStats ShaderCache::getStats() const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    std::filesystem::path ShaderCache::getCachePath(const uint64_t key) const { return m_cacheDirectory / std::format("{:016x}.cso", key); }
+
+    std::optional<std::vector<std::byte>> ShaderCache::readCachedShader(const uint64_t key) const
+    {
+        std::ifstream file(getCachePath(key), std::ios::binary);
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        ShaderCacheHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(ShaderCacheHeader));
+
+        if (!file || header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key)
+        {
+            return std::nullopt;
+        }
+
+        std::vector<std::byte> bytecode(static_cast<size_t>(header.bytecodeSize));
+        file.read(reinterpret_cast<char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+
+        // A truncated file (e.g from a crash while writing) is compiled again.
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        return bytecode;
+    }
+
+    void ShaderCache::writeCachedShader(const uint64_t key, std::span<const std::byte> bytecode) const
+    {
+        const ShaderCacheHeader header{
+            .key = key,
+            .bytecodeSize = bytecode.size(),
+        };
+
+        // Pipelines sharing a shader may compile it concurrently, so each writes to a unique temporary file that is then renamed.
+        const std::filesystem::path finalPath = getCachePath(key);
+        const std::filesystem::path temporaryPath = finalPath.string() + std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cout << "Failed to create shader cache file : " << temporaryPath.string() << '\n';
+                return;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(ShaderCacheHeader));
+            file.write(reinterpret_cast<const char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+        }
+
+        std::error_code errorCode{};
+        std::filesystem::rename(temporaryPath, finalPath, errorCode);
+        if (errorCode)
+        {
+            std::filesystem::remove(temporaryPath, errorCode);
+        }
+    }
+}
@@ -0,0 +1,748 @@
+#include "Pch.hpp"
+
+#include "SoftwareDeferredPasses.hpp"
+
+#include "CpuFeatures.hpp"
+#include "JobSystem.hpp"
+
+#include <immintrin.h>
+
+#include <stb_image_write.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        // UNORM conversion of a render target write, NaN being written as 0.
+        uint8_t toUnorm8(const float value) { return static_cast<uint8_t>((value > 0.0f ? std::min(value, 1.0f) : 0.0f) * 255.0f + 0.5f); }
+
+        // AcesNarkowicz and the gamma of FullscreenPass.hlsl.
+        uint8_t toneMap(const float value)
+        {
+            const float color = 0.6f * value;
+            const float toneMappedColor = (color * (2.51f * color + 0.03f)) / (color * (2.43f * color + 0.59f) + 0.14f);
+
+            return toUnorm8(std::pow(toneMappedColor > 0.0f ? std::min(toneMappedColor, 1.0f) : 0.0f, 1.0f / 2.2f));
+        }
+
+        // Columns of the projection matrix giving the clip space x, y and w, the only components SSAO uses.
+        constexpr std::array<uint32_t, 3> CLIP_COLUMNS = {0u, 1u, 3u};
+
+        // Of the projection matrix and the sample vectors, shared by the SSE2 and AVX2 SSAO.
+        struct SsaoConstants
+        {
+            math::XMFLOAT4X4 projectionMatrix{};
+            std::span<const math::XMFLOAT4> sampleVectors{};
+
+            float radius{};
+            float bias{};
+            float power{};
+        };
+
+        // The GPU pass divides (1 - occlusion) by the sample count, and raises it to the power, one pixel at a time as there is no SIMD pow.
+        void storeOcclusions(const float* const occlusions, const uint32_t count, const SsaoConstants& constants, uint8_t* const outOcclusions)
+        {
+            const float inverseSampleCount = 1.0f / static_cast<float>(constants.sampleVectors.size());
+
+            for (const uint32_t i : std::views::iota(0u, count))
+            {
+                outOcclusions[i] = toUnorm8(std::pow(std::abs(1.0f - occlusions[i] * inverseSampleCount), constants.power));
+            }
+        }
+
+        // x, y and z of 4 float4, transposed.
+        void loadFloat4sSse2(const math::XMFLOAT4* const values, __m128& outX, __m128& outY, __m128& outZ)
+        {
+            __m128 row0 = _mm_loadu_ps(&values[0].x);
+            __m128 row1 = _mm_loadu_ps(&values[1].x);
+            __m128 row2 = _mm_loadu_ps(&values[2].x);
+            __m128 row3 = _mm_loadu_ps(&values[3].x);
+
+            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+            outX = row0;
+            outY = row1;
+            outZ = row2;
+        }
+
+        __m128 normalizeSse2(__m128& x, __m128& y, __m128& z)
+        {
+            const __m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z))));
+
+            x = _mm_mul_ps(x, inverseLength);
+            y = _mm_mul_ps(y, inverseLength);
+            z = _mm_mul_ps(z, inverseLength);
+
+            return inverseLength;
+        }
+
+        // Component column of the clip space position of a view space direction (without the translation of the projection).
+        __m128 projectDirectionSse2(const math::XMFLOAT4X4& projection, const __m128 x, const __m128 y, const __m128 z, const uint32_t column)
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(projection.m[0][column])), _mm_mul_ps(y, _mm_set1_ps(projection.m[1][column]))),
+                              _mm_mul_ps(z, _mm_set1_ps(projection.m[2][column])));
+        }
+
+        __m128 dotSse2(const __m128 ax, const __m128 ay, const __m128 az, const __m128 bx, const __m128 by, const __m128 bz)
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+        }
+
+        // SSAO of [minimumX, maximumX] x [minimumY, maximumY], 4 pixels per iteration. The sample positions are offsets along the tangent
+        // basis, so their clip space positions are the pixel's plus the same offsets along the projected basis. The sample depths are loaded one
+        // by one from viewDepths, which has the same rows as occlusions.
+        void computeAmbientOcclusionSse2(const GBufferImages& gbuffer,
+                                         const SsaoConstants& constants,
+                                         std::span<const math::XMFLOAT2> noise,
+                                         const float* const viewDepths,
+                                         uint8_t* const occlusions,
+                                         const uint32_t rowPitch,
+                                         const uint32_t minimumX,
+                                         const uint32_t minimumY,
+                                         const uint32_t maximumX,
+                                         const uint32_t maximumY)
+        {
+            const math::XMFLOAT4X4& projection = constants.projectionMatrix;
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+
+            const __m128 radius = _mm_set1_ps(constants.radius);
+            const __m128 bias = _mm_set1_ps(constants.bias);
+
+            const __m128 halfWidth = _mm_set1_ps(0.5f * static_cast<float>(gbuffer.width));
+            const __m128 halfHeight = _mm_set1_ps(0.5f * static_cast<float>(gbuffer.height));
+            const __m128 lastX = _mm_set1_ps(static_cast<float>(gbuffer.width - 1u));
+            const __m128 lastY = _mm_set1_ps(static_cast<float>(gbuffer.height - 1u));
+
+            alignas(16) std::array<int32_t, 4> texelX{};
+            alignas(16) std::array<int32_t, 4> texelY{};
+            alignas(16) std::array<float, 4> laneOcclusions{};
+
+            for (uint32_t y = minimumY; y <= maximumY; y++)
+            {
+                for (uint32_t x = minimumX; x <= maximumX; x += 4u)
+                {
+                    const size_t index = static_cast<size_t>(y) * gbuffer.rowPitch + x;
+
+                    __m128 positionX{}, positionY{}, positionZ{};
+                    __m128 normalX{}, normalY{}, normalZ{};
+                    loadFloat4sSse2(&gbuffer.positions[index], positionX, positionY, positionZ);
+                    loadFloat4sSse2(&gbuffer.normals[index], normalX, normalY, normalZ);
+
+                    // The noise texture is tiled over the screen, one texel per pixel.
+                    const float* const noiseTexels = &noise[(y % SoftwareDeferredPasses::SSAO_NOISE_SIZE) * SoftwareDeferredPasses::SSAO_NOISE_SIZE + x % SoftwareDeferredPasses::SSAO_NOISE_SIZE].x;
+                    const __m128 noise01 = _mm_loadu_ps(noiseTexels);
+                    const __m128 noise23 = _mm_loadu_ps(noiseTexels + 4u);
+                    const __m128 randomX = _mm_shuffle_ps(noise01, noise23, _MM_SHUFFLE(2, 0, 2, 0));
+                    const __m128 randomY = _mm_shuffle_ps(noise01, noise23, _MM_SHUFFLE(3, 1, 3, 1));
+
+                    // Tangent basis built from the random vector (of z 0) by Gram-Schmidt.
+                    const __m128 randomDotNormal = _mm_add_ps(_mm_mul_ps(randomX, normalX), _mm_mul_ps(randomY, normalY));
+
+                    __m128 tangentX = _mm_sub_ps(randomX, _mm_mul_ps(normalX, randomDotNormal));
+                    __m128 tangentY = _mm_sub_ps(randomY, _mm_mul_ps(normalY, randomDotNormal));
+                    __m128 tangentZ = _mm_sub_ps(zero, _mm_mul_ps(normalZ, randomDotNormal));
+                    normalizeSse2(tangentX, tangentY, tangentZ);
+
+                    __m128 bitangentX = _mm_sub_ps(_mm_mul_ps(normalY, tangentZ), _mm_mul_ps(normalZ, tangentY));
+                    __m128 bitangentY = _mm_sub_ps(_mm_mul_ps(normalZ, tangentX), _mm_mul_ps(normalX, tangentZ));
+                    __m128 bitangentZ = _mm_sub_ps(_mm_mul_ps(normalX, tangentY), _mm_mul_ps(normalY, tangentX));
+                    normalizeSse2(bitangentX, bitangentY, bitangentZ);
+
+                    // The basis is scaled by the radius, and projected along with the pixel's position.
+                    const __m128 basis[3][3] = {
+                        {_mm_mul_ps(tangentX, radius), _mm_mul_ps(tangentY, radius), _mm_mul_ps(tangentZ, radius)},
+                        {_mm_mul_ps(bitangentX, radius), _mm_mul_ps(bitangentY, radius), _mm_mul_ps(bitangentZ, radius)},
+                        {_mm_mul_ps(normalX, radius), _mm_mul_ps(normalY, radius), _mm_mul_ps(normalZ, radius)},
+                    };
+
+                    __m128 clipBasis[3][3]{};
+                    for (const uint32_t axis : std::views::iota(0u, 3u))
+                    {
+                        for (const uint32_t component : std::views::iota(0u, 3u))
+                        {
+                            clipBasis[axis][component] = projectDirectionSse2(projection, basis[axis][0], basis[axis][1], basis[axis][2], CLIP_COLUMNS[component]);
+                        }
+                    }
+
+                    const __m128 clipPositionX = _mm_add_ps(projectDirectionSse2(projection, positionX, positionY, positionZ, 0u), _mm_set1_ps(projection.m[3][0]));
+                    const __m128 clipPositionY = _mm_add_ps(projectDirectionSse2(projection, positionX, positionY, positionZ, 1u), _mm_set1_ps(projection.m[3][1]));
+                    const __m128 clipPositionW = _mm_add_ps(projectDirectionSse2(projection, positionX, positionY, positionZ, 3u), _mm_set1_ps(projection.m[3][3]));
+
+                    __m128 occlusion = zero;
+
+                    for (const math::XMFLOAT4& sampleVector : constants.sampleVectors)
+                    {
+                        const __m128 sampleX = _mm_set1_ps(sampleVector.x);
+                        const __m128 sampleY = _mm_set1_ps(sampleVector.y);
+                        const __m128 sampleZ = _mm_set1_ps(sampleVector.z);
+
+                        const auto offset = [&](const __m128 origin, const __m128 (&axes)[3][3], const uint32_t component)
+                        {
+                            return _mm_add_ps(origin,
+                                              _mm_add_ps(_mm_add_ps(_mm_mul_ps(sampleX, axes[0][component]), _mm_mul_ps(sampleY, axes[1][component])),
+                                                         _mm_mul_ps(sampleZ, axes[2][component])));
+                        };
+
+                        const __m128 samplePositionZ = offset(positionZ, basis, 2u);
+                        const __m128 inverseW = _mm_div_ps(one, offset(clipPositionW, clipBasis, 2u));
+
+                        // Texel picked by the point sampler, clamped to the edges. The comparisons are ordered so NaN gives texel 0.
+                        const __m128 textureX = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(offset(clipPositionX, clipBasis, 0u), inverseW), halfWidth), halfWidth);
+                        const __m128 textureY = _mm_sub_ps(halfHeight, _mm_mul_ps(_mm_mul_ps(offset(clipPositionY, clipBasis, 1u), inverseW), halfHeight));
+
+                        _mm_store_si128(reinterpret_cast<__m128i*>(texelX.data()), _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(textureX, zero), lastX)));
+                        _mm_store_si128(reinterpret_cast<__m128i*>(texelY.data()), _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(textureY, zero), lastY)));
+
+                        const __m128 sampleDepth = _mm_setr_ps(viewDepths[static_cast<size_t>(texelY[0]) * rowPitch + texelX[0]],
+                                                               viewDepths[static_cast<size_t>(texelY[1]) * rowPitch + texelX[1]],
+                                                               viewDepths[static_cast<size_t>(texelY[2]) * rowPitch + texelX[2]],
+                                                               viewDepths[static_cast<size_t>(texelY[3]) * rowPitch + texelX[3]]);
+
+                        // smoothstep(0, 1, radius / |z - sampleDepth|), which is 3t^2 - 2t^3 of the clamped ratio.
+                        __m128 rangeCheck = _mm_div_ps(radius, _mm_andnot_ps(signMask, _mm_sub_ps(positionZ, sampleDepth)));
+                        rangeCheck = _mm_min_ps(_mm_max_ps(rangeCheck, zero), one);
+                        rangeCheck = _mm_mul_ps(_mm_mul_ps(rangeCheck, rangeCheck), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_add_ps(rangeCheck, rangeCheck)));
+
+                        const __m128 isUnoccluded = _mm_cmpge_ps(sampleDepth, _mm_add_ps(samplePositionZ, bias));
+                        occlusion = _mm_add_ps(occlusion, _mm_andnot_ps(isUnoccluded, rangeCheck));
+                    }
+
+                    _mm_store_ps(laneOcclusions.data(), occlusion);
+                    storeOcclusions(laneOcclusions.data(), 4u, constants, occlusions + static_cast<size_t>(y) * rowPitch + x);
+                }
+            }
+        }
+
+        SGFX_TARGET_AVX2 void loadFloat4sAvx2(const math::XMFLOAT4* const values, __m256& outX, __m256& outY, __m256& outZ)
+        {
+            // Lane i of the low half holds value i and of the high half value i + 4, which the per half transposition keeps in order.
+            const __m256 row0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&values[0].x)), _mm_loadu_ps(&values[4].x), 1);
+            const __m256 row1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&values[1].x)), _mm_loadu_ps(&values[5].x), 1);
+            const __m256 row2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&values[2].x)), _mm_loadu_ps(&values[6].x), 1);
+            const __m256 row3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&values[3].x)), _mm_loadu_ps(&values[7].x), 1);
+
+            const __m256 xy01 = _mm256_unpacklo_ps(row0, row1);
+            const __m256 xy23 = _mm256_unpacklo_ps(row2, row3);
+            const __m256 zw01 = _mm256_unpackhi_ps(row0, row1);
+            const __m256 zw23 = _mm256_unpackhi_ps(row2, row3);
+
+            outX = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(1, 0, 1, 0));
+            outY = _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 2, 3, 2));
+            outZ = _mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+        }
+
+        SGFX_TARGET_AVX2 void normalizeAvx2(__m256& x, __m256& y, __m256& z)
+        {
+            const __m256 inverseLength = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(_mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_mul_ps(z, z)))));
+
+            x = _mm256_mul_ps(x, inverseLength);
+            y = _mm256_mul_ps(y, inverseLength);
+            z = _mm256_mul_ps(z, inverseLength);
+        }
+
+        SGFX_TARGET_AVX2 __m256 projectDirectionAvx2(const math::XMFLOAT4X4& projection, const __m256 x, const __m256 y, const __m256 z, const uint32_t column)
+        {
+            return _mm256_fmadd_ps(x, _mm256_set1_ps(projection.m[0][column]), _mm256_fmadd_ps(y, _mm256_set1_ps(projection.m[1][column]), _mm256_mul_ps(z, _mm256_set1_ps(projection.m[2][column]))));
+        }
+
+        // origin + x * axisX + y * axisY + z * axisZ.
+        SGFX_TARGET_AVX2 __m256 offsetAvx2(const __m256 origin, const __m256 x, const __m256 y, const __m256 z, const __m256 axisX, const __m256 axisY, const __m256 axisZ)
+        {
+            return _mm256_fmadd_ps(x, axisX, _mm256_fmadd_ps(y, axisY, _mm256_fmadd_ps(z, axisZ, origin)));
+        }
+
+        // As computeAmbientOcclusionSse2, 8 pixels per iteration, gathering the sample depths.
+        SGFX_TARGET_AVX2 void computeAmbientOcclusionAvx2(const GBufferImages& gbuffer,
+                                                          const SsaoConstants& constants,
+                                                          std::span<const math::XMFLOAT2> noise,
+                                                          const float* const viewDepths,
+                                                          uint8_t* const occlusions,
+                                                          const uint32_t rowPitch,
+                                                          const uint32_t minimumX,
+                                                          const uint32_t minimumY,
+                                                          const uint32_t maximumX,
+                                                          const uint32_t maximumY)
+        {
+            const math::XMFLOAT4X4& projection = constants.projectionMatrix;
+
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+            const __m256 radius = _mm256_set1_ps(constants.radius);
+            const __m256 bias = _mm256_set1_ps(constants.bias);
+
+            const __m256 halfWidth = _mm256_set1_ps(0.5f * static_cast<float>(gbuffer.width));
+            const __m256 halfHeight = _mm256_set1_ps(0.5f * static_cast<float>(gbuffer.height));
+            const __m256 lastX = _mm256_set1_ps(static_cast<float>(gbuffer.width - 1u));
+            const __m256 lastY = _mm256_set1_ps(static_cast<float>(gbuffer.height - 1u));
+            const __m256i depthRowPitch = _mm256_set1_epi32(static_cast<int32_t>(rowPitch));
+
+
+            alignas(32) std::array<float, 8> laneOcclusions{};
+
+            for (uint32_t y = minimumY; y <= maximumY; y++)
+            {
+                for (uint32_t x = minimumX; x <= maximumX; x += 8u)
+                {
+                    const size_t index = static_cast<size_t>(y) * gbuffer.rowPitch + x;
+
+                    __m256 positionX{}, positionY{}, positionZ{};
+                    __m256 normalX{}, normalY{}, normalZ{};
+                    loadFloat4sAvx2(&gbuffer.positions[index], positionX, positionY, positionZ);
+                    loadFloat4sAvx2(&gbuffer.normals[index], normalX, normalY, normalZ);
+
+                    // x being a multiple of 8, the pixels cover a whole row of the noise texture.
+                    const float* const noiseTexels = &noise[(y % SoftwareDeferredPasses::SSAO_NOISE_SIZE) * SoftwareDeferredPasses::SSAO_NOISE_SIZE].x;
+                    const __m256 noise0123 = _mm256_loadu_ps(noiseTexels);
+                    const __m256 noise4567 = _mm256_loadu_ps(noiseTexels + 8u);
+
+                    // The shuffles work within halves, leaving pairs of lanes 0 1 4 5 2 3 6 7.
+                    const __m256 randomX = _mm256_castpd_ps(
+                        _mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(noise0123, noise4567, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+                    const __m256 randomY = _mm256_castpd_ps(
+                        _mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(noise0123, noise4567, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+
+                    const __m256 randomDotNormal = _mm256_fmadd_ps(randomX, normalX, _mm256_mul_ps(randomY, normalY));
+
+                    __m256 tangentX = _mm256_fnmadd_ps(normalX, randomDotNormal, randomX);
+                    __m256 tangentY = _mm256_fnmadd_ps(normalY, randomDotNormal, randomY);
+                    __m256 tangentZ = _mm256_fnmadd_ps(normalZ, randomDotNormal, zero);
+                    normalizeAvx2(tangentX, tangentY, tangentZ);
+
+                    __m256 bitangentX = _mm256_fmsub_ps(normalY, tangentZ, _mm256_mul_ps(normalZ, tangentY));
+                    __m256 bitangentY = _mm256_fmsub_ps(normalZ, tangentX, _mm256_mul_ps(normalX, tangentZ));
+                    __m256 bitangentZ = _mm256_fmsub_ps(normalX, tangentY, _mm256_mul_ps(normalY, tangentX));
+                    normalizeAvx2(bitangentX, bitangentY, bitangentZ);
+
+                    const __m256 basis[3][3] = {
+                        {_mm256_mul_ps(tangentX, radius), _mm256_mul_ps(tangentY, radius), _mm256_mul_ps(tangentZ, radius)},
+                        {_mm256_mul_ps(bitangentX, radius), _mm256_mul_ps(bitangentY, radius), _mm256_mul_ps(bitangentZ, radius)},
+                        {_mm256_mul_ps(normalX, radius), _mm256_mul_ps(normalY, radius), _mm256_mul_ps(normalZ, radius)},
+                    };
+
+                    __m256 clipBasis[3][3]{};
+                    for (const uint32_t axis : std::views::iota(0u, 3u))
+                    {
+                        for (const uint32_t component : std::views::iota(0u, 3u))
+                        {
+                            clipBasis[axis][component] = projectDirectionAvx2(projection, basis[axis][0], basis[axis][1], basis[axis][2], CLIP_COLUMNS[component]);
+                        }
+                    }
+
+                    const __m256 clipPositionX = _mm256_add_ps(projectDirectionAvx2(projection, positionX, positionY, positionZ, 0u), _mm256_set1_ps(projection.m[3][0]));
+                    const __m256 clipPositionY = _mm256_add_ps(projectDirectionAvx2(projection, positionX, positionY, positionZ, 1u), _mm256_set1_ps(projection.m[3][1]));
+                    const __m256 clipPositionW = _mm256_add_ps(projectDirectionAvx2(projection, positionX, positionY, positionZ, 3u), _mm256_set1_ps(projection.m[3][3]));
+
+                    __m256 occlusion = zero;
+
+                    for (const math::XMFLOAT4& sampleVector : constants.sampleVectors)
+                    {
+                        const __m256 sampleX = _mm256_set1_ps(sampleVector.x);
+                        const __m256 sampleY = _mm256_set1_ps(sampleVector.y);
+                        const __m256 sampleZ = _mm256_set1_ps(sampleVector.z);
+
+                        const __m256 samplePositionZ = offsetAvx2(positionZ, sampleX, sampleY, sampleZ, basis[0][2], basis[1][2], basis[2][2]);
+                        const __m256 inverseW = _mm256_div_ps(one, offsetAvx2(clipPositionW, sampleX, sampleY, sampleZ, clipBasis[0][2], clipBasis[1][2], clipBasis[2][2]));
+
+                        const __m256 clipX = offsetAvx2(clipPositionX, sampleX, sampleY, sampleZ, clipBasis[0][0], clipBasis[1][0], clipBasis[2][0]);
+                        const __m256 clipY = offsetAvx2(clipPositionY, sampleX, sampleY, sampleZ, clipBasis[0][1], clipBasis[1][1], clipBasis[2][1]);
+
+                        const __m256 textureX = _mm256_fmadd_ps(_mm256_mul_ps(clipX, inverseW), halfWidth, halfWidth);
+                        const __m256 textureY = _mm256_fnmadd_ps(_mm256_mul_ps(clipY, inverseW), halfHeight, halfHeight);
+
+                        const __m256i texelX = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(textureX, zero), lastX));
+                        const __m256i texelY = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(textureY, zero), lastY));
+                        const __m256i texelIndex = _mm256_add_epi32(_mm256_mullo_epi32(texelY, depthRowPitch), texelX);
+
+                        const __m256 sampleDepth = _mm256_i32gather_ps(viewDepths, texelIndex, 4);
+
+                        __m256 rangeCheck = _mm256_div_ps(radius, _mm256_andnot_ps(signMask, _mm256_sub_ps(positionZ, sampleDepth)));
+                        rangeCheck = _mm256_min_ps(_mm256_max_ps(rangeCheck, zero), one);
+                        rangeCheck = _mm256_mul_ps(_mm256_mul_ps(rangeCheck, rangeCheck), _mm256_fnmadd_ps(_mm256_set1_ps(2.0f), rangeCheck, _mm256_set1_ps(3.0f)));
+
+                        const __m256 isUnoccluded = _mm256_cmp_ps(sampleDepth, _mm256_add_ps(samplePositionZ, bias), _CMP_GE_OQ);
+                        occlusion = _mm256_add_ps(occlusion, _mm256_andnot_ps(isUnoccluded, rangeCheck));
+                    }
+
+                    _mm256_store_ps(laneOcclusions.data(), occlusion);
+                    storeOcclusions(laneOcclusions.data(), 8u, constants, occlusions + static_cast<size_t>(y) * rowPitch + x);
+                }
+            }
+        }
+    }
+
+    void SoftwareDeferredPasses::resize(const uint32_t width, const uint32_t height)
+    {
+        m_width = width;
+        m_height = height;
+
+        m_rowPitch = (width + 7u) & ~7u;
+
+        m_tileCountX = (width + TILE_SIZE - 1u) / TILE_SIZE;
+        m_tileCountY = (height + TILE_SIZE - 1u) / TILE_SIZE;
+
+        const size_t pixelCount = static_cast<size_t>(m_rowPitch) * height;
+
+        m_viewDepths.resize(pixelCount);
+        m_occlusions.resize(pixelCount);
+        m_blurredOcclusions.resize(pixelCount);
+        m_litColors.resize(pixelCount);
+    }
+
+    void SoftwareDeferredPasses::computeAmbientOcclusion(const GBufferImages& gbuffer,
+                                                         const SSAOBuffer& ssaoBuffer,
+                                                         std::span<const math::XMFLOAT2> noise,
+                                                         const uint32_t sampleCount,
+                                                         JobSystem& jobSystem)
+    {
+        validateGBuffer(gbuffer);
+
+        if (sampleCount == 0u || sampleCount > MAX_SSAO_SAMPLE_COUNT)
+        {
+            fatalError(std::format("SSAO sample count {} is not within [1, {}].", sampleCount, MAX_SSAO_SAMPLE_COUNT));
+        }
+
+        if (noise.size() != SSAO_NOISE_SIZE * SSAO_NOISE_SIZE)
+        {
+            fatalError(std::format("SSAO noise has {} texels instead of {}.", noise.size(), SSAO_NOISE_SIZE * SSAO_NOISE_SIZE));
+        }
+
+        SsaoConstants constants{
+            .sampleVectors = std::span(ssaoBuffer.sampleVectors).first(sampleCount),
+            .radius = ssaoBuffer.radius,
+            .bias = ssaoBuffer.bias,
+            .power = ssaoBuffer.power,
+        };
+        math::XMStoreFloat4x4(&constants.projectionMatrix, ssaoBuffer.projectionMatrix);
+
+        // The samples only read the z of the positions, which are copied so more of them fit in the cache.
+        JobCounter depthCounter{};
+        jobSystem.parallelFor(
+            m_tileCountX * m_tileCountY,
+            1u,
+            [&](const uint32_t tileIndex)
+            {
+                uint32_t minimumX{}, minimumY{}, maximumX{}, maximumY{};
+                getTileBounds(tileIndex, minimumX, minimumY, maximumX, maximumY);
+
+                for (uint32_t y = minimumY; y <= maximumY; y++)
+                {
+                    for (uint32_t x = minimumX; x <= maximumX; x++)
+                    {
+                        m_viewDepths[static_cast<size_t>(y) * m_rowPitch + x] = gbuffer.positions[static_cast<size_t>(y) * gbuffer.rowPitch + x].z;
+                    }
+                }
+            },
+            depthCounter);
+        jobSystem.wait(depthCounter);
+
+        const bool isAvx2Supported = getCpuFeatures().avx2;
+
+        JobCounter tileCounter{};
+        jobSystem.parallelFor(
+            m_tileCountX * m_tileCountY,
+            1u,
+            [&](const uint32_t tileIndex)
+            {
+                uint32_t minimumX{}, minimumY{}, maximumX{}, maximumY{};
+                getTileBounds(tileIndex, minimumX, minimumY, maximumX, maximumY);
+
+                if (isAvx2Supported)
+                {
+                    computeAmbientOcclusionAvx2(gbuffer, constants, noise, m_viewDepths.data(), m_occlusions.data(), m_rowPitch, minimumX, minimumY, maximumX, maximumY);
+                }
+                else
+                {
+                    computeAmbientOcclusionSse2(gbuffer, constants, noise, m_viewDepths.data(), m_occlusions.data(), m_rowPitch, minimumX, minimumY, maximumX, maximumY);
+                }
+            },
+            tileCounter);
+        jobSystem.wait(tileCounter);
+    }
+
+    void SoftwareDeferredPasses::blurAmbientOcclusion(JobSystem& jobSystem)
+    {
+        // BoxBlur.hlsl declares its pixel size as a float, so both of its offsets are in units of the width. The rows read are those the
+        // point sampler picks for these offsets, clamped to the edges.
+        const auto getSourceRow = [&](const uint32_t y, const int32_t offset)
+        {
+            const float textureY = ((static_cast<float>(y) + 0.5f) / static_cast<float>(m_height) + static_cast<float>(offset) / static_cast<float>(m_width)) * static_cast<float>(m_height);
+            return static_cast<uint32_t>(std::clamp(std::floor(textureY), 0.0f, static_cast<float>(m_height - 1u)));
+        };
+
+        // Rounded average of 9 bytes : x / 18 is (x * 3641) >> 16 for every x up to 2 * 9 * 255 + 9.
+        const __m128i divisor = _mm_set1_epi16(3641);
+        const __m128i half = _mm_set1_epi16(9);
+
+        JobCounter tileCounter{};
+        jobSystem.parallelFor(
+            m_tileCountX * m_tileCountY,
+            1u,
+            [&](const uint32_t tileIndex)
+            {
+                uint32_t minimumX{}, minimumY{}, maximumX{}, maximumY{};
+                getTileBounds(tileIndex, minimumX, minimumY, maximumX, maximumY);
+
+                for (uint32_t y = minimumY; y <= maximumY; y++)
+                {
+                    const std::array<const uint8_t*, 3> sourceRows = {
+                        &m_occlusions[static_cast<size_t>(getSourceRow(y, -1)) * m_rowPitch],
+                        &m_occlusions[static_cast<size_t>(getSourceRow(y, 0)) * m_rowPitch],
+                        &m_occlusions[static_cast<size_t>(getSourceRow(y, 1)) * m_rowPitch],
+                    };
+
+                    uint8_t* const row = &m_blurredOcclusions[static_cast<size_t>(y) * m_rowPitch];
+
+                    for (uint32_t x = minimumX; x <= maximumX; x += 8u)
+                    {
+                        // Groups reading past the edges (or the image) clamp their columns one pixel at a time.
+                        if (x == 0u || x + 8u >= m_width)
+                        {
+                            for (const uint32_t pixelX : std::views::iota(x, x + 8u))
+                            {
+                                uint32_t sum = 0u;
+                                for (const uint8_t* const sourceRow : sourceRows)
+                                {
+                                    for (const int32_t offset : {-1, 0, 1})
+                                    {
+                                        sum += sourceRow[std::clamp(static_cast<int32_t>(pixelX) + offset, 0, static_cast<int32_t>(m_width) - 1)];
+                                    }
+                                }
+
+                                row[pixelX] = static_cast<uint8_t>((sum * 2u + 9u) / 18u);
+                            }
+
+                            continue;
+                        }
+
+                        __m128i sum = _mm_setzero_si128();
+                        for (const uint8_t* const sourceRow : sourceRows)
+                        {
+                            for (const uint32_t column : {x - 1u, x, x + 1u})
+                            {
+                                sum = _mm_add_epi16(sum, _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(sourceRow + column)), _mm_setzero_si128()));
+                            }
+                        }
+
+                        const __m128i average = _mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(sum, sum), half), divisor);
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(row + x), _mm_packus_epi16(average, average));
+                    }
+                }
+            },
+            tileCounter);
+        jobSystem.wait(tileCounter);
+    }
+
+    void SoftwareDeferredPasses::computeLighting(const GBufferImages& gbuffer, const SceneBuffer& sceneBuffer, JobSystem& jobSystem)
+    {
+        validateGBuffer(gbuffer);
+
+        // Light 0 is directional, of unit attenuation. The others are points, attenuated by the inverse of their distance.
+        std::array<math::XMFLOAT3, LIGHT_COUNT> lightColors{};
+        for (const uint32_t i : std::views::iota(0u, LIGHT_COUNT))
+        {
+            const math::XMFLOAT4& colorIntensity = sceneBuffer.lightColorIntensity[i];
+            lightColors[i] = math::XMFLOAT3{colorIntensity.x * colorIntensity.w, colorIntensity.y * colorIntensity.w, colorIntensity.z * colorIntensity.w};
+        }
+
+        math::XMFLOAT3 directionalLightDirection{};
+        math::XMStoreFloat3(&directionalLightDirection, math::XMVector3Normalize(math::XMLoadFloat4(&sceneBuffer.viewSpaceLightPosition[0])));
+
+        const float inverseWidth = 1.0f / static_cast<float>(m_width);
+        const float inverseHeight = 1.0f / static_cast<float>(m_height);
+
+        JobCounter tileCounter{};
+        jobSystem.parallelFor(
+            m_tileCountX * m_tileCountY,
+            1u,
+            [&](const uint32_t tileIndex)
+            {
+                uint32_t minimumX{}, minimumY{}, maximumX{}, maximumY{};
+                getTileBounds(tileIndex, minimumX, minimumY, maximumX, maximumY);
+
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 inverseUnormMaximum = _mm_set1_ps(1.0f / 255.0f);
+                const __m128i byteMask = _mm_set1_epi32(0xff);
+
+                for (uint32_t y = minimumY; y <= maximumY; y++)
+                {
+                    const __m128 textureCoordY = _mm_set1_ps((static_cast<float>(y) + 0.5f) * inverseHeight);
+
+                    for (uint32_t x = minimumX; x <= maximumX; x += 4u)
+                    {
+                        const size_t gbufferIndex = static_cast<size_t>(y) * gbuffer.rowPitch + x;
+                        const size_t index = static_cast<size_t>(y) * m_rowPitch + x;
+
+                        const __m128i albedo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&gbuffer.albedos[gbufferIndex]));
+                        const __m128 albedoRed = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(albedo, byteMask)), inverseUnormMaximum);
+                        const __m128 albedoGreen = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(albedo, 8), byteMask)), inverseUnormMaximum);
+                        const __m128 albedoBlue = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(albedo, 16), byteMask)), inverseUnormMaximum);
+                        const __m128 albedoAlpha = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(albedo, 24)), inverseUnormMaximum);
+
+                        __m128 positionX{}, positionY{}, positionZ{};
+                        __m128 normalX{}, normalY{}, normalZ{};
+                        loadFloat4sSse2(&gbuffer.positions[gbufferIndex], positionX, positionY, positionZ);
+                        loadFloat4sSse2(&gbuffer.normals[gbufferIndex], normalX, normalY, normalZ);
+
+                        uint32_t occlusionBytes{};
+                        std::memcpy(&occlusionBytes, &m_blurredOcclusions[index], sizeof(occlusionBytes));
+                        const __m128i occlusion16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int32_t>(occlusionBytes)), _mm_setzero_si128());
+                        const __m128 ambientFactor = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(occlusion16, _mm_setzero_si128())), inverseUnormMaximum);
+
+                        const __m128 ambientScale = _mm_mul_ps(ambientFactor, _mm_set1_ps(0.4f));
+                        __m128 red = _mm_mul_ps(albedoRed, ambientScale);
+                        __m128 green = _mm_mul_ps(albedoGreen, ambientScale);
+                        __m128 blue = _mm_mul_ps(albedoBlue, ambientScale);
+
+                        __m128 viewDirectionX = _mm_sub_ps(zero, positionX);
+                        __m128 viewDirectionY = _mm_sub_ps(zero, positionY);
+                        __m128 viewDirectionZ = _mm_sub_ps(zero, positionZ);
+                        normalizeSse2(viewDirectionX, viewDirectionY, viewDirectionZ);
+
+                        for (const uint32_t i : std::views::iota(0u, LIGHT_COUNT))
+                        {
+                            __m128 lightDirectionX = _mm_set1_ps(directionalLightDirection.x);
+                            __m128 lightDirectionY = _mm_set1_ps(directionalLightDirection.y);
+                            __m128 lightDirectionZ = _mm_set1_ps(directionalLightDirection.z);
+                            __m128 attenuation = one;
+
+                            if (i != 0u)
+                            {
+                                const math::XMFLOAT4& lightPosition = sceneBuffer.viewSpaceLightPosition[i];
+
+                                lightDirectionX = _mm_sub_ps(_mm_set1_ps(lightPosition.x), positionX);
+                                lightDirectionY = _mm_sub_ps(_mm_set1_ps(lightPosition.y), positionY);
+                                lightDirectionZ = _mm_sub_ps(_mm_set1_ps(lightPosition.z), positionZ);
+                                attenuation = normalizeSse2(lightDirectionX, lightDirectionY, lightDirectionZ);
+                            }
+
+                            const __m128 diffuseStrength = _mm_max_ps(dotSse2(lightDirectionX, lightDirectionY, lightDirectionZ, normalX, normalY, normalZ), zero);
+
+                            __m128 halfwayX = _mm_add_ps(lightDirectionX, viewDirectionX);
+                            __m128 halfwayY = _mm_add_ps(lightDirectionY, viewDirectionY);
+                            __m128 halfwayZ = _mm_add_ps(lightDirectionZ, viewDirectionZ);
+                            normalizeSse2(halfwayX, halfwayY, halfwayZ);
+
+                            // pow(x, 64) is x squared 6 times.
+                            __m128 specularIntensity = _mm_max_ps(dotSse2(halfwayX, halfwayY, halfwayZ, normalX, normalY, normalZ), zero);
+                            for ([[maybe_unused]] const uint32_t square : std::views::iota(0u, 6u))
+                            {
+                                specularIntensity = _mm_mul_ps(specularIntensity, specularIntensity);
+                            }
+
+                            const __m128 strength = _mm_mul_ps(_mm_add_ps(diffuseStrength, _mm_mul_ps(specularIntensity, _mm_set1_ps(0.2f))), attenuation);
+
+                            red = _mm_add_ps(red, _mm_mul_ps(_mm_mul_ps(strength, albedoRed), _mm_set1_ps(lightColors[i].x)));
+                            green = _mm_add_ps(green, _mm_mul_ps(_mm_mul_ps(strength, albedoGreen), _mm_set1_ps(lightColors[i].y)));
+                            blue = _mm_add_ps(blue, _mm_mul_ps(_mm_mul_ps(strength, albedoBlue), _mm_set1_ps(lightColors[i].z)));
+                        }
+
+                        // PhongShader.hlsl outputs the ambient factor alone below the diagonal of the screen.
+                        const __m128 textureCoordX =
+                            _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f)), _mm_set1_ps(inverseWidth));
+                        const __m128 isAmbientOnly = _mm_cmplt_ps(textureCoordX, textureCoordY);
+
+                        red = _mm_or_ps(_mm_and_ps(isAmbientOnly, ambientFactor), _mm_andnot_ps(isAmbientOnly, red));
+                        green = _mm_or_ps(_mm_and_ps(isAmbientOnly, ambientFactor), _mm_andnot_ps(isAmbientOnly, green));
+                        blue = _mm_or_ps(_mm_and_ps(isAmbientOnly, ambientFactor), _mm_andnot_ps(isAmbientOnly, blue));
+
+                        // Pixels discarded by the alpha test keep the previous frame on the GPU, and are black here.
+                        const __m128 isDiscarded = _mm_cmplt_ps(albedoAlpha, _mm_set1_ps(0.2f));
+                        red = _mm_andnot_ps(isDiscarded, red);
+                        green = _mm_andnot_ps(isDiscarded, green);
+                        blue = _mm_andnot_ps(isDiscarded, blue);
+
+                        __m128 alpha = one;
+                        _MM_TRANSPOSE4_PS(red, green, blue, alpha);
+
+                        _mm_storeu_ps(&m_litColors[index].x, red);
+                        _mm_storeu_ps(&m_litColors[index + 1u].x, green);
+                        _mm_storeu_ps(&m_litColors[index + 2u].x, blue);
+                        _mm_storeu_ps(&m_litColors[index + 3u].x, alpha);
+                    }
+                }
+            },
+            tileCounter);
+        jobSystem.wait(tileCounter);
+    }
+
+    bool SoftwareDeferredPasses::writePngs(const std::string_view pathPrefix) const
+    {
+        bool isWritten = true;
+
+        for (const PngImage& image : getPngImages())
+        {
+            const std::string path = std::format("{}{}", pathPrefix, image.suffix);
+            const int width = static_cast<int>(m_width);
+
+            isWritten = stbi_write_png(path.c_str(), width, static_cast<int>(m_height), static_cast<int>(image.channelCount), image.pixels.data(), width * static_cast<int>(image.channelCount)) != 0 &&
+                        isWritten;
+        }
+
+        return isWritten;
+    }
+
+    std::array<GoldenImageComparison, 3> SoftwareDeferredPasses::compareWithGoldenImages(const std::string_view goldenPathPrefix, const uint32_t tolerance) const
+    {
+        std::array<GoldenImageComparison, 3> comparisons{};
+        const std::array<PngImage, 3> images = getPngImages();
+
+        for (const uint32_t i : std::views::iota(0u, 3u))
+        {
+            const PngImage& image = images[i];
+            comparisons[i] = compareWithGoldenImage(std::format("{}{}", goldenPathPrefix, image.suffix), image.pixels, m_width, m_height, image.channelCount, tolerance);
+        }
+
+        return comparisons;
+    }
+
+    std::array<SoftwareDeferredPasses::PngImage, 3> SoftwareDeferredPasses::getPngImages() const
+    {
+        const size_t pixelCount = static_cast<size_t>(m_width) * m_height;
+        const auto getIndex = [&](const size_t pixel) { return (pixel / m_width) * m_rowPitch + pixel % m_width; };
+
+        std::array<PngImage, 3> images = {
+            PngImage{.suffix = "_occlusion.png", .channelCount = 1u, .pixels = std::vector<uint8_t>(pixelCount)},
+            PngImage{.suffix = "_blurred_occlusion.png", .channelCount = 1u, .pixels = std::vector<uint8_t>(pixelCount)},
+            PngImage{.suffix = "_lit.png", .channelCount = 3u, .pixels = std::vector<uint8_t>(pixelCount * 3u)},
+        };
+
+        for (const size_t pixel : std::views::iota(size_t{0u}, pixelCount))
+        {
+            const size_t index = getIndex(pixel);
+
+            images[0].pixels[pixel] = m_occlusions[index];
+            images[1].pixels[pixel] = m_blurredOcclusions[index];
+
+            images[2].pixels[pixel * 3u] = toneMap(m_litColors[index].x);
+            images[2].pixels[pixel * 3u + 1u] = toneMap(m_litColors[index].y);
+            images[2].pixels[pixel * 3u + 2u] = toneMap(m_litColors[index].z);
+        }
+
+        return images;
+    }
+
+    void SoftwareDeferredPasses::getTileBounds(const uint32_t tileIndex, uint32_t& minimumX, uint32_t& minimumY, uint32_t& maximumX, uint32_t& maximumY) const
+    {
+        minimumX = (tileIndex % m_tileCountX) * TILE_SIZE;
+        minimumY = (tileIndex / m_tileCountX) * TILE_SIZE;
+        maximumX = std::min(minimumX + TILE_SIZE, m_rowPitch) - 1u;
+        maximumY = std::min(minimumY + TILE_SIZE, m_height) - 1u;
+    }
+
+    void SoftwareDeferredPasses::validateGBuffer(const GBufferImages& gbuffer) const
+    {
+        const size_t pixelCount = static_cast<size_t>(gbuffer.rowPitch) * gbuffer.height;
+
+        if (gbuffer.width != m_width || gbuffer.height != m_height || gbuffer.rowPitch < m_rowPitch || gbuffer.rowPitch % 8u != 0u ||
+            gbuffer.albedos.size() < pixelCount || gbuffer.positions.size() < pixelCount || gbuffer.normals.size() < pixelCount)
+        {
+            fatalError(std::format("G-buffer of {} x {} pixels (row pitch {}) does not match the {} x {} software deferred passes.", gbuffer.width, gbuffer.height, gbuffer.rowPitch, m_width, m_height));
+        }
+    }
+}
@@ -0,0 +1,974 @@
+#include "Pch.hpp"
+
+#include "SoftwareRasterizer.hpp"
+
+#include "BlockCompression.hpp"
+#include "CpuFeatures.hpp"
+#include "JobSystem.hpp"
+#include "TextureCooker.hpp"
+
+#include <immintrin.h>
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        const std::array<float, 256>& getSrgbToLinearTable()
+        {
+            static const std::array<float, 256> table = []()
+            {
+                std::array<float, 256> values{};
+                for (const uint32_t i : std::views::iota(0u, 256u))
+                {
+                    const float value = i / 255.0f;
+                    values[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+
+                return values;
+            }();
+
+            return table;
+        }
+
+        uint8_t linearToSrgb(const float value)
+        {
+            const float srgbValue = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+            return static_cast<uint8_t>(std::clamp(srgbValue, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        // UNORM conversion of a render target write.
+        uint32_t toUnorm8(const float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); }
+
+        // Level of detail the GPU selects for a pixel : log2 of the longest texture space footprint of the pixel's sides, in texels.
+        float computeLod(const RasterTexture& texture, const math::XMFLOAT2& textureCoordDx, const math::XMFLOAT2& textureCoordDy)
+        {
+            const float width = static_cast<float>(texture.getWidth());
+            const float height = static_cast<float>(texture.getHeight());
+
+            const float footprintX = textureCoordDx.x * textureCoordDx.x * width * width + textureCoordDx.y * textureCoordDx.y * height * height;
+            const float footprintY = textureCoordDy.x * textureCoordDy.x * width * width + textureCoordDy.y * textureCoordDy.y * height * height;
+
+            return 0.5f * std::log2(std::max({footprintX, footprintY, std::numeric_limits<float>::min()}));
+        }
+
+        // Every member of the vertex is a float, so it is interpolated as an array of floats.
+        template <typename Vertex> Vertex lerpVertex(const Vertex& start, const Vertex& end, const float t)
+        {
+            static_assert(std::is_trivially_copyable_v<Vertex> && sizeof(Vertex) % sizeof(float) == 0u);
+
+            constexpr size_t FLOAT_COUNT = sizeof(Vertex) / sizeof(float);
+
+            std::array<float, FLOAT_COUNT> values = std::bit_cast<std::array<float, FLOAT_COUNT>>(start);
+            const std::array<float, FLOAT_COUNT> endValues = std::bit_cast<std::array<float, FLOAT_COUNT>>(end);
+
+            for (const size_t i : std::views::iota(size_t{0u}, FLOAT_COUNT))
+            {
+                values[i] += (endValues[i] - values[i]) * t;
+            }
+
+            return std::bit_cast<Vertex>(values);
+        }
+
+        // Calls shadePixel(x, y, depth) for every pixel of [minimumX, maximumX] x [minimumY, maximumY] covered by the triangle and passing the
+        // depth test, 4 pixels per iteration. minimumX is rounded down to a multiple of 4, the extra pixels being masked.
+        template <typename ShadePixel>
+        void rasterizeTriangleSse2(const float* const edgeX,
+                                   const float* const edgeY,
+                                   const float* const edgeOffset,
+                                   const uint32_t topLeftEdgeMask,
+                                   const std::array<float, 3>& depthPlane,
+                                   const float* const depths,
+                                   const uint32_t rowPitch,
+                                   const uint32_t minimumX,
+                                   const uint32_t minimumY,
+                                   const uint32_t maximumX,
+                                   const uint32_t maximumY,
+                                   ShadePixel&& shadePixel)
+        {
+            const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 firstCenterX = _mm_set1_ps(static_cast<float>(minimumX) + 0.5f);
+            const __m128 lastCenterX = _mm_set1_ps(static_cast<float>(maximumX) + 0.5f);
+
+            // Pixels centered on an edge are only covered if it is a top or left edge.
+            __m128 isTopLeftEdge[3]{};
+            for (const uint32_t edge : std::views::iota(0u, 3u))
+            {
+                isTopLeftEdge[edge] = _mm_castsi128_ps(_mm_set1_epi32((topLeftEdgeMask >> edge) & 1u ? -1 : 0));
+            }
+
+            alignas(16) std::array<float, 4> laneDepths{};
+
+            for (uint32_t y = minimumY; y <= maximumY; y++)
+            {
+                const float centerY = static_cast<float>(y) + 0.5f;
+
+                __m128 rowEdges[3]{};
+                for (const uint32_t edge : std::views::iota(0u, 3u))
+                {
+                    rowEdges[edge] = _mm_set1_ps(edgeY[edge] * centerY + edgeOffset[edge]);
+                }
+
+                const __m128 rowDepth = _mm_set1_ps(depthPlane[1] * centerY + depthPlane[2]);
+
+                const float* const row = depths + static_cast<size_t>(y) * rowPitch;
+
+                for (uint32_t x = minimumX & ~3u; x <= maximumX; x += 4u)
+                {
+                    const __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+                    __m128 isInside = _mm_and_ps(_mm_cmpge_ps(centerX, firstCenterX), _mm_cmple_ps(centerX, lastCenterX));
+                    for (const uint32_t edge : std::views::iota(0u, 3u))
+                    {
+                        const __m128 edgeValue = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeX[edge]), centerX), rowEdges[edge]);
+                        const __m128 isEdgeInside =
+                            _mm_or_ps(_mm_cmpgt_ps(edgeValue, _mm_setzero_ps()), _mm_and_ps(_mm_cmpeq_ps(edgeValue, _mm_setzero_ps()), isTopLeftEdge[edge]));
+
+                        isInside = _mm_and_ps(isInside, isEdgeInside);
+                    }
+
+                    if (_mm_movemask_ps(isInside) == 0)
+                    {
+                        continue;
+                    }
+
+                    const __m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(depthPlane[0]), centerX), rowDepth);
+                    uint32_t laneMask = static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(isInside, _mm_cmplt_ps(depth, _mm_loadu_ps(row + x)))));
+
+                    _mm_store_ps(laneDepths.data(), depth);
+
+                    for (; laneMask != 0u; laneMask &= laneMask - 1u)
+                    {
+                        const uint32_t lane = static_cast<uint32_t>(std::countr_zero(laneMask));
+                        shadePixel(x + lane, y, laneDepths[lane]);
+                    }
+                }
+            }
+        }
+
+        template <typename ShadePixel>
+        SGFX_TARGET_AVX2 void rasterizeTriangleAvx2(const float* const edgeX,
+                                                    const float* const edgeY,
+                                                    const float* const edgeOffset,
+                                                    const uint32_t topLeftEdgeMask,
+                                                    const std::array<float, 3>& depthPlane,
+                                                    const float* const depths,
+                                                    const uint32_t rowPitch,
+                                                    const uint32_t minimumX,
+                                                    const uint32_t minimumY,
+                                                    const uint32_t maximumX,
+                                                    const uint32_t maximumY,
+                                                    ShadePixel&& shadePixel)
+        {
+            const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+            const __m256 firstCenterX = _mm256_set1_ps(static_cast<float>(minimumX) + 0.5f);
+            const __m256 lastCenterX = _mm256_set1_ps(static_cast<float>(maximumX) + 0.5f);
+
+            __m256 isTopLeftEdge[3]{};
+            for (const uint32_t edge : std::views::iota(0u, 3u))
+            {
+                isTopLeftEdge[edge] = _mm256_castsi256_ps(_mm256_set1_epi32((topLeftEdgeMask >> edge) & 1u ? -1 : 0));
+            }
+
+            alignas(32) std::array<float, 8> laneDepths{};
+
+            for (uint32_t y = minimumY; y <= maximumY; y++)
+            {
+                const float centerY = static_cast<float>(y) + 0.5f;
+
+                __m256 rowEdges[3]{};
+                for (const uint32_t edge : std::views::iota(0u, 3u))
+                {
+                    rowEdges[edge] = _mm256_set1_ps(edgeY[edge] * centerY + edgeOffset[edge]);
+                }
+
+                const __m256 rowDepth = _mm256_set1_ps(depthPlane[1] * centerY + depthPlane[2]);
+
+                const float* const row = depths + static_cast<size_t>(y) * rowPitch;
+
+                for (uint32_t x = minimumX & ~7u; x <= maximumX; x += 8u)
+                {
+                    const __m256 centerX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+
+                    __m256 isInside = _mm256_and_ps(_mm256_cmp_ps(centerX, firstCenterX, _CMP_GE_OQ), _mm256_cmp_ps(centerX, lastCenterX, _CMP_LE_OQ));
+                    for (const uint32_t edge : std::views::iota(0u, 3u))
+                    {
+                        const __m256 edgeValue = _mm256_fmadd_ps(_mm256_set1_ps(edgeX[edge]), centerX, rowEdges[edge]);
+                        const __m256 isEdgeInside = _mm256_or_ps(_mm256_cmp_ps(edgeValue, _mm256_setzero_ps(), _CMP_GT_OQ),
+                                                                 _mm256_and_ps(_mm256_cmp_ps(edgeValue, _mm256_setzero_ps(), _CMP_EQ_OQ), isTopLeftEdge[edge]));
+
+                        isInside = _mm256_and_ps(isInside, isEdgeInside);
+                    }
+
+                    if (_mm256_movemask_ps(isInside) == 0)
+                    {
+                        continue;
+                    }
+
+                    const __m256 depth = _mm256_fmadd_ps(_mm256_set1_ps(depthPlane[0]), centerX, rowDepth);
+                    uint32_t laneMask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(isInside, _mm256_cmp_ps(depth, _mm256_loadu_ps(row + x), _CMP_LT_OQ))));
+
+                    _mm256_store_ps(laneDepths.data(), depth);
+
+                    for (; laneMask != 0u; laneMask &= laneMask - 1u)
+                    {
+                        const uint32_t lane = static_cast<uint32_t>(std::countr_zero(laneMask));
+                        shadePixel(x + lane, y, laneDepths[lane]);
+                    }
+                }
+            }
+        }
+    }
+
+    GoldenImageComparison compareWithGoldenImage(const std::string_view goldenPath,
+                                                 std::span<const uint8_t> pixels,
+                                                 const uint32_t width,
+                                                 const uint32_t height,
+                                                 const uint32_t channelCount,
+                                                 const uint32_t tolerance)
+    {
+        GoldenImageComparison comparison{};
+
+        int goldenWidth{};
+        int goldenHeight{};
+        stbi_uc* const goldenPixels = stbi_load(std::string(goldenPath).c_str(), &goldenWidth, &goldenHeight, nullptr, static_cast<int>(channelCount));
+
+        if (!goldenPixels)
+        {
+            return comparison;
+        }
+
+        if (static_cast<uint32_t>(goldenWidth) == width && static_cast<uint32_t>(goldenHeight) == height)
+        {
+            comparison.isCompared = true;
+
+            for (const size_t pixel : std::views::iota(size_t{0u}, static_cast<size_t>(width) * height))
+            {
+                uint32_t pixelDifference = 0u;
+                for (const size_t channel : std::views::iota(pixel * channelCount, (pixel + 1u) * channelCount))
+                {
+                    pixelDifference = std::max(pixelDifference, static_cast<uint32_t>(std::abs(static_cast<int32_t>(pixels[channel]) - goldenPixels[channel])));
+                }
+
+                comparison.maximumDifference = std::max(comparison.maximumDifference, pixelDifference);
+                comparison.differingPixelCount += pixelDifference > tolerance ? 1u : 0u;
+            }
+        }
+
+        stbi_image_free(goldenPixels);
+
+        return comparison;
+    }
+
+    RasterTexture::RasterTexture(const uint32_t width, const uint32_t height, std::vector<uint8_t> texels, const bool isSrgb)
+        : m_width(width), m_height(height), m_isSrgb(isSrgb), m_texels(std::move(texels))
+    {
+        size_t offset = 0u;
+        for (uint32_t mip = 0u; offset < m_texels.size() / 4u; mip++)
+        {
+            m_mipOffsets.emplace_back(offset);
+            offset += static_cast<size_t>(std::max(width >> mip, 1u)) * std::max(height >> mip, 1u);
+        }
+    }
+
+    math::XMFLOAT4 RasterTexture::sample(const float u, const float v, const float lod) const
+    {
+        const float mipCount = static_cast<float>(getMipCount());
+        const float clampedLod = std::clamp(lod, 0.0f, mipCount - 1.0f);
+
+        const uint32_t mip = static_cast<uint32_t>(clampedLod);
+        const float mipWeight = clampedLod - static_cast<float>(mip);
+
+        const math::XMFLOAT4 sample = sampleMip(u, v, mip);
+        if (mipWeight == 0.0f)
+        {
+            return sample;
+        }
+
+        const math::XMFLOAT4 coarserSample = sampleMip(u, v, mip + 1u);
+
+        return math::XMFLOAT4{
+            sample.x + (coarserSample.x - sample.x) * mipWeight,
+            sample.y + (coarserSample.y - sample.y) * mipWeight,
+            sample.z + (coarserSample.z - sample.z) * mipWeight,
+            sample.w + (coarserSample.w - sample.w) * mipWeight,
+        };
+    }
+
+    math::XMFLOAT4 RasterTexture::sampleMip(const float u, const float v, const uint32_t mip) const
+    {
+        const uint32_t width = std::max(m_width >> mip, 1u);
+        const uint32_t height = std::max(m_height >> mip, 1u);
+
+        // Wrapped to [0, 1) first, so the texel coordinates stay small whatever the texture coordinates.
+        const float x = (u - std::floor(u)) * width - 0.5f;
+        const float y = (v - std::floor(v)) * height - 0.5f;
+
+        const float floorX = std::floor(x);
+        const float floorY = std::floor(y);
+        const float weightX = x - floorX;
+        const float weightY = y - floorY;
+
+        const uint32_t x0 = floorX < 0.0f ? width - 1u : std::min(static_cast<uint32_t>(floorX), width - 1u);
+        const uint32_t y0 = floorY < 0.0f ? height - 1u : std::min(static_cast<uint32_t>(floorY), height - 1u);
+        const uint32_t x1 = x0 + 1u == width ? 0u : x0 + 1u;
+        const uint32_t y1 = y0 + 1u == height ? 0u : y0 + 1u;
+
+        const uint8_t* const texels = m_texels.data() + m_mipOffsets[mip] * 4u;
+        const std::array<const uint8_t*, 4> corners = {
+            texels + (static_cast<size_t>(y0) * width + x0) * 4u,
+            texels + (static_cast<size_t>(y0) * width + x1) * 4u,
+            texels + (static_cast<size_t>(y1) * width + x0) * 4u,
+            texels + (static_cast<size_t>(y1) * width + x1) * 4u,
+        };
+
+        const std::array<float, 4> cornerWeights = {
+            (1.0f - weightX) * (1.0f - weightY),
+            weightX * (1.0f - weightY),
+            (1.0f - weightX) * weightY,
+            weightX * weightY,
+        };
+
+        const std::array<float, 256>& srgbToLinear = getSrgbToLinearTable();
+
+        std::array<float, 4> value{};
+        for (const uint32_t corner : std::views::iota(0u, 4u))
+        {
+            for (const uint32_t channel : std::views::iota(0u, 3u))
+            {
+                const uint8_t texel = corners[corner][channel];
+                value[channel] += cornerWeights[corner] * (m_isSrgb ? srgbToLinear[texel] : texel / 255.0f);
+            }
+
+            value[3] += cornerWeights[corner] * (corners[corner][3] / 255.0f);
+        }
+
+        return math::XMFLOAT4{value[0], value[1], value[2], value[3]};
+    }
+
+    std::optional<RasterTexture> loadCookedRasterTexture(const std::string_view cookedPath, const bool isSrgb)
+    {
+        const std::optional<CookedTextureLayout> layout = readCookedTextureLayout(cookedPath);
+        if (!layout.has_value())
+        {
+            return std::nullopt;
+        }
+
+        const std::vector<std::byte> mipData = readCookedTextureMips(cookedPath, *layout, 0u);
+
+        size_t texelCount = 0u;
+        for (const CookedMipLayout& mip : layout->mips)
+        {
+            texelCount += static_cast<size_t>(mip.width) * mip.height;
+        }
+
+        std::vector<uint8_t> texels(texelCount * 4u);
+
+        size_t texelOffset = 0u;
+        for (const CookedMipLayout& mip : layout->mips)
+        {
+            const size_t mipTexelCount = static_cast<size_t>(mip.width) * mip.height;
+
+            decompressImage(layout->format,
+                            std::span(mipData).subspan(mip.offset - layout->mips[0].offset, mip.size),
+                            mip.width,
+                            mip.height,
+                            std::span(texels).subspan(texelOffset * 4u, mipTexelCount * 4u));
+
+            texelOffset += mipTexelCount;
+        }
+
+        return RasterTexture(layout->width, layout->height, std::move(texels), isSrgb);
+    }
+
+    RasterTexture createRasterTexture(const uint32_t width, const uint32_t height, std::span<const uint8_t> pixels, const bool isSrgb)
+    {
+        std::vector<uint8_t> texels(pixels.begin(), pixels.end());
+
+        const std::array<float, 256>& srgbToLinear = getSrgbToLinearTable();
+
+        uint32_t mipWidth = width;
+        uint32_t mipHeight = height;
+        size_t mipOffset = 0u;
+
+        while (mipWidth > 1u || mipHeight > 1u)
+        {
+            const uint32_t nextWidth = std::max(mipWidth / 2u, 1u);
+            const uint32_t nextHeight = std::max(mipHeight / 2u, 1u);
+            const size_t nextOffset = texels.size();
+
+            texels.resize(nextOffset + static_cast<size_t>(nextWidth) * nextHeight * 4u);
+
+            // Odd sizes drop the last row or column, a side of 1 texel is repeated.
+            for (const uint32_t y : std::views::iota(0u, nextHeight))
+            {
+                for (const uint32_t x : std::views::iota(0u, nextWidth))
+                {
+                    const uint32_t sourceX = std::min(2u * x, mipWidth - 1u);
+                    const uint32_t sourceY = std::min(2u * y, mipHeight - 1u);
+                    const uint32_t nextSourceX = std::min(sourceX + 1u, mipWidth - 1u);
+                    const uint32_t nextSourceY = std::min(sourceY + 1u, mipHeight - 1u);
+
+                    const std::array<size_t, 4> sourceTexels = {
+                        mipOffset + (static_cast<size_t>(sourceY) * mipWidth + sourceX) * 4u,
+                        mipOffset + (static_cast<size_t>(sourceY) * mipWidth + nextSourceX) * 4u,
+                        mipOffset + (static_cast<size_t>(nextSourceY) * mipWidth + sourceX) * 4u,
+                        mipOffset + (static_cast<size_t>(nextSourceY) * mipWidth + nextSourceX) * 4u,
+                    };
+
+                    uint8_t* const texel = texels.data() + nextOffset + (static_cast<size_t>(y) * nextWidth + x) * 4u;
+
+                    for (const uint32_t channel : std::views::iota(0u, 4u))
+                    {
+                        float sum = 0.0f;
+                        for (const size_t sourceTexel : sourceTexels)
+                        {
+                            const uint8_t value = texels[sourceTexel + channel];
+                            sum += isSrgb && channel < 3u ? srgbToLinear[value] : value / 255.0f;
+                        }
+
+                        texel[channel] = isSrgb && channel < 3u ? linearToSrgb(sum * 0.25f) : static_cast<uint8_t>(toUnorm8(sum * 0.25f));
+                    }
+                }
+            }
+
+            mipWidth = nextWidth;
+            mipHeight = nextHeight;
+            mipOffset = nextOffset;
+        }
+
+        return RasterTexture(width, height, std::move(texels), isSrgb);
+    }
+
+    SoftwareRasterizationStats& SoftwareRasterizationStats::operator+=(const SoftwareRasterizationStats& other)
+    {
+        meshCount += other.meshCount;
+        triangleCount += other.triangleCount;
+        rasterizedTriangleCount += other.rasterizedTriangleCount;
+        shadedPixelCount += other.shadedPixelCount;
+        writtenPixelCount += other.writtenPixelCount;
+
+        return *this;
+    }
+
+    void SoftwareRasterizer::resize(const uint32_t width, const uint32_t height)
+    {
+        m_width = width;
+        m_height = height;
+
+        m_tileCountX = (width + TILE_SIZE - 1u) / TILE_SIZE;
+        m_tileCountY = (height + TILE_SIZE - 1u) / TILE_SIZE;
+
+        m_rowPitch = m_tileCountX * TILE_SIZE;
+        m_rowCount = m_tileCountY * TILE_SIZE;
+
+        const size_t pixelCount = static_cast<size_t>(m_rowPitch) * m_rowCount;
+        m_albedos.resize(pixelCount);
+        m_positions.resize(pixelCount);
+        m_normals.resize(pixelCount);
+        m_depths.resize(pixelCount);
+
+        m_tileTriangles.resize(static_cast<size_t>(m_tileCountX) * m_tileCountY);
+        m_tileStats.resize(m_tileTriangles.size());
+    }
+
+    SoftwareRasterizationStats SoftwareRasterizer::render(std::span<const RasterMesh> meshes,
+                                                          const math::XMMATRIX viewMatrix,
+                                                          const math::XMMATRIX projectionMatrix,
+                                                          JobSystem& jobSystem)
+    {
+        m_meshes = meshes;
+
+        const uint32_t meshCount = static_cast<uint32_t>(meshes.size());
+        if (m_meshVertices.size() < meshCount)
+        {
+            m_meshVertices.resize(meshCount);
+            m_meshTriangles.resize(meshCount);
+        }
+
+        JobCounter setupCounter{};
+        jobSystem.parallelFor(
+            meshCount,
+            1u,
+            [&](const uint32_t i)
+            {
+                transformVertices(meshes[i], viewMatrix, projectionMatrix, m_meshVertices[i]);
+                setupTriangles(meshes[i], i, m_meshVertices[i], m_meshTriangles[i]);
+            },
+            setupCounter);
+        jobSystem.wait(setupCounter);
+
+        SoftwareRasterizationStats stats{.meshCount = meshCount};
+
+        for (std::vector<const RasterTriangle*>& tileTriangles : m_tileTriangles)
+        {
+            tileTriangles.clear();
+        }
+
+        for (const uint32_t meshIndex : std::views::iota(0u, meshCount))
+        {
+            stats.triangleCount += meshes[meshIndex].indices.size() / 3u;
+            stats.rasterizedTriangleCount += m_meshTriangles[meshIndex].size();
+
+            for (const RasterTriangle& triangle : m_meshTriangles[meshIndex])
+            {
+                for (uint32_t tileY = triangle.minimumY / TILE_SIZE; tileY <= triangle.maximumY / TILE_SIZE; tileY++)
+                {
+                    for (uint32_t tileX = triangle.minimumX / TILE_SIZE; tileX <= triangle.maximumX / TILE_SIZE; tileX++)
+                    {
+                        m_tileTriangles[tileY * m_tileCountX + tileX].emplace_back(&triangle);
+                    }
+                }
+            }
+        }
+
+        // Every tile is cleared by its own job, including those without triangles.
+        JobCounter tileCounter{};
+        jobSystem.parallelFor(m_tileCountX * m_tileCountY, 1u, [&](const uint32_t tileIndex) { rasterizeTile(tileIndex); }, tileCounter);
+        jobSystem.wait(tileCounter);
+
+        for (const SoftwareRasterizationStats& tileStats : m_tileStats)
+        {
+            stats += tileStats;
+        }
+
+        m_meshes = {};
+
+        return stats;
+    }
+
+    bool SoftwareRasterizer::writePngs(const std::string_view pathPrefix) const
+    {
+        bool isWritten = true;
+
+        for (const PngImage& image : getPngImages())
+        {
+            const std::string path = std::format("{}{}", pathPrefix, image.suffix);
+            const int width = static_cast<int>(m_width);
+
+            isWritten = stbi_write_png(path.c_str(), width, static_cast<int>(m_height), static_cast<int>(image.channelCount), image.pixels.data(), width * static_cast<int>(image.channelCount)) != 0 &&
+                        isWritten;
+        }
+
+        return isWritten;
+    }
+
+    std::array<GoldenImageComparison, 3> SoftwareRasterizer::compareWithGoldenImages(const std::string_view goldenPathPrefix, const uint32_t tolerance) const
+    {
+        std::array<GoldenImageComparison, 3> comparisons{};
+        const std::array<PngImage, 3> images = getPngImages();
+
+        for (const uint32_t i : std::views::iota(0u, 3u))
+        {
+            const PngImage& image = images[i];
+            comparisons[i] = compareWithGoldenImage(std::format("{}{}", goldenPathPrefix, image.suffix), image.pixels, m_width, m_height, image.channelCount, tolerance);
+        }
+
+        return comparisons;
+    }
+
+    std::array<SoftwareRasterizer::PngImage, 3> SoftwareRasterizer::getPngImages() const
+    {
+        const size_t pixelCount = static_cast<size_t>(m_width) * m_height;
+        const auto getIndex = [&](const size_t pixel) { return (pixel / m_width) * m_rowPitch + pixel % m_width; };
+
+        std::array<PngImage, 3> images = {
+            PngImage{.suffix = "_albedo.png", .channelCount = 4u, .pixels = std::vector<uint8_t>(pixelCount * 4u)},
+            PngImage{.suffix = "_normal.png", .channelCount = 3u, .pixels = std::vector<uint8_t>(pixelCount * 3u)},
+            PngImage{.suffix = "_depth.png", .channelCount = 1u, .pixels = std::vector<uint8_t>(pixelCount)},
+        };
+
+        float maximumViewDepth = std::numeric_limits<float>::min();
+        for (const size_t pixel : std::views::iota(size_t{0u}, pixelCount))
+        {
+            if (m_depths[getIndex(pixel)] < 1.0f)
+            {
+                maximumViewDepth = std::max(maximumViewDepth, m_positions[getIndex(pixel)].z);
+            }
+        }
+
+        for (const size_t pixel : std::views::iota(size_t{0u}, pixelCount))
+        {
+            const size_t index = getIndex(pixel);
+
+            // Red in the lowest byte, so the packed albedo is already in RGBA order.
+            std::memcpy(&images[0].pixels[pixel * 4u], &m_albedos[index], sizeof(uint32_t));
+
+            images[1].pixels[pixel * 3u] = static_cast<uint8_t>(toUnorm8(m_normals[index].x * 0.5f + 0.5f));
+            images[1].pixels[pixel * 3u + 1u] = static_cast<uint8_t>(toUnorm8(m_normals[index].y * 0.5f + 0.5f));
+            images[1].pixels[pixel * 3u + 2u] = static_cast<uint8_t>(toUnorm8(m_normals[index].z * 0.5f + 0.5f));
+
+            // Pixels without geometry are as far as the farthest ones.
+            images[2].pixels[pixel] = static_cast<uint8_t>(toUnorm8(m_depths[index] < 1.0f ? m_positions[index].z / maximumViewDepth : 1.0f));
+        }
+
+        return images;
+    }
+
+    void SoftwareRasterizer::transformVertices(const RasterMesh& mesh,
+                                               const math::XMMATRIX viewMatrix,
+                                               const math::XMMATRIX projectionMatrix,
+                                               std::vector<RasterVertex>& outVertices) const
+    {
+        const math::XMMATRIX modelViewMatrix = math::XMMatrixMultiply(mesh.modelMatrix, viewMatrix);
+        const math::XMMATRIX modelViewProjectionMatrix = math::XMMatrixMultiply(modelViewMatrix, projectionMatrix);
+
+        // Normals are transformed by the inverse transpose of the model view matrix, tangents by the matrix itself (as in VsMain).
+        const math::XMMATRIX normalMatrix = math::XMMatrixTranspose(math::XMMatrixInverse(nullptr, modelViewMatrix));
+
+        // Clipped vertices are appended by setupTriangles.
+        outVertices.resize(mesh.vertices.size());
+
+        for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(mesh.vertices.size())))
+        {
+            const ModelVertex& vertex = mesh.vertices[i];
+            RasterVertex& outVertex = outVertices[i];
+
+            const math::XMVECTOR position = math::XMLoadFloat3(&vertex.position);
+            const math::XMVECTOR normal = math::XMLoadFloat3(&vertex.normal);
+            const math::XMVECTOR tangent = math::XMLoadFloat4(&vertex.tangent);
+            const math::XMVECTOR bitangent = math::XMVectorScale(math::XMVector3Cross(normal, tangent), vertex.tangent.w);
+
+            math::XMStoreFloat4(&outVertex.clipPosition, math::XMVector3Transform(position, modelViewProjectionMatrix));
+            outVertex.textureCoord = vertex.textureCoord;
+
+            math::XMStoreFloat3(&outVertex.viewPosition, math::XMVector3Transform(position, modelViewMatrix));
+            math::XMStoreFloat3(&outVertex.viewNormal, math::XMVector3Normalize(math::XMVector3TransformNormal(normal, normalMatrix)));
+            math::XMStoreFloat3(&outVertex.viewTangent, math::XMVector3Normalize(math::XMVector3TransformNormal(tangent, modelViewMatrix)));
+            math::XMStoreFloat3(&outVertex.viewBitangent, math::XMVector3Normalize(math::XMVector3TransformNormal(bitangent, modelViewMatrix)));
+        }
+    }
+
+    void SoftwareRasterizer::setupTriangles(const RasterMesh& mesh, const uint32_t meshIndex, std::vector<RasterVertex>& vertices, std::vector<RasterTriangle>& outTriangles) const
+    {
+        outTriangles.clear();
+
+        const float width = static_cast<float>(m_width);
+        const float height = static_cast<float>(m_height);
+
+        const auto addTriangle = [&](const std::array<uint32_t, 3>& vertexIndices)
+        {
+            std::array<math::XMFLOAT3, 3> screenPositions{};
+            std::array<float, 3> inverseW{};
+
+            for (const uint32_t i : std::views::iota(0u, 3u))
+            {
+                const math::XMFLOAT4& clipPosition = vertices[vertexIndices[i]].clipPosition;
+
+                inverseW[i] = 1.0f / clipPosition.w;
+                screenPositions[i] = math::XMFLOAT3{
+                    (clipPosition.x * inverseW[i] * 0.5f + 0.5f) * width,
+                    (0.5f - clipPosition.y * inverseW[i] * 0.5f) * height,
+                    clipPosition.z * inverseW[i],
+                };
+            }
+
+            const math::XMFLOAT3& v0 = screenPositions[0];
+            const math::XMFLOAT3& v1 = screenPositions[1];
+            const math::XMFLOAT3& v2 = screenPositions[2];
+
+            // Front faces are clockwise on screen (positive here, as y points down), back faces and degenerate triangles are culled.
+            const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+            if (!(area > std::numeric_limits<float>::epsilon()))
+            {
+                return;
+            }
+
+            // Pixels whose center is within the triangle's bounds.
+            const float minimumX = std::ceil(std::min({v0.x, v1.x, v2.x}) - 0.5f);
+            const float minimumY = std::ceil(std::min({v0.y, v1.y, v2.y}) - 0.5f);
+            const float maximumX = std::floor(std::max({v0.x, v1.x, v2.x}) - 0.5f);
+            const float maximumY = std::floor(std::max({v0.y, v1.y, v2.y}) - 0.5f);
+
+            if (maximumX < 0.0f || maximumY < 0.0f || minimumX >= width || minimumY >= height || minimumX > maximumX || minimumY > maximumY)
+            {
+                return;
+            }
+
+            RasterTriangle triangle{
+                .inverseArea = 1.0f / area,
+                .inverseW = inverseW,
+                .minimumX = static_cast<uint32_t>(std::max(minimumX, 0.0f)),
+                .minimumY = static_cast<uint32_t>(std::max(minimumY, 0.0f)),
+                .maximumX = static_cast<uint32_t>(std::min(maximumX, width - 1.0f)),
+                .maximumY = static_cast<uint32_t>(std::min(maximumY, height - 1.0f)),
+                .meshIndex = meshIndex,
+                .vertexIndices = vertexIndices,
+            };
+
+            for (const uint32_t edge : std::views::iota(0u, 3u))
+            {
+                const math::XMFLOAT3& start = screenPositions[edge];
+                const math::XMFLOAT3& end = screenPositions[(edge + 1u) % 3u];
+
+                triangle.edgeX[edge] = start.y - end.y;
+                triangle.edgeY[edge] = end.x - start.x;
+
+                // The offset is computed from the same vertex of an edge whichever way it is traversed, so the triangles sharing it get exactly
+                // opposite edge functions and cover every pixel along it once.
+                const math::XMFLOAT3& origin = std::tie(start.x, start.y) < std::tie(end.x, end.y) ? start : end;
+                triangle.edgeOffset[edge] = -(triangle.edgeX[edge] * origin.x + triangle.edgeY[edge] * origin.y);
+
+                // Left edges go up, top edges go right (along a clockwise triangle).
+                if (triangle.edgeX[edge] > 0.0f || (triangle.edgeX[edge] == 0.0f && triangle.edgeY[edge] > 0.0f))
+                {
+                    triangle.topLeftEdgeMask |= 1u << edge;
+                }
+            }
+
+            triangle.depthX = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+            triangle.depthY = ((v1.x - v0.x) * (v2.z - v0.z) - (v2.x - v0.x) * (v1.z - v0.z)) / area;
+            triangle.depthOffset = v0.z - triangle.depthX * v0.x - triangle.depthY * v0.y;
+
+            outTriangles.emplace_back(triangle);
+        };
+
+        for (uint32_t i = 0u; i + 2u < mesh.indices.size(); i += 3u)
+        {
+            const std::array<uint32_t, 3> vertexIndices = {mesh.indices[i], mesh.indices[i + 1u], mesh.indices[i + 2u]};
+
+            uint32_t insideVertexCount = 0u;
+            for (const uint32_t vertexIndex : vertexIndices)
+            {
+                insideVertexCount += vertices[vertexIndex].clipPosition.z >= 0.0f ? 1u : 0u;
+            }
+
+            if (insideVertexCount == 3u)
+            {
+                addTriangle(vertexIndices);
+                continue;
+            }
+
+            if (insideVertexCount == 0u)
+            {
+                continue;
+            }
+
+            // Clipped against the near plane (clip space z of 0), leaving a triangle or a quad, drawn as a fan. The far plane needs no clipping :
+            // depths beyond it fail the depth test against the cleared depth of 1.
+            std::array<uint32_t, 4> polygon{};
+            uint32_t polygonVertexCount = 0u;
+
+            for (const uint32_t edge : std::views::iota(0u, 3u))
+            {
+                const RasterVertex start = vertices[vertexIndices[edge]];
+                const RasterVertex end = vertices[vertexIndices[(edge + 1u) % 3u]];
+
+                if (start.clipPosition.z >= 0.0f)
+                {
+                    polygon[polygonVertexCount++] = vertexIndices[edge];
+                }
+
+                if ((start.clipPosition.z >= 0.0f) != (end.clipPosition.z >= 0.0f))
+                {
+                    RasterVertex clippedVertex = lerpVertex(start, end, start.clipPosition.z / (start.clipPosition.z - end.clipPosition.z));
+                    clippedVertex.clipPosition.z = std::max(clippedVertex.clipPosition.z, 0.0f);
+
+                    polygon[polygonVertexCount++] = static_cast<uint32_t>(vertices.size());
+                    vertices.emplace_back(clippedVertex);
+                }
+            }
+
+            for (const uint32_t vertex : std::views::iota(2u, polygonVertexCount))
+            {
+                addTriangle({polygon[0], polygon[vertex - 1u], polygon[vertex]});
+            }
+        }
+    }
+
+    void SoftwareRasterizer::rasterizeTile(const uint32_t tileIndex)
+    {
+        const uint32_t tileX = (tileIndex % m_tileCountX) * TILE_SIZE;
+        const uint32_t tileY = (tileIndex / m_tileCountX) * TILE_SIZE;
+
+        // Cleared as the GPU pass clears its targets.
+        for (const uint32_t y : std::views::iota(tileY, tileY + TILE_SIZE))
+        {
+            const size_t rowStart = static_cast<size_t>(y) * m_rowPitch + tileX;
+
+            std::fill_n(m_albedos.begin() + rowStart, TILE_SIZE, 0xff000000u);
+            std::fill_n(m_positions.begin() + rowStart, TILE_SIZE, math::XMFLOAT4{0.0f, 0.0f, 0.0f, 1.0f});
+            std::fill_n(m_normals.begin() + rowStart, TILE_SIZE, math::XMFLOAT4{0.0f, 0.0f, 0.0f, 1.0f});
+            std::fill_n(m_depths.begin() + rowStart, TILE_SIZE, 1.0f);
+        }
+
+        SoftwareRasterizationStats& stats = m_tileStats[tileIndex];
+        stats = {};
+
+        const bool isAvx2Supported = getCpuFeatures().avx2;
+
+        for (const RasterTriangle* const triangle : m_tileTriangles[tileIndex])
+        {
+            const uint32_t minimumX = std::max(triangle->minimumX, tileX);
+            const uint32_t minimumY = std::max(triangle->minimumY, tileY);
+            const uint32_t maximumX = std::min(triangle->maximumX, tileX + TILE_SIZE - 1u);
+            const uint32_t maximumY = std::min(triangle->maximumY, tileY + TILE_SIZE - 1u);
+
+            const std::array<float, 3> depthPlane = {triangle->depthX, triangle->depthY, triangle->depthOffset};
+
+            const auto shadePixel = [&](const uint32_t x, const uint32_t y, const float depth)
+            {
+                stats.shadedPixelCount++;
+                stats.writtenPixelCount += this->shadePixel(*triangle, x, y, depth) ? 1u : 0u;
+            };
+
+            if (isAvx2Supported)
+            {
+                rasterizeTriangleAvx2(triangle->edgeX.data(),
+                                      triangle->edgeY.data(),
+                                      triangle->edgeOffset.data(),
+                                      triangle->topLeftEdgeMask,
+                                      depthPlane,
+                                      m_depths.data(),
+                                      m_rowPitch,
+                                      minimumX,
+                                      minimumY,
+                                      maximumX,
+                                      maximumY,
+                                      shadePixel);
+            }
+            else
+            {
+                rasterizeTriangleSse2(triangle->edgeX.data(),
+                                      triangle->edgeY.data(),
+                                      triangle->edgeOffset.data(),
+                                      triangle->topLeftEdgeMask,
+                                      depthPlane,
+                                      m_depths.data(),
+                                      m_rowPitch,
+                                      minimumX,
+                                      minimumY,
+                                      maximumX,
+                                      maximumY,
+                                      shadePixel);
+            }
+        }
+    }
+
+    bool SoftwareRasterizer::shadePixel(const RasterTriangle& triangle, const uint32_t x, const uint32_t y, const float depth)
+    {
+        const RasterMesh& mesh = m_meshes[triangle.meshIndex];
+        const std::vector<RasterVertex>& meshVertices = m_meshVertices[triangle.meshIndex];
+
+        const std::array<const RasterVertex*, 3> vertices = {
+            &meshVertices[triangle.vertexIndices[0]],
+            &meshVertices[triangle.vertexIndices[1]],
+            &meshVertices[triangle.vertexIndices[2]],
+        };
+
+        const float centerX = static_cast<float>(x) + 0.5f;
+        const float centerY = static_cast<float>(y) + 0.5f;
+
+        // Screen space barycentrics, and their steps to the next pixel in x and y. Vertex i + 2 is opposite edge i, so its barycentric is the
+        // edge function over the triangle's area.
+        std::array<float, 3> barycentrics{};
+        std::array<float, 3> barycentricsDx{};
+        std::array<float, 3> barycentricsDy{};
+
+        for (const uint32_t edge : std::views::iota(0u, 3u))
+        {
+            const uint32_t vertex = (edge + 2u) % 3u;
+
+            barycentrics[vertex] = (triangle.edgeX[edge] * centerX + triangle.edgeY[edge] * centerY + triangle.edgeOffset[edge]) * triangle.inverseArea;
+            barycentricsDx[vertex] = triangle.edgeX[edge] * triangle.inverseArea;
+            barycentricsDy[vertex] = triangle.edgeY[edge] * triangle.inverseArea;
+        }
+
+        // Perspective correct weights : the barycentrics over w, normalized.
+        const auto getWeights = [&](const float offsetX, const float offsetY)
+        {
+            std::array<float, 3> weights{};
+            for (const uint32_t vertex : std::views::iota(0u, 3u))
+            {
+                weights[vertex] = (barycentrics[vertex] + offsetX * barycentricsDx[vertex] + offsetY * barycentricsDy[vertex]) * triangle.inverseW[vertex];
+            }
+
+            const float inverseWeightSum = 1.0f / (weights[0] + weights[1] + weights[2]);
+            for (float& weight : weights)
+            {
+                weight *= inverseWeightSum;
+            }
+
+            return weights;
+        };
+
+        const auto interpolateTextureCoord = [&](const std::array<float, 3>& weights)
+        {
+            math::XMFLOAT2 textureCoord{};
+            for (const uint32_t vertex : std::views::iota(0u, 3u))
+            {
+                textureCoord.x += weights[vertex] * vertices[vertex]->textureCoord.x;
+                textureCoord.y += weights[vertex] * vertices[vertex]->textureCoord.y;
+            }
+
+            return textureCoord;
+        };
+
+        const auto interpolate = [&](const std::array<float, 3>& weights, math::XMFLOAT3 RasterVertex::*attribute)
+        {
+            math::XMVECTOR value = math::XMVectorZero();
+            for (const uint32_t vertex : std::views::iota(0u, 3u))
+            {
+                value = math::XMVectorAdd(value, math::XMVectorScale(math::XMLoadFloat3(&(vertices[vertex]->*attribute)), weights[vertex]));
+            }
+
+            return value;
+        };
+
+        const std::array<float, 3> weights = getWeights(0.0f, 0.0f);
+        const math::XMFLOAT2 textureCoord = interpolateTextureCoord(weights);
+
+        // The texture coordinates of the neighboring pixels give the derivatives the GPU computes within 2x2 quads.
+        math::XMFLOAT2 textureCoordDx{};
+        math::XMFLOAT2 textureCoordDy{};
+
+        if (mesh.albedoTexture || mesh.normalTexture)
+        {
+            const math::XMFLOAT2 nextTextureCoordX = interpolateTextureCoord(getWeights(1.0f, 0.0f));
+            const math::XMFLOAT2 nextTextureCoordY = interpolateTextureCoord(getWeights(0.0f, 1.0f));
+
+            textureCoordDx = math::XMFLOAT2{nextTextureCoordX.x - textureCoord.x, nextTextureCoordX.y - textureCoord.y};
+            textureCoordDy = math::XMFLOAT2{nextTextureCoordY.x - textureCoord.x, nextTextureCoordY.y - textureCoord.y};
+        }
+
+        math::XMFLOAT4 albedo{1.0f, 1.0f, 1.0f, 1.0f};
+        if (mesh.albedoTexture)
+        {
+            albedo = mesh.albedoTexture->sample(textureCoord.x, textureCoord.y, computeLod(*mesh.albedoTexture, textureCoordDx, textureCoordDy));
+            if (albedo.w < 0.2f)
+            {
+                return false;
+            }
+        }
+
+        const math::XMVECTOR vertexNormal = interpolate(weights, &RasterVertex::viewNormal);
+        math::XMVECTOR normal = math::XMVector3Normalize(vertexNormal);
+
+        if (mesh.normalTexture)
+        {
+            // Normal maps are cooked to BC5, which only stores x and y.
+            const math::XMFLOAT4 normalSample = mesh.normalTexture->sample(textureCoord.x, textureCoord.y, computeLod(*mesh.normalTexture, textureCoordDx, textureCoordDy));
+
+            const float normalX = 2.0f * normalSample.x - 1.0f;
+            const float normalY = 2.0f * normalSample.y - 1.0f;
+            const float normalZ = std::sqrt(std::clamp(1.0f - normalX * normalX - normalY * normalY, 0.0f, 1.0f));
+
+            // The rows of the tangent basis are interpolated without being normalized, as in PsMain.
+            normal = math::XMVectorAdd(math::XMVectorScale(interpolate(weights, &RasterVertex::viewTangent), normalX),
+                                       math::XMVectorScale(interpolate(weights, &RasterVertex::viewBitangent), normalY));
+            normal = math::XMVector3Normalize(math::XMVectorAdd(normal, math::XMVectorScale(vertexNormal, normalZ)));
+        }
+
+        const size_t index = static_cast<size_t>(y) * m_rowPitch + x;
+
+        m_depths[index] = depth;
+        m_albedos[index] = toUnorm8(albedo.x) | toUnorm8(albedo.y) << 8u | toUnorm8(albedo.z) << 16u | toUnorm8(albedo.w) << 24u;
+
+        math::XMStoreFloat4(&m_positions[index], math::XMVectorSetW(interpolate(weights, &RasterVertex::viewPosition), 1.0f));
+        math::XMStoreFloat4(&m_normals[index], math::XMVectorSetW(normal, 1.0f));
+
+        return true;
+    }
+}
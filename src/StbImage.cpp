@@ -0,0 +1,7 @@
+#include "Pch.hpp"
+
+// stb_image and stb_image_write are shared by model loading, texture cooking and the software passes.
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image.h>
+#include <stb_image_write.h>
@@ -0,0 +1,190 @@
+#include "Pch.hpp"
+
+#include "TangentGeneration.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        // Position, normal and texture coordinate bits, plus the texture space orientation the vertex is used with.
+        struct VertexKey
+        {
+            std::array<uint32_t, 8u> bits{};
+            int32_t orientation{};
+
+            bool operator==(const VertexKey& other) const = default;
+        };
+
+        struct VertexKeyHash
+        {
+            size_t operator()(const VertexKey& key) const
+            {
+                return static_cast<size_t>(hashCombine(hashBytes(std::as_bytes(std::span(key.bits))), static_cast<uint64_t>(key.orientation + 1)));
+            }
+        };
+
+        // Maps every vertex to the first vertex with identical attributes and orientation, so duplicated vertices share a single tangent.
+        std::vector<uint32_t> getAttributeRemap(std::span<const ModelVertex> vertices, std::span<const int8_t> vertexOrientations)
+        {
+            std::unordered_map<VertexKey, uint32_t, VertexKeyHash> firstVertices{};
+            firstVertices.reserve(vertices.size());
+
+            std::vector<uint32_t> attributeRemap(vertices.size());
+
+            for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(vertices.size())))
+            {
+                const ModelVertex& vertex = vertices[i];
+
+                const VertexKey key{
+                    .bits =
+                        {
+                            std::bit_cast<uint32_t>(vertex.position.x),
+                            std::bit_cast<uint32_t>(vertex.position.y),
+                            std::bit_cast<uint32_t>(vertex.position.z),
+                            std::bit_cast<uint32_t>(vertex.normal.x),
+                            std::bit_cast<uint32_t>(vertex.normal.y),
+                            std::bit_cast<uint32_t>(vertex.normal.z),
+                            std::bit_cast<uint32_t>(vertex.textureCoord.x),
+                            std::bit_cast<uint32_t>(vertex.textureCoord.y),
+                        },
+                    .orientation = vertexOrientations[i],
+                };
+
+                attributeRemap[i] = firstVertices.try_emplace(key, i).first->second;
+            }
+
+            return attributeRemap;
+        }
+
+        // Removes the component along the (unit) normal, returns zero if nothing is left.
+        math::XMVECTOR projectOntoTangentPlane(const math::XMVECTOR vector, const math::XMVECTOR normal)
+        {
+            const math::XMVECTOR projected = math::XMVectorSubtract(vector, math::XMVectorMultiply(normal, math::XMVector3Dot(normal, vector)));
+            const float length = math::XMVectorGetX(math::XMVector3Length(projected));
+
+            return length > std::numeric_limits<float>::epsilon() ? math::XMVectorScale(projected, 1.0f / length) : math::XMVectorZero();
+        }
+
+        math::XMVECTOR loadNormal(const ModelVertex& vertex) { return math::XMVector3Normalize(math::XMLoadFloat3(&vertex.normal)); }
+    }
+
+    void computeTangents(std::vector<ModelVertex>& vertices, std::span<uint32_t> indices)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3u);
+
+        // Unnormalized tangent of every triangle and the sign of its texture space area (0 for triangles without a usable texture mapping).
+        std::vector<math::XMFLOAT3> triangleTangents(triangleCount);
+        std::vector<int8_t> triangleOrientations(triangleCount, 0);
+
+        for (const uint32_t triangle : std::views::iota(0u, triangleCount))
+        {
+            const ModelVertex& v0 = vertices[indices[triangle * 3u + 0u]];
+            const ModelVertex& v1 = vertices[indices[triangle * 3u + 1u]];
+            const ModelVertex& v2 = vertices[indices[triangle * 3u + 2u]];
+
+            const math::XMVECTOR edge1 = math::XMVectorSubtract(math::XMLoadFloat3(&v1.position), math::XMLoadFloat3(&v0.position));
+            const math::XMVECTOR edge2 = math::XMVectorSubtract(math::XMLoadFloat3(&v2.position), math::XMLoadFloat3(&v0.position));
+
+            // glTF texture coordinates have their origin at the top left, v is flipped so the bitangent points up the normal map.
+            const float s1 = v1.textureCoord.x - v0.textureCoord.x;
+            const float t1 = v0.textureCoord.y - v1.textureCoord.y;
+            const float s2 = v2.textureCoord.x - v0.textureCoord.x;
+            const float t2 = v0.textureCoord.y - v2.textureCoord.y;
+
+            // edge = tangent * s + bitangent * t, solved for the tangent up to the (signed) area.
+            const float signedArea = s1 * t2 - s2 * t1;
+            const math::XMVECTOR tangent = math::XMVectorSubtract(math::XMVectorScale(edge1, t2), math::XMVectorScale(edge2, t1));
+
+            if (signedArea == 0.0f || math::XMVectorGetX(math::XMVector3LengthSq(tangent)) == 0.0f)
+            {
+                continue;
+            }
+
+            math::XMStoreFloat3(&triangleTangents[triangle], math::XMVectorScale(tangent, signedArea > 0.0f ? 1.0f : -1.0f));
+            triangleOrientations[triangle] = signedArea > 0.0f ? 1 : -1;
+        }
+
+        // Split vertices used with both orientations, triangles of the second orientation seen get a copy of the vertex.
+        std::vector<int8_t> vertexOrientations(vertices.size(), 0);
+        std::vector<uint32_t> mirroredVertices(vertices.size(), INVALID_INDEX_U32);
+
+        for (const uint32_t triangle : std::views::iota(0u, triangleCount))
+        {
+            const int8_t orientation = triangleOrientations[triangle];
+            if (orientation == 0)
+            {
+                continue;
+            }
+
+            for (const uint32_t corner : std::views::iota(triangle * 3u, triangle * 3u + 3u))
+            {
+                const uint32_t vertexIndex = indices[corner];
+
+                if (vertexOrientations[vertexIndex] == 0)
+                {
+                    vertexOrientations[vertexIndex] = orientation;
+                }
+                else if (vertexOrientations[vertexIndex] != orientation)
+                {
+                    if (mirroredVertices[vertexIndex] == INVALID_INDEX_U32)
+                    {
+                        const ModelVertex vertex = vertices[vertexIndex];
+
+                        mirroredVertices[vertexIndex] = static_cast<uint32_t>(vertices.size());
+                        vertices.emplace_back(vertex);
+                        vertexOrientations.emplace_back(orientation);
+                    }
+
+                    indices[corner] = mirroredVertices[vertexIndex];
+                }
+            }
+        }
+
+        // Accumulate the per triangle tangents, projected onto each corner's tangent plane and weighted by the corner angle.
+        const std::vector<uint32_t> attributeRemap = getAttributeRemap(vertices, vertexOrientations);
+        std::vector<math::XMFLOAT3> tangentSums(vertices.size(), math::XMFLOAT3{0.0f, 0.0f, 0.0f});
+
+        for (const uint32_t triangle : std::views::iota(0u, triangleCount))
+        {
+            if (triangleOrientations[triangle] == 0)
+            {
+                continue;
+            }
+
+            const math::XMVECTOR triangleTangent = math::XMLoadFloat3(&triangleTangents[triangle]);
+
+            for (const uint32_t corner : std::views::iota(0u, 3u))
+            {
+                const uint32_t vertexIndex = indices[triangle * 3u + corner];
+                const math::XMVECTOR normal = loadNormal(vertices[vertexIndex]);
+
+                const math::XMVECTOR position = math::XMLoadFloat3(&vertices[vertexIndex].position);
+                const math::XMVECTOR edge1 = math::XMVectorSubtract(math::XMLoadFloat3(&vertices[indices[triangle * 3u + (corner + 1u) % 3u]].position), position);
+                const math::XMVECTOR edge2 = math::XMVectorSubtract(math::XMLoadFloat3(&vertices[indices[triangle * 3u + (corner + 2u) % 3u]].position), position);
+
+                const float cosine = math::XMVectorGetX(math::XMVector3Dot(projectOntoTangentPlane(edge1, normal), projectOntoTangentPlane(edge2, normal)));
+                const float angle = std::acos(std::clamp(cosine, -1.0f, 1.0f));
+
+                math::XMFLOAT3& tangentSum = tangentSums[attributeRemap[vertexIndex]];
+                math::XMStoreFloat3(&tangentSum,
+                                    math::XMVectorAdd(math::XMLoadFloat3(&tangentSum), math::XMVectorScale(projectOntoTangentPlane(triangleTangent, normal), angle)));
+            }
+        }
+
+        for (const uint32_t vertexIndex : std::views::iota(0u, static_cast<uint32_t>(vertices.size())))
+        {
+            ModelVertex& vertex = vertices[vertexIndex];
+            const math::XMVECTOR normal = loadNormal(vertex);
+
+            math::XMVECTOR tangent = projectOntoTangentPlane(math::XMLoadFloat3(&tangentSums[attributeRemap[vertexIndex]]), normal);
+
+            // Vertices only used by triangles without a texture mapping get an arbitrary tangent, it just has to be orthogonal to the normal.
+            if (math::XMVector3Equal(tangent, math::XMVectorZero()))
+            {
+                tangent = projectOntoTangentPlane(std::abs(vertex.normal.x) < 0.9f ? math::g_XMIdentityR0 : math::g_XMIdentityR1, normal);
+            }
+
+            math::XMStoreFloat4(&vertex.tangent, math::XMVectorSetW(tangent, vertexOrientations[vertexIndex] < 0 ? -1.0f : 1.0f));
+        }
+    }
+}
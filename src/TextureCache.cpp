@@ -0,0 +1,357 @@
+#include "Pch.hpp"
+
+#include "TextureCache.hpp"
+
+namespace sgfx
+{
+    namespace
+    {
+        // Paths differing only in separators or "." / ".." components refer to the same image, and so do paths differing only in case on
+        // Windows, whose file system is case insensitive. Only used as a cache key, images are loaded from the path they were requested with.
+        std::string normalizePath(const std::string_view path)
+        {
+            std::string normalizedPath = std::filesystem::path(path).lexically_normal().generic_string();
+#ifdef _WIN32
+            std::ranges::transform(normalizedPath, normalizedPath.begin(), [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+#endif
+
+            return normalizedPath;
+        }
+
+        TextureFormat getTextureFormat(const BlockFormat format, const bool isSrgb)
+        {
+            switch (format)
+            {
+                case BlockFormat::BC1: return isSrgb ? TextureFormat::BC1UnormSrgb : TextureFormat::BC1Unorm;
+                case BlockFormat::BC3: return isSrgb ? TextureFormat::BC3UnormSrgb : TextureFormat::BC3Unorm;
+                case BlockFormat::BC4: return TextureFormat::BC4Unorm;
+                case BlockFormat::BC5: return TextureFormat::BC5Unorm;
+                case BlockFormat::BC7: return isSrgb ? TextureFormat::BC7UnormSrgb : TextureFormat::BC7Unorm;
+            }
+
+            return TextureFormat::BC1Unorm;
+        }
+    }
+
+    size_t TextureCache::KeyHash::operator()(const Key& key) const { return static_cast<size_t>(hashCombine(std::hash<std::string>{}(key.path), enumClassValue(key.usage))); }
+
+    TextureCache::TextureCache(RenderBackend& renderBackend, JobSystem& jobSystem, const TextureStreamerCreationDesc& streamerCreationDesc)
+        : m_renderBackend(&renderBackend), m_jobSystem(&jobSystem), m_streamer(streamerCreationDesc)
+    {
+    }
+
+    // Streaming jobs refer to the cache, so they have to complete first.
+    TextureCache::~TextureCache() { m_jobSystem->wait(m_streamingCounter); }
+
+    TextureHandle TextureCache::getTexture(const std::string_view path, const TextureUsage usage)
+    {
+        const Key key{
+            .path = normalizePath(path),
+            .usage = usage,
+        };
+
+        std::promise<TextureHandle> loadPromise{};
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stats.requestCount++;
+
+            Entry& entry = m_entries[key];
+
+            if (TextureHandle texture = entry.texture.lock())
+            {
+                m_stats.hitCount++;
+                m_stats.bytesSaved += texture->sizeInBytes;
+
+                return texture;
+            }
+
+            if (entry.pendingLoad.valid())
+            {
+                const std::shared_future<TextureHandle> pendingLoad = entry.pendingLoad;
+                m_stats.inFlightHitCount++;
+
+                lock.unlock();
+
+                // The loading thread is already decoding the image, so this never waits on a job that has not started.
+                TextureHandle texture = pendingLoad.get();
+
+                lock.lock();
+                m_stats.bytesSaved += texture->sizeInBytes;
+
+                return texture;
+            }
+
+            entry.pendingLoad = loadPromise.get_future().share();
+        }
+
+        TextureHandle texture{};
+
+        try
+        {
+            texture = loadTexture(std::string(path), usage);
+        }
+        catch (...)
+        {
+            {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                m_entries[key].pendingLoad = {};
+            }
+
+            loadPromise.set_exception(std::current_exception());
+            throw;
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+
+            Entry& entry = m_entries[key];
+            entry.texture = texture;
+            entry.pendingLoad = {};
+        }
+
+        loadPromise.set_value(texture);
+
+        return texture;
+    }
+
+    void TextureCache::requestTextureLod(const Texture& texture, const float lod)
+    {
+        if (texture.streamingId == INVALID_INDEX_U32)
+        {
+            return;
+        }
+
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_streamer.requestMip(texture.streamingId, static_cast<uint32_t>(std::max(lod, 0.0f)));
+    }
+
+    void TextureCache::updateStreaming()
+    {
+        std::vector<TextureStreamingRequest> requests{};
+        std::vector<std::pair<std::string, std::shared_ptr<const CookedTextureLayout>>> requestSources{};
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (StreamingLoad& load : m_completedStreamingLoads)
+            {
+                const std::shared_ptr<Texture> texture = m_streamedTextures[load.textureId].texture.lock();
+
+                if (texture && load.resource)
+                {
+                    texture->resource = std::move(load.resource);
+                    texture->sizeInBytes = load.sizeInBytes;
+
+                    m_streamer.completeRequest(load.textureId, load.firstMip);
+                }
+                else
+                {
+                    m_streamer.completeRequest(load.textureId, m_streamer.getResidentMip(load.textureId));
+                }
+            }
+
+            m_completedStreamingLoads.clear();
+
+            // Textures whose last handle was released are no longer streamed.
+            for (const uint32_t textureId : std::views::iota(0u, static_cast<uint32_t>(m_streamedTextures.size())))
+            {
+                StreamedTexture& streamedTexture = m_streamedTextures[textureId];
+                if (streamedTexture.layout && streamedTexture.texture.expired())
+                {
+                    m_streamer.removeTexture(textureId);
+                    streamedTexture = {};
+                }
+            }
+
+            requests = m_streamer.update();
+
+            for (const TextureStreamingRequest& request : requests)
+            {
+                requestSources.emplace_back(m_streamedTextures[request.textureId].cookedPath, m_streamedTextures[request.textureId].layout);
+            }
+        }
+
+        for (const size_t index : std::views::iota(0u, requests.size()))
+        {
+            m_jobSystem->submit(
+                [this, request = requests[index], source = std::move(requestSources[index])]()
+                {
+                    StreamingLoad load{
+                        .textureId = request.textureId,
+                        .firstMip = request.firstMip,
+                    };
+
+                    // Both loading and evicting mips create a new texture from the mips that remain, the old one is released when swapped.
+                    try
+                    {
+                        const std::vector<std::byte> mipData = readCookedTextureMips(source.first, *source.second, request.firstMip);
+
+                        load.resource = createStreamedTexture(*source.second, request.firstMip, mipData);
+                        load.sizeInBytes = mipData.size();
+                    }
+                    catch (const std::exception& exception)
+                    {
+                        std::cout << "Failed to stream texture " << source.first << " : " << exception.what() << '\n';
+                    }
+
+                    const std::lock_guard<std::mutex> lock(m_mutex);
+                    m_completedStreamingLoads.emplace_back(std::move(load));
+                },
+                m_streamingCounter);
+        }
+    }
+
+    TextureCacheStats TextureCache::getStats() const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        TextureCacheStats stats = m_stats;
+        stats.streaming = m_streamer.getStats();
+
+        for (const auto& [key, entry] : m_entries)
+        {
+            if (const TextureHandle texture = entry.texture.lock())
+            {
+                stats.residentTextureCount++;
+                stats.residentBytes += texture->sizeInBytes;
+            }
+        }
+
+        return stats;
+    }
+
+    TextureHandle TextureCache::loadTexture(const std::string& path, const TextureUsage usage)
+    {
+        const std::string cookedPath = getCookedTexturePath(path, usage);
+
+        if (!isCookedTextureUpToDate(path, cookedPath))
+        {
+            const std::optional<CookedTextureInfo> cookedTexture = cookTexture(*m_jobSystem, path, usage, cookedPath);
+            if (!cookedTexture.has_value())
+            {
+                {
+                    const std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stats.uncompressedTextureCount++;
+                }
+
+                return loadUncompressedTexture(path, usage);
+            }
+
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.cookedTextureCount++;
+            m_stats.cookedBytes += cookedTexture->sizeInBytes;
+            m_stats.cookTimeMs += cookedTexture->cookTimeMs;
+            m_stats.lowestCookedPsnr = std::min(m_stats.lowestCookedPsnr, cookedTexture->psnr);
+        }
+
+        std::optional<CookedTextureLayout> layout = readCookedTextureLayout(cookedPath);
+        if (!layout.has_value())
+        {
+            std::cout << "Failed to load cooked texture from path : " << cookedPath << '\n';
+            throw std::runtime_error("Texture Loading Error");
+        }
+
+        return loadStreamedTexture(cookedPath, std::make_shared<const CookedTextureLayout>(std::move(*layout)));
+    }
+
+    TextureHandle TextureCache::loadStreamedTexture(const std::string& cookedPath, std::shared_ptr<const CookedTextureLayout> layout)
+    {
+        std::vector<uint64_t> mipSizes{};
+        std::ranges::transform(layout->mips, std::back_inserter(mipSizes), [](const CookedMipLayout& mip) { return mip.size; });
+
+        // The first mip of a block compressed texture must be made of whole blocks.
+        uint32_t maxFirstMip = 0u;
+        while (maxFirstMip + 1u < layout->mips.size() && layout->mips[maxFirstMip + 1u].width % BLOCK_WIDTH == 0u && layout->mips[maxFirstMip + 1u].height % BLOCK_WIDTH == 0u)
+        {
+            maxFirstMip++;
+        }
+
+        uint32_t streamingId{};
+        uint32_t mipTailFirstMip{};
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+
+            streamingId = m_streamer.addTexture(StreamedTextureDesc{
+                .mipSizes = mipSizes,
+                .width = layout->width,
+                .height = layout->height,
+                .maxFirstMip = maxFirstMip,
+            });
+
+            mipTailFirstMip = m_streamer.getMipTailFirstMip(streamingId);
+        }
+
+        // Backends create textures from any thread, so they are created without holding the cache lock.
+        const auto texture = std::make_shared<Texture>(Texture{
+            .width = layout->width,
+            .height = layout->height,
+            .streamingId = streamingId,
+        });
+
+        try
+        {
+            const std::vector<std::byte> mipData = readCookedTextureMips(cookedPath, *layout, mipTailFirstMip);
+
+            texture->resource = createStreamedTexture(*layout, mipTailFirstMip, mipData);
+            texture->sizeInBytes = mipData.size();
+        }
+        catch (...)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_streamer.removeTexture(streamingId);
+            throw;
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (streamingId >= m_streamedTextures.size())
+            {
+                m_streamedTextures.resize(streamingId + 1u);
+            }
+
+            m_streamedTextures[streamingId] = StreamedTexture{
+                .texture = texture,
+                .cookedPath = cookedPath,
+                .layout = std::move(layout),
+            };
+        }
+
+        return texture;
+    }
+
+    BackendResource TextureCache::createStreamedTexture(const CookedTextureLayout& layout, const uint32_t firstMip, std::span<const std::byte> mipData) const
+    {
+        // The mips of the file are tightly packed rows of blocks, as the backend expects them.
+        const BackendTextureDesc textureDesc = {
+            .width = layout.mips[firstMip].width,
+            .height = layout.mips[firstMip].height,
+            .format = getTextureFormat(layout.format, layout.isSrgb),
+            .mipCount = static_cast<uint32_t>(layout.mips.size()) - firstMip,
+        };
+
+        return BackendResource(*m_renderBackend, m_renderBackend->createTexture(textureDesc, mipData));
+    }
+
+    TextureHandle TextureCache::loadUncompressedTexture(const std::string& path, const TextureUsage usage) const
+    {
+        const UncompressedTexture uncompressedTexture = decodeUncompressedTexture(path, usage);
+
+        const BackendTextureDesc textureDesc = {
+            .width = uncompressedTexture.width,
+            .height = uncompressedTexture.height,
+            .format = isSrgbTextureUsage(usage) ? TextureFormat::R8G8B8A8UnormSrgb : TextureFormat::R8G8B8A8Unorm,
+            .mipCount = uncompressedTexture.mipCount,
+        };
+
+        // Backends create textures from any thread, so they are created without holding the cache lock.
+        return std::make_shared<const Texture>(Texture{
+            .resource = BackendResource(*m_renderBackend, m_renderBackend->createTexture(textureDesc, uncompressedTexture.pixels)),
+            .sizeInBytes = uncompressedTexture.pixels.size(),
+            .width = uncompressedTexture.width,
+            .height = uncompressedTexture.height,
+        });
+    }
+}
@@ -0,0 +1,571 @@
+#include "Pch.hpp"
+
+#include "TextureCooker.hpp"
+
+#include "JobSystem.hpp"
+
+#include <stb_image.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        constexpr uint32_t COOKED_TEXTURE_MAGIC = 0x54584653u; // 'SFXT'.
+        constexpr uint32_t COOKED_TEXTURE_VERSION = 1u;
+
+        // DDS file layout, see https://learn.microsoft.com/en-us/windows/win32/direct3ddds/dds-header.
+        // Written by hand (rather than with DirectXTex) so the cooker does not depend on Windows.
+        constexpr uint32_t DDS_MAGIC = 0x20534444u; // 'DDS '.
+        constexpr uint32_t DDS_FOURCC_DX10 = 0x30315844u; // 'DX10'.
+
+        constexpr uint32_t DDSD_CAPS = 0x1u;
+        constexpr uint32_t DDSD_HEIGHT = 0x2u;
+        constexpr uint32_t DDSD_WIDTH = 0x4u;
+        constexpr uint32_t DDSD_PIXELFORMAT = 0x1000u;
+        constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000u;
+        constexpr uint32_t DDSD_LINEARSIZE = 0x80000u;
+
+        constexpr uint32_t DDPF_FOURCC = 0x4u;
+
+        constexpr uint32_t DDSCAPS_COMPLEX = 0x8u;
+        constexpr uint32_t DDSCAPS_TEXTURE = 0x1000u;
+        constexpr uint32_t DDSCAPS_MIPMAP = 0x400000u;
+
+        constexpr uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3u;
+
+        struct DdsPixelFormat
+        {
+            uint32_t size{sizeof(DdsPixelFormat)};
+            uint32_t flags{};
+            uint32_t fourCC{};
+            uint32_t rgbBitCount{};
+            uint32_t redBitMask{};
+            uint32_t greenBitMask{};
+            uint32_t blueBitMask{};
+            uint32_t alphaBitMask{};
+        };
+
+        // The reserved words hold the cooker magic and version, and the hash of the source image.
+        struct DdsHeader
+        {
+            uint32_t magic{DDS_MAGIC};
+            uint32_t size{124u};
+            uint32_t flags{};
+            uint32_t height{};
+            uint32_t width{};
+            uint32_t pitchOrLinearSize{};
+            uint32_t depth{};
+            uint32_t mipMapCount{};
+            uint32_t cookerMagic{};
+            uint32_t cookerVersion{};
+            std::array<uint32_t, 2u> sourceHash{};
+            std::array<uint32_t, 7u> reserved{};
+            DdsPixelFormat pixelFormat{};
+            uint32_t caps{};
+            uint32_t caps2{};
+            uint32_t caps3{};
+            uint32_t caps4{};
+            uint32_t reserved2{};
+            uint32_t dxgiFormat{};
+            uint32_t resourceDimension{};
+            uint32_t miscFlag{};
+            uint32_t arraySize{};
+            uint32_t miscFlags2{};
+        };
+
+        static_assert(sizeof(DdsHeader) == 4u + 124u + 20u);
+
+        uint32_t getDxgiFormat(const BlockFormat format, const bool isSrgb)
+        {
+            switch (format)
+            {
+                case BlockFormat::BC1:
+                    return isSrgb ? 72u : 71u;
+                case BlockFormat::BC3:
+                    return isSrgb ? 78u : 77u;
+                case BlockFormat::BC4:
+                    return 80u;
+                case BlockFormat::BC5:
+                    return 83u;
+                case BlockFormat::BC7:
+                    return isSrgb ? 99u : 98u;
+            }
+
+            return 0u;
+        }
+
+        std::string_view getTextureUsageName(const TextureUsage usage)
+        {
+            switch (usage)
+            {
+                case TextureUsage::Albedo:
+                    return "albedo";
+                case TextureUsage::Normal:
+                    return "normal";
+                case TextureUsage::Occlusion:
+                    return "occlusion";
+                case TextureUsage::MetalRoughness:
+                    return "metalroughness";
+                case TextureUsage::Emissive:
+                    return "emissive";
+            }
+
+            return "unknown";
+        }
+
+        // Only accepts files written by the current cooker version.
+        std::optional<DdsHeader> readDdsHeader(const std::string_view cookedPath)
+        {
+            DdsHeader header{};
+
+            std::ifstream file(std::filesystem::path(cookedPath), std::ios::binary);
+            if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(DdsHeader)))
+            {
+                return std::nullopt;
+            }
+
+            if (header.magic != DDS_MAGIC || header.cookerMagic != COOKED_TEXTURE_MAGIC || header.cookerVersion != COOKED_TEXTURE_VERSION)
+            {
+                return std::nullopt;
+            }
+
+            return header;
+        }
+
+        std::vector<std::byte> readFile(const std::filesystem::path& path)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+            {
+                return {};
+            }
+
+            std::vector<std::byte> data(static_cast<size_t>(file.tellg()));
+
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+            return data;
+        }
+
+        // Filtering happens on floats : linear color for sRGB usages, unit vectors in [-1, 1] for normal maps and [0, 1] otherwise.
+        struct MipLevel
+        {
+            uint32_t width{};
+            uint32_t height{};
+
+            std::vector<float> values{};
+            std::vector<uint8_t> pixels{};
+            std::vector<std::byte> blocks{};
+        };
+
+        float srgbToLinear(const float value) { return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f); }
+        float linearToSrgb(const float value) { return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f; }
+
+        void normalizeNormals(std::span<float> values)
+        {
+            for (size_t i = 0u; i < values.size(); i += 4u)
+            {
+                const float length = std::sqrt(values[i] * values[i] + values[i + 1u] * values[i + 1u] + values[i + 2u] * values[i + 2u]);
+                if (length > std::numeric_limits<float>::epsilon())
+                {
+                    values[i] /= length;
+                    values[i + 1u] /= length;
+                    values[i + 2u] /= length;
+                }
+            }
+        }
+
+        std::vector<float> decodeValues(std::span<const uint8_t> pixels, const TextureUsage usage)
+        {
+            std::array<float, 256u> colorTable{};
+            for (const uint32_t i : std::views::iota(0u, 256u))
+            {
+                const float value = static_cast<float>(i) / 255.0f;
+                colorTable[i] = isSrgbTextureUsage(usage) ? srgbToLinear(value) : usage == TextureUsage::Normal ? value * 2.0f - 1.0f : value;
+            }
+
+            std::vector<float> values(pixels.size());
+            for (const size_t i : std::views::iota(0u, pixels.size()))
+            {
+                values[i] = i % 4u == 3u ? static_cast<float>(pixels[i]) / 255.0f : colorTable[pixels[i]];
+            }
+
+            if (usage == TextureUsage::Normal)
+            {
+                normalizeNormals(values);
+            }
+
+            return values;
+        }
+
+        std::vector<uint8_t> encodeValues(std::span<const float> values, const TextureUsage usage)
+        {
+            std::vector<uint8_t> pixels(values.size());
+            for (const size_t i : std::views::iota(0u, values.size()))
+            {
+                float value = values[i];
+                if (i % 4u != 3u)
+                {
+                    value = isSrgbTextureUsage(usage) ? linearToSrgb(std::clamp(value, 0.0f, 1.0f)) : usage == TextureUsage::Normal ? value * 0.5f + 0.5f : value;
+                }
+
+                pixels[i] = static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+            }
+
+            return pixels;
+        }
+
+        // 2x2 box filter, odd dimensions repeat the last row / column.
+        MipLevel downsample(const MipLevel& source, const TextureUsage usage)
+        {
+            MipLevel destination{
+                .width = std::max(source.width / 2u, 1u),
+                .height = std::max(source.height / 2u, 1u),
+            };
+
+            destination.values.resize(static_cast<size_t>(destination.width) * destination.height * 4u);
+
+            for (const uint32_t y : std::views::iota(0u, destination.height))
+            {
+                const uint32_t y0 = std::min(y * 2u, source.height - 1u);
+                const uint32_t y1 = std::min(y * 2u + 1u, source.height - 1u);
+
+                for (const uint32_t x : std::views::iota(0u, destination.width))
+                {
+                    const uint32_t x0 = std::min(x * 2u, source.width - 1u);
+                    const uint32_t x1 = std::min(x * 2u + 1u, source.width - 1u);
+
+                    for (const uint32_t channel : std::views::iota(0u, 4u))
+                    {
+                        const auto sample = [&](const uint32_t sampleX, const uint32_t sampleY) { return source.values[(static_cast<size_t>(sampleY) * source.width + sampleX) * 4u + channel]; };
+
+                        destination.values[(static_cast<size_t>(y) * destination.width + x) * 4u + channel] = (sample(x0, y0) + sample(x1, y0) + sample(x0, y1) + sample(x1, y1)) * 0.25f;
+                    }
+                }
+            }
+
+            if (usage == TextureUsage::Normal)
+            {
+                normalizeNormals(destination.values);
+            }
+
+            return destination;
+        }
+
+        // Throws if the image cannot be decoded.
+        MipLevel decodeImage(const std::string_view sourcePath, std::span<const std::byte> sourceData)
+        {
+            int32_t width{};
+            int32_t height{};
+            int32_t channelCount{};
+            uint8_t* const sourcePixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(sourceData.data()), static_cast<int32_t>(sourceData.size()), &width, &height, &channelCount, 4);
+            if (!sourcePixels)
+            {
+                fatalError(std::format("Failed to decode texture : {}.", sourcePath));
+            }
+
+            MipLevel mip{
+                .width = static_cast<uint32_t>(width),
+                .height = static_cast<uint32_t>(height),
+                .pixels = std::vector<uint8_t>(sourcePixels, sourcePixels + static_cast<size_t>(width) * height * 4u),
+            };
+
+            stbi_image_free(sourcePixels);
+
+            return mip;
+        }
+
+        // Appends the mips below the (decoded) top mip. The top mip keeps the source pixels as is, lower mips are filtered from the level above.
+        void generateMips(std::vector<MipLevel>& mips, const TextureUsage usage)
+        {
+            mips[0].values = decodeValues(mips[0].pixels, usage);
+            if (usage == TextureUsage::Normal)
+            {
+                mips[0].pixels = encodeValues(mips[0].values, usage);
+            }
+
+            while (mips.back().width > 1u || mips.back().height > 1u)
+            {
+                MipLevel mip = downsample(mips.back(), usage);
+                mip.pixels = encodeValues(mip.values, usage);
+
+                mips.emplace_back(std::move(mip));
+            }
+        }
+
+        // Block rows of every mip are claimed one at a time from a shared counter, by the calling thread and by helper jobs.
+        // The caller keeps claiming rows until none are left and then only waits for rows already being compressed, so it never waits on a job
+        // that has not started : cooking happens inside texture cache loads, which other jobs may be blocked on.
+        struct CompressionWork
+        {
+            BlockFormat format{};
+            std::vector<MipLevel> mips{};
+            std::vector<std::pair<uint32_t, uint32_t>> blockRows{};
+
+            std::atomic<uint32_t> nextBlockRow{0u};
+            std::atomic<uint32_t> completedBlockRowCount{0u};
+
+            // Helper jobs hold a reference to the work, so they may safely start after cooking returned.
+            JobCounter helperCounter{JobPriority::Low};
+
+            void compressClaimedRows()
+            {
+                for (uint32_t index = nextBlockRow.fetch_add(1u, std::memory_order_relaxed); index < blockRows.size(); index = nextBlockRow.fetch_add(1u, std::memory_order_relaxed))
+                {
+                    const auto [mipIndex, blockRow] = blockRows[index];
+                    MipLevel& mip = mips[mipIndex];
+
+                    compressBlockRows(format, mip.pixels, mip.width, mip.height, blockRow, 1u, mip.blocks);
+                    completedBlockRowCount.fetch_add(1u, std::memory_order_release);
+                }
+            }
+        };
+
+        bool writeDdsFile(const std::string_view cookedPath, const DdsHeader& header, std::span<const MipLevel> mips)
+        {
+            // Models loaded concurrently may cook the same image, so each writes to a unique temporary file that is then renamed.
+            const std::filesystem::path finalPath(cookedPath);
+            const std::filesystem::path temporaryPath = finalPath.string() + std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+            {
+                std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+                if (!file)
+                {
+                    std::cout << "Failed to create cooked texture file : " << temporaryPath.string() << '\n';
+                    return false;
+                }
+
+                file.write(reinterpret_cast<const char*>(&header), sizeof(DdsHeader));
+                for (const MipLevel& mip : mips)
+                {
+                    file.write(reinterpret_cast<const char*>(mip.blocks.data()), static_cast<std::streamsize>(mip.blocks.size()));
+                }
+            }
+
+            std::error_code errorCode{};
+            std::filesystem::rename(temporaryPath, finalPath, errorCode);
+            if (errorCode)
+            {
+                std::filesystem::remove(temporaryPath, errorCode);
+            }
+
+            return true;
+        }
+    }
+
+    BlockFormat getCookedTextureFormat(const TextureUsage usage)
+    {
+        switch (usage)
+        {
+            case TextureUsage::Albedo:
+                return BlockFormat::BC7;
+            case TextureUsage::Normal:
+                return BlockFormat::BC5;
+            case TextureUsage::Occlusion:
+                return BlockFormat::BC4;
+            default:
+                return BlockFormat::BC1;
+        }
+    }
+
+    std::string getCookedTexturePath(const std::string_view sourcePath, const TextureUsage usage) { return std::format("{}.{}.dds", sourcePath, getTextureUsageName(usage)); }
+
+    bool isCookedTextureUpToDate(const std::string_view sourcePath, const std::string_view cookedPath)
+    {
+        const std::optional<DdsHeader> header = readDdsHeader(cookedPath);
+        if (!header.has_value())
+        {
+            return false;
+        }
+
+        const std::vector<std::byte> sourceData = readFile(std::filesystem::path(sourcePath));
+        return !sourceData.empty() && std::bit_cast<uint64_t>(header->sourceHash) == hashBytes(sourceData);
+    }
+
+    std::optional<CookedTextureLayout> readCookedTextureLayout(const std::string_view cookedPath)
+    {
+        const std::optional<DdsHeader> header = readDdsHeader(cookedPath);
+        if (!header.has_value())
+        {
+            return std::nullopt;
+        }
+
+        CookedTextureLayout layout{
+            .width = header->width,
+            .height = header->height,
+        };
+
+        constexpr std::array<BlockFormat, 5u> blockFormats = {BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC4, BlockFormat::BC5, BlockFormat::BC7};
+        const auto blockFormat = std::ranges::find_if(blockFormats, [&](const BlockFormat format) {
+            return getDxgiFormat(format, false) == header->dxgiFormat || getDxgiFormat(format, true) == header->dxgiFormat;
+        });
+
+        if (blockFormat == blockFormats.end())
+        {
+            return std::nullopt;
+        }
+
+        layout.format = *blockFormat;
+        layout.isSrgb = getDxgiFormat(*blockFormat, true) == header->dxgiFormat && getDxgiFormat(*blockFormat, false) != header->dxgiFormat;
+
+        uint64_t offset = sizeof(DdsHeader);
+        for (const uint32_t mip : std::views::iota(0u, header->mipMapCount))
+        {
+            const uint32_t width = std::max(header->width >> mip, 1u);
+            const uint32_t height = std::max(header->height >> mip, 1u);
+
+            const uint32_t rowPitch = (width + BLOCK_WIDTH - 1u) / BLOCK_WIDTH * getBlockSize(layout.format);
+            const uint64_t size = static_cast<uint64_t>(rowPitch) * ((height + BLOCK_WIDTH - 1u) / BLOCK_WIDTH);
+
+            layout.mips.emplace_back(CookedMipLayout{
+                .offset = offset,
+                .size = size,
+                .width = width,
+                .height = height,
+                .rowPitch = rowPitch,
+            });
+
+            offset += size;
+        }
+
+        return layout;
+    }
+
+    std::vector<std::byte> readCookedTextureMips(const std::string_view cookedPath, const CookedTextureLayout& layout, const uint32_t firstMip)
+    {
+        const uint64_t offset = layout.mips[firstMip].offset;
+        const uint64_t size = layout.mips.back().offset + layout.mips.back().size - offset;
+
+        std::vector<std::byte> data(static_cast<size_t>(size));
+
+        std::ifstream file(std::filesystem::path(cookedPath), std::ios::binary);
+        if (!file || !file.seekg(static_cast<std::streamoff>(offset)) || !file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size)))
+        {
+            fatalError(std::format("Failed to read mips of cooked texture : {}.", cookedPath));
+        }
+
+        return data;
+    }
+
+    UncompressedTexture decodeUncompressedTexture(const std::string_view sourcePath, const TextureUsage usage)
+    {
+        std::vector<MipLevel> mips{};
+        mips.emplace_back(decodeImage(sourcePath, readFile(std::filesystem::path(sourcePath))));
+
+        generateMips(mips, usage);
+
+        UncompressedTexture texture{
+            .width = mips[0].width,
+            .height = mips[0].height,
+            .mipCount = static_cast<uint32_t>(mips.size()),
+        };
+
+        for (const MipLevel& mip : mips)
+        {
+            const std::span<const std::byte> pixels = std::as_bytes(std::span(mip.pixels));
+            texture.pixels.insert(texture.pixels.end(), pixels.begin(), pixels.end());
+        }
+
+        return texture;
+    }
+
+    std::optional<CookedTextureInfo> cookTexture(JobSystem& jobSystem, const std::string_view sourcePath, const TextureUsage usage, const std::string_view cookedPath)
+    {
+        const std::chrono::high_resolution_clock::time_point cookStartTime = std::chrono::high_resolution_clock::now();
+
+        const std::vector<std::byte> sourceData = readFile(std::filesystem::path(sourcePath));
+
+        const auto work = std::make_shared<CompressionWork>();
+        work->mips.emplace_back(decodeImage(sourcePath, sourceData));
+
+        // D3D11 requires the top mip of a block compressed texture to be a whole number of blocks, lower mips are padded.
+        if (work->mips[0].width % BLOCK_WIDTH != 0u || work->mips[0].height % BLOCK_WIDTH != 0u)
+        {
+            return std::nullopt;
+        }
+
+        work->format = getCookedTextureFormat(usage);
+
+        generateMips(work->mips, usage);
+
+        const uint32_t blockSize = getBlockSize(work->format);
+        for (const uint32_t mipIndex : std::views::iota(0u, static_cast<uint32_t>(work->mips.size())))
+        {
+            MipLevel& mip = work->mips[mipIndex];
+            mip.values.clear();
+            mip.values.shrink_to_fit();
+
+            const uint32_t blockColumnCount = (mip.width + BLOCK_WIDTH - 1u) / BLOCK_WIDTH;
+            const uint32_t blockRowCount = (mip.height + BLOCK_WIDTH - 1u) / BLOCK_WIDTH;
+
+            mip.blocks.resize(static_cast<size_t>(blockColumnCount) * blockRowCount * blockSize);
+            for (const uint32_t blockRow : std::views::iota(0u, blockRowCount))
+            {
+                work->blockRows.emplace_back(mipIndex, blockRow);
+            }
+        }
+
+        const uint32_t blockRowCount = static_cast<uint32_t>(work->blockRows.size());
+        const uint32_t helperCount = std::min(jobSystem.getWorkerCount(), blockRowCount - 1u);
+        for (const uint32_t helper : std::views::iota(0u, helperCount))
+        {
+            static_cast<void>(helper);
+            jobSystem.submit([work]() { work->compressClaimedRows(); }, work->helperCounter);
+        }
+
+        work->compressClaimedRows();
+
+        while (work->completedBlockRowCount.load(std::memory_order_acquire) != blockRowCount)
+        {
+            std::this_thread::yield();
+        }
+
+        const MipLevel& topMip = work->mips[0];
+
+        std::vector<uint8_t> decodedPixels(topMip.pixels.size());
+        decompressImage(work->format, topMip.blocks, topMip.width, topMip.height, decodedPixels);
+
+        CookedTextureInfo info{
+            .format = work->format,
+            .width = topMip.width,
+            .height = topMip.height,
+            .mipCount = static_cast<uint32_t>(work->mips.size()),
+            .psnr = computePsnr(work->format, topMip.pixels, decodedPixels),
+        };
+
+        for (const MipLevel& mip : work->mips)
+        {
+            info.sizeInBytes += mip.blocks.size();
+        }
+
+        const DdsHeader header{
+            .flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE,
+            .height = info.height,
+            .width = info.width,
+            .pitchOrLinearSize = static_cast<uint32_t>(topMip.blocks.size()),
+            .mipMapCount = info.mipCount,
+            .cookerMagic = COOKED_TEXTURE_MAGIC,
+            .cookerVersion = COOKED_TEXTURE_VERSION,
+            .sourceHash = std::bit_cast<std::array<uint32_t, 2u>>(hashBytes(sourceData)),
+            .pixelFormat =
+                DdsPixelFormat{
+                    .flags = DDPF_FOURCC,
+                    .fourCC = DDS_FOURCC_DX10,
+                },
+            .caps = DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX,
+            .dxgiFormat = getDxgiFormat(info.format, isSrgbTextureUsage(usage)),
+            .resourceDimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D,
+            .arraySize = 1u,
+        };
+
+        if (!writeDdsFile(cookedPath, header, work->mips))
+        {
+            return std::nullopt;
+        }
+
+        info.cookTimeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - cookStartTime).count();
+
+        return info;
+    }
+}
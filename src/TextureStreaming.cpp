@@ -0,0 +1,353 @@
+#include "Pch.hpp"
+
+#include "TextureStreaming.hpp"
+
+namespace sgfx
+{
+    float computeTextureLod(const uint32_t textureSize, const float textureCoordsPerPixel)
+    {
+        return std::log2(std::max(static_cast<float>(textureSize) * textureCoordsPerPixel, std::numeric_limits<float>::min()));
+    }
+
+    TextureStreamer::TextureStreamer(const TextureStreamerCreationDesc& creationDesc) : m_creationDesc(creationDesc) {}
+
+    uint32_t TextureStreamer::addTexture(const StreamedTextureDesc& textureDesc)
+    {
+        StreamedTexture texture{
+            .mipSizes = std::vector<uint64_t>(textureDesc.mipSizes.begin(), textureDesc.mipSizes.end()),
+            .isActive = true,
+        };
+
+        const uint32_t mipCount = static_cast<uint32_t>(texture.mipSizes.size());
+        while (texture.mipTailFirstMip + 1u < mipCount && texture.mipTailFirstMip < textureDesc.maxFirstMip &&
+               std::max(textureDesc.width >> texture.mipTailFirstMip, textureDesc.height >> texture.mipTailFirstMip) > m_creationDesc.mipTailDimension)
+        {
+            texture.mipTailFirstMip++;
+        }
+
+        texture.residentMip = texture.mipTailFirstMip;
+        texture.wantedMip = texture.mipTailFirstMip;
+
+        if (m_freeTextureIds.empty())
+        {
+            m_textures.emplace_back(std::move(texture));
+            return static_cast<uint32_t>(m_textures.size() - 1u);
+        }
+
+        const uint32_t textureId = m_freeTextureIds.back();
+        m_freeTextureIds.pop_back();
+
+        m_textures[textureId] = std::move(texture);
+        return textureId;
+    }
+
+    void TextureStreamer::removeTexture(const uint32_t textureId)
+    {
+        StreamedTexture& texture = m_textures[textureId];
+        texture.isActive = false;
+
+        // The id is only reused once the request in flight completed.
+        if (texture.pendingMip == INVALID_INDEX_U32)
+        {
+            m_freeTextureIds.emplace_back(textureId);
+        }
+    }
+
+    void TextureStreamer::requestMip(const uint32_t textureId, const uint32_t mip)
+    {
+        StreamedTexture& texture = m_textures[textureId];
+        texture.requestedMip = std::min(texture.requestedMip, mip);
+    }
+
+    std::vector<TextureStreamingRequest> TextureStreamer::update()
+    {
+        std::vector<TextureStreamingRequest> requests{};
+
+        m_updateIndex++;
+
+        uint32_t pendingRequestCount = 0u;
+
+        // A request creates a new texture from the mips that remain, the current one is only released once the request completes. Until then
+        // both count against the budget, and releasingBytes are the bytes released once every request in flight completed.
+        uint64_t residentBytes = 0u;
+        uint64_t releasingBytes = 0u;
+
+        std::vector<uint32_t> waitingTextureIds{};
+
+        for (const uint32_t textureId : std::views::iota(0u, static_cast<uint32_t>(m_textures.size())))
+        {
+            StreamedTexture& texture = m_textures[textureId];
+            if (!texture.isActive)
+            {
+                continue;
+            }
+
+            if (texture.requestedMip != INVALID_INDEX_U32)
+            {
+                texture.lastRequestedUpdate = m_updateIndex;
+            }
+
+            texture.wantedMip = std::min(texture.requestedMip, texture.mipTailFirstMip);
+            texture.requestedMip = INVALID_INDEX_U32;
+
+            if (texture.pendingMip != INVALID_INDEX_U32)
+            {
+                pendingRequestCount++;
+                residentBytes += getSize(texture, texture.residentMip) + getSize(texture, texture.pendingMip);
+                releasingBytes += getSize(texture, texture.residentMip);
+            }
+            else
+            {
+                residentBytes += getSize(texture, texture.residentMip);
+
+                if (texture.wantedMip < texture.residentMip)
+                {
+                    waitingTextureIds.emplace_back(textureId);
+                }
+            }
+        }
+
+        // The blurriest textures (relative to what is wanted) first.
+        std::ranges::stable_sort(waitingTextureIds, std::greater{}, [&](const uint32_t textureId) { return m_textures[textureId].residentMip - m_textures[textureId].wantedMip; });
+
+        uint64_t uploadBytes = 0u;
+
+        for (const uint32_t textureId : waitingTextureIds)
+        {
+            if (pendingRequestCount >= m_creationDesc.maxPendingRequestCount)
+            {
+                break;
+            }
+
+            // Textures evicted to make room for an earlier load are not loaded in the same update.
+            StreamedTexture& texture = m_textures[textureId];
+            if (texture.pendingMip != INVALID_INDEX_U32)
+            {
+                continue;
+            }
+
+            const uint64_t currentSize = getSize(texture, texture.residentMip);
+
+            // Load as many mips as fit in the remaining upload budget, but always at least one so large mips are not starved.
+            uint32_t firstMip = texture.residentMip - 1u;
+            while (firstMip > texture.wantedMip && uploadBytes + getSize(texture, firstMip - 1u) - currentSize <= m_creationDesc.uploadBudgetBytesPerUpdate)
+            {
+                firstMip--;
+            }
+
+            uint64_t newBytes = getSize(texture, firstMip) - currentSize;
+            if (uploadBytes != 0u && uploadBytes + newBytes > m_creationDesc.uploadBudgetBytesPerUpdate)
+            {
+                break;
+            }
+
+            // The new texture holds every mip from firstMip, alongside the current one until the swap.
+            if (residentBytes + getSize(texture, firstMip) > m_creationDesc.residentBudgetBytes)
+            {
+                // Under memory pressure a single mip is loaded, so other textures give up as little as possible.
+                firstMip = texture.residentMip - 1u;
+                newBytes = getSize(texture, firstMip) - currentSize;
+
+                // Evicted mips are only released once the evictions complete, so the load is left to a later update. Nothing is evicted if the
+                // requests in flight will release enough.
+                const uint64_t requiredBytes = residentBytes - releasingBytes + getSize(texture, firstMip);
+                if (requiredBytes > m_creationDesc.residentBudgetBytes)
+                {
+                    releasingBytes += evict(requiredBytes - m_creationDesc.residentBudgetBytes, textureId, residentBytes, requests);
+                    continue;
+                }
+
+                // A smaller load of another texture may still fit.
+                if (residentBytes + getSize(texture, firstMip) > m_creationDesc.residentBudgetBytes)
+                {
+                    continue;
+                }
+            }
+
+            requests.emplace_back(TextureStreamingRequest{
+                .textureId = textureId,
+                .firstMip = firstMip,
+            });
+
+            texture.pendingMip = firstMip;
+
+            pendingRequestCount++;
+            residentBytes += getSize(texture, firstMip);
+            releasingBytes += currentSize;
+            uploadBytes += newBytes;
+        }
+
+        m_lastUpdateLoadCount = static_cast<uint32_t>(std::ranges::count_if(requests, [&](const TextureStreamingRequest& request) { return request.firstMip < m_textures[request.textureId].residentMip; }));
+        m_lastUpdateEvictionCount = static_cast<uint32_t>(requests.size()) - m_lastUpdateLoadCount;
+        m_evictionCount += m_lastUpdateEvictionCount;
+
+        return requests;
+    }
+
+    void TextureStreamer::completeRequest(const uint32_t textureId, const uint32_t residentMip)
+    {
+        StreamedTexture& texture = m_textures[textureId];
+
+        if (residentMip < texture.residentMip)
+        {
+            m_loadedBytes += getSize(texture, residentMip) - getSize(texture, texture.residentMip);
+        }
+        else
+        {
+            m_evictedBytes += getSize(texture, texture.residentMip) - getSize(texture, residentMip);
+        }
+
+        texture.residentMip = residentMip;
+        texture.pendingMip = INVALID_INDEX_U32;
+
+        if (!texture.isActive)
+        {
+            m_freeTextureIds.emplace_back(textureId);
+        }
+    }
+
+    TextureStreamingStats TextureStreamer::getStats() const
+    {
+        TextureStreamingStats stats{
+            .budgetBytes = m_creationDesc.residentBudgetBytes,
+            .lastUpdateLoadCount = m_lastUpdateLoadCount,
+            .lastUpdateEvictionCount = m_lastUpdateEvictionCount,
+            .loadedBytes = m_loadedBytes,
+            .evictedBytes = m_evictedBytes,
+            .evictionCount = m_evictionCount,
+        };
+
+        for (const StreamedTexture& texture : m_textures)
+        {
+            if (!texture.isActive)
+            {
+                continue;
+            }
+
+            stats.textureCount++;
+            stats.pendingRequestCount += texture.pendingMip != INVALID_INDEX_U32 ? 1u : 0u;
+            stats.waitingTextureCount += texture.wantedMip < texture.residentMip ? 1u : 0u;
+            stats.residentBytes += getSize(texture, texture.residentMip);
+            stats.inFlightBytes += texture.pendingMip != INVALID_INDEX_U32 ? getSize(texture, texture.pendingMip) : 0u;
+        }
+
+        return stats;
+    }
+
+    uint64_t TextureStreamer::getSize(const StreamedTexture& texture, const uint32_t firstMip)
+    {
+        return std::accumulate(texture.mipSizes.begin() + firstMip, texture.mipSizes.end(), uint64_t{0u});
+    }
+
+    uint64_t TextureStreamer::evict(const uint64_t byteCount, const uint32_t loadingTextureId, uint64_t& residentBytes, std::vector<TextureStreamingRequest>& requests)
+    {
+        const uint32_t loadingDeficit = m_textures[loadingTextureId].residentMip - m_textures[loadingTextureId].wantedMip;
+
+        std::vector<uint32_t> unwantedTextureIds{};
+        std::vector<uint32_t> wantedTextureIds{};
+
+        for (const uint32_t textureId : std::views::iota(0u, static_cast<uint32_t>(m_textures.size())))
+        {
+            const StreamedTexture& texture = m_textures[textureId];
+            if (!texture.isActive || texture.pendingMip != INVALID_INDEX_U32 || textureId == loadingTextureId)
+            {
+                continue;
+            }
+
+            if (texture.residentMip < texture.wantedMip)
+            {
+                unwantedTextureIds.emplace_back(textureId);
+            }
+            else if (texture.residentMip < texture.mipTailFirstMip && texture.residentMip - texture.wantedMip + 1u < loadingDeficit)
+            {
+                wantedTextureIds.emplace_back(textureId);
+            }
+        }
+
+        // Net bytes, the evicted mips, and bytes of the textures released once the evictions complete.
+        uint64_t freedBytes = 0u;
+        uint64_t releasedBytes = 0u;
+
+        // The texture created from the remaining mips must fit the budget alongside the current one, evictions that do not are skipped.
+        const auto issueEviction = [&](const uint32_t textureId, const uint32_t firstMip)
+        {
+            StreamedTexture& texture = m_textures[textureId];
+            if (residentBytes + getSize(texture, firstMip) > m_creationDesc.residentBudgetBytes)
+            {
+                return;
+            }
+
+            freedBytes += getSize(texture, texture.residentMip) - getSize(texture, firstMip);
+            releasedBytes += getSize(texture, texture.residentMip);
+            residentBytes += getSize(texture, firstMip);
+
+            requests.emplace_back(TextureStreamingRequest{
+                .textureId = textureId,
+                .firstMip = firstMip,
+            });
+
+            texture.pendingMip = firstMip;
+        };
+
+        // Least recently requested first, then the textures with the most unneeded bytes.
+        std::ranges::stable_sort(unwantedTextureIds,
+                                 [&](const uint32_t a, const uint32_t b)
+                                 {
+                                     const StreamedTexture& textureA = m_textures[a];
+                                     const StreamedTexture& textureB = m_textures[b];
+
+                                     if (textureA.lastRequestedUpdate != textureB.lastRequestedUpdate)
+                                     {
+                                         return textureA.lastRequestedUpdate < textureB.lastRequestedUpdate;
+                                     }
+
+                                     return getSize(textureA, textureA.residentMip) - getSize(textureA, textureA.wantedMip) >
+                                            getSize(textureB, textureB.residentMip) - getSize(textureB, textureB.wantedMip);
+                                 });
+
+        for (const uint32_t textureId : unwantedTextureIds)
+        {
+            if (freedBytes >= byteCount)
+            {
+                return releasedBytes;
+            }
+
+            issueEviction(textureId, m_textures[textureId].wantedMip);
+        }
+
+        // Wanted mips are only given up if that actually makes room for the load.
+        const uint64_t wantedBytes = std::accumulate(wantedTextureIds.begin(), wantedTextureIds.end(), uint64_t{0u},
+                                                     [&](const uint64_t sum, const uint32_t textureId) { return sum + m_textures[textureId].mipSizes[m_textures[textureId].residentMip]; });
+        if (freedBytes + wantedBytes < byteCount)
+        {
+            return releasedBytes;
+        }
+
+        // Closest to their wanted mip first, then the largest finest mips.
+        std::ranges::stable_sort(wantedTextureIds,
+                                 [&](const uint32_t a, const uint32_t b)
+                                 {
+                                     const StreamedTexture& textureA = m_textures[a];
+                                     const StreamedTexture& textureB = m_textures[b];
+
+                                     if (textureA.residentMip - textureA.wantedMip != textureB.residentMip - textureB.wantedMip)
+                                     {
+                                         return textureA.residentMip - textureA.wantedMip < textureB.residentMip - textureB.wantedMip;
+                                     }
+
+                                     return textureA.mipSizes[textureA.residentMip] > textureB.mipSizes[textureB.residentMip];
+                                 });
+
+        for (const uint32_t textureId : wantedTextureIds)
+        {
+            if (freedBytes >= byteCount)
+            {
+                break;
+            }
+
+            issueEviction(textureId, m_textures[textureId].residentMip + 1u);
+        }
+
+        return releasedBytes;
+    }
+}
@@ -0,0 +1,95 @@
+#include "Pch.hpp"
+
+#include "TransformHierarchy.hpp"
+
+namespace sgfx
+{
+    void TransformHierarchy::reserve(const uint32_t nodeCount)
+    {
+        m_parentIndices.reserve(nodeCount);
+        m_translations.reserve(nodeCount);
+        m_rotations.reserve(nodeCount);
+        m_scales.reserve(nodeCount);
+        m_worldMatrices.reserve(nodeCount);
+        m_isDirty.reserve(nodeCount);
+        m_isUpdated.reserve(nodeCount);
+    }
+
+    uint32_t TransformHierarchy::addNode(const uint32_t parentIndex, const LocalTransform& localTransform)
+    {
+        const uint32_t nodeIndex = getNodeCount();
+
+        if (parentIndex != INVALID_INDEX_U32 && parentIndex >= nodeIndex)
+        {
+            fatalError(std::format("Parent {} of transform hierarchy node {} has not been added yet.", parentIndex, nodeIndex));
+        }
+
+        m_parentIndices.emplace_back(parentIndex);
+        m_translations.emplace_back(localTransform.translation);
+        m_rotations.emplace_back(localTransform.rotation);
+        m_scales.emplace_back(localTransform.scale);
+        m_worldMatrices.emplace_back(math::XMMatrixIdentity());
+        m_isDirty.emplace_back(uint8_t{1u});
+        m_isUpdated.emplace_back(uint8_t{0u});
+
+        m_firstDirtyNode = std::min(m_firstDirtyNode, nodeIndex);
+
+        return nodeIndex;
+    }
+
+    void TransformHierarchy::setLocalTransform(const uint32_t nodeIndex, const LocalTransform& localTransform)
+    {
+        m_translations[nodeIndex] = localTransform.translation;
+        m_rotations[nodeIndex] = localTransform.rotation;
+        m_scales[nodeIndex] = localTransform.scale;
+
+        m_isDirty[nodeIndex] = 1u;
+        m_firstDirtyNode = std::min(m_firstDirtyNode, nodeIndex);
+    }
+
+    LocalTransform TransformHierarchy::getLocalTransform(const uint32_t nodeIndex) const
+    {
+        return LocalTransform{
+            .translation = m_translations[nodeIndex],
+            .rotation = m_rotations[nodeIndex],
+            .scale = m_scales[nodeIndex],
+        };
+    }
+
+    uint32_t TransformHierarchy::updateWorldMatrices()
+    {
+        const uint32_t nodeCount = getNodeCount();
+
+        std::ranges::fill(m_isUpdated, uint8_t{0u});
+
+        uint32_t updatedNodeCount = 0u;
+
+        for (uint32_t nodeIndex = m_firstDirtyNode; nodeIndex < nodeCount; nodeIndex++)
+        {
+            const uint32_t parentIndex = m_parentIndices[nodeIndex];
+            const bool isParentUpdated = parentIndex != INVALID_INDEX_U32 && m_isUpdated[parentIndex] != 0u;
+
+            if (m_isDirty[nodeIndex] == 0u && !isParentUpdated)
+            {
+                continue;
+            }
+
+            // Scale, then rotation, then translation (the glTF TRS order), in DirectXMath's row vector convention.
+            const math::XMMATRIX localMatrix = math::XMMatrixAffineTransformation(math::XMLoadFloat3(&m_scales[nodeIndex]),
+                                                                                  math::XMVectorZero(),
+                                                                                  math::XMLoadFloat4(&m_rotations[nodeIndex]),
+                                                                                  math::XMLoadFloat3(&m_translations[nodeIndex]));
+
+            m_worldMatrices[nodeIndex] = parentIndex == INVALID_INDEX_U32 ? localMatrix : math::XMMatrixMultiply(localMatrix, m_worldMatrices[parentIndex]);
+
+            m_isDirty[nodeIndex] = 0u;
+            m_isUpdated[nodeIndex] = 1u;
+
+            updatedNodeCount++;
+        }
+
+        m_firstDirtyNode = nodeCount;
+
+        return updatedNodeCount;
+    }
+}
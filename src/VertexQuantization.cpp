@@ -0,0 +1,349 @@
+#include "Pch.hpp"
+
+#include "VertexQuantization.hpp"
+
+#include "CpuFeatures.hpp"
+
+#include <immintrin.h>
+
+namespace sgfx
+{
+    namespace
+    {
+        // The SIMD path loads (position, textureCoord.x) and (textureCoord.y, normal) as two float4's per vertex, tangents are encoded separately.
+        static_assert(offsetof(ModelVertex, textureCoord) == offsetof(ModelVertex, position) + sizeof(math::XMFLOAT3));
+        static_assert(offsetof(ModelVertex, normal) == offsetof(ModelVertex, textureCoord) + sizeof(math::XMFLOAT2));
+        static_assert(sizeof(CompactModelVertex) == 16u);
+
+        constexpr float UNORM16_MAX = 65535.0f;
+        constexpr float SNORM16_MAX = 32767.0f;
+
+        constexpr float TWO_PI = 6.28318530718f;
+        constexpr uint16_t TANGENT_HANDEDNESS_BIT = 0x8000u;
+        constexpr uint16_t TANGENT_ANGLE_MASK = 0x7fffu;
+        constexpr float TANGENT_ANGLE_STEPS = 32768.0f;
+
+        // Duff et al. 2017, "Building an Orthonormal Basis, Revisited". Must match getTangentBasis in the shaders.
+        std::array<math::XMFLOAT3, 2> getTangentBasis(const math::XMFLOAT3& normal)
+        {
+            const float sign = normal.z >= 0.0f ? 1.0f : -1.0f;
+            const float a = -1.0f / (sign + normal.z);
+            const float b = normal.x * normal.y * a;
+
+            return {
+                math::XMFLOAT3{1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x},
+                math::XMFLOAT3{b, sign + normal.y * normal.y * a, -normal.y},
+            };
+        }
+
+        struct QuantizationParameters
+        {
+            std::array<float, 3> minimum{};
+            std::array<float, 3> inverseExtent{};
+        };
+
+        QuantizationParameters getQuantizationParameters(const AxisAlignedBoundingBox& bounds)
+        {
+            const auto getInverseExtent = [](const float minimum, const float maximum) { return maximum > minimum ? UNORM16_MAX / (maximum - minimum) : 0.0f; };
+
+            return QuantizationParameters{
+                .minimum = {bounds.minimum.x, bounds.minimum.y, bounds.minimum.z},
+                .inverseExtent =
+                    {
+                        getInverseExtent(bounds.minimum.x, bounds.maximum.x),
+                        getInverseExtent(bounds.minimum.y, bounds.maximum.y),
+                        getInverseExtent(bounds.minimum.z, bounds.maximum.z),
+                    },
+            };
+        }
+
+        CompactModelVertex encodeCompactVertex(const ModelVertex& vertex, const QuantizationParameters& parameters)
+        {
+            const std::array<int16_t, 2> normal = encodeOctahedralNormal(vertex.normal);
+
+            return CompactModelVertex{
+                .position =
+                    {
+                        quantizeUnorm16(vertex.position.x, parameters.minimum[0], parameters.inverseExtent[0]),
+                        quantizeUnorm16(vertex.position.y, parameters.minimum[1], parameters.inverseExtent[1]),
+                        quantizeUnorm16(vertex.position.z, parameters.minimum[2], parameters.inverseExtent[2]),
+                        encodeTangent(decodeOctahedralNormal(normal), vertex.tangent),
+                    },
+                .textureCoord = {floatToHalf(vertex.textureCoord.x), floatToHalf(vertex.textureCoord.y)},
+                .normal = {normal[0], normal[1]},
+            };
+        }
+
+        SGFX_TARGET_SSE41 __m128i quantizeUnorm16Sse41(const __m128 value, const __m128 minimum, const __m128 inverseExtent)
+        {
+            const __m128 scaled = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(value, minimum), inverseExtent), _mm_set1_ps(0.5f));
+            return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(scaled, _mm_setzero_ps()), _mm_set1_ps(UNORM16_MAX)));
+        }
+
+        // +1 for values >= 0 (including -0), -1 otherwise.
+        SGFX_TARGET_SSE41 __m128 signNotZeroSse41(const __m128 value) { return _mm_blendv_ps(_mm_set1_ps(-1.0f), _mm_set1_ps(1.0f), _mm_cmpge_ps(value, _mm_setzero_ps())); }
+
+        // Encodes 4 vertices per iteration : both halves of the 4 vertices are transposed to SoA, encoded, and interleaved back.
+        // Returns the number of vertices encoded.
+        SGFX_TARGET_SSE41_F16C size_t encodeCompactVerticesSse41F16c(std::span<const ModelVertex> vertices, const QuantizationParameters& parameters, CompactModelVertex* const destination)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 minusOne = _mm_set1_ps(-1.0f);
+            const __m128 snormMax = _mm_set1_ps(SNORM16_MAX);
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            const __m128 minimumSum = _mm_set1_ps(std::numeric_limits<float>::min());
+
+            const __m128 minimumX = _mm_set1_ps(parameters.minimum[0]);
+            const __m128 minimumY = _mm_set1_ps(parameters.minimum[1]);
+            const __m128 minimumZ = _mm_set1_ps(parameters.minimum[2]);
+
+            const __m128 inverseExtentX = _mm_set1_ps(parameters.inverseExtent[0]);
+            const __m128 inverseExtentY = _mm_set1_ps(parameters.inverseExtent[1]);
+            const __m128 inverseExtentZ = _mm_set1_ps(parameters.inverseExtent[2]);
+
+            size_t i = 0u;
+            for (; i + 4u <= vertices.size(); i += 4u)
+            {
+                __m128 px = _mm_loadu_ps(&vertices[i].position.x);
+                __m128 py = _mm_loadu_ps(&vertices[i + 1u].position.x);
+                __m128 pz = _mm_loadu_ps(&vertices[i + 2u].position.x);
+                __m128 u = _mm_loadu_ps(&vertices[i + 3u].position.x);
+                _MM_TRANSPOSE4_PS(px, py, pz, u);
+
+                __m128 v = _mm_loadu_ps(&vertices[i].textureCoord.y);
+                __m128 nx = _mm_loadu_ps(&vertices[i + 1u].textureCoord.y);
+                __m128 ny = _mm_loadu_ps(&vertices[i + 2u].textureCoord.y);
+                __m128 nz = _mm_loadu_ps(&vertices[i + 3u].textureCoord.y);
+                _MM_TRANSPOSE4_PS(v, nx, ny, nz);
+
+                // Positions.
+                const __m128i positionXZ = _mm_packus_epi32(quantizeUnorm16Sse41(px, minimumX, inverseExtentX), quantizeUnorm16Sse41(pz, minimumZ, inverseExtentZ));
+                const __m128i positionY = _mm_packus_epi32(quantizeUnorm16Sse41(py, minimumY, inverseExtentY), _mm_setzero_si128());
+
+                const __m128i positionXY = _mm_unpacklo_epi16(positionXZ, positionY);
+                const __m128i positionZW = _mm_unpackhi_epi16(positionXZ, positionY);
+
+                // Texture coordinates.
+                const __m128i textureCoord = _mm_unpacklo_epi16(_mm_cvtps_ph(u, _MM_FROUND_TO_NEAREST_INT), _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+
+                // Normals, projected onto the octahedron and folded into the upper hemisphere.
+                const __m128 sum = _mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_and_ps(nx, absMask), _mm_and_ps(ny, absMask)), _mm_and_ps(nz, absMask)), minimumSum);
+
+                const __m128 octX = _mm_div_ps(nx, sum);
+                const __m128 octY = _mm_div_ps(ny, sum);
+
+                const __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(octY, absMask)), signNotZeroSse41(octX));
+                const __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(octX, absMask)), signNotZeroSse41(octY));
+
+                const __m128 isLowerHemisphere = _mm_cmplt_ps(nz, zero);
+                const __m128 encodedX = _mm_blendv_ps(octX, foldedX, isLowerHemisphere);
+                const __m128 encodedY = _mm_blendv_ps(octY, foldedY, isLowerHemisphere);
+
+                const __m128i normalXY = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(encodedX, minusOne), one), snormMax)),
+                                                         _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(encodedY, minusOne), one), snormMax)));
+                const __m128i normal = _mm_unpacklo_epi16(normalXY, _mm_unpackhi_epi64(normalXY, normalXY));
+
+                // Back to AoS.
+                const __m128i position01 = _mm_unpacklo_epi32(positionXY, positionZW);
+                const __m128i position23 = _mm_unpackhi_epi32(positionXY, positionZW);
+                const __m128i attributes01 = _mm_unpacklo_epi32(textureCoord, normal);
+                const __m128i attributes23 = _mm_unpackhi_epi32(textureCoord, normal);
+
+                __m128i* const output = reinterpret_cast<__m128i*>(destination + i);
+                _mm_storeu_si128(output, _mm_unpacklo_epi64(position01, attributes01));
+                _mm_storeu_si128(output + 1u, _mm_unpackhi_epi64(position01, attributes01));
+                _mm_storeu_si128(output + 2u, _mm_unpacklo_epi64(position23, attributes23));
+                _mm_storeu_si128(output + 3u, _mm_unpackhi_epi64(position23, attributes23));
+            }
+
+            return i;
+        }
+    }
+
+    PositionDequantization getPositionDequantization(const AxisAlignedBoundingBox& bounds)
+    {
+        return PositionDequantization{
+            .scale =
+                {
+                    (bounds.maximum.x - bounds.minimum.x) / UNORM16_MAX,
+                    (bounds.maximum.y - bounds.minimum.y) / UNORM16_MAX,
+                    (bounds.maximum.z - bounds.minimum.z) / UNORM16_MAX,
+                    0.0f,
+                },
+            .offset = {bounds.minimum.x, bounds.minimum.y, bounds.minimum.z, 0.0f},
+        };
+    }
+
+    bool canEncodeCompactTextureCoords(std::span<const ModelVertex> vertices)
+    {
+        return std::ranges::all_of(vertices,
+                                   [](const ModelVertex& vertex)
+                                   { return std::abs(vertex.textureCoord.x) <= MAX_COMPACT_TEXTURE_COORD && std::abs(vertex.textureCoord.y) <= MAX_COMPACT_TEXTURE_COORD; });
+    }
+
+    void encodeCompactVertices(std::span<const ModelVertex> vertices, const AxisAlignedBoundingBox& bounds, std::span<CompactModelVertex> outVertices)
+    {
+        const QuantizationParameters parameters = getQuantizationParameters(bounds);
+
+        size_t i = 0u;
+        if (getCpuFeatures().sse41 && getCpuFeatures().f16c)
+        {
+            i = encodeCompactVerticesSse41F16c(vertices, parameters, outVertices.data());
+
+            // The tangent depends on the decoded normal and an atan2, which is left to the scalar code.
+            for (const size_t j : std::views::iota(size_t{0u}, i))
+            {
+                const std::array<int16_t, 2> normal = {outVertices[j].normal[0], outVertices[j].normal[1]};
+                outVertices[j].position[3] = encodeTangent(decodeOctahedralNormal(normal), vertices[j].tangent);
+            }
+        }
+
+        for (; i < vertices.size(); ++i)
+        {
+            outVertices[i] = encodeCompactVertex(vertices[i], parameters);
+        }
+    }
+
+    uint16_t quantizeUnorm16(const float value, const float minimum, const float inverseExtent)
+    {
+        const float scaled = (value - minimum) * inverseExtent + 0.5f;
+        return static_cast<uint16_t>(static_cast<int32_t>(std::min(std::max(scaled, 0.0f), UNORM16_MAX)));
+    }
+
+    uint16_t floatToHalf(const float value)
+    {
+        const uint32_t bits = std::bit_cast<uint32_t>(value);
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+        const uint32_t magnitude = bits & 0x7fffffffu;
+
+        // Inf / NaN.
+        if (magnitude >= 0x7f800000u)
+        {
+            return static_cast<uint16_t>(sign | (magnitude > 0x7f800000u ? 0x7e00u : 0x7c00u));
+        }
+
+        // Values of 65520 and above round to infinity.
+        if (magnitude >= 0x477ff000u)
+        {
+            return static_cast<uint16_t>(sign | 0x7c00u);
+        }
+
+        // Below 2^-14 the result is subnormal, which is a plain fixed point value in units of 2^-24.
+        if (magnitude < 0x38800000u)
+        {
+            return static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(std::bit_cast<float>(magnitude) * 16777216.0f)));
+        }
+
+        // Rebias the exponent and round the mantissa to nearest even, a carry correctly propagates into the exponent.
+        return static_cast<uint16_t>(sign | ((magnitude - 0x38000000u + 0x0fffu + ((magnitude >> 13u) & 1u)) >> 13u));
+    }
+
+    float halfToFloat(const uint16_t value)
+    {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16u;
+        const uint32_t exponent = (value >> 10u) & 0x1fu;
+        const uint32_t mantissa = value & 0x03ffu;
+
+        if (exponent == 0u)
+        {
+            const float subnormal = static_cast<float>(mantissa) / 16777216.0f;
+            return sign ? -subnormal : subnormal;
+        }
+
+        if (exponent == 0x1fu)
+        {
+            return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13u));
+        }
+
+        return std::bit_cast<float>(sign | ((exponent + 112u) << 23u) | (mantissa << 13u));
+    }
+
+    std::array<int16_t, 2> encodeOctahedralNormal(const math::XMFLOAT3& normal)
+    {
+        const float sum = std::max(std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z), std::numeric_limits<float>::min());
+
+        float x = normal.x / sum;
+        float y = normal.y / sum;
+
+        if (normal.z < 0.0f)
+        {
+            const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+
+            x = foldedX;
+            y = foldedY;
+        }
+
+        return {
+            static_cast<int16_t>(std::nearbyint(std::clamp(x, -1.0f, 1.0f) * SNORM16_MAX)),
+            static_cast<int16_t>(std::nearbyint(std::clamp(y, -1.0f, 1.0f) * SNORM16_MAX)),
+        };
+    }
+
+    math::XMFLOAT3 decodeOctahedralNormal(const std::array<int16_t, 2>& encodedNormal)
+    {
+        float x = std::max(static_cast<float>(encodedNormal[0]) / SNORM16_MAX, -1.0f);
+        float y = std::max(static_cast<float>(encodedNormal[1]) / SNORM16_MAX, -1.0f);
+        const float z = 1.0f - std::abs(x) - std::abs(y);
+
+        const float t = std::max(-z, 0.0f);
+        x += x >= 0.0f ? -t : t;
+        y += y >= 0.0f ? -t : t;
+
+        const float length = std::sqrt(x * x + y * y + z * z);
+
+        return math::XMFLOAT3(x / length, y / length, z / length);
+    }
+
+    uint16_t encodeTangent(const math::XMFLOAT3& normal, const math::XMFLOAT4& tangent)
+    {
+        const std::array<math::XMFLOAT3, 2> basis = getTangentBasis(normal);
+
+        const float x = tangent.x * basis[0].x + tangent.y * basis[0].y + tangent.z * basis[0].z;
+        const float y = tangent.x * basis[1].x + tangent.y * basis[1].y + tangent.z * basis[1].z;
+
+        float angle = std::atan2(y, x);
+        angle += angle < 0.0f ? TWO_PI : 0.0f;
+
+        // An angle rounding up to 2 pi wraps around to 0.
+        const uint16_t encodedAngle = static_cast<uint16_t>(static_cast<uint32_t>(std::nearbyint(angle / TWO_PI * TANGENT_ANGLE_STEPS)) & TANGENT_ANGLE_MASK);
+
+        return static_cast<uint16_t>(encodedAngle | (tangent.w < 0.0f ? 0u : TANGENT_HANDEDNESS_BIT));
+    }
+
+    math::XMFLOAT4 decodeTangent(const math::XMFLOAT3& normal, const uint16_t encodedTangent)
+    {
+        const std::array<math::XMFLOAT3, 2> basis = getTangentBasis(normal);
+
+        const float angle = static_cast<float>(encodedTangent & TANGENT_ANGLE_MASK) * (TWO_PI / TANGENT_ANGLE_STEPS);
+        const float cosine = std::cos(angle);
+        const float sine = std::sin(angle);
+
+        return math::XMFLOAT4{
+            basis[0].x * cosine + basis[1].x * sine,
+            basis[0].y * cosine + basis[1].y * sine,
+            basis[0].z * cosine + basis[1].z * sine,
+            (encodedTangent & TANGENT_HANDEDNESS_BIT) ? 1.0f : -1.0f,
+        };
+    }
+
+    std::vector<VertexAttribute> getModelVertexAttributes(const VertexFormat vertexFormat)
+    {
+        if (vertexFormat == VertexFormat::Compact)
+        {
+            return {
+                VertexAttribute{.semanticName = "Position", .format = VertexAttributeFormat::Unorm16x4},
+                VertexAttribute{.semanticName = "TextureCoord", .format = VertexAttributeFormat::Half2},
+                VertexAttribute{.semanticName = "Normal", .format = VertexAttributeFormat::Snorm16x2},
+            };
+        }
+
+        return {
+            VertexAttribute{.semanticName = "Position", .format = VertexAttributeFormat::Float3},
+            VertexAttribute{.semanticName = "TextureCoord", .format = VertexAttributeFormat::Float2},
+            VertexAttribute{.semanticName = "Normal", .format = VertexAttributeFormat::Float3},
+            VertexAttribute{.semanticName = "Tangent", .format = VertexAttributeFormat::Float4},
+        };
+    }
+}
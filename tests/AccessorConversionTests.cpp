@@ -0,0 +1,106 @@
+#include "Pch.hpp"
+
+#include "AccessorConversion.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    constexpr uint32_t GLTF_UNSIGNED_BYTE = 5121u;
+    constexpr uint32_t GLTF_UNSIGNED_SHORT = 5123u;
+    constexpr uint32_t GLTF_FLOAT = 5126u;
+}
+
+SGFX_TEST(AccessorConversionMatchesScalarConversion)
+{
+    // Not a multiple of the block size, with an interleaved source of 8 floats per vertex.
+    constexpr uint32_t VERTEX_COUNT = 1000u;
+
+    std::vector<float> source(VERTEX_COUNT * 8u);
+    std::iota(source.begin(), source.end(), 0.0f);
+
+    std::vector<uint16_t> quantizedTextureCoords(VERTEX_COUNT * 2u);
+    std::iota(quantizedTextureCoords.begin(), quantizedTextureCoords.end(), uint16_t{0u});
+
+    const auto getSourceView = [&](const uint32_t firstComponent, const uint32_t componentCount)
+    {
+        return sgfx::AccessorView{
+            .data = reinterpret_cast<const uint8_t*>(source.data() + firstComponent),
+            .byteStride = 8u * sizeof(float),
+            .count = VERTEX_COUNT,
+            .componentType = GLTF_FLOAT,
+            .componentCount = componentCount,
+        };
+    };
+
+    const std::array<sgfx::AttributeConversion, 3> attributes = {
+        sgfx::AttributeConversion{.accessor = getSourceView(0u, 3u), .destinationOffset = offsetof(sgfx::ModelVertex, position)},
+        sgfx::AttributeConversion{
+            .accessor =
+                sgfx::AccessorView{
+                    .data = reinterpret_cast<const uint8_t*>(quantizedTextureCoords.data()),
+                    .byteStride = 2u * sizeof(uint16_t),
+                    .count = VERTEX_COUNT,
+                    .componentType = GLTF_UNSIGNED_SHORT,
+                    .componentCount = 2u,
+                    .normalized = true,
+                },
+            .destinationOffset = offsetof(sgfx::ModelVertex, textureCoord),
+        },
+        sgfx::AttributeConversion{.accessor = getSourceView(5u, 3u), .destinationOffset = offsetof(sgfx::ModelVertex, normal)},
+    };
+
+    std::vector<sgfx::ModelVertex> vertices(VERTEX_COUNT);
+    sgfx::convertAttributesToFloats(attributes, reinterpret_cast<std::byte*>(vertices.data()), sizeof(sgfx::ModelVertex));
+
+    bool isMatching = true;
+    for (const uint32_t i : std::views::iota(0u, VERTEX_COUNT))
+    {
+        const sgfx::ModelVertex& vertex = vertices[i];
+        const float* const sourceVertex = source.data() + i * 8u;
+
+        isMatching = isMatching && vertex.position.x == sourceVertex[0] && vertex.position.y == sourceVertex[1] && vertex.position.z == sourceVertex[2];
+        isMatching = isMatching && vertex.textureCoord.x == quantizedTextureCoords[2u * i] / 65535.0f && vertex.textureCoord.y == quantizedTextureCoords[2u * i + 1u] / 65535.0f;
+        isMatching = isMatching && vertex.normal.x == sourceVertex[5] && vertex.normal.y == sourceVertex[6] && vertex.normal.z == sourceVertex[7];
+
+        // Not converted, so left untouched.
+        isMatching = isMatching && vertex.tangent.x == 0.0f && vertex.tangent.w == 0.0f;
+    }
+
+    SGFX_CHECK(isMatching);
+}
+
+SGFX_TEST(AccessorConversionShorterAccessor)
+{
+    const std::vector<float> positions(3u * 600u, 1.0f);
+    const std::vector<float> normals(3u * 300u, 2.0f);
+
+    const std::array<sgfx::AttributeConversion, 2> attributes = {
+        sgfx::AttributeConversion{
+            .accessor = {.data = reinterpret_cast<const uint8_t*>(positions.data()), .byteStride = 12u, .count = 600u, .componentType = GLTF_FLOAT, .componentCount = 3u},
+            .destinationOffset = offsetof(sgfx::ModelVertex, position),
+        },
+        sgfx::AttributeConversion{
+            .accessor = {.data = reinterpret_cast<const uint8_t*>(normals.data()), .byteStride = 12u, .count = 300u, .componentType = GLTF_FLOAT, .componentCount = 3u},
+            .destinationOffset = offsetof(sgfx::ModelVertex, normal),
+        },
+    };
+
+    std::vector<sgfx::ModelVertex> vertices(600u);
+    sgfx::convertAttributesToFloats(attributes, reinterpret_cast<std::byte*>(vertices.data()), sizeof(sgfx::ModelVertex));
+
+    SGFX_CHECK(vertices[599].position.z == 1.0f);
+    SGFX_CHECK(vertices[299].normal.z == 2.0f);
+    SGFX_CHECK(vertices[300].normal.x == 0.0f);
+}
+
+SGFX_TEST(AccessorConversionIndices)
+{
+    std::vector<uint8_t> byteIndices(37u);
+    std::iota(byteIndices.begin(), byteIndices.end(), uint8_t{200u});
+
+    std::vector<uint32_t> indices(byteIndices.size());
+    sgfx::convertIndices(sgfx::AccessorView{.data = byteIndices.data(), .byteStride = 1u, .count = 37u, .componentType = GLTF_UNSIGNED_BYTE, .componentCount = 1u},
+                         indices.data());
+
+    SGFX_CHECK(std::ranges::equal(indices, byteIndices, {}, {}, [](const uint8_t index) { return uint32_t{index}; }));
+}
@@ -0,0 +1,234 @@
+#include "Pch.hpp"
+
+#include "Bvh.hpp"
+#include "Frustum.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    // Boxes scattered in a cube, standing in for the meshes of a scene.
+    std::vector<sgfx::AxisAlignedBoundingBox> createBoxes(const uint32_t boxCount, const uint32_t seed)
+    {
+        std::mt19937 randomEngine(seed);
+        std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> sizeDistribution(0.1f, 4.0f);
+
+        std::vector<sgfx::AxisAlignedBoundingBox> boxes(boxCount);
+        for (sgfx::AxisAlignedBoundingBox& box : boxes)
+        {
+            const math::XMFLOAT3 center = {positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)};
+            const math::XMFLOAT3 extent = {sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine)};
+
+            box = sgfx::AxisAlignedBoundingBox{
+                .minimum = {center.x - extent.x, center.y - extent.y, center.z - extent.z},
+                .maximum = {center.x + extent.x, center.y + extent.y, center.z + extent.z},
+            };
+        }
+
+        return boxes;
+    }
+
+    // A camera looking at the cube from outside, with fields of view from narrow to wide.
+    std::array<sgfx::Frustum, 4> createFrustums()
+    {
+        const math::XMMATRIX viewMatrix =
+            math::XMMatrixLookAtLH(math::XMVectorSet(20.0f, 10.0f, -150.0f, 1.0f), math::XMVectorZero(), math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+        std::array<sgfx::Frustum, 4> frustums{};
+        for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(frustums.size())))
+        {
+            frustums[i] = sgfx::createFrustum(viewMatrix * math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(10.0f + 20.0f * i), 16.0f / 9.0f, 1.0f, 200.0f));
+        }
+
+        return frustums;
+    }
+
+    // Every box in the frustum must be returned (the query is conservative), and no box twice.
+    bool isConservative(const sgfx::Frustum& frustum, std::span<const sgfx::AxisAlignedBoundingBox> boxes, std::vector<uint32_t> primitives)
+    {
+        std::ranges::sort(primitives);
+        if (std::ranges::adjacent_find(primitives) != primitives.end())
+        {
+            return false;
+        }
+
+        for (const uint32_t boxIndex : std::views::iota(0u, static_cast<uint32_t>(boxes.size())))
+        {
+            if (sgfx::isAabbInFrustum(frustum, boxes[boxIndex]) && !std::ranges::binary_search(primitives, boxIndex))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // The BVH's closest hit must be at the distance of the closest box found by testing them all.
+    bool isClosestHit(const sgfx::Bvh& bvh, std::span<const sgfx::AxisAlignedBoundingBox> boxes, const sgfx::Ray& ray)
+    {
+        float closestDistance = std::numeric_limits<float>::infinity();
+        for (const sgfx::AxisAlignedBoundingBox& box : boxes)
+        {
+            closestDistance = std::min(closestDistance, sgfx::intersectRayAabb(ray, box));
+        }
+
+        const auto intersectBox = [&](const uint32_t boxIndex, const sgfx::Ray& boxRay, const float) { return sgfx::intersectRayAabb(boxRay, boxes[boxIndex]); };
+        const sgfx::BvhRayHit hit = bvh.raycast(ray, intersectBox);
+
+        if (!hit.isHit())
+        {
+            return std::isinf(closestDistance);
+        }
+
+        return hit.distance == closestDistance && sgfx::intersectRayAabb(ray, boxes[hit.primitiveIndex]) == closestDistance;
+    }
+
+    std::vector<sgfx::Ray> createRays(const uint32_t rayCount)
+    {
+        std::mt19937 randomEngine(5u);
+        std::uniform_real_distribution<float> distribution(-120.0f, 120.0f);
+
+        std::vector<sgfx::Ray> rays(rayCount);
+        for (sgfx::Ray& ray : rays)
+        {
+            ray.origin = {distribution(randomEngine), distribution(randomEngine), distribution(randomEngine)};
+            ray.direction = {distribution(randomEngine), distribution(randomEngine), distribution(randomEngine)};
+        }
+
+        return rays;
+    }
+}
+
+SGFX_TEST(BvhBuild)
+{
+    const std::vector<sgfx::AxisAlignedBoundingBox> boxes = createBoxes(1000u, 3u);
+
+    sgfx::Bvh bvh{};
+    bvh.build(boxes);
+
+    SGFX_CHECK(bvh.getPrimitiveCount() == boxes.size());
+    SGFX_CHECK(bvh.getNodeCount() > 0u);
+
+    // The root covers every box, tightly.
+    const sgfx::AxisAlignedBoundingBox bounds = bvh.getBounds();
+    const auto minimum = std::ranges::min(boxes | std::views::transform([](const sgfx::AxisAlignedBoundingBox& box) { return box.minimum.x; }));
+    const auto maximum = std::ranges::max(boxes | std::views::transform([](const sgfx::AxisAlignedBoundingBox& box) { return box.maximum.z; }));
+    SGFX_CHECK(bounds.minimum.x == minimum && bounds.maximum.z == maximum);
+
+    // An empty BVH returns nothing.
+    sgfx::Bvh emptyBvh{};
+    emptyBvh.build({});
+
+    std::vector<uint32_t> primitives{};
+    emptyBvh.queryFrustum(createFrustums()[0], primitives);
+    SGFX_CHECK(emptyBvh.getNodeCount() == 0u && primitives.empty());
+    SGFX_CHECK(!emptyBvh.raycast(sgfx::Ray{.direction = {0.0f, 0.0f, 1.0f}}, [](const uint32_t, const sgfx::Ray&, const float) { return 0.0f; }).isHit());
+}
+
+SGFX_TEST(BvhFrustumQueries)
+{
+    const std::vector<sgfx::AxisAlignedBoundingBox> boxes = createBoxes(5000u, 11u);
+    const std::array<sgfx::Frustum, 4> frustums = createFrustums();
+
+    for (const uint32_t maxLeafPrimitiveCount : {1u, 4u, 16u})
+    {
+        sgfx::Bvh bvh{};
+        bvh.build(boxes, maxLeafPrimitiveCount);
+
+        std::array<std::vector<uint32_t>, 4> queryResults{};
+        bvh.queryFrustums(frustums, queryResults);
+
+        for (const size_t i : std::views::iota(size_t{0u}, frustums.size()))
+        {
+            SGFX_CHECK(isConservative(frustums[i], boxes, queryResults[i]));
+
+            // Querying the frustums together returns what querying them one at a time does.
+            std::vector<uint32_t> primitives{};
+            bvh.queryFrustum(frustums[i], primitives);
+
+            std::ranges::sort(primitives);
+            std::ranges::sort(queryResults[i]);
+            SGFX_CHECK(primitives == queryResults[i]);
+        }
+
+        // Wider frustums contain narrower ones, so they return at least as many boxes. The narrowest one still culls most of them.
+        SGFX_CHECK(queryResults[0].size() <= queryResults[3].size());
+        SGFX_CHECK(queryResults[0].size() < boxes.size() / 2u);
+    }
+}
+
+SGFX_TEST(BvhRaycastFindsClosestHit)
+{
+    const std::vector<sgfx::AxisAlignedBoundingBox> boxes = createBoxes(2000u, 13u);
+
+    sgfx::Bvh bvh{};
+    bvh.build(boxes);
+
+    uint32_t hitCount = 0u;
+    for (const sgfx::Ray& ray : createRays(500u))
+    {
+        SGFX_CHECK(isClosestHit(bvh, boxes, ray));
+
+        const auto intersectBox = [&](const uint32_t boxIndex, const sgfx::Ray& boxRay, const float) { return sgfx::intersectRayAabb(boxRay, boxes[boxIndex]); };
+        hitCount += bvh.raycast(ray, intersectBox).isHit() ? 1u : 0u;
+    }
+
+    // Both hits and misses are covered.
+    SGFX_CHECK(hitCount > 0u && hitCount < 500u);
+
+    // Hits beyond the ray's maximum distance are ignored.
+    const sgfx::Ray shortRay{.origin = {0.0f, 0.0f, -1000.0f}, .direction = {0.0f, 0.0f, 1.0f}, .maxDistance = 10.0f};
+    SGFX_CHECK(isClosestHit(bvh, boxes, shortRay));
+}
+
+SGFX_TEST(BvhRefit)
+{
+    std::vector<sgfx::AxisAlignedBoundingBox> boxes = createBoxes(2000u, 17u);
+
+    sgfx::Bvh bvh{};
+    bvh.build(boxes);
+
+    // Move every box by a different offset, far enough for the tree to no longer match its bounds without a refit.
+    std::mt19937 randomEngine(19u);
+    std::uniform_real_distribution<float> offsetDistribution(-30.0f, 30.0f);
+
+    for (sgfx::AxisAlignedBoundingBox& box : boxes)
+    {
+        const math::XMFLOAT3 offset = {offsetDistribution(randomEngine), offsetDistribution(randomEngine), offsetDistribution(randomEngine)};
+
+        box.minimum = {box.minimum.x + offset.x, box.minimum.y + offset.y, box.minimum.z + offset.z};
+        box.maximum = {box.maximum.x + offset.x, box.maximum.y + offset.y, box.maximum.z + offset.z};
+    }
+
+    bvh.refit(boxes);
+
+    for (const sgfx::Frustum& frustum : createFrustums())
+    {
+        std::vector<uint32_t> primitives{};
+        bvh.queryFrustum(frustum, primitives);
+        SGFX_CHECK(isConservative(frustum, boxes, primitives));
+    }
+
+    for (const sgfx::Ray& ray : createRays(200u))
+    {
+        SGFX_CHECK(isClosestHit(bvh, boxes, ray));
+    }
+}
+
+SGFX_TEST(RayIntersections)
+{
+    const sgfx::Ray ray{.origin = {0.25f, 0.25f, -2.0f}, .direction = {0.0f, 0.0f, 2.0f}};
+
+    // Distances are in units of the direction's length, and both sides of a triangle are hit.
+    SGFX_CHECK(sgfx::intersectRayTriangle(ray, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}) == 1.0f);
+    SGFX_CHECK(sgfx::intersectRayTriangle(ray, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}) == 1.0f);
+    SGFX_CHECK(std::isinf(sgfx::intersectRayTriangle(ray, {1.0f, 1.0f, 0.0f}, {2.0f, 1.0f, 0.0f}, {1.0f, 2.0f, 0.0f})));
+
+    const sgfx::Ray shortRay{.origin = ray.origin, .direction = ray.direction, .maxDistance = 0.5f};
+    SGFX_CHECK(std::isinf(sgfx::intersectRayTriangle(shortRay, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f})));
+
+    const sgfx::AxisAlignedBoundingBox box{.minimum = {0.0f, 0.0f, 0.0f}, .maximum = {1.0f, 1.0f, 1.0f}};
+    SGFX_CHECK(sgfx::intersectRayAabb(ray, box) == 1.0f);
+    SGFX_CHECK(sgfx::intersectRayAabb(sgfx::Ray{.origin = {0.5f, 0.5f, 0.5f}, .direction = {1.0f, 0.0f, 0.0f}}, box) == 0.0f);
+    SGFX_CHECK(std::isinf(sgfx::intersectRayAabb(sgfx::Ray{.origin = {2.0f, 0.0f, -2.0f}, .direction = {0.0f, 0.0f, 1.0f}}, box)));
+}
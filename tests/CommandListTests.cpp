@@ -0,0 +1,133 @@
+#include "Pch.hpp"
+
+#include "CommandList.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    // Records drawCount draws, each after binding its constant buffer (a stand in handle derived from the draw index).
+    void recordDraws(sgfx::CommandList& commandList, const uint32_t firstDraw, const uint32_t drawCount)
+    {
+        for (const uint32_t draw : std::views::iota(firstDraw, firstDraw + drawCount))
+        {
+            commandList.record(sgfx::SetConstantBufferCommand{.buffer = reinterpret_cast<sgfx::BackendHandle>(uintptr_t{draw} + 1u), .stage = sgfx::ShaderStage::Vertex, .slot = 1u});
+            commandList.record(sgfx::DrawIndexedCommand{.indexCount = 3u, .firstIndex = draw * 3u, .baseVertex = -static_cast<int32_t>(draw)});
+        }
+    }
+
+    // Checks the list holds exactly the commands of recordDraws(commandList, 0, drawCount), in order.
+    bool hasDraws(const sgfx::CommandList& commandList, const uint32_t drawCount)
+    {
+        uint32_t commandIndex = 0u;
+        bool isMatching = true;
+
+        commandList.forEach(
+            [&]<typename T>(const T& command)
+            {
+                const uint32_t draw = commandIndex / 2u;
+
+                if constexpr (std::is_same_v<T, sgfx::SetConstantBufferCommand>)
+                {
+                    isMatching &= commandIndex % 2u == 0u && command.buffer == reinterpret_cast<sgfx::BackendHandle>(uintptr_t{draw} + 1u) &&
+                                  command.stage == sgfx::ShaderStage::Vertex && command.slot == 1u;
+                }
+                else if constexpr (std::is_same_v<T, sgfx::DrawIndexedCommand>)
+                {
+                    isMatching &= commandIndex % 2u == 1u && command.indexCount == 3u && command.firstIndex == draw * 3u && command.baseVertex == -static_cast<int32_t>(draw);
+                }
+                else
+                {
+                    isMatching = false;
+                }
+
+                commandIndex++;
+            });
+
+        return isMatching && commandIndex == drawCount * 2u && commandList.getCommandCount() == drawCount * 2u && commandList.getDrawCount() == drawCount;
+    }
+}
+
+SGFX_TEST(CommandListRecordsInOrder)
+{
+    sgfx::CommandList commandList{};
+    SGFX_CHECK(commandList.getCommandCount() == 0u && commandList.getSize() == 0u);
+
+    // Every command type is visited as itself, with its fields intact.
+    const std::array<float, 4> clearColor = {0.1f, 0.2f, 0.3f, 1.0f};
+    commandList.record(sgfx::ClearRenderTargetCommand{.color = clearColor});
+    commandList.record(sgfx::SetViewportCommand{.width = 1920.0f, .height = 1080.0f});
+    commandList.record(sgfx::DrawCommand{.vertexCount = 3u});
+    commandList.record(sgfx::DrawIndexedInstancedCommand{.indexCount = 36u, .instanceCount = 4u, .firstInstance = 2u});
+
+    std::vector<sgfx::CommandType> commandTypes{};
+    commandList.forEach(
+        [&]<typename T>(const T& command)
+        {
+            commandTypes.push_back(T::TYPE);
+
+            if constexpr (std::is_same_v<T, sgfx::ClearRenderTargetCommand>)
+            {
+                SGFX_CHECK(command.color == clearColor);
+            }
+            else if constexpr (std::is_same_v<T, sgfx::SetViewportCommand>)
+            {
+                SGFX_CHECK(command.width == 1920.0f && command.height == 1080.0f && command.maximumDepth == 1.0f);
+            }
+            else if constexpr (std::is_same_v<T, sgfx::DrawIndexedInstancedCommand>)
+            {
+                SGFX_CHECK(command.indexCount == 36u && command.instanceCount == 4u && command.firstInstance == 2u);
+            }
+        });
+
+    SGFX_CHECK((commandTypes == std::vector<sgfx::CommandType>{sgfx::CommandType::ClearRenderTarget, sgfx::CommandType::SetViewport, sgfx::CommandType::Draw,
+                                                              sgfx::CommandType::DrawIndexedInstanced}));
+    SGFX_CHECK(commandList.getDrawCount() == 2u);
+}
+
+SGFX_TEST(CommandListSpansBlocks)
+{
+    // Far more than a block's worth of commands.
+    constexpr uint32_t DRAW_COUNT = 20'000u;
+
+    sgfx::CommandList commandList{};
+    recordDraws(commandList, 0u, DRAW_COUNT);
+
+    SGFX_CHECK(hasDraws(commandList, DRAW_COUNT));
+    SGFX_CHECK(commandList.getSize() > sgfx::CommandList::BLOCK_SIZE);
+
+    // Reset forgets the commands, and the list records the same way once reused.
+    commandList.reset();
+    SGFX_CHECK(commandList.getCommandCount() == 0u && commandList.getDrawCount() == 0u && commandList.getSize() == 0u);
+    SGFX_CHECK(hasDraws(commandList, 0u));
+
+    recordDraws(commandList, 0u, DRAW_COUNT / 2u);
+    SGFX_CHECK(hasDraws(commandList, DRAW_COUNT / 2u));
+}
+
+SGFX_TEST(CommandListAppend)
+{
+    // Ranges recorded by separate lists (as threads do) and appended in order, some spanning several blocks and one empty.
+    constexpr std::array<uint32_t, 5> FIRST_DRAWS = {0u, 10u, 10u, 9'000u, 9'001u};
+    constexpr uint32_t DRAW_COUNT = 15'000u;
+
+    sgfx::CommandList mergedCommandList{};
+    mergedCommandList.record(sgfx::SetConstantBufferCommand{.buffer = reinterpret_cast<sgfx::BackendHandle>(uintptr_t{1u}), .stage = sgfx::ShaderStage::Vertex, .slot = 1u});
+    mergedCommandList.reset();
+
+    std::vector<sgfx::CommandList> commandLists(FIRST_DRAWS.size());
+    for (const size_t i : std::views::iota(size_t{0u}, FIRST_DRAWS.size()))
+    {
+        const uint32_t lastDraw = i + 1u < FIRST_DRAWS.size() ? FIRST_DRAWS[i + 1u] : DRAW_COUNT;
+        recordDraws(commandLists[i], FIRST_DRAWS[i], lastDraw - FIRST_DRAWS[i]);
+    }
+
+    for (const sgfx::CommandList& commandList : commandLists)
+    {
+        mergedCommandList.append(commandList);
+    }
+
+    SGFX_CHECK(hasDraws(mergedCommandList, DRAW_COUNT));
+
+    // Appending copies, leaving the source lists as they were.
+    SGFX_CHECK(commandLists[3].getCommandCount() == 2u);
+}
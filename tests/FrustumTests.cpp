@@ -0,0 +1,120 @@
+#include "Pch.hpp"
+
+#include "Frustum.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    const math::XMMATRIX VIEW_MATRIX =
+        math::XMMatrixLookAtLH(math::XMVectorSet(20.0f, 10.0f, -150.0f, 1.0f), math::XMVectorZero(), math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+    const sgfx::Frustum FRUSTUM = sgfx::createFrustum(VIEW_MATRIX * math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(30.0f), 16.0f / 9.0f, 1.0f, 200.0f));
+
+    struct BoundingVolume
+    {
+        sgfx::AxisAlignedBoundingBox box{};
+        math::XMFLOAT3 sphereCenter{};
+        float sphereRadius{};
+    };
+
+    // Boxes scattered around the frustum, so about half of them are culled. Their spheres are shifted and shrunk at random, so some objects are
+    // only culled by their sphere.
+    std::vector<BoundingVolume> createBoundingVolumes(const uint32_t count, const uint32_t seed)
+    {
+        std::mt19937 randomEngine(seed);
+        std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> sizeDistribution(0.1f, 10.0f);
+        std::uniform_real_distribution<float> sphereDistribution(0.0f, 1.0f);
+
+        std::vector<BoundingVolume> volumes(count);
+        for (BoundingVolume& volume : volumes)
+        {
+            const math::XMFLOAT3 center = {positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)};
+            const math::XMFLOAT3 extent = {sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine)};
+
+            volume.box = sgfx::AxisAlignedBoundingBox{
+                .minimum = {center.x - extent.x, center.y - extent.y, center.z - extent.z},
+                .maximum = {center.x + extent.x, center.y + extent.y, center.z + extent.z},
+            };
+
+            volume.sphereCenter = {center.x + extent.x * sphereDistribution(randomEngine), center.y, center.z - extent.z * sphereDistribution(randomEngine)};
+            volume.sphereRadius = std::max({extent.x, extent.y, extent.z}) * (0.5f + sphereDistribution(randomEngine));
+        }
+
+        return volumes;
+    }
+
+    // The SSE2 path is always available, the AVX2 one only if the CPU has it.
+    std::vector<sgfx::CpuFeatures> getTestedCpuFeatures()
+    {
+        std::vector<sgfx::CpuFeatures> cpuFeatures = {sgfx::CpuFeatures{}};
+        if (sgfx::getCpuFeatures().avx2)
+        {
+            cpuFeatures.push_back(sgfx::CpuFeatures{.avx2 = true});
+        }
+
+        return cpuFeatures;
+    }
+}
+
+SGFX_TEST(FrustumPlanesPointInwards)
+{
+    const math::XMFLOAT3 target = {0.0f, 0.0f, 0.0f};
+    const math::XMFLOAT3 behindCamera = {20.0f, 10.0f, -160.0f};
+    const math::XMFLOAT3 beyondFarPlane = {0.0f, 0.0f, 100.0f};
+
+    SGFX_CHECK(sgfx::isSphereInFrustum(FRUSTUM, target, 0.0f));
+    SGFX_CHECK(!sgfx::isSphereInFrustum(FRUSTUM, behindCamera, 1.0f));
+    SGFX_CHECK(!sgfx::isSphereInFrustum(FRUSTUM, beyondFarPlane, 1.0f));
+
+    // Large enough to reach back into the frustum.
+    SGFX_CHECK(sgfx::isSphereInFrustum(FRUSTUM, beyondFarPlane, 60.0f));
+
+    SGFX_CHECK(sgfx::isAabbInFrustum(FRUSTUM, sgfx::AxisAlignedBoundingBox{.minimum = {-1.0f, -1.0f, -1.0f}, .maximum = {1.0f, 1.0f, 1.0f}}));
+    SGFX_CHECK(!sgfx::isAabbInFrustum(FRUSTUM, sgfx::AxisAlignedBoundingBox{.minimum = {-1.0f, -1.0f, 99.0f}, .maximum = {1.0f, 1.0f, 101.0f}}));
+}
+
+SGFX_TEST(CullBoundingVolumesMatchesScalarTests)
+{
+    // Counts with and without a remainder after the groups of 4 (SSE2) and 8 (AVX2) objects, which are tested by the scalar tail.
+    constexpr std::array<uint32_t, 12> COUNTS = {0u, 1u, 3u, 4u, 5u, 7u, 8u, 9u, 15u, 16u, 17u, 1003u};
+
+    for (const uint32_t count : COUNTS)
+    {
+        const std::vector<BoundingVolume> volumes = createBoundingVolumes(count, count + 11u);
+
+        sgfx::BoundingVolumes soaVolumes{};
+        soaVolumes.resize(count);
+
+        std::vector<uint8_t> expectedIsVisible(count);
+        uint32_t expectedVisibleCount = 0u;
+
+        for (const uint32_t i : std::views::iota(0u, count))
+        {
+            const BoundingVolume& volume = volumes[i];
+            soaVolumes.set(i, volume.box, volume.sphereCenter, volume.sphereRadius);
+
+            expectedIsVisible[i] = sgfx::isAabbInFrustum(FRUSTUM, volume.box) && sgfx::isSphereInFrustum(FRUSTUM, volume.sphereCenter, volume.sphereRadius) ? 1u : 0u;
+            expectedVisibleCount += expectedIsVisible[i];
+        }
+
+        // Both outcomes are covered, and the sphere rejects objects the box alone does not.
+        if (count == COUNTS.back())
+        {
+            const auto isBoxVisible = [&](const BoundingVolume& volume) { return sgfx::isAabbInFrustum(FRUSTUM, volume.box); };
+
+            SGFX_CHECK(expectedVisibleCount > count / 10u && expectedVisibleCount < count - count / 10u);
+            SGFX_CHECK(static_cast<uint32_t>(std::ranges::count_if(volumes, isBoxVisible)) > expectedVisibleCount);
+        }
+
+        for (const sgfx::CpuFeatures& cpuFeatures : getTestedCpuFeatures())
+        {
+            // Filled with a value neither path writes, so every entry must be written.
+            std::vector<uint8_t> isVisible(count, 0xffu);
+            const uint32_t visibleCount = sgfx::cullBoundingVolumes(FRUSTUM, soaVolumes, isVisible, cpuFeatures);
+
+            SGFX_CHECK(visibleCount == expectedVisibleCount);
+            SGFX_CHECK(isVisible == expectedIsVisible);
+        }
+    }
+}
@@ -0,0 +1,261 @@
+#include "Pch.hpp"
+
+#include "JobSystem.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    // Spins until the flag is set, so a test can hold a worker busy.
+    void spinUntil(const std::atomic<bool>& flag)
+    {
+        while (!flag.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+SGFX_TEST(JobSystemSubmitAndWait)
+{
+    sgfx::JobSystem jobSystem{3u};
+
+    constexpr uint32_t JOB_COUNT = 1000u;
+
+    std::atomic<uint32_t> completedJobCount{0u};
+    sgfx::JobCounter counter{};
+
+    for (uint32_t i = 0u; i < JOB_COUNT; i++)
+    {
+        jobSystem.submit([&]() { completedJobCount.fetch_add(1u, std::memory_order_relaxed); }, counter);
+    }
+
+    jobSystem.wait(counter);
+    SGFX_CHECK(completedJobCount.load() == JOB_COUNT);
+
+    // A counter can be reused once it reached zero.
+    jobSystem.submit([&]() { completedJobCount.fetch_add(1u, std::memory_order_relaxed); }, counter);
+    jobSystem.wait(counter);
+    SGFX_CHECK(completedJobCount.load() == JOB_COUNT + 1u);
+}
+
+SGFX_TEST(JobSystemParallelFor)
+{
+    sgfx::JobSystem jobSystem{3u};
+
+    constexpr uint32_t COUNT = 10'001u;
+
+    std::vector<uint32_t> visitCounts(COUNT);
+    sgfx::JobCounter counter{};
+
+    jobSystem.parallelFor(COUNT, 64u, [&](const uint32_t i) { visitCounts[i]++; }, counter);
+    jobSystem.wait(counter);
+
+    SGFX_CHECK(std::ranges::all_of(visitCounts, [](const uint32_t visitCount) { return visitCount == 1u; }));
+}
+
+SGFX_TEST(JobSystemNestedWait)
+{
+    // A single worker, so waits nested in jobs can only make progress by running the jobs they wait on themselves.
+    sgfx::JobSystem jobSystem{1u};
+
+    constexpr uint32_t OUTER_JOB_COUNT = 8u;
+    constexpr uint32_t INNER_JOB_COUNT = 16u;
+
+    std::atomic<uint32_t> innerJobCount{0u};
+    std::array<bool, OUTER_JOB_COUNT> areInnerJobsDone{};
+    sgfx::JobCounter outerCounter{};
+
+    for (uint32_t i = 0u; i < OUTER_JOB_COUNT; i++)
+    {
+        jobSystem.submit(
+            [&, i]()
+            {
+                std::atomic<uint32_t> completedJobCount{0u};
+                sgfx::JobCounter innerCounter{};
+
+                for (uint32_t j = 0u; j < INNER_JOB_COUNT; j++)
+                {
+                    jobSystem.submit(
+                        [&]()
+                        {
+                            completedJobCount.fetch_add(1u, std::memory_order_relaxed);
+                            innerJobCount.fetch_add(1u, std::memory_order_relaxed);
+                        },
+                        innerCounter);
+                }
+
+                jobSystem.wait(innerCounter);
+                areInnerJobsDone[i] = completedJobCount.load() == INNER_JOB_COUNT;
+            },
+            outerCounter);
+    }
+
+    jobSystem.wait(outerCounter);
+
+    SGFX_CHECK(innerJobCount.load() == OUTER_JOB_COUNT * INNER_JOB_COUNT);
+    SGFX_CHECK(std::ranges::all_of(areInnerJobsDone, std::identity{}));
+}
+
+SGFX_TEST(JobSystemDependency)
+{
+    sgfx::JobSystem jobSystem{3u};
+
+    std::atomic<uint32_t> firstJobCount{0u};
+    std::atomic<bool> isOrderRespected{true};
+
+    sgfx::JobCounter firstCounter{};
+    sgfx::JobCounter secondCounter{};
+
+    for (uint32_t i = 0u; i < 32u; i++)
+    {
+        jobSystem.submit(
+            [&]()
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                firstJobCount.fetch_add(1u, std::memory_order_relaxed);
+            },
+            firstCounter);
+    }
+
+    for (uint32_t i = 0u; i < 8u; i++)
+    {
+        jobSystem.submit(
+            [&]()
+            {
+                if (firstJobCount.load() != 32u)
+                {
+                    isOrderRespected = false;
+                }
+            },
+            secondCounter,
+            &firstCounter);
+    }
+
+    jobSystem.wait(secondCounter);
+    jobSystem.wait(firstCounter);
+
+    SGFX_CHECK(isOrderRespected.load());
+}
+
+SGFX_TEST(JobSystemExceptionRethrownFromWait)
+{
+    sgfx::JobSystem jobSystem{2u};
+
+    std::atomic<uint32_t> completedJobCount{0u};
+    sgfx::JobCounter counter{};
+
+    for (uint32_t i = 0u; i < 16u; i++)
+    {
+        jobSystem.submit(
+            [&, i]()
+            {
+                if (i == 5u)
+                {
+                    throw std::runtime_error("job 5 failed");
+                }
+
+                completedJobCount.fetch_add(1u, std::memory_order_relaxed);
+            },
+            counter);
+    }
+
+    bool isRethrown = false;
+    try
+    {
+        jobSystem.wait(counter);
+    }
+    catch (const std::runtime_error& exception)
+    {
+        isRethrown = std::string_view(exception.what()) == "job 5 failed";
+    }
+
+    SGFX_CHECK(isRethrown);
+
+    // The other jobs still ran, and the exception is only rethrown once.
+    SGFX_CHECK(completedJobCount.load() == 15u);
+
+    jobSystem.submit([]() {}, counter);
+    jobSystem.wait(counter);
+}
+
+SGFX_TEST(JobSystemLowPriorityJobsSkippedByNormalWaits)
+{
+    sgfx::JobSystem jobSystem{1u};
+
+    // Keep the only worker busy, so only the waiting thread can run the jobs below.
+    std::atomic<bool> isWorkerBusy{false};
+    std::atomic<bool> isWorkerReleased{false};
+    sgfx::JobCounter blockingCounter{};
+
+    jobSystem.submit(
+        [&]()
+        {
+            isWorkerBusy = true;
+            spinUntil(isWorkerReleased);
+        },
+        blockingCounter);
+
+    spinUntil(isWorkerBusy);
+
+    std::atomic<bool> isLowPriorityJobDone{false};
+    sgfx::JobCounter lowPriorityCounter{sgfx::JobPriority::Low};
+    jobSystem.submit([&]() { isLowPriorityJobDone = true; }, lowPriorityCounter);
+
+    std::atomic<bool> isNormalJobDone{false};
+    sgfx::JobCounter normalCounter{};
+    jobSystem.submit([&]() { isNormalJobDone = true; }, normalCounter);
+
+    jobSystem.wait(normalCounter);
+
+    SGFX_CHECK(isNormalJobDone.load());
+    SGFX_CHECK(!isLowPriorityJobDone.load());
+
+    // Waiting on the low priority counter runs the job.
+    jobSystem.wait(lowPriorityCounter);
+    SGFX_CHECK(isLowPriorityJobDone.load());
+
+    isWorkerReleased = true;
+    jobSystem.wait(blockingCounter);
+}
+
+SGFX_TEST(ScopedJobWaitWaitsWhenUnwinding)
+{
+    sgfx::JobSystem jobSystem{1u};
+
+    std::atomic<bool> isJobDone{false};
+
+    try
+    {
+        sgfx::JobCounter counter{};
+        const sgfx::ScopedJobWait counterWait(jobSystem, counter);
+
+        jobSystem.submit(
+            [&]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                isJobDone = true;
+            },
+            counter);
+
+        throw std::runtime_error("caller failed");
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+
+    SGFX_CHECK(isJobDone.load());
+
+    // Exceptions of the jobs are dropped while unwinding instead of terminating.
+    try
+    {
+        sgfx::JobCounter counter{};
+        const sgfx::ScopedJobWait counterWait(jobSystem, counter);
+
+        jobSystem.submit([]() { throw std::runtime_error("job failed"); }, counter);
+
+        throw std::logic_error("caller failed");
+    }
+    catch (const std::logic_error&)
+    {
+    }
+}
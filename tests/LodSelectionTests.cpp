@@ -0,0 +1,74 @@
+#include "Pch.hpp"
+
+#include "Model.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    // Each LOD has four times the error of the previous one, as powers of two so the projected errors are exact.
+    constexpr std::array<sgfx::MeshLod, 4> LODS = {{
+        {.indexCount = 3u * 256u, .error = 0.0f},
+        {.indexCount = 3u * 128u, .error = 0.0625f},
+        {.indexCount = 3u * 64u, .error = 0.25f},
+        {.indexCount = 3u * 32u, .error = 1.0f},
+    }};
+}
+
+SGFX_TEST(LodSelectionPicksTheCoarsestLodWithinTheErrorThreshold)
+{
+    const sgfx::LodSelectionDesc lodSelectionDesc = {.errorThreshold = 1.0f, .hysteresis = 0.0f};
+
+    // The error scale grows as the mesh gets closer : every LOD within the threshold, then one less each time the scale is multiplied by 4.
+    SGFX_CHECK(sgfx::selectLod(LODS, 0u, 1.0f, lodSelectionDesc) == 3u);
+    SGFX_CHECK(sgfx::selectLod(LODS, 0u, 4.0f, lodSelectionDesc) == 2u);
+    SGFX_CHECK(sgfx::selectLod(LODS, 0u, 16.0f, lodSelectionDesc) == 1u);
+    SGFX_CHECK(sgfx::selectLod(LODS, 0u, 17.0f, lodSelectionDesc) == 0u);
+
+    // The previous LOD does not matter without hysteresis.
+    for (const uint32_t previousLod : std::views::iota(0u, 4u))
+    {
+        SGFX_CHECK(sgfx::selectLod(LODS, previousLod, 4.0f, lodSelectionDesc) == 2u);
+    }
+
+    // A larger threshold allows coarser LODs.
+    SGFX_CHECK(sgfx::selectLod(LODS, 0u, 16.0f, sgfx::LodSelectionDesc{.errorThreshold = 4.0f, .hysteresis = 0.0f}) == 2u);
+
+    // The full resolution is kept however close the mesh is, and a mesh without LODs always draws it.
+    SGFX_CHECK(sgfx::selectLod(LODS, 3u, 1.0e6f, lodSelectionDesc) == 0u);
+    SGFX_CHECK(sgfx::selectLod(std::span(LODS).first(1u), 2u, 1.0f, lodSelectionDesc) == 0u);
+}
+
+SGFX_TEST(LodSelectionHysteresis)
+{
+    // Coarsens once the next LOD's projected error is at most 0.75 pixels, refines once the current one's is above 1 pixel.
+    const sgfx::LodSelectionDesc lodSelectionDesc = {.errorThreshold = 1.0f, .hysteresis = 0.25f};
+
+    // LOD 1 projects to 0.875 pixels : kept if drawn, but not switched to from the full resolution.
+    SGFX_CHECK(sgfx::selectLod(LODS, 0u, 14.0f, lodSelectionDesc) == 0u);
+    SGFX_CHECK(sgfx::selectLod(LODS, 1u, 14.0f, lodSelectionDesc) == 1u);
+
+    // Within the margin on both sides.
+    SGFX_CHECK(sgfx::selectLod(LODS, 0u, 12.0f, lodSelectionDesc) == 1u);
+    SGFX_CHECK(sgfx::selectLod(LODS, 1u, 17.0f, lodSelectionDesc) == 0u);
+
+    // Unlike without hysteresis, LOD 3 (1 pixel) is not switched to, but still kept if drawn.
+    SGFX_CHECK(sgfx::selectLod(LODS, 0u, 1.0f, lodSelectionDesc) == 2u);
+    SGFX_CHECK(sgfx::selectLod(LODS, 3u, 1.0f, lodSelectionDesc) == 3u);
+
+    // Refining skips every LOD too coarse at once.
+    SGFX_CHECK(sgfx::selectLod(LODS, 3u, 16.0f, lodSelectionDesc) == 1u);
+
+    // A mesh moving back and forth around a switching distance switches once, then stays.
+    uint32_t selectedLod = 0u;
+    uint32_t switchCount = 0u;
+
+    for (const float errorScale : {15.0f, 13.0f, 15.0f, 13.0f, 11.0f, 13.0f, 15.0f, 13.0f, 15.0f})
+    {
+        const uint32_t lod = sgfx::selectLod(LODS, selectedLod, errorScale, lodSelectionDesc);
+
+        switchCount += lod != selectedLod ? 1u : 0u;
+        selectedLod = lod;
+    }
+
+    SGFX_CHECK(selectedLod == 1u && switchCount == 1u);
+}
@@ -0,0 +1,192 @@
+#include "Pch.hpp"
+
+#include "MeshOptimizer.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<sgfx::ModelVertex> vertices{};
+        std::vector<uint32_t> indices{};
+    };
+
+    // A grid of size x size quads over [0, 1]^2 with bumps along z (so overdraw has outward facing clusters to sort), in scanline order.
+    TestMesh createGrid(const uint32_t size)
+    {
+        TestMesh mesh{};
+
+        for (uint32_t y = 0u; y <= size; y++)
+        {
+            for (uint32_t x = 0u; x <= size; x++)
+            {
+                const float u = static_cast<float>(x) / size;
+                const float v = static_cast<float>(y) / size;
+
+                mesh.vertices.push_back(sgfx::ModelVertex{.position = {u, v, 0.1f * std::sin(6.0f * u) * std::cos(6.0f * v)}, .textureCoord = {u, v}, .normal = {0.0f, 0.0f, 1.0f}});
+            }
+        }
+
+        const uint32_t rowLength = size + 1u;
+
+        for (uint32_t y = 0u; y < size; y++)
+        {
+            for (uint32_t x = 0u; x < size; x++)
+            {
+                const uint32_t v00 = y * rowLength + x;
+                const uint32_t v10 = v00 + 1u;
+                const uint32_t v01 = v00 + rowLength;
+                const uint32_t v11 = v01 + 1u;
+
+                mesh.indices.insert(mesh.indices.end(), {v00, v11, v10, v00, v01, v11});
+            }
+        }
+
+        return mesh;
+    }
+
+    // The same grid with its vertices and triangles shuffled, as a mesh exported without any optimization may be.
+    TestMesh createShuffledGrid(const uint32_t size, const uint32_t seed)
+    {
+        TestMesh mesh = createGrid(size);
+        std::mt19937 randomEngine(seed);
+
+        std::vector<uint32_t> remap(mesh.vertices.size());
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::ranges::shuffle(remap, randomEngine);
+
+        std::vector<sgfx::ModelVertex> vertices(mesh.vertices.size());
+        for (const uint32_t i : std::views::iota(0u, static_cast<uint32_t>(mesh.vertices.size())))
+        {
+            vertices[remap[i]] = mesh.vertices[i];
+        }
+
+        std::vector<std::array<uint32_t, 3>> triangles{};
+        for (size_t i = 0u; i < mesh.indices.size(); i += 3u)
+        {
+            triangles.push_back({remap[mesh.indices[i]], remap[mesh.indices[i + 1u]], remap[mesh.indices[i + 2u]]});
+        }
+
+        std::ranges::shuffle(triangles, randomEngine);
+
+        mesh.vertices = std::move(vertices);
+        mesh.indices.clear();
+        for (const std::array<uint32_t, 3>& triangle : triangles)
+        {
+            mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+        }
+
+        return mesh;
+    }
+
+    // Triangles as the positions of their vertices, rotated to start at the smallest one (which keeps the winding) and sorted, so meshes with
+    // the same triangles compare equal whatever the order of their triangles and vertices.
+    std::vector<std::array<std::tuple<float, float, float>, 3>> getSortedTriangles(const TestMesh& mesh)
+    {
+        std::vector<std::array<std::tuple<float, float, float>, 3>> triangles{};
+
+        for (size_t i = 0u; i < mesh.indices.size(); i += 3u)
+        {
+            std::array<std::tuple<float, float, float>, 3> triangle{};
+            for (const uint32_t corner : std::views::iota(0u, 3u))
+            {
+                const math::XMFLOAT3& position = mesh.vertices[mesh.indices[i + corner]].position;
+                triangle[corner] = {position.x, position.y, position.z};
+            }
+
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+            triangles.push_back(triangle);
+        }
+
+        std::ranges::sort(triangles);
+        return triangles;
+    }
+
+    float getAcmr(const TestMesh& mesh) { return sgfx::analyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size())).getAcmr(); }
+    float getAtvr(const TestMesh& mesh) { return sgfx::analyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size())).getAtvr(); }
+
+    float getOverfetch(const TestMesh& mesh)
+    {
+        return sgfx::analyzeVertexFetch(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()), static_cast<uint32_t>(sizeof(sgfx::ModelVertex))).getOverfetch();
+    }
+}
+
+SGFX_TEST(MeshOptimizationsKeepTheTriangles)
+{
+    const TestMesh source = createShuffledGrid(32u, 3u);
+    const auto sourceTriangles = getSortedTriangles(source);
+
+    TestMesh mesh = source;
+
+    sgfx::optimizeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+    SGFX_CHECK(getSortedTriangles(mesh) == sourceTriangles);
+
+    sgfx::optimizeOverdraw(mesh.indices, mesh.vertices);
+    SGFX_CHECK(getSortedTriangles(mesh) == sourceTriangles);
+
+    sgfx::optimizeVertexFetch(mesh.vertices, mesh.indices);
+    SGFX_CHECK(getSortedTriangles(mesh) == sourceTriangles);
+    SGFX_CHECK(mesh.vertices.size() == source.vertices.size());
+}
+
+SGFX_TEST(MeshOptimizationsDoNotRaiseAcmrOrAtvr)
+{
+    // Large enough for the vertices not to fit in the simulated fetch cache.
+    for (const TestMesh& source : {createGrid(64u), createShuffledGrid(64u, 7u)})
+    {
+        TestMesh mesh = source;
+
+        sgfx::optimizeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+
+        const float vertexCacheAcmr = getAcmr(mesh);
+        SGFX_CHECK(vertexCacheAcmr <= getAcmr(source) && getAtvr(mesh) <= getAtvr(source));
+
+        // Scanline order transforms about one vertex per triangle, shuffled order almost three.
+        SGFX_CHECK(vertexCacheAcmr < 0.8f);
+
+        // Overdraw only gives up on the vertex cache within its threshold, and still beats the source order.
+        sgfx::optimizeOverdraw(mesh.indices, mesh.vertices);
+
+        const float overdrawAcmr = getAcmr(mesh);
+        SGFX_CHECK(overdrawAcmr <= vertexCacheAcmr * 1.05f && overdrawAcmr <= getAcmr(source));
+
+        // Renumbering the vertices in order of first use leaves the cache behaviour unchanged, and reads each vertex about once (the shuffled
+        // grid reads more than four times its vertex buffer).
+        const float overdrawOverfetch = getOverfetch(mesh);
+        sgfx::optimizeVertexFetch(mesh.vertices, mesh.indices);
+
+        SGFX_CHECK(getAcmr(mesh) == overdrawAcmr);
+        SGFX_CHECK(getOverfetch(mesh) <= overdrawOverfetch && getOverfetch(mesh) < 1.1f);
+    }
+
+    // Unreferenced vertices are dropped.
+    TestMesh mesh = createGrid(4u);
+    mesh.vertices.resize(mesh.vertices.size() + 3u);
+
+    sgfx::optimizeVertexFetch(mesh.vertices, mesh.indices);
+    SGFX_CHECK(mesh.vertices.size() == 25u);
+}
+
+SGFX_TEST(MeshAnalyzersMatchHandComputedCounts)
+{
+    // Two disjoint triangles, then the first one again.
+    constexpr std::array<uint32_t, 9> INDICES = {0u, 1u, 2u, 3u, 4u, 5u, 0u, 1u, 2u};
+
+    // A 6 entry FIFO still holds the first triangle, a 5 entry one has evicted vertex 0 and then each vertex it reloads evicts the next one.
+    const sgfx::VertexCacheStatistics hitStatistics = sgfx::analyzeVertexCache(INDICES, 6u, 6u);
+    const sgfx::VertexCacheStatistics missStatistics = sgfx::analyzeVertexCache(INDICES, 6u, 5u);
+
+    SGFX_CHECK(hitStatistics.vertexTransformCount == 6u && hitStatistics.triangleCount == 3u && hitStatistics.vertexCount == 6u);
+    SGFX_CHECK(hitStatistics.getAcmr() == 2.0f && hitStatistics.getAtvr() == 1.0f);
+    SGFX_CHECK(missStatistics.vertexTransformCount == 9u && missStatistics.getAcmr() == 3.0f && missStatistics.getAtvr() == 1.5f);
+
+    // 32 byte vertices, two per 64 byte line : every vertex of the buffer is read once.
+    const sgfx::VertexFetchStatistics packedStatistics = sgfx::analyzeVertexFetch(INDICES, 6u, 32u);
+    SGFX_CHECK(packedStatistics.bytesFetched == 192u && packedStatistics.vertexBufferSize == 192u && packedStatistics.getOverfetch() == 1.0f);
+
+    // 48 byte vertices : vertex 1 (bytes 48 to 95) straddles the first two lines, which are both fetched to read it alone.
+    constexpr std::array<uint32_t, 3> STRADDLING_INDICES = {1u, 1u, 1u};
+
+    const sgfx::VertexFetchStatistics straddlingStatistics = sgfx::analyzeVertexFetch(STRADDLING_INDICES, 6u, 48u);
+    SGFX_CHECK(straddlingStatistics.bytesFetched == 128u && straddlingStatistics.vertexBufferSize == 288u);
+}
@@ -0,0 +1,156 @@
+#include "Pch.hpp"
+
+#include "MeshSimplifier.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<sgfx::ModelVertex> vertices{};
+        std::vector<uint32_t> indices{};
+    };
+
+    // A grid of size x size quads over [0, 1]^2, displaced along z by height(x, y). With splitColumn set, the vertices of that column are
+    // duplicated (as a texture seam would), the left quads using one copy and the right quads the other.
+    template <typename Height> TestMesh createGrid(const uint32_t size, const Height& height, const std::optional<uint32_t> splitColumn = std::nullopt)
+    {
+        TestMesh mesh{};
+
+        const auto addVertex = [&](const uint32_t x, const uint32_t y)
+        {
+            const float u = static_cast<float>(x) / size;
+            const float v = static_cast<float>(y) / size;
+
+            mesh.vertices.push_back(sgfx::ModelVertex{.position = {u, v, height(u, v)}, .textureCoord = {u, v}, .normal = {0.0f, 0.0f, 1.0f}});
+        };
+
+        for (uint32_t y = 0u; y <= size; y++)
+        {
+            for (uint32_t x = 0u; x <= size; x++)
+            {
+                addVertex(x, y);
+            }
+        }
+
+        const uint32_t rowLength = size + 1u;
+        const uint32_t firstSeamVertex = static_cast<uint32_t>(mesh.vertices.size());
+
+        if (splitColumn.has_value())
+        {
+            for (uint32_t y = 0u; y <= size; y++)
+            {
+                addVertex(*splitColumn, y);
+            }
+        }
+
+        const auto getVertex = [&](const uint32_t x, const uint32_t y, const bool isRightOfSeam)
+        { return splitColumn.has_value() && x == *splitColumn && isRightOfSeam ? firstSeamVertex + y : y * rowLength + x; };
+
+        for (uint32_t y = 0u; y < size; y++)
+        {
+            for (uint32_t x = 0u; x < size; x++)
+            {
+                const bool isRightOfSeam = splitColumn.has_value() && x >= *splitColumn;
+
+                const uint32_t v00 = getVertex(x, y, isRightOfSeam);
+                const uint32_t v10 = getVertex(x + 1u, y, isRightOfSeam);
+                const uint32_t v01 = getVertex(x, y + 1u, isRightOfSeam);
+                const uint32_t v11 = getVertex(x + 1u, y + 1u, isRightOfSeam);
+
+                mesh.indices.insert(mesh.indices.end(), {v00, v11, v10, v00, v01, v11});
+            }
+        }
+
+        return mesh;
+    }
+
+    float getArea(std::span<const uint32_t> indices, std::span<const sgfx::ModelVertex> vertices)
+    {
+        float area = 0.0f;
+
+        for (size_t i = 0u; i < indices.size(); i += 3u)
+        {
+            const math::XMVECTOR p0 = math::XMLoadFloat3(&vertices[indices[i]].position);
+            const math::XMVECTOR p1 = math::XMLoadFloat3(&vertices[indices[i + 1u]].position);
+            const math::XMVECTOR p2 = math::XMLoadFloat3(&vertices[indices[i + 2u]].position);
+
+            area += 0.5f * math::XMVectorGetX(math::XMVector3Length(math::XMVector3Cross(math::XMVectorSubtract(p1, p0), math::XMVectorSubtract(p2, p0))));
+        }
+
+        return area;
+    }
+
+    bool isValidIndexList(std::span<const uint32_t> indices, const size_t vertexCount)
+    {
+        return indices.size() % 3u == 0u && std::ranges::all_of(indices, [&](const uint32_t index) { return index < vertexCount; });
+    }
+}
+
+SGFX_TEST(SimplifyFlatGridToItsBorder)
+{
+    const TestMesh mesh = createGrid(32u, [](float, float) { return 0.0f; });
+
+    float error = 0.0f;
+    const std::vector<uint32_t> indices = sgfx::simplifyMesh(mesh.indices, mesh.vertices, 0u, 1e-4f, error);
+
+    // A plane collapses to a few triangles between its border vertices, without losing any area.
+    SGFX_CHECK(isValidIndexList(indices, mesh.vertices.size()));
+    SGFX_CHECK(indices.size() * 10u < mesh.indices.size());
+    SGFX_CHECK(error <= 1e-4f);
+    SGFX_CHECK(std::abs(getArea(indices, mesh.vertices) - 1.0f) < 1e-4f);
+}
+
+SGFX_TEST(SimplifyStopsAtTargetCountOrError)
+{
+    const TestMesh mesh = createGrid(32u, [](const float x, const float y) { return 0.1f * std::sin(6.0f * x) * std::cos(6.0f * y); });
+    const size_t triangleCount = mesh.indices.size() / 3u;
+
+    float error = 0.0f;
+    const std::vector<uint32_t> halfIndices = sgfx::simplifyMesh(mesh.indices, mesh.vertices, triangleCount / 2u * 3u, std::numeric_limits<float>::max(), error);
+
+    SGFX_CHECK(isValidIndexList(halfIndices, mesh.vertices.size()));
+    SGFX_CHECK(halfIndices.size() <= triangleCount / 2u * 3u);
+    SGFX_CHECK(error > 0.0f);
+
+    // The error bound wins over the target count, and a tighter bound keeps more triangles.
+    constexpr float TARGET_ERROR = 1e-3f;
+
+    float boundedError = 0.0f;
+    const std::vector<uint32_t> boundedIndices = sgfx::simplifyMesh(mesh.indices, mesh.vertices, 0u, TARGET_ERROR, boundedError);
+
+    float tighterError = 0.0f;
+    const std::vector<uint32_t> tighterIndices = sgfx::simplifyMesh(mesh.indices, mesh.vertices, 0u, TARGET_ERROR * 0.1f, tighterError);
+
+    SGFX_CHECK(boundedError <= TARGET_ERROR);
+    SGFX_CHECK(tighterError <= TARGET_ERROR * 0.1f);
+    SGFX_CHECK(!boundedIndices.empty() && boundedIndices.size() < mesh.indices.size());
+    SGFX_CHECK(tighterIndices.size() > boundedIndices.size());
+}
+
+SGFX_TEST(SimplifyKeepsSeamVertices)
+{
+    constexpr uint32_t SIZE = 16u;
+    constexpr uint32_t SEAM_COLUMN = 8u;
+
+    const TestMesh mesh = createGrid(SIZE, [](float, float) { return 0.0f; }, SEAM_COLUMN);
+
+    float error = 0.0f;
+    const std::vector<uint32_t> indices = sgfx::simplifyMesh(mesh.indices, mesh.vertices, 0u, 1e-4f, error);
+
+    SGFX_CHECK(isValidIndexList(indices, mesh.vertices.size()));
+    SGFX_CHECK(indices.size() < mesh.indices.size());
+
+    // Both copies of every seam vertex are still referenced, so the seam is not moved.
+    std::vector<bool> isVertexUsed(mesh.vertices.size());
+    for (const uint32_t index : indices)
+    {
+        isVertexUsed[index] = true;
+    }
+
+    for (uint32_t y = 0u; y <= SIZE; y++)
+    {
+        SGFX_CHECK(isVertexUsed[y * (SIZE + 1u) + SEAM_COLUMN]);
+        SGFX_CHECK(isVertexUsed[(SIZE + 1u) * (SIZE + 1u) + y]);
+    }
+}
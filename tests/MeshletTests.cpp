@@ -0,0 +1,214 @@
+#include "Pch.hpp"
+
+#include "Frustum.hpp"
+#include "Meshlet.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    // A grid of size x size quads over [0, size]^2 in the z = 0 plane, facing +z (counter clockwise, as glTF front faces).
+    std::pair<std::vector<sgfx::ModelVertex>, std::vector<uint32_t>> createGrid(const uint32_t size)
+    {
+        std::vector<sgfx::ModelVertex> vertices{};
+        std::vector<uint32_t> indices{};
+
+        for (uint32_t y = 0u; y <= size; y++)
+        {
+            for (uint32_t x = 0u; x <= size; x++)
+            {
+                vertices.push_back(sgfx::ModelVertex{.position = {static_cast<float>(x), static_cast<float>(y), 0.0f}, .normal = {0.0f, 0.0f, 1.0f}});
+            }
+        }
+
+        for (uint32_t y = 0u; y < size; y++)
+        {
+            for (uint32_t x = 0u; x < size; x++)
+            {
+                const uint32_t v00 = y * (size + 1u) + x;
+                const uint32_t v01 = v00 + size + 1u;
+
+                indices.insert(indices.end(), {v00, v00 + 1u, v01 + 1u, v00, v01 + 1u, v01});
+            }
+        }
+
+        return {std::move(vertices), std::move(indices)};
+    }
+
+    // The meshlets cover every triangle once, in index order.
+    bool coversIndices(std::span<const sgfx::MeshletData> meshlets, const size_t indexCount)
+    {
+        uint32_t nextIndex = 0u;
+        for (const sgfx::MeshletData& meshlet : meshlets)
+        {
+            if (meshlet.firstIndex != nextIndex || meshlet.indexCount == 0u || meshlet.indexCount % 3u != 0u)
+            {
+                return false;
+            }
+
+            nextIndex += meshlet.indexCount;
+        }
+
+        return nextIndex == indexCount;
+    }
+
+    uint32_t getUniqueVertexCount(const sgfx::MeshletData& meshlet, std::span<const uint32_t> indices)
+    {
+        std::vector<uint32_t> meshletIndices(indices.begin() + meshlet.firstIndex, indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+        std::ranges::sort(meshletIndices);
+
+        return static_cast<uint32_t>(std::distance(meshletIndices.begin(), std::unique(meshletIndices.begin(), meshletIndices.end())));
+    }
+
+    sgfx::Frustum createCameraFrustum(const math::XMFLOAT3& position, const math::XMFLOAT3& target)
+    {
+        const math::XMMATRIX viewMatrix =
+            math::XMMatrixLookAtLH(math::XMLoadFloat3(&position), math::XMLoadFloat3(&target), math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+        return sgfx::createFrustum(viewMatrix * math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(90.0f), 1.0f, 0.1f, 100.0f));
+    }
+}
+
+SGFX_TEST(MeshletsRespectVertexAndTriangleLimits)
+{
+    const auto [vertices, indices] = createGrid(32u);
+
+    // Default limits, then a vertex limit that is reached long before the triangle limit, and the other way around.
+    const std::array<std::pair<uint32_t, uint32_t>, 3> limits = {{
+        {sgfx::MESHLET_MAX_VERTEX_COUNT, sgfx::MESHLET_MAX_TRIANGLE_COUNT},
+        {16u, sgfx::MESHLET_MAX_TRIANGLE_COUNT},
+        {sgfx::MESHLET_MAX_VERTEX_COUNT, 10u},
+    }};
+
+    for (const auto& [maxVertexCount, maxTriangleCount] : limits)
+    {
+        const std::vector<sgfx::MeshletData> meshlets = sgfx::buildMeshlets(indices, vertices, maxVertexCount, maxTriangleCount);
+
+        SGFX_CHECK(coversIndices(meshlets, indices.size()));
+        SGFX_CHECK(std::ranges::all_of(meshlets, [&](const sgfx::MeshletData& meshlet) { return meshlet.indexCount / 3u <= maxTriangleCount; }));
+        SGFX_CHECK(std::ranges::all_of(meshlets, [&](const sgfx::MeshletData& meshlet) { return getUniqueVertexCount(meshlet, indices) <= maxVertexCount; }));
+
+        // Meshlets are only closed when the next triangle does not fit, which adds at most two new vertices on a grid.
+        SGFX_CHECK(std::ranges::all_of(meshlets | std::views::take(meshlets.size() - 1u),
+                                       [&](const sgfx::MeshletData& meshlet)
+                                       { return meshlet.indexCount / 3u == maxTriangleCount || getUniqueVertexCount(meshlet, indices) + 2u >= maxVertexCount; }));
+    }
+
+    // Exactly at the triangle limit, except for the last meshlet.
+    const std::vector<sgfx::MeshletData> meshlets = sgfx::buildMeshlets(indices, vertices, sgfx::MESHLET_MAX_VERTEX_COUNT, 10u);
+    SGFX_CHECK(meshlets.size() == (indices.size() / 3u + 9u) / 10u);
+}
+
+SGFX_TEST(MeshletBoundsContainTheirVertices)
+{
+    auto [vertices, indices] = createGrid(24u);
+
+    // Raised in the middle, so the bounds are not flat.
+    for (sgfx::ModelVertex& vertex : vertices)
+    {
+        vertex.position.z = std::sin(vertex.position.x * 0.5f) * std::cos(vertex.position.y * 0.3f) * 3.0f;
+    }
+
+    const std::vector<sgfx::MeshletData> meshlets = sgfx::buildMeshlets(indices, vertices);
+    SGFX_CHECK(meshlets.size() > 1u);
+
+    constexpr float EPSILON = 1e-4f;
+
+    for (const sgfx::MeshletData& meshlet : meshlets)
+    {
+        for (const uint32_t index : std::span(indices).subspan(meshlet.firstIndex, meshlet.indexCount))
+        {
+            const math::XMFLOAT3& position = vertices[index].position;
+
+            SGFX_CHECK(position.x >= meshlet.bounds.minimum.x && position.y >= meshlet.bounds.minimum.y && position.z >= meshlet.bounds.minimum.z);
+            SGFX_CHECK(position.x <= meshlet.bounds.maximum.x && position.y <= meshlet.bounds.maximum.y && position.z <= meshlet.bounds.maximum.z);
+
+            const float dx = position.x - meshlet.sphereCenter.x;
+            const float dy = position.y - meshlet.sphereCenter.y;
+            const float dz = position.z - meshlet.sphereCenter.z;
+            SGFX_CHECK(std::sqrt(dx * dx + dy * dy + dz * dz) <= meshlet.sphereRadius + EPSILON);
+        }
+
+        // The sphere is centered on the box, and no larger than needed to hold it.
+        SGFX_CHECK(std::abs(meshlet.sphereCenter.x - 0.5f * (meshlet.bounds.minimum.x + meshlet.bounds.maximum.x)) <= EPSILON);
+        SGFX_CHECK(std::abs(meshlet.sphereCenter.z - 0.5f * (meshlet.bounds.minimum.z + meshlet.bounds.maximum.z)) <= EPSILON);
+
+        const float halfDiagonalX = 0.5f * (meshlet.bounds.maximum.x - meshlet.bounds.minimum.x);
+        const float halfDiagonalY = 0.5f * (meshlet.bounds.maximum.y - meshlet.bounds.minimum.y);
+        const float halfDiagonalZ = 0.5f * (meshlet.bounds.maximum.z - meshlet.bounds.minimum.z);
+        SGFX_CHECK(meshlet.sphereRadius <= std::sqrt(halfDiagonalX * halfDiagonalX + halfDiagonalY * halfDiagonalY + halfDiagonalZ * halfDiagonalZ) + EPSILON);
+    }
+}
+
+SGFX_TEST(MeshletConesRejectBackFacingClusters)
+{
+    const auto [vertices, indices] = createGrid(16u);
+    const std::vector<sgfx::MeshletData> meshlets = sgfx::buildMeshlets(indices, vertices);
+
+    // A flat grid has a zero width cone along its normal.
+    SGFX_CHECK(std::ranges::all_of(meshlets, [](const sgfx::MeshletData& meshlet) { return meshlet.coneCutoff < 1e-3f && meshlet.coneAxis.z > 0.999f; }));
+
+    const math::XMFLOAT3 center = {8.0f, 8.0f, 0.0f};
+    const uint32_t meshletCount = static_cast<uint32_t>(meshlets.size());
+
+    // In front of the grid, every meshlet is visible.
+    const math::XMFLOAT3 frontPosition = {8.0f, 8.0f, 20.0f};
+    std::vector<uint32_t> visibleMeshlets{};
+    sgfx::MeshletCullingStats stats = sgfx::cullMeshlets(meshlets, createCameraFrustum(frontPosition, center), frontPosition, true, visibleMeshlets);
+
+    SGFX_CHECK(visibleMeshlets.size() == meshletCount);
+    SGFX_CHECK(stats.meshletCount == meshletCount && stats.triangleCount == indices.size() / 3u && stats.getRejectedTriangleCount() == 0u);
+
+    // Behind it, every meshlet is back facing, unless backface culling is disabled (e.g for non uniformly scaled objects).
+    const math::XMFLOAT3 backPosition = {8.0f, 8.0f, -20.0f};
+    visibleMeshlets.clear();
+    stats = sgfx::cullMeshlets(meshlets, createCameraFrustum(backPosition, center), backPosition, true, visibleMeshlets);
+
+    SGFX_CHECK(visibleMeshlets.empty());
+    SGFX_CHECK(stats.backfaceCulledMeshletCount == meshletCount && stats.frustumCulledMeshletCount == 0u);
+    SGFX_CHECK(stats.backfaceCulledTriangleCount == indices.size() / 3u);
+
+    visibleMeshlets.clear();
+    stats = sgfx::cullMeshlets(meshlets, createCameraFrustum(backPosition, center), backPosition, false, visibleMeshlets);
+    SGFX_CHECK(visibleMeshlets.size() == meshletCount && stats.backfaceCulledMeshletCount == 0u);
+
+    // Grazing the plane from behind, the test stays conservative for meshlets whose bounding sphere may still be seen from the front.
+    const math::XMFLOAT3 grazingPosition = {8.0f, -20.0f, -0.5f};
+    visibleMeshlets.clear();
+    stats = sgfx::cullMeshlets(meshlets, createCameraFrustum(grazingPosition, center), grazingPosition, true, visibleMeshlets);
+    SGFX_CHECK(stats.backfaceCulledMeshletCount < meshletCount - stats.frustumCulledMeshletCount);
+
+    // Looking away, every meshlet is outside the frustum, which is tested first.
+    const math::XMFLOAT3 awayTarget = {8.0f, 8.0f, 40.0f};
+    visibleMeshlets.clear();
+    stats = sgfx::cullMeshlets(meshlets, createCameraFrustum(frontPosition, awayTarget), frontPosition, true, visibleMeshlets);
+    SGFX_CHECK(visibleMeshlets.empty() && stats.frustumCulledMeshletCount == meshletCount && stats.backfaceCulledMeshletCount == 0u);
+}
+
+SGFX_TEST(MeshletsWithSpreadNormalsAreNeverBackfaceCulled)
+{
+    // Three faces of a unit box, facing -x, +z and +x : the normals span 180 degrees.
+    const std::vector<sgfx::ModelVertex> vertices = {
+        {.position = {0.0f, 0.0f, 0.0f}}, {.position = {0.0f, 1.0f, 0.0f}}, {.position = {0.0f, 1.0f, 1.0f}}, {.position = {0.0f, 0.0f, 1.0f}},
+        {.position = {1.0f, 0.0f, 0.0f}}, {.position = {1.0f, 1.0f, 0.0f}}, {.position = {1.0f, 1.0f, 1.0f}}, {.position = {1.0f, 0.0f, 1.0f}},
+    };
+
+    // Counter clockwise seen from the side each face faces.
+    const std::vector<uint32_t> indices = {
+        0u, 2u, 1u, 0u, 3u, 2u, // -x
+        3u, 7u, 6u, 3u, 6u, 2u, // +z
+        4u, 5u, 6u, 4u, 6u, 7u, // +x
+    };
+
+    const std::vector<sgfx::MeshletData> meshlets = sgfx::buildMeshlets(indices, vertices);
+    SGFX_CHECK(meshlets.size() == 1u);
+    SGFX_CHECK(meshlets[0].coneCutoff == 1.0f);
+
+    // From any side, the meshlet is kept.
+    for (const math::XMFLOAT3& position : {math::XMFLOAT3{0.5f, 0.5f, -10.0f}, math::XMFLOAT3{0.5f, 0.5f, 10.0f}, math::XMFLOAT3{-10.0f, 0.5f, 0.5f}, math::XMFLOAT3{10.0f, 0.5f, 0.5f}})
+    {
+        std::vector<uint32_t> visibleMeshlets{};
+        const sgfx::MeshletCullingStats stats = sgfx::cullMeshlets(meshlets, createCameraFrustum(position, {0.5f, 0.5f, 0.5f}), position, true, visibleMeshlets);
+
+        SGFX_CHECK(visibleMeshlets.size() == 1u && stats.backfaceCulledMeshletCount == 0u);
+    }
+}
@@ -0,0 +1,99 @@
+#include "Pch.hpp"
+
+#include "ModelCache.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    // Directory of its own under the system temporary directory, removed with its contents when destroyed.
+    struct TemporaryDirectory
+    {
+        TemporaryDirectory() : path(std::filesystem::temp_directory_path() / std::format("sgfx_model_cache_tests_{}", std::random_device{}()))
+        {
+            std::filesystem::create_directories(path);
+        }
+
+        ~TemporaryDirectory()
+        {
+            std::error_code errorCode{};
+            std::filesystem::remove_all(path, errorCode);
+        }
+
+        std::filesystem::path path{};
+    };
+
+    void writeFile(const std::filesystem::path& path, const std::string_view contents)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+}
+
+SGFX_TEST(ModelCacheRoundTrip)
+{
+    const TemporaryDirectory directory{};
+    const std::string cachePath = (directory.path / "model.gltf.sgfxcache").string();
+
+    sgfx::ModelDataStorage storage{};
+
+    sgfx::PrimitiveData primitive{.materialIndex = 1u};
+    for (const uint32_t i : std::views::iota(0u, 300u))
+    {
+        primitive.vertices.push_back(sgfx::ModelVertex{.position = {static_cast<float>(i), 1.0f, 2.0f}, .textureCoord = {0.5f, 0.25f}});
+        primitive.indices.push_back(i);
+    }
+
+    storage.addPrimitive(primitive);
+    storage.materials.emplace_back();
+    storage.materials.emplace_back();
+    storage.imagePaths = {"albedo.png", "textures/normal.png"};
+
+    constexpr uint64_t CACHE_KEY = 0x1234u;
+    sgfx::ModelCache::write(cachePath, CACHE_KEY, storage.getView());
+
+    sgfx::ModelCache modelCache{};
+    SGFX_CHECK(modelCache.open(cachePath, CACHE_KEY));
+
+    const sgfx::ModelData& data = modelCache.getData();
+    SGFX_CHECK(data.vertices.size() == primitive.vertices.size());
+    SGFX_CHECK(data.vertices.back().position.x == 299.0f);
+    SGFX_CHECK(data.meshes.size() == 1u);
+    SGFX_CHECK(data.meshes[0].indexSize == sizeof(uint16_t));
+    SGFX_CHECK(data.meshes[0].materialIndex == 1u);
+    SGFX_CHECK(data.indexData.size() == primitive.indices.size() * sizeof(uint16_t));
+    SGFX_CHECK(data.materials.size() == 2u);
+    SGFX_CHECK(data.imagePaths.size() == 2u && data.imagePaths[1] == "textures/normal.png");
+
+    // Every section is page aligned within the mapping.
+    SGFX_CHECK(reinterpret_cast<uintptr_t>(data.vertices.data()) % 4096u == 0u);
+
+    sgfx::ModelCache staleModelCache{};
+    SGFX_CHECK(!staleModelCache.open(cachePath, CACHE_KEY + 1u));
+    SGFX_CHECK(!staleModelCache.open((directory.path / "missing.sgfxcache").string(), CACHE_KEY));
+}
+
+SGFX_TEST(ModelCacheSourceFilesKey)
+{
+    const TemporaryDirectory directory{};
+    const std::filesystem::path modelPath = directory.path / "model.gltf";
+
+    writeFile(modelPath, "{}");
+    writeFile(directory.path / "buffer.bin", "0123");
+
+    const uint64_t key = sgfx::ModelCache::getSourceFilesKey(modelPath.string());
+    SGFX_CHECK(key == sgfx::ModelCache::getSourceFilesKey(modelPath.string()));
+
+    // A buffer of a different size.
+    writeFile(directory.path / "buffer.bin", "012345");
+    const uint64_t resizedBufferKey = sgfx::ModelCache::getSourceFilesKey(modelPath.string());
+    SGFX_CHECK(resizedBufferKey != key);
+
+    // The same size, but written later.
+    std::filesystem::last_write_time(modelPath, std::filesystem::last_write_time(modelPath) + std::chrono::seconds(10));
+    SGFX_CHECK(sgfx::ModelCache::getSourceFilesKey(modelPath.string()) != resizedBufferKey);
+
+    // A new buffer.
+    const uint64_t touchedKey = sgfx::ModelCache::getSourceFilesKey(modelPath.string());
+    writeFile(directory.path / "other.bin", "");
+    SGFX_CHECK(sgfx::ModelCache::getSourceFilesKey(modelPath.string()) != touchedKey);
+}
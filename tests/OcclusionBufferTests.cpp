@@ -0,0 +1,130 @@
+#include "Pch.hpp"
+
+#include "JobSystem.hpp"
+#include "OcclusionBuffer.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    constexpr uint32_t BUFFER_WIDTH = 128u;
+    constexpr uint32_t BUFFER_HEIGHT = 72u;
+
+    // Unit cube, scaled and moved into walls by the occluder model matrices.
+    constexpr std::array<math::XMFLOAT3, 8> CUBE_POSITIONS = {{
+        {-0.5f, -0.5f, -0.5f},
+        {0.5f, -0.5f, -0.5f},
+        {0.5f, 0.5f, -0.5f},
+        {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f, 0.5f},
+        {0.5f, -0.5f, 0.5f},
+        {0.5f, 0.5f, 0.5f},
+        {-0.5f, 0.5f, 0.5f},
+    }};
+
+    constexpr std::array<uint32_t, 36> CUBE_INDICES = {0u, 2u, 1u, 0u, 3u, 2u, 4u, 5u, 6u, 4u, 6u, 7u, 0u, 1u, 5u, 0u, 5u, 4u,
+                                                       3u, 7u, 6u, 3u, 6u, 2u, 0u, 4u, 7u, 0u, 7u, 3u, 1u, 2u, 6u, 1u, 6u, 5u};
+
+    // A wall of width x height centered on (x, 0, z) and turned by yaw radians, one unit thick.
+    sgfx::Occluder createWall(const float x, const float z, const float width, const float height, const float yaw = 0.0f)
+    {
+        return sgfx::Occluder{
+            .positions = CUBE_POSITIONS,
+            .indices = CUBE_INDICES,
+            .modelMatrix = math::XMMatrixScaling(width, height, 1.0f) * math::XMMatrixRotationRollPitchYaw(0.0f, yaw, 0.0f) * math::XMMatrixTranslation(x, 0.0f, z),
+        };
+    }
+
+    sgfx::AxisAlignedBoundingBox createBox(const float x, const float y, const float z, const float halfSize = 0.5f)
+    {
+        return sgfx::AxisAlignedBoundingBox{.minimum = {x - halfSize, y - halfSize, z - halfSize}, .maximum = {x + halfSize, y + halfSize, z + halfSize}};
+    }
+
+    // Camera at the origin looking down +z.
+    math::XMMATRIX getViewProjectionMatrix()
+    {
+        const math::XMMATRIX viewMatrix = math::XMMatrixLookAtLH(math::XMVectorZero(), math::XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f), math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        return viewMatrix * math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(45.0f), BUFFER_WIDTH / static_cast<float>(BUFFER_HEIGHT), 0.1f, 200.0f);
+    }
+}
+
+SGFX_TEST(OcclusionBufferWithoutOccluders)
+{
+    sgfx::JobSystem jobSystem{2u};
+
+    sgfx::OcclusionBuffer occlusionBuffer{};
+    occlusionBuffer.resize(BUFFER_WIDTH, BUFFER_HEIGHT);
+
+    const sgfx::OcclusionRasterizationStats stats = occlusionBuffer.rasterize({}, getViewProjectionMatrix(), jobSystem);
+    SGFX_CHECK(stats.occluderCount == 0u && stats.triangleCount == 0u);
+
+    SGFX_CHECK(occlusionBuffer.getWidth() == BUFFER_WIDTH && occlusionBuffer.getHeight() == BUFFER_HEIGHT);
+    SGFX_CHECK(occlusionBuffer.getRowPitch() % sgfx::OcclusionBuffer::TILE_SIZE == 0u);
+    SGFX_CHECK(std::ranges::all_of(occlusionBuffer.getDepths(), [](const float depth) { return depth == 1.0f; }));
+
+    // Boxes on screen are visible, boxes entirely off screen are not.
+    SGFX_CHECK(occlusionBuffer.isAabbVisible(createBox(0.0f, 0.0f, 50.0f)));
+    SGFX_CHECK(occlusionBuffer.isAabbVisible(createBox(10.0f, 0.0f, 50.0f)));
+    SGFX_CHECK(!occlusionBuffer.isAabbVisible(createBox(200.0f, 0.0f, 50.0f)));
+}
+
+SGFX_TEST(OcclusionBufferCullsHiddenBoxes)
+{
+    sgfx::JobSystem jobSystem{2u};
+
+    sgfx::OcclusionBuffer occlusionBuffer{};
+    occlusionBuffer.resize(BUFFER_WIDTH, BUFFER_HEIGHT);
+
+    // Two walls at z = 20 with a 4 unit gap between them, around x = 0.
+    const std::array<sgfx::Occluder, 2> occluders = {createWall(-12.0f, 20.0f, 20.0f, 20.0f), createWall(12.0f, 20.0f, 20.0f, 20.0f)};
+
+    const sgfx::OcclusionRasterizationStats stats = occlusionBuffer.rasterize(occluders, getViewProjectionMatrix(), jobSystem);
+    SGFX_CHECK(stats.occluderCount == 2u && stats.triangleCount == 2u * CUBE_INDICES.size() / 3u);
+    SGFX_CHECK(stats.rasterizedTriangleCount > 0u && stats.rasterizedTriangleCount <= stats.triangleCount);
+
+    // Behind either wall.
+    SGFX_CHECK(!occlusionBuffer.isAabbVisible(createBox(-8.0f, 0.0f, 40.0f)));
+    SGFX_CHECK(!occlusionBuffer.isAabbVisible(createBox(8.0f, 2.0f, 30.0f)));
+
+    // In front of the walls, seen through the gap, or partially hidden.
+    SGFX_CHECK(occlusionBuffer.isAabbVisible(createBox(-8.0f, 0.0f, 10.0f)));
+    SGFX_CHECK(occlusionBuffer.isAabbVisible(createBox(0.0f, 0.0f, 40.0f)));
+    SGFX_CHECK(occlusionBuffer.isAabbVisible(createBox(-2.0f, 0.0f, 40.0f, 2.0f)));
+
+    // Crossing the near plane.
+    SGFX_CHECK(occlusionBuffer.isAabbVisible(createBox(0.0f, 0.0f, 0.0f)));
+}
+
+SGFX_TEST(OcclusionBufferDoesNotDependOnThreadCount)
+{
+    std::mt19937 randomEngine(3u);
+    std::uniform_real_distribution<float> positionDistribution(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> depthDistribution(5.0f, 100.0f);
+
+    // Overlapping walls spread over every tile.
+    std::vector<sgfx::Occluder> occluders{};
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        occluders.push_back(createWall(positionDistribution(randomEngine), depthDistribution(randomEngine), 6.0f, 30.0f, positionDistribution(randomEngine)));
+    }
+
+    std::vector<float> singleThreadDepths{};
+    for (const uint32_t workerCount : {1u, 4u})
+    {
+        sgfx::JobSystem jobSystem{workerCount};
+
+        sgfx::OcclusionBuffer occlusionBuffer{};
+        occlusionBuffer.resize(BUFFER_WIDTH, BUFFER_HEIGHT);
+        static_cast<void>(occlusionBuffer.rasterize(occluders, getViewProjectionMatrix(), jobSystem));
+
+        const std::span<const float> depths = occlusionBuffer.getDepths();
+        if (singleThreadDepths.empty())
+        {
+            singleThreadDepths.assign(depths.begin(), depths.end());
+            SGFX_CHECK(std::ranges::count_if(singleThreadDepths, [](const float depth) { return depth < 1.0f; }) > std::ssize(singleThreadDepths) / 4);
+        }
+        else
+        {
+            SGFX_CHECK(std::ranges::equal(depths, singleThreadDepths));
+        }
+    }
+}
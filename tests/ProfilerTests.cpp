@@ -0,0 +1,109 @@
+#include "Pch.hpp"
+
+#include "Profiler.hpp"
+#include "Test.hpp"
+
+// Thread buffers are registered with the global profiler, so the tests use it, with zone names no other code records.
+namespace
+{
+    const sgfx::ProfilerZoneStats* findZone(std::span<const sgfx::ProfilerZoneStats> zoneStats, const std::string_view name)
+    {
+        const auto it = std::ranges::find(zoneStats, name, &sgfx::ProfilerZoneStats::name);
+        return it != zoneStats.end() ? &*it : nullptr;
+    }
+}
+
+SGFX_TEST(ProfilerZoneStatsFollowNesting)
+{
+    sgfx::Profiler& profiler = sgfx::getProfiler();
+    profiler.endFrame();
+
+    {
+        const sgfx::ProfilerScope outerScope("Profiler test outer zone");
+        for (uint32_t i = 0u; i < 3u; i++)
+        {
+            const sgfx::ProfilerScope innerScope("Profiler test inner zone");
+        }
+    }
+
+    profiler.endFrame();
+
+    const std::vector<sgfx::ProfilerZoneStats> zoneStats = profiler.getZoneStats();
+    const sgfx::ProfilerZoneStats* const outerZone = findZone(zoneStats, "Profiler test outer zone");
+    const sgfx::ProfilerZoneStats* const innerZone = findZone(zoneStats, "Profiler test inner zone");
+
+    SGFX_CHECK(outerZone != nullptr && innerZone != nullptr);
+    if (outerZone == nullptr || innerZone == nullptr)
+    {
+        return;
+    }
+
+    // Children directly follow their parent, one level deeper.
+    SGFX_CHECK(innerZone == outerZone + 1 && innerZone->depth == outerZone->depth + 1u);
+
+    // Averaged over the same frames, so the ratio of the call counts is exact.
+    SGFX_CHECK(outerZone->averageCallCount > 0.0 && innerZone->averageCallCount == 3.0 * outerZone->averageCallCount);
+    SGFX_CHECK(outerZone->maximumDuration >= innerZone->maximumDuration / 3.0);
+}
+
+SGFX_TEST(ProfilerDropsZonesOfFullBuffers)
+{
+    constexpr uint32_t EXTRA_ZONE_COUNT = 10u;
+
+    sgfx::Profiler& profiler = sgfx::getProfiler();
+    profiler.endFrame();
+
+    const uint64_t droppedEventCount = profiler.getStats().droppedEventCount;
+    const uint32_t threadCount = profiler.getStats().threadCount;
+
+    // On a new thread, so its buffer starts empty.
+    std::thread(
+        []()
+        {
+            for (uint32_t i = 0u; i < sgfx::Profiler::RING_BUFFER_CAPACITY + EXTRA_ZONE_COUNT; i++)
+            {
+                const sgfx::ProfilerScope scope("Profiler test dropped zone");
+            }
+        })
+        .join();
+
+    SGFX_CHECK(profiler.getStats().threadCount == threadCount + 1u);
+    SGFX_CHECK(profiler.getStats().droppedEventCount == droppedEventCount + EXTRA_ZONE_COUNT);
+
+    // Draining makes room again.
+    profiler.endFrame();
+
+    const std::vector<sgfx::ProfilerZoneStats> zoneStats = profiler.getZoneStats();
+    const sgfx::ProfilerZoneStats* const zone = findZone(zoneStats, "Profiler test dropped zone");
+    SGFX_CHECK(zone != nullptr && zone->depth == 0u && zone->averageCallCount > 0.0);
+}
+
+SGFX_TEST(ProfilerCaptureWritesChromeTrace)
+{
+    sgfx::Profiler& profiler = sgfx::getProfiler();
+    profiler.endFrame();
+
+    profiler.beginCapture();
+    {
+        const sgfx::ProfilerScope scope("Profiler test \"captured\" zone");
+    }
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "sgfx_profiler_test_trace.json";
+    SGFX_CHECK(profiler.endCapture(path));
+    SGFX_CHECK(!profiler.getStats().isCapturing && profiler.getStats().capturedEventCount == 0u);
+
+    std::ifstream file(path, std::ios::binary);
+    const std::string json{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    file.close();
+    std::filesystem::remove(path);
+
+    // Names are escaped, and the event list is closed without a trailing separator.
+    SGFX_CHECK(json.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"));
+    SGFX_CHECK(json.find("{\"name\":\"Profiler test \\\"captured\\\" zone\",\"cat\":\"sgfx\",\"ph\":\"X\"") != std::string::npos);
+    SGFX_CHECK(json.ends_with("}\n]}\n"));
+
+    // A path that cannot be written fails, the capture being discarded.
+    profiler.beginCapture();
+    SGFX_CHECK(!profiler.endCapture(std::filesystem::temp_directory_path() / "sgfx_missing_directory" / "trace.json"));
+    SGFX_CHECK(!profiler.getStats().isCapturing);
+}
@@ -0,0 +1,98 @@
+#include "Pch.hpp"
+
+#include "RangeAllocator.hpp"
+#include "Test.hpp"
+
+SGFX_TEST(RangeAllocatorAllocateAndFree)
+{
+    sgfx::RangeAllocator allocator{1000u};
+
+    const std::optional<uint64_t> first = allocator.allocate(100u);
+    const std::optional<uint64_t> second = allocator.allocate(200u);
+    const std::optional<uint64_t> third = allocator.allocate(300u);
+
+    SGFX_CHECK(first == 0u && second == 100u && third == 300u);
+    SGFX_CHECK(allocator.getStats().usedSize == 600u && allocator.getStats().allocationCount == 3u);
+
+    // Larger than the largest free block.
+    SGFX_CHECK(!allocator.allocate(401u).has_value());
+    SGFX_CHECK(!allocator.allocate(0u).has_value());
+
+    // Freeing the middle range leaves two free blocks, freeing its neighbours merges everything back into one.
+    allocator.free(*second, 200u);
+    SGFX_CHECK(allocator.getStats().freeBlockCount == 2u);
+
+    allocator.free(*first, 100u);
+    SGFX_CHECK(allocator.getStats().freeBlockCount == 2u && allocator.getStats().largestFreeBlockSize == 400u);
+
+    allocator.free(*third, 300u);
+
+    const sgfx::RangeAllocatorStats stats = allocator.getStats();
+    SGFX_CHECK(stats.usedSize == 0u && stats.allocationCount == 0u && stats.freeBlockCount == 1u && stats.largestFreeBlockSize == 1000u);
+    SGFX_CHECK(stats.getFragmentation() == 0.0f);
+}
+
+SGFX_TEST(RangeAllocatorBestFitAndAlignment)
+{
+    sgfx::RangeAllocator allocator{1000u};
+
+    // Free blocks of 100 (at 0) and 50 (at 200) units, between allocated ranges.
+    const std::optional<uint64_t> first = allocator.allocate(100u);
+    const std::optional<uint64_t> second = allocator.allocate(100u);
+    const std::optional<uint64_t> third = allocator.allocate(50u);
+    const std::optional<uint64_t> fourth = allocator.allocate(10u);
+
+    allocator.free(*first, 100u);
+    allocator.free(*third, 50u);
+
+    // The smallest block that fits is used.
+    SGFX_CHECK(allocator.allocate(40u) == 200u);
+
+    allocator.free(*second, 100u);
+    allocator.free(*fourth, 10u);
+    SGFX_CHECK(allocator.getStats().usedSize == 40u);
+
+    // The padding before an aligned range stays free.
+    sgfx::RangeAllocator alignedAllocator{1000u};
+
+    SGFX_CHECK(alignedAllocator.allocate(10u) == 0u);
+    SGFX_CHECK(alignedAllocator.allocate(30u, 64u) == 64u);
+    SGFX_CHECK(alignedAllocator.allocate(54u) == 10u);
+    SGFX_CHECK(alignedAllocator.getStats().freeBlockCount == 1u);
+}
+
+SGFX_TEST(RangeAllocatorInvalidFree)
+{
+    sgfx::RangeAllocator allocator{1000u};
+
+    const std::optional<uint64_t> first = allocator.allocate(100u);
+    const std::optional<uint64_t> second = allocator.allocate(100u);
+
+    allocator.free(*first, 100u);
+
+    const auto isRejected = [&](const uint64_t offset, const uint64_t size)
+    {
+        try
+        {
+            allocator.free(offset, size);
+        }
+        catch (const std::exception&)
+        {
+            return true;
+        }
+
+        return false;
+    };
+
+    // Double free, overlap with a free block on either side, and out of the address space.
+    SGFX_CHECK(isRejected(*first, 100u));
+    SGFX_CHECK(isRejected(*second + 50u, 100u));
+    SGFX_CHECK(isRejected(50u, 100u));
+    SGFX_CHECK(isRejected(990u, 20u));
+
+    // Nothing was changed by the rejected frees.
+    SGFX_CHECK(allocator.getStats().usedSize == 100u && allocator.getStats().freeBlockCount == 2u);
+
+    allocator.free(*second, 100u);
+    SGFX_CHECK(allocator.getStats().freeBlockCount == 1u);
+}
@@ -0,0 +1,94 @@
+#include "Pch.hpp"
+
+#include "RenderQueue.hpp"
+#include "Test.hpp"
+
+SGFX_TEST(RenderQueueSortKeyOrder)
+{
+    const auto createSortKey = sgfx::RenderQueue::createSortKey;
+
+    // Pass first, then pipeline, then material, then depth.
+    SGFX_CHECK(createSortKey(0u, 9u, 9u, 100.0f) < createSortKey(1u, 0u, 0u, 0.0f));
+    SGFX_CHECK(createSortKey(0u, 0u, 9u, 100.0f) < createSortKey(0u, 1u, 0u, 0.0f));
+    SGFX_CHECK(createSortKey(0u, 0u, 0u, 100.0f) < createSortKey(0u, 0u, 1u, 0.0f));
+    SGFX_CHECK(createSortKey(0u, 0u, 0u, 1.5f) < createSortKey(0u, 0u, 0u, 2.0f));
+
+    // Negative depths sort as 0, and fields too large for their bits wrap instead of spilling into the next field.
+    SGFX_CHECK(createSortKey(0u, 0u, 0u, -5.0f) == createSortKey(0u, 0u, 0u, 0.0f));
+    SGFX_CHECK(createSortKey(0u, 1u << sgfx::RenderQueue::PIPELINE_BITS, 0u, 0.0f) == createSortKey(0u, 0u, 0u, 0.0f));
+    SGFX_CHECK(createSortKey(1u << sgfx::RenderQueue::PASS_BITS, 0u, 1u << sgfx::RenderQueue::MATERIAL_BITS, 0.0f) == createSortKey(0u, 0u, 0u, 0.0f));
+}
+
+SGFX_TEST(RenderQueueSortIsStable)
+{
+    constexpr uint32_t ITEM_COUNT = 10'000u;
+
+    std::mt19937 randomEngine(13u);
+    std::uniform_int_distribution<uint32_t> passDistribution(0u, 3u);
+    std::uniform_int_distribution<uint32_t> materialDistribution(0u, 50u);
+
+    // Few distinct depths, so many items share a key and their order is that of the stable sort only.
+    std::uniform_int_distribution<uint32_t> depthDistribution(0u, 8u);
+
+    sgfx::RenderQueue renderQueue{};
+    renderQueue.reserve(ITEM_COUNT);
+
+    std::vector<std::pair<uint64_t, uint32_t>> referenceItems{};
+    for (const uint32_t i : std::views::iota(0u, ITEM_COUNT))
+    {
+        const uint64_t sortKey =
+            sgfx::RenderQueue::createSortKey(passDistribution(randomEngine), 0u, materialDistribution(randomEngine), static_cast<float>(depthDistribution(randomEngine)));
+
+        renderQueue.add(sortKey, sgfx::RenderItem{.meshIndex = i});
+        referenceItems.emplace_back(sortKey, i);
+    }
+
+    SGFX_CHECK(renderQueue.getItemCount() == ITEM_COUNT);
+    SGFX_CHECK(renderQueue.getItems()[1].meshIndex == 1u);
+
+    renderQueue.sort();
+    std::ranges::stable_sort(referenceItems, {}, &std::pair<uint64_t, uint32_t>::first);
+
+    // Items move along with their keys.
+    SGFX_CHECK(std::ranges::equal(renderQueue.getSortKeys(), referenceItems, {}, {}, &std::pair<uint64_t, uint32_t>::first));
+    SGFX_CHECK(std::ranges::equal(renderQueue.getItems(), referenceItems, {}, &sgfx::RenderItem::meshIndex, &std::pair<uint64_t, uint32_t>::second));
+
+    // The queue is reusable after clear, and sorting nothing or a single item is fine.
+    renderQueue.clear();
+    renderQueue.sort();
+    SGFX_CHECK(renderQueue.getItemCount() == 0u && renderQueue.getItems().empty());
+
+    renderQueue.add(42u, sgfx::RenderItem{.meshIndex = 7u});
+    renderQueue.sort();
+    SGFX_CHECK(renderQueue.getSortKeys()[0] == 42u && renderQueue.getItems()[0].meshIndex == 7u);
+}
+
+SGFX_TEST(RenderQueueSortOfFullKeys)
+{
+    constexpr uint32_t ITEM_COUNT = 5'000u;
+
+    // Random bits in every digit, so no radix pass is skipped.
+    std::mt19937_64 randomEngine(17u);
+
+    sgfx::RenderQueue renderQueue{};
+    std::vector<uint64_t> referenceKeys{};
+
+    for (const uint32_t i : std::views::iota(0u, ITEM_COUNT))
+    {
+        const uint64_t sortKey = randomEngine();
+
+        renderQueue.add(sortKey, sgfx::RenderItem{.meshIndex = i});
+        referenceKeys.push_back(sortKey);
+    }
+
+    renderQueue.sort();
+    std::ranges::sort(referenceKeys);
+
+    SGFX_CHECK(std::ranges::equal(renderQueue.getSortKeys(), referenceKeys));
+
+    // Every item is still there once.
+    std::vector<uint32_t> meshIndices(ITEM_COUNT);
+    std::ranges::transform(renderQueue.getItems(), meshIndices.begin(), &sgfx::RenderItem::meshIndex);
+    std::ranges::sort(meshIndices);
+    SGFX_CHECK(std::ranges::equal(meshIndices, std::views::iota(0u, ITEM_COUNT)));
+}
@@ -0,0 +1,223 @@
+#include "Pch.hpp"
+
+#include "ShaderCache.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    // Directory of its own under the system temporary directory, removed with its contents when destroyed.
+    struct TemporaryDirectory
+    {
+        TemporaryDirectory() : path(std::filesystem::temp_directory_path() / std::format("sgfx_shader_cache_tests_{}", std::random_device{}()))
+        {
+            std::filesystem::create_directories(path);
+        }
+
+        ~TemporaryDirectory()
+        {
+            std::error_code errorCode{};
+            std::filesystem::remove_all(path, errorCode);
+        }
+
+        std::filesystem::path path{};
+    };
+
+    // In memory shader sources, keyed by generic path.
+    struct ShaderFiles
+    {
+        sgfx::ShaderFileReader getReader()
+        {
+            return [this](const std::filesystem::path& path) -> std::optional<std::string>
+            {
+                const auto file = files.find(path.generic_string());
+                return file != files.end() ? std::optional<std::string>(file->second) : std::nullopt;
+            };
+        }
+
+        std::map<std::string, std::string> files{};
+    };
+
+    // Returns the source of the compiled file as bytecode, and counts its calls.
+    struct MockCompiler
+    {
+        sgfx::ShaderCompiler getCompiler(ShaderFiles& shaderFiles)
+        {
+            return [this, &shaderFiles](const sgfx::ShaderCompileDesc& compileDesc)
+            {
+                compileCount++;
+
+                const std::string& source = shaderFiles.files.at(compileDesc.path.generic_string());
+                if (source.find("error") != std::string::npos)
+                {
+                    throw std::runtime_error("Shader compilation failed");
+                }
+
+                const std::span<const std::byte> bytes = std::as_bytes(std::span(source));
+                return std::vector<std::byte>(bytes.begin(), bytes.end());
+            };
+        }
+
+        std::atomic<uint32_t> compileCount{};
+    };
+
+    const sgfx::ShaderCompileDesc PIXEL_SHADER_DESC = {.path = "shaders/Lighting.hlsl", .entryPoint = "PsMain", .target = "ps_5_0", .defines = {"SHADOWS"}};
+
+    ShaderFiles createShaderFiles()
+    {
+        return ShaderFiles{.files = {
+                               {"shaders/Lighting.hlsl", "#include \"Common.hlsli\"\n#include \"../Shared.hlsli\"\nfloat4 PsMain() : SV_Target { return 0; }\n"},
+                               {"shaders/Common.hlsli", "#include \"Lighting.hlsl\" // Cycles are hashed once.\nstatic const float PI = 3.14159f;\n"},
+                               {"Shared.hlsli", "cbuffer Constants : register(b0) { float4 color; };\n"},
+                           }};
+    }
+}
+
+SGFX_TEST(ShaderIncludeScanning)
+{
+    constexpr std::string_view SOURCE = "#include \"Common.hlsli\"\n"
+                                        "  #  include <System.hlsli>\n"
+                                        "// #include \"LineComment.hlsli\"\n"
+                                        "/* #include \"BlockComment.hlsli\"\n"
+                                        "#include \"StillInComment.hlsli\" */\n"
+                                        "#include \"http://Slashes.hlsli\"\n"
+                                        "#define include \"NotAnInclude.hlsli\"\n"
+                                        "#ifdef UNUSED\n"
+                                        "#include \"Conditional.hlsli\"\n"
+                                        "#endif\n";
+
+    const std::vector<std::string> includePaths = sgfx::scanShaderIncludes(SOURCE);
+    SGFX_CHECK((includePaths == std::vector<std::string>{"Common.hlsli", "System.hlsli", "http://Slashes.hlsli", "Conditional.hlsli"}));
+}
+
+SGFX_TEST(ShaderKeyFollowsIncludes)
+{
+    ShaderFiles shaderFiles = createShaderFiles();
+    const uint64_t key = sgfx::computeShaderKey(PIXEL_SHADER_DESC, shaderFiles.getReader());
+
+    // Defines are hashed in any order.
+    sgfx::ShaderCompileDesc reorderedDesc = PIXEL_SHADER_DESC;
+    reorderedDesc.defines = {"MSAA", "SHADOWS"};
+    const uint64_t definesKey = sgfx::computeShaderKey(reorderedDesc, shaderFiles.getReader());
+
+    reorderedDesc.defines = {"SHADOWS", "MSAA"};
+    SGFX_CHECK(sgfx::computeShaderKey(reorderedDesc, shaderFiles.getReader()) == definesKey);
+    SGFX_CHECK(definesKey != key);
+
+    sgfx::ShaderCompileDesc otherTargetDesc = PIXEL_SHADER_DESC;
+    otherTargetDesc.target = "ps_5_1";
+    SGFX_CHECK(sgfx::computeShaderKey(otherTargetDesc, shaderFiles.getReader()) != key);
+
+    // Editing a file included relative to the including file's directory changes the key.
+    shaderFiles.files["Shared.hlsli"] += "// Edited.\n";
+    const uint64_t editedKey = sgfx::computeShaderKey(PIXEL_SHADER_DESC, shaderFiles.getReader());
+    SGFX_CHECK(editedKey != key);
+
+    // As does creating a missing include.
+    shaderFiles.files["shaders/Common.hlsli"] += "#include \"Optional.hlsli\"\n";
+    const uint64_t missingIncludeKey = sgfx::computeShaderKey(PIXEL_SHADER_DESC, shaderFiles.getReader());
+    SGFX_CHECK(missingIncludeKey != editedKey);
+
+    shaderFiles.files["shaders/Optional.hlsli"] = "";
+    SGFX_CHECK(sgfx::computeShaderKey(PIXEL_SHADER_DESC, shaderFiles.getReader()) != missingIncludeKey);
+}
+
+SGFX_TEST(ShaderCacheCompilesOnMissOnly)
+{
+    const TemporaryDirectory directory{};
+
+    ShaderFiles shaderFiles = createShaderFiles();
+    MockCompiler compiler{};
+
+    sgfx::ShaderCache shaderCache(directory.path, compiler.getCompiler(shaderFiles), shaderFiles.getReader());
+
+    const std::vector<std::byte> bytecode = shaderCache.getShader(PIXEL_SHADER_DESC);
+    SGFX_CHECK(shaderCache.getShader(PIXEL_SHADER_DESC) == bytecode);
+    SGFX_CHECK(compiler.compileCount == 1u);
+
+    // The cache persists on disk, so another instance (the next run) hits.
+    sgfx::ShaderCache nextRunShaderCache(directory.path, compiler.getCompiler(shaderFiles), shaderFiles.getReader());
+    SGFX_CHECK(nextRunShaderCache.getShader(PIXEL_SHADER_DESC) == bytecode);
+    SGFX_CHECK(compiler.compileCount == 1u);
+
+    const sgfx::ShaderCacheStats stats = shaderCache.getStats();
+    SGFX_CHECK(stats.requestCount == 2u && stats.hitCount == 1u && stats.compileCount == 1u);
+
+    // Editing an include is a miss.
+    shaderFiles.files["shaders/Common.hlsli"] += "// Edited.\n";
+    static_cast<void>(shaderCache.getShader(PIXEL_SHADER_DESC));
+    SGFX_CHECK(compiler.compileCount == 2u);
+}
+
+SGFX_TEST(ShaderCacheRecompilesInvalidFiles)
+{
+    const TemporaryDirectory directory{};
+
+    ShaderFiles shaderFiles = createShaderFiles();
+    MockCompiler compiler{};
+
+    sgfx::ShaderCache shaderCache(directory.path, compiler.getCompiler(shaderFiles), shaderFiles.getReader());
+    const std::vector<std::byte> bytecode = shaderCache.getShader(PIXEL_SHADER_DESC);
+
+    // Truncate the cached file, as a crash while writing would.
+    const std::filesystem::path cachePath = std::filesystem::directory_iterator(directory.path)->path();
+    std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 1u);
+
+    SGFX_CHECK(shaderCache.getShader(PIXEL_SHADER_DESC) == bytecode);
+    SGFX_CHECK(compiler.compileCount == 2u);
+    SGFX_CHECK(std::filesystem::file_size(cachePath) > bytecode.size());
+
+    // A shader that does not compile throws, and nothing is cached for it.
+    shaderFiles.files["shaders/Lighting.hlsl"] += "error\n";
+
+    bool hasThrown = false;
+    try
+    {
+        static_cast<void>(shaderCache.getShader(PIXEL_SHADER_DESC));
+    }
+    catch (const std::exception&)
+    {
+        hasThrown = true;
+    }
+
+    SGFX_CHECK(hasThrown);
+    SGFX_CHECK(std::ranges::distance(std::filesystem::directory_iterator(directory.path), std::filesystem::directory_iterator{}) == 1);
+}
+
+SGFX_TEST(ShaderCacheIsThreadSafe)
+{
+    constexpr uint32_t THREAD_COUNT = 8u;
+
+    const TemporaryDirectory directory{};
+
+    ShaderFiles shaderFiles = createShaderFiles();
+    MockCompiler compiler{};
+
+    sgfx::ShaderCache shaderCache(directory.path, compiler.getCompiler(shaderFiles), shaderFiles.getReader());
+
+    // Every thread requests the same shader with and without a define, so both may compile concurrently and race on their cache files.
+    std::vector<std::vector<std::byte>> bytecodes(THREAD_COUNT);
+    {
+        std::vector<std::jthread> threads{};
+        for (const uint32_t thread : std::views::iota(0u, THREAD_COUNT))
+        {
+            threads.emplace_back(
+                [&, thread]()
+                {
+                    sgfx::ShaderCompileDesc compileDesc = PIXEL_SHADER_DESC;
+                    if (thread % 2u == 0u)
+                    {
+                        compileDesc.defines.clear();
+                    }
+
+                    bytecodes[thread] = shaderCache.getShader(compileDesc);
+                });
+        }
+    }
+
+    SGFX_CHECK(std::ranges::all_of(bytecodes, [&](const std::vector<std::byte>& bytecode) { return bytecode == bytecodes[0]; }));
+    SGFX_CHECK(shaderCache.getStats().requestCount == THREAD_COUNT);
+    SGFX_CHECK(compiler.compileCount >= 2u && compiler.compileCount <= THREAD_COUNT);
+
+    // No temporary file is left behind.
+    SGFX_CHECK(std::ranges::distance(std::filesystem::directory_iterator(directory.path), std::filesystem::directory_iterator{}) == 2);
+}
@@ -0,0 +1,193 @@
+#include "Pch.hpp"
+
+#include "JobSystem.hpp"
+#include "SoftwareDeferredPasses.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    constexpr uint32_t IMAGE_WIDTH = 160u;
+    constexpr uint32_t IMAGE_HEIGHT = 120u;
+
+    // In 8 bit units, covering the rounding differences between instruction sets and compilers.
+    constexpr uint32_t GOLDEN_IMAGE_TOLERANCE = 2u;
+
+    // Next to this file, so the test does not depend on the working directory.
+    std::string getGoldenImagePathPrefix()
+    {
+        return (std::filesystem::path(std::source_location::current().file_name()).parent_path() / "golden" / "software_deferred").string();
+    }
+
+    // In [0, 1), from the raw output of the engine so every standard library gives the same values (the distributions do not).
+    float getRandomUnitFloat(std::mt19937& randomEngine) { return static_cast<float>(randomEngine() >> 8u) / 16777216.0f; }
+
+    struct SyntheticGBuffer
+    {
+        std::vector<uint32_t> albedos{};
+        std::vector<math::XMFLOAT4> positions{};
+        std::vector<math::XMFLOAT4> normals{};
+
+        sgfx::GBufferImages getImages() const
+        {
+            return sgfx::GBufferImages{
+                .width = IMAGE_WIDTH,
+                .height = IMAGE_HEIGHT,
+                .rowPitch = IMAGE_WIDTH,
+                .albedos = albedos,
+                .positions = positions,
+                .normals = normals,
+            };
+        }
+    };
+
+    // View space G-buffer of a room corner, ray cast from a camera at the origin looking down +z : a checkered floor, a back wall and a ball on
+    // the floor, for SSAO to darken the creases and the contact shadow. A square of the wall is cut out by the alpha test.
+    SyntheticGBuffer createGBuffer(const math::XMMATRIX projectionMatrix)
+    {
+        constexpr float FLOOR_HEIGHT = -1.0f;
+        constexpr float WALL_DEPTH = 6.0f;
+        constexpr math::XMFLOAT3 BALL_CENTER = {0.4f, -0.3f, 3.5f};
+        constexpr float BALL_RADIUS = 0.7f;
+
+        math::XMFLOAT4X4 projection{};
+        math::XMStoreFloat4x4(&projection, projectionMatrix);
+
+        SyntheticGBuffer gbuffer{};
+        for (uint32_t y = 0u; y < IMAGE_HEIGHT; y++)
+        {
+            for (uint32_t x = 0u; x < IMAGE_WIDTH; x++)
+            {
+                // Through the pixel center, with z = 1.
+                const math::XMFLOAT3 direction = {
+                    ((x + 0.5f) / IMAGE_WIDTH * 2.0f - 1.0f) / projection.m[0][0],
+                    (1.0f - (y + 0.5f) / IMAGE_HEIGHT * 2.0f) / projection.m[1][1],
+                    1.0f,
+                };
+
+                float distance = WALL_DEPTH;
+                math::XMFLOAT3 normal = {0.0f, 0.0f, -1.0f};
+                uint32_t albedo = 0xff4080c0u;
+
+                if (direction.y < 0.0f && FLOOR_HEIGHT / direction.y < distance)
+                {
+                    distance = FLOOR_HEIGHT / direction.y;
+                    normal = {0.0f, 1.0f, 0.0f};
+
+                    const bool isDarkSquare = (static_cast<int32_t>(std::floor(direction.x * distance * 2.0f)) + static_cast<int32_t>(std::floor(distance * 2.0f))) % 2 != 0;
+                    albedo = isDarkSquare ? 0xff505050u : 0xffd0d0d0u;
+                }
+
+                // Nearest root of |distance * direction - center|^2 = radius^2.
+                const float a = direction.x * direction.x + direction.y * direction.y + direction.z * direction.z;
+                const float b = direction.x * BALL_CENTER.x + direction.y * BALL_CENTER.y + direction.z * BALL_CENTER.z;
+                const float c = BALL_CENTER.x * BALL_CENTER.x + BALL_CENTER.y * BALL_CENTER.y + BALL_CENTER.z * BALL_CENTER.z - BALL_RADIUS * BALL_RADIUS;
+                const float discriminant = b * b - a * c;
+
+                if (discriminant >= 0.0f && (b - std::sqrt(discriminant)) / a < distance)
+                {
+                    distance = (b - std::sqrt(discriminant)) / a;
+                    normal = {
+                        (direction.x * distance - BALL_CENTER.x) / BALL_RADIUS,
+                        (direction.y * distance - BALL_CENTER.y) / BALL_RADIUS,
+                        (direction.z * distance - BALL_CENTER.z) / BALL_RADIUS,
+                    };
+                    albedo = 0xff2040e0u;
+                }
+
+                const math::XMFLOAT3 position = {direction.x * distance, direction.y * distance, distance};
+                if (distance == WALL_DEPTH && std::abs(position.x + 1.5f) < 0.4f && std::abs(position.y - 0.8f) < 0.4f)
+                {
+                    albedo &= 0x00ffffffu;
+                }
+
+                gbuffer.albedos.push_back(albedo);
+                gbuffer.positions.emplace_back(position.x, position.y, position.z, 1.0f);
+                gbuffer.normals.emplace_back(normal.x, normal.y, normal.z, 0.0f);
+            }
+        }
+
+        return gbuffer;
+    }
+}
+
+SGFX_TEST(SoftwareDeferredPassesMatchGoldenImages)
+{
+    sgfx::JobSystem jobSystem{3u};
+
+    const math::XMMATRIX projectionMatrix = math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(60.0f), IMAGE_WIDTH / static_cast<float>(IMAGE_HEIGHT), 0.1f, 100.0f);
+    const SyntheticGBuffer gbuffer = createGBuffer(projectionMatrix);
+
+    // Generated as the engine does, from a fixed seed.
+    std::mt19937 randomEngine(7u);
+
+    sgfx::SSAOBuffer ssaoBuffer{.projectionMatrix = projectionMatrix};
+    for (const uint32_t i : std::views::iota(0u, sgfx::SoftwareDeferredPasses::MAX_SSAO_SAMPLE_COUNT))
+    {
+        const math::XMVECTOR direction = math::XMVector3Normalize(math::XMVectorSet(getRandomUnitFloat(randomEngine) * 2.0f - 1.0f,
+                                                                                   getRandomUnitFloat(randomEngine) * 2.0f - 1.0f,
+                                                                                   getRandomUnitFloat(randomEngine),
+                                                                                   0.0f));
+
+        const float scaleFactor = static_cast<float>(i) / sgfx::SoftwareDeferredPasses::MAX_SSAO_SAMPLE_COUNT;
+        const float scale = 0.1f + 0.9f * scaleFactor * scaleFactor;
+
+        math::XMStoreFloat4(&ssaoBuffer.sampleVectors[i], math::XMVectorScale(direction, getRandomUnitFloat(randomEngine) * scale));
+    }
+
+    std::array<math::XMFLOAT2, sgfx::SoftwareDeferredPasses::SSAO_NOISE_SIZE * sgfx::SoftwareDeferredPasses::SSAO_NOISE_SIZE> noise{};
+    for (math::XMFLOAT2& rotation : noise)
+    {
+        rotation = {getRandomUnitFloat(randomEngine) * 2.0f - 1.0f, getRandomUnitFloat(randomEngine) * 2.0f - 1.0f};
+    }
+
+    // A directional light from above and behind the camera, and point lights of different colors around the ball.
+    sgfx::SceneBuffer sceneBuffer{};
+    sceneBuffer.viewSpaceLightPosition[0] = {0.3f, 0.8f, -0.5f, 0.0f};
+    sceneBuffer.lightColorIntensity[0] = {1.0f, 0.95f, 0.9f, 1.0f};
+
+    constexpr std::array<math::XMFLOAT4, sgfx::LIGHT_COUNT - 1u> POINT_LIGHT_POSITIONS = {{
+        {-1.5f, 0.0f, 3.0f, 1.0f},
+        {1.8f, 0.5f, 4.0f, 1.0f},
+        {0.0f, 1.5f, 5.0f, 1.0f},
+        {0.5f, -0.5f, 2.0f, 1.0f},
+    }};
+
+    constexpr std::array<math::XMFLOAT4, sgfx::LIGHT_COUNT - 1u> POINT_LIGHT_COLORS = {{
+        {1.0f, 0.3f, 0.2f, 2.0f},
+        {0.2f, 1.0f, 0.3f, 2.0f},
+        {0.3f, 0.4f, 1.0f, 3.0f},
+        {1.0f, 1.0f, 1.0f, 0.5f},
+    }};
+
+    for (const uint32_t i : std::views::iota(1u, sgfx::LIGHT_COUNT))
+    {
+        sceneBuffer.viewSpaceLightPosition[i] = POINT_LIGHT_POSITIONS[i - 1u];
+        sceneBuffer.lightColorIntensity[i] = POINT_LIGHT_COLORS[i - 1u];
+    }
+
+    sgfx::SoftwareDeferredPasses passes{};
+    passes.resize(IMAGE_WIDTH, IMAGE_HEIGHT);
+
+    passes.computeAmbientOcclusion(gbuffer.getImages(), ssaoBuffer, noise, sgfx::SoftwareDeferredPasses::MAX_SSAO_SAMPLE_COUNT, jobSystem);
+    passes.blurAmbientOcclusion(jobSystem);
+    passes.computeLighting(gbuffer.getImages(), sceneBuffer, jobSystem);
+
+    // A missing golden image fails as a differing one does.
+    const std::array<sgfx::GoldenImageComparison, 3> comparisons = passes.compareWithGoldenImages(getGoldenImagePathPrefix(), GOLDEN_IMAGE_TOLERANCE);
+
+    bool isMatching = true;
+    for (const sgfx::GoldenImageComparison& comparison : comparisons)
+    {
+        SGFX_CHECK(comparison.isCompared);
+        SGFX_CHECK(comparison.differingPixelCount == 0u);
+
+        isMatching = isMatching && comparison.isCompared && comparison.differingPixelCount == 0u;
+    }
+
+    // The images are written for inspection, and to replace the golden images if the change is intended.
+    if (!isMatching)
+    {
+        const std::string pathPrefix = (std::filesystem::temp_directory_path() / "software_deferred").string();
+        std::cout << std::format("    Images {} the golden images : {}_*.png written.\n", passes.writePngs(pathPrefix) ? "differing from" : "failing to write", pathPrefix);
+    }
+}
@@ -0,0 +1,228 @@
+#include "Pch.hpp"
+
+#include "JobSystem.hpp"
+#include "SoftwareRasterizer.hpp"
+#include "TangentGeneration.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    constexpr uint32_t IMAGE_WIDTH = 160u;
+    constexpr uint32_t IMAGE_HEIGHT = 120u;
+
+    // In 8 bit units, covering the rounding differences between instruction sets and compilers.
+    constexpr uint32_t GOLDEN_IMAGE_TOLERANCE = 2u;
+
+    // Pixels on triangle edges whose coverage may flip with the rounding of another compiler (e.g contracting multiplies and adds).
+    constexpr uint64_t MAX_DIFFERING_PIXEL_COUNT = 16u;
+
+    // Next to this file, so the test does not depend on the working directory.
+    std::string getGoldenImagePathPrefix()
+    {
+        return (std::filesystem::path(std::source_location::current().file_name()).parent_path() / "golden" / "software_rasterizer").string();
+    }
+
+    struct MeshData
+    {
+        std::vector<sgfx::ModelVertex> vertices{};
+        std::vector<uint32_t> indices{};
+    };
+
+    // Quad centered on center spanning +-u and +-v, facing cross(u, v) (counter clockwise, as glTF front faces), with textureScale repeats of
+    // the texture along each side.
+    void appendQuad(MeshData& mesh, const math::XMFLOAT3& center, const math::XMFLOAT3& u, const math::XMFLOAT3& v, const float textureScale)
+    {
+        const math::XMVECTOR centerVector = math::XMLoadFloat3(&center);
+        const math::XMVECTOR uVector = math::XMLoadFloat3(&u);
+        const math::XMVECTOR vVector = math::XMLoadFloat3(&v);
+
+        math::XMFLOAT3 normal{};
+        math::XMStoreFloat3(&normal, math::XMVector3Normalize(math::XMVector3Cross(uVector, vVector)));
+
+        const uint32_t firstVertex = static_cast<uint32_t>(mesh.vertices.size());
+
+        const std::array<std::pair<float, float>, 4> corners = {{{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}}};
+        for (const auto& [cornerU, cornerV] : corners)
+        {
+            sgfx::ModelVertex& vertex = mesh.vertices.emplace_back();
+            math::XMStoreFloat3(&vertex.position, math::XMVectorAdd(centerVector, math::XMVectorAdd(math::XMVectorScale(uVector, cornerU), math::XMVectorScale(vVector, cornerV))));
+
+            // v grows downwards, as in glTF.
+            vertex.textureCoord = {(cornerU + 1.0f) * 0.5f * textureScale, (1.0f - cornerV) * 0.5f * textureScale};
+            vertex.normal = normal;
+        }
+
+        mesh.indices.insert(mesh.indices.end(), {firstVertex, firstVertex + 1u, firstVertex + 2u, firstVertex, firstVertex + 2u, firstVertex + 3u});
+    }
+
+    // RGBA8 texels of a size x size image, from texel(x, y).
+    template <typename Texel> std::vector<uint8_t> createImage(const uint32_t size, const Texel& texel)
+    {
+        std::vector<uint8_t> pixels{};
+        for (uint32_t y = 0u; y < size; y++)
+        {
+            for (uint32_t x = 0u; x < size; x++)
+            {
+                const std::array<uint8_t, 4> value = texel(x, y);
+                pixels.insert(pixels.end(), value.begin(), value.end());
+            }
+        }
+
+        return pixels;
+    }
+
+    // A checkered floor reaching behind the camera (so it is clipped by the near plane), a box with a normal map, seen on three sides, and a
+    // panel with square holes cut out by the alpha test. Made of integer patterns and without trigonometry, so every platform builds it
+    // identically.
+    struct Scene
+    {
+        Scene()
+        {
+            appendQuad(floor, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 10.0f}, {10.0f, 0.0f, 0.0f}, 10.0f);
+
+            for (const uint32_t axis : std::views::iota(0u, 3u))
+            {
+                for (const float sign : {-1.0f, 1.0f})
+                {
+                    std::array<float, 3> center = {0.0f, 0.5f, 0.0f};
+                    std::array<float, 3> u{};
+                    std::array<float, 3> v{};
+
+                    center[axis] += 0.5f * sign;
+                    u[(axis + 1u) % 3u] = 0.5f;
+                    v[(axis + 2u) % 3u] = 0.5f;
+
+                    if (sign < 0.0f)
+                    {
+                        std::swap(u, v);
+                    }
+
+                    appendQuad(box, {center[0], center[1], center[2]}, {u[0], u[1], u[2]}, {v[0], v[1], v[2]}, 1.0f);
+                }
+            }
+
+            sgfx::computeTangents(box.vertices, box.indices);
+
+            appendQuad(panel, {-1.8f, 1.0f, 1.5f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 1.0f);
+
+            checkerTexture = sgfx::createRasterTexture(16u,
+                                                       16u,
+                                                       createImage(16u,
+                                                                   [](const uint32_t x, const uint32_t y) -> std::array<uint8_t, 4>
+                                                                   { return ((x / 8u + y / 8u) % 2u == 0u) ? std::array<uint8_t, 4>{230u, 220u, 200u, 255u} : std::array<uint8_t, 4>{60u, 70u, 90u, 255u}; }),
+                                                       true);
+
+            boxTexture = sgfx::createRasterTexture(32u,
+                                                   32u,
+                                                   createImage(32u,
+                                                               [](const uint32_t x, const uint32_t y) -> std::array<uint8_t, 4>
+                                                               { return {static_cast<uint8_t>(x * 8u), static_cast<uint8_t>(y * 8u), 160u, 255u}; }),
+                                                   true);
+
+            // Ridges along v : the normal leans towards -u on the left of each ridge and +u on its right.
+            boxNormalTexture = sgfx::createRasterTexture(32u,
+                                                         32u,
+                                                         createImage(32u,
+                                                                     [](const uint32_t x, const uint32_t) -> std::array<uint8_t, 4>
+                                                                     { return {(x % 8u) < 4u ? static_cast<uint8_t>(64u) : static_cast<uint8_t>(192u), 128u, 255u, 255u}; }),
+                                                         false);
+
+            panelTexture = sgfx::createRasterTexture(16u,
+                                                     16u,
+                                                     createImage(16u,
+                                                                 [](const uint32_t x, const uint32_t y) -> std::array<uint8_t, 4>
+                                                                 {
+                                                                     const bool isHole = (x / 4u) % 2u == 1u && (y / 4u) % 2u == 1u;
+                                                                     return {200u, 60u, 40u, isHole ? static_cast<uint8_t>(0u) : static_cast<uint8_t>(255u)};
+                                                                 }),
+                                                     true);
+        }
+
+        std::array<sgfx::RasterMesh, 3> getMeshes() const
+        {
+            return {
+                sgfx::RasterMesh{.vertices = floor.vertices, .indices = floor.indices, .modelMatrix = math::XMMatrixIdentity(), .albedoTexture = &checkerTexture},
+                sgfx::RasterMesh{.vertices = box.vertices,
+                                 .indices = box.indices,
+                                 .modelMatrix = math::XMMatrixTranslation(0.3f, 0.0f, 0.5f),
+                                 .albedoTexture = &boxTexture,
+                                 .normalTexture = &boxNormalTexture},
+                sgfx::RasterMesh{.vertices = panel.vertices, .indices = panel.indices, .modelMatrix = math::XMMatrixIdentity(), .albedoTexture = &panelTexture},
+            };
+        }
+
+        MeshData floor{};
+        MeshData box{};
+        MeshData panel{};
+
+        sgfx::RasterTexture checkerTexture{};
+        sgfx::RasterTexture boxTexture{};
+        sgfx::RasterTexture boxNormalTexture{};
+        sgfx::RasterTexture panelTexture{};
+    };
+
+    const math::XMMATRIX VIEW_MATRIX =
+        math::XMMatrixLookAtLH(math::XMVectorSet(1.5f, 2.0f, -3.0f, 1.0f), math::XMVectorSet(0.0f, 0.5f, 0.5f, 1.0f), math::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+
+    // About 60 degrees vertically, from the size of the near plane rather than an angle.
+    const math::XMMATRIX PROJECTION_MATRIX = math::XMMatrixPerspectiveLH(0.16f, 0.12f, 0.1f, 50.0f);
+}
+
+SGFX_TEST(SoftwareRasterizerMatchesGoldenImages)
+{
+    const Scene scene{};
+    const std::array<sgfx::RasterMesh, 3> meshes = scene.getMeshes();
+
+    sgfx::JobSystem jobSystem{};
+
+    sgfx::SoftwareRasterizer rasterizer{};
+    rasterizer.resize(IMAGE_WIDTH, IMAGE_HEIGHT);
+
+    const sgfx::SoftwareRasterizationStats stats = rasterizer.render(meshes, VIEW_MATRIX, PROJECTION_MATRIX, jobSystem);
+
+    // Half the box faces away, the floor is clipped into more triangles, and the holes of the panel are discarded.
+    SGFX_CHECK(stats.meshCount == 3u && stats.triangleCount == 2u + 12u + 2u);
+    SGFX_CHECK(stats.rasterizedTriangleCount >= 2u + 6u + 2u && stats.rasterizedTriangleCount < stats.triangleCount);
+    SGFX_CHECK(stats.writtenPixelCount > 0u && stats.writtenPixelCount < stats.shadedPixelCount);
+
+    // A missing golden image fails as a differing one does.
+    const std::array<sgfx::GoldenImageComparison, 3> comparisons = rasterizer.compareWithGoldenImages(getGoldenImagePathPrefix(), GOLDEN_IMAGE_TOLERANCE);
+
+    bool isMatching = true;
+    for (const sgfx::GoldenImageComparison& comparison : comparisons)
+    {
+        SGFX_CHECK(comparison.isCompared);
+        SGFX_CHECK(comparison.differingPixelCount <= MAX_DIFFERING_PIXEL_COUNT);
+
+        isMatching = isMatching && comparison.isCompared && comparison.differingPixelCount == 0u;
+    }
+
+    // The images are written for inspection, and to replace the golden images if the change is intended.
+    if (!isMatching)
+    {
+        const std::string pathPrefix = (std::filesystem::temp_directory_path() / "software_rasterizer").string();
+        std::cout << std::format("    Images {} the golden images : {}_*.png written.\n", rasterizer.writePngs(pathPrefix) ? "differing from" : "failing to write", pathPrefix);
+    }
+}
+
+SGFX_TEST(SoftwareRasterizerDoesNotDependOnThreadCount)
+{
+    const Scene scene{};
+    const std::array<sgfx::RasterMesh, 3> meshes = scene.getMeshes();
+
+    sgfx::JobSystem jobSystem{};
+    sgfx::JobSystem singleWorkerJobSystem{1u};
+
+    sgfx::SoftwareRasterizer rasterizer{};
+    rasterizer.resize(IMAGE_WIDTH, IMAGE_HEIGHT);
+    rasterizer.render(meshes, VIEW_MATRIX, PROJECTION_MATRIX, jobSystem);
+
+    const std::vector<uint32_t> albedos(rasterizer.getAlbedos().begin(), rasterizer.getAlbedos().end());
+    const std::vector<float> depths(rasterizer.getDepths().begin(), rasterizer.getDepths().end());
+
+    // Tiles are only rasterized after every triangle is binned in mesh order, so the result is the same however the work is split.
+    rasterizer.render(meshes, VIEW_MATRIX, PROJECTION_MATRIX, singleWorkerJobSystem);
+
+    SGFX_CHECK(std::ranges::equal(albedos, rasterizer.getAlbedos()));
+    SGFX_CHECK(std::ranges::equal(depths, rasterizer.getDepths()));
+}
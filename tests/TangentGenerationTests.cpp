@@ -0,0 +1,154 @@
+#include "Pch.hpp"
+
+#include "TangentGeneration.hpp"
+#include "Test.hpp"
+
+namespace
+{
+    // A grid of size x size quads over [0, 1]^2 in the z = 0 plane, facing +z (counter clockwise, as glTF front faces), with the texture
+    // coordinates given by textureCoord(x, y).
+    template <typename TextureCoord> std::pair<std::vector<sgfx::ModelVertex>, std::vector<uint32_t>> createGrid(const uint32_t size, const TextureCoord& textureCoord)
+    {
+        std::vector<sgfx::ModelVertex> vertices{};
+        std::vector<uint32_t> indices{};
+
+        for (uint32_t y = 0u; y <= size; y++)
+        {
+            for (uint32_t x = 0u; x <= size; x++)
+            {
+                const float positionX = static_cast<float>(x) / size;
+                const float positionY = static_cast<float>(y) / size;
+
+                vertices.push_back(sgfx::ModelVertex{.position = {positionX, positionY, 0.0f}, .textureCoord = textureCoord(positionX, positionY), .normal = {0.0f, 0.0f, 1.0f}});
+            }
+        }
+
+        for (uint32_t y = 0u; y < size; y++)
+        {
+            for (uint32_t x = 0u; x < size; x++)
+            {
+                const uint32_t v00 = y * (size + 1u) + x;
+                const uint32_t v01 = v00 + size + 1u;
+
+                indices.insert(indices.end(), {v00, v00 + 1u, v01 + 1u, v00, v01 + 1u, v01});
+            }
+        }
+
+        return {std::move(vertices), std::move(indices)};
+    }
+
+    bool isNear(const math::XMFLOAT4& a, const math::XMFLOAT4& b)
+    {
+        return math::XMVector4NearEqual(math::XMLoadFloat4(&a), math::XMLoadFloat4(&b), math::XMVectorReplicate(1e-5f));
+    }
+}
+
+SGFX_TEST(TangentsFollowTextureSpace)
+{
+    // v grows downwards as in glTF, so the bitangent (towards decreasing v) points up along +y and the handedness is positive.
+    auto [vertices, indices] = createGrid(4u, [](const float x, const float y) { return math::XMFLOAT2{x, 1.0f - y}; });
+    const size_t vertexCount = vertices.size();
+
+    sgfx::computeTangents(vertices, indices);
+
+    SGFX_CHECK(vertices.size() == vertexCount);
+    SGFX_CHECK(std::ranges::all_of(vertices, [](const sgfx::ModelVertex& vertex) { return isNear(vertex.tangent, {1.0f, 0.0f, 0.0f, 1.0f}); }));
+
+    // With v growing upwards, the bitangent must point down instead.
+    auto [flippedVertices, flippedIndices] = createGrid(4u, [](const float x, const float y) { return math::XMFLOAT2{x, y}; });
+    sgfx::computeTangents(flippedVertices, flippedIndices);
+
+    SGFX_CHECK(std::ranges::all_of(flippedVertices, [](const sgfx::ModelVertex& vertex) { return isNear(vertex.tangent, {1.0f, 0.0f, 0.0f, -1.0f}); }));
+}
+
+SGFX_TEST(TangentsSplitMirroredTextureCoords)
+{
+    constexpr uint32_t SIZE = 4u;
+
+    // The right half mirrors the left half in u, both share the vertices of the middle column.
+    auto [vertices, indices] = createGrid(SIZE, [](const float x, const float y) { return math::XMFLOAT2{x <= 0.5f ? x : 1.0f - x, 1.0f - y}; });
+    const size_t vertexCount = vertices.size();
+
+    sgfx::computeTangents(vertices, indices);
+
+    // One copy per vertex of the middle column.
+    SGFX_CHECK(vertices.size() == vertexCount + SIZE + 1u);
+
+    for (size_t i = 0u; i < indices.size(); i += 3u)
+    {
+        const bool isLeftHalf = vertices[indices[i]].position.x + vertices[indices[i + 1u]].position.x + vertices[indices[i + 2u]].position.x < 1.5f;
+        const math::XMFLOAT4 expectedTangent = isLeftHalf ? math::XMFLOAT4{1.0f, 0.0f, 0.0f, 1.0f} : math::XMFLOAT4{-1.0f, 0.0f, 0.0f, -1.0f};
+
+        for (const uint32_t corner : std::views::iota(0u, 3u))
+        {
+            SGFX_CHECK(isNear(vertices[indices[i + corner]].tangent, expectedTangent));
+        }
+    }
+}
+
+SGFX_TEST(TangentsOfSphereMatchAnalyticTangents)
+{
+    constexpr uint32_t RING_COUNT = 32u;
+    constexpr uint32_t SEGMENT_COUNT = 64u;
+    constexpr float PI = 3.14159265f;
+
+    // A UV sphere, with a duplicated column of vertices at the u seam.
+    std::vector<sgfx::ModelVertex> vertices{};
+    for (uint32_t ring = 0u; ring <= RING_COUNT; ring++)
+    {
+        for (uint32_t segment = 0u; segment <= SEGMENT_COUNT; segment++)
+        {
+            const float theta = PI * ring / RING_COUNT;
+            const float phi = 2.0f * PI * segment / SEGMENT_COUNT;
+
+            const math::XMFLOAT3 position = {std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)};
+            vertices.push_back(sgfx::ModelVertex{
+                .position = position,
+                .textureCoord = {static_cast<float>(segment) / SEGMENT_COUNT, static_cast<float>(ring) / RING_COUNT},
+                .normal = position,
+            });
+        }
+    }
+
+    std::vector<uint32_t> indices{};
+    for (uint32_t ring = 0u; ring < RING_COUNT; ring++)
+    {
+        for (uint32_t segment = 0u; segment < SEGMENT_COUNT; segment++)
+        {
+            const uint32_t v00 = ring * (SEGMENT_COUNT + 1u) + segment;
+            const uint32_t v10 = v00 + SEGMENT_COUNT + 1u;
+
+            indices.insert(indices.end(), {v00, v00 + 1u, v10 + 1u, v00, v10 + 1u, v10});
+        }
+    }
+
+    sgfx::computeTangents(vertices, indices);
+
+    // The poles have no well defined tangent, every other vertex follows d(position) / du.
+    float maximumAngle = 0.0f;
+    for (uint32_t ring = 1u; ring < RING_COUNT; ring++)
+    {
+        for (uint32_t segment = 0u; segment <= SEGMENT_COUNT; segment++)
+        {
+            const sgfx::ModelVertex& vertex = vertices[ring * (SEGMENT_COUNT + 1u) + segment];
+
+            const float phi = 2.0f * PI * segment / SEGMENT_COUNT;
+            const math::XMVECTOR expectedTangent = math::XMVectorSet(-std::sin(phi), 0.0f, std::cos(phi), 0.0f);
+            const math::XMVECTOR tangent = math::XMVectorSetW(math::XMLoadFloat4(&vertex.tangent), 0.0f);
+
+            const float cosine = math::XMVectorGetX(math::XMVector3Dot(expectedTangent, math::XMVector3Normalize(tangent)));
+            maximumAngle = std::max(maximumAngle, math::XMConvertToDegrees(std::acos(std::clamp(cosine, -1.0f, 1.0f))));
+        }
+    }
+
+    SGFX_CHECK(maximumAngle < 3.0f);
+
+    // Tangents are unit length and orthogonal to the normal everywhere, poles included.
+    for (const sgfx::ModelVertex& vertex : vertices)
+    {
+        const math::XMVECTOR tangent = math::XMVectorSetW(math::XMLoadFloat4(&vertex.tangent), 0.0f);
+
+        SGFX_CHECK(std::abs(math::XMVectorGetX(math::XMVector3Length(tangent)) - 1.0f) < 1e-4f);
+        SGFX_CHECK(std::abs(math::XMVectorGetX(math::XMVector3Dot(tangent, math::XMLoadFloat3(&vertex.normal)))) < 1e-4f);
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Minimal test registry : SGFX_TEST defines a test function registered at static initialization, SGFX_CHECK records a failure of the running
+// test without stopping it. A test also fails if it throws.
+#define SGFX_TEST(name)                                                                                                                              \
+    static void name();                                                                                                                              \
+    static const sgfx::test::TestRegistration name##Registration{#name, &name};                                                                      \
+    static void name()
+
+#define SGFX_CHECK(expression) ((expression) ? void() : sgfx::test::reportFailure(#expression))
+
+namespace sgfx::test
+{
+    using TestFunction = void (*)();
+
+    struct TestCase
+    {
+        std::string_view name{};
+        TestFunction function{};
+    };
+
+    // Every registered test, in registration order within a translation unit.
+    std::vector<TestCase>& getTestCases();
+
+    void reportFailure(const std::string_view expression, const std::source_location sourceLocation = std::source_location::current());
+
+    struct TestRegistration
+    {
+        TestRegistration(const std::string_view name, const TestFunction function) { getTestCases().push_back(TestCase{.name = name, .function = function}); }
+    };
+}
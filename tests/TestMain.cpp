@@ -0,0 +1,65 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+
+namespace sgfx::test
+{
+    namespace
+    {
+        uint32_t failureCount{};
+    }
+
+    std::vector<TestCase>& getTestCases()
+    {
+        static std::vector<TestCase> testCases{};
+        return testCases;
+    }
+
+    void reportFailure(const std::string_view expression, const std::source_location sourceLocation)
+    {
+        std::cout << std::format("    {}({}) : check failed : {}\n", sourceLocation.file_name(), sourceLocation.line(), expression);
+        failureCount++;
+    }
+}
+
+// Runs every test, or those whose name contains the first argument. Returns 1 if any of them failed.
+int main(int argc, char** argv)
+{
+    const std::string_view filter = argc > 1 ? std::string_view(argv[1]) : std::string_view{};
+
+    uint32_t testCount = 0u;
+    uint32_t failedTestCount = 0u;
+
+    for (const sgfx::test::TestCase& testCase : sgfx::test::getTestCases())
+    {
+        if (testCase.name.find(filter) == std::string_view::npos)
+        {
+            continue;
+        }
+
+        const uint32_t previousFailureCount = sgfx::test::failureCount;
+
+        try
+        {
+            testCase.function();
+        }
+        catch (const std::exception& exception)
+        {
+            sgfx::test::reportFailure(std::format("unexpected exception : {}", exception.what()));
+        }
+        catch (...)
+        {
+            sgfx::test::reportFailure("unexpected exception");
+        }
+
+        const bool isPassed = sgfx::test::failureCount == previousFailureCount;
+        std::cout << std::format("[{}] {}\n", isPassed ? "PASS" : "FAIL", testCase.name);
+
+        testCount++;
+        failedTestCount += isPassed ? 0u : 1u;
+    }
+
+    std::cout << std::format("{} of {} tests passed.\n", testCount - failedTestCount, testCount);
+
+    return failedTestCount == 0u ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include "Pch.hpp"
+
+#include "NullRenderBackend.hpp"
+#include "TextureCache.hpp"
+#include "Test.hpp"
+
+#include <stb_image_write.h>
+
+#include <latch>
+
+namespace
+{
+    // Directory of its own under the system temporary directory, removed with its contents when destroyed.
+    struct TemporaryDirectory
+    {
+        TemporaryDirectory() : path(std::filesystem::temp_directory_path() / std::format("sgfx_texture_cache_tests_{}", std::random_device{}()))
+        {
+            std::filesystem::create_directories(path);
+        }
+
+        ~TemporaryDirectory()
+        {
+            std::error_code errorCode{};
+            std::filesystem::remove_all(path, errorCode);
+        }
+
+        std::filesystem::path path{};
+    };
+
+    // Checkerboard, so the image is cooked as any other.
+    std::string writeImage(const std::filesystem::path& path)
+    {
+        constexpr int IMAGE_SIZE = 64;
+
+        std::vector<uint8_t> pixels(IMAGE_SIZE * IMAGE_SIZE * 4u);
+        for (int y = 0; y < IMAGE_SIZE; y++)
+        {
+            for (int x = 0; x < IMAGE_SIZE; x++)
+            {
+                const uint8_t value = ((x / 8 + y / 8) % 2 == 0) ? 255u : 32u;
+                const size_t offset = static_cast<size_t>(y * IMAGE_SIZE + x) * 4u;
+
+                pixels[offset + 0u] = value;
+                pixels[offset + 1u] = 128u;
+                pixels[offset + 2u] = static_cast<uint8_t>(255u - value);
+                pixels[offset + 3u] = 255u;
+            }
+        }
+
+        const std::string imagePath = path.generic_string();
+        stbi_write_png(imagePath.c_str(), IMAGE_SIZE, IMAGE_SIZE, 4, pixels.data(), IMAGE_SIZE * 4);
+
+        return imagePath;
+    }
+}
+
+SGFX_TEST(TextureCacheHitsShareTexture)
+{
+    const TemporaryDirectory directory{};
+
+    // Mixed case, which has to be loaded as spelled on case sensitive file systems.
+    const std::string imagePath = writeImage(directory.path / "Mixed_Case.png");
+    const std::string equivalentPath = (directory.path / "." / "sub" / ".." / "Mixed_Case.png").generic_string();
+
+    sgfx::JobSystem jobSystem{};
+    sgfx::NullRenderBackend renderBackend{};
+    sgfx::TextureCache textureCache(renderBackend, jobSystem);
+
+    const sgfx::TextureHandle texture = textureCache.getTexture(imagePath, sgfx::TextureUsage::Albedo);
+    const sgfx::TextureHandle equivalentTexture = textureCache.getTexture(equivalentPath, sgfx::TextureUsage::Albedo);
+
+    SGFX_CHECK(texture != nullptr && texture->resource && texture->width == 64u && texture->height == 64u);
+    SGFX_CHECK(equivalentTexture == texture);
+
+    // Another usage is another texture.
+    const sgfx::TextureHandle normalTexture = textureCache.getTexture(imagePath, sgfx::TextureUsage::Normal);
+    SGFX_CHECK(normalTexture != nullptr && normalTexture != texture);
+
+    const sgfx::TextureCacheStats stats = textureCache.getStats();
+    SGFX_CHECK(stats.requestCount == 3u);
+    SGFX_CHECK(stats.hitCount == 1u && stats.inFlightHitCount == 0u);
+    SGFX_CHECK(stats.bytesSaved == texture->sizeInBytes && stats.bytesSaved > 0u);
+    SGFX_CHECK(stats.cookedTextureCount == 2u && stats.uncompressedTextureCount == 0u);
+    SGFX_CHECK(stats.cookedBytes > 0u && stats.lowestCookedPsnr > 0.0);
+    SGFX_CHECK(stats.residentTextureCount == 2u && stats.residentBytes == texture->sizeInBytes + normalTexture->sizeInBytes);
+}
+
+SGFX_TEST(TextureCacheReloadsExpiredTextures)
+{
+    const TemporaryDirectory directory{};
+    const std::string imagePath = writeImage(directory.path / "expiring.png");
+
+    sgfx::JobSystem jobSystem{};
+    sgfx::NullRenderBackend renderBackend{};
+    sgfx::TextureCache textureCache(renderBackend, jobSystem);
+
+    sgfx::TextureHandle texture = textureCache.getTexture(imagePath, sgfx::TextureUsage::Albedo);
+    SGFX_CHECK(textureCache.getStats().residentTextureCount == 1u);
+
+    // The cache does not own textures, so releasing the last handle frees it.
+    texture.reset();
+    SGFX_CHECK(textureCache.getStats().residentTextureCount == 0u && textureCache.getStats().residentBytes == 0u);
+
+    // Loaded again, but from the cooked file written the first time.
+    texture = textureCache.getTexture(imagePath, sgfx::TextureUsage::Albedo);
+
+    const sgfx::TextureCacheStats stats = textureCache.getStats();
+    SGFX_CHECK(texture != nullptr && texture->resource);
+    SGFX_CHECK(stats.requestCount == 2u && stats.hitCount == 0u && stats.inFlightHitCount == 0u && stats.bytesSaved == 0u);
+    SGFX_CHECK(stats.cookedTextureCount == 1u);
+    SGFX_CHECK(stats.residentTextureCount == 1u);
+}
+
+SGFX_TEST(TextureCacheDeduplicatesLoadsInFlight)
+{
+    constexpr uint32_t THREAD_COUNT = 8u;
+
+    const TemporaryDirectory directory{};
+    const std::string imagePath = writeImage(directory.path / "shared.png");
+
+    sgfx::JobSystem jobSystem{};
+    sgfx::NullRenderBackend renderBackend{};
+    sgfx::TextureCache textureCache(renderBackend, jobSystem);
+
+    // Released together, so most requests arrive while the first one is still cooking the image.
+    std::latch startLatch(THREAD_COUNT);
+    std::array<sgfx::TextureHandle, THREAD_COUNT> textures{};
+
+    {
+        std::vector<std::jthread> threads{};
+        for (uint32_t i = 0u; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back(
+                [&, i]()
+                {
+                    startLatch.arrive_and_wait();
+                    textures[i] = textureCache.getTexture(imagePath, sgfx::TextureUsage::Albedo);
+                });
+        }
+    }
+
+    const sgfx::TextureCacheStats stats = textureCache.getStats();
+
+    // Whether a request waited or found the texture resident depends on timing, but the image is only loaded once either way.
+    SGFX_CHECK(std::ranges::all_of(textures, [&](const sgfx::TextureHandle& texture) { return texture != nullptr && texture == textures[0]; }));
+    SGFX_CHECK(stats.requestCount == THREAD_COUNT);
+    SGFX_CHECK(stats.hitCount + stats.inFlightHitCount == THREAD_COUNT - 1u);
+    SGFX_CHECK(stats.cookedTextureCount == 1u);
+    SGFX_CHECK(stats.bytesSaved == (THREAD_COUNT - 1u) * textures[0]->sizeInBytes);
+}
@@ -0,0 +1,231 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+#include "TextureStreaming.hpp"
+
+namespace
+{
+    constexpr uint32_t TEXTURE_SIZE = 1024u;
+
+    // RGBA8 mips of a TEXTURE_SIZE x TEXTURE_SIZE texture : 4 MiB, 1 MiB, 256 KiB... With the default 64 texel mip tail, mips 4 and coarser are
+    // always resident.
+    const std::vector<uint64_t>& getMipSizes()
+    {
+        static const std::vector<uint64_t> mipSizes = []()
+        {
+            std::vector<uint64_t> sizes{};
+            for (uint32_t size = TEXTURE_SIZE; size > 0u; size >>= 1u)
+            {
+                sizes.push_back(uint64_t{size} * size * 4u);
+            }
+
+            return sizes;
+        }();
+
+        return mipSizes;
+    }
+
+    constexpr uint32_t MIP_TAIL_FIRST_MIP = 4u;
+
+    uint32_t addTexture(sgfx::TextureStreamer& streamer)
+    {
+        return streamer.addTexture(sgfx::StreamedTextureDesc{.mipSizes = getMipSizes(), .width = TEXTURE_SIZE, .height = TEXTURE_SIZE});
+    }
+
+    // Completes every request as if it succeeded.
+    void completeRequests(sgfx::TextureStreamer& streamer, std::span<const sgfx::TextureStreamingRequest> requests)
+    {
+        for (const sgfx::TextureStreamingRequest& request : requests)
+        {
+            streamer.completeRequest(request.textureId, request.firstMip);
+        }
+    }
+}
+
+SGFX_TEST(TextureStreamerStartsAtMipTail)
+{
+    sgfx::TextureStreamer streamer{};
+    const uint32_t textureId = addTexture(streamer);
+
+    SGFX_CHECK(streamer.getMipTailFirstMip(textureId) == MIP_TAIL_FIRST_MIP);
+    SGFX_CHECK(streamer.getResidentMip(textureId) == MIP_TAIL_FIRST_MIP);
+    SGFX_CHECK(streamer.getResidentSize(textureId) == std::accumulate(getMipSizes().begin() + MIP_TAIL_FIRST_MIP, getMipSizes().end(), uint64_t{0u}));
+
+    // Nothing is loaded until finer mips are requested.
+    SGFX_CHECK(streamer.update().empty());
+    SGFX_CHECK(streamer.getStats().textureCount == 1u);
+
+    // Textures smaller than the tail are entirely resident.
+    const std::array<uint64_t, 3> smallMipSizes = {64u, 16u, 4u};
+    const uint32_t smallTextureId = streamer.addTexture(sgfx::StreamedTextureDesc{.mipSizes = smallMipSizes, .width = 4u, .height = 4u});
+    SGFX_CHECK(streamer.getResidentMip(smallTextureId) == 0u);
+}
+
+SGFX_TEST(TextureStreamerLoadsRequestedMips)
+{
+    sgfx::TextureStreamer streamer{};
+    const uint32_t textureId = addTexture(streamer);
+
+    // Finer mips are loaded in a single request, as they fit the default upload budget.
+    streamer.requestMip(textureId, 1u);
+    streamer.requestMip(textureId, 0u);
+
+    const std::vector<sgfx::TextureStreamingRequest> requests = streamer.update();
+    SGFX_CHECK(requests.size() == 1u && requests[0].textureId == textureId && requests[0].firstMip == 0u);
+    SGFX_CHECK(streamer.getWantedMip(textureId) == 0u);
+    SGFX_CHECK(streamer.getStats().pendingRequestCount == 1u);
+
+    // A texture with a request in flight is not requested again.
+    streamer.requestMip(textureId, 0u);
+    SGFX_CHECK(streamer.update().empty());
+
+    completeRequests(streamer, requests);
+    SGFX_CHECK(streamer.getResidentMip(textureId) == 0u);
+    SGFX_CHECK(streamer.getStats().loadedBytes == std::accumulate(getMipSizes().begin(), getMipSizes().begin() + MIP_TAIL_FIRST_MIP, uint64_t{0u}));
+
+    // Mips no longer requested stay resident as long as the budget allows.
+    SGFX_CHECK(streamer.update().empty());
+    SGFX_CHECK(streamer.getWantedMip(textureId) == MIP_TAIL_FIRST_MIP);
+    SGFX_CHECK(streamer.getResidentMip(textureId) == 0u);
+}
+
+SGFX_TEST(TextureStreamerRetriesFailedRequests)
+{
+    sgfx::TextureStreamer streamer{};
+    const uint32_t textureId = addTexture(streamer);
+
+    streamer.requestMip(textureId, 2u);
+    const std::vector<sgfx::TextureStreamingRequest> requests = streamer.update();
+    SGFX_CHECK(requests.size() == 1u);
+
+    // A failed request reports the mip that is still resident.
+    streamer.completeRequest(textureId, MIP_TAIL_FIRST_MIP);
+    SGFX_CHECK(streamer.getResidentMip(textureId) == MIP_TAIL_FIRST_MIP);
+    SGFX_CHECK(streamer.getStats().loadedBytes == 0u);
+
+    streamer.requestMip(textureId, 2u);
+    SGFX_CHECK(streamer.update().size() == 1u);
+}
+
+SGFX_TEST(TextureStreamerServesBlurriestTexturesFirst)
+{
+    // A single request in flight at a time, loading at most 1 MiB per update.
+    sgfx::TextureStreamer streamer(sgfx::TextureStreamerCreationDesc{.uploadBudgetBytesPerUpdate = 1024u * 1024u, .maxPendingRequestCount = 1u});
+
+    const uint32_t slightlyBlurryTextureId = addTexture(streamer);
+    const uint32_t blurryTextureId = addTexture(streamer);
+
+    streamer.requestMip(slightlyBlurryTextureId, 3u);
+    streamer.requestMip(blurryTextureId, 0u);
+
+    // The 4 MiB top mip exceeds the upload budget, so the first request stops at mip 2 (320 KiB) and the next one loads mip 1 (1 MiB).
+    std::vector<sgfx::TextureStreamingRequest> requests = streamer.update();
+    SGFX_CHECK(requests.size() == 1u && requests[0].textureId == blurryTextureId && requests[0].firstMip == 2u);
+
+    completeRequests(streamer, requests);
+    streamer.requestMip(slightlyBlurryTextureId, 3u);
+    streamer.requestMip(blurryTextureId, 0u);
+
+    requests = streamer.update();
+    SGFX_CHECK(requests.size() == 1u && requests[0].textureId == blurryTextureId && requests[0].firstMip == 1u);
+
+    // Both textures are now one mip away from what they want, and are served in the order they were added.
+    completeRequests(streamer, requests);
+    streamer.requestMip(slightlyBlurryTextureId, 3u);
+    streamer.requestMip(blurryTextureId, 0u);
+
+    requests = streamer.update();
+    SGFX_CHECK(requests.size() == 1u && requests[0].textureId == slightlyBlurryTextureId && requests[0].firstMip == 3u);
+
+    // A single mip is loaded even when it exceeds the upload budget on its own, so large mips are not starved.
+    completeRequests(streamer, requests);
+    streamer.requestMip(slightlyBlurryTextureId, 3u);
+    streamer.requestMip(blurryTextureId, 0u);
+
+    requests = streamer.update();
+    SGFX_CHECK(requests.size() == 1u && requests[0].textureId == blurryTextureId && requests[0].firstMip == 0u);
+}
+
+SGFX_TEST(TextureStreamerReusesIdsOnceRequestsComplete)
+{
+    sgfx::TextureStreamer streamer{};
+    const uint32_t textureId = addTexture(streamer);
+
+    streamer.requestMip(textureId, 0u);
+    const std::vector<sgfx::TextureStreamingRequest> requests = streamer.update();
+
+    // The id of a texture removed with a request in flight is only reused once the request completes.
+    streamer.removeTexture(textureId);
+    SGFX_CHECK(addTexture(streamer) != textureId);
+    SGFX_CHECK(streamer.getStats().textureCount == 1u);
+
+    completeRequests(streamer, requests);
+    SGFX_CHECK(addTexture(streamer) == textureId);
+}
+
+SGFX_TEST(TextureStreamerCountsReplacedTexturesUntilSwap)
+{
+    const uint64_t mipTailSize = std::accumulate(getMipSizes().begin() + MIP_TAIL_FIRST_MIP, getMipSizes().end(), uint64_t{0u});
+    const uint64_t fullSize = std::accumulate(getMipSizes().begin(), getMipSizes().end(), uint64_t{0u});
+
+    // Room for the whole texture, but not for the whole texture alongside the mip tail it replaces.
+    const uint64_t budgetBytes = fullSize + mipTailSize / 2u;
+
+    sgfx::TextureStreamer streamer(sgfx::TextureStreamerCreationDesc{.residentBudgetBytes = budgetBytes});
+    const uint32_t textureId = addTexture(streamer);
+
+    // A single mip is loaded instead.
+    streamer.requestMip(textureId, 0u);
+    const std::vector<sgfx::TextureStreamingRequest> requests = streamer.update();
+    SGFX_CHECK(requests.size() == 1u && requests[0].firstMip == MIP_TAIL_FIRST_MIP - 1u);
+
+    const sgfx::TextureStreamingStats stats = streamer.getStats();
+    SGFX_CHECK(stats.residentBytes == mipTailSize);
+    SGFX_CHECK(stats.inFlightBytes == mipTailSize + getMipSizes()[MIP_TAIL_FIRST_MIP - 1u]);
+}
+
+SGFX_TEST(TextureStreamerEvictsWithinBudget)
+{
+    const uint64_t fullSize = std::accumulate(getMipSizes().begin(), getMipSizes().end(), uint64_t{0u});
+    const uint64_t budgetBytes = fullSize + fullSize / 2u;
+
+    sgfx::TextureStreamer streamer(sgfx::TextureStreamerCreationDesc{.residentBudgetBytes = budgetBytes});
+    const uint32_t previousTextureId = addTexture(streamer);
+    const uint32_t textureId = addTexture(streamer);
+
+    // Requests complete by the next update. Resident textures and the ones being created never exceed the budget.
+    const auto runUpdates = [&](const uint32_t requestedTextureId)
+    {
+        for (uint32_t update = 0u; update < 16u; update++)
+        {
+            streamer.requestMip(requestedTextureId, 0u);
+            const std::vector<sgfx::TextureStreamingRequest> requests = streamer.update();
+
+            const sgfx::TextureStreamingStats stats = streamer.getStats();
+            SGFX_CHECK(stats.residentBytes + stats.inFlightBytes <= budgetBytes);
+
+            // Evicted mips are only released once the eviction completes, so the load waits for the next update.
+            SGFX_CHECK(stats.lastUpdateEvictionCount == 0u || stats.lastUpdateLoadCount == 0u);
+
+            completeRequests(streamer, requests);
+        }
+    };
+
+    runUpdates(previousTextureId);
+    SGFX_CHECK(streamer.getResidentMip(previousTextureId) == 0u);
+
+    // Both textures do not fit at full resolution, the one no longer requested gives up its mips.
+    runUpdates(textureId);
+    SGFX_CHECK(streamer.getResidentMip(textureId) == 0u);
+    SGFX_CHECK(streamer.getResidentMip(previousTextureId) == MIP_TAIL_FIRST_MIP);
+    SGFX_CHECK(streamer.getStats().evictionCount == 1u);
+}
+
+SGFX_TEST(TextureLod)
+{
+    // One texel per pixel samples the top mip, four texels per pixel (along each axis) the third.
+    SGFX_CHECK(sgfx::computeTextureLod(TEXTURE_SIZE, 1.0f / TEXTURE_SIZE) == 0.0f);
+    SGFX_CHECK(sgfx::computeTextureLod(TEXTURE_SIZE, 4.0f / TEXTURE_SIZE) == 2.0f);
+    SGFX_CHECK(sgfx::computeTextureLod(TEXTURE_SIZE, 0.25f / TEXTURE_SIZE) == -2.0f);
+    SGFX_CHECK(std::isfinite(sgfx::computeTextureLod(TEXTURE_SIZE, 0.0f)));
+}
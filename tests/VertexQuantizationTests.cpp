@@ -0,0 +1,129 @@
+#include "Pch.hpp"
+
+#include "Test.hpp"
+#include "VertexQuantization.hpp"
+
+namespace
+{
+    math::XMFLOAT3 getRandomUnitVector(std::mt19937& randomEngine)
+    {
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        math::XMFLOAT3 vector{};
+        math::XMStoreFloat3(&vector, math::XMVector3Normalize(math::XMVectorSet(distribution(randomEngine), distribution(randomEngine), distribution(randomEngine), 0.0f)));
+
+        return vector;
+    }
+
+    float getAngleInDegrees(const math::XMFLOAT3& a, const math::XMFLOAT3& b)
+    {
+        const float cosine = math::XMVectorGetX(math::XMVector3Dot(math::XMVector3Normalize(math::XMLoadFloat3(&a)), math::XMVector3Normalize(math::XMLoadFloat3(&b))));
+        return math::XMConvertToDegrees(std::acos(std::clamp(cosine, -1.0f, 1.0f)));
+    }
+}
+
+SGFX_TEST(HalfConversionRoundTrip)
+{
+    // Exactly representable values come back unchanged, others within half a step (2^-11 relative).
+    for (const float value : {0.0f, 1.0f, -2.5f, 0.125f, 1024.0f, 65504.0f})
+    {
+        SGFX_CHECK(sgfx::halfToFloat(sgfx::floatToHalf(value)) == value);
+    }
+
+    std::mt19937 randomEngine(5u);
+    std::uniform_real_distribution<float> distribution(-sgfx::MAX_COMPACT_TEXTURE_COORD, sgfx::MAX_COMPACT_TEXTURE_COORD);
+
+    for (uint32_t i = 0u; i < 10'000u; i++)
+    {
+        const float value = distribution(randomEngine);
+        SGFX_CHECK(std::abs(sgfx::halfToFloat(sgfx::floatToHalf(value)) - value) <= std::abs(value) * 0x1p-11f);
+    }
+}
+
+SGFX_TEST(OctahedralNormalAndTangentRoundTrip)
+{
+    std::mt19937 randomEngine(9u);
+
+    float maximumNormalError = 0.0f;
+    float maximumTangentError = 0.0f;
+
+    for (uint32_t i = 0u; i < 10'000u; i++)
+    {
+        const math::XMFLOAT3 normal = getRandomUnitVector(randomEngine);
+        const math::XMFLOAT3 decodedNormal = sgfx::decodeOctahedralNormal(sgfx::encodeOctahedralNormal(normal));
+
+        // Any vector orthogonal to the normal, with either handedness.
+        math::XMFLOAT3 tangentDirection{};
+        const math::XMFLOAT3 randomDirection = getRandomUnitVector(randomEngine);
+        math::XMStoreFloat3(&tangentDirection, math::XMVector3Normalize(math::XMVector3Cross(math::XMLoadFloat3(&decodedNormal), math::XMLoadFloat3(&randomDirection))));
+
+        const math::XMFLOAT4 tangent = {tangentDirection.x, tangentDirection.y, tangentDirection.z, i % 2u == 0u ? 1.0f : -1.0f};
+        const math::XMFLOAT4 decodedTangent = sgfx::decodeTangent(decodedNormal, sgfx::encodeTangent(decodedNormal, tangent));
+
+        maximumNormalError = std::max(maximumNormalError, getAngleInDegrees(normal, decodedNormal));
+        maximumTangentError = std::max(maximumTangentError, getAngleInDegrees(tangentDirection, {decodedTangent.x, decodedTangent.y, decodedTangent.z}));
+
+        SGFX_CHECK(decodedTangent.w == tangent.w);
+    }
+
+    SGFX_CHECK(maximumNormalError < 0.05f);
+    SGFX_CHECK(maximumTangentError < 0.05f);
+}
+
+SGFX_TEST(CompactVerticesMatchScalarEncoding)
+{
+    // Not a multiple of the SIMD width, so the scalar tail runs too.
+    constexpr uint32_t VERTEX_COUNT = 1001u;
+
+    std::mt19937 randomEngine(17u);
+    std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+
+    std::vector<sgfx::ModelVertex> vertices(VERTEX_COUNT);
+    for (sgfx::ModelVertex& vertex : vertices)
+    {
+        vertex.position = {distribution(randomEngine), distribution(randomEngine), distribution(randomEngine)};
+        vertex.textureCoord = {distribution(randomEngine), distribution(randomEngine)};
+        vertex.normal = getRandomUnitVector(randomEngine);
+        vertex.tangent = {1.0f, 0.0f, 0.0f, 1.0f};
+    }
+
+    const sgfx::AxisAlignedBoundingBox bounds = {.minimum = {-4.0f, -4.0f, -4.0f}, .maximum = {4.0f, 4.0f, 4.0f}};
+    const float inverseExtent = 65535.0f / 8.0f;
+
+    std::vector<sgfx::CompactModelVertex> compactVertices(VERTEX_COUNT);
+    sgfx::encodeCompactVertices(vertices, bounds, compactVertices);
+
+    const sgfx::PositionDequantization dequantization = sgfx::getPositionDequantization(bounds);
+
+    for (const uint32_t i : std::views::iota(0u, VERTEX_COUNT))
+    {
+        const sgfx::ModelVertex& vertex = vertices[i];
+        const sgfx::CompactModelVertex& compactVertex = compactVertices[i];
+
+        const std::array<int16_t, 2> normal = sgfx::encodeOctahedralNormal(vertex.normal);
+
+        SGFX_CHECK(compactVertex.position[0] == sgfx::quantizeUnorm16(vertex.position.x, -4.0f, inverseExtent));
+        SGFX_CHECK(compactVertex.position[1] == sgfx::quantizeUnorm16(vertex.position.y, -4.0f, inverseExtent));
+        SGFX_CHECK(compactVertex.position[2] == sgfx::quantizeUnorm16(vertex.position.z, -4.0f, inverseExtent));
+        SGFX_CHECK(compactVertex.position[3] == sgfx::encodeTangent(sgfx::decodeOctahedralNormal(normal), vertex.tangent));
+        SGFX_CHECK(compactVertex.textureCoord[0] == sgfx::floatToHalf(vertex.textureCoord.x));
+        SGFX_CHECK(compactVertex.textureCoord[1] == sgfx::floatToHalf(vertex.textureCoord.y));
+        SGFX_CHECK(compactVertex.normal[0] == normal[0] && compactVertex.normal[1] == normal[1]);
+
+        // Within about half a quantization step of the source position.
+        const float decodedX = compactVertex.position[0] * dequantization.scale.x + dequantization.offset.x;
+        SGFX_CHECK(std::abs(decodedX - vertex.position.x) <= 0.51f / inverseExtent);
+    }
+}
+
+SGFX_TEST(CompactTextureCoordRange)
+{
+    std::vector<sgfx::ModelVertex> vertices(4u);
+    vertices[1].textureCoord = {sgfx::MAX_COMPACT_TEXTURE_COORD, -sgfx::MAX_COMPACT_TEXTURE_COORD};
+
+    SGFX_CHECK(sgfx::canEncodeCompactTextureCoords(vertices));
+
+    // Tiling coordinates, half floats would step by 1/64 of a repeat here.
+    vertices[2].textureCoord = {0.5f, -20.0f};
+    SGFX_CHECK(!sgfx::canEncodeCompactTextureCoords(vertices));
+}